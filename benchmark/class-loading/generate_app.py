@@ -0,0 +1,116 @@
+#! /usr/bin/env python3
+#
+# Copyright 2024, The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates the Java sources of a synthetic app for ClassLoadingBenchmark.
+
+The classes form short inheritance chains, implement a shared interface, have static
+initializers and enough methods for the app to need several dex files.
+"""
+
+import argparse
+import os
+
+INTERFACE = '''package gen;
+
+public interface Shape {
+    int area(int scale);
+}
+'''
+
+CLASS_TEMPLATE = '''package gen.p{package};
+
+public class C{index} extends {superclass} implements gen.Shape {{
+    static final int[] TABLE = new int[{table_size}];
+    static int counter;
+
+    static {{
+        for (int i = 0; i < TABLE.length; ++i) {{
+            TABLE[i] = i * {index} + 1;
+        }}
+        counter = TABLE[TABLE.length - 1];
+    }}
+
+    int width = {index};
+    long height = {index}L * 3;
+    Object link;
+
+    public int area(int scale) {{
+        return (int) (width * height) * scale + counter;
+    }}
+
+{methods}
+}}
+'''
+
+METHOD_TEMPLATE = '''    public int m{method}(int x) {{
+        int result = x;
+        for (int i = 0; i < {method} + 2; ++i) {{
+            result = (result * 31) ^ TABLE[i % TABLE.length];
+        }}
+        if (link instanceof C{index}) {{
+            result += ((C{index}) link).width;
+        }}
+        return result;
+    }}
+'''
+
+
+def main():
+  parser = argparse.ArgumentParser(
+      description=__doc__,
+      formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+  )
+  parser.add_argument('out_dir', help='Directory for the generated sources.')
+  parser.add_argument('--num-classes', type=int, default=5000)
+  parser.add_argument('--methods-per-class', type=int, default=20)
+  parser.add_argument(
+      '--chain-length',
+      type=int,
+      default=8,
+      help='Length of the inheritance chains.',
+  )
+  parser.add_argument('--classes-per-package', type=int, default=100)
+  args = parser.parse_args()
+
+  os.makedirs(os.path.join(args.out_dir, 'gen'), exist_ok=True)
+  with open(os.path.join(args.out_dir, 'gen', 'Shape.java'), 'w') as f:
+    f.write(INTERFACE)
+
+  for index in range(args.num_classes):
+    package = index // args.classes_per_package
+    if index % args.chain_length == 0 or index % args.classes_per_package == 0:
+      superclass = 'Object'
+    else:
+      superclass = f'C{index - 1}'
+    methods = '\n'.join(
+        METHOD_TEMPLATE.format(method=m, index=index)
+        for m in range(args.methods_per_class)
+    )
+    source = CLASS_TEMPLATE.format(
+        package=package,
+        index=index,
+        superclass=superclass,
+        table_size=16 + index % 64,
+        methods=methods,
+    )
+    package_dir = os.path.join(args.out_dir, 'gen', f'p{package}')
+    os.makedirs(package_dir, exist_ok=True)
+    with open(os.path.join(package_dir, f'C{index}.java'), 'w') as f:
+      f.write(source)
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.system.DexFile;
+import dalvik.system.PathClassLoader;
+
+import java.util.ArrayList;
+import java.util.Enumeration;
+import java.util.List;
+
+public class ClassLoadingBenchmark {
+    private final String appPath;
+    private final List<String> classNames;
+
+    // Keeps the loaded classes reachable, so that each iteration really loads them.
+    private static Object sink;
+
+    @SuppressWarnings("deprecation")
+    ClassLoadingBenchmark(String appPath) throws Exception {
+        this.appPath = appPath;
+        this.classNames = new ArrayList<>();
+        DexFile dexFile = new DexFile(appPath);
+        try {
+            for (Enumeration<String> e = dexFile.entries(); e.hasMoreElements();) {
+                classNames.add(e.nextElement());
+            }
+        } finally {
+            dexFile.close();
+        }
+    }
+
+    // Opening the dex files, and their oat file if there is one.
+    public ClassLoader $noinline$open() {
+        return new PathClassLoader(appPath, ClassLoadingBenchmark.class.getClassLoader());
+    }
+
+    // FindClass, DefineClass and linking of every class, without initializing them.
+    public Class<?>[] $noinline$load(ClassLoader loader) throws Exception {
+        Class<?>[] classes = new Class<?>[classNames.size()];
+        for (int i = 0; i < classes.length; ++i) {
+            classes[i] = Class.forName(classNames.get(i), /* initialize= */ false, loader);
+        }
+        return classes;
+    }
+
+    // Initialization of every class. This includes verification, unless dex2oat already verified
+    // the app, and the <clinit> of each class.
+    public void $noinline$initialize(ClassLoader loader) throws Exception {
+        for (String className : classNames) {
+            Class.forName(className, /* initialize= */ true, loader);
+        }
+    }
+
+    // Report the mean time of each phase over fresh class loaders. The arguments are the path of
+    // the app to load and, optionally, the number of iterations.
+    public static void main(String[] args) throws Exception {
+        if (args.length < 1) {
+            System.err.println("Usage: ClassLoadingBenchmark <app.jar> [iterations]");
+            System.exit(1);
+        }
+        int iterations = (args.length > 1) ? Integer.parseInt(args[1]) : 10;
+        ClassLoadingBenchmark benchmark = new ClassLoadingBenchmark(args[0]);
+        long openNs = 0;
+        long loadNs = 0;
+        long initializeNs = 0;
+        for (int i = 0; i <= iterations; ++i) {
+            long startNs = System.nanoTime();
+            ClassLoader loader = benchmark.$noinline$open();
+            long openedNs = System.nanoTime();
+            sink = benchmark.$noinline$load(loader);
+            long loadedNs = System.nanoTime();
+            benchmark.$noinline$initialize(loader);
+            long initializedNs = System.nanoTime();
+            if (i == 0) {
+                continue;  // Warm up.
+            }
+            openNs += openedNs - startNs;
+            loadNs += loadedNs - openedNs;
+            initializeNs += initializedNs - loadedNs;
+            sink = null;
+            Runtime.getRuntime().gc();  // Unload the classes of this iteration.
+        }
+        System.out.println(benchmark.classNames.size() + " classes, " + iterations + " iterations");
+        System.out.println(String.format("Open: %.2f ms", openNs / 1e6 / iterations));
+        System.out.println(String.format("Load: %.2f ms", loadNs / 1e6 / iterations));
+        System.out.println(String.format("Initialize: %.2f ms", initializeNs / 1e6 / iterations));
+    }
+}
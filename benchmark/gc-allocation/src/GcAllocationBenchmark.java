@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.system.VMDebug;
+
+import java.io.BufferedReader;
+import java.io.FileReader;
+import java.lang.ref.SoftReference;
+import java.lang.ref.WeakReference;
+import java.lang.reflect.Method;
+import java.util.LinkedHashMap;
+import java.util.Map;
+import java.util.Random;
+
+public class GcAllocationBenchmark {
+    private static final long SEED = 42;
+    private static final int NUM_THREADS = 4;
+
+    // Keeps the result of each workload reachable, so that the allocations are not optimized out.
+    private static Object sink;
+
+    static class Node {
+        Node next;
+        int value;
+        long payload;
+
+        Node(Node next, int value) {
+            this.next = next;
+            this.value = value;
+        }
+    }
+
+    static class LruCache extends LinkedHashMap<Integer, Object> {
+        private final int capacity;
+
+        LruCache(int capacity) {
+            super(capacity, 0.75f, /* accessOrder= */ true);
+            this.capacity = capacity;
+        }
+
+        @Override
+        protected boolean removeEldestEntry(Map.Entry<Integer, Object> eldest) {
+            return size() > capacity;
+        }
+    }
+
+    // Small objects that almost all die young, only short lists survive for a few allocations.
+    public void timeShortLivedChurn(int count) {
+        sink = $noinline$churn(count);
+    }
+
+    // Object arrays big enough for the large object space, with a window of them kept alive.
+    public void timeLargeObjectArrays(int count) {
+        Object[][] window = new Object[16][];
+        for (int i = 0; i < count; ++i) {
+            Object[] array = new Object[16 * 1024];
+            array[0] = window;
+            window[i % window.length] = array;
+        }
+        sink = window;
+    }
+
+    // A long-lived cache of soft and weak references to byte arrays, with random lookups that
+    // keep replacing entries.
+    public void timeReferenceHeavyCache(int count) {
+        Random random = new Random(SEED);
+        LruCache cache = new LruCache(4096);
+        for (int i = 0; i < count; ++i) {
+            for (int j = 0; j < 100; ++j) {
+                int key = random.nextInt(16 * 1024);
+                Object ref = cache.get(key);
+                if (ref == null) {
+                    byte[] data = new byte[64 + (key & 0xff)];
+                    ref = ((key & 1) == 0) ? new SoftReference<>(data) : new WeakReference<>(data);
+                    cache.put(key, ref);
+                }
+            }
+        }
+        sink = cache;
+    }
+
+    // The short-lived churn on several threads at once, to exercise thread-local allocation
+    // buffers and GCs that have to suspend several mutators.
+    public void timeMultiThreadedAllocation(final int count) throws Exception {
+        Thread[] threads = new Thread[NUM_THREADS];
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            threads[t] = new Thread() {
+                public void run() {
+                    Object result = $noinline$churn(count);
+                    synchronized (GcAllocationBenchmark.class) {
+                        sink = result;
+                    }
+                }
+            };
+        }
+        for (Thread thread : threads) {
+            thread.start();
+        }
+        for (Thread thread : threads) {
+            thread.join();
+        }
+    }
+
+    static Node $noinline$churn(int count) {
+        Node head = null;
+        for (int i = 0; i < count; ++i) {
+            for (int j = 0; j < 100; ++j) {
+                head = ((j & 15) == 0) ? null : new Node(head, j);
+            }
+        }
+        return head;
+    }
+
+    private static long getRuntimeStat(String name) {
+        return Long.parseLong(VMDebug.getRuntimeStat(name));
+    }
+
+    // Returns the "VmHWM" line of /proc/self/status, or null if it is not available.
+    private static String getPeakRss() {
+        try (BufferedReader reader = new BufferedReader(new FileReader("/proc/self/status"))) {
+            String line;
+            while ((line = reader.readLine()) != null) {
+                if (line.startsWith("VmHWM:")) {
+                    return line.substring("VmHWM:".length()).trim();
+                }
+            }
+        } catch (Exception e) {
+            // Not on Linux.
+        }
+        return null;
+    }
+
+    // Report the cost of each workload. The optional argument is the number of rounds per
+    // measurement.
+    public static void main(String[] args) throws Exception {
+        int n = (args.length > 0) ? Integer.parseInt(args[0]) : 10000;
+        GcAllocationBenchmark benchmark = new GcAllocationBenchmark();
+        for (Method method : GcAllocationBenchmark.class.getDeclaredMethods()) {
+            if (!method.getName().startsWith("time")) {
+                continue;
+            }
+            method.invoke(benchmark, n);  // Warm up.
+            sink = null;
+            Runtime.getRuntime().gc();
+            long startGcCount = getRuntimeStat("art.gc.gc-count");
+            long startGcTimeMs = getRuntimeStat("art.gc.gc-time");
+            long startBlockingCount = getRuntimeStat("art.gc.blocking-gc-count");
+            long startBytesAllocated = getRuntimeStat("art.gc.bytes-allocated");
+            long startNs = System.nanoTime();
+            method.invoke(benchmark, n);
+            long ns = System.nanoTime() - startNs;
+            long gcCount = getRuntimeStat("art.gc.gc-count") - startGcCount;
+            long gcTimeMs = getRuntimeStat("art.gc.gc-time") - startGcTimeMs;
+            long blockingGcCount = getRuntimeStat("art.gc.blocking-gc-count") - startBlockingCount;
+            long bytesAllocated = getRuntimeStat("art.gc.bytes-allocated") - startBytesAllocated;
+            System.out.println(String.format(
+                    "%s: %.1f us, %.1f MB/s allocated, %d GCs (%d blocking), %d ms in GC",
+                    method.getName().substring(4),
+                    ns / 1000.0 / n,
+                    bytesAllocated / (1024.0 * 1024.0) / (ns / 1e9),
+                    gcCount,
+                    blockingGcCount,
+                    gcTimeMs));
+        }
+        String peakRss = getPeakRss();
+        if (peakRss != null) {
+            System.out.println("Peak RSS: " + peakRss);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <jni.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace art {
+
+namespace {
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_emptyCall(JNIEnv*, jobject) {}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_referenceArgsCall(
+    JNIEnv*, jobject, jobject, jstring, jintArray) {}
+
+extern "C" JNIEXPORT jobject JNICALL Java_JniTransitionsBenchmark_referenceReturnCall(
+    JNIEnv*, jobject, jobject a) {
+  return a;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_staticEmptyCall(JNIEnv*, jclass) {}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_throwingCall(JNIEnv* env,
+                                                                           jobject) {
+  // Look up the class every time, as an application throwing from native code would.
+  jclass exception_class = env->FindClass("java/lang/IllegalStateException");
+  env->ThrowNew(exception_class, "throwingCall");
+  env->DeleteLocalRef(exception_class);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_callbackCall(JNIEnv* env,
+                                                                           jobject thiz) {
+  static jmethodID callback = nullptr;
+  if (callback == nullptr) {
+    jclass klass = env->GetObjectClass(thiz);
+    callback = env->GetMethodID(klass, "callback", "()V");
+    env->DeleteLocalRef(klass);
+  }
+  env->CallVoidMethod(thiz, callback);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_arrayCriticalCall(
+    JNIEnv* env, jobject, jintArray array) {
+  jsize length = env->GetArrayLength(array);
+  jint* elements = reinterpret_cast<jint*>(env->GetPrimitiveArrayCritical(array, nullptr));
+  jint result = elements[0] + elements[length - 1];
+  env->ReleasePrimitiveArrayCritical(array, elements, JNI_ABORT);
+  return result;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_synchronizedEmptyCall(JNIEnv*,
+                                                                                    jobject) {}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_fastEmptyCall(JNIEnv*, jobject) {}
+
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_fastReferenceArgsCall(
+    JNIEnv*, jobject, jobject, jstring, jintArray) {}
+
+extern "C" JNIEXPORT jobject JNICALL Java_JniTransitionsBenchmark_fastReferenceReturnCall(
+    JNIEnv*, jobject, jobject a) {
+  return a;
+}
+
+// @CriticalNative methods take neither the JNIEnv* nor the jclass.
+extern "C" JNIEXPORT void JNICALL Java_JniTransitionsBenchmark_criticalEmptyCall() {}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniTransitionsBenchmark_criticalIntArgsCall(
+    jint a, jint b, jint c, jint d) {
+  return a + b + c + d;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_JniTransitionsBenchmark_instructionCount(JNIEnv*,
+                                                                                jclass) {
+#if defined(__linux__)
+  // One counter per thread, opened on first use and kept open for the lifetime of the thread.
+  static thread_local int counter_fd = -2;
+  if (counter_fd == -2) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    counter_fd = static_cast<int>(
+        syscall(__NR_perf_event_open, &attr, /*pid=*/ 0, /*cpu=*/ -1, /*group_fd=*/ -1, 0));
+  }
+  long long count;  // NOLINT(runtime/int) - the kernel interface uses a 64-bit integer.
+  if (counter_fd >= 0 && read(counter_fd, &count, sizeof(count)) == sizeof(count)) {
+    return static_cast<jlong>(count);
+  }
+#endif
+  return -1;
+}
+
+}  // namespace
+
+}  // namespace art
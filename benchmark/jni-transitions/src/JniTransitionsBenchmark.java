@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.annotation.optimization.CriticalNative;
+import dalvik.annotation.optimization.FastNative;
+
+import java.lang.reflect.Method;
+
+public class JniTransitionsBenchmark {
+  private final Object object = new Object();
+  private final String string = "ABCDE";
+  private final int[] smallArray = new int[16];
+  private final int[] largeArray = new int[16 * 1024];
+  private int callbackCount = 0;
+
+  // Regular JNI.
+  native void emptyCall();
+  native void referenceArgsCall(Object a, String b, int[] c);
+  native Object referenceReturnCall(Object a);
+  static native void staticEmptyCall();
+  native void throwingCall();
+  native void callbackCall();
+  native int arrayCriticalCall(int[] array);
+  synchronized native void synchronizedEmptyCall();
+
+  @FastNative
+  native void fastEmptyCall();
+  @FastNative
+  native void fastReferenceArgsCall(Object a, String b, int[] c);
+  @FastNative
+  native Object fastReferenceReturnCall(Object a);
+
+  @CriticalNative
+  static native void criticalEmptyCall();
+  @CriticalNative
+  static native int criticalIntArgsCall(int a, int b, int c, int d);
+
+  // Returns the user-space instructions retired by this thread, or -1 if not available.
+  static native long instructionCount();
+
+  // Called from `callbackCall()`.
+  private void callback() {
+    callbackCount++;
+  }
+
+  public void timeEmptyCall(int N) {
+    for (int i = 0; i < N; i++) {
+      emptyCall();
+    }
+  }
+
+  public void timeStaticEmptyCall(int N) {
+    for (int i = 0; i < N; i++) {
+      staticEmptyCall();
+    }
+  }
+
+  public void timeSynchronizedEmptyCall(int N) {
+    for (int i = 0; i < N; i++) {
+      synchronizedEmptyCall();
+    }
+  }
+
+  public void timeReferenceArgsCall(int N) {
+    for (int i = 0; i < N; i++) {
+      referenceArgsCall(object, string, smallArray);
+    }
+  }
+
+  public void timeReferenceReturnCall(int N) {
+    for (int i = 0; i < N; i++) {
+      referenceReturnCall(object);
+    }
+  }
+
+  public void timeThrowingCall(int N) {
+    for (int i = 0; i < N; i++) {
+      try {
+        throwingCall();
+      } catch (IllegalStateException expected) {
+      }
+    }
+  }
+
+  public void timeCallbackCall(int N) {
+    for (int i = 0; i < N; i++) {
+      callbackCall();
+    }
+  }
+
+  public void timeSmallArrayCriticalCall(int N) {
+    for (int i = 0; i < N; i++) {
+      arrayCriticalCall(smallArray);
+    }
+  }
+
+  public void timeLargeArrayCriticalCall(int N) {
+    for (int i = 0; i < N; i++) {
+      arrayCriticalCall(largeArray);
+    }
+  }
+
+  public void timeFastEmptyCall(int N) {
+    for (int i = 0; i < N; i++) {
+      fastEmptyCall();
+    }
+  }
+
+  public void timeFastReferenceArgsCall(int N) {
+    for (int i = 0; i < N; i++) {
+      fastReferenceArgsCall(object, string, smallArray);
+    }
+  }
+
+  public void timeFastReferenceReturnCall(int N) {
+    for (int i = 0; i < N; i++) {
+      fastReferenceReturnCall(object);
+    }
+  }
+
+  public void timeCriticalEmptyCall(int N) {
+    for (int i = 0; i < N; i++) {
+      criticalEmptyCall();
+    }
+  }
+
+  public void timeCriticalIntArgsCall(int N) {
+    for (int i = 0; i < N; i++) {
+      criticalIntArgsCall(i, 1, 2, 3);
+    }
+  }
+
+  // Report the cost of one transition for each benchmark. The optional argument is the
+  // number of transitions per measurement.
+  public static void main(String[] args) throws Exception {
+    int n = (args.length > 0) ? Integer.parseInt(args[0]) : 1000000;
+    JniTransitionsBenchmark benchmark = new JniTransitionsBenchmark();
+    for (Method method : JniTransitionsBenchmark.class.getDeclaredMethods()) {
+      if (!method.getName().startsWith("time")) {
+        continue;
+      }
+      method.invoke(benchmark, n);  // Warm up.
+      long startInstructions = instructionCount();
+      long startNs = System.nanoTime();
+      method.invoke(benchmark, n);
+      long ns = System.nanoTime() - startNs;
+      long instructions = instructionCount() - startInstructions;
+      StringBuilder sb = new StringBuilder();
+      sb.append(method.getName().substring(4)).append(": ");
+      sb.append(String.format("%.1f ns", (double) ns / n));
+      if (startInstructions >= 0) {
+        sb.append(String.format(", %.1f instructions", (double) instructions / n));
+      }
+      System.out.println(sb);
+    }
+  }
+
+  static {
+    System.loadLibrary("artbenchmark");
+  }
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class StringEqualsBenchmark {
+    public static final String string8 = "01234567";
+    public static final String string36 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";  // length = 36
+    public static final String string256;
+    public static final String string256Utf16;
+
+    static {
+        StringBuilder sb = new StringBuilder();
+        for (int i = 0; i < 256; ++i) {
+            sb.append((char) ('a' + (i % 26)));
+        }
+        string256 = sb.toString();
+        string256Utf16 = string256.replace('z', '\u0444');
+    }
+
+    // Use copies so that the strings are not the same reference.
+    private final String copy8 = new String(string8.toCharArray());
+    private final String copy36 = new String(string36.toCharArray());
+    private final String copy256 = new String(string256.toCharArray());
+    private final String copy256Utf16 = new String(string256Utf16.toCharArray());
+    private final String differentLast256 = string256.substring(0, 255) + '!';
+
+    public void timeEquals8(int count) {
+        String s = string8;
+        String t = copy8;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    public void timeEquals36(int count) {
+        String s = string36;
+        String t = copy36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    public void timeEquals256(int count) {
+        String s = string256;
+        String t = copy256;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    public void timeEquals256Utf16(int count) {
+        String s = string256Utf16;
+        String t = copy256Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    public void timeEquals256DifferentLast(int count) {
+        String s = string256;
+        String t = differentLast256;
+        for (int i = 0; i < count; ++i) {
+            $noinline$equals(s, t);
+        }
+    }
+
+    static boolean $noinline$equals(String s, String t) {
+        if (doThrow) { throw new Error(); }
+        return s.equals(t);
+    }
+
+    public static boolean doThrow = false;
+}
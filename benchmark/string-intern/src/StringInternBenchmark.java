@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class StringInternBenchmark {
+    public static final String string8 = "01234567";
+    public static final String string36 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";  // length = 36
+    public static final String string256;
+    public static final String string256Utf16;
+
+    static {
+        StringBuilder sb = new StringBuilder();
+        for (int i = 0; i < 256; ++i) {
+            sb.append((char) ('a' + (i % 26)));
+        }
+        string256 = sb.toString().intern();
+        string256Utf16 = string256.replace('z', 'ф').intern();
+    }
+
+    private final char[] chars8 = string8.toCharArray();
+    private final char[] chars36 = string36.toCharArray();
+    private final char[] chars256 = string256.toCharArray();
+    private final char[] chars256Utf16 = string256Utf16.toCharArray();
+
+    // Each iteration interns a new string, so that the runtime has to compute its hash code.
+
+    public void timeIntern8(int count) {
+        char[] chars = chars8;
+        for (int i = 0; i < count; ++i) {
+            $noinline$intern(chars);
+        }
+    }
+
+    public void timeIntern36(int count) {
+        char[] chars = chars36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$intern(chars);
+        }
+    }
+
+    public void timeIntern256(int count) {
+        char[] chars = chars256;
+        for (int i = 0; i < count; ++i) {
+            $noinline$intern(chars);
+        }
+    }
+
+    public void timeIntern256Utf16(int count) {
+        char[] chars = chars256Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$intern(chars);
+        }
+    }
+
+    // Baseline for the cost of creating the new strings.
+    public void timeNewString256(int count) {
+        char[] chars = chars256;
+        for (int i = 0; i < count; ++i) {
+            $noinline$newString(chars);
+        }
+    }
+
+    static String $noinline$intern(char[] chars) {
+        if (doThrow) { throw new Error(); }
+        return new String(chars).intern();
+    }
+
+    static String $noinline$newString(char[] chars) {
+        if (doThrow) { throw new Error(); }
+        return new String(chars);
+    }
+
+    public static boolean doThrow = false;
+}
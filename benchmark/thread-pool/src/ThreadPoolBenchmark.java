@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class ThreadPoolBenchmark {
+  // Number of workers in the pools.
+  private static final int NUM_THREADS = 4;
+  // Depth of the task tree, which has 2^depth - 1 tasks.
+  private static final int DEPTH = 16;
+
+  public ThreadPoolBenchmark() {
+    // Make sure to link methods before benchmark starts.
+    System.loadLibrary("artbenchmark");
+    timeThreadPoolTree(1);
+    timeWorkStealingThreadPoolTree(1);
+  }
+
+  // Each call runs `reps` task trees on a pool created for the call.
+  private static native void runTrees(int reps, int numThreads, int depth, boolean workStealing);
+
+  public void timeThreadPoolTree(int reps) {
+    runTrees(reps, NUM_THREADS, DEPTH, /* workStealing= */ false);
+  }
+
+  public void timeWorkStealingThreadPoolTree(int reps) {
+    runTrees(reps, NUM_THREADS, DEPTH, /* workStealing= */ true);
+  }
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+
+#include "jni.h"
+
+#include "base/atomic.h"
+#include "thread-current-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace {
+
+class TreeTask : public Task {
+ public:
+  TreeTask(AbstractThreadPool* thread_pool, AtomicInteger* count, int depth)
+      : thread_pool_(thread_pool), count_(count), depth_(depth) {}
+
+  void Run(Thread* self) override {
+    if (depth_ > 1) {
+      thread_pool_->AddTask(self, new TreeTask(thread_pool_, count_, depth_ - 1));
+      thread_pool_->AddTask(self, new TreeTask(thread_pool_, count_, depth_ - 1));
+    }
+    ++*count_;
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  AbstractThreadPool* const thread_pool_;
+  AtomicInteger* const count_;
+  const int depth_;
+};
+
+extern "C" JNIEXPORT void JNICALL Java_ThreadPoolBenchmark_runTrees(
+    JNIEnv*, jclass, jint reps, jint num_threads, jint depth, jboolean work_stealing) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<AbstractThreadPool> thread_pool;
+  if (work_stealing) {
+    thread_pool.reset(WorkStealingThreadPool::Create("Benchmark thread pool", num_threads));
+  } else {
+    thread_pool.reset(ThreadPool::Create("Benchmark thread pool", num_threads));
+  }
+  thread_pool->StartWorkers(self);
+  for (jint i = 0; i < reps; ++i) {
+    AtomicInteger count(0);
+    thread_pool->AddTask(self, new TreeTask(thread_pool.get(), &count, depth));
+    thread_pool->Wait(self, /* do_work= */ false, /* may_hold_locks= */ false);
+    CHECK_EQ(count.load(std::memory_order_relaxed), (1 << depth) - 1);
+  }
+}
+
+}  // namespace
+}  // namespace art
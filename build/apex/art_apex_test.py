@@ -519,6 +519,7 @@ class ReleaseChecker:
     self._checker.check_native_library('liblzma')
     self._checker.check_native_library('libnpt')
     self._checker.check_native_library('libunwindstack')
+    self._checker.check_native_library('libzstd')
 
     # Allow extra dependencies that appear in ASAN builds.
     self._checker.check_optional_native_library('libclang_rt.asan*')
@@ -757,6 +758,7 @@ class TestingTargetChecker:
     self._checker.check_art_test_data('art-gtest-jars-Dex2oatVdexTestDex.jar')
     self._checker.check_art_test_data('art-gtest-jars-Dex2oatVdexPublicSdkDex.dex')
     self._checker.check_art_test_data('art-gtest-jars-SuperWithAccessChecks.dex')
+    self._checker.check_art_test_data('art-gtest-jars-CallGraph.jar')
 
     # Fuzzer cases
     self._checker.check_art_test_data("fuzzer_corpus.zip")
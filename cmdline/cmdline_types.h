@@ -557,6 +557,8 @@ struct XGcOption {
   bool verify_pre_gc_rosalloc_ = kIsDebugBuild;
   bool verify_pre_sweeping_rosalloc_ = false;
   bool verify_post_gc_rosalloc_ = false;
+  // Verify only a slice of the heap references in each GC, see `Heap::VerifyHeapReferences()`.
+  bool incremental_verify_heap_ = false;
   // Do no measurements for kUseTableLookupReadBarrier to avoid test timeouts. b/31679493
   bool measure_ = kIsDebugBuild && !kUseTableLookupReadBarrier;
   bool gcstress_ = false;
@@ -611,6 +613,10 @@ struct CmdlineType<XGcOption> : CmdlineTypeParser<XGcOption> {
         xgc.verify_post_gc_rosalloc_ = true;
       } else if (gc_option == "nopostverify_rosalloc") {
         xgc.verify_post_gc_rosalloc_ = false;
+      } else if (gc_option == "incrementalverify") {
+        xgc.incremental_verify_heap_ = true;
+      } else if (gc_option == "noincrementalverify") {
+        xgc.incremental_verify_heap_ = false;
       } else if (gc_option == "gcstress") {
         xgc.gcstress_ = true;
       } else if (gc_option == "nogcstress") {
@@ -634,7 +640,7 @@ struct CmdlineType<XGcOption> : CmdlineTypeParser<XGcOption> {
   static const char* DescribeType() {
     return "MS|nonconccurent|concurrent|CMS|SS|CC|[no]preverify[_rosalloc]|"
            "[no]presweepingverify[_rosalloc]|[no]generation_cc|[no]postverify[_rosalloc]|"
-           "[no]gcstress|measure|[no]precisce|[no]verifycardtable";
+           "[no]incrementalverify|[no]gcstress|measure|[no]precisce|[no]verifycardtable";
   }
 };
 
@@ -111,7 +111,7 @@ void WriteDebugInfo(ElfBuilder<ElfTypes>* builder,
 }
 
 template <typename ElfTypes>
-static std::vector<uint8_t> MakeMiniDebugInfoInternal(
+static std::vector<uint8_t> MakeMiniDebugInfoElfFileInternal(
     InstructionSet isa,
     [[maybe_unused]] const InstructionSetFeatures* features,
     typename ElfTypes::Addr text_section_address,
@@ -139,13 +139,10 @@ static std::vector<uint8_t> MakeMiniDebugInfoInternal(
   }
   builder->End();
   CHECK(builder->Good());
-  std::vector<uint8_t> compressed_buffer;
-  compressed_buffer.reserve(buffer.size() / 4);
-  XzCompress(ArrayRef<const uint8_t>(buffer), &compressed_buffer);
-  return compressed_buffer;
+  return buffer;
 }
 
-std::vector<uint8_t> MakeMiniDebugInfo(
+std::vector<uint8_t> MakeMiniDebugInfoElfFile(
     InstructionSet isa,
     const InstructionSetFeatures* features,
     uint64_t text_section_address,
@@ -154,24 +151,45 @@ std::vector<uint8_t> MakeMiniDebugInfo(
     size_t dex_section_size,
     const DebugInfo& debug_info) {
   if (Is64BitInstructionSet(isa)) {
-    return MakeMiniDebugInfoInternal<ElfTypes64>(isa,
-                                                 features,
-                                                 text_section_address,
-                                                 text_section_size,
-                                                 dex_section_address,
-                                                 dex_section_size,
-                                                 debug_info);
+    return MakeMiniDebugInfoElfFileInternal<ElfTypes64>(isa,
+                                                        features,
+                                                        text_section_address,
+                                                        text_section_size,
+                                                        dex_section_address,
+                                                        dex_section_size,
+                                                        debug_info);
   } else {
-    return MakeMiniDebugInfoInternal<ElfTypes32>(isa,
-                                                 features,
-                                                 text_section_address,
-                                                 text_section_size,
-                                                 dex_section_address,
-                                                 dex_section_size,
-                                                 debug_info);
+    return MakeMiniDebugInfoElfFileInternal<ElfTypes32>(isa,
+                                                        features,
+                                                        text_section_address,
+                                                        text_section_size,
+                                                        dex_section_address,
+                                                        dex_section_size,
+                                                        debug_info);
   }
 }
 
+std::vector<uint8_t> MakeMiniDebugInfo(
+    InstructionSet isa,
+    const InstructionSetFeatures* features,
+    uint64_t text_section_address,
+    size_t text_section_size,
+    uint64_t dex_section_address,
+    size_t dex_section_size,
+    const DebugInfo& debug_info) {
+  std::vector<uint8_t> buffer = MakeMiniDebugInfoElfFile(isa,
+                                                         features,
+                                                         text_section_address,
+                                                         text_section_size,
+                                                         dex_section_address,
+                                                         dex_section_size,
+                                                         debug_info);
+  std::vector<uint8_t> compressed_buffer;
+  compressed_buffer.reserve(buffer.size() / 4);
+  XzCompress(ArrayRef<const uint8_t>(buffer), &compressed_buffer);
+  return compressed_buffer;
+}
+
 std::vector<uint8_t> MakeElfFileForJIT(InstructionSet isa,
                                        [[maybe_unused]] const InstructionSetFeatures* features,
                                        bool mini_debug_info,
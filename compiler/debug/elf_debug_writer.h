@@ -41,6 +41,16 @@ EXPORT void WriteDebugInfo(
     ElfBuilder<ElfTypes>* builder,
     const DebugInfo& debug_info);
 
+// Returns the uncompressed ELF file which MakeMiniDebugInfo() compresses.
+EXPORT std::vector<uint8_t> MakeMiniDebugInfoElfFile(
+    InstructionSet isa,
+    const InstructionSetFeatures* features,
+    uint64_t text_section_address,
+    size_t text_section_size,
+    uint64_t dex_section_address,
+    size_t dex_section_size,
+    const DebugInfo& debug_info);
+
 EXPORT std::vector<uint8_t> MakeMiniDebugInfo(
     InstructionSet isa,
     const InstructionSetFeatures* features,
@@ -40,6 +40,7 @@ namespace art HIDDEN {
 CompilerOptions::CompilerOptions()
     : compiler_filter_(CompilerFilter::kDefaultCompilerFilter),
       huge_method_threshold_(kDefaultHugeMethodThreshold),
+      large_graph_threshold_(kDefaultLargeGraphThreshold),
       inline_max_code_units_(kUnsetInlineMaxCodeUnits),
       instruction_set_(kRuntimeISA == InstructionSet::kArm ? InstructionSet::kThumb2 : kRuntimeISA),
       instruction_set_features_(nullptr),
@@ -63,6 +64,7 @@ CompilerOptions::CompilerOptions()
       dump_timings_(false),
       dump_pass_timings_(false),
       dump_stats_(false),
+      num_slowest_methods_to_dump_(0u),
       profile_branches_(false),
       profile_compilation_info_(nullptr),
       verbose_methods_(),
@@ -120,10 +122,9 @@ bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
   if (option == "linear-scan") {
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
   } else if (option == "graph-color") {
-    LOG(ERROR) << "Graph coloring allocator has been removed, using linear scan instead.";
-    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
+    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorGraphColor;
   } else {
-    *error_msg = "Unrecognized register allocation strategy. Try linear-scan.";
+    *error_msg = "Unrecognized register allocation strategy. Try linear-scan or graph-color.";
     return false;
   }
   return true;
@@ -64,6 +64,7 @@ class CompilerOptions final {
   static constexpr bool kDefaultGenerateDebugInfo = false;
   static constexpr bool kDefaultGenerateMiniDebugInfo = true;
   static constexpr size_t kDefaultHugeMethodThreshold = 10000;
+  static constexpr size_t kDefaultLargeGraphThreshold = 20000;
   static constexpr size_t kDefaultInlineMaxCodeUnits = 32;
   // Token to represent no value set for `inline_max_code_units_`.
   static constexpr size_t kUnsetInlineMaxCodeUnits = -1;
@@ -128,6 +129,16 @@ class CompilerOptions final {
     return num_dalvik_instructions > huge_method_threshold_;
   }
 
+  size_t GetLargeGraphThreshold() const {
+    return large_graph_threshold_;
+  }
+
+  // Whether a graph with `num_instructions` instructions should only run the
+  // optimizations which scale linearly with its size.
+  bool IsLargeGraph(size_t num_instructions) const {
+    return num_instructions > large_graph_threshold_;
+  }
+
   size_t GetInlineMaxCodeUnits() const {
     return inline_max_code_units_;
   }
@@ -346,6 +357,12 @@ class CompilerOptions final {
     return dump_stats_;
   }
 
+  // Number of slowest methods to report along with the total time spent in each optimization
+  // pass, or 0 to not report pass timings over the whole compilation.
+  uint32_t GetNumSlowestMethodsToDump() const {
+    return num_slowest_methods_to_dump_;
+  }
+
   bool CountHotnessInCompiledCode() const {
     return count_hotness_in_compiled_code_;
   }
@@ -387,6 +404,7 @@ class CompilerOptions final {
 
   CompilerFilter::Filter compiler_filter_;
   size_t huge_method_threshold_;
+  size_t large_graph_threshold_;
   size_t inline_max_code_units_;
 
   InstructionSet instruction_set_;
@@ -425,6 +443,7 @@ class CompilerOptions final {
   bool dump_timings_;
   bool dump_pass_timings_;
   bool dump_stats_;
+  uint32_t num_slowest_methods_to_dump_;
   bool profile_branches_;
 
   // Info for profile guided compilation.
@@ -57,6 +57,7 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
   }
   map.AssignIfExists(Base::CompileArtTest, &options->compile_art_test_);
   map.AssignIfExists(Base::HugeMethodMaxThreshold, &options->huge_method_threshold_);
+  map.AssignIfExists(Base::LargeGraphThreshold, &options->large_graph_threshold_);
   map.AssignIfExists(Base::InlineMaxCodeUnitsThreshold, &options->inline_max_code_units_);
   map.AssignIfExists(Base::GenerateDebugInfo, &options->generate_debug_info_);
   map.AssignIfExists(Base::GenerateMiniDebugInfo, &options->generate_mini_debug_info_);
@@ -106,6 +107,8 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->dump_pass_timings_ = true;
   }
 
+  map.AssignIfExists(Base::DumpSlowestMethods, &options->num_slowest_methods_to_dump_);
+
   if (map.Exists(Base::DumpStats)) {
     options->dump_stats_ = true;
   }
@@ -133,6 +136,11 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .template WithType<unsigned int>()
           .WithHelp("threshold size for a huge method for compiler filter tuning.")
           .IntoKey(Map::HugeMethodMaxThreshold)
+      .Define("--large-graph-threshold=_")
+          .template WithType<unsigned int>()
+          .WithHelp("the number of instructions above which a method only runs the cheaper\n"
+                    "optimizations, to bound its compilation time.")
+          .IntoKey(Map::LargeGraphThreshold)
       .Define("--inline-max-code-units=_")
           .template WithType<unsigned int>()
           .WithHelp("the maximum code units that a methodcan have to be considered for inlining.\n"
@@ -184,6 +192,13 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
                     " method.")
           .IntoKey(Map::DumpPassTimings)
 
+      .Define("--dump-slowest-methods=_")
+          .template WithType<unsigned int>()
+          .WithHelp("Display the total time spent in each optimization pass, and the given number"
+                    " of methods that took the longest to compile with the time of each of their"
+                    " passes.")
+          .IntoKey(Map::DumpSlowestMethods)
+
       .Define({"--dump-stats"})
           .WithHelp("Display overall compilation statistics.")
           .IntoKey(Map::DumpStats)
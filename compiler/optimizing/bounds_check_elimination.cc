@@ -550,7 +550,9 @@ class BCEVisitor final : public HGraphVisitor {
     }
     // We should never deoptimize from an osr method, otherwise we might wrongly optimize
     // code dominated by the deoptimization.
-    if (!GetGraph()->IsCompilingOsr()) {
+    // Also don't if such a deoptimization already happened too often for this method.
+    if (!GetGraph()->IsCompilingOsr() &&
+        GetGraph()->CanSpeculate(DeoptimizationKind::kBlockBCE)) {
       AddComparesWithDeoptimization(block);
     }
   }
@@ -929,6 +931,7 @@ class BCEVisitor final : public HGraphVisitor {
           // Do this test last, since it may generate code.
           CanHandleLength(loop, array_length, needs_taken_test)) {
         TransformLoopForDeoptimizationIfNeeded(loop, needs_taken_test);
+        TransformLoopForFiniteTestIfNeeded(loop, bounds_check, needs_finite_test);
         TransformLoopForDynamicBCE(loop, bounds_check);
         return;
       }
@@ -1604,7 +1607,8 @@ class BCEVisitor final : public HGraphVisitor {
           int32_t other_c = ValueBound::AsValueBound(other_index).GetConstant();
           // Generate code for either the maximum or minimum. Range analysis already was queried
           // whether code generation on the original and, thus, related bounds check was possible.
-          // It handles either loop invariants (lower is not set) or unit strides.
+          // It handles either loop invariants (lower is not set), unit strides or non-unit
+          // strides in lock-step with the loop control.
           if (other_c == max_c) {
             induction_range_.GenerateRange(other_bounds_check->GetBlock(),
                                            other_index,
@@ -1629,7 +1633,7 @@ class BCEVisitor final : public HGraphVisitor {
       // (2) two symbolic invariants
       //       if (min_upper >  max_upper) deoptimize;   unless min_c == max_c
       //       if (max_upper >= a.length ) deoptimize;
-      // (3) general case, unit strides (where lower would exceed upper for arithmetic wrap-around)
+      // (3) general case, linear (where lower would exceed upper for arithmetic wrap-around)
       //       if (min_lower >  max_lower) deoptimize;   unless min_c == max_c
       //       if (max_lower >  max_upper) deoptimize;
       //       if (max_upper >= a.length ) deoptimize;
@@ -1650,7 +1654,7 @@ class BCEVisitor final : public HGraphVisitor {
                  max_lower == nullptr && max_upper != nullptr);
         }
       } else {
-        // General case, unit strides.
+        // General case, linear.
         if (min_c != max_c) {
           DCHECK(min_lower != nullptr && min_upper != nullptr &&
                  max_lower != nullptr && max_upper != nullptr);
@@ -1685,6 +1689,12 @@ class BCEVisitor final : public HGraphVisitor {
       if (GetGraph()->IsCompilingOsr()) {
         return false;
       }
+      // Don't speculate again if previously compiled code for the method
+      // deoptimized too often because of loop-based dynamic bce.
+      if (!GetGraph()->CanSpeculate(DeoptimizationKind::kLoopBoundsBCE) ||
+          !GetGraph()->CanSpeculate(DeoptimizationKind::kLoopNullBCE)) {
+        return false;
+      }
       // A try boundary preheader is hard to handle.
       // TODO: remove this restriction.
       if (loop->GetPreHeader()->GetLastInstruction()->IsTryBoundary()) {
@@ -1782,10 +1792,16 @@ class BCEVisitor final : public HGraphVisitor {
       if (finite_loop_.find(loop_id) != finite_loop_.end()) {
         return true;
       }
+      // With a non-unit stride, the loop control may step over the upper bound and wrap
+      // around even if the runtime tests pass, so this needs an explicit finite-test
+      // (generated by TransformLoopForFiniteTestIfNeeded()).
+      HInstruction* control = loop->GetHeader()->GetLastInstruction();
+      if (induction_range_.CanGenerateFiniteTest(control)) {
+        return true;
+      }
       // Otherwise, allow dynamic bce if the index (which is necessarily an induction at
       // this point) is the direct loop index (viz. a[i]), since then the runtime tests
       // ensure upper bound cannot cause an infinite loop.
-      HInstruction* control = loop->GetHeader()->GetLastInstruction();
       if (control->IsIf()) {
         HInstruction* if_expr = control->AsIf()->InputAt(0);
         if (if_expr->IsCondition()) {
@@ -1824,14 +1840,21 @@ class BCEVisitor final : public HGraphVisitor {
     return loop->GetPreHeader();
   }
 
-  /** Inserts a deoptimization test in a loop preheader. */
+  /**
+   * Inserts a deoptimization test in a loop preheader. The condition is inserted as well,
+   * unless it was already generated there.
+   */
   void InsertDeoptInLoop(HLoopInformation* loop,
                          HBasicBlock* block,
                          HInstruction* condition,
                          bool is_null_check = false) {
     HInstruction* suspend = loop->GetSuspendCheck();
     DCHECK(suspend != nullptr);
-    block->InsertInstructionBefore(condition, block->GetLastInstruction());
+    if (!condition->IsInBlock()) {
+      block->InsertInstructionBefore(condition, block->GetLastInstruction());
+    } else {
+      DCHECK_EQ(condition->GetBlock(), block);
+    }
     DeoptimizationKind kind =
         is_null_check ? DeoptimizationKind::kLoopNullBCE : DeoptimizationKind::kLoopBoundsBCE;
     HDeoptimize* deoptimize = new (GetGraph()->GetAllocator()) HDeoptimize(
@@ -1931,6 +1954,30 @@ class BCEVisitor final : public HGraphVisitor {
     taken_test_loop_.Put(loop_id, true_block);
   }
 
+  /**
+   * Inserts a deoptimization on an explicit finite-test for a loop with a non-unit stride,
+   * unless the loop is already known to be finite.
+   *
+   * Example (for a loop with stride 2):
+   *   if (upper > MAX - 1) deoptimize;
+   *   for (int i = lower; i < upper; i += 2) {
+   *     array[i] = 0;
+   *   }
+   */
+  void TransformLoopForFiniteTestIfNeeded(HLoopInformation* loop,
+                                          HBoundsCheck* bounds_check,
+                                          bool needs_finite_test) {
+    const uint32_t loop_id = loop->GetHeader()->GetBlockId();
+    if (!needs_finite_test || finite_loop_.find(loop_id) != finite_loop_.end()) {
+      return;
+    }
+    HBasicBlock* block = GetPreHeader(loop, bounds_check);
+    HInstruction* condition = induction_range_.GenerateFiniteTest(
+        loop->GetHeader()->GetLastInstruction(), GetGraph(), block);
+    InsertDeoptInLoop(loop, block, condition);
+    finite_loop_.insert(loop_id);
+  }
+
   /**
    * Inserts phi nodes that preserve SSA structure in generated top test structures.
    * All uses of instructions in the deoptimization block that reach the loop need
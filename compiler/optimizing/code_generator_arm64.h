@@ -144,6 +144,11 @@ Location ARM64ReturnLocation(DataType::Type return_type);
   V(StringBuilderToString)                    \
   V(SystemArrayCopyByte)                      \
   V(SystemArrayCopyInt)                       \
+  V(SystemArrayCopyBoolean)                   \
+  V(SystemArrayCopyShort)                     \
+  V(SystemArrayCopyLong)                      \
+  V(SystemArrayCopyFloat)                     \
+  V(SystemArrayCopyDouble)                    \
   /* 1.8 */                                   \
   V(MethodHandleInvokeExact)                  \
   V(MethodHandleInvoke)
@@ -127,6 +127,8 @@ using VIXLUInt32Literal = vixl::aarch32::Literal<uint32_t>;
   V(CRC32Update)                                                           \
   V(CRC32UpdateBytes)                                                      \
   V(CRC32UpdateByteBuffer)                                                 \
+  V(CRC32CUpdateBytes)                                                     \
+  V(CRC32CUpdateDirectByteBuffer)                                          \
   V(FP16ToFloat)                                                           \
   V(FP16ToHalf)                                                            \
   V(FP16Floor)                                                             \
@@ -159,6 +161,11 @@ using VIXLUInt32Literal = vixl::aarch32::Literal<uint32_t>;
   V(StringBuilderToString)                                                 \
   V(SystemArrayCopyByte)                                                   \
   V(SystemArrayCopyInt)                                                    \
+  V(SystemArrayCopyBoolean)                                                \
+  V(SystemArrayCopyShort)                                                  \
+  V(SystemArrayCopyLong)                                                   \
+  V(SystemArrayCopyFloat)                                                  \
+  V(SystemArrayCopyDouble)                                                 \
   /* 1.8 */                                                                \
   V(MathFmaDouble)                                                         \
   V(MathFmaFloat)                                                          \
@@ -59,6 +59,11 @@ static constexpr int32_t kFClassNaNMinValue = 0x100;
   V(SystemArrayCopyByte)                        \
   V(SystemArrayCopyChar)                        \
   V(SystemArrayCopyInt)                         \
+  V(SystemArrayCopyBoolean)                     \
+  V(SystemArrayCopyShort)                       \
+  V(SystemArrayCopyLong)                        \
+  V(SystemArrayCopyFloat)                       \
+  V(SystemArrayCopyDouble)                      \
   V(FP16Ceil)                                   \
   V(FP16Compare)                                \
   V(FP16Floor)                                  \
@@ -94,6 +99,8 @@ static constexpr int32_t kFClassNaNMinValue = 0x100;
   V(CRC32Update)                                \
   V(CRC32UpdateBytes)                           \
   V(CRC32UpdateByteBuffer)                      \
+  V(CRC32CUpdateBytes)                          \
+  V(CRC32CUpdateDirectByteBuffer)               \
   V(MethodHandleInvokeExact)                    \
   V(MethodHandleInvoke)
 
@@ -1336,9 +1336,20 @@ void InstructionCodeGeneratorARM64Sve::VisitVecPredToBoolean(HVecPredToBoolean*
   DCHECK(!instruction->IsPredicated());
   Register reg = OutputRegister(instruction);
   // Currently VecPredToBoolean is only used as part of vectorized loop check condition
-  // evaluation.
-  DCHECK(instruction->GetPCondKind() == HVecPredToBoolean::PCondKind::kNFirst);
-  __ Cset(reg, pl);
+  // evaluation and of the early exit test of vectorized search loops; the flags are set by
+  // the immediately preceding predicate setting instruction.
+  switch (instruction->GetPCondKind()) {
+    case HVecPredToBoolean::PCondKind::kNFirst:
+      __ Cset(reg, pl);
+      break;
+    case HVecPredToBoolean::PCondKind::kAny:
+      __ Cset(reg, ne);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported condition kind: "
+                 << static_cast<int>(instruction->GetPCondKind());
+      UNREACHABLE();
+  }
 }
 
 Location InstructionCodeGeneratorARM64Sve::AllocateSIMDScratchLocation(
@@ -6940,6 +6940,13 @@ void InstructionCodeGeneratorX86::VisitSuspendCheck(HSuspendCheck* instruction)
 
 void InstructionCodeGeneratorX86::GenerateSuspendCheck(HSuspendCheck* instruction,
                                                        HBasicBlock* successor) {
+  if (instruction->IsNoOp()) {
+    if (successor != nullptr) {
+      __ jmp(codegen_->GetLabelOf(successor));
+    }
+    return;
+  }
+
   SuspendCheckSlowPathX86* slow_path =
       down_cast<SuspendCheckSlowPathX86*>(instruction->GetSlowPath());
   if (slow_path == nullptr) {
@@ -6954,7 +6961,9 @@ void InstructionCodeGeneratorX86::GenerateSuspendCheck(HSuspendCheck* instructio
     DCHECK_EQ(slow_path->GetSuccessor(), successor);
   }
 
-  __ fs()->testl(Address::Absolute(Thread::ThreadFlagsOffset<kX86PointerSize>().Int32Value()),
+  // The flags fit in the low byte, which makes for a shorter encoding.
+  static_assert(IsInt<8>(Thread::SuspendOrCheckpointRequestFlags()));
+  __ fs()->testb(Address::Absolute(Thread::ThreadFlagsOffset<kX86PointerSize>().Int32Value()),
                  Immediate(Thread::SuspendOrCheckpointRequestFlags()));
   if (successor == nullptr) {
     __ j(kNotZero, slow_path->GetEntryLabel());
@@ -58,6 +58,8 @@ static constexpr size_t kRuntimeParameterFpuRegistersLength =
   V(CRC32Update)                            \
   V(CRC32UpdateBytes)                       \
   V(CRC32UpdateByteBuffer)                  \
+  V(CRC32CUpdateBytes)                      \
+  V(CRC32CUpdateDirectByteBuffer)           \
   V(FP16ToFloat)                            \
   V(FP16ToHalf)                             \
   V(FP16Floor)                              \
@@ -31,6 +31,10 @@
 
 namespace art HIDDEN {
 
+// Minimum ratio between the counts of the two edges of a profiled branch for the
+// less taken edge to be considered uncommon.
+static constexpr uint32_t kUncommonBranchRatio = 100u;
+
 bool CodeSinking::Run() {
   if (graph_->GetExitBlock() == nullptr) {
     // Infinite loop, just bail.
@@ -45,8 +49,8 @@ bool CodeSinking::Run() {
 void CodeSinking::UncommonBranchSinking() {
   HBasicBlock* exit = graph_->GetExitBlock();
   DCHECK(exit != nullptr);
-  // TODO(ngeoffray): we do not profile branches yet, so use throw instructions
-  // as an indicator of an uncommon branch.
+  // Use throw instructions as an indicator of an uncommon branch. Branches profiled
+  // by the baseline compiled code are handled below.
   for (HBasicBlock* exit_predecessor : exit->GetPredecessors()) {
     HInstruction* last = exit_predecessor->GetLastInstruction();
 
@@ -71,6 +75,29 @@ void CodeSinking::UncommonBranchSinking() {
       SinkCodeToUncommonBranch(exit_predecessor);
     }
   }
+
+  // Also sink into the successors of profiled branches which were rarely taken. Only
+  // consider successors which can be reached from the branch alone, so that the code
+  // sunk there does not run on other paths.
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    HIf* if_instruction = block->GetLastInstruction()->AsIfOrNull();
+    if (if_instruction == nullptr || !if_instruction->HasBranchProfile()) {
+      continue;
+    }
+    uint32_t true_count = if_instruction->GetTrueCount();
+    uint32_t false_count = if_instruction->GetFalseCount();
+    HBasicBlock* uncommon_block = nullptr;
+    if (true_count * kUncommonBranchRatio < false_count) {
+      uncommon_block = if_instruction->IfTrueSuccessor();
+    } else if (false_count * kUncommonBranchRatio < true_count) {
+      uncommon_block = if_instruction->IfFalseSuccessor();
+    }
+    if (uncommon_block != nullptr &&
+        uncommon_block->GetSinglePredecessor() == block &&
+        !uncommon_block->IsCatchBlock()) {
+      SinkCodeToUncommonBranch(uncommon_block);
+    }
+  }
 }
 
 static bool IsInterestingInstruction(HInstruction* instruction) {
@@ -339,9 +366,7 @@ void CodeSinking::SinkCodeToUncommonBranch(HBasicBlock* end_block) {
 
   // Step (1): Visit post order to get a subset of blocks post dominated by `end_block`.
   // TODO(ngeoffray): Getting the full set of post-dominated should be done by
-  // computing the post dominator tree, but that could be too time consuming. Also,
-  // we should start the analysis from blocks dominated by an uncommon branch, but we
-  // don't profile branches yet.
+  // computing the post dominator tree, but that could be too time consuming.
   bool found_block = false;
   for (HBasicBlock* block : graph_->GetPostOrder()) {
     if (block == end_block) {
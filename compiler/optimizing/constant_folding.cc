@@ -22,6 +22,7 @@
 #include "base/casts.h"
 #include "base/logging.h"
 #include "dex/dex_file-inl.h"
+#include "dex/utf-inl.h"
 #include "intrinsics_enum.h"
 #include "optimizing/data_type.h"
 #include "optimizing/nodes.h"
@@ -48,6 +49,7 @@ class HConstantFoldingVisitor final : public HGraphDelegateVisitor {
   // with Select(15, 25, condition).
   bool TryRemoveBinaryOperationViaSelect(HBinaryOperation* inst);
 
+  void VisitArrayGet(HArrayGet* inst) override;
   void VisitArrayLength(HArrayLength* inst) override;
   void VisitDivZeroCheck(HDivZeroCheck* inst) override;
   void VisitIf(HIf* inst) override;
@@ -589,6 +591,51 @@ void HConstantFoldingVisitor::FoldNumberOfTrailingZerosIntrinsic(HInvoke* inst)
   inst->GetBlock()->RemoveInstruction(inst);
 }
 
+void HConstantFoldingVisitor::VisitArrayGet(HArrayGet* inst) {
+  // Constant folding: replace `String.charAt(index)` on a const-string with a constant
+  // index by the character, read from the dex file. The bounds check is left for BCE.
+  if (!inst->IsStringCharAt() || !inst->GetArray()->IsLoadString()) {
+    return;
+  }
+  HInstruction* index = inst->GetIndex();
+  if (index->IsBoundsCheck()) {
+    index = index->AsBoundsCheck()->GetIndex();
+  }
+  if (!index->IsIntConstant()) {
+    return;
+  }
+  HLoadString* load_string = inst->GetArray()->AsLoadString();
+  const DexFile& dex_file = load_string->GetDexFile();
+  uint32_t utf16_length;
+  const char* data =
+      dex_file.StringDataAndUtf16LengthByIdx(load_string->GetStringIndex(), &utf16_length);
+  int32_t char_index = index->AsIntConstant()->GetValue();
+  if (char_index < 0 || static_cast<uint32_t>(char_index) >= utf16_length) {
+    // The access throws, don't constant fold.
+    return;
+  }
+  // Decode the string up to the requested UTF-16 code unit. Supplementary characters
+  // are encoded as a surrogate pair, i.e. two code units.
+  uint16_t c = 0u;
+  for (int32_t i = 0; ; ++i) {
+    uint32_t pair = GetUtf16FromUtf8(&data);
+    if (i == char_index) {
+      c = GetLeadingUtf16Char(pair);
+      break;
+    }
+    uint16_t trailing = GetTrailingUtf16Char(pair);
+    if (trailing != 0u) {
+      ++i;
+      if (i == char_index) {
+        c = trailing;
+        break;
+      }
+    }
+  }
+  inst->ReplaceWith(GetGraph()->GetIntConstant(c));
+  inst->GetBlock()->RemoveInstruction(inst);
+}
+
 void HConstantFoldingVisitor::VisitArrayLength(HArrayLength* inst) {
   HInstruction* input = inst->InputAt(0);
   if (input->IsLoadString()) {
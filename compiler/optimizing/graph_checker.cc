@@ -1351,6 +1351,12 @@ void GraphChecker::VisitStaticFieldSet(HStaticFieldSet* instruction) {
   }
 }
 
+// A suspend check that was made a no-op does not generate any code, so it is not a GC point.
+static bool CanTriggerGC(HInstruction* instruction) {
+  return instruction->GetSideEffects().Includes(SideEffects::CanTriggerGC()) &&
+         !(instruction->IsSuspendCheck() && instruction->AsSuspendCheck()->IsNoOp());
+}
+
 template <typename GetWriteBarrierKind>
 void GraphChecker::CheckWriteBarrier(HInstruction* instruction,
                                      GetWriteBarrierKind&& get_write_barrier_kind) {
@@ -1359,39 +1365,80 @@ void GraphChecker::CheckWriteBarrier(HInstruction* instruction,
          instruction->IsArraySet());
 
   // For removed write barriers, we expect that the write barrier they are relying on is:
-  // A) In the same block, and
-  // B) There's no instruction between them that can trigger a GC.
+  // A) In the same block or in a dominator, and
+  // B) There's no instruction that can trigger a GC on any path between them.
   HInstruction* object = HuntForOriginalReference(instruction->InputAt(0));
-  bool found = false;
-  for (HBackwardInstructionIterator it(instruction); !it.Done(); it.Advance()) {
-    if (instruction->GetKind() == it.Current()->GetKind() &&
-        object == HuntForOriginalReference(it.Current()->InputAt(0)) &&
-        get_write_barrier_kind(it.Current()) == WriteBarrierKind::kEmitBeingReliedOn) {
-      // Found the write barrier we are relying on.
-      found = true;
-      break;
-    }
-
-    // We check the `SideEffects::CanTriggerGC` after failing to find the write barrier since having
-    // a write barrier that's relying on an ArraySet that can trigger GC is fine because the card
-    // table is marked after the GC happens.
-    if (it.Current()->GetSideEffects().Includes(SideEffects::CanTriggerGC())) {
-      AddError(
-          StringPrintf("%s %d from block %d was expecting a write barrier and it didn't find "
-                       "any. %s %d can trigger GC",
-                       instruction->DebugName(),
-                       instruction->GetId(),
-                       instruction->GetBlock()->GetBlockId(),
-                       it.Current()->DebugName(),
-                       it.Current()->GetId()));
+  HInstruction* write_barrier = nullptr;
+  for (HBasicBlock* block = instruction->GetBlock();
+       block != nullptr && write_barrier == nullptr;
+       block = block->GetDominator()) {
+    HBackwardInstructionIterator it = (block == instruction->GetBlock())
+        ? HBackwardInstructionIterator(instruction->GetPrevious())
+        : HBackwardInstructionIterator(block->GetInstructions());
+    for (; !it.Done(); it.Advance()) {
+      if (instruction->GetKind() == it.Current()->GetKind() &&
+          object == HuntForOriginalReference(it.Current()->InputAt(0)) &&
+          get_write_barrier_kind(it.Current()) == WriteBarrierKind::kEmitBeingReliedOn) {
+        // Found the write barrier we are relying on.
+        write_barrier = it.Current();
+        break;
+      }
     }
   }
 
-  if (!found) {
+  if (write_barrier == nullptr) {
     AddError(StringPrintf("%s %d in block %d didn't find a write barrier to latch onto",
                           instruction->DebugName(),
                           instruction->GetId(),
                           instruction->GetBlock()->GetBlockId()));
+    return;
+  }
+
+  auto check_no_gc = [&](HInstruction* first, HInstruction* end) {
+    for (HInstruction* current = first; current != end; current = current->GetNext()) {
+      // Having a write barrier that's relying on an ArraySet that can trigger GC is fine since
+      // the card table is marked after the GC happens, so we start after `write_barrier`.
+      if (CanTriggerGC(current)) {
+        AddError(
+            StringPrintf("%s %d from block %d was expecting a write barrier and it didn't find "
+                         "any. %s %d can trigger GC",
+                         instruction->DebugName(),
+                         instruction->GetId(),
+                         instruction->GetBlock()->GetBlockId(),
+                         current->DebugName(),
+                         current->GetId()));
+      }
+    }
+  };
+
+  HBasicBlock* write_barrier_block = write_barrier->GetBlock();
+  if (write_barrier_block == instruction->GetBlock()) {
+    check_no_gc(write_barrier->GetNext(), instruction);
+    return;
+  }
+  // Check every block on a path from `write_barrier` to `instruction`, i.e. the blocks reached
+  // backwards from `instruction` without going through the block of `write_barrier`. Since the
+  // latter dominates the block of `instruction`, all such paths go through it.
+  check_no_gc(write_barrier->GetNext(), nullptr);
+  check_no_gc(instruction->GetBlock()->GetFirstInstruction(), instruction);
+  ArenaBitVector visited(&allocator_,
+                         GetGraph()->GetBlocks().size(),
+                         /* expandable= */ false,
+                         kArenaAllocGraphChecker);
+  ScopedArenaVector<HBasicBlock*> worklist(allocator_.Adapter(kArenaAllocGraphChecker));
+  visited.SetBit(write_barrier_block->GetBlockId());
+  worklist.push_back(instruction->GetBlock());
+  while (!worklist.empty()) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    for (HBasicBlock* predecessor : block->GetPredecessors()) {
+      if (!visited.IsBitSet(predecessor->GetBlockId())) {
+        visited.SetBit(predecessor->GetBlockId());
+        // If `instruction` is in a loop, its own block is checked in full for the back edge.
+        check_no_gc(predecessor->GetFirstInstruction(), nullptr);
+        worklist.push_back(predecessor);
+      }
+    }
   }
 }
 
@@ -21,6 +21,7 @@
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "base/utils.h"
+#include "load_store_analysis.h"
 #include "side_effects_analysis.h"
 
 namespace art HIDDEN {
@@ -130,6 +131,16 @@ class ValueSet : public ArenaObject<kArenaAllocGvn> {
     });
   }
 
+  // Removes all instructions in the set affected by the given side effects,
+  // except those for which `is_preserved` returns true.
+  template <typename Predicate>
+  void Kill(SideEffects side_effects, Predicate&& is_preserved) {
+    DeleteAllImpureWhich([side_effects, &is_preserved](Node* node) {
+      return node->GetSideEffects().MayDependOn(side_effects) &&
+             !is_preserved(node->GetInstruction());
+    });
+  }
+
   void Clear() {
     num_entries_ = 0;
     for (size_t i = 0; i < num_buckets_; ++i) {
@@ -353,10 +364,13 @@ class ValueSet : public ArenaObject<kArenaAllocGvn> {
  */
 class GlobalValueNumberer : public ValueObject {
  public:
-  GlobalValueNumberer(HGraph* graph, const SideEffectsAnalysis& side_effects)
+  GlobalValueNumberer(HGraph* graph,
+                      const SideEffectsAnalysis& side_effects,
+                      const HeapLocationCollector* heap_location_collector)
       : graph_(graph),
         allocator_(graph->GetArenaStack()),
         side_effects_(side_effects),
+        heap_location_collector_(heap_location_collector),
         sets_(graph->GetBlocks().size(), nullptr, allocator_.Adapter(kArenaAllocGvn)),
         visited_blocks_(
             &allocator_, graph->GetBlocks().size(), /* expandable= */ false, kArenaAllocGvn) {}
@@ -368,9 +382,20 @@ class GlobalValueNumberer : public ValueObject {
   // successor blocks.
   void VisitBasicBlock(HBasicBlock* block);
 
+  // Kill the values in `set` which may be changed by the loop of `header`. With
+  // heap location information, field loads are only killed if the loop may
+  // store to the location they read.
+  void KillLoopEffects(ValueSet* set, HBasicBlock* header);
+
+  // Returns the heap location of the field accessed by `instruction`, or
+  // HeapLocationCollector::kHeapLocationNotFound.
+  size_t GetFieldHeapLocation(HInstruction* instruction) const;
+
   HGraph* graph_;
   ScopedArenaAllocator allocator_;
   const SideEffectsAnalysis& side_effects_;
+  // Heap locations of the graph, or null if load/store analysis did not run.
+  const HeapLocationCollector* const heap_location_collector_;
 
   ValueSet* FindSetFor(HBasicBlock* block) const {
     ValueSet* result = sets_[block->GetBlockId()];
@@ -467,7 +492,7 @@ void GlobalValueNumberer::VisitBasicBlock(HBasicBlock* block) {
         } else {
           DCHECK(!block->GetLoopInformation()->IsIrreducible());
           DCHECK_EQ(block->GetDominator(), block->GetLoopInformation()->GetPreHeader());
-          set->Kill(side_effects_.GetLoopEffects(block));
+          KillLoopEffects(set, block);
         }
       } else if (predecessors.size() > 1) {
         for (HBasicBlock* predecessor : predecessors) {
@@ -521,6 +546,72 @@ void GlobalValueNumberer::VisitBasicBlock(HBasicBlock* block) {
   visited_blocks_.SetBit(block->GetBlockId());
 }
 
+void GlobalValueNumberer::KillLoopEffects(ValueSet* set, HBasicBlock* header) {
+  SideEffects loop_effects = side_effects_.GetLoopEffects(header);
+  if (heap_location_collector_ == nullptr || !loop_effects.DoesAnyWrite()) {
+    set->Kill(loop_effects);
+    return;
+  }
+
+  // Collect the heap locations of the field stores in the loop, and the side
+  // effects of all other instructions, which are handled conservatively.
+  SideEffects other_effects = SideEffects::None();
+  ScopedArenaVector<size_t> stored_locations(allocator_.Adapter(kArenaAllocGvn));
+  for (HBlocksInLoopIterator it(*header->GetLoopInformation()); !it.Done(); it.Advance()) {
+    for (HInstructionIterator inst_it(it.Current()->GetInstructions());
+         !inst_it.Done();
+         inst_it.Advance()) {
+      HInstruction* instruction = inst_it.Current();
+      size_t location = HeapLocationCollector::kHeapLocationNotFound;
+      if ((instruction->IsInstanceFieldSet() && !instruction->AsInstanceFieldSet()->IsVolatile()) ||
+          (instruction->IsStaticFieldSet() && !instruction->AsStaticFieldSet()->IsVolatile())) {
+        location = GetFieldHeapLocation(instruction);
+      }
+      if (location != HeapLocationCollector::kHeapLocationNotFound) {
+        stored_locations.push_back(location);
+      } else {
+        other_effects = other_effects.Union(instruction->GetSideEffects());
+      }
+    }
+  }
+
+  set->Kill(loop_effects, [&](HInstruction* instruction) {
+    if (!instruction->IsInstanceFieldGet() && !instruction->IsStaticFieldGet()) {
+      return false;
+    }
+    if (instruction->GetSideEffects().MayDependOn(other_effects)) {
+      return false;
+    }
+    size_t location = GetFieldHeapLocation(instruction);
+    if (location == HeapLocationCollector::kHeapLocationNotFound) {
+      return false;
+    }
+    for (size_t stored_location : stored_locations) {
+      if (stored_location == location ||
+          heap_location_collector_->MayAlias(stored_location, location)) {
+        return false;
+      }
+    }
+    return true;
+  });
+}
+
+size_t GlobalValueNumberer::GetFieldHeapLocation(HInstruction* instruction) const {
+  DCHECK(heap_location_collector_ != nullptr);
+  const FieldInfo* field_info = nullptr;
+  if (instruction->IsInstanceFieldGet()) {
+    field_info = &instruction->AsInstanceFieldGet()->GetFieldInfo();
+  } else if (instruction->IsStaticFieldGet()) {
+    field_info = &instruction->AsStaticFieldGet()->GetFieldInfo();
+  } else if (instruction->IsInstanceFieldSet()) {
+    field_info = &instruction->AsInstanceFieldSet()->GetFieldInfo();
+  } else {
+    DCHECK(instruction->IsStaticFieldSet());
+    field_info = &instruction->AsStaticFieldSet()->GetFieldInfo();
+  }
+  return heap_location_collector_->GetFieldHeapLocation(instruction->InputAt(0), field_info);
+}
+
 bool GlobalValueNumberer::WillBeReferencedAgain(HBasicBlock* block) const {
   DCHECK(visited_blocks_.IsBitSet(block->GetBlockId()));
 
@@ -574,7 +665,13 @@ HBasicBlock* GlobalValueNumberer::FindVisitedBlockWithRecyclableSet(
 }
 
 bool GVNOptimization::Run() {
-  GlobalValueNumberer gvn(graph_, side_effects_);
+  // Load/store analysis lets loop headers keep the field loads that the loop does not
+  // write, so it is only worth running on graphs with loops.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  LoadStoreAnalysis lsa(graph_, /* stats= */ nullptr, &allocator);
+  const HeapLocationCollector* heap_location_collector =
+      (graph_->HasLoops() && lsa.Run()) ? &lsa.GetHeapLocationCollector() : nullptr;
+  GlobalValueNumberer gvn(graph_, side_effects_, heap_location_collector);
   return gvn.Run();
 }
 
@@ -305,6 +305,85 @@ TEST_F(GVNTest, LoopFieldElimination) {
   ASSERT_TRUE(field_get_in_exit->GetBlock() == nullptr);
 }
 
+// Test that a field load before the loop is reused in the loop, when the loop
+// only stores to a different field of the same type.
+TEST_F(GVNTest, LoopFieldEliminationWithHeapLocations) {
+  HGraph* graph = CreateGraph();
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+
+  HInstruction* parameter = new (GetAllocator()) HParameterValue(graph->GetDexFile(),
+                                                                 dex::TypeIndex(0),
+                                                                 0,
+                                                                 DataType::Type::kReference);
+  entry->AddInstruction(parameter);
+
+  HBasicBlock* block = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(block);
+  entry->AddSuccessor(block);
+  block->AddInstruction(new (GetAllocator()) HInstanceFieldGet(parameter,
+                                                               nullptr,
+                                                               DataType::Type::kBool,
+                                                               MemberOffset(42),
+                                                               false,
+                                                               kUnknownFieldIndex,
+                                                               kUnknownClassDefIndex,
+                                                               graph->GetDexFile(),
+                                                               0));
+  HInstruction* field_get = block->GetLastInstruction();
+  block->AddInstruction(new (GetAllocator()) HGoto());
+
+  HBasicBlock* loop_header = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* loop_body = new (GetAllocator()) HBasicBlock(graph);
+  HBasicBlock* exit = new (GetAllocator()) HBasicBlock(graph);
+
+  graph->AddBlock(loop_header);
+  graph->AddBlock(loop_body);
+  graph->AddBlock(exit);
+  block->AddSuccessor(loop_header);
+  loop_header->AddSuccessor(loop_body);
+  loop_header->AddSuccessor(exit);
+  loop_body->AddSuccessor(loop_header);
+
+  loop_header->AddInstruction(new (GetAllocator()) HIf(field_get));
+
+  // The store writes a field of the same type, so side effects alone would kill
+  // `field_get` at the loop header. Heap locations tell that the fields differ.
+  loop_body->AddInstruction(new (GetAllocator()) HInstanceFieldSet(parameter,
+                                                                   parameter,
+                                                                   nullptr,
+                                                                   DataType::Type::kBool,
+                                                                   MemberOffset(43),
+                                                                   false,
+                                                                   kUnknownFieldIndex,
+                                                                   kUnknownClassDefIndex,
+                                                                   graph->GetDexFile(),
+                                                                   0));
+  loop_body->AddInstruction(new (GetAllocator()) HInstanceFieldGet(parameter,
+                                                                   nullptr,
+                                                                   DataType::Type::kBool,
+                                                                   MemberOffset(42),
+                                                                   false,
+                                                                   kUnknownFieldIndex,
+                                                                   kUnknownClassDefIndex,
+                                                                   graph->GetDexFile(),
+                                                                   0));
+  HInstruction* field_get_in_loop_body = loop_body->GetLastInstruction();
+  loop_body->AddInstruction(new (GetAllocator()) HGoto());
+  exit->AddInstruction(new (GetAllocator()) HExit());
+
+  graph->BuildDominatorTree();
+  {
+    SideEffectsAnalysis side_effects(graph);
+    side_effects.Run();
+    GVNOptimization(graph, side_effects).Run();
+  }
+
+  ASSERT_EQ(field_get->GetBlock(), block);
+  ASSERT_TRUE(field_get_in_loop_body->GetBlock() == nullptr);
+}
+
 // Test that inner loops affect the side effects of the outer loop.
 TEST_F(GVNTest, LoopSideEffects) {
   static const SideEffects kCanTriggerGC = SideEffects::CanTriggerGC();
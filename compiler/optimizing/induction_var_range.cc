@@ -255,10 +255,7 @@ bool InductionVarRange::CanGenerateRange(const HBasicBlock* context,
                                   nullptr,  // nothing generated yet
                                   &stride_value,
                                   needs_finite_test,
-                                  needs_taken_test) &&
-         (stride_value == -1 ||
-          stride_value == 0 ||
-          stride_value == 1);  // avoid arithmetic wrap-around anomalies.
+                                  needs_taken_test);
 }
 
 void InductionVarRange::GenerateRange(const HBasicBlock* context,
@@ -280,10 +277,7 @@ void InductionVarRange::GenerateRange(const HBasicBlock* context,
                                 nullptr,
                                 &stride_value,
                                 &b1,
-                                &b2) ||
-      (stride_value != -1 &&
-       stride_value != 0 &&
-       stride_value != 1)) {
+                                &b2)) {
     LOG(FATAL) << "Failed precondition: CanGenerateRange()";
   }
 }
@@ -315,6 +309,37 @@ HInstruction* InductionVarRange::GenerateTakenTest(HInstruction* loop_control,
   return taken_test;
 }
 
+bool InductionVarRange::CanGenerateFiniteTest(HInstruction* loop_control) {
+  const HBasicBlock* context = loop_control->GetBlock();
+  const HLoopInformation* loop = nullptr;
+  HInductionVarAnalysis::InductionInfo* info = nullptr;
+  HInductionVarAnalysis::InductionInfo* trip = nullptr;
+  return HasInductionInfo(context, loop_control, &loop, &info, &trip) &&
+         trip != nullptr &&
+         GenerateFiniteTestCode(context,
+                                loop,
+                                trip,
+                                /*graph=*/ nullptr,
+                                /*block=*/ nullptr,
+                                /*result=*/ nullptr);
+}
+
+HInstruction* InductionVarRange::GenerateFiniteTest(HInstruction* loop_control,
+                                                    HGraph* graph,
+                                                    HBasicBlock* block) {
+  const HBasicBlock* context = loop_control->GetBlock();
+  const HLoopInformation* loop = nullptr;
+  HInductionVarAnalysis::InductionInfo* info = nullptr;
+  HInductionVarAnalysis::InductionInfo* trip = nullptr;
+  HInstruction* finite_test = nullptr;
+  if (!HasInductionInfo(context, loop_control, &loop, &info, &trip) ||
+      trip == nullptr ||
+      !GenerateFiniteTestCode(context, loop, trip, graph, block, &finite_test)) {
+    LOG(FATAL) << "Failed precondition: CanGenerateFiniteTest()";
+  }
+  return finite_test;
+}
+
 bool InductionVarRange::CanGenerateLastValue(HInstruction* instruction) {
   const HBasicBlock* context = instruction->GetBlock();
   bool is_last_value = true;
@@ -1122,7 +1147,12 @@ bool InductionVarRange::GenerateRangeOrLastValue(const HBasicBlock* context,
       return false;
     }
   }
-  // Code generation for lower and upper.
+  // Code generation for lower and upper. Evaluating a * (TC - 1) + b for a non-unit stride
+  // could wrap around, so such strides are only handled for a plain linear induction.
+  if (*stride_value < -1 || *stride_value > 1) {
+    return info->induction_class == HInductionVarAnalysis::kLinear &&
+           GenerateStridedLinearRange(context, loop, info, trip, graph, block, lower, upper);
+  }
   return
       // Success on lower if invariant (not set), or code can be generated.
       ((info->induction_class == HInductionVarAnalysis::kInvariant) ||
@@ -1131,6 +1161,140 @@ bool InductionVarRange::GenerateRangeOrLastValue(const HBasicBlock* context,
       GenerateCode(context, loop, info, trip, graph, block, /*is_min=*/ false, upper);
 }
 
+bool InductionVarRange::GenerateStridedLinearRange(const HBasicBlock* context,
+                                                   const HLoopInformation* loop,
+                                                   HInductionVarAnalysis::InductionInfo* info,
+                                                   HInductionVarAnalysis::InductionInfo* trip,
+                                                   HGraph* graph,
+                                                   HBasicBlock* block,
+                                                   /*out*/ HInstruction** lower,
+                                                   /*out*/ HInstruction** upper) const {
+  // A linear induction a * i + b that advances in lock-step with the loop control L + a * i
+  // differs from the loop control by b - L. Inside the loop-body, the loop control lies between
+  // L and the inclusive limit U' of the loop condition, so the induction lies between b and
+  // U' + b - L (swapped for a negative stride). Unlike a * (TC - 1) + b, this bound does not
+  // depend on the rounded down trip-count and cannot wrap around for a finite loop.
+  DCHECK_EQ(info->induction_class, HInductionVarAnalysis::kLinear);
+  HInductionVarAnalysis::InductionInfo* trip_count = trip->op_a;
+  HInductionVarAnalysis::InductionInfo* taken_test = trip->op_b;
+  int64_t stride_value = 0;
+  int64_t control_stride_value = 0;
+  if (!IsContextInBody(context, loop) ||
+      HInductionVarAnalysis::IsNarrowingLinear(info) ||
+      trip->type != info->type ||
+      !IsConstant(context, loop, info->op_a, kExact, &stride_value) ||
+      trip_count->induction_class != HInductionVarAnalysis::kInvariant ||
+      trip_count->operation != HInductionVarAnalysis::kDiv ||
+      !IsConstant(context, loop, trip_count->op_b, kExact, &control_stride_value) ||
+      stride_value != control_stride_value) {
+    return false;
+  }
+  // Make the limit inclusive.
+  int64_t limit_adjustment = 0;
+  switch (taken_test->operation) {
+    case HInductionVarAnalysis::kLT:
+      limit_adjustment = -1;
+      FALLTHROUGH_INTENDED;
+    case HInductionVarAnalysis::kLE:
+      if (stride_value < 0) {
+        return false;
+      }
+      break;
+    case HInductionVarAnalysis::kGT:
+      limit_adjustment = 1;
+      FALLTHROUGH_INTENDED;
+    case HInductionVarAnalysis::kGE:
+      if (stride_value > 0) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  const bool is_increasing = stride_value > 0;
+  HInstruction* start = nullptr;
+  HInstruction* control_start = nullptr;
+  HInstruction* limit = nullptr;
+  if (!GenerateCode(context, loop, info->op_b, trip, graph, block, is_increasing, &start) ||
+      !GenerateCode(context, loop, taken_test->op_a, trip, graph, block, true, &control_start) ||
+      !GenerateCode(context, loop, taken_test->op_b, trip, graph, block, false, &limit)) {
+    return false;
+  }
+  if (graph != nullptr) {
+    DataType::Type type = info->type;
+    ArenaAllocator* allocator = graph->GetAllocator();
+    HInstruction* end = Insert(block, new (allocator) HSub(type, limit, control_start));
+    if (limit_adjustment != 0) {
+      end = Insert(block,
+                   new (allocator) HAdd(type, end, graph->GetConstant(type, limit_adjustment)));
+    }
+    end = Insert(block, new (allocator) HAdd(type, end, start));
+    *lower = is_increasing ? start : end;
+    *upper = is_increasing ? end : start;
+  }
+  return true;
+}
+
+bool InductionVarRange::GenerateFiniteTestCode(const HBasicBlock* context,
+                                               const HLoopInformation* loop,
+                                               HInductionVarAnalysis::InductionInfo* trip,
+                                               HGraph* graph,
+                                               HBasicBlock* block,
+                                               /*out*/ HInstruction** result) const {
+  // A loop control with a non-unit stride S can step over the limit U of the loop condition
+  // and wrap around, in which case the loop does not terminate. This is avoided if the last
+  // increment cannot wrap around, e.g. U <= MAX - S + 1 for condition i < U (the same rules
+  // HInductionVarAnalysis::IsFinite() uses at compile-time). The generated test is the negation.
+  HInductionVarAnalysis::InductionInfo* trip_count = trip->op_a;
+  HInductionVarAnalysis::InductionInfo* taken_test = trip->op_b;
+  DataType::Type type = trip->type;
+  int64_t stride_value = 0;
+  if ((type != DataType::Type::kInt32 && type != DataType::Type::kInt64) ||
+      trip_count->induction_class != HInductionVarAnalysis::kInvariant ||
+      trip_count->operation != HInductionVarAnalysis::kDiv ||
+      !IsConstant(context, loop, trip_count->op_b, kExact, &stride_value) ||
+      (stride_value >= -1 && stride_value <= 1)) {
+    return false;
+  }
+  const int64_t min = DataType::MinValueOfIntegralType(type);
+  const int64_t max = DataType::MaxValueOfIntegralType(type);
+  int64_t threshold = 0;
+  switch (taken_test->operation) {
+    case HInductionVarAnalysis::kLT:
+      threshold = max - stride_value + 1;
+      break;
+    case HInductionVarAnalysis::kLE:
+      threshold = max - stride_value;
+      break;
+    case HInductionVarAnalysis::kGT:
+      threshold = min - stride_value - 1;
+      break;
+    case HInductionVarAnalysis::kGE:
+      threshold = min - stride_value;
+      break;
+    default:
+      return false;
+  }
+  const bool is_increasing = taken_test->operation == HInductionVarAnalysis::kLT ||
+                             taken_test->operation == HInductionVarAnalysis::kLE;
+  if (is_increasing != (stride_value > 0)) {
+    return false;
+  }
+  HInstruction* limit = nullptr;
+  if (!GenerateCode(context, loop, taken_test->op_b, trip, graph, block, false, &limit)) {
+    return false;
+  }
+  if (graph != nullptr) {
+    ArenaAllocator* allocator = graph->GetAllocator();
+    HInstruction* constant = graph->GetConstant(type, threshold);
+    *result = Insert(block,
+                     is_increasing
+                         ? static_cast<HInstruction*>(new (allocator) HGreaterThan(limit, constant))
+                         : static_cast<HInstruction*>(new (allocator) HLessThan(limit, constant)));
+  }
+  return true;
+}
+
 bool InductionVarRange::GenerateLastValueLinear(const HBasicBlock* context,
                                                 const HLoopInformation* loop,
                                                 HInductionVarAnalysis::InductionInfo* info,
@@ -1610,7 +1774,8 @@ bool InductionVarRange::GenerateCode(const HBasicBlock* context,
       case HInductionVarAnalysis::kLinear: {
         // Linear induction a * i + b, for normalized 0 <= i < TC. For ranges, this should
         // be restricted to a unit stride to avoid arithmetic wrap-around situations that
-        // are harder to guard against. For a last value, requesting min/max based on any
+        // are harder to guard against (see GenerateStridedLinearRange() for non-unit
+        // strides). For a last value, requesting min/max based on any
         // known stride yields right value. Always avoid any narrowing linear induction or
         // any type mismatch between the linear induction and the trip count expression.
         // TODO: careful runtime type conversions could generalize this latter restriction.
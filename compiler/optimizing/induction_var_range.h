@@ -113,6 +113,21 @@ class InductionVarRange {
    */
   HInstruction* GenerateTakenTest(HInstruction* loop_control, HGraph* graph, HBasicBlock* block);
 
+  /**
+   * Returns true if the loop of the given `loop_control` instruction has a constant non-unit
+   * stride and induction analysis is able to generate an explicit finite-test for it.
+   */
+  bool CanGenerateFiniteTest(HInstruction* loop_control);
+
+  /**
+   * Generates explicit finite-test for the given `loop_control` instruction, i.e. a condition
+   * that is true if the loop control may wrap around instead of exiting the loop. Code is
+   * generated in given block and graph. Returns generated finite-test.
+   *
+   * Precondition: CanGenerateFiniteTest() returns true.
+   */
+  HInstruction* GenerateFiniteTest(HInstruction* loop_control, HGraph* graph, HBasicBlock* block);
+
   /**
    * Returns true if induction analysis is able to generate code for last value of
    * the given instruction inside the closest enveloping loop.
@@ -318,6 +333,22 @@ class InductionVarRange {
                                 /*out*/ bool* needs_finite_test,
                                 /*out*/ bool* needs_taken_test) const;
 
+  bool GenerateStridedLinearRange(const HBasicBlock* context,
+                                  const HLoopInformation* loop,
+                                  HInductionVarAnalysis::InductionInfo* info,
+                                  HInductionVarAnalysis::InductionInfo* trip,
+                                  HGraph* graph,
+                                  HBasicBlock* block,
+                                  /*out*/ HInstruction** lower,
+                                  /*out*/ HInstruction** upper) const;
+
+  bool GenerateFiniteTestCode(const HBasicBlock* context,
+                              const HLoopInformation* loop,
+                              HInductionVarAnalysis::InductionInfo* trip,
+                              HGraph* graph,
+                              HBasicBlock* block,
+                              /*out*/ HInstruction** result) const;
+
   bool GenerateLastValueLinear(const HBasicBlock* context,
                                const HLoopInformation* loop,
                                HInductionVarAnalysis::InductionInfo* info,
@@ -16,6 +16,8 @@
 
 #include "induction_var_range.h"
 
+#include <limits>
+
 #include "base/arena_allocator.h"
 #include "base/macros.h"
 #include "builder.h"
@@ -1146,6 +1148,9 @@ TEST_F(InductionVarRangeTest, SymbolicTripCountUp) {
   ExpectInt(0, taken->InputAt(0));
   EXPECT_TRUE(taken->InputAt(1)->IsParameterValue());
 
+  // No finite-test for a unit stride.
+  EXPECT_FALSE(range_.CanGenerateFiniteTest(loop_header_->GetLastInstruction()));
+
   // Replacement.
   range_.Replace(loop_header_->GetLastInstruction(), x_, y_);
   range_.GetInductionRange(increment_->GetBlock(), increment_, x_, &v1, &v2, &needs_finite_test);
@@ -1259,4 +1264,50 @@ TEST_F(InductionVarRangeTest, SymbolicTripCountDown) {
   EXPECT_TRUE(taken->InputAt(1)->IsParameterValue());
 }
 
+TEST_F(InductionVarRangeTest, SymbolicTripCountUpNonUnitStride) {
+  BuildLoop(0, x_, 2);
+  PerformInductionVarAnalysis();
+
+  bool needs_finite_test = false;
+  bool needs_taken_test = false;
+
+  HInstruction* phi = condition_->InputAt(0);
+  HInstruction* lower = nullptr;
+  HInstruction* upper = nullptr;
+
+  // Can generate code in context of loop-body only, protected by both tests.
+  EXPECT_FALSE(
+      range_.CanGenerateRange(condition_->GetBlock(), phi, &needs_finite_test, &needs_taken_test));
+  ASSERT_TRUE(
+      range_.CanGenerateRange(increment_->GetBlock(), phi, &needs_finite_test, &needs_taken_test));
+  EXPECT_TRUE(needs_finite_test);
+  EXPECT_TRUE(needs_taken_test);
+
+  // Generates code (unsimplified).
+  range_.GenerateRange(increment_->GetBlock(), phi, graph_, loop_preheader_, &lower, &upper);
+
+  // Verify lower is 0.
+  ASSERT_TRUE(lower != nullptr);
+  ExpectInt(0, lower);
+
+  // Verify upper is ((V-0)+-1)+0, i.e. bounded by the limit rather than the trip-count.
+  ASSERT_TRUE(upper != nullptr);
+  ASSERT_TRUE(upper->IsAdd());
+  ExpectInt(0, upper->InputAt(1));
+  ASSERT_TRUE(upper->InputAt(0)->IsAdd());
+  ExpectInt(-1, upper->InputAt(0)->InputAt(1));
+  ASSERT_TRUE(upper->InputAt(0)->InputAt(0)->IsSub());
+  EXPECT_TRUE(upper->InputAt(0)->InputAt(0)->InputAt(0)->IsParameterValue());
+  ExpectInt(0, upper->InputAt(0)->InputAt(0)->InputAt(1));
+
+  // Verify finite-test is V>MAX-1.
+  HInstruction* control = loop_header_->GetLastInstruction();
+  ASSERT_TRUE(range_.CanGenerateFiniteTest(control));
+  HInstruction* finite = range_.GenerateFiniteTest(control, graph_, loop_preheader_);
+  ASSERT_TRUE(finite != nullptr);
+  ASSERT_TRUE(finite->IsGreaterThan());
+  EXPECT_TRUE(finite->InputAt(0)->IsParameterValue());
+  ExpectInt(std::numeric_limits<int32_t>::max() - 1, finite->InputAt(1));
+}
+
 }  // namespace art
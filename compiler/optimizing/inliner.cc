@@ -20,6 +20,7 @@
 #include "base/enums.h"
 #include "base/logging.h"
 #include "builder.h"
+#include "cha.h"
 #include "class_linker.h"
 #include "class_root-inl.h"
 #include "constant_folding.h"
@@ -29,6 +30,7 @@
 #include "driver/compiler_options.h"
 #include "driver/dex_compilation_unit.h"
 #include "instruction_simplifier.h"
+#include "instrumentation.h"
 #include "intrinsics.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
@@ -57,6 +59,15 @@ static constexpr size_t kMaximumNumberOfTotalInstructions = 1024;
 // are not reached.
 static constexpr size_t kMaximumNumberOfInstructionsForSmallMethod = 3;
 
+// Number of instructions on top of `kMaximumNumberOfTotalInstructions` that only
+// hot call sites can use, so that they are still inlined once colder call sites
+// have spent the regular budget.
+static constexpr size_t kHotCallSiteInstructionReserve = 256;
+
+// Maximum number of code units of a method inlined at a cold call site. Inlining
+// larger methods there only increases code size.
+static constexpr size_t kMaximumCodeUnitsForColdCallSite = 8;
+
 // Limit the number of dex registers that we accumulate while inlining
 // to avoid creating large amount of nested environments.
 static constexpr size_t kMaximumNumberOfCumulatedDexRegisters = 32;
@@ -123,17 +134,113 @@ static size_t CountNumberOfInstructions(HGraph* graph) {
   return number_of_instructions;
 }
 
-void HInliner::UpdateInliningBudget() {
-  if (total_number_of_instructions_ >= kMaximumNumberOfTotalInstructions) {
+static size_t ComputeInliningBudget(size_t total_number_of_instructions,
+                                    size_t maximum_number_of_instructions) {
+  if (total_number_of_instructions >= maximum_number_of_instructions) {
     // Always try to inline small methods.
-    inlining_budget_ = kMaximumNumberOfInstructionsForSmallMethod;
+    return kMaximumNumberOfInstructionsForSmallMethod;
   } else {
-    inlining_budget_ = std::max(
-        kMaximumNumberOfInstructionsForSmallMethod,
-        kMaximumNumberOfTotalInstructions - total_number_of_instructions_);
+    return std::max(kMaximumNumberOfInstructionsForSmallMethod,
+                    maximum_number_of_instructions - total_number_of_instructions);
   }
 }
 
+void HInliner::UpdateInliningBudget() {
+  inlining_budget_ =
+      ComputeInliningBudget(total_number_of_instructions_, kMaximumNumberOfTotalInstructions);
+  hot_call_site_inlining_budget_ =
+      ComputeInliningBudget(total_number_of_instructions_,
+                            kMaximumNumberOfTotalInstructions + kHotCallSiteInstructionReserve);
+}
+
+void HInliner::ComputeCallSiteHotnessFromBranchProfile() {
+  ProfilingInfo* profiling_info = graph_->GetProfilingInfo();
+  if (profiling_info == nullptr || graph_->IsCompilingBaseline()) {
+    // Baseline compiles collect the profile rather than use it.
+    return;
+  }
+
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ArenaBitVector cold_blocks(
+      &allocator, graph_->GetBlocks().size(), /* expandable= */ false, kArenaAllocMisc);
+  cold_invokes_ = ArenaBitVector::Create(graph_->GetAllocator(),
+                                         graph_->GetCurrentInstructionId(),
+                                         /* expandable= */ false,
+                                         kArenaAllocMisc);
+  hot_invokes_ = ArenaBitVector::Create(graph_->GetAllocator(),
+                                        graph_->GetCurrentInstructionId(),
+                                        /* expandable= */ false,
+                                        kArenaAllocMisc);
+  // Nothing has been inlined into `graph_` yet, so all branches have dex pcs of its
+  // method and can be looked up in its branch caches.
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    HBasicBlock* dominator = block->GetDominator();
+    bool is_cold = false;
+    if (dominator != nullptr && cold_blocks.IsBitSet(dominator->GetBlockId())) {
+      is_cold = true;
+    } else if (block->GetPredecessors().size() == 1u) {
+      HIf* hif = block->GetSinglePredecessor()->GetLastInstruction()->AsIfOrNull();
+      BranchCache* cache =
+          (hif != nullptr) ? profiling_info->GetBranchCache(hif->GetDexPc()) : nullptr;
+      if (cache != nullptr) {
+        bool is_true_successor = (hif->IfTrueSuccessor() == block);
+        uint16_t taken = is_true_successor ? cache->GetTrue() : cache->GetFalse();
+        uint16_t not_taken = is_true_successor ? cache->GetFalse() : cache->GetTrue();
+        is_cold = (taken == 0u) && (not_taken != 0u);
+      }
+    }
+    if (is_cold) {
+      cold_blocks.SetBit(block->GetBlockId());
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (it.Current()->IsInvoke()) {
+        if (is_cold) {
+          cold_invokes_->SetBit(it.Current()->GetId());
+        } else if (block->IsInLoop()) {
+          hot_invokes_->SetBit(it.Current()->GetId());
+        }
+      }
+    }
+  }
+}
+
+HInliner::CallSiteHotness HInliner::GetCallSiteHotness(const HInvoke* invoke_instruction,
+                                                       ArtMethod* method) const {
+  if (cold_invokes_ != nullptr) {
+    DCHECK(hot_invokes_ != nullptr);
+    if (cold_invokes_->IsBitSet(invoke_instruction->GetId())) {
+      return CallSiteHotness::kCold;
+    } else if (hot_invokes_->IsBitSet(invoke_instruction->GetId())) {
+      return CallSiteHotness::kHot;
+    }
+    return CallSiteHotness::kUnknown;
+  }
+
+  if (!Runtime::Current()->IsAotCompiler()) {
+    return CallSiteHotness::kUnknown;
+  }
+  const ProfileCompilationInfo* pci = codegen_->GetCompilerOptions().GetProfileCompilationInfo();
+  if (pci == nullptr) {
+    return CallSiteHotness::kUnknown;
+  }
+  ProfileCompilationInfo::MethodHotness caller_hotness = pci->GetMethodHotness(MethodReference(
+      caller_compilation_unit_.GetDexFile(), caller_compilation_unit_.GetDexMethodIndex()));
+  if (!caller_hotness.IsHot()) {
+    return CallSiteHotness::kUnknown;
+  }
+  const DexFile* callee_dex_file = method->GetDexFile();
+  ProfileCompilationInfo::MethodHotness callee_hotness =
+      pci->GetMethodHotness(MethodReference(callee_dex_file, method->GetDexMethodIndex()));
+  if (callee_hotness.IsHot()) {
+    return CallSiteHotness::kHot;
+  } else if (!callee_hotness.IsInProfile() &&
+             pci->FindDexFile(*callee_dex_file) != ProfileCompilationInfo::MaxProfileIndex()) {
+    // The profile covers the callee's dex file, but the callee was never executed.
+    return CallSiteHotness::kCold;
+  }
+  return CallSiteHotness::kUnknown;
+}
+
 bool HInliner::Run() {
   if (codegen_->GetCompilerOptions().GetInlineMaxCodeUnits() == 0) {
     // Inlining effectively disabled.
@@ -155,6 +262,7 @@ bool HInliner::Run() {
   UpdateInliningBudget();
   DCHECK_NE(total_number_of_instructions_, 0u);
   DCHECK_NE(inlining_budget_, 0u);
+  ComputeCallSiteHotnessFromBranchProfile();
 
   // If we're compiling tests, honor inlining directives in method names:
   // - if a method's name contains the substring "$noinline$", do not
@@ -375,6 +483,16 @@ ArtMethod* HInliner::FindMethodFromCHA(ArtMethod* resolved_method) {
     // We do not support HDeoptimize in OSR methods.
     return nullptr;
   }
+  if (!outermost_graph_->CanSpeculate(DeoptimizationKind::kCHA)) {
+    // Compiled code for this method kept being invalidated by class loading.
+    return nullptr;
+  }
+  if (caller_compilation_unit_.GetClassLinker()->GetClassHierarchyAnalysis()->
+          IsFrequentlyInvalidated(resolved_method)) {
+    // Speculating on this hierarchy kept invalidating compiled code. Rely on the
+    // inline cache instead.
+    return nullptr;
+  }
   PointerSize pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
   ArtMethod* single_impl = resolved_method->GetSingleImplementation(pointer_size);
   if (single_impl == nullptr) {
@@ -624,7 +742,12 @@ bool HInliner::UseOnlyPolymorphicInliningWithNoDeopt() {
   //
   // For OSR:
   //     We may come from the interpreter and it may have seen different receiver types.
-  return Runtime::Current()->IsAotCompiler() || outermost_graph_->IsCompilingOsr();
+  //
+  // For JIT, also avoid the deopt if compiled code for the method already deoptimized
+  // too often because of a missed inline cache type.
+  return Runtime::Current()->IsAotCompiler() ||
+         outermost_graph_->IsCompilingOsr() ||
+         !outermost_graph_->CanSpeculate(DeoptimizationKind::kJitInlineCache);
 }
 bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -671,11 +794,22 @@ bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction)
     }
 
     case kInlineCacheMegamorphic: {
+      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
+      // The inline cache only holds the first receiver types seen, but the call
+      // may still dispatch to a single target for all of them, e.g. a method
+      // implemented in a common superclass. Inline that target behind a check of
+      // the receiver's dispatch table entry, and keep the original invoke for
+      // the other targets.
+      if (classes.Size() != 0u &&
+          TryInlinePolymorphicCallToSameTarget(
+              invoke_instruction, classes, /* deoptimize_on_mismatch= */ false)) {
+        MaybeRecordStat(stats_, MethodCompilationStat::kInlinedMegamorphicCall);
+        return true;
+      }
       LOG_FAIL_NO_STAT()
           << "Interface or virtual call to "
           << invoke_instruction->GetMethodReference().PrettyMethod()
           << " is megamorphic and not inlined";
-      MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
       return false;
     }
 
@@ -1028,7 +1162,11 @@ bool HInliner::TryInlinePolymorphicCall(
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, classes)) {
+  if (TryInlinePolymorphicCallToSameTarget(
+          invoke_instruction,
+          classes,
+          /* deoptimize_on_mismatch= */
+          outermost_graph_->CanSpeculate(DeoptimizationKind::kJitSameTarget))) {
     return true;
   }
 
@@ -1205,7 +1343,8 @@ void HInliner::CreateDiamondPatternForPolymorphicInline(HInstruction* compare,
 
 bool HInliner::TryInlinePolymorphicCallToSameTarget(
     HInvoke* invoke_instruction,
-    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes) {
+    const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+    bool deoptimize_on_mismatch) {
   // This optimization only works under JIT for now.
   if (!codegen_->GetCompilerOptions().IsJitCompiler()) {
     return false;
@@ -1296,7 +1435,7 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   bb_cursor->InsertInstructionAfter(class_table_get, receiver_class);
   bb_cursor->InsertInstructionAfter(compare, class_table_get);
 
-  if (outermost_graph_->IsCompilingOsr()) {
+  if (!deoptimize_on_mismatch || outermost_graph_->IsCompilingOsr()) {
     CreateDiamondPatternForPolymorphicInline(compare, return_replacement, invoke_instruction);
   } else {
     HDeoptimize* deoptimize = new (graph_->GetAllocator()) HDeoptimize(
@@ -1314,7 +1453,9 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
 
   // Lazily run type propagation to get the guard typed.
   run_extra_type_propagation_ = true;
-  MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+  if (deoptimize_on_mismatch) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kInlinedPolymorphicCall);
+  }
 
   LOG_SUCCESS() << "Inlined same polymorphic target " << actual_method->PrettyMethod();
   return true;
@@ -1490,6 +1631,14 @@ bool HInliner::IsInliningAllowed(ArtMethod* method, const CodeItemDataAccessor&
     return false;
   }
 
+  if (codegen_->GetCompilerOptions().IsJitCompiler() &&
+      Runtime::Current()->GetInstrumentation()->HasEntryExitHooksForMethod(method)) {
+    LOG_FAIL_NO_STAT()
+        << "Method " << method->PrettyMethod()
+        << " is not inlined because it needs to call the entry / exit hooks";
+    return false;
+  }
+
   return true;
 }
 
@@ -1566,6 +1715,17 @@ bool HInliner::IsInliningEncouraged(const HInvoke* invoke_instruction,
     return false;
   }
 
+  if (accessor.InsnsSizeInCodeUnits() > kMaximumCodeUnitsForColdCallSite &&
+      GetCallSiteHotness(invoke_instruction, method) == CallSiteHotness::kCold) {
+    LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedColdCallSite)
+        << "Method " << method->PrettyMethod()
+        << " is not inlined because its call site is cold and its code item is too big: "
+        << accessor.InsnsSizeInCodeUnits()
+        << " > "
+        << kMaximumCodeUnitsForColdCallSite;
+    return false;
+  }
+
   if (graph_->IsCompilingBaseline() &&
       accessor.InsnsSizeInCodeUnits() > CompilerOptions::kBaselineInlineMaxCodeUnits) {
     LOG_FAIL_NO_STAT() << "Reached baseline maximum code unit for inlining  "
@@ -1973,6 +2133,11 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
                              size_t* out_number_of_instructions,
                              bool is_speculative) const {
   ArtMethod* const resolved_method = callee_graph->GetArtMethod();
+  // Hot call sites may also use the reserve of instructions kept for them.
+  const size_t inlining_budget =
+      (GetCallSiteHotness(invoke, resolved_method) == CallSiteHotness::kHot)
+          ? hot_call_site_inlining_budget_
+          : inlining_budget_;
 
   HBasicBlock* exit_block = callee_graph->GetExitBlock();
   if (exit_block == nullptr) {
@@ -2075,7 +2240,7 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
     for (HInstructionIterator instr_it(block->GetInstructions());
          !instr_it.Done();
          instr_it.Advance()) {
-      if (++number_of_instructions > inlining_budget_) {
+      if (++number_of_instructions > inlining_budget) {
         LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedInstructionBudget)
             << "Method " << resolved_method->PrettyMethod()
             << " is not inlined because the outer method has reached"
@@ -17,6 +17,7 @@
 #ifndef ART_COMPILER_OPTIMIZING_INLINER_H_
 #define ART_COMPILER_OPTIMIZING_INLINER_H_
 
+#include "base/arena_bit_vector.h"
 #include "base/macros.h"
 #include "dex/dex_file_types.h"
 #include "dex/invoke_type.h"
@@ -58,6 +59,9 @@ class HInliner : public HOptimization {
         caller_environment_(caller_environment),
         depth_(depth),
         inlining_budget_(0),
+        hot_call_site_inlining_budget_(0),
+        cold_invokes_(nullptr),
+        hot_invokes_(nullptr),
         try_catch_inlining_allowed_(try_catch_inlining_allowed),
         run_extra_type_propagation_(false),
         inline_stats_(nullptr) {}
@@ -82,6 +86,12 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  enum class CallSiteHotness {
+    kUnknown,
+    kCold,  // The call site is not expected to execute.
+    kHot,   // The call site is expected to execute often.
+  };
+
   bool TryInline(HInvoke* invoke_instruction);
 
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
@@ -225,9 +235,14 @@ class HInliner : public HOptimization {
                                 const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to inline the single target that all the types of the inline cache
+  // dispatch to. The receiver's dispatch table entry is checked against that
+  // target: on mismatch, either deoptimize or, if `deoptimize_on_mismatch` is
+  // false, fall back to the original invoke.
   bool TryInlinePolymorphicCallToSameTarget(
       HInvoke* invoke_instruction,
-      const StackHandleScope<InlineCache::kIndividualCacheSize>& classes)
+      const StackHandleScope<InlineCache::kIndividualCacheSize>& classes,
+      bool deoptimize_on_mismatch)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Returns whether or not we should use only polymorphic inlining with no deoptimizations.
@@ -318,6 +333,15 @@ class HInliner : public HOptimization {
   // Update the inlining budget based on `total_number_of_instructions_`.
   void UpdateInliningBudget();
 
+  // Record the invokes of `graph_` that its branch profile shows as never executed, or
+  // as executed inside a loop. Must be called before anything is inlined into `graph_`.
+  void ComputeCallSiteHotnessFromBranchProfile();
+
+  // Returns how hot the call from `invoke_instruction` to `method` is, based on the
+  // branch profile in JIT and on the profile flags of the callee in AOT.
+  CallSiteHotness GetCallSiteHotness(const HInvoke* invoke_instruction, ArtMethod* method) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Count the number of calls of `method` being inlined recursively.
   size_t CountRecursiveCallsOf(ArtMethod* method) const;
 
@@ -340,6 +364,14 @@ class HInliner : public HOptimization {
   // The budget left for inlining, in number of instructions.
   size_t inlining_budget_;
 
+  // The budget left for inlining at hot call sites, which includes a reserve that other
+  // call sites cannot use.
+  size_t hot_call_site_inlining_budget_;
+
+  // Ids of the invokes of `graph_` found cold or hot by the branch profile, if any.
+  ArenaBitVector* cold_invokes_;
+  ArenaBitVector* hot_invokes_;
+
   // States if we are allowing try catch inlining to occur at this particular instance of inlining.
   bool try_catch_inlining_allowed_;
 
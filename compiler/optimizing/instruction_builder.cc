@@ -1333,7 +1333,12 @@ static void DecideVarHandleIntrinsic(HInvoke* invoke) {
         optimizations.SetDoNotIntrinsify();
         return;
       }
-      if (value_type != return_type) {
+      // Only the ARM64 code generator can discard the old value, see
+      // `IsVarHandleGetAndUpdateResultUnused()`.
+      bool can_discard_result =
+          return_type == DataType::Type::kVoid &&
+          invoke->GetBlock()->GetGraph()->GetInstructionSet() == InstructionSet::kArm64;
+      if (value_type != return_type && !can_discard_result) {
         optimizations.SetDoNotIntrinsify();
         return;
       }
@@ -17,6 +17,8 @@
 #include "instruction_simplifier.h"
 
 #include "art_method-inl.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
 #include "data_type-inl.h"
@@ -116,6 +118,7 @@ class InstructionSimplifierVisitor final : public HGraphDelegateVisitor {
   void VisitDeoptimize(HDeoptimize* deoptimize) override;
   void VisitVecMul(HVecMul* instruction) override;
   void SimplifyBoxUnbox(HInvoke* instruction, ArtField* field, DataType::Type type);
+  void SimplifyBoxUnboxPhi(HPhi* phi, Intrinsics intrinsic, ArtField* field, DataType::Type type);
   void SimplifySystemArrayCopy(HInvoke* invoke);
   void SimplifyStringEquals(HInvoke* invoke);
   void SimplifyFP2Int(HInvoke* invoke);
@@ -1188,6 +1191,9 @@ void InstructionSimplifierVisitor::VisitIf(HIf* instruction) {
     // Swap successors if input is negated.
     instruction->ReplaceInput(condition->InputAt(0), 0);
     instruction->GetBlock()->SwapSuccessors();
+    uint16_t true_count = instruction->GetTrueCount();
+    instruction->SetTrueCount(instruction->GetFalseCount());
+    instruction->SetFalseCount(true_count);
     RecordSimplification();
   }
 }
@@ -2489,6 +2495,126 @@ void InstructionSimplifierVisitor::SimplifyBoxUnbox(
       user->ReplaceWith(instruction->InputAt(0));
       RecordSimplification();
       // Do not remove `user` while we're iterating over the block's instructions. Let DCE do it.
+    } else if (user->IsPhi() && !user->AsPhi()->IsCatchPhi()) {
+      SimplifyBoxUnboxPhi(user->AsPhi(), instruction->GetIntrinsic(), field, type);
+    }
+  }
+}
+
+// Unboxing a Phi that merges only boxes created by the same `valueOf()` intrinsic, directly
+// or through other such Phis, reads one of the boxed values. Create Phis of the boxed values
+// for the unboxing to use, so that boxes carried around a loop are not unboxed again in each
+// iteration, and let DCE remove the boxes if nothing else needs them.
+void InstructionSimplifierVisitor::SimplifyBoxUnboxPhi(
+    HPhi* phi, Intrinsics intrinsic, ArtField* field, DataType::Type type) {
+  auto is_unboxing = [field, type](HInstruction* user) {
+    return user->IsInstanceFieldGet() &&
+           user->AsInstanceFieldGet()->GetFieldInfo().GetField() == field &&
+           user->GetType() == type;
+  };
+  // The null check of the merged box may not have been removed yet.
+  auto has_unboxing = [&is_unboxing](HInstruction* box) {
+    for (const HUseListNode<HInstruction*>& use : box->GetUses()) {
+      HInstruction* user = use.GetUser();
+      if (is_unboxing(user)) {
+        return true;
+      } else if (user->IsNullCheck()) {
+        for (const HUseListNode<HInstruction*>& null_check_use : user->GetUses()) {
+          if (is_unboxing(null_check_use.GetUser())) {
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  };
+
+  ScopedArenaAllocator allocator(GetGraph()->GetArenaStack());
+  ScopedArenaVector<HPhi*> box_phis(allocator.Adapter(kArenaAllocOptimization));
+  box_phis.push_back(phi);
+  bool is_unboxed = false;
+  for (size_t i = 0; i != box_phis.size(); ++i) {
+    for (HInstruction* input : box_phis[i]->GetInputs()) {
+      if (input->IsPhi()) {
+        if (input->AsPhi()->IsCatchPhi()) {
+          return;
+        } else if (!ContainsElement(box_phis, input)) {
+          box_phis.push_back(input->AsPhi());
+        }
+      } else if (!input->IsInvoke() || input->AsInvoke()->GetIntrinsic() != intrinsic) {
+        return;
+      }
+    }
+    is_unboxed = is_unboxed || has_unboxing(box_phis[i]);
+  }
+  if (!is_unboxed) {
+    return;
+  }
+
+  ArenaAllocator* arena = GetGraph()->GetAllocator();
+  ScopedArenaVector<HPhi*> value_phis(allocator.Adapter(kArenaAllocOptimization));
+  for (HPhi* box_phi : box_phis) {
+    HPhi* value_phi = new (arena) HPhi(arena, kNoRegNumber, 0, type, box_phi->GetDexPc());
+    box_phi->GetBlock()->AddPhi(value_phi);
+    value_phis.push_back(value_phi);
+  }
+  for (size_t i = 0; i != box_phis.size(); ++i) {
+    for (HInstruction* input : box_phis[i]->GetInputs()) {
+      value_phis[i]->AddInput(
+          input->IsPhi() ? value_phis[IndexOfElement(box_phis, input)] : input->InputAt(0));
+    }
+  }
+
+  for (size_t i = 0; i != box_phis.size(); ++i) {
+    const HUseList<HInstruction*>& uses = box_phis[i]->GetUses();
+    for (auto it = uses.begin(), end = uses.end(); it != end;) {
+      HInstruction* user = it->GetUser();
+      ++it;  // Increment the iterator before we potentially remove the node from the list.
+      if (is_unboxing(user)) {
+        user->ReplaceWith(value_phis[i]);
+        RecordSimplification();
+      } else if (user->IsNullCheck()) {
+        const HUseList<HInstruction*>& null_check_uses = user->GetUses();
+        for (auto nc_it = null_check_uses.begin(), nc_end = null_check_uses.end();
+             nc_it != nc_end;) {
+          HInstruction* null_check_user = nc_it->GetUser();
+          ++nc_it;
+          if (is_unboxing(null_check_user)) {
+            null_check_user->ReplaceWith(value_phis[i]);
+            RecordSimplification();
+          }
+        }
+      }
+    }
+  }
+
+  if (GetGraph()->IsDebuggable()) {
+    return;
+  }
+  // Boxes used only by the Phis above and by environments can be dropped, as long as
+  // the environments cannot be used to deoptimize. Environment slots without a value
+  // are only a problem for the debugger.
+  auto only_needed_by_environments = [&box_phis](HInstruction* box) {
+    for (const HUseListNode<HInstruction*>& use : box->GetUses()) {
+      if (!use.GetUser()->IsPhi() || !ContainsElement(box_phis, use.GetUser())) {
+        return false;
+      }
+    }
+    for (const HUseListNode<HEnvironment*>& use : box->GetEnvUses()) {
+      if (use.GetUser()->GetHolder()->IsDeoptimize()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (std::all_of(box_phis.begin(), box_phis.end(), only_needed_by_environments)) {
+    for (HPhi* box_phi : box_phis) {
+      for (HInstruction* input : box_phi->GetInputs()) {
+        if (!input->IsPhi() && only_needed_by_environments(input)) {
+          input->RemoveEnvironmentUsers();
+        }
+      }
+      box_phi->RemoveEnvironmentUsers();
     }
   }
 }
@@ -2912,12 +3038,37 @@ static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
       ++num_args;
     } else if (user->IsInvokeStaticOrDirect() &&
                user->AsInvokeStaticOrDirect()->GetResolvedMethod() != nullptr &&
-               user->AsInvokeStaticOrDirect()->GetResolvedMethod()->IsConstructor() &&
-               user->AsInvokeStaticOrDirect()->GetNumberOfArguments() == 1u) {
+               user->AsInvokeStaticOrDirect()->GetResolvedMethod()->IsConstructor()) {
       // After arguments, we should see the constructor.
-      // We accept only the constructor with no extra arguments.
       DCHECK(!seen_constructor);
       DCHECK(!seen_constructor_fence);
+      HInvokeStaticOrDirect* constructor = user->AsInvokeStaticOrDirect();
+      if (constructor->GetNumberOfArguments() == 2u) {
+        // Some compilers, for example for Kotlin string templates, initialize the StringBuilder
+        // with the first string or with a capacity hint. Accept these constructors when they
+        // cannot throw, that is for a non-null string and for a non-negative capacity.
+        HInstruction* constructor_arg = constructor->InputAt(1u);
+        std::string signature;
+        {
+          ScopedObjectAccess soa(Thread::Current());
+          signature = constructor->GetResolvedMethod()->GetSignature().ToString();
+        }
+        if (signature == "(Ljava/lang/String;)V" && !constructor_arg->CanBeNull()) {
+          if (num_args == StringBuilderAppend::kMaxArgs) {
+            return false;
+          }
+          format = (format << StringBuilderAppend::kBitsPerArg) |
+                   static_cast<uint32_t>(StringBuilderAppend::Argument::kString);
+          args[num_args] = constructor_arg;
+          ++num_args;
+        } else if (signature != "(I)V" ||
+                   !constructor_arg->IsIntConstant() ||
+                   constructor_arg->AsIntConstant()->GetValue() < 0) {
+          return false;
+        }
+      } else if (constructor->GetNumberOfArguments() != 1u) {
+        return false;
+      }
       seen_constructor = true;
     } else if (user->IsConstructorFence()) {
       // The last use we see is the constructor fence.
@@ -3715,16 +3715,19 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32Update(HInvoke* invoke) {
 // a CRC32 value of a byte.
 //
 // Parameters:
-//   masm   - VIXL macro assembler
-//   crc    - a register holding an initial CRC value
-//   ptr    - a register holding a memory address of bytes
-//   length - a register holding a number of bytes to process
-//   out    - a register to put a result of calculation
+//   masm       - VIXL macro assembler
+//   crc        - a register holding an initial CRC value
+//   ptr        - a register holding a memory address of bytes
+//   length     - a register holding a number of bytes to process
+//   out        - a register to put a result of calculation
+//   use_crc32c - whether to use the CRC32C polynomial. java.util.zip.CRC32C keeps
+//                the CRC inverted itself, so the CRC is not inverted in that case.
 static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
                                                         const Register& crc,
                                                         const Register& ptr,
                                                         const Register& length,
-                                                        const Register& out) {
+                                                        const Register& out,
+                                                        bool use_crc32c) {
   // The algorithm of CRC32 of bytes is:
   //   crc = ~crc
   //   process a few first bytes to make the array 8-byte aligned
@@ -3748,28 +3751,61 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   Register len = temps.AcquireW();
   Register array_elem = temps.AcquireW();
 
-  __ Mvn(out, crc);
+  auto crc32b = [&](const Register& rd, const Register& rn, const Register& rm) {
+    if (use_crc32c) {
+      __ Crc32cb(rd, rn, rm);
+    } else {
+      __ Crc32b(rd, rn, rm);
+    }
+  };
+  auto crc32h = [&](const Register& rd, const Register& rn, const Register& rm) {
+    if (use_crc32c) {
+      __ Crc32ch(rd, rn, rm);
+    } else {
+      __ Crc32h(rd, rn, rm);
+    }
+  };
+  auto crc32w = [&](const Register& rd, const Register& rn, const Register& rm) {
+    if (use_crc32c) {
+      __ Crc32cw(rd, rn, rm);
+    } else {
+      __ Crc32w(rd, rn, rm);
+    }
+  };
+  auto crc32x = [&](const Register& rd, const Register& rn, const Register& rm) {
+    if (use_crc32c) {
+      __ Crc32cx(rd, rn, rm);
+    } else {
+      __ Crc32x(rd, rn, rm);
+    }
+  };
+
+  if (use_crc32c) {
+    __ Mov(out, crc);
+  } else {
+    __ Mvn(out, crc);
+  }
   __ Mov(len, length);
 
   __ Tbz(ptr, 0, &aligned2);
   __ Subs(len, len, 1);
   __ B(&done, lo);
   __ Ldrb(array_elem, MemOperand(ptr, 1, PostIndex));
-  __ Crc32b(out, out, array_elem);
+  crc32b(out, out, array_elem);
 
   __ Bind(&aligned2);
   __ Tbz(ptr, 1, &aligned4);
   __ Subs(len, len, 2);
   __ B(&process_1byte, lo);
   __ Ldrh(array_elem, MemOperand(ptr, 2, PostIndex));
-  __ Crc32h(out, out, array_elem);
+  crc32h(out, out, array_elem);
 
   __ Bind(&aligned4);
   __ Tbz(ptr, 2, &aligned8);
   __ Subs(len, len, 4);
   __ B(&process_2bytes, lo);
   __ Ldr(array_elem, MemOperand(ptr, 4, PostIndex));
-  __ Crc32w(out, out, array_elem);
+  crc32w(out, out, array_elem);
 
   __ Bind(&aligned8);
   __ Subs(len, len, 8);
@@ -3780,7 +3816,7 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   __ Bind(&loop);
   __ Ldr(array_elem.X(), MemOperand(ptr, 8, PostIndex));
   __ Subs(len, len, 8);
-  __ Crc32x(out, out, array_elem.X());
+  crc32x(out, out, array_elem.X());
   // if len >= 8, process the next 8 bytes.
   __ B(&loop, hs);
 
@@ -3797,22 +3833,24 @@ static void GenerateCodeForCalculationCRC32ValueOfBytes(MacroAssembler* masm,
   // Goto process_2bytes if less than four bytes available
   __ Tbz(len, 2, &process_2bytes);
   __ Ldr(array_elem, MemOperand(ptr, 4, PostIndex));
-  __ Crc32w(out, out, array_elem);
+  crc32w(out, out, array_elem);
 
   __ Bind(&process_2bytes);
   // Goto process_1bytes if less than two bytes available
   __ Tbz(len, 1, &process_1byte);
   __ Ldrh(array_elem, MemOperand(ptr, 2, PostIndex));
-  __ Crc32h(out, out, array_elem);
+  crc32h(out, out, array_elem);
 
   __ Bind(&process_1byte);
   // Goto done if no bytes available
   __ Tbz(len, 0, &done);
   __ Ldrb(array_elem, MemOperand(ptr));
-  __ Crc32b(out, out, array_elem);
+  crc32b(out, out, array_elem);
 
   __ Bind(&done);
-  __ Mvn(out, out);
+  if (!use_crc32c) {
+    __ Mvn(out, out);
+  }
 }
 
 // The threshold for sizes of arrays to use the library provided implementation
@@ -3870,7 +3908,8 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32UpdateBytes(HInvoke* invoke) {
   Register crc = WRegisterFrom(locations->InAt(0));
   Register out = WRegisterFrom(locations->Out());
 
-  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out);
+  GenerateCodeForCalculationCRC32ValueOfBytes(
+      masm, crc, ptr, length, out, /*use_crc32c=*/ false);
 
   __ Bind(slow_path->GetExitLabel());
 }
@@ -3915,7 +3954,106 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
   Register crc = WRegisterFrom(locations->InAt(0));
   Register length = WRegisterFrom(locations->InAt(3));
   Register out = WRegisterFrom(locations->Out());
-  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out);
+  GenerateCodeForCalculationCRC32ValueOfBytes(
+      masm, crc, ptr, length, out, /*use_crc32c=*/ false);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitCRC32CUpdateBytes(HInvoke* invoke) {
+  if (!codegen_->GetInstructionSetFeatures().HasCRC()) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke,
+                                       LocationSummary::kCallOnSlowPath,
+                                       kIntrinsified);
+
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+// Lower the invoke of CRC32C.updateBytes(int crc, byte[] b, int off, int end)
+//
+// The method updateBytes is a private method of java.util.zip.CRC32C, which
+// checks the bounds before calling it.
+//
+// Note: The intrinsic is not used if end - off exceeds a threshold.
+void IntrinsicCodeGeneratorARM64::VisitCRC32CUpdateBytes(HInvoke* invoke) {
+  DCHECK(codegen_->GetInstructionSetFeatures().HasCRC());
+
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  Register offset = WRegisterFrom(locations->InAt(2));
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  __ Sub(length, WRegisterFrom(locations->InAt(3)), offset);
+  __ Cmp(length, kCRC32UpdateBytesThreshold);
+  __ B(slow_path->GetEntryLabel(), hi);
+
+  const uint32_t array_data_offset =
+      mirror::Array::DataOffset(Primitive::kPrimByte).Uint32Value();
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register array = XRegisterFrom(locations->InAt(1));
+  __ Add(ptr, array, array_data_offset);
+  __ Add(ptr, ptr, Operand(offset, SXTW));
+
+  Register crc = WRegisterFrom(locations->InAt(0));
+  Register out = WRegisterFrom(locations->Out());
+
+  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out, /*use_crc32c=*/ true);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitCRC32CUpdateDirectByteBuffer(HInvoke* invoke) {
+  if (!codegen_->GetInstructionSetFeatures().HasCRC()) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke,
+                                       LocationSummary::kNoCall,
+                                       kIntrinsified);
+
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+// Lower the invoke of CRC32C.updateDirectByteBuffer(int crc, long addr, int off, int end)
+//
+// As for CRC32.updateByteBuffer, the method is private and only called with
+// the address and bounds of a direct buffer.
+void IntrinsicCodeGeneratorARM64::VisitCRC32CUpdateDirectByteBuffer(HInvoke* invoke) {
+  DCHECK(codegen_->GetInstructionSetFeatures().HasCRC());
+
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register offset = WRegisterFrom(locations->InAt(2));
+  Register addr = XRegisterFrom(locations->InAt(1));
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  __ Add(ptr, addr, Operand(offset, SXTW));
+
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  __ Sub(length, WRegisterFrom(locations->InAt(3)), offset);
+
+  Register crc = WRegisterFrom(locations->InAt(0));
+  Register out = WRegisterFrom(locations->Out());
+  GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out, /*use_crc32c=*/ true);
 }
 
 void IntrinsicLocationsBuilderARM64::VisitFP16ToFloat(HInvoke* invoke) {
@@ -5377,7 +5515,8 @@ static void CreateVarHandleGetAndUpdateLocations(HInvoke* invoke,
     return;
   }
 
-  if (invoke->GetType() == DataType::Type::kReference && codegen->EmitNonBakerReadBarrier()) {
+  DataType::Type value_type = GetDataTypeFromShorty(invoke, invoke->GetNumberOfArguments() - 1u);
+  if (value_type == DataType::Type::kReference && codegen->EmitNonBakerReadBarrier()) {
     // Unsupported for non-Baker read barrier because the artReadBarrierSlow() ignores
     // the passed reference and reloads it from the field, thus seeing the new value
     // that we have just stored. (And it also gets the memory visibility wrong.) b/173104084
@@ -5388,7 +5527,7 @@ static void CreateVarHandleGetAndUpdateLocations(HInvoke* invoke,
 
   size_t old_temp_count = locations->GetTempCount();
   DCHECK_EQ(old_temp_count, (GetExpectedVarHandleCoordinatesCount(invoke) == 0) ? 2u : 1u);
-  if (DataType::IsFloatingPointType(invoke->GetType())) {
+  if (DataType::IsFloatingPointType(value_type)) {
     if (get_and_update_op == GetAndUpdateOp::kAdd) {
       // For ADD, do not use ZR for zero bit pattern (+0.0f or +0.0).
       locations->SetInAt(invoke->GetNumberOfArguments() - 1u, Location::RequiresFpuRegister());
@@ -5408,12 +5547,18 @@ static void CreateVarHandleGetAndUpdateLocations(HInvoke* invoke,
       (get_and_update_op != GetAndUpdateOp::kSet && get_and_update_op != GetAndUpdateOp::kAdd) &&
       GetExpectedVarHandleCoordinatesCount(invoke) == 2u &&
       !IsZeroBitPattern(invoke->InputAt(invoke->GetNumberOfArguments() - 1u))) {
-    DataType::Type value_type =
-        GetVarHandleExpectedValueType(invoke, /*expected_coordinates_count=*/ 2u);
+    DCHECK_EQ(value_type,
+              GetVarHandleExpectedValueType(invoke, /*expected_coordinates_count=*/ 2u));
     if (value_type != DataType::Type::kReference && DataType::Size(value_type) != 1u) {
       locations->AddTemp(Location::RequiresRegister());
     }
   }
+  if (IsVarHandleGetAndUpdateResultUnused(invoke)) {
+    // Add a temporary for the old value instead of the output. This must be the last temporary.
+    locations->AddTemp(DataType::IsFloatingPointType(value_type)
+        ? Location::RequiresFpuRegister()
+        : Location::RequiresRegister());
+  }
 }
 
 static void GenerateVarHandleGetAndUpdate(HInvoke* invoke,
@@ -5427,7 +5572,10 @@ static void GenerateVarHandleGetAndUpdate(HInvoke* invoke,
   MacroAssembler* masm = codegen->GetVIXLAssembler();
   LocationSummary* locations = invoke->GetLocations();
   CPURegister arg = InputCPURegisterOrZeroRegAt(invoke, arg_index);
-  CPURegister out = helpers::OutputCPURegister(invoke);
+  bool result_unused = IsVarHandleGetAndUpdateResultUnused(invoke);
+  CPURegister out = result_unused
+      ? CPURegisterFrom(locations->GetTemp(locations->GetTempCount() - 1u), value_type)
+      : helpers::OutputCPURegister(invoke);
 
   VarHandleTarget target = GetVarHandleTarget(invoke);
   VarHandleSlowPathARM64* slow_path = nullptr;
@@ -5481,7 +5629,9 @@ static void GenerateVarHandleGetAndUpdate(HInvoke* invoke,
       // the new value unless it is zero bit pattern (+0.0f or +0.0) and need another one
       // in GenerateGetAndUpdate(). We have allocated a normal temporary to handle that.
       old_value = CPURegisterFrom(locations->GetTemp(1u), load_store_type);
-    } else if (value_type == DataType::Type::kReference && codegen->EmitBakerReadBarrier()) {
+    } else if (value_type == DataType::Type::kReference &&
+               codegen->EmitBakerReadBarrier() &&
+               !result_unused) {
       // Load the old value initially to a scratch register.
       // We shall move it to `out` later with a read barrier.
       old_value = temps.AcquireW();
@@ -5528,7 +5678,10 @@ static void GenerateVarHandleGetAndUpdate(HInvoke* invoke,
     __ Sxtb(out.W(), old_value.W());
   } else if (value_type == DataType::Type::kInt16) {
     __ Sxth(out.W(), old_value.W());
-  } else if (value_type == DataType::Type::kReference && codegen->EmitReadBarrier()) {
+  } else if (value_type == DataType::Type::kReference &&
+             codegen->EmitReadBarrier() &&
+             !result_unused) {
+    // A discarded old reference does not need to be marked.
     if (kUseBakerReadBarrier) {
       codegen->GenerateIntrinsicMoveWithBakerReadBarrier(out.W(), old_value.W());
     } else {
@@ -147,6 +147,15 @@ static inline bool IsVarHandleGetAndAdd(HInvoke* invoke) {
   }
 }
 
+// Returns true if the old value returned by a get-and-update VarHandle operation is discarded.
+// Javac gives such invokes a call site returning void when they are used as an expression
+// statement, for example `COUNT.getAndAdd(this, 1);`.
+static inline bool IsVarHandleGetAndUpdateResultUnused(HInvoke* invoke) {
+  DCHECK_EQ(mirror::VarHandle::GetAccessModeTemplateByIntrinsic(invoke->GetIntrinsic()),
+            mirror::VarHandle::AccessModeTemplate::kGetAndUpdate);
+  return invoke->GetType() == DataType::Type::kVoid;
+}
+
 static inline bool IsVarHandleGet(HInvoke* invoke) {
   mirror::VarHandle::AccessModeTemplate access_mode =
       mirror::VarHandle::GetAccessModeTemplateByIntrinsic(invoke->GetIntrinsic());
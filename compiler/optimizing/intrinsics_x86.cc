@@ -946,13 +946,23 @@ static void SystemArrayCopyPrimitive(HInvoke* invoke,
 
   // Do the move.
   switch (type) {
+    case DataType::Type::kBool:
     case DataType::Type::kInt8:
        __ rep_movsb();
        break;
     case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
        __ rep_movsw();
        break;
     case DataType::Type::kInt32:
+    case DataType::Type::kFloat32:
+       __ rep_movsl();
+       break;
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat64:
+       // Copy the 64-bit elements as pairs of 32-bit words. The length of an array is below
+       // 2^31, so doubling the unsigned count cannot overflow.
+       __ shll(count, Immediate(1));
        __ rep_movsl();
        break;
     default:
@@ -988,6 +998,51 @@ void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyInt(HInvoke* invoke) {
   CreateSystemArrayCopyLocations(invoke);
 }
 
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyBoolean(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyBoolean(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kBool);
+}
+
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyShort(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyShort(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kInt16);
+}
+
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyLong(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyLong(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kInt64);
+}
+
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyFloat(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyFloat(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kFloat32);
+}
+
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyDouble(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyDouble(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kFloat64);
+}
+
 void IntrinsicLocationsBuilderX86::VisitStringCompareTo(HInvoke* invoke) {
   // The inputs plus one temp.
   LocationSummary* locations = new (allocator_) LocationSummary(
@@ -815,13 +815,23 @@ static void SystemArrayCopyPrimitive(HInvoke* invoke,
 
   // Do the move.
   switch (type) {
+    case DataType::Type::kBool:
     case DataType::Type::kInt8:
        __ rep_movsb();
        break;
     case DataType::Type::kUint16:
+    case DataType::Type::kInt16:
        __ rep_movsw();
        break;
     case DataType::Type::kInt32:
+    case DataType::Type::kFloat32:
+       __ rep_movsl();
+       break;
+    case DataType::Type::kInt64:
+    case DataType::Type::kFloat64:
+       // Copy the 64-bit elements as pairs of 32-bit words. The length of an array is below
+       // 2^31, so doubling the unsigned count cannot overflow.
+       __ shll(count, Immediate(1));
        __ rep_movsl();
        break;
     default:
@@ -856,6 +866,51 @@ void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyInt(HInvoke* invoke) {
   CreateSystemArrayCopyLocations(invoke);
 }
 
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyBoolean(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyBoolean(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kBool);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyShort(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyShort(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kInt16);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyLong(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyLong(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kInt64);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyFloat(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyFloat(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kFloat32);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyDouble(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyDouble(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  SystemArrayCopyPrimitive(invoke, assembler, codegen_, DataType::Type::kFloat64);
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopy(HInvoke* invoke) {
   // The only read barrier implementation supporting the
   // SystemArrayCopy intrinsic is the Baker-style read barriers.
@@ -1199,6 +1254,12 @@ void IntrinsicLocationsBuilderX86_64::VisitStringEquals(HInvoke* invoke) {
 
   // Set output, RSI needed for repe_cmpsq instruction anyways.
   locations->SetOut(Location::RegisterLocation(RSI), Location::kOutputOverlap);
+
+  if (codegen_->GetInstructionSetFeatures().HasSSE4_1()) {
+    // XMM temporaries for comparing 16 bytes at a time.
+    locations->AddTemp(Location::RequiresFpuRegister());
+    locations->AddTemp(Location::RequiresFpuRegister());
+  }
 }
 
 void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
@@ -1278,15 +1339,47 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   __ leal(rsi, Address(str, value_offset));
   __ leal(rdi, Address(arg, value_offset));
 
-  // Divide string length by 4 and adjust for lengths not divisible by 4.
-  __ addl(rcx, Immediate(3));
-  __ shrl(rcx, Immediate(2));
-
   // Assertions that must hold in order to compare strings 4 characters (uncompressed)
   // or 8 characters (compressed) at a time.
   DCHECK_ALIGNED(value_offset, 8);
   static_assert(IsAligned<8>(kObjectAlignment), "String is not zero padded");
 
+  if (codegen_->GetInstructionSetFeatures().HasSSE4_1()) {
+    XmmRegister str_chunk = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+    XmmRegister arg_chunk = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+    NearLabel loop, tail;
+    // Compute the number of bytes to compare, rounded up to 8 as both strings are zero padded.
+    __ leal(rcx, Address(rcx, rcx, ScaleFactor::TIMES_1, 7));
+    __ andl(rcx, Immediate(-8));
+
+    // Compare 16 bytes at a time. `repe cmpsq` is microcoded and much slower.
+    __ Bind(&loop);
+    __ cmpl(rcx, Immediate(16));
+    __ j(kLess, &tail);
+    __ movdqu(str_chunk, Address(rsi, 0));
+    __ movdqu(arg_chunk, Address(rdi, 0));
+    __ pxor(str_chunk, arg_chunk);
+    __ ptest(str_chunk, str_chunk);
+    __ j(kNotZero, &return_false);
+    __ addq(rsi, Immediate(16));
+    __ addq(rdi, Immediate(16));
+    __ subl(rcx, Immediate(16));
+    __ jmp(&loop);
+
+    // At most 8 bytes remain. Do not read further, as that could be past the end of the objects.
+    __ Bind(&tail);
+    __ testl(rcx, rcx);
+    __ j(kZero, &return_true);
+    __ movq(rcx, Address(rsi, 0));
+    __ cmpq(rcx, Address(rdi, 0));
+    __ j(kNotEqual, &return_false);
+    __ jmp(&return_true);
+  }
+
+  // Divide string length by 4 and adjust for lengths not divisible by 4.
+  __ addl(rcx, Immediate(3));
+  __ shrl(rcx, Immediate(2));
+
   // Loop to compare strings four characters at a time starting at the beginning of the string.
   __ repe_cmpsq();
   // If strings are not equal, zero flag will be cleared.
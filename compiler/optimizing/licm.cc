@@ -16,6 +16,8 @@
 
 #include "licm.h"
 
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
 #include "side_effects_analysis.h"
 
 namespace art HIDDEN {
@@ -78,6 +80,43 @@ static void UpdateLoopPhisIn(HEnvironment* environment, HLoopInformation* info)
   }
 }
 
+/**
+ * Collects the offsets of the fields written in the loop into `offsets`. Returns false if the
+ * loop has any other write that may be seen by a field load, e.g. an invoke.
+ */
+static bool CollectWrittenFieldOffsets(HLoopInformation* info,
+                                       /*out*/ ScopedArenaHashSet<uint32_t>* offsets) {
+  for (HBlocksInLoopIterator it_loop(*info); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (!instruction->DoesAnyWrite() || instruction->IsArraySet()) {
+        continue;
+      } else if (instruction->IsInstanceFieldSet() &&
+                 !instruction->AsInstanceFieldSet()->IsVolatile()) {
+        offsets->insert(instruction->AsInstanceFieldSet()->GetFieldOffset().Uint32Value());
+      } else if (instruction->IsStaticFieldSet() &&
+                 !instruction->AsStaticFieldSet()->IsVolatile()) {
+        offsets->insert(instruction->AsStaticFieldSet()->GetFieldOffset().Uint32Value());
+      } else {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static bool IsFieldGet(HInstruction* instruction) {
+  return instruction->IsInstanceFieldGet() || instruction->IsStaticFieldGet();
+}
+
+static uint32_t GetFieldGetOffset(HInstruction* instruction) {
+  DCHECK(IsFieldGet(instruction));
+  return instruction->IsInstanceFieldGet()
+      ? instruction->AsInstanceFieldGet()->GetFieldOffset().Uint32Value()
+      : instruction->AsStaticFieldGet()->GetFieldOffset().Uint32Value();
+}
+
 bool LICM::Run() {
   bool didLICM = false;
   DCHECK(side_effects_.HasRun());
@@ -102,6 +141,25 @@ bool LICM::Run() {
     SideEffects loop_effects = side_effects_.GetLoopEffects(block);
     HBasicBlock* pre_header = loop_info->GetPreHeader();
 
+    // Side effects do not tell fields of the same type apart, so a field load would not be
+    // hoisted out of a loop that writes any other field of that type, e.g. a getter called
+    // in a loop that updates a counter field. The stores cannot alias the load if they
+    // write fields at other offsets, whatever their receivers are. Collected lazily.
+    ScopedArenaAllocator allocator(graph_->GetArenaStack());
+    ScopedArenaHashSet<uint32_t> written_field_offsets(allocator.Adapter(kArenaAllocLICM));
+    enum class FieldWrites { kNotCollected, kOnlyKnown, kUnknown };
+    FieldWrites field_writes = FieldWrites::kNotCollected;
+    auto is_field_written_in_loop = [&](HInstruction* instruction) {
+      if (field_writes == FieldWrites::kNotCollected) {
+        field_writes = CollectWrittenFieldOffsets(loop_info, &written_field_offsets)
+            ? FieldWrites::kOnlyKnown
+            : FieldWrites::kUnknown;
+      }
+      return field_writes == FieldWrites::kUnknown ||
+             written_field_offsets.find(GetFieldGetOffset(instruction)) !=
+                 written_field_offsets.end();
+    };
+
     for (HBlocksInLoopIterator it_loop(*loop_info); !it_loop.Done(); it_loop.Advance()) {
       HBasicBlock* inner = it_loop.Current();
       DCHECK(inner->IsInLoop());
@@ -146,6 +204,8 @@ bool LICM::Run() {
             }
           } else if (!instruction->GetSideEffects().MayDependOn(loop_effects)) {
             can_move = true;
+          } else if (IsFieldGet(instruction) && !is_field_written_in_loop(instruction)) {
+            can_move = true;
           }
         }
         if (can_move) {
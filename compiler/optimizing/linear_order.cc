@@ -16,6 +16,9 @@
 
 #include "linear_order.h"
 
+#include <algorithm>
+
+#include "base/arena_bit_vector.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 
@@ -36,6 +39,37 @@ static bool IsInnerLoop(HLoopInformation* outer, HLoopInformation* inner) {
       && inner->IsIn(*outer);
 }
 
+// Minimum ratio between the counts of the two edges of a profiled branch for the
+// less taken edge to be considered cold.
+static constexpr uint32_t kColdEdgeRatio = 100;
+
+// Returns whether the edge from `block` to `successor` is expected to be rarely taken.
+static bool IsColdEdge(HBasicBlock* block, HBasicBlock* successor) {
+  if (successor->IsCatchBlock()) {
+    return true;
+  }
+  HIf* hif = block->GetLastInstruction()->AsIfOrNull();
+  if (hif != nullptr && hif->HasBranchProfile()) {
+    bool is_true_successor = (hif->IfTrueSuccessor() == successor);
+    uint32_t taken = is_true_successor ? hif->GetTrueCount() : hif->GetFalseCount();
+    uint32_t not_taken = is_true_successor ? hif->GetFalseCount() : hif->GetTrueCount();
+    return taken * kColdEdgeRatio < not_taken;
+  }
+  // Code leading to a throw is expected to run only in exceptional cases.
+  return successor->GetLastInstruction()->IsThrow();
+}
+
+// Returns whether the successors of `block` should be visited in reverse order, so that
+// the more frequently taken one is placed right after `block`.
+static bool VisitSuccessorsInReverseOrder(HBasicBlock* block) {
+  // The last successor added to the work list is the first one taken out. Without a
+  // profile, keep the false successor of an `HIf` (the dex fall-through) next.
+  HIf* hif = block->GetLastInstruction()->AsIfOrNull();
+  return hif != nullptr &&
+         hif->HasBranchProfile() &&
+         hif->GetTrueCount() > hif->GetFalseCount();
+}
+
 // Helper method to update work list for linear order.
 static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
                                       HBasicBlock* block) {
@@ -87,20 +121,32 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Cold blocks outside of loops are placed after the other blocks, and the
+  //   more frequently taken successor of a profiled branch follows the branch.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
   //      current reverse post order in the graph, but it would require making
   //      order queries to a GrowableArray, which is not the best data structure
-  //      for it.
+  //      for it. Also record which blocks are only reached through cold edges.
   ScopedArenaAllocator allocator(graph->GetArenaStack());
   ScopedArenaVector<uint32_t> forward_predecessors(graph->GetBlocks().size(),
                                                    allocator.Adapter(kArenaAllocLinearOrder));
+  ArenaBitVector cold_blocks(
+      &allocator, graph->GetBlocks().size(), /* expandable= */ false, kArenaAllocLinearOrder);
   for (HBasicBlock* block : graph->GetReversePostOrder()) {
     size_t number_of_forward_predecessors = block->GetPredecessors().size();
     if (block->IsLoopHeader()) {
       number_of_forward_predecessors -= block->GetLoopInformation()->NumberOfBackEdges();
+    } else if (!block->IsEntryBlock() &&
+               std::all_of(block->GetPredecessors().begin(),
+                           block->GetPredecessors().end(),
+                           [&](HBasicBlock* predecessor) {
+                             return cold_blocks.IsBitSet(predecessor->GetBlockId()) ||
+                                    IsColdEdge(predecessor, block);
+                           })) {
+      cold_blocks.SetBit(block->GetBlockId());
     }
     forward_predecessors[block->GetBlockId()] = number_of_forward_predecessors;
   }
@@ -116,13 +162,28 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
     worklist.pop_back();
     linear_order[num_added] = current;
     ++num_added;
-    for (HBasicBlock* successor : current->GetSuccessors()) {
+    auto visit_successor = [&](HBasicBlock* successor) {
       int block_id = successor->GetBlockId();
       size_t number_of_remaining_predecessors = forward_predecessors[block_id];
       if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+        if (cold_blocks.IsBitSet(block_id) && successor->GetLoopInformation() == nullptr) {
+          // Only taken out of the work list once all other blocks have been placed.
+          // Cold blocks in loops stay in place, as the loop must end with a back edge.
+          worklist.insert(worklist.begin(), successor);
+        } else {
+          AddToListForLinearization(&worklist, successor);
+        }
       }
       forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
+    };
+    if (VisitSuccessorsInReverseOrder(current)) {
+      for (HBasicBlock* successor : ReverseRange(current->GetSuccessors())) {
+        visit_successor(successor);
+      }
+    } else {
+      for (HBasicBlock* successor : current->GetSuccessors()) {
+        visit_successor(successor);
+      }
     }
   } while (!worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
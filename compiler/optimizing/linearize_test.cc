@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <fstream>
 
 #include "base/arena_allocator.h"
@@ -245,4 +246,43 @@ TEST_F(LinearizeTest, CFG7) {
   TestCode(data, blocks);
 }
 
+TEST_F(LinearizeTest, ColdThrowingBlock) {
+  // Structure of this graph:
+  //            Block0
+  //              |
+  //            Block1
+  //            /    \
+  //       Return   Throw
+  //            \    /
+  //             Exit
+  //
+  // The false successor of Block1 would normally follow it, but the block ending with
+  // the throw is cold and is placed after all the other blocks but the exit.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 3,
+    Instruction::THROW | 0,
+    Instruction::RETURN_VOID);
+
+  HGraph* graph = CreateCFG(data);
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(kRuntimeISA, "default");
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+  auto position_of = [&](auto predicate) {
+    auto it = std::find_if(linear_order.begin(), linear_order.end(), [&](HBasicBlock* block) {
+      return predicate(block->GetLastInstruction());
+    });
+    EXPECT_TRUE(it != linear_order.end());
+    return std::distance(linear_order.begin(), it);
+  };
+  auto return_position = position_of([](HInstruction* last) { return last->IsReturnVoid(); });
+  auto throw_position = position_of([](HInstruction* last) { return last->IsThrow(); });
+  ASSERT_LT(return_position, throw_position);
+  ASSERT_EQ(linear_order.back(), graph->GetExitBlock());
+}
+
 }  // namespace art
@@ -62,9 +62,28 @@
  *  - In phase 4, we commit the changes, replacing loads marked for elimination
  *    in previous processing and removing stores not marked for keeping. We also
  *    remove allocations that are no longer needed.
- *  - In phase 5, we move allocations which only escape along some executions
- *    closer to their escape points and fixup non-escaping paths with their actual
- *    values, creating PHIs when needed.
+ *  - Before phase 1, we move allocations which only escape along some executions
+ *    to their escape points, so that the other executions only see an allocation
+ *    that does not escape and can be removed in phase 4.
+ *
+ * 0. Materialize partially escaping allocations at their escapes.
+ *
+ * An allocation is materialized when it has a set of escapes, all of them invokes
+ * with an environment, such that each escape dominates all uses that are reachable
+ * from it without going through the allocation again, and there is a path to the
+ * exit that does not escape.
+ * Right before each such escape, we load the current values of the fields of the
+ * original allocation, create a new allocation with these values and replace the
+ * uses dominated by the escape with the new allocation. The original allocation
+ * then no longer escapes and phase 4 removes it together with the loads created
+ * here, which are replaced by the values stored along each path.
+ *
+ * Allocations stored to the heap, returned, merged into Phis or Selects, used in
+ * type checks or deoptimization, or escaping more than once without a new
+ * allocation in between are left alone.
+ *
+ * The time complexity of this phase is
+ *    O(allocations * escapes * (blocks + allocation_uses)) .
  *
  * 1. Walk over blocks and their instructions.
  *
@@ -2901,12 +2920,262 @@ class LSEVisitorWrapper : public DeletableArenaObject<kArenaAllocLSE> {
   LSEVisitor lse_visitor_;
 };
 
+// Moves allocations which only escape along some executions to their escape
+// points. See "0." in the description of the algorithm above.
+class PartialEscapeMaterializer : public ValueObject {
+ public:
+  PartialEscapeMaterializer(HGraph* graph, OptimizingCompilerStats* stats)
+      : graph_(graph), stats_(stats) {}
+
+  void Run();
+
+ private:
+  bool TryMaterializeAtEscapes(HNewInstance* new_instance);
+
+  // Insert a copy of `new_instance` with the current values of the fields written by
+  // `stores` right before `escape` and let the uses dominated by `escape` use it.
+  void MaterializeBefore(HNewInstance* new_instance,
+                         ArrayRef<HInstanceFieldSet* const> stores,
+                         bool has_constructor_fence,
+                         HInstruction* escape);
+
+  // Mark in `reachable` the blocks reachable from the successors of `from` without
+  // entering a block marked in `barriers`.
+  void MarkReachableBlocks(HBasicBlock* from,
+                           const ArenaBitVector& barriers,
+                           ScopedArenaAllocator* allocator,
+                           /*out*/ ArenaBitVector* reachable) const;
+
+  HGraph* const graph_;
+  OptimizingCompilerStats* const stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(PartialEscapeMaterializer);
+};
+
+void PartialEscapeMaterializer::Run() {
+  if (graph_->HasTryCatch() || graph_->HasIrreducibleLoops() || graph_->GetExitBlock() == nullptr) {
+    // Moving an allocation into a try block would change which handler sees its
+    // exceptions and irreducible loops do not let us reason about dominance of
+    // reachable uses. Without an exit block, no path avoids the escapes.
+    return;
+  }
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HNewInstance*> candidates(allocator.Adapter(kArenaAllocLSE));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HNewInstance* new_instance = it.Current()->AsNewInstanceOrNull();
+      if (new_instance != nullptr &&
+          !new_instance->IsFinalizable() &&
+          !new_instance->NeedsChecks()) {
+        candidates.push_back(new_instance);
+      }
+    }
+  }
+  for (HNewInstance* new_instance : candidates) {
+    if (TryMaterializeAtEscapes(new_instance)) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kPartialLSEPossible);
+    }
+  }
+}
+
+bool PartialEscapeMaterializer::TryMaterializeAtEscapes(HNewInstance* new_instance) {
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> escapes(allocator.Adapter(kArenaAllocLSE));
+  bool materializable = true;
+  LambdaEscapeVisitor visitor([&](HInstruction* escape) -> bool {
+    if (!escape->IsInvoke() || !escape->HasEnvironment()) {
+      // The new allocation needs the environment of the escape, which stores to the
+      // heap and returns do not have. Phis, Selects, aliases, type checks, unresolved
+      // accesses and deoptimization would also need the object to be tracked through them.
+      materializable = false;
+      return false;
+    }
+    if (!ContainsElement(escapes, escape)) {
+      escapes.push_back(escape);
+    }
+    return true;
+  });
+  VisitEscapes(new_instance, visitor);
+  if (!materializable || escapes.empty()) {
+    return false;
+  }
+
+  // Collect the fields written to the allocation, which have to be copied to the new
+  // allocations.
+  ScopedArenaVector<HInstanceFieldSet*> stores(allocator.Adapter(kArenaAllocLSE));
+  bool has_constructor_fence = false;
+  for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user->IsConstructorFence()) {
+      has_constructor_fence = true;
+    } else if ((user->IsInstanceFieldGet() || user->IsInstanceFieldSet()) &&
+               user->InputAt(0) == new_instance) {
+      if (user->GetFieldInfo().IsVolatile()) {
+        return false;
+      }
+      HInstanceFieldSet* store = user->AsInstanceFieldSetOrNull();
+      if (store != nullptr &&
+          std::none_of(stores.begin(), stores.end(), [store](HInstanceFieldSet* other) {
+            return other->GetFieldOffset().Uint32Value() == store->GetFieldOffset().Uint32Value();
+          })) {
+        stores.push_back(store);
+      }
+    }
+  }
+
+  // Only the escapes not dominated by another one need a new allocation. The others
+  // use the new allocation of the escape that dominates them.
+  ScopedArenaVector<HInstruction*> primary_escapes(allocator.Adapter(kArenaAllocLSE));
+  for (HInstruction* escape : escapes) {
+    if (std::none_of(escapes.begin(), escapes.end(), [escape](HInstruction* other) {
+          return other->StrictlyDominates(escape);
+        })) {
+      primary_escapes.push_back(escape);
+    }
+  }
+
+  // Moving the allocation only pays off if some executions do not escape.
+  HBasicBlock* allocation_block = new_instance->GetBlock();
+  size_t num_blocks = graph_->GetBlocks().size();
+  ArenaBitVector escape_blocks(&allocator, num_blocks, /*expandable=*/ false, kArenaAllocLSE);
+  for (HInstruction* escape : primary_escapes) {
+    if (escape->GetBlock() == allocation_block) {
+      return false;
+    }
+    escape_blocks.SetBit(escape->GetBlock()->GetBlockId());
+  }
+  ArenaBitVector reachable(&allocator, num_blocks, /*expandable=*/ false, kArenaAllocLSE);
+  MarkReachableBlocks(allocation_block, escape_blocks, &allocator, &reachable);
+  if (!reachable.IsBitSet(graph_->GetExitBlock()->GetBlockId())) {
+    return false;
+  }
+
+  // Each use reachable from an escape must see the new allocation, so it must be
+  // dominated by that escape. This also rejects escapes executed more than once per
+  // allocation, for example in a loop that does not contain the allocation.
+  ArenaBitVector allocation_only(&allocator, num_blocks, /*expandable=*/ false, kArenaAllocLSE);
+  allocation_only.SetBit(allocation_block->GetBlockId());
+  for (HInstruction* escape : primary_escapes) {
+    reachable.ClearAllBits();
+    MarkReachableBlocks(escape->GetBlock(), allocation_only, &allocator, &reachable);
+    for (const HUseListNode<HInstruction*>& use : new_instance->GetUses()) {
+      HInstruction* user = use.GetUser();
+      if (reachable.IsBitSet(user->GetBlock()->GetBlockId()) && !escape->StrictlyDominates(user)) {
+        return false;
+      }
+    }
+  }
+
+  for (HInstruction* escape : primary_escapes) {
+    MaterializeBefore(new_instance, ArrayRef<HInstanceFieldSet* const>(stores),
+                      has_constructor_fence, escape);
+    MaybeRecordStat(stats_, MethodCompilationStat::kPartialAllocationMoved);
+  }
+  return true;
+}
+
+void PartialEscapeMaterializer::MaterializeBefore(HNewInstance* new_instance,
+                                                  ArrayRef<HInstanceFieldSet* const> stores,
+                                                  bool has_constructor_fence,
+                                                  HInstruction* escape) {
+  ArenaAllocator* allocator = graph_->GetAllocator();
+  HBasicBlock* block = escape->GetBlock();
+  uint32_t dex_pc = escape->GetDexPc();
+
+  // Read the field values before the new allocation so that these loads keep using
+  // the original allocation and can be replaced by the stored values.
+  ScopedArenaAllocator local_allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> values(local_allocator.Adapter(kArenaAllocLSE));
+  for (HInstanceFieldSet* store : stores) {
+    const FieldInfo& field_info = store->GetFieldInfo();
+    HInstanceFieldGet* load = new (allocator) HInstanceFieldGet(
+        new_instance,
+        field_info.GetField(),
+        field_info.GetFieldType(),
+        field_info.GetFieldOffset(),
+        field_info.IsVolatile(),
+        field_info.GetFieldIndex(),
+        field_info.GetDeclaringClassDefIndex(),
+        field_info.GetDexFile(),
+        dex_pc);
+    if (load->GetType() == DataType::Type::kReference) {
+      load->SetReferenceTypeInfo(graph_->GetInexactObjectRti());
+    }
+    block->InsertInstructionBefore(load, escape);
+    values.push_back(load);
+  }
+
+  HNewInstance* materialized = new (allocator) HNewInstance(new_instance->InputAt(0),
+                                                            dex_pc,
+                                                            new_instance->GetTypeIndex(),
+                                                            new_instance->GetDexFile(),
+                                                            /*finalizable=*/ false,
+                                                            new_instance->GetEntrypoint());
+  // The class of the original allocation is already initialized at this point.
+  materialized->SetPartialMaterialization();
+  materialized->SetReferenceTypeInfo(new_instance->GetReferenceTypeInfo());
+  block->InsertInstructionBefore(materialized, escape);
+  materialized->CopyEnvironmentFrom(escape->GetEnvironment());
+
+  for (size_t i = 0; i != stores.size(); ++i) {
+    const FieldInfo& field_info = stores[i]->GetFieldInfo();
+    HInstanceFieldSet* store = new (allocator) HInstanceFieldSet(
+        materialized,
+        values[i],
+        field_info.GetField(),
+        field_info.GetFieldType(),
+        field_info.GetFieldOffset(),
+        field_info.IsVolatile(),
+        field_info.GetFieldIndex(),
+        field_info.GetDeclaringClassDefIndex(),
+        field_info.GetDexFile(),
+        dex_pc);
+    block->InsertInstructionBefore(store, escape);
+  }
+  if (has_constructor_fence) {
+    HConstructorFence* fence = new (allocator) HConstructorFence(materialized, dex_pc, allocator);
+    block->InsertInstructionBefore(fence, escape);
+  }
+
+  new_instance->ReplaceUsesDominatedBy(materialized, materialized);
+  new_instance->ReplaceEnvUsesDominatedBy(materialized, materialized);
+}
+
+void PartialEscapeMaterializer::MarkReachableBlocks(HBasicBlock* from,
+                                                    const ArenaBitVector& barriers,
+                                                    ScopedArenaAllocator* allocator,
+                                                    /*out*/ ArenaBitVector* reachable) const {
+  ScopedArenaVector<HBasicBlock*> worklist(allocator->Adapter(kArenaAllocLSE));
+  worklist.push_back(from);
+  while (!worklist.empty()) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      uint32_t id = successor->GetBlockId();
+      if (!barriers.IsBitSet(id) && !reachable->IsBitSet(id)) {
+        reachable->SetBit(id);
+        worklist.push_back(successor);
+      }
+    }
+  }
+}
+
 bool LoadStoreElimination::Run() {
   if (graph_->IsDebuggable()) {
     // Debugger may set heap values or trigger deoptimization of callers.
     // Skip this optimization.
     return false;
   }
+
+  // Currently load_store analysis can't handle predicated load/stores; specifically pairs of
+  // memory operations with different predicates.
+  // TODO: support predicated SIMD.
+  if (graph_->HasPredicatedSIMD()) {
+    return false;
+  }
+
+  PartialEscapeMaterializer(graph_, stats_).Run();
+
   ScopedArenaAllocator allocator(graph_->GetArenaStack());
   LoadStoreAnalysis lsa(graph_, stats_, &allocator);
   lsa.Run();
@@ -2916,13 +3185,6 @@ bool LoadStoreElimination::Run() {
     return false;
   }
 
-  // Currently load_store analysis can't handle predicated load/stores; specifically pairs of
-  // memory operations with different predicates.
-  // TODO: support predicated SIMD.
-  if (graph_->HasPredicatedSIMD()) {
-    return false;
-  }
-
   std::unique_ptr<LSEVisitorWrapper> lse_visitor(
       new (&allocator) LSEVisitorWrapper(graph_, heap_location_collector, stats_));
   lse_visitor->Run();
@@ -19,6 +19,7 @@
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
 #include "induction_var_range.h"
+#include "jit/profiling_info.h"
 
 namespace art HIDDEN {
 
@@ -73,6 +74,48 @@ int64_t LoopAnalysis::GetLoopTripCount(HLoopInformation* loop_info,
   return trip_count;
 }
 
+void LoopAnalysis::CalculateProfiledTripCount(const HGraph* graph,
+                                              LoopAnalysisInfo* analysis_results) {
+  // Minimum number of profiled loop exits for the average trip count to be meaningful.
+  static constexpr uint32_t kMinProfiledLoopExits = 8;
+
+  ProfilingInfo* profiling_info = graph->GetProfilingInfo();
+  HLoopInformation* loop_info = analysis_results->GetLoopInfo();
+  if (profiling_info == nullptr ||
+      graph->IsCompilingBaseline() ||
+      analysis_results->GetTripCount() != LoopAnalysisInfo::kUnknownTripCount ||
+      analysis_results->GetNumberOfExits() != 1) {
+    return;
+  }
+
+  // Branch caches are keyed by the dex pcs of the compiled method, so loops inlined from
+  // other methods cannot use them.
+  HIf* hif = loop_info->GetHeader()->GetLastInstruction()->AsIfOrNull();
+  HSuspendCheck* suspend_check = loop_info->GetSuspendCheck();
+  if (hif == nullptr ||
+      suspend_check == nullptr ||
+      !suspend_check->HasEnvironment() ||
+      suspend_check->GetEnvironment()->GetParent() != nullptr) {
+    return;
+  }
+  BranchCache* cache = profiling_info->GetBranchCache(hif->GetDexPc());
+  if (cache == nullptr) {
+    return;
+  }
+
+  // The loop check is executed once per iteration and once more when leaving the loop.
+  bool exit_on_true = !loop_info->Contains(*hif->IfTrueSuccessor());
+  uint32_t exits = exit_on_true ? cache->GetTrue() : cache->GetFalse();
+  uint32_t iterations = exit_on_true ? cache->GetFalse() : cache->GetTrue();
+  // The counters saturate, after which they no longer reflect the trip count.
+  constexpr uint32_t kSaturated = std::numeric_limits<uint16_t>::max();
+  if (exits < kMinProfiledLoopExits || exits == kSaturated || iterations == kSaturated) {
+    return;
+  }
+  analysis_results->profiled_trip_count_ = iterations / exits;
+  analysis_results->has_uniform_profiled_trip_count_ = (iterations % exits == 0);
+}
+
 // Default implementation of loop helper; used for all targets unless a custom implementation
 // is provided. Enables scalar loop peeling and unrolling with the most conservative heuristics.
 class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
@@ -88,6 +131,9 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
   static constexpr uint32_t kScalarHeuristicMaxBodySizeBlocks = 6;
   // Maximum number of instructions to be created as a result of full unrolling.
   static constexpr uint32_t kScalarHeuristicFullyUnrolledMaxInstrThreshold = 35;
+  // Minimum profiled trip count for unrolling a loop with an unknown trip count; the unrolled
+  // copy keeps its loop check, so only fewer back edges and suspend checks are saved.
+  static constexpr uint32_t kScalarHeuristicMinProfiledTripCountForUnrolling = 16;
 
   bool IsLoopNonBeneficialForScalarOpts(LoopAnalysisInfo* analysis_info) const override {
     return analysis_info->HasLongTypeInstructions() ||
@@ -98,9 +144,12 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
 
   uint32_t GetScalarUnrollingFactor(const LoopAnalysisInfo* analysis_info) const override {
     int64_t trip_count = analysis_info->GetTripCount();
-    // Unroll only loops with known trip count.
+    // Unroll only loops with known trip count or with a big profiled trip count.
     if (trip_count == LoopAnalysisInfo::kUnknownTripCount) {
-      return LoopAnalysisInfo::kNoUnrollingFactor;
+      return (analysis_info->GetProfiledTripCount() >=
+              kScalarHeuristicMinProfiledTripCountForUnrolling)
+          ? kScalarMaxUnrollFactor
+          : LoopAnalysisInfo::kNoUnrollingFactor;
     }
     uint32_t desired_unrolling_factor = kScalarMaxUnrollFactor;
     if (trip_count < desired_unrolling_factor || trip_count % desired_unrolling_factor != 0) {
@@ -120,6 +169,16 @@ class ArchDefaultLoopHelper : public ArchNoOptsLoopHelper {
     return (trip_count * instr_num < kScalarHeuristicFullyUnrolledMaxInstrThreshold);
   }
 
+  bool IsPeelingForProfiledTripCountBeneficial(LoopAnalysisInfo* analysis_info) const override {
+    int64_t trip_count = analysis_info->GetProfiledTripCount();
+    // We assume that the profiled trip count is known.
+    DCHECK_NE(trip_count, LoopAnalysisInfo::kUnknownTripCount);
+    size_t instr_num = analysis_info->GetNumberOfInstructions();
+    return analysis_info->HasUniformProfiledTripCount() &&
+           trip_count > 0 &&
+           (trip_count * instr_num < kScalarHeuristicFullyUnrolledMaxInstrThreshold);
+  }
+
  protected:
   bool IsLoopTooBig(LoopAnalysisInfo* loop_analysis_info,
                     size_t instr_threshold,
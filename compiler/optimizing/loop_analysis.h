@@ -36,6 +36,8 @@ class LoopAnalysisInfo : public ValueObject {
 
   explicit LoopAnalysisInfo(HLoopInformation* loop_info)
       : trip_count_(kUnknownTripCount),
+        profiled_trip_count_(kUnknownTripCount),
+        has_uniform_profiled_trip_count_(false),
         bb_num_(0),
         instr_num_(0),
         exits_num_(0),
@@ -46,6 +48,8 @@ class LoopAnalysisInfo : public ValueObject {
         loop_info_(loop_info) {}
 
   int64_t GetTripCount() const { return trip_count_; }
+  int64_t GetProfiledTripCount() const { return profiled_trip_count_; }
+  bool HasUniformProfiledTripCount() const { return has_uniform_profiled_trip_count_; }
   size_t GetNumberOfBasicBlocks() const { return bb_num_; }
   size_t GetNumberOfInstructions() const { return instr_num_; }
   size_t GetNumberOfExits() const { return exits_num_; }
@@ -72,6 +76,12 @@ class LoopAnalysisInfo : public ValueObject {
  private:
   // Trip count of the loop if known, kUnknownTripCount otherwise.
   int64_t trip_count_;
+  // Average trip count observed by baseline compiled code for a loop whose trip count is not
+  // known statically, kUnknownTripCount if there is no such profile.
+  int64_t profiled_trip_count_;
+  // Whether the profile is consistent with every execution of the loop taking
+  // profiled_trip_count_ iterations.
+  bool has_uniform_profiled_trip_count_;
   // Number of basic blocks in the loop body.
   size_t bb_num_;
   // Number of instructions in the loop body.
@@ -108,6 +118,11 @@ class LoopAnalysis : public ValueObject {
   static int64_t GetLoopTripCount(HLoopInformation* loop_info,
                                   const InductionVarRange* induction_range);
 
+  // Derives the trip count of a loop with a single exit and an unknown trip count from the
+  // branch profile of its loop check, collected by baseline compiled code, and fills
+  // 'analysis_results' with it. Must be called after CalculateLoopBasicProperties.
+  static void CalculateProfiledTripCount(const HGraph* graph, LoopAnalysisInfo* analysis_results);
+
  private:
   // Returns whether an instruction makes scalar loop peeling/unrolling non-beneficial.
   //
@@ -172,6 +187,15 @@ class ArchNoOptsLoopHelper : public ArenaObject<kArenaAllocOptimization> {
     return false;
   }
 
+  // Returns whether it is beneficial to peel as many iterations as the profiled trip count
+  // of the loop.
+  //
+  // Returns 'false' by default, should be overridden by particular target loop helper.
+  virtual bool IsPeelingForProfiledTripCountBeneficial(
+      [[maybe_unused]] LoopAnalysisInfo* analysis_info) const {
+    return false;
+  }
+
   // Returns optimal SIMD unrolling factor for the loop.
   //
   // Returns kNoUnrollingFactor by default, should be overridden by particular target loop helper.
@@ -526,8 +526,8 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_tests_(),
+      num_vector_runtime_tests_(0u),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_external_set_(nullptr),
@@ -886,7 +886,8 @@ bool HLoopOptimization::TryOptimizeInnerLoopFinite(LoopNode* node) {
   // Check loop exits.
   HBasicBlock* exit = GetInnerLoopFiniteSingleExit(node->loop_info);
   if (exit == nullptr) {
-    return false;
+    // Search loops, which leave from the body as well, can still be vectorized.
+    return TryVectorizeEarlyExit(node, trip_count);
   }
 
   HBasicBlock* body = (header->GetSuccessors()[0] == exit)
@@ -979,6 +980,87 @@ bool HLoopOptimization::TryVectorizedTraditional(LoopNode* node,
   return true;
 }
 
+bool HLoopOptimization::TryVectorizeEarlyExit(LoopNode* node, int64_t trip_count) {
+  HLoopInformation* loop_info = node->loop_info;
+  HBasicBlock* header = loop_info->GetHeader();
+
+  // Expect a header with the loop control, a body with the exit test and a back edge block:
+  //   header: if (i >= hi) goto exit-1
+  //   body:   if (a == b) goto exit-2
+  //   latch:  i++; goto header
+  HPhi* main_phi = nullptr;
+  if (!kEnableVectorization ||
+      graph_->IsDebuggable() ||
+      !IsInPredicatedVectorizationMode() ||
+      loop_info->GetBlocks().NumSetBits() != 3 ||
+      loop_info->NumberOfBackEdges() != 1 ||
+      !TrySetSimpleLoopHeader(header, &main_phi) ||
+      !reductions_->empty()) {
+    return false;
+  }
+  HBasicBlock* body = loop_info->Contains(*header->GetSuccessors()[0])
+      ? header->GetSuccessors()[0]
+      : header->GetSuccessors()[1];
+  HInstruction* last = body->GetLastInstruction();
+  if (body->GetPredecessors().size() != 1 || !last->IsIf()) {
+    return false;
+  }
+  HIf* hif = last->AsIf();
+  bool exit_on_true = !loop_info->Contains(*hif->IfTrueSuccessor());
+  HBasicBlock* latch = exit_on_true ? hif->IfFalseSuccessor() : hif->IfTrueSuccessor();
+  HBasicBlock* early_exit = exit_on_true ? hif->IfTrueSuccessor() : hif->IfFalseSuccessor();
+  if (loop_info->Contains(*early_exit) ||
+      !loop_info->IsBackEdge(*latch) ||
+      latch->GetPredecessors().size() != 1 ||
+      !IsEmptyBody(latch)) {
+    return false;
+  }
+
+  // The loop leaves when the operands compare equal.
+  HInstruction* cond = hif->InputAt(0);
+  if (!(exit_on_true ? cond->IsEqual() : cond->IsNotEqual()) ||
+      !cond->HasOnlyOneNonEnvironmentUse()) {
+    return false;
+  }
+
+  // The body is executed speculatively for a whole vector of iterations, so apart from the
+  // loop control it may only compute values.
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction != hif &&
+        iset_->find(instruction) == iset_->end() &&
+        (instruction->CanThrow() ||
+         instruction->NeedsEnvironment() ||
+         instruction->GetSideEffects().DoesAnyWrite())) {
+      return false;
+    }
+  }
+
+  // Reset vector bookkeeping.
+  vector_length_ = 0;
+  vector_refs_->clear();
+  vector_static_peeling_factor_ = 0;
+  vector_dynamic_peeling_candidate_ = nullptr;
+  num_vector_runtime_tests_ = 0u;
+
+  DataType::Type type = DataType::Type::kVoid;
+  HInstruction* opa = nullptr;
+  HInstruction* opb = nullptr;
+  uint64_t restrictions = kNone;
+  if (!TrySetVectorConditionType(cond->AsCondition(), &type, &opa, &opb, &restrictions) ||
+      (loop_info->IsDefinedOutOfTheLoop(opa) && loop_info->IsDefinedOutOfTheLoop(opb)) ||
+      !VectorizeUse(node, opa, /*generate_code*/ false, type, restrictions) ||
+      !VectorizeUse(node, opb, /*generate_code*/ false, type, restrictions) ||
+      !IsVectorizationProfitable(trip_count)) {
+    return false;
+  }
+
+  VectorizeEarlyExit(node, body, main_phi, cond, opa, opb, type, restrictions);
+  MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorized);
+  graph_->SetHasPredicatedSIMD(true);  // flag SIMD usage
+  return true;
+}
+
 bool HLoopOptimization::OptimizeInnerLoop(LoopNode* node) {
   return TryOptimizeInnerLoopFinite(node) || TryLoopScalarOpts(node);
 }
@@ -1007,11 +1089,14 @@ bool HLoopOptimization::TryUnrollingForBranchPenaltyReduction(LoopAnalysisInfo*
     LoopClonerSimpleHelper helper(loop_info, &induction_range_);
     helper.DoUnrolling();
 
-    // Remove the redundant loop check after unrolling.
-    HIf* copy_hif =
-        helper.GetBasicBlockMap()->Get(loop_info->GetHeader())->GetLastInstruction()->AsIf();
-    int32_t constant = loop_info->Contains(*copy_hif->IfTrueSuccessor()) ? 1 : 0;
-    copy_hif->ReplaceInput(graph_->GetIntConstant(constant), 0u);
+    // Remove the redundant loop check after unrolling. With a trip count that is only known
+    // from the profile, the copy of the check must stay.
+    if (analysis_info->GetTripCount() != LoopAnalysisInfo::kUnknownTripCount) {
+      HIf* copy_hif =
+          helper.GetBasicBlockMap()->Get(loop_info->GetHeader())->GetLastInstruction()->AsIf();
+      int32_t constant = loop_info->Contains(*copy_hif->IfTrueSuccessor()) ? 1 : 0;
+      copy_hif->ReplaceInput(graph_->GetIntConstant(constant), 0u);
+    }
   }
   return true;
 }
@@ -1084,6 +1169,25 @@ bool HLoopOptimization::TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool g
   return true;
 }
 
+bool HLoopOptimization::TryPeelingForProfiledTripCount(LoopAnalysisInfo* analysis_info,
+                                                       bool generate_code) {
+  // Peel the iterations of loops that were profiled to run a small number of times. Unlike
+  // full unrolling, the loop stays in place for executions that take more iterations.
+  int64_t trip_count = analysis_info->GetProfiledTripCount();
+  if (!arch_loop_helper_->IsLoopPeelingEnabled() ||
+      analysis_info->GetTripCount() != LoopAnalysisInfo::kUnknownTripCount ||
+      trip_count == LoopAnalysisInfo::kUnknownTripCount ||
+      !arch_loop_helper_->IsPeelingForProfiledTripCountBeneficial(analysis_info)) {
+    return false;
+  }
+
+  if (generate_code) {
+    PeelByCount(analysis_info->GetLoopInfo(), trip_count, &induction_range_);
+  }
+
+  return true;
+}
+
 bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
   HLoopInformation* loop_info = node->loop_info;
   int64_t trip_count = LoopAnalysis::GetLoopTripCount(loop_info, &induction_range_);
@@ -1097,12 +1201,14 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
 
   LoopAnalysisInfo analysis_info(loop_info);
   LoopAnalysis::CalculateLoopBasicProperties(loop_info, &analysis_info, trip_count);
+  LoopAnalysis::CalculateProfiledTripCount(graph_, &analysis_info);
   if (analysis_info.HasInstructionsPreventingScalarOpts() ||
       arch_loop_helper_->IsLoopNonBeneficialForScalarOpts(&analysis_info)) {
     return false;
   }
 
   if (!TryFullUnrolling(&analysis_info, /*generate_code*/ false) &&
+      !TryPeelingForProfiledTripCount(&analysis_info, /*generate_code*/ false) &&
       !TryPeelingForLoopInvariantExitsElimination(&analysis_info, /*generate_code*/ false) &&
       !TryUnrollingForBranchPenaltyReduction(&analysis_info, /*generate_code*/ false) &&
       !TryToRemoveSuspendCheckFromLoopHeader(&analysis_info, /*generate_code*/ false)) {
@@ -1120,6 +1226,7 @@ bool HLoopOptimization::TryLoopScalarOpts(LoopNode* node) {
   }
 
   return TryFullUnrolling(&analysis_info) ||
+         TryPeelingForProfiledTripCount(&analysis_info) ||
          TryPeelingForLoopInvariantExitsElimination(&analysis_info) ||
          TryUnrollingForBranchPenaltyReduction(&analysis_info) || removed_suspend_check;
 }
@@ -1139,8 +1246,7 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  num_vector_runtime_tests_ = 0u;
 
   // Traverse the data flow of the loop, in the original program order.
   for (HBlocksInLoopReversePostOrderIterator block_it(*header->GetLoopInformation());
@@ -1213,16 +1319,8 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
           // Found a[i+x] vs. b[i+y]. Accept if x == y (at worst loop-independent data dependence).
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
-          if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
-            }
+          if (x != y && !AddArrayRefsDisambiguationTest(a, b)) {
+            return false;  // too many tests would be needed
           }
         }
       }
@@ -1278,6 +1376,36 @@ bool HLoopOptimization::ShouldVectorizeCommon(LoopNode* node,
   return true;
 }
 
+bool HLoopOptimization::AddArrayRefsDisambiguationTest(HInstruction* a, HInstruction* b) {
+  for (size_t i = 0; i != num_vector_runtime_tests_; ++i) {
+    const auto& [test_a, test_b] = vector_runtime_tests_[i];
+    if ((test_a == a && test_b == b) || (test_a == b && test_b == a)) {
+      return true;  // already tested
+    }
+  }
+  // To avoid excessive overhead, we only accept a few a != b tests.
+  if (num_vector_runtime_tests_ == kMaxVectorRuntimeTests) {
+    return false;
+  }
+  vector_runtime_tests_[num_vector_runtime_tests_] = {a, b};
+  ++num_vector_runtime_tests_;
+  return true;
+}
+
+HInstruction* HLoopOptimization::GenerateArrayRefsDisambiguationTest(HBasicBlock* block,
+                                                                     HInstruction* vtc,
+                                                                     DataType::Type induc_type) {
+  DCHECK(NeedsArrayRefsDisambiguationTest());
+  // Any aliased pair of array refs sends all the iterations to the scalar loop.
+  HInstruction* zero = graph_->GetConstant(induc_type, 0);
+  for (size_t i = 0; i != num_vector_runtime_tests_; ++i) {
+    const auto& [a, b] = vector_runtime_tests_[i];
+    HInstruction* rt = Insert(block, new (global_allocator_) HNotEqual(a, b));
+    vtc = Insert(block, new (global_allocator_) HSelect(rt, vtc, zero, kNoDexPc));
+  }
+  return vtc;
+}
+
 void HLoopOptimization::VectorizePredicated(LoopNode* node,
                                             HBasicBlock* block,
                                             HBasicBlock* exit) {
@@ -1305,15 +1433,10 @@ void HLoopOptimization::VectorizePredicated(LoopNode* node,
   HInstruction* vtc = stc;
   vector_index_ = graph_->GetConstant(induc_type, 0);
   bool needs_disambiguation_test = false;
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
-    vtc = Insert(preheader,
-                 new (global_allocator_)
-                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    vtc = GenerateArrayRefsDisambiguationTest(preheader, vtc, induc_type);
     needs_disambiguation_test = true;
   }
 
@@ -1346,7 +1469,130 @@ void HLoopOptimization::VectorizePredicated(LoopNode* node,
   }
 
   FinalizeVectorization(node);
+  SetExternalGoverningPredicates();
+}
+
+void HLoopOptimization::VectorizeEarlyExit(LoopNode* node,
+                                           HBasicBlock* body,
+                                           HPhi* main_phi,
+                                           HInstruction* cond,
+                                           HInstruction* opa,
+                                           HInstruction* opb,
+                                           DataType::Type type,
+                                           uint64_t restrictions) {
+  DCHECK(IsInPredicatedVectorizationMode());
+
+  HLoopInformation* loop_info = node->loop_info;
+  HBasicBlock* preheader = loop_info->GetPreHeader();
+
+  // Loop induction type.
+  DataType::Type induc_type = main_phi->GetType();
+  DCHECK(induc_type == DataType::Type::kInt32 || induc_type == DataType::Type::kInt64)
+      << induc_type;
+
+  // Generate loop control:
+  // stc = <trip-count>;
+  HInstruction* stc = induction_range_.GenerateTripCount(loop_info, graph_, preheader);
+
+  // Generate vector loop, which stops at the first vector with a matching element:
+  // for (i = 0, hi = stc; i < hi; i += vector_length)
+  //    if (any(<vectorized-condition>)) hi = i;
+  HBasicBlock* preheader_for_vector_loop =
+      graph_->TransformLoopForEarlyExitVectorization(loop_info->GetHeader());
+  vector_mode_ = VectorMode::kVector;
+  HInstruction* lo = graph_->GetConstant(induc_type, 0);
+  HPhi* phi = InitializeForNewLoop(preheader_for_vector_loop, lo);
+  HPhi* hi_phi = new (global_allocator_) HPhi(global_allocator_,
+                                              kNoRegNumber,
+                                              0,
+                                              HPhi::ToPhiType(induc_type));
+  vector_header_->AddPhi(hi_phi);
+  HBasicBlock* vector_exit = vector_header_->GetSuccessors()[0];
 
+  // Generate loop exit check.
+  HVecPredWhile* pred_while =
+      new (global_allocator_) HVecPredWhile(global_allocator_,
+                                            phi,
+                                            hi_phi,
+                                            HVecPredWhile::CondKind::kLO,
+                                            DataType::Type::kInt32,
+                                            vector_length_,
+                                            0u);
+  HInstruction* exit_cond =
+      new (global_allocator_) HVecPredToBoolean(global_allocator_,
+                                                pred_while,
+                                                HVecPredToBoolean::PCondKind::kNFirst,
+                                                DataType::Type::kInt32,
+                                                vector_length_,
+                                                0u);
+  vector_header_->AddInstruction(pred_while);
+  vector_header_->AddInstruction(exit_cond);
+  vector_header_->AddInstruction(new (global_allocator_) HIf(exit_cond));
+
+  // Generate the operands of the condition, in the original program order.
+  vector_map_->clear();
+  bool vectorized_cond = VectorizeUse(node, opa, /*generate_code*/ true, type, restrictions) &&
+                         VectorizeUse(node, opb, /*generate_code*/ true, type, restrictions);
+  DCHECK(vectorized_cond);
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    auto i = vector_map_->find(it.Current());
+    if (i != vector_map_->end() && !i->second->IsInBlock()) {
+      Insert(vector_body_, i->second);
+    }
+  }
+
+  // Generate the condition; the flags it sets are consumed right away by the
+  // VecPredToBoolean, so the two must stay adjacent.
+  HInstruction* vec_cond = Insert(vector_body_,
+                                  new (global_allocator_) HVecCondition(global_allocator_,
+                                                                        vector_map_->Get(opa),
+                                                                        vector_map_->Get(opb),
+                                                                        type,
+                                                                        vector_length_,
+                                                                        cond->GetDexPc()));
+  HInstruction* found = Insert(vector_body_,
+                               new (global_allocator_) HVecPredToBoolean(
+                                   global_allocator_,
+                                   vec_cond->AsVecPredSetOperation(),
+                                   HVecPredToBoolean::PCondKind::kAny,
+                                   type,
+                                   vector_length_,
+                                   0u));
+  HInstruction* next_hi = Insert(vector_body_,
+                                 new (global_allocator_) HSelect(found, phi, hi_phi, kNoDexPc));
+
+  // Assign the governing predicate for the vector instructions in the loop.
+  for (HInstructionIterator it(vector_body_->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instr = it.Current();
+    if (instr->IsVecOperation() &&
+        instr->AsVecOperation()->MustBePredicatedInPredicatedSIMDMode() &&
+        !instr->AsVecOperation()->IsPredicated()) {
+      instr->AsVecOperation()->SetMergingGoverningPredicate(pred_while);
+    }
+  }
+
+  // Generate the induction.
+  vector_index_ = Insert(vector_body_,
+                         new (global_allocator_) HAdd(induc_type,
+                                                      phi,
+                                                      graph_->GetConstant(induc_type,
+                                                                          vector_length_)));
+  FinalizePhisForNewLoop(phi, lo);
+  hi_phi->AddInput(stc);
+  hi_phi->AddInput(next_hi);
+
+  // Continue the original loop from the vector with the first match, if any:
+  // i = <initial-value> + min(i, hi);
+  HInstruction* start = Insert(vector_exit,
+                               new (global_allocator_) HMin(induc_type, phi, hi_phi, kNoDexPc));
+  start = Insert(vector_exit,
+                 new (global_allocator_) HAdd(induc_type, main_phi->InputAt(0), start));
+  main_phi->ReplaceInput(start, 0);
+
+  SetExternalGoverningPredicates();
+}
+
+void HLoopOptimization::SetExternalGoverningPredicates() {
   // Assign governing predicates for the predicated instructions inserted during vectorization
   // outside the loop.
   for (auto it : *vector_external_set_) {
@@ -1452,15 +1698,10 @@ void HLoopOptimization::VectorizeTraditional(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation tests:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
-    vtc = Insert(preheader,
-                 new (global_allocator_)
-                 HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
+    vtc = GenerateArrayRefsDisambiguationTest(preheader, vtc, induc_type);
     needs_cleanup = true;
   }
 
@@ -2711,6 +2952,43 @@ bool HLoopOptimization::VectorizeDotProdIdiom(LoopNode* node,
   return false;
 }
 
+bool HLoopOptimization::TrySetVectorConditionType(HCondition* cond,
+                                                  /*out*/ DataType::Type* type,
+                                                  /*out*/ HInstruction** opa_promoted,
+                                                  /*out*/ HInstruction** opb_promoted,
+                                                  /*inout*/ uint64_t* restrictions) {
+  HInstruction* opa = cond->InputAt(0);
+  HInstruction* opb = cond->InputAt(1);
+  DataType::Type narrower_type = GetNarrowerType(opa, opb);
+
+  if (!DataType::IsIntegralType(narrower_type)) {
+    return false;
+  }
+
+  bool is_unsigned = false;
+  *opa_promoted = opa;
+  *opb_promoted = opb;
+  bool is_int_case = DataType::Type::kInt32 == opa->GetType() &&
+                     DataType::Type::kInt32 == opb->GetType();
+
+  // Condition arguments should be either both int32 or consistently extended signed/unsigned
+  // narrower operands.
+  if (!is_int_case &&
+      !IsNarrowerOperands(opa, opb, narrower_type, opa_promoted, opb_promoted, &is_unsigned)) {
+    return false;
+  }
+  *type = HVecOperation::ToProperType(narrower_type, is_unsigned);
+
+  // For narrow types, explicit type conversion may have been
+  // optimized way, so set the no hi bits restriction here.
+  if (DataType::Size(*type) <= 2) {
+    *restrictions |= kNoHiBits;
+  }
+
+  return TrySetVectorType(*type, restrictions) &&
+         !HasVectorRestrictions(*restrictions, kNoIfCond);
+}
+
 bool HLoopOptimization::VectorizeIfCondition(LoopNode* node,
                                              HInstruction* hif,
                                              bool generate_code,
@@ -2731,34 +3009,11 @@ bool HLoopOptimization::VectorizeIfCondition(LoopNode* node,
   HCondition* cond = if_input->AsCondition();
   HInstruction* opa = cond->InputAt(0);
   HInstruction* opb = cond->InputAt(1);
-  DataType::Type type = GetNarrowerType(opa, opb);
-
-  if (!DataType::IsIntegralType(type)) {
-    return false;
-  }
-
-  bool is_unsigned = false;
-  HInstruction* opa_promoted = opa;
-  HInstruction* opb_promoted = opb;
-  bool is_int_case = DataType::Type::kInt32 == opa->GetType() &&
-                     DataType::Type::kInt32 == opb->GetType();
-
-  // Condition arguments should be either both int32 or consistently extended signed/unsigned
-  // narrower operands.
-  if (!is_int_case &&
-      !IsNarrowerOperands(opa, opb, type, &opa_promoted, &opb_promoted, &is_unsigned)) {
-    return false;
-  }
-  type = HVecOperation::ToProperType(type, is_unsigned);
-
-  // For narrow types, explicit type conversion may have been
-  // optimized way, so set the no hi bits restriction here.
-  if (DataType::Size(type) <= 2) {
-    restrictions |= kNoHiBits;
-  }
+  DataType::Type type = DataType::Type::kVoid;
+  HInstruction* opa_promoted = nullptr;
+  HInstruction* opb_promoted = nullptr;
 
-  if (!TrySetVectorType(type, &restrictions) ||
-      HasVectorRestrictions(restrictions, kNoIfCond)) {
+  if (!TrySetVectorConditionType(cond, &type, &opa_promoted, &opb_promoted, &restrictions)) {
     return false;
   }
 
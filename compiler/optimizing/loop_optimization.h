@@ -17,6 +17,9 @@
 #ifndef ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
 #define ART_COMPILER_OPTIMIZING_LOOP_OPTIMIZATION_H_
 
+#include <array>
+#include <utility>
+
 #include "base/macros.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
@@ -53,6 +56,9 @@ class HLoopOptimization : public HOptimization {
   // be performed.
   static constexpr int64_t kMaxTotalInstRemoveSuspendCheck = 128;
 
+  // The maximum number of a != b runtime disambiguation tests guarding a vector loop.
+  static constexpr size_t kMaxVectorRuntimeTests = 4;
+
  private:
   /**
    * A single loop inside the loop hierarchy representation.
@@ -276,6 +282,13 @@ class HLoopOptimization : public HOptimization {
   // should be actually applied.
   bool TryFullUnrolling(LoopAnalysisInfo* analysis_info, bool generate_code = true);
 
+  // Tries to peel as many iterations as the profiled trip count of a small loop whose trip
+  // count is not known statically, which gives a straight-line path for the common case.
+  // Returns whether transformation happened. 'generate_code' determines whether the
+  // optimization should be actually applied.
+  bool TryPeelingForProfiledTripCount(LoopAnalysisInfo* analysis_info,
+                                      bool generate_code = true);
+
   // Tries to remove SuspendCheck for plain loops with a low trip count. The
   // SuspendCheck in the codegen makes sure that the thread can be interrupted
   // during execution for GC. Not being able to do so might decrease the
@@ -334,6 +347,33 @@ class HLoopOptimization : public HOptimization {
                             HBasicBlock* exit,
                             int64_t trip_count);
 
+  // Try to vectorize a search loop with an early exit in predicated mode, returns whether it
+  // was successful. The supported loops have the form
+  //
+  //   for (int i = lo; i < hi; i++) {
+  //     if (<expr>[i] == <expr>[i]) break;  // or return
+  //   }
+  //
+  // where the loop body has no other side effects. The vector loop scans whole vectors of
+  // elements until it finds a vector with a matching element; the original loop is kept and
+  // finishes the search starting from that vector.
+  bool TryVectorizeEarlyExit(LoopNode* node, int64_t trip_count);
+
+  // Vectorizes the early exit loop for which all checks have been already done; `cond` is the
+  // exit condition, which compares `opa` and `opb` in vectors of `type`.
+  void VectorizeEarlyExit(LoopNode* node,
+                          HBasicBlock* body,
+                          HPhi* main_phi,
+                          HInstruction* cond,
+                          HInstruction* opa,
+                          HInstruction* opb,
+                          DataType::Type type,
+                          uint64_t restrictions);
+
+  // Assigns all-true governing predicates to the vector instructions that were placed outside
+  // the vector loop during predicated vectorization.
+  void SetExternalGoverningPredicates();
+
   // Performs final steps for whole vectorization process: links reduction, removes the original
   // scalar loop, updates loop info.
   void FinalizeVectorization(LoopNode* node);
@@ -381,7 +421,17 @@ class HLoopOptimization : public HOptimization {
                                HInstruction* step);
 
   // Returns whether the vector loop needs runtime disambiguation test for array refs.
-  bool NeedsArrayRefsDisambiguationTest() const { return vector_runtime_test_a_ != nullptr; }
+  bool NeedsArrayRefsDisambiguationTest() const { return num_vector_runtime_tests_ != 0u; }
+
+  // Records that the array refs `a` and `b` need a runtime disambiguation test. Returns false
+  // if that would exceed kMaxVectorRuntimeTests.
+  bool AddArrayRefsDisambiguationTest(HInstruction* a, HInstruction* b);
+
+  // Generates the runtime disambiguation tests in the given block, returning `vtc` if all
+  // the array refs are disjoint and 0 otherwise.
+  HInstruction* GenerateArrayRefsDisambiguationTest(HBasicBlock* block,
+                                                    HInstruction* vtc,
+                                                    DataType::Type induc_type);
 
   bool VectorizeDef(LoopNode* node, HInstruction* instruction, bool generate_code);
   bool VectorizeUse(LoopNode* node,
@@ -441,6 +491,14 @@ class HLoopOptimization : public HOptimization {
                             bool generate_code,
                             uint64_t restrictions);
 
+  // Checks whether the operands of the integral condition `cond` can be compared lane-wise;
+  // if so, sets the vector type and returns it along with the (possibly promoted) operands.
+  bool TrySetVectorConditionType(HCondition* cond,
+                                 /*out*/ DataType::Type* type,
+                                 /*out*/ HInstruction** opa_promoted,
+                                 /*out*/ HInstruction** opb_promoted,
+                                 /*inout*/ uint64_t* restrictions);
+
   // Vectorization heuristics.
   Alignment ComputeAlignment(HInstruction* offset,
                              DataType::Type type,
@@ -530,9 +588,10 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b.
+  std::array<std::pair<HInstruction*, HInstruction*>, kMaxVectorRuntimeTests>
+      vector_runtime_tests_;
+  size_t num_vector_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
@@ -39,6 +39,7 @@
 #include "intrinsic_objects.h"
 #include "intrinsics.h"
 #include "intrinsics_list.h"
+#include "jit/profiling_info.h"
 #include "mirror/class-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "ssa_builder.h"
@@ -63,6 +64,10 @@ void HGraph::AddBlock(HBasicBlock* block) {
   blocks_.push_back(block);
 }
 
+bool HGraph::CanSpeculate(DeoptimizationKind kind) const {
+  return profiling_info_ == nullptr || profiling_info_->CanSpeculate(kind);
+}
+
 void HGraph::FindBackEdges(ArenaBitVector* visited) {
   // "visited" must be empty on entry, it's an output argument for all visited (i.e. live) blocks.
   DCHECK_EQ(visited->GetHighestBitSet(), -1);
@@ -3084,6 +3089,66 @@ HBasicBlock* HGraph::TransformLoopForVectorization(HBasicBlock* header,
   return new_pre_header;
 }
 
+HBasicBlock* HGraph::TransformLoopForEarlyExitVectorization(HBasicBlock* header) {
+  DCHECK(header->IsLoopHeader());
+  HLoopInformation* loop = header->GetLoopInformation();
+  HBasicBlock* pre_header = loop->GetPreHeader();
+
+  // Add new loop blocks; the new exit becomes the preheader of the original loop.
+  HBasicBlock* new_header = new (allocator_) HBasicBlock(this, header->GetDexPc());
+  HBasicBlock* new_body = new (allocator_) HBasicBlock(this, header->GetDexPc());
+  HBasicBlock* new_exit = new (allocator_) HBasicBlock(this, header->GetDexPc());
+  AddBlock(new_header);
+  AddBlock(new_body);
+  AddBlock(new_exit);
+
+  // Set up control flow. Replacing the predecessor keeps the order of the header phi inputs.
+  header->ReplacePredecessor(pre_header, new_exit);
+  pre_header->AddSuccessor(new_header);
+  new_header->AddSuccessor(new_exit);
+  new_header->AddSuccessor(new_body);
+  new_body->AddSuccessor(new_header);
+
+  // Set up dominators.
+  pre_header->ReplaceDominatedBlock(header, new_header);
+  new_header->SetDominator(pre_header);
+  new_header->dominated_blocks_.push_back(new_body);
+  new_body->SetDominator(new_header);
+  new_header->dominated_blocks_.push_back(new_exit);
+  new_exit->SetDominator(new_header);
+  new_exit->dominated_blocks_.push_back(header);
+  header->SetDominator(new_exit);
+
+  // Fix reverse post order.
+  size_t index_of_header = IndexOfElement(reverse_post_order_, header);
+  MakeRoomFor(&reverse_post_order_, 3, index_of_header - 1);
+  reverse_post_order_[index_of_header++] = new_header;
+  reverse_post_order_[index_of_header++] = new_body;
+  reverse_post_order_[index_of_header++] = new_exit;
+
+  // Add gotos and suspend check (client must add conditional in header).
+  HSuspendCheck* suspend_check = new (allocator_) HSuspendCheck(header->GetDexPc());
+  new_header->AddInstruction(suspend_check);
+  new_body->AddInstruction(new (allocator_) HGoto());
+  new_exit->AddInstruction(new (allocator_) HGoto());
+  DCHECK(loop->GetSuspendCheck() != nullptr);
+  suspend_check->CopyEnvironmentFromWithLoopPhiAdjustment(
+      loop->GetSuspendCheck()->GetEnvironment(), header);
+
+  // Update loop information.
+  new_header->AddBackEdge(new_body);
+  new_header->GetLoopInformation()->SetSuspendCheck(suspend_check);
+  new_header->GetLoopInformation()->Populate();
+  new_exit->SetLoopInformation(pre_header->GetLoopInformation());  // outward
+  HLoopInformationOutwardIterator it(*new_header);
+  for (it.Advance(); !it.Done(); it.Advance()) {
+    it.Current()->Add(new_header);
+    it.Current()->Add(new_body);
+    it.Current()->Add(new_exit);
+  }
+  return pre_header;
+}
+
 static void CheckAgainstUpperBound(ReferenceTypeInfo rti, ReferenceTypeInfo upper_bound_rti)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   if (rti.IsValid()) {
@@ -505,6 +505,11 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
                                              HBasicBlock* body,
                                              HBasicBlock* exit);
 
+  // Adds a new loop directly before the loop with the given header, on the edge from its
+  // preheader. The original loop is kept and entered once the new loop exits.
+  // Returns the preheader of the new loop.
+  HBasicBlock* TransformLoopForEarlyExitVectorization(HBasicBlock* header);
+
   // Removes `block` from the graph. Assumes `block` has been disconnected from
   // other blocks and has no instructions or phis.
   void DeleteDeadEmptyBlock(HBasicBlock* block);
@@ -732,6 +737,11 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   void SetProfilingInfo(ProfilingInfo* info) { profiling_info_ = info; }
   ProfilingInfo* GetProfilingInfo() const { return profiling_info_; }
 
+  // Returns whether the code for this graph may emit a speculation guarded by a
+  // deoptimization of the given `kind`. Speculations which made previously compiled
+  // code for the method deoptimize too often are disabled.
+  bool CanSpeculate(DeoptimizationKind kind) const;
+
   // Returns an instruction with the opposite Boolean value from 'cond'.
   // The instruction has been inserted into the graph, either as a constant, or
   // before cursor.
@@ -3552,6 +3562,13 @@ class HIf final : public HExpression<1> {
   void SetFalseCount(uint16_t count) { false_count_ = count; }
   uint16_t GetFalseCount() const { return false_count_; }
 
+  // Whether the counts were recorded by the baseline compiled code of the method.
+  // Branches without profiling data have both counts set to the maximum.
+  bool HasBranchProfile() const {
+    return true_count_ != std::numeric_limits<uint16_t>::max() ||
+           false_count_ != std::numeric_limits<uint16_t>::max();
+  }
+
   DECLARE_INSTRUCTION(If);
 
  protected:
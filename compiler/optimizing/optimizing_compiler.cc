@@ -31,6 +31,7 @@
 #include "base/mutex.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/systrace.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "builder.h"
 #include "code_generator.h"
@@ -44,6 +45,7 @@
 #include "graph_checker.h"
 #include "graph_visualizer.h"
 #include "inliner.h"
+#include "instrumentation.h"
 #include "jit/debugger_interface.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
@@ -53,7 +55,9 @@
 #include "nodes.h"
 #include "oat/oat_quick_method_header.h"
 #include "optimizing/write_barrier_elimination.h"
+#include "pass_timing_stats.h"
 #include "prepare_for_register_allocation.h"
+#include "profile/profile_compilation_info.h"
 #include "profiling_info_builder.h"
 #include "reference_type_propagation.h"
 #include "register_allocator_linear_scan.h"
@@ -83,12 +87,16 @@ class PassObserver : public ValueObject {
   PassObserver(HGraph* graph,
                CodeGenerator* codegen,
                std::ostream* visualizer_output,
-               const CompilerOptions& compiler_options)
+               const CompilerOptions& compiler_options,
+               PassTimingStats* pass_timing_stats)
       : graph_(graph),
         last_seen_graph_size_(0),
         cached_method_name_(),
         timing_logger_enabled_(compiler_options.GetDumpPassTimings()),
         timing_logger_(timing_logger_enabled_ ? GetMethodName() : "", true, true),
+        pass_timing_stats_(pass_timing_stats),
+        pass_times_(),
+        pass_start_ns_(0u),
         disasm_info_(graph->GetAllocator()),
         visualizer_oss_(),
         visualizer_output_(visualizer_output),
@@ -108,6 +116,9 @@ class PassObserver : public ValueObject {
   }
 
   ~PassObserver() {
+    if (pass_timing_stats_ != nullptr && !pass_times_.empty()) {
+      pass_timing_stats_->RecordMethod(GetMethodName(), std::move(pass_times_));
+    }
     if (timing_logger_enabled_) {
       LOG(INFO) << "TIMINGS " << GetMethodName();
       LOG(INFO) << Dumpable<TimingLogger>(timing_logger_);
@@ -146,6 +157,9 @@ class PassObserver : public ValueObject {
     if (timing_logger_enabled_) {
       timing_logger_.StartTiming(pass_name);
     }
+    if (pass_timing_stats_ != nullptr) {
+      pass_start_ns_ = NanoTime();
+    }
   }
 
   void FlushVisualizer() {
@@ -157,6 +171,9 @@ class PassObserver : public ValueObject {
 
   void EndPass(const char* pass_name, bool pass_change) {
     // Pause timer first, then dump graph.
+    if (pass_timing_stats_ != nullptr) {
+      pass_times_.emplace_back(pass_name, NanoTime() - pass_start_ns_);
+    }
     if (timing_logger_enabled_) {
       timing_logger_.EndTiming();
     }
@@ -206,6 +223,10 @@ class PassObserver : public ValueObject {
   bool timing_logger_enabled_;
   TimingLogger timing_logger_;
 
+  PassTimingStats* const pass_timing_stats_;
+  PassTimingStats::PassTimes pass_times_;
+  uint64_t pass_start_ns_;
+
   DisassemblyInformation disasm_info_;
 
   std::ostringstream visualizer_oss_;
@@ -376,11 +397,17 @@ class OptimizingCompiler final : public Compiler {
 
   std::vector<uint8_t> GenerateJitDebugInfo(const debug::MethodDebugInfo& method_debug_info);
 
+  // Return a generator for the debug info of `method_debug_info` if it should be
+  // generated lazily (see `JitOptions::LazyMiniDebugInfo()`), or null otherwise.
+  JitDebugInfoGenerator MakeLazyJitDebugInfo(const debug::MethodDebugInfo& method_debug_info);
+
   // This must be called before any other function that dumps data to the cfg
   void DumpInstructionSetFeaturesToCfg() const;
 
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
 
+  std::unique_ptr<PassTimingStats> pass_timing_stats_;
+
   std::unique_ptr<std::ostream> visualizer_output_;
 
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompiler);
@@ -402,12 +429,18 @@ OptimizingCompiler::OptimizingCompiler(const CompilerOptions& compiler_options,
   if (compiler_options.GetDumpStats()) {
     compilation_stats_.reset(new OptimizingCompilerStats());
   }
+  if (compiler_options.GetNumSlowestMethodsToDump() != 0u) {
+    pass_timing_stats_.reset(new PassTimingStats(compiler_options.GetNumSlowestMethodsToDump()));
+  }
 }
 
 OptimizingCompiler::~OptimizingCompiler() {
   if (compilation_stats_.get() != nullptr) {
     compilation_stats_->Log();
   }
+  if (pass_timing_stats_ != nullptr) {
+    LOG(INFO) << Dumpable<PassTimingStats>(*pass_timing_stats_);
+  }
 }
 
 void OptimizingCompiler::DumpInstructionSetFeaturesToCfg() const {
@@ -538,7 +571,8 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
       OptimizationDef riscv64_optimizations[] = {
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
-          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64)
+          OptDef(OptimizationPass::kCriticalNativeAbiFixupRiscv64),
+          OptDef(OptimizationPass::kScheduling)
       };
       return RunOptimizations(graph,
                               codegen,
@@ -569,6 +603,9 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
           OptDef(OptimizationPass::kInstructionSimplifierX86_64),
           OptDef(OptimizationPass::kSideEffectsAnalysis),
           OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+          // Schedule before the memory operand generation, which relies on the
+          // relative position of the instructions it merges.
+          OptDef(OptimizationPass::kScheduling),
           OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       return RunOptimizations(graph,
@@ -613,12 +650,42 @@ static void AllocateRegisters(HGraph* graph,
   }
 }
 
+// Record the arena memory used so far for compiling the method of `graph`. The arena
+// stack keeps the arenas it used until the end of the compilation, so this includes
+// the peak memory of passes which have already released their allocator.
+static void MaybeRecordPeakArenaBytes(OptimizingCompilerStats* stats,
+                                      MethodCompilationStat stat,
+                                      HGraph* graph) {
+  if (stats != nullptr) {
+    size_t bytes =
+        graph->GetAllocator()->BytesUsed() + graph->GetArenaStack()->ApproximatePeakBytes();
+    stats->RecordPeakStat(stat, dchecked_integral_cast<uint32_t>(bytes));
+  }
+}
+
 // Strip pass name suffix to get optimization name.
 static std::string ConvertPassNameToOptimizationName(const std::string& pass_name) {
   size_t pos = pass_name.find(kPassNameSeparator);
   return pos == std::string::npos ? pass_name : pass_name.substr(0, pos);
 }
 
+// Returns whether the method should be compiled for size rather than speed. With the space
+// filters, only the methods that the profile marks as hot are compiled for speed.
+static bool ShouldOptimizeForSize(const CompilerOptions& compiler_options,
+                                  const DexCompilationUnit& dex_compilation_unit) {
+  CompilerFilter::Filter filter = compiler_options.GetCompilerFilter();
+  if (filter != CompilerFilter::kSpace && filter != CompilerFilter::kSpaceProfile) {
+    return false;
+  }
+  const ProfileCompilationInfo* profile = compiler_options.GetProfileCompilationInfo();
+  if (profile == nullptr) {
+    return true;
+  }
+  ProfileCompilationInfo::MethodHotness hotness = profile->GetMethodHotness(MethodReference(
+      dex_compilation_unit.GetDexFile(), dex_compilation_unit.GetDexMethodIndex()));
+  return !hotness.IsHot();
+}
+
 void OptimizingCompiler::RunOptimizations(HGraph* graph,
                                           CodeGenerator* codegen,
                                           const DexCompilationUnit& dex_compilation_unit,
@@ -643,6 +710,39 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     return;
   }
 
+  if (GetCompilerOptions().IsLargeGraph(graph->GetCurrentInstructionId())) {
+    // Very large methods (e.g. generated parsers) would otherwise dominate the compilation
+    // time. Skip inlining, which would grow them further, and the global optimizations
+    // whose cost grows faster than the size of the graph, but keep the simplifications
+    // the code generator relies on.
+    VLOG(compiler) << "Running reduced optimizations for large graph "
+                   << graph->PrettyMethod() << ": "
+                   << graph->GetCurrentInstructionId() << " instructions";
+    MaybeRecordStat(compilation_stats_.get(),
+                    MethodCompilationStat::kCompiledWithReducedOptimizations);
+    OptimizationDef reduced_optimizations[] = {
+        OptDef(OptimizationPass::kConstantFolding),
+        OptDef(OptimizationPass::kInstructionSimplifier),
+        OptDef(OptimizationPass::kDeadCodeElimination,
+               "dead_code_elimination$initial"),
+        OptDef(OptimizationPass::kAggressiveInstructionSimplifier,
+               "instruction_simplifier$before_codegen"),
+        OptDef(OptimizationPass::kDeadCodeElimination,
+               "dead_code_elimination$before_codegen"),
+        OptDef(OptimizationPass::kConstructorFenceRedundancyElimination)
+    };
+    RunOptimizations(graph,
+                     codegen,
+                     dex_compilation_unit,
+                     pass_observer,
+                     reduced_optimizations);
+
+    // Only run the architecture specific passes the code generator needs; instruction
+    // scheduling and GVN are as expensive as the global passes skipped above.
+    RunRequiredPasses(graph, codegen, dex_compilation_unit, pass_observer);
+    return;
+  }
+
   OptimizationDef optimizations[] = {
       // Initial optimizations.
       OptDef(OptimizationPass::kConstantFolding),
@@ -707,11 +807,29 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
       // complicated sinking logic to split a fence with many inputs.
       OptDef(OptimizationPass::kConstructorFenceRedundancyElimination)
   };
-  RunOptimizations(graph,
-                   codegen,
-                   dex_compilation_unit,
-                   pass_observer,
-                   optimizations);
+  if (ShouldOptimizeForSize(GetCompilerOptions(), dex_compilation_unit)) {
+    // Loop optimizations unroll, peel and vectorize loops, trading code size for speed.
+    // Only spend that size on methods the profile says are hot.
+    MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kCompiledOptimizedForSize);
+    std::vector<OptimizationDef> size_optimizations;
+    for (const OptimizationDef& definition : optimizations) {
+      if (definition.pass != OptimizationPass::kLoopOptimization) {
+        size_optimizations.push_back(definition);
+      }
+    }
+    RunOptimizations(graph,
+                     codegen,
+                     dex_compilation_unit,
+                     pass_observer,
+                     size_optimizations.data(),
+                     size_optimizations.size());
+  } else {
+    RunOptimizations(graph,
+                     codegen,
+                     dex_compilation_unit,
+                     pass_observer,
+                     optimizations);
+  }
 
   RunArchOptimizations(graph, codegen, dex_compilation_unit, pass_observer);
 }
@@ -820,6 +938,14 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     dead_reference_safe = false;
   }
 
+  // Methods selected for entry / exit hooks need JIT code that calls the hooks, which is
+  // generated for debuggable graphs.
+  bool debuggable = compiler_options.GetDebuggable();
+  if (!debuggable && compiler_options.IsJitCompiler()) {
+    ScopedObjectAccess soa(Thread::Current());
+    debuggable = Runtime::Current()->GetInstrumentation()->HasEntryExitHooksForMethod(method);
+  }
+
   HGraph* graph = new (allocator) HGraph(
       allocator,
       arena_stack,
@@ -829,7 +955,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
       compiler_options.GetInstructionSet(),
       kInvalidInvokeType,
       dead_reference_safe,
-      compiler_options.GetDebuggable(),
+      debuggable,
       compilation_kind);
 
   if (method != nullptr) {
@@ -855,7 +981,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
-                             compiler_options);
+                             compiler_options,
+                             pass_timing_stats_.get());
 
   {
     VLOG(compiler) << "Building " << pass_observer.GetMethodName();
@@ -914,6 +1041,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     }
   }
 
+  MaybeRecordPeakArenaBytes(
+      compilation_stats_.get(), MethodCompilationStat::kPeakArenaBytesBuilder, graph);
+
   if (compilation_kind == CompilationKind::kBaseline && compiler_options.ProfileBranches()) {
     graph->SetUsefulOptimizing();
     // Branch profiling currently doesn't support running optimizations.
@@ -923,6 +1053,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     PassScope scope(WriteBarrierElimination::kWBEPassName, &pass_observer);
     WriteBarrierElimination(graph, compilation_stats_.get()).Run();
   }
+  MaybeRecordPeakArenaBytes(
+      compilation_stats_.get(), MethodCompilationStat::kPeakArenaBytesOptimizations, graph);
 
   // If we are compiling baseline and we haven't created a profiling info for
   // this method already, do it now.
@@ -949,6 +1081,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                     &pass_observer,
                     regalloc_strategy,
                     compilation_stats_.get());
+  MaybeRecordPeakArenaBytes(
+      compilation_stats_.get(), MethodCompilationStat::kPeakArenaBytesRegisterAllocation, graph);
 
   if (UNLIKELY(codegen->GetFrameSize() > codegen->GetMaximumFrameSize())) {
     SCOPED_TRACE << "Not compiling because of stack frame too large";
@@ -961,6 +1095,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
 
   codegen->Compile();
   pass_observer.DumpDisassembly();
+  MaybeRecordPeakArenaBytes(
+      compilation_stats_.get(), MethodCompilationStat::kPeakArenaBytesCodeGeneration, graph);
 
   MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kCompiledBytecode);
   return codegen.release();
@@ -1015,7 +1151,8 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
   PassObserver pass_observer(graph,
                              codegen.get(),
                              visualizer_output_.get(),
-                             compiler_options);
+                             compiler_options,
+                             pass_timing_stats_.get());
 
   {
     VLOG(compiler) << "Building intrinsic graph " << pass_observer.GetMethodName();
@@ -1324,6 +1461,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                              stack_map.size(),
                              /* number_of_roots= */ 0,
                              method,
+                             compilation_kind,
                              /*out*/ &reserved_code,
                              /*out*/ &reserved_data)) {
       MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kJitOutOfMemoryForCommit);
@@ -1333,6 +1471,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
 
     // Add debug info after we know the code location but before we update entry-point.
     std::vector<uint8_t> debug_info;
+    JitDebugInfoGenerator lazy_debug_info;
     if (compiler_options.GenerateAnyDebugInfo()) {
       debug::MethodDebugInfo info = {};
       // Simpleperf relies on art_jni_trampoline to detect jni methods.
@@ -1352,7 +1491,10 @@ bool OptimizingCompiler::JitCompile(Thread* self,
       info.frame_size_in_bytes = jni_compiled_method.GetFrameSize();
       info.code_info = nullptr;
       info.cfi = jni_compiled_method.GetCfi();
-      debug_info = GenerateJitDebugInfo(info);
+      lazy_debug_info = MakeLazyJitDebugInfo(info);
+      if (lazy_debug_info == nullptr) {
+        debug_info = GenerateJitDebugInfo(info);
+      }
     }
 
     if (!code_cache->Commit(self,
@@ -1364,6 +1506,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                             roots,
                             ArrayRef<const uint8_t>(stack_map),
                             debug_info,
+                            std::move(lazy_debug_info),
                             /* is_full_debug_info= */ compiler_options.GetGenerateDebugInfo(),
                             compilation_kind,
                             cha_single_implementation_list)) {
@@ -1420,6 +1563,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                            stack_map.size(),
                            /*number_of_roots=*/codegen->GetNumberOfJitRoots(),
                            method,
+                           compilation_kind,
                            /*out*/ &reserved_code,
                            /*out*/ &reserved_data)) {
     MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kJitOutOfMemoryForCommit);
@@ -1441,6 +1585,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
 
   // Add debug info after we know the code location but before we update entry-point.
   std::vector<uint8_t> debug_info;
+  JitDebugInfoGenerator lazy_debug_info;
   if (compiler_options.GenerateAnyDebugInfo()) {
     debug::MethodDebugInfo info = {};
     DCHECK(info.custom_name.empty());
@@ -1459,7 +1604,10 @@ bool OptimizingCompiler::JitCompile(Thread* self,
     info.frame_size_in_bytes = codegen->GetFrameSize();
     info.code_info = stack_map.size() == 0 ? nullptr : stack_map.data();
     info.cfi = ArrayRef<const uint8_t>(*codegen->GetAssembler()->cfi().data());
-    debug_info = GenerateJitDebugInfo(info);
+    lazy_debug_info = MakeLazyJitDebugInfo(info);
+    if (lazy_debug_info == nullptr) {
+      debug_info = GenerateJitDebugInfo(info);
+    }
   }
 
   if (compilation_kind == CompilationKind::kBaseline &&
@@ -1476,6 +1624,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                           roots,
                           ArrayRef<const uint8_t>(stack_map),
                           debug_info,
+                          std::move(lazy_debug_info),
                           /* is_full_debug_info= */ compiler_options.GetGenerateDebugInfo(),
                           compilation_kind,
                           codegen->GetGraph()->GetCHASingleImplementationList())) {
@@ -1520,4 +1669,25 @@ std::vector<uint8_t> OptimizingCompiler::GenerateJitDebugInfo(const debug::Metho
   return std::vector<uint8_t>();
 }
 
+JitDebugInfoGenerator OptimizingCompiler::MakeLazyJitDebugInfo(
+    const debug::MethodDebugInfo& info) {
+  // Full debug info cannot be packed, and the zygote shares its debug info with the apps.
+  Runtime* runtime = Runtime::Current();
+  if (GetCompilerOptions().GetGenerateDebugInfo() ||
+      !runtime->GetJit()->LazyMiniDebugInfo() ||
+      runtime->IsZygote()) {
+    return nullptr;
+  }
+  // The CFI is owned by the assembler, so keep a copy. The stack map is only needed for full
+  // debug info. The rest of the info remains valid while the code is in the code cache, and the
+  // generator is dropped when the code is freed.
+  std::vector<uint8_t> cfi(info.cfi.begin(), info.cfi.end());
+  return [this, info, cfi = std::move(cfi)]() {
+    debug::MethodDebugInfo method_info = info;
+    method_info.code_info = nullptr;
+    method_info.cfi = ArrayRef<const uint8_t>(cfi);
+    return GenerateJitDebugInfo(method_info);
+  };
+}
+
 }  // namespace art
@@ -36,6 +36,8 @@ enum class MethodCompilationStat {
   kCompiledNativeStub,
   kCompiledIntrinsic,
   kCompiledBytecode,
+  kCompiledWithReducedOptimizations,
+  kCompiledOptimizedForSize,
   kCHAInline,
   kInlinedInvoke,
   kInlinedLastInvoke,
@@ -71,6 +73,7 @@ enum class MethodCompilationStat {
   kNotCompiledFrameTooBig,
   kInlinedMonomorphicCall,
   kInlinedPolymorphicCall,
+  kInlinedMegamorphicCall,
   kMonomorphicCall,
   kPolymorphicCall,
   kMegamorphicCall,
@@ -111,6 +114,7 @@ enum class MethodCompilationStat {
   kNotInlinedNotVerified,
   kNotInlinedCodeItem,
   kNotInlinedEndsWithThrow,
+  kNotInlinedColdCallSite,
   kNotInlinedWont,
   kNotInlinedRecursiveBudget,
   kNotInlinedPolymorphicRecursiveBudget,
@@ -136,6 +140,12 @@ enum class MethodCompilationStat {
   kPartialStoreRemoved,
   kPartialAllocationMoved,
   kDevirtualized,
+  // Peak arena memory in bytes used for compiling a single method, reached by the end of
+  // each compilation phase. Unlike the other stats, these record a maximum, not a total.
+  kPeakArenaBytesBuilder,
+  kPeakArenaBytesOptimizations,
+  kPeakArenaBytesRegisterAllocation,
+  kPeakArenaBytesCodeGeneration,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
@@ -153,6 +163,23 @@ class OptimizingCompilerStats {
     compile_stats_[stat_index] += count;
   }
 
+  // Record `value` for `stat` if it is larger than the value recorded so far.
+  void RecordPeakStat(MethodCompilationStat stat, uint32_t value) {
+    DCHECK(IsPeakStat(stat));
+    size_t stat_index = static_cast<size_t>(stat);
+    DCHECK_LT(stat_index, arraysize(compile_stats_));
+    uint32_t old_value = compile_stats_[stat_index].load(std::memory_order_relaxed);
+    while (old_value < value &&
+           !compile_stats_[stat_index].compare_exchange_weak(
+               old_value, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  static bool IsPeakStat(MethodCompilationStat stat) {
+    return stat >= MethodCompilationStat::kPeakArenaBytesBuilder &&
+           stat <= MethodCompilationStat::kPeakArenaBytesCodeGeneration;
+  }
+
   uint32_t GetStat(MethodCompilationStat stat) const {
     size_t stat_index = static_cast<size_t>(stat);
     DCHECK_LT(stat_index, arraysize(compile_stats_));
@@ -193,7 +220,12 @@ class OptimizingCompilerStats {
     for (size_t i = 0; i != arraysize(compile_stats_); ++i) {
       uint32_t count = compile_stats_[i];
       if (count != 0) {
-        other_stats->RecordStat(static_cast<MethodCompilationStat>(i), count);
+        MethodCompilationStat stat = static_cast<MethodCompilationStat>(i);
+        if (IsPeakStat(stat)) {
+          other_stats->RecordPeakStat(stat, count);
+        } else {
+          other_stats->RecordStat(stat, count);
+        }
       }
     }
   }
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pass_timing_stats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include "base/time_utils.h"
+#include "thread-current-inl.h"
+
+namespace art HIDDEN {
+
+PassTimingStats::PassTimingStats(size_t num_slowest_methods)
+    : num_slowest_methods_(num_slowest_methods),
+      lock_("Pass timing stats lock", kGenericBottomLock),
+      num_methods_(0u) {}
+
+void PassTimingStats::RecordMethod(const std::string& method_name, PassTimes&& pass_times) {
+  uint64_t total_ns = 0u;
+  for (const auto& [pass_name, pass_ns] : pass_times) {
+    total_ns += pass_ns;
+  }
+
+  MutexLock mu(Thread::Current(), lock_);
+  ++num_methods_;
+  for (const auto& [pass_name, pass_ns] : pass_times) {
+    pass_total_ns_[pass_name] += pass_ns;
+  }
+  if (num_slowest_methods_ == 0u) {
+    return;
+  }
+  if (slowest_methods_.size() == num_slowest_methods_) {
+    if (slowest_methods_.front().total_ns >= total_ns) {
+      return;
+    }
+    std::pop_heap(slowest_methods_.begin(), slowest_methods_.end(), IsSlower);
+    slowest_methods_.pop_back();
+  }
+  slowest_methods_.push_back({total_ns, method_name, std::move(pass_times)});
+  std::push_heap(slowest_methods_.begin(), slowest_methods_.end(), IsSlower);
+}
+
+void PassTimingStats::Dump(std::ostream& os) const {
+  MutexLock mu(Thread::Current(), lock_);
+  std::vector<std::pair<std::string, uint64_t>> passes(pass_total_ns_.begin(),
+                                                       pass_total_ns_.end());
+  std::sort(passes.begin(), passes.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second > rhs.second;
+  });
+  uint64_t total_ns = 0u;
+  for (const auto& [pass_name, pass_ns] : passes) {
+    total_ns += pass_ns;
+  }
+  os << "Pass timings over " << num_methods_ << " methods (" << PrettyDuration(total_ns)
+     << "):\n";
+  for (const auto& [pass_name, pass_ns] : passes) {
+    os << "  " << pass_name << ": " << PrettyDuration(pass_ns) << " (" << std::fixed
+       << std::setprecision(2) << (total_ns != 0u ? pass_ns * 100.0 / total_ns : 0.0)
+       << "%)\n";
+  }
+
+  std::vector<MethodTimes> methods(slowest_methods_);
+  std::sort(methods.begin(), methods.end(), IsSlower);
+  os << "Slowest " << methods.size() << " methods:\n";
+  for (const MethodTimes& method : methods) {
+    os << "  " << method.method_name << ": " << PrettyDuration(method.total_ns) << "\n";
+    for (const auto& [pass_name, pass_ns] : method.pass_times) {
+      os << "    " << pass_name << ": " << PrettyDuration(pass_ns) << "\n";
+    }
+  }
+}
+
+}  // namespace art
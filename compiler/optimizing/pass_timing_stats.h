@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_PASS_TIMING_STATS_H_
+#define ART_COMPILER_OPTIMIZING_PASS_TIMING_STATS_H_
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art HIDDEN {
+
+// Compile time breakdown of a whole compilation, for `--dump-slowest-methods`.
+//
+// Accumulates the time spent in each optimizing compiler pass over all methods, and keeps the
+// `num_slowest_methods` methods that took the longest to go through the passes, together with
+// the time of each of their passes. Unlike `--dump-pass-timings`, which logs every method, this
+// makes it practical to find compile time outliers in large apps.
+class PassTimingStats {
+ public:
+  // The name and duration in nanoseconds of each pass run on a method, in the order they ran.
+  using PassTimes = std::vector<std::pair<std::string, uint64_t>>;
+
+  explicit PassTimingStats(size_t num_slowest_methods);
+
+  // Record the passes run on one method. Thread-safe.
+  void RecordMethod(const std::string& method_name, PassTimes&& pass_times) REQUIRES(!lock_);
+
+  void Dump(std::ostream& os) const REQUIRES(!lock_);
+
+ private:
+  struct MethodTimes {
+    uint64_t total_ns;
+    std::string method_name;
+    PassTimes pass_times;
+  };
+
+  static bool IsSlower(const MethodTimes& lhs, const MethodTimes& rhs) {
+    return lhs.total_ns > rhs.total_ns;
+  }
+
+  const size_t num_slowest_methods_;
+
+  mutable Mutex lock_;
+  size_t num_methods_ GUARDED_BY(lock_);
+  std::map<std::string, uint64_t> pass_total_ns_ GUARDED_BY(lock_);
+  // A heap with the fastest of the slowest methods at the front.
+  std::vector<MethodTimes> slowest_methods_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(PassTimingStats);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_PASS_TIMING_STATS_H_
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pass_timing_stats.h"
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+namespace art HIDDEN {
+
+TEST(PassTimingStatsTest, KeepsSlowestMethods) {
+  PassTimingStats stats(/*num_slowest_methods=*/ 2u);
+  stats.RecordMethod("void A.fast()", {{"builder", 1000u}, {"inliner", 1000u}});
+  stats.RecordMethod("void A.slow()", {{"builder", 5000u}, {"inliner", 90000u}});
+  stats.RecordMethod("void A.medium()", {{"builder", 3000u}, {"inliner", 7000u}});
+
+  std::ostringstream oss;
+  stats.Dump(oss);
+  std::string dump = oss.str();
+  EXPECT_NE(std::string::npos, dump.find("Pass timings over 3 methods")) << dump;
+  // Passes are listed by decreasing total time, and methods by decreasing compile time.
+  size_t inliner = dump.find("  inliner: ");
+  size_t builder = dump.find("  builder: ");
+  ASSERT_NE(std::string::npos, inliner) << dump;
+  EXPECT_LT(inliner, builder) << dump;
+  size_t slow = dump.find("void A.slow()");
+  size_t medium = dump.find("void A.medium()");
+  ASSERT_NE(std::string::npos, slow) << dump;
+  EXPECT_LT(slow, medium) << dump;
+  EXPECT_EQ(std::string::npos, dump.find("void A.fast()")) << dump;
+}
+
+}  // namespace art
@@ -0,0 +1,1112 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "register_allocator_graph_color.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/bit_utils.h"
+#include "base/enums.h"
+#include "code_generator.h"
+#include "register_allocation_resolver.h"
+#include "ssa_liveness_analysis.h"
+
+namespace art HIDDEN {
+
+static constexpr size_t kMaxLifetimePosition = -1;
+static constexpr size_t kDefaultNumberOfSpillSlots = 4;
+
+// The cost of a register use is multiplied by this factor for each loop the use is in.
+static constexpr float kLoopSpillWeightMultiplier = 10.0f;
+
+// As in the linear scan allocator, we implement register pairs as (reg, reg + 1).
+// Note that this is a requirement for double registers on ARM, since we
+// allocate SRegister.
+static int GetHighForLowRegister(int reg) { return reg + 1; }
+static bool IsLowRegister(int reg) { return (reg & 1) == 0; }
+
+// A node of the interference graph. It stands for a live interval that does not
+// have a register yet, together with its high interval if it needs a register pair.
+class InterferenceNode : public ArenaObject<kArenaAllocRegisterAllocator> {
+ public:
+  InterferenceNode(LiveInterval* interval, size_t id, ScopedArenaAllocator* allocator)
+      : interval_(interval),
+        id_(id),
+        adjacent_nodes_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        blocked_registers_(0u),
+        number_of_colors_(0u),
+        degree_(0u),
+        spill_weight_(0.0f),
+        pruned_(false) {}
+
+  LiveInterval* GetInterval() const { return interval_; }
+  size_t GetId() const { return id_; }
+  bool IsPair() const { return interval_->HasHighInterval(); }
+
+  void AddInterference(InterferenceNode* other) {
+    adjacent_nodes_.push_back(other);
+    degree_ += EdgeWeightWith(other);
+  }
+
+  const ScopedArenaVector<InterferenceNode*>& GetAdjacentNodes() const { return adjacent_nodes_; }
+
+  // The number of registers (or aligned register pairs) that `other` can take away
+  // from this node. A pair can take two single registers, but only one pair.
+  size_t EdgeWeightWith(const InterferenceNode* other) const {
+    return (!IsPair() && other->IsPair()) ? 2u : 1u;
+  }
+
+  // Registers this node cannot get, because of fixed and pre-colored intervals.
+  uint32_t GetBlockedRegisters() const { return blocked_registers_; }
+  void SetBlockedRegisters(uint32_t blocked_registers, size_t number_of_registers) {
+    blocked_registers_ = blocked_registers;
+    uint32_t available = ~blocked_registers & MaxInt<uint32_t>(number_of_registers);
+    if (IsPair()) {
+      // Only count the pairs with both registers available.
+      available &= (available >> 1) & 0x55555555u;
+    }
+    number_of_colors_ = POPCOUNT(available);
+  }
+
+  // A node with fewer neighbors than colors can always be colored, whatever
+  // registers its neighbors get.
+  bool IsLowDegree() const { return degree_ < number_of_colors_; }
+
+  void Prune() {
+    DCHECK(!pruned_);
+    pruned_ = true;
+  }
+  bool IsPruned() const { return pruned_; }
+  void RemoveInterference(InterferenceNode* other) {
+    DCHECK_GE(degree_, EdgeWeightWith(other));
+    degree_ -= EdgeWeightWith(other);
+  }
+
+  float GetSpillWeight() const { return spill_weight_; }
+  void SetSpillWeight(float spill_weight) { spill_weight_ = spill_weight; }
+
+ private:
+  LiveInterval* const interval_;
+  const size_t id_;
+  ScopedArenaVector<InterferenceNode*> adjacent_nodes_;
+  uint32_t blocked_registers_;
+  size_t number_of_colors_;
+  size_t degree_;
+  float spill_weight_;
+  bool pruned_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterferenceNode);
+};
+
+RegisterAllocatorGraphColor::RegisterAllocatorGraphColor(ScopedArenaAllocator* allocator,
+                                                         CodeGenerator* codegen,
+                                                         const SsaLivenessAnalysis& liveness)
+      : RegisterAllocator(allocator, codegen, liveness),
+        core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        physical_core_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        physical_fp_register_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        block_registers_for_call_interval_(
+            LiveInterval::MakeFixedInterval(allocator, kNoRegister, DataType::Type::kVoid)),
+        block_registers_special_interval_(
+            LiveInterval::MakeFixedInterval(allocator, kNoRegister, DataType::Type::kVoid)),
+        temp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        int_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        long_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        float_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        double_spill_slots_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        catch_phi_spill_slots_(0),
+        safepoints_(allocator->Adapter(kArenaAllocRegisterAllocator)),
+        blocked_core_registers_(codegen->GetBlockedCoreRegisters()),
+        blocked_fp_registers_(codegen->GetBlockedFloatingPointRegisters()),
+        reserved_out_slots_(0) {
+  temp_intervals_.reserve(4);
+  int_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  long_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  float_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+  double_spill_slots_.reserve(kDefaultNumberOfSpillSlots);
+
+  codegen->SetupBlockedRegisters();
+  physical_core_register_intervals_.resize(codegen->GetNumberOfCoreRegisters(), nullptr);
+  physical_fp_register_intervals_.resize(codegen->GetNumberOfFloatingPointRegisters(), nullptr);
+  // Always reserve for the current method and the graph's max out registers.
+  // ArtMethod* takes 2 vregs for 64 bits.
+  size_t ptr_size = static_cast<size_t>(InstructionSetPointerSize(codegen->GetInstructionSet()));
+  reserved_out_slots_ = ptr_size / kVRegSize + codegen->GetGraph()->GetMaximumNumberOfOutVRegs();
+}
+
+RegisterAllocatorGraphColor::~RegisterAllocatorGraphColor() {}
+
+void RegisterAllocatorGraphColor::AllocateRegisters() {
+  ProcessInstructions();
+  ColorIntervals(RegisterType::kCoreRegister);
+  ColorIntervals(RegisterType::kFpRegister);
+  AllocateSpillSlots();
+
+  RegisterAllocationResolver(codegen_, liveness_)
+      .Resolve(ArrayRef<HInstruction* const>(safepoints_),
+               reserved_out_slots_,
+               int_spill_slots_.size(),
+               long_spill_slots_.size(),
+               float_spill_slots_.size(),
+               double_spill_slots_.size(),
+               catch_phi_spill_slots_,
+               ArrayRef<LiveInterval* const>(temp_intervals_));
+
+  if (kIsDebugBuild) {
+    ValidateInternal(RegisterType::kCoreRegister, /* log_fatal_on_failure= */ true);
+    ValidateInternal(RegisterType::kFpRegister, /* log_fatal_on_failure= */ true);
+  }
+}
+
+void RegisterAllocatorGraphColor::ProcessInstructions() {
+  // Iterate post-order, so that safepoints are recorded in the order `AddSafepointsFor()`
+  // expects and catch phi spill slots are allocated in reverse linear order.
+  for (HBasicBlock* block : codegen_->GetGraph()->GetLinearPostOrder()) {
+    for (HBackwardInstructionIterator back_it(block->GetInstructions()); !back_it.Done();
+         back_it.Advance()) {
+      ProcessInstruction(back_it.Current());
+    }
+    for (HInstructionIterator inst_it(block->GetPhis()); !inst_it.Done(); inst_it.Advance()) {
+      ProcessInstruction(inst_it.Current());
+    }
+
+    if (block->IsCatchBlock() ||
+        (block->IsLoopHeader() && block->GetLoopInformation()->IsIrreducible())) {
+      // By blocking all registers at the top of each catch block or irreducible loop, we force
+      // intervals belonging to the live-in set of the catch/header block to be spilled.
+      size_t position = block->GetLifetimeStart();
+      DCHECK_EQ(liveness_.GetInstructionFromPosition(position / 2u), nullptr);
+      block_registers_special_interval_->AddRange(position, position + 1u);
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::ProcessInstruction(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+
+  // Check for early returns.
+  if (locations == nullptr) {
+    return;
+  }
+  if (TryRemoveSuspendCheckEntry(instruction)) {
+    return;
+  }
+
+  bool will_call = locations->WillCall();
+  if (will_call) {
+    // If a call will happen, add the range to a fixed interval that represents all the
+    // caller-save registers blocked at call sites.
+    const size_t position = instruction->GetLifetimePosition();
+    DCHECK_NE(liveness_.GetInstructionFromPosition(position / 2u), nullptr);
+    block_registers_for_call_interval_->AddRange(position, position + 1u);
+  }
+  CheckForTempLiveIntervals(instruction, will_call);
+  CheckForSafepoint(instruction);
+  CheckForFixedInputs(instruction, will_call);
+
+  LiveInterval* current = instruction->GetLiveInterval();
+  if (current == nullptr) {
+    return;
+  }
+
+  if (codegen_->NeedsTwoRegisters(current->GetType())) {
+    current->AddHighInterval();
+  }
+
+  AddSafepointsFor(instruction);
+  current->ResetSearchCache();
+  CheckForFixedOutput(instruction, will_call);
+
+  if (instruction->IsPhi() && instruction->AsPhi()->IsCatchPhi()) {
+    AllocateSpillSlotForCatchPhi(instruction->AsPhi());
+  }
+
+  ScopedArenaVector<LiveInterval*>& intervals =
+      DataType::IsFloatingPointType(instruction->GetType()) ? fp_intervals_ : core_intervals_;
+  if (current->HasSpillSlot() || instruction->IsConstant()) {
+    // The value is available without a register until its first register use.
+    size_t first_register_use = current->FirstRegisterUse();
+    if (first_register_use != kNoLifetime) {
+      intervals.push_back(SplitBetween(current, current->GetStart(), first_register_use - 1));
+    } else {
+      // Nothing to do, we won't allocate a register for this value.
+    }
+  } else {
+    if (current->HasRegister() && current->GetStart() + 1u < current->GetEnd()) {
+      // The instruction only constrains the register at the definition. Split the
+      // interval so that the rest of it is colored like any other interval.
+      Split(current, current->GetStart() + 1u);
+    }
+    intervals.push_back(current);
+  }
+}
+
+bool RegisterAllocatorGraphColor::TryRemoveSuspendCheckEntry(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (instruction->IsSuspendCheckEntry() && !codegen_->NeedsSuspendCheckEntry()) {
+    // We do this here because we do not want the suspend check to artificially
+    // create live registers.
+    DCHECK_EQ(locations->GetTempCount(), 0u);
+    instruction->GetBlock()->RemoveInstruction(instruction);
+    return true;
+  }
+  return false;
+}
+
+void RegisterAllocatorGraphColor::BlockRegister(Location location,
+                                                size_t position,
+                                                bool will_call) {
+  DCHECK(location.IsRegister() || location.IsFpuRegister());
+  int reg = location.reg();
+  if (will_call) {
+    uint32_t registers_blocked_for_call =
+        location.IsRegister() ? core_registers_blocked_for_call_ : fp_registers_blocked_for_call_;
+    if ((registers_blocked_for_call & (1u << reg)) != 0u) {
+      // Register is already marked as blocked by the `block_registers_for_call_interval_`.
+      return;
+    }
+  }
+  LiveInterval* interval = location.IsRegister()
+      ? physical_core_register_intervals_[reg]
+      : physical_fp_register_intervals_[reg];
+  DataType::Type type = location.IsRegister()
+      ? DataType::Type::kInt32
+      : DataType::Type::kFloat32;
+  if (interval == nullptr) {
+    interval = LiveInterval::MakeFixedInterval(allocator_, reg, type);
+    if (location.IsRegister()) {
+      physical_core_register_intervals_[reg] = interval;
+    } else {
+      physical_fp_register_intervals_[reg] = interval;
+    }
+  }
+  DCHECK(interval->GetRegister() == reg);
+  interval->AddRange(position, position + 1u);
+}
+
+void RegisterAllocatorGraphColor::CheckForTempLiveIntervals(HInstruction* instruction,
+                                                            bool will_call) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t position = instruction->GetLifetimePosition();
+
+  // Create synthesized intervals for temporaries.
+  for (size_t i = 0; i < locations->GetTempCount(); ++i) {
+    Location temp = locations->GetTemp(i);
+    if (temp.IsRegister() || temp.IsFpuRegister()) {
+      BlockRegister(temp, position, will_call);
+      // Ensure that an explicit temporary register is marked as being allocated.
+      codegen_->AddAllocatedRegister(temp);
+    } else {
+      DCHECK(temp.IsUnallocated());
+      switch (temp.GetPolicy()) {
+        case Location::kRequiresRegister: {
+          LiveInterval* interval =
+              LiveInterval::MakeTempInterval(allocator_, DataType::Type::kInt32);
+          temp_intervals_.push_back(interval);
+          interval->AddTempUse(instruction, i);
+          core_intervals_.push_back(interval);
+          break;
+        }
+
+        case Location::kRequiresFpuRegister: {
+          LiveInterval* interval =
+              LiveInterval::MakeTempInterval(allocator_, DataType::Type::kFloat64);
+          temp_intervals_.push_back(interval);
+          interval->AddTempUse(instruction, i);
+          if (codegen_->NeedsTwoRegisters(DataType::Type::kFloat64)) {
+            // The high interval is colored together with the low one.
+            interval->AddHighInterval(/* is_temp= */ true);
+            temp_intervals_.push_back(interval->GetHighInterval());
+          }
+          fp_intervals_.push_back(interval);
+          break;
+        }
+
+        default:
+          LOG(FATAL) << "Unexpected policy for temporary location " << temp.GetPolicy();
+      }
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::CheckForSafepoint(HInstruction* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  if (locations->NeedsSafepoint()) {
+    safepoints_.push_back(instruction);
+  }
+}
+
+void RegisterAllocatorGraphColor::CheckForFixedInputs(HInstruction* instruction, bool will_call) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t position = instruction->GetLifetimePosition();
+  for (size_t i = 0; i < locations->GetInputCount(); ++i) {
+    Location input = locations->InAt(i);
+    if (input.IsRegister() || input.IsFpuRegister()) {
+      BlockRegister(input, position, will_call);
+      // Ensure that an explicit input register is marked as being allocated.
+      codegen_->AddAllocatedRegister(input);
+    } else if (input.IsPair()) {
+      BlockRegister(input.ToLow(), position, will_call);
+      BlockRegister(input.ToHigh(), position, will_call);
+      // Ensure that an explicit input register pair is marked as being allocated.
+      codegen_->AddAllocatedRegister(input.ToLow());
+      codegen_->AddAllocatedRegister(input.ToHigh());
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::AddSafepointsFor(HInstruction* instruction) {
+  LiveInterval* current = instruction->GetLiveInterval();
+  for (size_t safepoint_index = safepoints_.size(); safepoint_index > 0; --safepoint_index) {
+    HInstruction* safepoint = safepoints_[safepoint_index - 1u];
+    size_t safepoint_position = SafepointPosition::ComputePosition(safepoint);
+
+    // Test that safepoints are ordered in the optimal way.
+    DCHECK(safepoint_index == safepoints_.size() ||
+           safepoints_[safepoint_index]->GetLifetimePosition() < safepoint_position);
+
+    if (safepoint_position == current->GetStart()) {
+      // The safepoint is for this instruction, so the location of the instruction
+      // does not need to be saved.
+      DCHECK_EQ(safepoint_index, safepoints_.size());
+      DCHECK_EQ(safepoint, instruction);
+      continue;
+    } else if (current->IsDeadAt(safepoint_position)) {
+      break;
+    } else if (!current->Covers(safepoint_position)) {
+      // Hole in the interval.
+      continue;
+    }
+    current->AddSafepoint(safepoint);
+  }
+}
+
+void RegisterAllocatorGraphColor::CheckForFixedOutput(HInstruction* instruction, bool will_call) {
+  LocationSummary* locations = instruction->GetLocations();
+  size_t position = instruction->GetLifetimePosition();
+  LiveInterval* current = instruction->GetLiveInterval();
+  // Some instructions define their output in fixed register/stack slot. We need
+  // to ensure we know these locations before doing register allocation. For a
+  // given register, we create an interval that covers these locations. The register
+  // will be unavailable at these locations when coloring other intervals.
+  Location output = locations->Out();
+  if (output.IsUnallocated() && output.GetPolicy() == Location::kSameAsFirstInput) {
+    Location first = locations->InAt(0);
+    if (first.IsRegister() || first.IsFpuRegister()) {
+      current->SetFrom(position + 1u);
+      current->SetRegister(first.reg());
+    } else if (first.IsPair()) {
+      current->SetFrom(position + 1u);
+      current->SetRegister(first.low());
+      LiveInterval* high = current->GetHighInterval();
+      high->SetRegister(first.high());
+      high->SetFrom(position + 1u);
+    }
+  } else if (output.IsRegister() || output.IsFpuRegister()) {
+    // Shift the interval's start by one to account for the blocked register.
+    current->SetFrom(position + 1u);
+    current->SetRegister(output.reg());
+    BlockRegister(output, position, will_call);
+    // Ensure that an explicit output register is marked as being allocated.
+    codegen_->AddAllocatedRegister(output);
+  } else if (output.IsPair()) {
+    current->SetFrom(position + 1u);
+    current->SetRegister(output.low());
+    LiveInterval* high = current->GetHighInterval();
+    high->SetRegister(output.high());
+    high->SetFrom(position + 1u);
+    BlockRegister(output.ToLow(), position, will_call);
+    BlockRegister(output.ToHigh(), position, will_call);
+    // Ensure that an explicit output register pair is marked as being allocated.
+    codegen_->AddAllocatedRegister(output.ToLow());
+    codegen_->AddAllocatedRegister(output.ToHigh());
+  } else if (output.IsStackSlot() || output.IsDoubleStackSlot()) {
+    current->SetSpillSlot(output.GetStackIndex());
+  } else {
+    DCHECK(output.IsUnallocated() || output.IsConstant());
+  }
+}
+
+// Returns the first position at or after `from` where both intervals are live,
+// or kNoLifetime if there is none.
+static size_t FirstIntersectionAtOrAfter(LiveInterval* first, LiveInterval* second, size_t from) {
+  LiveRange* first_range = first->GetFirstRange();
+  LiveRange* second_range = second->GetFirstRange();
+  while (first_range != nullptr && second_range != nullptr) {
+    size_t start = std::max({first_range->GetStart(), second_range->GetStart(), from});
+    size_t end = std::min(first_range->GetEnd(), second_range->GetEnd());
+    if (start < end) {
+      return start;
+    }
+    if (first_range->GetEnd() < second_range->GetEnd()) {
+      first_range = first_range->GetNext();
+    } else {
+      second_range = second_range->GetNext();
+    }
+  }
+  return kNoLifetime;
+}
+
+// Returns whether `interval`, the first interval of the output of an instruction,
+// can have the same register as `other` even though both are live at the instruction.
+// This is the case when `other` is an input that dies at the instruction and the
+// instruction allows its output to overlap with its inputs, see
+// `LiveInterval::CanUseInputRegister()`.
+static bool CanShareRegisterWithInput(LiveInterval* interval, LiveInterval* other) {
+  HInstruction* defined_by = interval->GetDefinedBy();
+  if (interval->IsSplit() || defined_by == nullptr || other->IsTemp()) {
+    return false;
+  }
+  size_t position = defined_by->GetLifetimePosition();
+  if (interval->GetStart() != position ||
+      defined_by->GetLocations()->OutputCanOverlapWithInputs()) {
+    return false;
+  }
+  HInstruction* other_defined_by = other->GetParent()->GetDefinedBy();
+  for (HInstruction* input : defined_by->GetInputs()) {
+    if (input == other_defined_by) {
+      return FirstIntersectionAtOrAfter(interval, other, position + 1u) == kNoLifetime;
+    }
+  }
+  return false;
+}
+
+static bool Interfere(LiveInterval* first, LiveInterval* second) {
+  return FirstIntersectionAtOrAfter(first, second, /* from= */ 0u) != kNoLifetime &&
+         !CanShareRegisterWithInput(first, second) &&
+         !CanShareRegisterWithInput(second, first);
+}
+
+void RegisterAllocatorGraphColor::ColorIntervals(RegisterType register_type) {
+  const ScopedArenaVector<LiveInterval*>& intervals =
+      (register_type == RegisterType::kCoreRegister) ? core_intervals_ : fp_intervals_;
+  ScopedArenaVector<uint32_t> blocked_at(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  ComputeBlockedRegisters(register_type, intervals, &blocked_at);
+
+  ScopedArenaVector<LiveInterval*> failed(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  while (true) {
+    size_t number_of_nodes = 0u;
+    for (LiveInterval* interval : intervals) {
+      for (LiveInterval* sibling = interval;
+           sibling != nullptr;
+           sibling = sibling->GetNextSibling()) {
+        if (!sibling->HasRegister()) {
+          ++number_of_nodes;
+        }
+      }
+    }
+    // Splitting intervals allocates from the allocator of the live intervals, which we
+    // cannot do while the allocator of a coloring attempt is alive. Reserve the space
+    // for the intervals to split up front, and split them once the attempt is over.
+    failed.clear();
+    failed.reserve(number_of_nodes);
+    {
+      ScopedArenaAllocator attempt_allocator(allocator_->GetArenaStack());
+      ScopedArenaVector<InterferenceNode*> nodes(
+          attempt_allocator.Adapter(kArenaAllocRegisterAllocator));
+      nodes.reserve(number_of_nodes);
+      BuildInterferenceGraph(register_type, intervals, blocked_at, &attempt_allocator, &nodes);
+      ScopedArenaVector<InterferenceNode*> stack(
+          attempt_allocator.Adapter(kArenaAllocRegisterAllocator));
+      stack.reserve(nodes.size());
+      PruneInterferenceGraph(nodes, &attempt_allocator, &stack);
+      ColorInterferenceGraph(register_type, nodes, stack, &failed);
+    }
+    if (failed.empty()) {
+      break;
+    }
+
+    // The interference graph is too dense to color. Make it sparser by splitting the
+    // intervals that did not get a register, and try again.
+    bool split = false;
+    for (LiveInterval* interval : failed) {
+      split |= SplitAtRegisterUses(interval);
+    }
+    if (!split) {
+      // This situation would loop forever, so we make it a non-debug CHECK.
+      LiveInterval* interval = failed.front();
+      HInstruction* at = liveness_.GetInstructionFromPosition(interval->GetStart() / 2u);
+      CHECK(false) << "There is not enough registers available at " << interval->GetStart()
+          << " " << (at == nullptr ? "" : at->DebugName());
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::ComputeBlockedRegisters(
+    RegisterType register_type,
+    const ScopedArenaVector<LiveInterval*>& intervals,
+    ScopedArenaVector<uint32_t>* blocked_at) const {
+  blocked_at->assign(liveness_.GetMaxLifetimePosition() + 1u, 0u);
+  auto block = [blocked_at](LiveInterval* interval, uint32_t mask) {
+    for (LiveRange* range = interval->GetFirstRange(); range != nullptr; range = range->GetNext()) {
+      DCHECK_LE(range->GetEnd(), blocked_at->size());
+      for (size_t position = range->GetStart(); position != range->GetEnd(); ++position) {
+        (*blocked_at)[position] |= mask;
+      }
+    }
+  };
+
+  for (LiveInterval* block_registers_interval : { block_registers_for_call_interval_,
+                                                  block_registers_special_interval_ }) {
+    if (block_registers_interval->GetFirstRange() != nullptr) {
+      block(block_registers_interval, GetRegisterMask(block_registers_interval, register_type));
+    }
+  }
+  const ScopedArenaVector<LiveInterval*>& physical_register_intervals =
+      (register_type == RegisterType::kCoreRegister)
+          ? physical_core_register_intervals_
+          : physical_fp_register_intervals_;
+  for (LiveInterval* fixed : physical_register_intervals) {
+    if (fixed != nullptr) {
+      block(fixed, 1u << fixed->GetRegister());
+    }
+  }
+  // Intervals that already have a register are the ones the instruction defining
+  // them pre-colored. They keep their register, other intervals work around them.
+  for (LiveInterval* interval : intervals) {
+    for (LiveInterval* sibling = interval;
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (sibling->HasRegister()) {
+        uint32_t mask = 1u << sibling->GetRegister();
+        if (sibling->HasHighInterval()) {
+          mask |= 1u << sibling->GetHighInterval()->GetRegister();
+        }
+        block(sibling, mask);
+      }
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::BuildInterferenceGraph(
+    RegisterType register_type,
+    const ScopedArenaVector<LiveInterval*>& intervals,
+    const ScopedArenaVector<uint32_t>& blocked_at,
+    ScopedArenaAllocator* allocator,
+    ScopedArenaVector<InterferenceNode*>* nodes) const {
+  size_t number_of_registers =
+      (register_type == RegisterType::kCoreRegister) ? num_core_registers_ : num_fp_registers_;
+  const bool* blocked_registers = (register_type == RegisterType::kCoreRegister)
+      ? blocked_core_registers_
+      : blocked_fp_registers_;
+  uint32_t blocked_by_codegen = 0u;
+  for (size_t reg = 0; reg != number_of_registers; ++reg) {
+    if (blocked_registers[reg]) {
+      blocked_by_codegen |= 1u << reg;
+    }
+  }
+
+  for (LiveInterval* interval : intervals) {
+    for (LiveInterval* sibling = interval;
+         sibling != nullptr;
+         sibling = sibling->GetNextSibling()) {
+      if (sibling->HasRegister()) {
+        continue;
+      }
+      InterferenceNode* node = new (allocator) InterferenceNode(sibling, nodes->size(), allocator);
+      uint32_t blocked = blocked_by_codegen;
+      for (LiveRange* range = sibling->GetFirstRange();
+           range != nullptr;
+           range = range->GetNext()) {
+        for (size_t position = range->GetStart(); position != range->GetEnd(); ++position) {
+          blocked |= blocked_at[position];
+        }
+      }
+      node->SetBlockedRegisters(blocked, number_of_registers);
+      node->SetSpillWeight(ComputeSpillWeight(sibling));
+      nodes->push_back(node);
+    }
+  }
+
+  std::sort(nodes->begin(), nodes->end(), [](InterferenceNode* lhs, InterferenceNode* rhs) {
+    size_t lhs_start = lhs->GetInterval()->GetStart();
+    size_t rhs_start = rhs->GetInterval()->GetStart();
+    return (lhs_start != rhs_start) ? (lhs_start < rhs_start) : (lhs->GetId() < rhs->GetId());
+  });
+
+  // Sweep the nodes in order of start position, keeping the ones that are not dead yet.
+  ScopedArenaVector<InterferenceNode*> active(allocator->Adapter(kArenaAllocRegisterAllocator));
+  for (InterferenceNode* node : *nodes) {
+    LiveInterval* interval = node->GetInterval();
+    size_t start = interval->GetStart();
+    active.erase(std::remove_if(active.begin(),
+                                active.end(),
+                                [start](InterferenceNode* other) {
+                                  return other->GetInterval()->IsDeadAt(start);
+                                }),
+                 active.end());
+    for (InterferenceNode* other : active) {
+      if (Interfere(interval, other->GetInterval())) {
+        node->AddInterference(other);
+        other->AddInterference(node);
+      }
+    }
+    active.push_back(node);
+  }
+}
+
+void RegisterAllocatorGraphColor::PruneInterferenceGraph(
+    const ScopedArenaVector<InterferenceNode*>& nodes,
+    ScopedArenaAllocator* allocator,
+    ScopedArenaVector<InterferenceNode*>* stack) const {
+  ScopedArenaVector<InterferenceNode*> simplify_worklist(
+      allocator->Adapter(kArenaAllocRegisterAllocator));
+  ScopedArenaVector<InterferenceNode*> spill_worklist(
+      allocator->Adapter(kArenaAllocRegisterAllocator));
+  for (InterferenceNode* node : nodes) {
+    if (node->IsLowDegree()) {
+      simplify_worklist.push_back(node);
+    } else {
+      spill_worklist.push_back(node);
+    }
+  }
+  std::sort(spill_worklist.begin(),
+            spill_worklist.end(),
+            [](InterferenceNode* lhs, InterferenceNode* rhs) {
+              return (lhs->GetSpillWeight() != rhs->GetSpillWeight())
+                  ? (lhs->GetSpillWeight() < rhs->GetSpillWeight())
+                  : (lhs->GetId() < rhs->GetId());
+            });
+
+  size_t spill_index = 0u;
+  while (stack->size() != nodes.size()) {
+    InterferenceNode* node;
+    if (!simplify_worklist.empty()) {
+      node = simplify_worklist.back();
+      simplify_worklist.pop_back();
+    } else {
+      // All the remaining nodes have a high degree. Optimistically prune the one that
+      // is the cheapest to spill: it may still get a register if its neighbors end up
+      // sharing registers.
+      DCHECK_LT(spill_index, spill_worklist.size());
+      node = spill_worklist[spill_index];
+      ++spill_index;
+    }
+    if (node->IsPruned()) {
+      // A node from the spill worklist that got a low degree and was pruned already.
+      continue;
+    }
+    node->Prune();
+    stack->push_back(node);
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      if (!adjacent->IsPruned()) {
+        bool was_low_degree = adjacent->IsLowDegree();
+        adjacent->RemoveInterference(node);
+        if (!was_low_degree && adjacent->IsLowDegree()) {
+          simplify_worklist.push_back(adjacent);
+        }
+      }
+    }
+  }
+}
+
+void RegisterAllocatorGraphColor::ColorInterferenceGraph(
+    RegisterType register_type,
+    const ScopedArenaVector<InterferenceNode*>& nodes,
+    const ScopedArenaVector<InterferenceNode*>& stack,
+    ScopedArenaVector<LiveInterval*>* failed) {
+  DCHECK(failed->empty());
+  for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+    InterferenceNode* node = *it;
+    LiveInterval* interval = node->GetInterval();
+    uint32_t conflicts = node->GetBlockedRegisters();
+    for (InterferenceNode* adjacent : node->GetAdjacentNodes()) {
+      LiveInterval* other = adjacent->GetInterval();
+      if (other->HasRegister()) {
+        conflicts |= 1u << other->GetRegister();
+        if (other->HasHighInterval()) {
+          conflicts |= 1u << other->GetHighInterval()->GetRegister();
+        }
+      }
+    }
+
+    int reg = FindRegister(node, conflicts, register_type);
+    if (reg != kNoRegister) {
+      interval->SetRegister(reg);
+      if (interval->HasHighInterval()) {
+        interval->GetHighInterval()->SetRegister(GetHighForLowRegister(reg));
+      }
+    } else if (interval->RequiresRegister()) {
+      DCHECK_LT(failed->size(), failed->capacity());
+      failed->push_back(interval);
+      // We continue coloring, because there may be additional intervals that cannot
+      // be colored, and that we should split.
+    } else {
+      // The interval will live in its spill slot.
+    }
+  }
+
+  if (!failed->empty()) {
+    // Reset the registers, the next attempt will color a different graph.
+    for (InterferenceNode* node : nodes) {
+      LiveInterval* interval = node->GetInterval();
+      interval->ClearRegister();
+      if (interval->HasHighInterval()) {
+        interval->GetHighInterval()->ClearRegister();
+      }
+    }
+    return;
+  }
+
+  // Tell the code generator which registers were allocated.
+  for (InterferenceNode* node : nodes) {
+    LiveInterval* interval = node->GetInterval();
+    if (!interval->HasRegister()) {
+      DCHECK(!interval->HasHighInterval() || !interval->GetHighInterval()->HasRegister());
+      continue;
+    }
+    auto to_location = [register_type](int reg) {
+      return (register_type == RegisterType::kCoreRegister)
+          ? Location::RegisterLocation(reg)
+          : Location::FpuRegisterLocation(reg);
+    };
+    codegen_->AddAllocatedRegister(to_location(interval->GetRegister()));
+    if (interval->HasHighInterval()) {
+      codegen_->AddAllocatedRegister(to_location(interval->GetHighInterval()->GetRegister()));
+    }
+  }
+}
+
+int RegisterAllocatorGraphColor::FindRegister(InterferenceNode* node,
+                                              uint32_t conflicts,
+                                              RegisterType register_type) const {
+  LiveInterval* interval = node->GetInterval();
+  size_t number_of_registers =
+      (register_type == RegisterType::kCoreRegister) ? num_core_registers_ : num_fp_registers_;
+  bool is_pair = interval->HasHighInterval();
+  auto is_free = [=](int reg) {
+    DCHECK_NE(reg, kNoRegister);
+    if (is_pair) {
+      return IsLowRegister(reg) &&
+             static_cast<size_t>(GetHighForLowRegister(reg)) < number_of_registers &&
+             (conflicts & (3u << reg)) == 0u;
+    }
+    return (conflicts & (1u << reg)) == 0u;
+  };
+
+  // Try to get the register of a sibling next to this interval, so that the value
+  // does not need to be moved between them.
+  for (LiveInterval* sibling = interval->GetParent();
+       sibling != nullptr;
+       sibling = sibling->GetNextSibling()) {
+    if (sibling->GetStart() > interval->GetEnd()) {
+      break;
+    }
+    if (sibling != interval &&
+        sibling->HasRegister() &&
+        (sibling->GetEnd() == interval->GetStart() || sibling->GetStart() == interval->GetEnd()) &&
+        is_free(sibling->GetRegister())) {
+      return sibling->GetRegister();
+    }
+  }
+
+  // Then try the register the definition or the uses of the interval prefer, which
+  // avoids moves for phis, fixed inputs and outputs that are the same as an input.
+  size_t free_until[BitSizeOf<uint32_t>()];
+  for (size_t reg = 0; reg != number_of_registers; ++reg) {
+    free_until[reg] = ((conflicts & (1u << reg)) != 0u) ? 0u : kMaxLifetimePosition;
+  }
+  int hint = interval->FindFirstRegisterHint(free_until, liveness_);
+  if (hint != kNoRegister && is_free(hint)) {
+    return hint;
+  }
+
+  // Otherwise prefer caller-save registers, which leaves callee-save registers to the
+  // intervals live across calls and does not require saving them in the frame entry.
+  int first_free = kNoRegister;
+  for (size_t reg = 0; reg != number_of_registers; ++reg) {
+    if (!is_free(reg)) {
+      continue;
+    }
+    if (IsCallerSave(reg, register_type) &&
+        (!is_pair || IsCallerSave(GetHighForLowRegister(reg), register_type))) {
+      return reg;
+    }
+    if (first_free == kNoRegister) {
+      first_free = reg;
+    }
+  }
+  return first_free;
+}
+
+bool RegisterAllocatorGraphColor::SplitAtRegisterUses(LiveInterval* interval) {
+  DCHECK(!interval->IsHighInterval());
+  if (interval->IsTemp()) {
+    // Temporaries cover a single position and cannot be split.
+    return false;
+  }
+
+  bool split = false;
+  // Split `current` at `position` if `position` is strictly inside of it, and return
+  // the interval starting at `position`, or `current` if it was not split.
+  auto try_split = [&split](LiveInterval* current, size_t position) {
+    if (current->GetStart() < position && position < current->GetEnd()) {
+      split = true;
+      return Split(current, position);
+    }
+    return current;
+  };
+
+  size_t start = interval->GetStart();
+  size_t end = interval->GetEnd();
+  // Split just after a register definition.
+  if (interval->IsParent() && interval->DefinitionRequiresRegister()) {
+    interval = try_split(interval, start + 1u);
+  }
+
+  // Split around register uses in [start, end], leaving a short interval
+  // around each of them.
+  for (const UsePosition& use : FindMatchingUseRange(interval->GetUses().begin(),
+                                                     interval->GetUses().end(),
+                                                     start,
+                                                     end + 1u)) {
+    if (!use.RequiresRegister()) {
+      continue;
+    }
+    size_t position = use.GetPosition();
+    HInstruction* user = use.GetUser();
+    interval = try_split(interval, position - 1u);
+    if (user->IsControlFlow()) {
+      // We cannot insert moves after a control flow instruction, so we split at the
+      // next instruction instead.
+      interval = try_split(interval, user->GetLifetimePosition() + 2u);
+    } else {
+      interval = try_split(interval, position);
+    }
+  }
+  return split;
+}
+
+float RegisterAllocatorGraphColor::ComputeSpillWeight(LiveInterval* interval) const {
+  if (interval->IsTemp() || interval->GetLength() <= 1u) {
+    // Intervals this short cannot be split any further. Give them the highest
+    // priority, so that coloring makes progress.
+    return std::numeric_limits<float>::max();
+  }
+
+  auto cost_in = [](HBasicBlock* block) {
+    float cost = 1.0f;
+    for (HLoopInformationOutwardIterator it(*block); !it.Done(); it.Advance()) {
+      cost *= kLoopSpillWeightMultiplier;
+    }
+    return cost;
+  };
+
+  float use_weight = 0.0f;
+  if (interval->IsParent() &&
+      interval->GetDefinedBy() != nullptr &&
+      interval->DefinitionRequiresRegister()) {
+    // Cost for spilling at a register definition point.
+    use_weight += cost_in(interval->GetDefinedBy()->GetBlock());
+  }
+  for (const UsePosition& use : FindMatchingUseRange(interval->GetUses().begin(),
+                                                     interval->GetUses().end(),
+                                                     interval->GetStart() + 1u,
+                                                     interval->GetEnd() + 1u)) {
+    if (use.RequiresRegister()) {
+      // Cost for reloading at a register use point.
+      use_weight += cost_in(use.GetUser()->GetBlock());
+    }
+  }
+  // Divide by the length of the interval: splitting a short interval further
+  // does not free many positions for other intervals.
+  return use_weight / static_cast<float>(interval->GetLength());
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlots() {
+  ScopedArenaVector<LiveInterval*> spilled(allocator_->Adapter(kArenaAllocRegisterAllocator));
+  for (size_t i = 0; i < liveness_.GetNumberOfSsaValues(); ++i) {
+    LiveInterval* parent = liveness_.GetInstructionFromSsaIndex(i)->GetLiveInterval();
+    for (LiveInterval* sibling = parent; sibling != nullptr; sibling = sibling->GetNextSibling()) {
+      if (!sibling->HasRegister()) {
+        spilled.push_back(parent);
+        break;
+      }
+    }
+  }
+  // Slots are reused by intervals starting after the previous user of the slot died.
+  std::sort(spilled.begin(), spilled.end(), [](LiveInterval* lhs, LiveInterval* rhs) {
+    return (lhs->GetStart() != rhs->GetStart())
+        ? (lhs->GetStart() < rhs->GetStart())
+        : (lhs->GetDefinedBy()->GetSsaIndex() < rhs->GetDefinedBy()->GetSsaIndex());
+  });
+  for (LiveInterval* parent : spilled) {
+    AllocateSpillSlotFor(parent);
+  }
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlotFor(LiveInterval* interval) {
+  DCHECK(interval->IsParent());
+  DCHECK(!interval->IsHighInterval());
+
+  // An instruction gets a spill slot for its entire lifetime. If the interval
+  // already has a spill slot, there is nothing to do.
+  if (interval->HasSpillSlot()) {
+    return;
+  }
+
+  HInstruction* defined_by = interval->GetDefinedBy();
+  DCHECK_IMPLIES(defined_by->IsPhi(), !defined_by->AsPhi()->IsCatchPhi());
+
+  if (defined_by->IsParameterValue()) {
+    // Parameters have their own stack slot.
+    interval->SetSpillSlot(codegen_->GetStackSlotOfParameter(defined_by->AsParameterValue()));
+    return;
+  }
+
+  if (defined_by->IsCurrentMethod()) {
+    interval->SetSpillSlot(0);
+    return;
+  }
+
+  if (defined_by->IsConstant()) {
+    // Constants don't need a spill slot.
+    return;
+  }
+
+  ScopedArenaVector<size_t>* spill_slots = nullptr;
+  switch (interval->GetType()) {
+    case DataType::Type::kFloat64:
+      spill_slots = &double_spill_slots_;
+      break;
+    case DataType::Type::kInt64:
+      spill_slots = &long_spill_slots_;
+      break;
+    case DataType::Type::kFloat32:
+      spill_slots = &float_spill_slots_;
+      break;
+    case DataType::Type::kReference:
+    case DataType::Type::kInt32:
+    case DataType::Type::kUint16:
+    case DataType::Type::kUint8:
+    case DataType::Type::kInt8:
+    case DataType::Type::kBool:
+    case DataType::Type::kInt16:
+      spill_slots = &int_spill_slots_;
+      break;
+    case DataType::Type::kUint32:
+    case DataType::Type::kUint64:
+    case DataType::Type::kVoid:
+      LOG(FATAL) << "Unexpected type for interval " << interval->GetType();
+  }
+
+  // Find first available spill slots.
+  size_t number_of_spill_slots_needed = interval->NumberOfSpillSlotsNeeded();
+  size_t slot = 0;
+  for (size_t e = spill_slots->size(); slot < e; ++slot) {
+    bool found = true;
+    for (size_t s = slot, u = std::min(slot + number_of_spill_slots_needed, e); s < u; s++) {
+      if ((*spill_slots)[s] > interval->GetStart()) {
+        found = false;  // failure
+        break;
+      }
+    }
+    if (found) {
+      break;  // success
+    }
+  }
+
+  // Need new spill slots?
+  size_t upper = slot + number_of_spill_slots_needed;
+  if (upper > spill_slots->size()) {
+    spill_slots->resize(upper);
+  }
+  // Set slots to end.
+  size_t end = interval->GetLastSibling()->GetEnd();
+  for (size_t s = slot; s < upper; s++) {
+    (*spill_slots)[s] = end;
+  }
+
+  // Note that the exact spill slot location will be computed when we resolve,
+  // that is when we know the number of spill slots for each type.
+  interval->SetSpillSlot(slot);
+}
+
+void RegisterAllocatorGraphColor::AllocateSpillSlotForCatchPhi(HPhi* phi) {
+  LiveInterval* interval = phi->GetLiveInterval();
+
+  HInstruction* previous_phi = phi->GetPrevious();
+  DCHECK(previous_phi == nullptr || previous_phi->AsPhi()->GetRegNumber() <= phi->GetRegNumber())
+      << "Phis expected to be sorted by vreg number, so that equivalent phis are adjacent.";
+
+  if (phi->IsVRegEquivalentOf(previous_phi)) {
+    // This is an equivalent of the previous phi. We need to assign the same
+    // catch phi slot.
+    DCHECK(previous_phi->GetLiveInterval()->HasSpillSlot());
+    interval->SetSpillSlot(previous_phi->GetLiveInterval()->GetSpillSlot());
+  } else {
+    // Allocate a new spill slot for this catch phi.
+    interval->SetSpillSlot(catch_phi_spill_slots_);
+    catch_phi_spill_slots_ += interval->NumberOfSpillSlotsNeeded();
+  }
+}
+
+bool RegisterAllocatorGraphColor::ValidateInternal(RegisterType register_type,
+                                                   bool log_fatal_on_failure) const {
+  auto should_process = [](RegisterType current_register_type, LiveInterval* interval) {
+    if (interval == nullptr) {
+      return false;
+    }
+    RegisterType interval_register_type = DataType::IsFloatingPointType(interval->GetType())
+        ? RegisterType::kFpRegister
+        : RegisterType::kCoreRegister;
+    return interval_register_type == current_register_type;
+  };
+
+  ScopedArenaAllocator allocator(allocator_->GetArenaStack());
+  ScopedArenaVector<LiveInterval*> intervals(
+      allocator.Adapter(kArenaAllocRegisterAllocatorValidate));
+  for (size_t i = 0; i < liveness_.GetNumberOfSsaValues(); ++i) {
+    HInstruction* instruction = liveness_.GetInstructionFromSsaIndex(i);
+    if (should_process(register_type, instruction->GetLiveInterval())) {
+      intervals.push_back(instruction->GetLiveInterval());
+    }
+  }
+
+  for (LiveInterval* block_registers_interval : { block_registers_for_call_interval_,
+                                                  block_registers_special_interval_ }) {
+    if (block_registers_interval->GetFirstRange() != nullptr) {
+      intervals.push_back(block_registers_interval);
+    }
+  }
+  const ScopedArenaVector<LiveInterval*>& physical_register_intervals =
+      (register_type == RegisterType::kCoreRegister)
+          ? physical_core_register_intervals_
+          : physical_fp_register_intervals_;
+  for (LiveInterval* fixed : physical_register_intervals) {
+    if (fixed != nullptr) {
+      intervals.push_back(fixed);
+    }
+  }
+
+  for (LiveInterval* temp : temp_intervals_) {
+    if (should_process(register_type, temp)) {
+      intervals.push_back(temp);
+    }
+  }
+
+  return ValidateIntervals(ArrayRef<LiveInterval* const>(intervals),
+                           GetNumberOfSpillSlots(),
+                           reserved_out_slots_,
+                           *codegen_,
+                           &liveness_,
+                           register_type,
+                           log_fatal_on_failure);
+}
+
+}  // namespace art
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+#define ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
+
+#include "arch/instruction_set.h"
+#include "base/macros.h"
+#include "base/scoped_arena_containers.h"
+#include "register_allocator.h"
+
+namespace art HIDDEN {
+
+class CodeGenerator;
+class HBasicBlock;
+class HGraph;
+class HInstruction;
+class HParallelMove;
+class HPhi;
+class InterferenceNode;
+class LiveInterval;
+class Location;
+class SsaLivenessAnalysis;
+
+/**
+ * A graph coloring register allocator on an `HGraph` with SSA form.
+ *
+ * For each register type, the live intervals that need a register form the nodes of an
+ * interference graph, which is colored with the optimistic Chaitin-Briggs algorithm.
+ * Nodes are pruned in order of increasing spill weight, where a use inside a loop weighs
+ * more than a use outside of it, so that values used in hot loops are the last ones to
+ * lose their register. Nodes that cannot be colored are split around their register uses
+ * and the graph is rebuilt, until every interval that requires a register has one.
+ *
+ * Looking at the whole method at once costs more compile time than linear scan, so this
+ * allocator is meant for AOT compiles that favor code quality.
+ */
+class RegisterAllocatorGraphColor : public RegisterAllocator {
+ public:
+  RegisterAllocatorGraphColor(ScopedArenaAllocator* allocator,
+                              CodeGenerator* codegen,
+                              const SsaLivenessAnalysis& analysis);
+  ~RegisterAllocatorGraphColor() override;
+
+  void AllocateRegisters() override;
+
+  bool Validate(bool log_fatal_on_failure) override {
+    return ValidateInternal(RegisterType::kCoreRegister, log_fatal_on_failure) &&
+           ValidateInternal(RegisterType::kFpRegister, log_fatal_on_failure);
+  }
+
+  size_t GetNumberOfSpillSlots() const {
+    return int_spill_slots_.size()
+        + long_spill_slots_.size()
+        + float_spill_slots_.size()
+        + double_spill_slots_.size()
+        + catch_phi_spill_slots_;
+  }
+
+ private:
+  // Collect the live intervals and fixed register constraints of all instructions.
+  void ProcessInstructions();
+  void ProcessInstruction(HInstruction* instruction);
+
+  // Try to remove the SuspendCheck at function entry. Returns true if it was successful.
+  bool TryRemoveSuspendCheckEntry(HInstruction* instruction);
+
+  // Record that the register in `location` is blocked at `position`.
+  void BlockRegister(Location location, size_t position, bool will_call);
+
+  // Collect all live intervals associated with the temporary locations
+  // needed by an instruction.
+  void CheckForTempLiveIntervals(HInstruction* instruction, bool will_call);
+
+  // If a safe point is needed, record it so that the number of live registers
+  // at this point can be computed.
+  void CheckForSafepoint(HInstruction* instruction);
+
+  // If any inputs require specific registers, block those registers
+  // at the position of this instruction.
+  void CheckForFixedInputs(HInstruction* instruction, bool will_call);
+
+  // If the output of an instruction requires a specific register, pre-color the
+  // interval with it.
+  void CheckForFixedOutput(HInstruction* instruction, bool will_call);
+
+  // Add all applicable safepoints to a live interval.
+  // Currently depends on instruction processing order.
+  void AddSafepointsFor(HInstruction* instruction);
+
+  // Color the intervals of one register type, splitting them until coloring succeeds.
+  void ColorIntervals(RegisterType register_type);
+
+  // Compute, for each lifetime position, the registers that fixed and pre-colored
+  // intervals of `register_type` occupy at that position.
+  void ComputeBlockedRegisters(RegisterType register_type,
+                               const ScopedArenaVector<LiveInterval*>& intervals,
+                               ScopedArenaVector<uint32_t>* blocked_at) const;
+
+  // Build the interference graph of the intervals of `register_type` that do not
+  // have a register, sorted by start position.
+  void BuildInterferenceGraph(RegisterType register_type,
+                              const ScopedArenaVector<LiveInterval*>& intervals,
+                              const ScopedArenaVector<uint32_t>& blocked_at,
+                              ScopedArenaAllocator* allocator,
+                              ScopedArenaVector<InterferenceNode*>* nodes) const;
+
+  // Remove nodes from the interference graph one at a time and push them on `stack`,
+  // so that the nodes most likely to get a register are colored first.
+  void PruneInterferenceGraph(const ScopedArenaVector<InterferenceNode*>& nodes,
+                              ScopedArenaAllocator* allocator,
+                              ScopedArenaVector<InterferenceNode*>* stack) const;
+
+  // Pop nodes from `stack` and assign them registers. Intervals which require a
+  // register but cannot get one are added to `failed`, in which case all the
+  // registers assigned by this call are cleared again.
+  void ColorInterferenceGraph(RegisterType register_type,
+                              const ScopedArenaVector<InterferenceNode*>& nodes,
+                              const ScopedArenaVector<InterferenceNode*>& stack,
+                              ScopedArenaVector<LiveInterval*>* failed);
+
+  // Pick a register for the node that is not in `conflicts`, or return kNoRegister.
+  int FindRegister(InterferenceNode* node, uint32_t conflicts, RegisterType register_type) const;
+
+  // Split `interval` around its register uses, so that the parts between these uses
+  // do not need a register. Returns whether any split happened.
+  bool SplitAtRegisterUses(LiveInterval* interval);
+
+  // Returns the estimated cost of not giving a register to `interval`.
+  float ComputeSpillWeight(LiveInterval* interval) const;
+
+  bool IsCallerSave(int reg, RegisterType register_type) const {
+    uint32_t blocked_for_call = (register_type == RegisterType::kCoreRegister)
+        ? core_registers_blocked_for_call_
+        : fp_registers_blocked_for_call_;
+    return (blocked_for_call & (1u << reg)) != 0u;
+  }
+
+  // Allocate a spill slot for the given interval. Should be called in linear
+  // order of interval starting positions.
+  void AllocateSpillSlotFor(LiveInterval* interval);
+
+  // Allocate a spill slot for the given catch phi. Will allocate the same slot
+  // for phis which share the same vreg. Must be called in reverse linear order
+  // of lifetime positions and ascending vreg numbers for correctness.
+  void AllocateSpillSlotForCatchPhi(HPhi* phi);
+
+  // Allocate spill slots for all the values that are not in a register for
+  // part of their lifetime.
+  void AllocateSpillSlots();
+
+  bool ValidateInternal(RegisterType register_type, bool log_fatal_on_failure) const;
+
+  // Intervals for core and floating-point registers that need to be colored. Split
+  // siblings of these intervals are colored too.
+  ScopedArenaVector<LiveInterval*> core_intervals_;
+  ScopedArenaVector<LiveInterval*> fp_intervals_;
+
+  // Fixed intervals for physical registers. Such intervals cover the positions
+  // where an instruction requires a specific register.
+  ScopedArenaVector<LiveInterval*> physical_core_register_intervals_;
+  ScopedArenaVector<LiveInterval*> physical_fp_register_intervals_;
+
+  // Fixed interval covering all positions where caller-save registers are blocked by calls.
+  LiveInterval* block_registers_for_call_interval_;
+
+  // Fixed interval covering the top of catch blocks and irreducible loop headers, where
+  // all registers are blocked so that values live there are spilled.
+  LiveInterval* block_registers_special_interval_;
+
+  // Intervals for temporaries. Such intervals cover the positions
+  // where an instruction requires a temporary.
+  ScopedArenaVector<LiveInterval*> temp_intervals_;
+
+  // The spill slots allocated for live intervals. We ensure spill slots
+  // are typed to avoid (1) doing moves and swaps between two different kinds
+  // of registers, and (2) swapping between a single stack slot and a double
+  // stack slot. This simplifies the parallel move resolver.
+  ScopedArenaVector<size_t> int_spill_slots_;
+  ScopedArenaVector<size_t> long_spill_slots_;
+  ScopedArenaVector<size_t> float_spill_slots_;
+  ScopedArenaVector<size_t> double_spill_slots_;
+
+  // Spill slots allocated to catch phis. This category is special-cased because
+  // (1) slots are allocated prior to coloring and in reverse linear order,
+  // (2) equivalent phis need to share slots despite having different types.
+  size_t catch_phi_spill_slots_;
+
+  // Instructions that need a safepoint.
+  ScopedArenaVector<HInstruction*> safepoints_;
+
+  // Blocked registers, as decided by the code generator.
+  bool* const blocked_core_registers_;
+  bool* const blocked_fp_registers_;
+
+  // Slots reserved for out arguments.
+  size_t reserved_out_slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegisterAllocatorGraphColor);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_REGISTER_ALLOCATOR_GRAPH_COLOR_H_
@@ -85,8 +85,7 @@ class RegisterAllocatorTest : public CommonCompilerTest, public OptimizingUnitTe
 TEST_F(RegisterAllocatorTest, test_name##_LinearScan) {\
   test_name(Strategy::kRegisterAllocatorLinearScan);\
 }\
-/* Note: Graph coloring register allocator has been removed, so the test is DISABLED. */ \
-TEST_F(RegisterAllocatorTest, DISABLED_##test_name##_GraphColor) {\
+TEST_F(RegisterAllocatorTest, test_name##_GraphColor) {\
   test_name(Strategy::kRegisterAllocatorGraphColor);\
 }
 
@@ -634,11 +633,7 @@ void RegisterAllocatorTest::PhiHint(Strategy strategy) {
   }
 }
 
-// TODO: Enable this test for graph coloring register allocation when iterative move
-//       coalescing is merged.
-TEST_F(RegisterAllocatorTest, PhiHint_LinearScan) {
-  PhiHint(Strategy::kRegisterAllocatorLinearScan);
-}
+TEST_ALL_STRATEGIES(PhiHint);
 
 HGraph* RegisterAllocatorTest::BuildFieldReturn(HInstruction** field, HInstruction** ret) {
   HGraph* graph = CreateGraph();
@@ -710,11 +705,7 @@ void RegisterAllocatorTest::ExpectedInRegisterHint(Strategy strategy) {
   }
 }
 
-// TODO: Enable this test for graph coloring register allocation when iterative move
-//       coalescing is merged.
-TEST_F(RegisterAllocatorTest, ExpectedInRegisterHint_LinearScan) {
-  ExpectedInRegisterHint(Strategy::kRegisterAllocatorLinearScan);
-}
+TEST_ALL_STRATEGIES(ExpectedInRegisterHint);
 
 HGraph* RegisterAllocatorTest::BuildTwoSubs(HInstruction** first_sub, HInstruction** second_sub) {
   HGraph* graph = CreateGraph();
@@ -782,11 +773,7 @@ void RegisterAllocatorTest::SameAsFirstInputHint(Strategy strategy) {
   }
 }
 
-// TODO: Enable this test for graph coloring register allocation when iterative move
-//       coalescing is merged.
-TEST_F(RegisterAllocatorTest, SameAsFirstInputHint_LinearScan) {
-  SameAsFirstInputHint(Strategy::kRegisterAllocatorLinearScan);
-}
+TEST_ALL_STRATEGIES(SameAsFirstInputHint);
 
 HGraph* RegisterAllocatorTest::BuildDiv(HInstruction** div) {
   HGraph* graph = CreateGraph();
@@ -829,11 +816,7 @@ void RegisterAllocatorTest::ExpectedExactInRegisterAndSameOutputHint(Strategy st
   ASSERT_EQ(div->GetLiveInterval()->GetRegister(), 0);
 }
 
-// TODO: Enable this test for graph coloring register allocation when iterative move
-//       coalescing is merged.
-TEST_F(RegisterAllocatorTest, ExpectedExactInRegisterAndSameOutputHint_LinearScan) {
-  ExpectedExactInRegisterAndSameOutputHint(Strategy::kRegisterAllocatorLinearScan);
-}
+TEST_ALL_STRATEGIES(ExpectedExactInRegisterAndSameOutputHint);
 
 // Test a bug in the register allocator, where allocating a blocked
 // register would lead to spilling an inactive interval at the wrong
@@ -23,6 +23,10 @@ namespace art HIDDEN {
 
 static constexpr size_t kMaxInstructionsInBranch = 1u;
 
+// Minimum ratio between the counts of the two edges of a profiled branch for the
+// branch to be considered predictable.
+static constexpr uint32_t kPredictableBranchRatio = 50u;
+
 HSelectGenerator::HSelectGenerator(HGraph* graph,
                                    OptimizingCompilerStats* stats,
                                    const char* name)
@@ -87,6 +91,19 @@ static HPhi* GetSinglePhi(HBasicBlock* block, size_t index1, size_t index2) {
   return select_phi;
 }
 
+// Returns whether the branch profile shows that `if_instruction` almost always goes
+// the same way. Such a branch is well predicted and cheaper than a select, which has
+// to wait for both of its values and for the condition.
+static bool IsPredictableBranch(HIf* if_instruction) {
+  if (!if_instruction->HasBranchProfile()) {
+    return false;
+  }
+  uint32_t true_count = if_instruction->GetTrueCount();
+  uint32_t false_count = if_instruction->GetFalseCount();
+  return true_count * kPredictableBranchRatio < false_count ||
+         false_count * kPredictableBranchRatio < true_count;
+}
+
 bool HSelectGenerator::TryGenerateSelectSimpleDiamondPattern(
     HBasicBlock* block, ScopedArenaSafeMap<HInstruction*, HSelect*>* cache) {
   DCHECK(block->GetLastInstruction()->IsIf());
@@ -97,7 +114,8 @@ bool HSelectGenerator::TryGenerateSelectSimpleDiamondPattern(
 
   if (!IsSimpleBlock(true_block) ||
       !IsSimpleBlock(false_block) ||
-      !BlocksMergeTogether(true_block, false_block)) {
+      !BlocksMergeTogether(true_block, false_block) ||
+      IsPredictableBranch(if_instruction)) {
     return false;
   }
   HBasicBlock* merge_block = true_block->GetSingleSuccessor();
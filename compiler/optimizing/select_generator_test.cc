@@ -100,4 +100,17 @@ TEST_F(SelectGeneratorTest, testAdd) {
   EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
 }
 
+// Test that SelectGenerator keeps a branch which the profile shows to be predictable.
+TEST_F(SelectGeneratorTest, testPredictableBranch) {
+  InitGraphAndParameters();
+  HAdd* instr = new (GetAllocator()) HAdd(DataType::Type::kInt32,
+                                          parameters_[0],
+                                          parameters_[0], 0);
+  ConstructBasicGraphForSelect(instr);
+  HIf* if_instruction = instr->GetBlock()->GetSinglePredecessor()->GetLastInstruction()->AsIf();
+  if_instruction->SetTrueCount(1000);
+  if_instruction->SetFalseCount(2);
+  EXPECT_FALSE(CheckGraphAndTrySelectGenerator());
+}
+
 }  // namespace art
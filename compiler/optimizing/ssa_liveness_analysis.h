@@ -60,7 +60,10 @@ class BlockInfo : public ArenaObject<kArenaAllocSsaLiveness> {
  */
 class LiveRange final : public ArenaObject<kArenaAllocSsaLiveness> {
  public:
-  LiveRange(size_t start, size_t end, LiveRange* next) : start_(start), end_(end), next_(next) {
+  LiveRange(size_t start, size_t end, LiveRange* next)
+      : start_(dchecked_integral_cast<uint32_t>(start)),
+        end_(dchecked_integral_cast<uint32_t>(end)),
+        next_(next) {
     DCHECK_LT(start, end);
     DCHECK(next_ == nullptr || next_->GetStart() > GetEnd());
   }
@@ -92,8 +95,13 @@ class LiveRange final : public ArenaObject<kArenaAllocSsaLiveness> {
   }
 
  private:
-  size_t start_;
-  size_t end_;
+  void SetStart(size_t start) { start_ = dchecked_integral_cast<uint32_t>(start); }
+  void SetEnd(size_t end) { end_ = dchecked_integral_cast<uint32_t>(end); }
+
+  // Lifetime positions fit in 32 bits. Huge methods have millions of ranges,
+  // so keep them small.
+  uint32_t start_;
+  uint32_t end_;
   LiveRange* next_;
 
   friend class LiveInterval;
@@ -109,8 +117,8 @@ class UsePosition : public ArenaObject<kArenaAllocSsaLiveness>,
  public:
   UsePosition(HInstruction* user, size_t input_index, size_t position)
       : user_(user),
-        input_index_(input_index),
-        position_(position) {
+        input_index_(dchecked_integral_cast<uint32_t>(input_index)),
+        position_(dchecked_integral_cast<uint32_t>(position)) {
   }
 
   explicit UsePosition(size_t position)
@@ -149,8 +157,8 @@ class UsePosition : public ArenaObject<kArenaAllocSsaLiveness>,
   static constexpr uint32_t kNoInput = static_cast<uint32_t>(-1);
 
   HInstruction* const user_;
-  const size_t input_index_;
-  const size_t position_;
+  const uint32_t input_index_;
+  const uint32_t position_;
 
   DISALLOW_COPY_AND_ASSIGN(UsePosition);
 };
@@ -166,8 +174,8 @@ class EnvUsePosition : public ArenaObject<kArenaAllocSsaLiveness>,
                  size_t input_index,
                  size_t position)
       : environment_(environment),
-        input_index_(input_index),
-        position_(position) {
+        input_index_(dchecked_integral_cast<uint32_t>(input_index)),
+        position_(dchecked_integral_cast<uint32_t>(position)) {
     DCHECK(environment != nullptr);
   }
 
@@ -186,8 +194,8 @@ class EnvUsePosition : public ArenaObject<kArenaAllocSsaLiveness>,
 
  private:
   HEnvironment* const environment_;
-  const size_t input_index_;
-  const size_t position_;
+  const uint32_t input_index_;
+  const uint32_t position_;
 
   DISALLOW_COPY_AND_ASSIGN(EnvUsePosition);
 };
@@ -353,7 +361,7 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
       UsePosition* new_use = new (allocator_) UsePosition(instruction, input_index, position);
       uses_.insert_after(insert_pos, *new_use);
       if (first_range_->GetEnd() == uses_.front().GetPosition()) {
-        first_range_->end_ = position;
+        first_range_->SetEnd(position);
       }
       return;
     }
@@ -409,7 +417,7 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
           new (allocator_) LiveRange(start, end, first_range_);
     } else if (first_range_->GetStart() == end) {
       // There is a use in the following block.
-      first_range_->start_ = start;
+      first_range_->SetStart(start);
     } else if (first_range_->GetStart() == start && first_range_->GetEnd() == end) {
       DCHECK(is_fixed_);
     } else {
@@ -437,13 +445,13 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
     } else if (after_loop->GetStart() <= end) {
       first_range_ = range_search_start_ = after_loop;
       // There are uses after the loop.
-      first_range_->start_ = start;
+      first_range_->SetStart(start);
     } else {
       // The use after the loop is after a lifetime hole.
       DCHECK(last_in_loop != nullptr);
       first_range_ = range_search_start_ = last_in_loop;
-      first_range_->start_ = start;
-      first_range_->end_ = end;
+      first_range_->SetStart(start);
+      first_range_->SetEnd(end);
     }
   }
 
@@ -457,7 +465,7 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
 
   void SetFrom(size_t from) {
     if (first_range_ != nullptr) {
-      first_range_->start_ = from;
+      first_range_->SetStart(from);
     } else {
       // Instruction without uses.
       DCHECK(uses_.empty());
@@ -716,7 +724,7 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
           first_range_ = last_range_;
         }
         new_interval->first_range_ = current;
-        current->start_ = position;
+        current->SetStart(position);
         if (range_search_start_ != nullptr && range_search_start_->GetEnd() >= current->GetEnd()) {
           // Search start point is inside `new_interval`. Change it to `last_range`
           // in the original interval. This is conservative but always correct.
@@ -1285,7 +1293,12 @@ class SsaLivenessAnalysis : public ValueObject {
     if (graph->IsDebuggable()) return true;
     // When compiling in OSR mode, all loops in the compiled method may be entered
     // from the interpreter via SuspendCheck; thus we need to preserve the environment.
-    if (env_holder->IsSuspendCheck() && graph->IsCompilingOsr()) return true;
+    // Baseline JIT code may be deoptimized at a SuspendCheck so that the interpreter
+    // can enter the OSR code, so it needs the environment too.
+    if (env_holder->IsSuspendCheck() &&
+        (graph->IsCompilingOsr() || graph->IsCompilingBaseline())) {
+      return true;
+    }
     if (graph -> IsDeadReferenceSafe()) return false;
     return instruction->GetType() == DataType::Type::kReference;
   }
@@ -17,6 +17,7 @@
 #include "write_barrier_elimination.h"
 
 #include "base/arena_allocator.h"
+#include "base/array_ref.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "optimizing/nodes.h"
@@ -32,13 +33,20 @@ class WBEVisitor final : public HGraphVisitor {
       : HGraphVisitor(graph),
         scoped_allocator_(graph->GetArenaStack()),
         current_write_barriers_(scoped_allocator_.Adapter(kArenaAllocWBE)),
+        block_write_barriers_(graph->GetBlocks().size(),
+                              ScopedArenaHashMap<HInstruction*, HInstruction*>(
+                                  scoped_allocator_.Adapter(kArenaAllocWBE)),
+                              scoped_allocator_.Adapter(kArenaAllocWBE)),
+        visited_blocks_(graph->GetBlocks().size(),
+                        false,
+                        scoped_allocator_.Adapter(kArenaAllocWBE)),
         stats_(stats) {}
 
   void VisitBasicBlock(HBasicBlock* block) override {
-    // We clear the map to perform this optimization only in the same block. Doing it across blocks
-    // would entail non-trivial merging of states.
-    current_write_barriers_.clear();
+    MergePredecessorValues(block);
     VisitNonPhiInstructions(block);
+    block_write_barriers_[block->GetBlockId()] = current_write_barriers_;
+    visited_blocks_[block->GetBlockId()] = true;
   }
 
   void VisitInstanceFieldSet(HInstanceFieldSet* instruction) override {
@@ -57,7 +65,7 @@ class WBEVisitor final : public HGraphVisitor {
       DCHECK(it->second->IsInstanceFieldSet());
       DCHECK(it->second->AsInstanceFieldSet()->GetWriteBarrierKind() !=
              WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       it->second->AsInstanceFieldSet()->SetWriteBarrierKind(WriteBarrierKind::kEmitBeingReliedOn);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -83,7 +91,7 @@ class WBEVisitor final : public HGraphVisitor {
     if (it != current_write_barriers_.end()) {
       DCHECK(it->second->IsStaticFieldSet());
       DCHECK(it->second->AsStaticFieldSet()->GetWriteBarrierKind() != WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       it->second->AsStaticFieldSet()->SetWriteBarrierKind(WriteBarrierKind::kEmitBeingReliedOn);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -95,7 +103,7 @@ class WBEVisitor final : public HGraphVisitor {
   }
 
   void VisitArraySet(HArraySet* instruction) override {
-    if (instruction->GetSideEffects().Includes(SideEffects::CanTriggerGC())) {
+    if (CanTriggerGC(instruction)) {
       ClearCurrentValues();
     }
 
@@ -111,7 +119,7 @@ class WBEVisitor final : public HGraphVisitor {
     if (it != current_write_barriers_.end()) {
       DCHECK(it->second->IsArraySet());
       DCHECK(it->second->AsArraySet()->GetWriteBarrierKind() != WriteBarrierKind::kDontEmit);
-      DCHECK_EQ(it->second->GetBlock(), instruction->GetBlock());
+      DCHECK(it->second->GetBlock()->Dominates(instruction->GetBlock()));
       it->second->AsArraySet()->SetWriteBarrierKind(WriteBarrierKind::kEmitBeingReliedOn);
       instruction->SetWriteBarrierKind(WriteBarrierKind::kDontEmit);
       MaybeRecordStat(stats_, MethodCompilationStat::kRemovedWriteBarrier);
@@ -123,7 +131,7 @@ class WBEVisitor final : public HGraphVisitor {
   }
 
   void VisitInstruction(HInstruction* instruction) override {
-    if (instruction->GetSideEffects().Includes(SideEffects::CanTriggerGC())) {
+    if (CanTriggerGC(instruction)) {
       ClearCurrentValues();
     }
   }
@@ -131,6 +139,70 @@ class WBEVisitor final : public HGraphVisitor {
  private:
   void ClearCurrentValues() { current_write_barriers_.clear(); }
 
+  // A suspend check that was made a no-op does not generate any code, so it is not a GC point.
+  static bool CanTriggerGC(HInstruction* instruction) {
+    return instruction->GetSideEffects().Includes(SideEffects::CanTriggerGC()) &&
+           !(instruction->IsSuspendCheck() && instruction->AsSuspendCheck()->IsNoOp());
+  }
+
+  bool LoopCanTriggerGC(HLoopInformation* loop_info) const {
+    for (HBlocksInLoopIterator it_loop(*loop_info); !it_loop.Done(); it_loop.Advance()) {
+      HBasicBlock* block = it_loop.Current();
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        if (CanTriggerGC(it.Current())) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // A write barrier can be relied on in another block if it dominates it and there is no GC point
+  // in between. This is the case for the write barriers that reach the end of all the
+  // predecessors. Loops need the back edges, which have not been visited yet, so we only keep
+  // the write barriers from before a loop if nothing in the loop can trigger GC. Such a loop then
+  // marks the card of a loop invariant receiver once, before the loop.
+  void MergePredecessorValues(HBasicBlock* block) {
+    current_write_barriers_.clear();
+    if (block->IsCatchBlock()) {
+      return;
+    }
+    if (block->IsLoopHeader()) {
+      HLoopInformation* loop_info = block->GetLoopInformation();
+      if (!loop_info->IsIrreducible() &&
+          visited_blocks_[loop_info->GetPreHeader()->GetBlockId()] &&
+          !LoopCanTriggerGC(loop_info)) {
+        current_write_barriers_ = block_write_barriers_[loop_info->GetPreHeader()->GetBlockId()];
+      }
+      return;
+    }
+    ArrayRef<HBasicBlock* const> predecessors(block->GetPredecessors());
+    if (predecessors.empty()) {
+      return;
+    }
+    for (HBasicBlock* predecessor : predecessors) {
+      if (!visited_blocks_[predecessor->GetBlockId()]) {
+        return;
+      }
+    }
+    for (const auto& [receiver, write_barrier] :
+         block_write_barriers_[predecessors[0]->GetBlockId()]) {
+      bool in_all_predecessors = true;
+      for (HBasicBlock* predecessor : predecessors.SubArray(1u)) {
+        const ScopedArenaHashMap<HInstruction*, HInstruction*>& other =
+            block_write_barriers_[predecessor->GetBlockId()];
+        auto it = other.find(receiver);
+        if (it == other.end() || it->second != write_barrier) {
+          in_all_predecessors = false;
+          break;
+        }
+      }
+      if (in_all_predecessors) {
+        current_write_barriers_.insert({receiver, write_barrier});
+      }
+    }
+  }
+
   HInstruction* HuntForOriginalReference(HInstruction* ref) const {
     // An original reference can be transformed by instructions like:
     //   i0 NewArray
@@ -146,9 +218,12 @@ class WBEVisitor final : public HGraphVisitor {
   ScopedArenaAllocator scoped_allocator_;
 
   // Stores a map of <Receiver, InstructionWhereTheWriteBarrierIs>.
-  // `InstructionWhereTheWriteBarrierIs` is used for DCHECKs only.
   ScopedArenaHashMap<HInstruction*, HInstruction*> current_write_barriers_;
 
+  // The `current_write_barriers_` at the end of each visited block, indexed by block id.
+  ScopedArenaVector<ScopedArenaHashMap<HInstruction*, HInstruction*>> block_write_barriers_;
+  ScopedArenaVector<bool> visited_blocks_;
+
   OptimizingCompilerStats* const stats_;
 
   DISALLOW_COPY_AND_ASSIGN(WBEVisitor);
@@ -32,6 +32,11 @@ namespace art HIDDEN {
 //   o.inner_obj3 = io3;
 // We can keep the write barrier for `inner_obj` and remove the other two.
 //
+// This also works across blocks, as long as the kept write barrier dominates the removed ones and
+// there is no instruction that can trigger GC in between. For loops without such instructions
+// (e.g. small loops whose suspend check is a no-op), a write barrier before the loop covers the
+// sets to the same receiver in all iterations.
+//
 // In order to do this, we set the WriteBarrierKind of the instruction. The instruction's kind are
 // set to kEmitBeingReliedOn (if this write barrier coalesced other write barriers, we don't want to
 // perform the null check optimization), or to kDontEmit (if the write barrier as a whole is not
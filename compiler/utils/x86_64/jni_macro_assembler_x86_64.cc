@@ -311,19 +311,16 @@ void X86_64JNIMacroAssembler::MoveArguments(ArrayRef<ArgumentLocation> dests,
     } else {
       DCHECK_EQ(src.GetSize(), dest.GetSize());
     }
-    if (src.IsRegister() && ref != kInvalidReferenceOffset) {
-      // Note: We can clobber `src` here as the register cannot hold more than one argument.
-      //       This overload of `CreateJObject()` is currently implemented as "test and branch";
-      //       if it was using a conditional move, it would be better to do this at move time.
-      CreateJObject(src.GetRegister(), ref, src.GetRegister(), /*null_allowed=*/ i != 0u);
-    }
     if (dest.IsRegister()) {
       // Note: X86_64ManagedRegister makes no distinction between 32-bit and 64-bit core
-      // registers, so the following `Equals()` can return `true` for references; the
-      // reference has already been converted to `jobject` above.
+      // registers, so the following `Equals()` can return `true` for references.
       if (src.IsRegister() && src.GetRegister().Equals(dest.GetRegister())) {
-        // Nothing to do.
+        if (ref != kInvalidReferenceOffset) {
+          // Just convert to `jobject`. No further processing is needed.
+          CreateJObject(dest.GetRegister(), ref, src.GetRegister(), /*null_allowed=*/ i != 0u);
+        }
       } else {
+        // References in other registers are converted to `jobject` when moving them below.
         if (src.IsRegister()) {
           src_regs |= get_mask(src.GetRegister());
         }
@@ -331,6 +328,10 @@ void X86_64JNIMacroAssembler::MoveArguments(ArrayRef<ArgumentLocation> dests,
       }
     } else {
       if (src.IsRegister()) {
+        if (ref != kInvalidReferenceOffset) {
+          // Note: We can clobber `src` here as the register cannot hold more than one argument.
+          CreateJObject(src.GetRegister(), ref, src.GetRegister(), /*null_allowed=*/ i != 0u);
+        }
         Store(dest.GetFrameOffset(), src.GetRegister(), dest.GetSize());
       } else if (ref != kInvalidReferenceOffset) {
         CreateJObject(dest.GetFrameOffset(), ref, /*null_allowed=*/ i != 0u);
@@ -359,7 +360,11 @@ void X86_64JNIMacroAssembler::MoveArguments(ArrayRef<ArgumentLocation> dests,
         continue;  // Cannot clobber this register yet.
       }
       if (src.IsRegister()) {
-        Move(dest.GetRegister(), src.GetRegister(), dest.GetSize());
+        if (ref != kInvalidReferenceOffset) {
+          CreateJObject(dest.GetRegister(), ref, src.GetRegister(), /*null_allowed=*/ i != 0u);
+        } else {
+          Move(dest.GetRegister(), src.GetRegister(), dest.GetSize());
+        }
         src_regs &= ~get_mask(src.GetRegister());  // Allow clobbering source register.
       } else if (ref != kInvalidReferenceOffset) {
         CreateJObject(
@@ -435,14 +440,16 @@ void X86_64JNIMacroAssembler::CreateJObject(ManagedRegister mout_reg,
   CHECK(out_reg.IsCpuRegister());
   VerifyObject(in_reg, null_allowed);
   if (null_allowed) {
-    Label null_arg;
+    // Use a conditional move rather than a branch that depends on the argument value.
+    CpuRegister scratch = GetScratchRegister();
+    DCHECK_NE(out_reg.AsCpuRegister().AsRegister(), scratch.AsRegister());
+    DCHECK_NE(in_reg.AsCpuRegister().AsRegister(), scratch.AsRegister());
     if (!out_reg.Equals(in_reg)) {
       __ xorl(out_reg.AsCpuRegister(), out_reg.AsCpuRegister());
     }
+    __ leaq(scratch, Address(CpuRegister(RSP), spilled_reference_offset));
     __ testl(in_reg.AsCpuRegister(), in_reg.AsCpuRegister());
-    __ j(kZero, &null_arg);
-    __ leaq(out_reg.AsCpuRegister(), Address(CpuRegister(RSP), spilled_reference_offset));
-    __ Bind(&null_arg);
+    __ cmov(kNotZero, out_reg.AsCpuRegister(), scratch);
   } else {
     __ leaq(out_reg.AsCpuRegister(), Address(CpuRegister(RSP), spilled_reference_offset));
   }
@@ -1105,6 +1105,7 @@ class Dex2Oat final {
     AssignIfExists(args, M::RuntimeOptions, &runtime_args_);
     AssignIfExists(args, M::SwapFile, &swap_file_name_);
     AssignIfExists(args, M::SwapFileFd, &swap_fd_);
+    AssignIfExists(args, M::SwapDir, &swap_dir_);
     AssignIfExists(args, M::SwapDexSizeThreshold, &min_dex_file_cumulative_size_for_swap_);
     AssignIfExists(args, M::SwapDexCountThreshold, &min_dex_files_for_swap_);
     AssignIfExists(args, M::VeryLargeAppThreshold, &very_large_threshold_);
@@ -1739,6 +1740,18 @@ class Dex2Oat final {
       } else {
         LOG(INFO) << "Large app, accepted running with swap.";
       }
+    } else if (!swap_dir_.empty() && UseSwap(IsBootImage() || IsBootImageExtension(), dex_files)) {
+      // Keep the compiled code of large apps in a swap file rather than in memory, so that
+      // the peak memory use of dex2oat does not grow with the size of the app.
+      std::string swap_file_name = swap_dir_ + "/dex2oat-swap.XXXXXX";
+      int swap_fd = TEMP_FAILURE_RETRY(mkstemp(swap_file_name.data()));
+      if (swap_fd == -1) {
+        PLOG(WARNING) << "Failed to create swap file in " << swap_dir_;
+      } else {
+        unlink(swap_file_name.c_str());
+        swap_fd_ = swap_fd;
+        LOG(INFO) << "Large app, running with swap in " << swap_dir_;
+      }
     }
     // Note that dex2oat won't close the swap_fd_. The compiler driver's swap space will do that.
 
@@ -1773,6 +1786,11 @@ class Dex2Oat final {
   // contain a dex section (e.g. when they come from .dm files).
   // If the input vdex does contain dex files, the dex files will be opened from there
   // and so this check is redundant.
+  // Note that the input vdex cannot be reused for the dex files that did not change when
+  // only some of them did: VerifierDeps only record dependencies on the classpath, not on
+  // the other dex files being compiled, so unchanged classes may have been verified
+  // against classes that changed. For the same reason, and because compiled code embeds
+  // dex indices and inlines across classes, compiled code is not reused per class either.
   bool ValidateInputVdexChecksums() {
     if (input_vdex_file_ == nullptr) {
       // Nothing to validate
@@ -2206,7 +2224,8 @@ class Dex2Oat final {
         // We need to mirror the layout of the ELF file in the compressed debug-info.
         // Therefore PrepareDebugInfo() relies on the SetLoadedSectionSizes() call further above.
         debug::DebugInfo debug_info = oat_writer->GetDebugInfo();  // Keep the variable alive.
-        elf_writer->PrepareDebugInfo(debug_info);  // Processes the data on background thread.
+        // Processes the data on background threads.
+        elf_writer->PrepareDebugInfo(debug_info, thread_count_);
 
         OutputStream* rodata = rodata_[i];
         DCHECK(rodata != nullptr);
@@ -3038,6 +3057,7 @@ class Dex2Oat final {
   android::base::unique_fd invocation_file_;
   std::string swap_file_name_;
   int swap_fd_;
+  std::string swap_dir_;
   size_t min_dex_files_for_swap_ = kDefaultMinDexFilesForSwap;
   size_t min_dex_file_cumulative_size_for_swap_ = kDefaultMinDexFileCumulativeSizeForSwap;
   size_t very_large_threshold_ = std::numeric_limits<size_t>::max();
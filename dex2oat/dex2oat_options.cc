@@ -215,6 +215,7 @@ static void AddImageMappings(Builder& builder) {
           .WithType<ImageHeader::StorageMode>()
           .WithValueMap({{"lz4", ImageHeader::kStorageModeLZ4},
                          {"lz4hc", ImageHeader::kStorageModeLZ4HC},
+                         {"zstd", ImageHeader::kStorageModeZstd},
                          {"uncompressed", ImageHeader::kStorageModeUncompressed}})
           .WithHelp("Which format to store the image Defaults to uncompressed. Eg:"
                     " --image-format=lz4")
@@ -233,6 +234,11 @@ static void AddSwapMappings(Builder& builder) {
           .WithType<int>()
           .WithHelp("Specify a file to use for swap by file-descriptor. Eg: --swap-fd=3")
           .IntoKey(M::SwapFileFd)
+      .Define("--swap-dir=_")
+          .WithType<std::string>()
+          .WithHelp("Specify a directory where dex2oat creates a swap file when no swap file is\n"
+                    "given and the swap thresholds are reached. Eg: --swap-dir=/data/tmp")
+          .IntoKey(M::SwapDir)
       .Define("--swap-dex-size-threshold=_")
           .WithType<unsigned int>()
           .WithHelp("specifies the minimum total dex file size in bytes to allow the use of swap.")
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <optional>
 #include <regex>
 #include <sstream>
@@ -31,6 +32,7 @@
 #include "arch/instruction_set_features.h"
 #include "base/macros.h"
 #include "base/mutex-inl.h"
+#include "base/stl_util.h"
 #include "base/string_view_cpp20.h"
 #include "base/utils.h"
 #include "base/zip_archive.h"
@@ -315,6 +317,23 @@ TEST_F(Dex2oatSwapTest, DoUseSwapSingleSmall) {
           {"--swap-dex-size-threshold=0", "--swap-dex-count-threshold=0"});
 }
 
+TEST_F(Dex2oatSwapTest, DoUseSwapDir) {
+  std::string dex_location = GetScratchDir() + "/Dex2OatSwapTest.jar";
+  std::string odex_location = GetOdexDir() + "/Dex2OatSwapTest.odex";
+  Copy(GetTestDexFileName(), dex_location);
+
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  odex_location,
+                                  CompilerFilter::kSpeed,
+                                  {"--swap-dir=" + GetScratchDir(),
+                                   "--swap-dex-size-threshold=0",
+                                   "--swap-dex-count-threshold=0"}));
+  CheckValidity();
+  if (!kIsTargetBuild) {
+    EXPECT_NE(output_.find("Large app, running with swap in"), std::string::npos) << output_;
+  }
+}
+
 class Dex2oatSwapUseTest : public Dex2oatSwapTest {
  protected:
   void CheckHostResult(bool expect_use) override {
@@ -1405,6 +1424,149 @@ TEST_F(Dex2oatTest, LayoutSections) {
 #endif  // 0
 }
 
+// Test that the code of the profile startup methods is laid out next to each other and that the
+// oat header records its range.
+TEST_F(Dex2oatTest, StartupCodeRange) {
+  using Hotness = ProfileCompilationInfo::MethodHotness;
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("ManyMethods"));
+  const dex::TypeId* type_id = dex->FindTypeId("LManyMethods;");
+  ASSERT_TRUE(type_id != nullptr);
+  const dex::ClassDef* class_def = dex->FindClassDef(dex->GetIndexForTypeId(*type_id));
+  ASSERT_TRUE(class_def != nullptr);
+  // Compile all methods of the class, interleaving startup and other methods.
+  std::vector<uint16_t> hot_methods;
+  std::vector<uint16_t> startup_methods;
+  std::vector<uint16_t> post_startup_methods;
+  ClassAccessor accessor(*dex, *class_def);
+  for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+    const uint16_t method_idx = method.GetIndex();
+    hot_methods.push_back(method_idx);
+    if (hot_methods.size() % 3u == 1u) {
+      startup_methods.push_back(method_idx);
+    } else if (hot_methods.size() % 3u == 2u) {
+      post_startup_methods.push_back(method_idx);
+    }
+  }
+  ASSERT_GE(hot_methods.size(), 6u);
+  ScratchFile profile_file;
+  ProfileCompilationInfo info;
+  info.AddMethodsForDex(Hotness::kFlagHot, dex.get(), hot_methods.begin(), hot_methods.end());
+  info.AddMethodsForDex(
+      Hotness::kFlagStartup, dex.get(), startup_methods.begin(), startup_methods.end());
+  info.AddMethodsForDex(Hotness::kFlagPostStartup,
+                        dex.get(),
+                        post_startup_methods.begin(),
+                        post_startup_methods.end());
+  ASSERT_TRUE(info.Save(profile_file.GetFd()));
+
+  const std::string odex_location = GetScratchDir() + "/base.odex";
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  odex_location,
+                                  CompilerFilter::Filter::kSpeedProfile,
+                                  {"--profile-file=" + profile_file.GetFilename()}));
+  std::string error_msg;
+  std::unique_ptr<OatFile> odex_file(OatFile::Open(/*zip_fd=*/-1,
+                                                   odex_location,
+                                                   odex_location,
+                                                   /*executable=*/false,
+                                                   /*low_4gb=*/false,
+                                                   dex->GetLocation(),
+                                                   &error_msg));
+  ASSERT_TRUE(odex_file != nullptr) << error_msg;
+  const OatHeader& oat_header = odex_file->GetOatHeader();
+  const uint32_t startup_begin = oat_header.GetStartupCodeOffset();
+  const uint32_t startup_end = startup_begin + oat_header.GetStartupCodeSize();
+  ASSERT_LT(startup_begin, startup_end);
+  EXPECT_GE(startup_begin, oat_header.GetExecutableOffset());
+  EXPECT_LE(startup_end, odex_file->Size());
+
+  std::vector<const OatDexFile*> oat_dex_files = odex_file->GetOatDexFiles();
+  ASSERT_EQ(oat_dex_files.size(), 1u);
+  const OatFile::OatClass oat_class =
+      oat_dex_files[0]->GetOatClass(dex->GetIndexForClassDef(*class_def));
+  std::vector<uint32_t> startup_code_offsets;
+  std::vector<uint32_t> other_code_offsets;
+  uint32_t method_index = 0u;
+  for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+    const uint32_t code_offset = oat_class.GetOatMethod(method_index).GetCodeOffset();
+    ++method_index;
+    if (code_offset == 0u) {
+      continue;  // Not compiled.
+    }
+    if (ContainsElement(startup_methods, method.GetIndex())) {
+      startup_code_offsets.push_back(code_offset);
+    } else {
+      other_code_offsets.push_back(code_offset);
+    }
+  }
+  ASSERT_FALSE(startup_code_offsets.empty());
+  for (uint32_t code_offset : startup_code_offsets) {
+    EXPECT_GE(code_offset, startup_begin);
+    EXPECT_LT(code_offset, startup_end);
+  }
+  for (uint32_t code_offset : other_code_offsets) {
+    // Methods with the same code as a startup method share its copy.
+    if (!ContainsElement(startup_code_offsets, code_offset)) {
+      EXPECT_TRUE(code_offset < startup_begin || code_offset >= startup_end) << code_offset;
+    }
+  }
+}
+
+// Test that the code of a profiled method is followed by the code of the methods it calls.
+TEST_F(Dex2oatTest, CalleesFollowCallers) {
+  using Hotness = ProfileCompilationInfo::MethodHotness;
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("CallGraph"));
+  const dex::TypeId* type_id = dex->FindTypeId("LCallGraph;");
+  ASSERT_TRUE(type_id != nullptr);
+  const dex::ClassDef* class_def = dex->FindClassDef(dex->GetIndexForTypeId(*type_id));
+  ASSERT_TRUE(class_def != nullptr);
+  std::vector<uint16_t> hot_methods;
+  ClassAccessor accessor(*dex, *class_def);
+  for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+    hot_methods.push_back(method.GetIndex());
+  }
+  ScratchFile profile_file;
+  ProfileCompilationInfo info;
+  info.AddMethodsForDex(Hotness::kFlagHot, dex.get(), hot_methods.begin(), hot_methods.end());
+  ASSERT_TRUE(info.Save(profile_file.GetFd()));
+
+  // Disable inlining so that the calls stay in the compiled code.
+  const std::string odex_location = GetScratchDir() + "/base.odex";
+  ASSERT_TRUE(GenerateOdexForTest(dex->GetLocation(),
+                                  odex_location,
+                                  CompilerFilter::Filter::kSpeedProfile,
+                                  {"--profile-file=" + profile_file.GetFilename(),
+                                   "--inline-max-code-units=0"}));
+  std::string error_msg;
+  std::unique_ptr<OatFile> odex_file(OatFile::Open(/*zip_fd=*/-1,
+                                                   odex_location,
+                                                   odex_location,
+                                                   /*executable=*/false,
+                                                   /*low_4gb=*/false,
+                                                   dex->GetLocation(),
+                                                   &error_msg));
+  ASSERT_TRUE(odex_file != nullptr) << error_msg;
+  std::vector<const OatDexFile*> oat_dex_files = odex_file->GetOatDexFiles();
+  ASSERT_EQ(oat_dex_files.size(), 1u);
+  const OatFile::OatClass oat_class =
+      oat_dex_files[0]->GetOatClass(dex->GetIndexForClassDef(*class_def));
+  std::map<std::string, uint32_t> code_offsets;
+  uint32_t method_index = 0u;
+  for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+    code_offsets.emplace(dex->GetMethodName(method.GetIndex()),
+                         oat_class.GetOatMethod(method_index).GetCodeOffset());
+    ++method_index;
+  }
+  for (const char* name : {"a", "b", "c", "d"}) {
+    ASSERT_NE(code_offsets[name], 0u) << name;
+  }
+  // In dex order, the methods would be laid out as a, b, c, d. `a()` calls `c()`, which
+  // calls `d()`, so they are placed before the unrelated `b()`.
+  EXPECT_LT(code_offsets["a"], code_offsets["c"]);
+  EXPECT_LT(code_offsets["c"], code_offsets["d"]);
+  EXPECT_LT(code_offsets["d"], code_offsets["b"]);
+}
+
 // Test that generating compact dex works.
 TEST_F(Dex2oatTest, GenerateCompactDex) {
   // TODO(b/256664509): Clean this up.
@@ -22,6 +22,8 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <algorithm>
+#include <numeric>
 #include <string_view>
 #include <vector>
 
@@ -266,6 +268,9 @@ CompilerDriver::CompilerDriver(
       parallel_thread_count_(thread_count),
       stats_(new AOTCompilationStats),
       compiled_method_storage_(swap_fd),
+      jni_stubs_lock_("CompilerDriver JNI stubs lock", kGenericBottomLock),
+      jni_stubs_(JniStubKeyHash(compiler_options->GetInstructionSet()),
+                 JniStubKeyEquals(compiler_options->GetInstructionSet())),
       max_arena_alloc_(0) {
   DCHECK(compiler_options_ != nullptr);
 
@@ -452,6 +457,45 @@ static bool ShouldCompileBasedOnProfile(const CompilerOptions& compiler_options,
   }
 }
 
+CompiledMethod* CompilerDriver::CompileJniStub(uint32_t access_flags,
+                                               uint32_t method_idx,
+                                               const DexFile& dex_file,
+                                               Handle<mirror::DexCache> dex_cache) {
+  Thread* self = Thread::Current();
+  JniStubKey key(access_flags, dex_file.GetMethodShortyView(dex_file.GetMethodId(method_idx)));
+  const CompiledMethod* shared_stub = nullptr;
+  {
+    MutexLock mu(self, jni_stubs_lock_);
+    auto it = jni_stubs_.find(key);
+    if (it != jni_stubs_.end()) {
+      shared_stub = it->second;
+    }
+  }
+  if (shared_stub != nullptr) {
+    // The stub does not depend on the method beyond its `JniStubKey`. The storage shares
+    // the code and stack maps and the oat writer deduplicates the code of the copy.
+    return GetCompiledMethodStorage()->CreateCompiledMethod(
+        shared_stub->GetInstructionSet(),
+        shared_stub->GetQuickCode(),
+        shared_stub->GetVmapTable(),
+        shared_stub->GetCFIInfo(),
+        /*patches=*/ ArrayRef<const linker::LinkerPatch>(),
+        /*is_intrinsic=*/ false);
+  }
+
+  CompiledMethod* compiled_method =
+      GetCompiler()->JniCompile(access_flags, method_idx, dex_file, dex_cache);
+  CHECK(compiled_method != nullptr);
+  // Intrinsic implementations are specific to the method.
+  if (!compiled_method->IsIntrinsic()) {
+    DCHECK(compiled_method->GetPatches().empty());
+    MutexLock mu(self, jni_stubs_lock_);
+    // If another thread compiled an equivalent stub concurrently, keep the first one.
+    jni_stubs_.insert(std::make_pair(key, compiled_method));
+  }
+  return compiled_method;
+}
+
 static void CompileMethodQuick(
     Thread* self,
     CompilerDriver* driver,
@@ -502,8 +546,7 @@ static void CompileMethodQuick(
         }
         if (boot_jni_stub == nullptr) {
           compiled_method =
-              driver->GetCompiler()->JniCompile(access_flags, method_idx, dex_file, dex_cache);
-          CHECK(compiled_method != nullptr);
+              driver->CompileJniStub(access_flags, method_idx, dex_file, dex_cache);
         }
       }
     } else if ((access_flags & kAccAbstract) != 0) {
@@ -569,6 +612,146 @@ static void CompileMethodQuick(
                        quick_fn);
 }
 
+class CompilationVisitor {
+ public:
+  virtual ~CompilationVisitor() {}
+  virtual void Visit(size_t index) = 0;
+};
+
+class ParallelCompilationManager {
+ public:
+  ParallelCompilationManager(ClassLinker* class_linker,
+                             jobject class_loader,
+                             CompilerDriver* compiler,
+                             const DexFile* dex_file,
+                             const std::vector<const DexFile*>& dex_files,
+                             ThreadPool* thread_pool)
+    : index_(0),
+      class_linker_(class_linker),
+      class_loader_(class_loader),
+      compiler_(compiler),
+      dex_file_(dex_file),
+      dex_files_(dex_files),
+      thread_pool_(thread_pool) {}
+
+  ClassLinker* GetClassLinker() const {
+    CHECK(class_linker_ != nullptr);
+    return class_linker_;
+  }
+
+  jobject GetClassLoader() const {
+    return class_loader_;
+  }
+
+  CompilerDriver* GetCompiler() const {
+    CHECK(compiler_ != nullptr);
+    return compiler_;
+  }
+
+  const DexFile* GetDexFile() const {
+    CHECK(dex_file_ != nullptr);
+    return dex_file_;
+  }
+
+  const std::vector<const DexFile*>& GetDexFiles() const {
+    return dex_files_;
+  }
+
+  void ForAll(size_t begin, size_t end, CompilationVisitor* visitor, size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
+    ForAllLambda(begin, end, [visitor](size_t index) { visitor->Visit(index); }, work_units);
+  }
+
+  template <typename Fn>
+  void ForAllLambda(size_t begin, size_t end, Fn fn, size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    self->AssertNoPendingException();
+    CHECK_GT(work_units, 0U);
+
+    index_.store(begin, std::memory_order_relaxed);
+    busy_times_ns_.assign(work_units, 0u);
+    for (size_t i = 0; i < work_units; ++i) {
+      thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn, &busy_times_ns_[i]));
+    }
+    thread_pool_->StartWorkers(self);
+
+    // Ensure we're suspended while we're blocked waiting for the other threads to finish (worker
+    // thread destructor's called below perform join).
+    CHECK_NE(self->GetState(), ThreadState::kRunnable);
+
+    // Wait for all the worker threads to finish.
+    thread_pool_->Wait(self, true, false);
+
+    // And stop the workers accepting jobs.
+    thread_pool_->StopWorkers(self);
+  }
+
+  // Like ForAllLambda, but calls `fn` with the indexes in `order`, in that order.
+  template <typename Fn>
+  void ForAllLambdaInOrder(const std::vector<uint32_t>& order, Fn fn, size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
+    ForAllLambda(0, order.size(), [&order, &fn](size_t index) { fn(order[index]); }, work_units);
+  }
+
+  // Returns the time each work unit of the last ForAll call spent running `fn`.
+  const std::vector<uint64_t>& GetBusyTimes() const {
+    return busy_times_ns_;
+  }
+
+  size_t NextIndex() {
+    return index_.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+ private:
+  template <typename Fn>
+  class ForAllClosureLambda : public Task {
+   public:
+    ForAllClosureLambda(ParallelCompilationManager* manager,
+                        size_t end,
+                        Fn fn,
+                        uint64_t* busy_time_ns)
+        : manager_(manager),
+          end_(end),
+          fn_(fn),
+          busy_time_ns_(busy_time_ns) {}
+
+    void Run(Thread* self) override {
+      const uint64_t start_ns = NanoTime();
+      while (true) {
+        const size_t index = manager_->NextIndex();
+        if (UNLIKELY(index >= end_)) {
+          break;
+        }
+        fn_(index);
+        self->AssertNoPendingException();
+      }
+      *busy_time_ns_ = NanoTime() - start_ns;
+    }
+
+    void Finalize() override {
+      delete this;
+    }
+
+   private:
+    ParallelCompilationManager* const manager_;
+    const size_t end_;
+    Fn fn_;
+    uint64_t* const busy_time_ns_;
+  };
+
+  AtomicInteger index_;
+  ClassLinker* const class_linker_;
+  const jobject class_loader_;
+  CompilerDriver* const compiler_;
+  const DexFile* const dex_file_;
+  const std::vector<const DexFile*>& dex_files_;
+  ThreadPool* const thread_pool_;
+  std::vector<uint64_t> busy_times_ns_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelCompilationManager);
+};
+
 void CompilerDriver::Resolve(jobject class_loader,
                              const std::vector<const DexFile*>& dex_files,
                              TimingLogger* timings) {
@@ -601,14 +784,10 @@ void CompilerDriver::ResolveConstStrings(const std::vector<const DexFile*>& dex_
     // will cause a bloated app image and slow down startup.
     return;
   }
-  ScopedObjectAccess soa(Thread::Current());
-  StackHandleScope<1> hs(soa.Self());
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
-  MutableHandle<mirror::DexCache> dex_cache(hs.NewHandle<mirror::DexCache>(nullptr));
   size_t num_instructions = 0u;
 
   for (const DexFile* dex_file : dex_files) {
-    dex_cache.Assign(class_linker->FindDexCache(soa.Self(), *dex_file));
     TimingLogger::ScopedTiming t("Resolve const-string Strings", timings);
 
     ProfileCompilationInfo::ProfileIndexType profile_index =
@@ -622,12 +801,23 @@ void CompilerDriver::ResolveConstStrings(const std::vector<const DexFile*>& dex_
       }
     }
 
-    // TODO: Implement a profile-based filter for the boot image. See b/76145463.
-    for (ClassAccessor accessor : dex_file->GetClasses()) {
+    // Collect the const-string indices of each class in parallel. The strings are then resolved
+    // sequentially in class and instruction order, so that the allocation order does not depend
+    // on the number of threads and the image stays deterministic.
+    std::vector<std::vector<dex::StringIndex>> string_indices(dex_file->NumClassDefs());
+    ParallelCompilationManager context(class_linker,
+                                       /* class_loader= */ nullptr,
+                                       this,
+                                       dex_file,
+                                       dex_files,
+                                       parallel_thread_pool_.get());
+    auto collect = [&](size_t class_def_index) {
+      // TODO: Implement a profile-based filter for the boot image. See b/76145463.
+      ClassAccessor accessor(*dex_file, class_def_index);
       // Skip methods that failed to verify since they may contain invalid Dex code.
-      if (GetClassStatus(ClassReference(dex_file, accessor.GetClassDefIndex())) <
+      if (GetClassStatus(ClassReference(dex_file, class_def_index)) <
           ClassStatus::kRetryVerificationAtRuntime) {
-        continue;
+        return;
       }
 
       for (const ClassAccessor::Method& method : accessor.GetMethods()) {
@@ -651,10 +841,6 @@ void CompilerDriver::ResolveConstStrings(const std::vector<const DexFile*>& dex_
           }
         }
 
-        // Resolve const-strings in the code. Done to have deterministic allocation behavior. Right
-        // now this is single-threaded for simplicity.
-        // TODO: Collect the relevant string indices in parallel, then allocate them sequentially
-        // in a stable order.
         for (const DexInstructionPcPair& inst : method.GetInstructions()) {
           switch (inst->Opcode()) {
             case Instruction::CONST_STRING:
@@ -662,9 +848,7 @@ void CompilerDriver::ResolveConstStrings(const std::vector<const DexFile*>& dex_
               dex::StringIndex string_index((inst->Opcode() == Instruction::CONST_STRING)
                   ? inst->VRegB_21c()
                   : inst->VRegB_31c());
-              ObjPtr<mirror::String> string = class_linker->ResolveString(string_index, dex_cache);
-              CHECK(string != nullptr) << "Could not allocate a string when forcing determinism";
-              ++num_instructions;
+              string_indices[class_def_index].push_back(string_index);
               break;
             }
 
@@ -673,22 +857,31 @@ void CompilerDriver::ResolveConstStrings(const std::vector<const DexFile*>& dex_
           }
         }
       }
+    };
+    context.ForAllLambda(0, dex_file->NumClassDefs(), collect, parallel_thread_count_);
+
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::DexCache> dex_cache =
+        hs.NewHandle(class_linker->FindDexCache(soa.Self(), *dex_file));
+    for (const std::vector<dex::StringIndex>& class_string_indices : string_indices) {
+      for (dex::StringIndex string_index : class_string_indices) {
+        ObjPtr<mirror::String> string = class_linker->ResolveString(string_index, dex_cache);
+        CHECK(string != nullptr) << "Could not allocate a string when forcing determinism";
+      }
+      num_instructions += class_string_indices.size();
     }
   }
   VLOG(compiler) << "Resolved " << num_instructions << " const string instructions";
 }
 
-// Initialize type check bit strings for check-cast and instance-of in the code. Done to have
-// deterministic allocation behavior. Right now this is single-threaded for simplicity.
-// TODO: Collect the relevant type indices in parallel, then process them sequentially in a
-//       stable order.
-
-static void InitializeTypeCheckBitstrings(CompilerDriver* driver,
-                                          ClassLinker* class_linker,
-                                          Handle<mirror::DexCache> dex_cache,
-                                          const DexFile& dex_file,
-                                          const ClassAccessor::Method& method)
-      REQUIRES_SHARED(Locks::mutator_lock_) {
+// Collect the type indices of check-cast and instance-of in the code whose type check bit
+// strings need to be initialized. This does not need the mutator lock, so that it can run
+// in parallel.
+static void CollectTypeCheckBitstringIndices(CompilerDriver* driver,
+                                             const DexFile& dex_file,
+                                             const ClassAccessor::Method& method,
+                                             std::vector<dex::TypeIndex>* type_indices) {
   for (const DexInstructionPcPair& inst : method.GetInstructions()) {
     switch (inst->Opcode()) {
       case Instruction::CHECK_CAST:
@@ -701,16 +894,7 @@ static void InitializeTypeCheckBitstrings(CompilerDriver* driver,
         // And we cannot use it for classes outside the boot image as we do not know the runtime
         // value of their bitstring when compiling (it may not even get assigned at runtime).
         if (descriptor[0] == 'L' && driver->GetCompilerOptions().IsImageClass(descriptor)) {
-          ObjPtr<mirror::Class> klass =
-              class_linker->LookupResolvedType(type_index,
-                                               dex_cache.Get(),
-                                               /* class_loader= */ nullptr);
-          CHECK(klass != nullptr) << descriptor << " should have been previously resolved.";
-          // Now assign the bitstring if the class is not final. Keep this in sync with sharpening.
-          if (!klass->IsFinal()) {
-            MutexLock subtype_check_lock(Thread::Current(), *Locks::subtype_check_lock_);
-            SubtypeCheck<ObjPtr<mirror::Class>>::EnsureAssigned(klass);
-          }
+          type_indices->push_back(type_index);
         }
         break;
       }
@@ -721,22 +905,53 @@ static void InitializeTypeCheckBitstrings(CompilerDriver* driver,
   }
 }
 
+// Initialize type check bit strings for check-cast and instance-of in the code. Done to have
+// deterministic allocation behavior: the relevant type indices are collected in parallel, then
+// the bitstrings are assigned sequentially in class and instruction order.
 static void InitializeTypeCheckBitstrings(CompilerDriver* driver,
                                           const std::vector<const DexFile*>& dex_files,
+                                          ThreadPool* thread_pool,
+                                          size_t thread_count,
                                           TimingLogger* timings) {
-  ScopedObjectAccess soa(Thread::Current());
-  StackHandleScope<1> hs(soa.Self());
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
-  MutableHandle<mirror::DexCache> dex_cache(hs.NewHandle<mirror::DexCache>(nullptr));
 
   for (const DexFile* dex_file : dex_files) {
-    dex_cache.Assign(class_linker->FindDexCache(soa.Self(), *dex_file));
     TimingLogger::ScopedTiming t("Initialize type check bitstrings", timings);
 
-    for (ClassAccessor accessor : dex_file->GetClasses()) {
+    std::vector<std::vector<dex::TypeIndex>> type_indices(dex_file->NumClassDefs());
+    ParallelCompilationManager context(class_linker,
+                                       /* class_loader= */ nullptr,
+                                       driver,
+                                       dex_file,
+                                       dex_files,
+                                       thread_pool);
+    auto collect = [&](size_t class_def_index) {
+      ClassAccessor accessor(*dex_file, class_def_index);
       // Direct and virtual methods.
       for (const ClassAccessor::Method& method : accessor.GetMethods()) {
-        InitializeTypeCheckBitstrings(driver, class_linker, dex_cache, *dex_file, method);
+        CollectTypeCheckBitstringIndices(
+            driver, *dex_file, method, &type_indices[class_def_index]);
+      }
+    };
+    context.ForAllLambda(0, dex_file->NumClassDefs(), collect, thread_count);
+
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::DexCache> dex_cache =
+        hs.NewHandle(class_linker->FindDexCache(soa.Self(), *dex_file));
+    for (const std::vector<dex::TypeIndex>& class_type_indices : type_indices) {
+      for (dex::TypeIndex type_index : class_type_indices) {
+        ObjPtr<mirror::Class> klass =
+            class_linker->LookupResolvedType(type_index,
+                                             dex_cache.Get(),
+                                             /* class_loader= */ nullptr);
+        CHECK(klass != nullptr) << dex_file->StringByTypeIdx(type_index)
+                                << " should have been previously resolved.";
+        // Now assign the bitstring if the class is not final. Keep this in sync with sharpening.
+        if (!klass->IsFinal()) {
+          MutexLock subtype_check_lock(soa.Self(), *Locks::subtype_check_lock_);
+          SubtypeCheck<ObjPtr<mirror::Class>>::EnsureAssigned(klass);
+        }
       }
     }
   }
@@ -926,7 +1141,8 @@ void CompilerDriver::PreCompile(jobject class_loader,
       // Do this now to have a deterministic image.
       // Note: This is done after UpdateImageClasses() at it relies on the image
       // classes to be final.
-      InitializeTypeCheckBitstrings(this, dex_files, timings);
+      InitializeTypeCheckBitstrings(
+          this, dex_files, parallel_thread_pool_.get(), parallel_thread_count_, timings);
     }
   }
 }
@@ -1437,125 +1653,6 @@ bool CompilerDriver::ComputeInstanceFieldInfo(uint32_t field_idx, const DexCompi
   }
 }
 
-class CompilationVisitor {
- public:
-  virtual ~CompilationVisitor() {}
-  virtual void Visit(size_t index) = 0;
-};
-
-class ParallelCompilationManager {
- public:
-  ParallelCompilationManager(ClassLinker* class_linker,
-                             jobject class_loader,
-                             CompilerDriver* compiler,
-                             const DexFile* dex_file,
-                             const std::vector<const DexFile*>& dex_files,
-                             ThreadPool* thread_pool)
-    : index_(0),
-      class_linker_(class_linker),
-      class_loader_(class_loader),
-      compiler_(compiler),
-      dex_file_(dex_file),
-      dex_files_(dex_files),
-      thread_pool_(thread_pool) {}
-
-  ClassLinker* GetClassLinker() const {
-    CHECK(class_linker_ != nullptr);
-    return class_linker_;
-  }
-
-  jobject GetClassLoader() const {
-    return class_loader_;
-  }
-
-  CompilerDriver* GetCompiler() const {
-    CHECK(compiler_ != nullptr);
-    return compiler_;
-  }
-
-  const DexFile* GetDexFile() const {
-    CHECK(dex_file_ != nullptr);
-    return dex_file_;
-  }
-
-  const std::vector<const DexFile*>& GetDexFiles() const {
-    return dex_files_;
-  }
-
-  void ForAll(size_t begin, size_t end, CompilationVisitor* visitor, size_t work_units)
-      REQUIRES(!*Locks::mutator_lock_) {
-    ForAllLambda(begin, end, [visitor](size_t index) { visitor->Visit(index); }, work_units);
-  }
-
-  template <typename Fn>
-  void ForAllLambda(size_t begin, size_t end, Fn fn, size_t work_units)
-      REQUIRES(!*Locks::mutator_lock_) {
-    Thread* self = Thread::Current();
-    self->AssertNoPendingException();
-    CHECK_GT(work_units, 0U);
-
-    index_.store(begin, std::memory_order_relaxed);
-    for (size_t i = 0; i < work_units; ++i) {
-      thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn));
-    }
-    thread_pool_->StartWorkers(self);
-
-    // Ensure we're suspended while we're blocked waiting for the other threads to finish (worker
-    // thread destructor's called below perform join).
-    CHECK_NE(self->GetState(), ThreadState::kRunnable);
-
-    // Wait for all the worker threads to finish.
-    thread_pool_->Wait(self, true, false);
-
-    // And stop the workers accepting jobs.
-    thread_pool_->StopWorkers(self);
-  }
-
-  size_t NextIndex() {
-    return index_.fetch_add(1, std::memory_order_seq_cst);
-  }
-
- private:
-  template <typename Fn>
-  class ForAllClosureLambda : public Task {
-   public:
-    ForAllClosureLambda(ParallelCompilationManager* manager, size_t end, Fn fn)
-        : manager_(manager),
-          end_(end),
-          fn_(fn) {}
-
-    void Run(Thread* self) override {
-      while (true) {
-        const size_t index = manager_->NextIndex();
-        if (UNLIKELY(index >= end_)) {
-          break;
-        }
-        fn_(index);
-        self->AssertNoPendingException();
-      }
-    }
-
-    void Finalize() override {
-      delete this;
-    }
-
-   private:
-    ParallelCompilationManager* const manager_;
-    const size_t end_;
-    Fn fn_;
-  };
-
-  AtomicInteger index_;
-  ClassLinker* const class_linker_;
-  const jobject class_loader_;
-  CompilerDriver* const compiler_;
-  const DexFile* const dex_file_;
-  const std::vector<const DexFile*>& dex_files_;
-  ThreadPool* const thread_pool_;
-
-  DISALLOW_COPY_AND_ASSIGN(ParallelCompilationManager);
-};
-
 // A fast version of SkipClass above if the class pointer is available
 // that avoids the expensive FindInClassPath search.
 static bool SkipClass(jobject class_loader, const DexFile& dex_file, ObjPtr<mirror::Class> klass)
@@ -2589,6 +2686,23 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// Returns the class def indexes of `dex_file`, sorted by decreasing number of code units, as
+// an estimate of the time needed to compile each class.
+static std::vector<uint32_t> GetClassDefsByDecreasingCodeSize(const DexFile& dex_file) {
+  std::vector<uint32_t> code_units(dex_file.NumClassDefs(), 0u);
+  for (ClassAccessor accessor : dex_file.GetClasses()) {
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      code_units[accessor.GetClassDefIndex()] += method.GetInstructions().InsnsSizeInCodeUnits();
+    }
+  }
+  std::vector<uint32_t> order(dex_file.NumClassDefs());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(), [&code_units](uint32_t lhs, uint32_t rhs) {
+    return code_units[lhs] > code_units[rhs];
+  });
+  return order;
+}
+
 template <typename CompileFn>
 static void CompileDexFile(CompilerDriver* driver,
                            jobject class_loader,
@@ -2679,7 +2793,21 @@ static void CompileDexFile(CompilerDriver* driver,
                  profile_index);
     }
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  if (thread_count == 1u) {
+    context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+    return;
+  }
+
+  // Compile the largest classes first. Threads taking the next class from a shared index
+  // then balance the load, instead of a few large classes at the end keeping one thread
+  // busy while the others are idle.
+  context.ForAllLambdaInOrder(GetClassDefsByDecreasingCodeSize(dex_file), compile, thread_count);
+  if (VLOG_IS_ON(compiler)) {
+    const std::vector<uint64_t>& busy_times = context.GetBusyTimes();
+    auto [min_time, max_time] = std::minmax_element(busy_times.begin(), busy_times.end());
+    VLOG(compiler) << timing_name << " " << dex_file.GetLocation() << ": thread busy time "
+                   << PrettyDuration(*min_time) << " to " << PrettyDuration(*max_time);
+  }
 }
 
 void CompilerDriver::Compile(jobject class_loader,
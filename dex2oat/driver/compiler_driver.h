@@ -37,6 +37,7 @@
 #include "dex/dex_file_types.h"
 #include "dex/method_reference.h"
 #include "driver/compiled_method_storage.h"
+#include "oat/jni_stub_hash_map.h"
 #include "thread_pool.h"
 #include "utils/atomic_dex_ref_map.h"
 
@@ -226,6 +227,14 @@ class CompilerDriver {
     return &compiled_method_storage_;
   }
 
+  // Compile a JNI stub for the native method, or reuse the code of a stub already compiled
+  // for another method with a matching `JniStubKey` if there is one. Thread-safe.
+  CompiledMethod* CompileJniStub(uint32_t access_flags,
+                                 uint32_t method_idx,
+                                 const DexFile& dex_file,
+                                 Handle<mirror::DexCache> dex_cache)
+      REQUIRES(!jni_stubs_lock_);
+
  private:
   void LoadImageClasses(TimingLogger* timings, /*inout*/ HashSet<std::string>* image_classes)
       REQUIRES(!Locks::mutator_lock_);
@@ -332,6 +341,11 @@ class CompilerDriver {
 
   CompiledMethodStorage compiled_method_storage_;
 
+  // JNI stubs compiled so far, for sharing them between native methods. The compiled
+  // methods are owned by `compiled_methods_`.
+  Mutex jni_stubs_lock_;
+  JniStubHashMap<const CompiledMethod*> jni_stubs_ GUARDED_BY(jni_stubs_lock_);
+
   size_t max_arena_alloc_;
 
   friend class CommonCompilerDriverTest;
@@ -65,7 +65,9 @@ class ElfWriter {
                                      size_t bss_methods_offset,
                                      size_t bss_roots_offset,
                                      size_t dex_section_size) = 0;
-  virtual void PrepareDebugInfo(const debug::DebugInfo& debug_info) = 0;
+  // Starts generating the mini-debug-info in the background, compressing it on up to
+  // `thread_count` threads.
+  virtual void PrepareDebugInfo(const debug::DebugInfo& debug_info, size_t thread_count) = 0;
   virtual OutputStream* StartRoData() = 0;
   virtual void EndRoData(OutputStream* rodata) = 0;
   virtual OutputStream* StartText() = 0;
@@ -17,6 +17,7 @@
 #include "elf_writer_quick.h"
 
 #include <memory>
+#include <vector>
 #include <openssl/sha.h>
 
 #include <android-base/logging.h>
@@ -30,6 +31,7 @@
 #include "driver/compiler_options.h"
 #include "elf/elf_builder.h"
 #include "elf/elf_utils.h"
+#include "elf/xz_utils.h"
 #include "stream/buffered_output_stream.h"
 #include "stream/file_output_stream.h"
 #include "thread-current-inl.h"
@@ -46,27 +48,54 @@ class DebugInfoTask : public Task {
                 size_t text_section_size,
                 uint64_t dex_section_address,
                 size_t dex_section_size,
-                const debug::DebugInfo& debug_info)
+                const debug::DebugInfo& debug_info,
+                ThreadPool* thread_pool,
+                size_t thread_count)
       : isa_(isa),
         instruction_set_features_(features),
         text_section_address_(text_section_address),
         text_section_size_(text_section_size),
         dex_section_address_(dex_section_address),
         dex_section_size_(dex_section_size),
-        debug_info_(debug_info) {
+        debug_info_(debug_info),
+        thread_pool_(thread_pool),
+        thread_count_(thread_count) {
   }
 
-  void Run(Thread*) override {
-    result_ = debug::MakeMiniDebugInfo(isa_,
-                                       instruction_set_features_,
-                                       text_section_address_,
-                                       text_section_size_,
-                                       dex_section_address_,
-                                       dex_section_size_,
-                                       debug_info_);
+  void Run(Thread* self) override {
+    elf_file_ = debug::MakeMiniDebugInfoElfFile(isa_,
+                                                instruction_set_features_,
+                                                text_section_address_,
+                                                text_section_size_,
+                                                dex_section_address_,
+                                                dex_section_size_,
+                                                debug_info_);
+    // Compress the chunks on the other workers of the pool, and the first one on this thread.
+    // The pool's Wait() returns only once all of them are done.
+    std::vector<ArrayRef<const uint8_t>> chunks =
+        XzSplitIntoChunks(ArrayRef<const uint8_t>(elf_file_), thread_count_);
+    compressed_chunks_.resize(chunks.size());
+    for (size_t i = 1; i < chunks.size(); ++i) {
+      thread_pool_->AddTask(self, new FunctionTask([this, chunk = chunks[i], i](Thread*) {
+        XzCompress(chunk, &compressed_chunks_[i]);
+      }));
+    }
+    XzCompress(chunks[0], &compressed_chunks_[0]);
   }
 
+  // Must be called only after the thread pool finished all the tasks.
   std::vector<uint8_t>* GetResult() {
+    if (result_.empty()) {
+      if (compressed_chunks_.size() == 1u) {
+        result_.swap(compressed_chunks_[0]);
+      } else {
+        for (const std::vector<uint8_t>& compressed_chunk : compressed_chunks_) {
+          result_.insert(result_.end(), compressed_chunk.begin(), compressed_chunk.end());
+        }
+      }
+      compressed_chunks_.clear();
+      elf_file_.clear();
+    }
     return &result_;
   }
 
@@ -78,6 +107,10 @@ class DebugInfoTask : public Task {
   uint64_t dex_section_address_;
   size_t dex_section_size_;
   const debug::DebugInfo& debug_info_;
+  ThreadPool* const thread_pool_;
+  const size_t thread_count_;
+  std::vector<uint8_t> elf_file_;
+  std::vector<std::vector<uint8_t>> compressed_chunks_;
   std::vector<uint8_t> result_;
 };
 
@@ -96,7 +129,7 @@ class ElfWriterQuick final : public ElfWriter {
                              size_t bss_methods_offset,
                              size_t bss_roots_offset,
                              size_t dex_section_size) override;
-  void PrepareDebugInfo(const debug::DebugInfo& debug_info) override;
+  void PrepareDebugInfo(const debug::DebugInfo& debug_info, size_t thread_count) override;
   OutputStream* StartRoData() override;
   void EndRoData(OutputStream* rodata) override;
   OutputStream* StartText() override;
@@ -242,10 +275,13 @@ void ElfWriterQuick<ElfTypes>::WriteDynamicSection() {
 }
 
 template <typename ElfTypes>
-void ElfWriterQuick<ElfTypes>::PrepareDebugInfo(const debug::DebugInfo& debug_info) {
+void ElfWriterQuick<ElfTypes>::PrepareDebugInfo(const debug::DebugInfo& debug_info,
+                                                size_t thread_count) {
   if (compiler_options_.GetGenerateMiniDebugInfo()) {
     // Prepare the mini-debug-info in background while we do other I/O.
     Thread* self = Thread::Current();
+    DCHECK_NE(thread_count, 0u);
+    debug_info_thread_pool_.reset(ThreadPool::Create("Mini-debug-info writer", thread_count));
     debug_info_task_ = std::make_unique<DebugInfoTask>(
         builder_->GetIsa(),
         compiler_options_.GetInstructionSetFeatures(),
@@ -253,8 +289,9 @@ void ElfWriterQuick<ElfTypes>::PrepareDebugInfo(const debug::DebugInfo& debug_in
         text_size_,
         builder_->GetDex()->Exists() ? builder_->GetDex()->GetAddress() : 0,
         dex_section_size_,
-        debug_info);
-    debug_info_thread_pool_.reset(ThreadPool::Create("Mini-debug-info writer", 1));
+        debug_info,
+        debug_info_thread_pool_.get(),
+        thread_count);
     debug_info_thread_pool_->AddTask(self, debug_info_task_.get());
     debug_info_thread_pool_->StartWorkers(self);
   }
@@ -265,7 +302,7 @@ void ElfWriterQuick<ElfTypes>::WriteDebugInfo(const debug::DebugInfo& debug_info
   if (compiler_options_.GetGenerateMiniDebugInfo()) {
     // If mini-debug-info wasn't explicitly created so far, create it now (happens in tests).
     if (debug_info_task_ == nullptr) {
-      PrepareDebugInfo(debug_info);
+      PrepareDebugInfo(debug_info, /*thread_count=*/ 1u);
     }
     // Wait for the mini-debug-info generation to finish and write it to disk.
     Thread* self = Thread::Current();
@@ -22,6 +22,7 @@
 #include "base/utils.h"
 #include "common_compiler_driver_test.h"
 #include "elf/elf_builder.h"
+#include "elf/xz_utils.h"
 #include "elf_writer_quick.h"
 #include "oat/elf_file.h"
 #include "oat/elf_file_impl.h"
@@ -137,5 +138,41 @@ TEST_F(ElfWriterTest, CheckBuildIdPresent) {
   }
 }
 
+// The mini-debug-info is compressed in chunks on several threads. The concatenated xz streams
+// must decompress to the original data.
+TEST_F(ElfWriterTest, CompressMiniDebugInfoInChunks) {
+  std::vector<uint8_t> data(100 * KB);
+  for (size_t i = 0; i != data.size(); ++i) {
+    data[i] = static_cast<uint8_t>((i * 7u) ^ (i >> 9));
+  }
+  ArrayRef<const uint8_t> src(data);
+
+  std::vector<ArrayRef<const uint8_t>> chunks = XzSplitIntoChunks(src, /*max_chunks=*/ 4u);
+  ASSERT_EQ(chunks.size(), 4u);
+  std::vector<uint8_t> compressed;
+  size_t offset = 0u;
+  for (ArrayRef<const uint8_t> chunk : chunks) {
+    // Chunks are contiguous and, except for the last one, made of whole blocks.
+    EXPECT_EQ(chunk.data(), src.data() + offset);
+    EXPECT_TRUE(IsAligned<kXzDefaultBlockSize>(offset));
+    offset += chunk.size();
+    std::vector<uint8_t> compressed_chunk;
+    XzCompress(chunk, &compressed_chunk);
+    compressed.insert(compressed.end(), compressed_chunk.begin(), compressed_chunk.end());
+  }
+  EXPECT_EQ(offset, src.size());
+  std::vector<uint8_t> decompressed;
+  XzDecompress(ArrayRef<const uint8_t>(compressed), &decompressed);
+  EXPECT_EQ(decompressed, data);
+
+  // Data smaller than a block makes a single chunk.
+  EXPECT_EQ(XzSplitIntoChunks(src.SubArray(0u, kXzDefaultBlockSize), 4u).size(), 1u);
+  EXPECT_EQ(XzSplitIntoChunks(src, /*max_chunks=*/ 1u).size(), 1u);
+  std::vector<ArrayRef<const uint8_t>> empty_chunks =
+      XzSplitIntoChunks(ArrayRef<const uint8_t>(), 4u);
+  ASSERT_EQ(empty_chunks.size(), 1u);
+  EXPECT_TRUE(empty_chunks[0].empty());
+}
+
 }  // namespace linker
 }  // namespace art
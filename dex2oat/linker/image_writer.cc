@@ -402,7 +402,7 @@ static ObjPtr<mirror::ObjectArray<mirror::Object>> AllocateBootImageLiveObjects(
 template <typename MirrorType>
 ObjPtr<MirrorType> ImageWriter::DecodeGlobalWithoutRB(JavaVMExt* vm, jobject obj) {
   DCHECK_EQ(IndirectReferenceTable::GetIndirectRefKind(obj), kGlobal);
-  return ObjPtr<MirrorType>::DownCast(vm->globals_.Get<kWithoutReadBarrier>(obj));
+  return ObjPtr<MirrorType>::DownCast(vm->GetGlobalsShard(obj).Get<kWithoutReadBarrier>(obj));
 }
 
 template <typename MirrorType>
@@ -1528,7 +1528,9 @@ void ImageWriter::TryAssignConflictTableOffset(ImtConflictTable* table, size_t o
   CHECK(!IsInBootImage(table));
   // If the method is a conflict method we also want to assign the conflict table offset.
   ImageInfo& image_info = GetImageInfo(oat_index);
-  const size_t size = table->ComputeSize(target_ptr_size_);
+  // The copy in the image uses the linear layout.
+  const size_t size =
+      ImtConflictTable::ComputeSize(table->NumEntries(target_ptr_size_), target_ptr_size_);
   native_object_relocations_.insert(std::make_pair(
       table,
       NativeObjectRelocation{
@@ -2920,10 +2922,13 @@ void ImageWriter::CopyAndFixupImTable(ImTable* orig, ImTable* copy) {
 }
 
 void ImageWriter::CopyAndFixupImtConflictTable(ImtConflictTable* orig, ImtConflictTable* copy) {
-  const size_t count = orig->NumEntries(target_ptr_size_);
-  for (size_t i = 0; i < count; ++i) {
-    ArtMethod* interface_method = orig->GetInterfaceMethod(i, target_ptr_size_);
-    ArtMethod* implementation_method = orig->GetImplementationMethod(i, target_ptr_size_);
+  // The hash of a table with the hashed layout depends on the method addresses,
+  // so the `copy` always uses the linear layout.
+  size_t i = 0u;
+  orig->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods)
+                  REQUIRES_SHARED(Locks::mutator_lock_) {
+    ArtMethod* interface_method = methods.first;
+    ArtMethod* implementation_method = methods.second;
     CopyAndFixupPointer(copy->AddressOfInterfaceMethod(i, target_ptr_size_), interface_method);
     CopyAndFixupPointer(
         copy->AddressOfImplementationMethod(i, target_ptr_size_), implementation_method);
@@ -2931,7 +2936,10 @@ void ImageWriter::CopyAndFixupImtConflictTable(ImtConflictTable* orig, ImtConfli
               NativeLocationInImage(interface_method));
     DCHECK_EQ(copy->GetImplementationMethod(i, target_ptr_size_),
               NativeLocationInImage(implementation_method));
-  }
+    ++i;
+    return methods;
+  }, target_ptr_size_);
+  DCHECK_EQ(i, orig->NumEntries(target_ptr_size_));
 }
 
 void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
@@ -898,6 +898,12 @@ struct OatWriter::BssMappingInfo {
 //
 // See also OrderedMethodVisitor.
 struct OatWriter::OrderedMethodData {
+  // Hotness bits from the profile. The startup bit is the most significant one, so that
+  // all startup methods end up next to each other and the oat file can record their range.
+  static constexpr uint32_t kHotBit = 1u;
+  static constexpr uint32_t kPostStartupBit = 2u;
+  static constexpr uint32_t kStartupBit = 4u;
+
   uint32_t hotness_bits;
   OatClass* oat_class;
   CompiledMethod* compiled_method;
@@ -919,17 +925,15 @@ struct OatWriter::OrderedMethodData {
 
   // Bin each method according to the profile flags.
   //
-  // Groups by e.g.
+  // Groups by
   //  -- not hot at all
   //  -- hot
-  //  -- hot and startup
+  //  -- post-startup
   //  -- hot and post-startup
-  //  -- hot and startup and poststartup
   //  -- startup
+  //  -- hot and startup
   //  -- startup and post-startup
-  //  -- post-startup
-  //
-  // (See MethodHotness enum definition for up-to-date binning order.)
+  //  -- hot and startup and post-startup
   bool operator<(const OrderedMethodData& other) const {
     if (kOatWriterForceOatCodeLayout) {
       // Development flag: Override default behavior by sorting by name.
@@ -1065,10 +1069,11 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
         DCHECK(pci != nullptr);
         // Note: Bin-to-bin order does not matter. If the kernel does or does not read-ahead
         // any memory, it only goes into the buffer cache and does not grow the PSS until the
-        // first time that memory is referenced in the process.
-        constexpr uint32_t kHotBit = 1u;
-        constexpr uint32_t kStartupBit = 2u;
-        constexpr uint32_t kPostStartupBit = 4u;
+        // first time that memory is referenced in the process. The startup bins are only kept
+        // together so that the runtime can prefetch them, see `OatHeader::GetStartupCodeSize()`.
+        constexpr uint32_t kHotBit = OrderedMethodData::kHotBit;
+        constexpr uint32_t kStartupBit = OrderedMethodData::kStartupBit;
+        constexpr uint32_t kPostStartupBit = OrderedMethodData::kPostStartupBit;
         hotness_bits =
             (pci->IsHotMethod(profile_index_, method_index) ? kHotBit : 0u) |
             (pci->IsStartupMethod(profile_index_, method_index) ? kStartupBit : 0u) |
@@ -1109,6 +1114,9 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
       // Since most methods will have the same ordering criteria,
       // we preserve the original insertion order within the same sort order.
       std::stable_sort(ordered_methods_.begin(), ordered_methods_.end());
+      if (!kOatWriterForceOatCodeLayout) {
+        GroupCalleesWithCallers();
+      }
     } else {
       // The profile-less behavior is as if every method had 0 hotness
       // associated with it.
@@ -1122,6 +1130,66 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
   }
 
  private:
+  // Within each bin of profiled methods, place the methods that a method calls directly
+  // right after it, in call order, so that code running together shares pages and i-TLB
+  // entries. The direct calls are taken from the patches of the compiled code that load the
+  // callee's `ArtMethod` or call it directly. Methods without profile flags keep their
+  // original order.
+  void GroupCalleesWithCallers() {
+    SafeMap<MethodReference, size_t> method_indexes;
+    for (size_t i = 0; i != ordered_methods_.size(); ++i) {
+      if (ordered_methods_[i].hotness_bits != 0u) {
+        method_indexes.FindOrAdd(ordered_methods_[i].method_reference, i);
+      }
+    }
+    if (method_indexes.empty()) {
+      return;
+    }
+
+    OrderedMethodList grouped_methods;
+    grouped_methods.reserve(ordered_methods_.size());
+    std::vector<bool> placed(ordered_methods_.size(), false);
+    std::vector<size_t> worklist;
+    for (size_t i = 0; i != ordered_methods_.size(); ++i) {
+      if (placed[i]) {
+        continue;
+      }
+      worklist.push_back(i);
+      while (!worklist.empty()) {
+        size_t index = worklist.back();
+        worklist.pop_back();
+        if (placed[index]) {
+          continue;
+        }
+        placed[index] = true;
+        const OrderedMethodData& method_data = ordered_methods_[index];
+        grouped_methods.push_back(method_data);
+        if (method_data.hotness_bits == 0u) {
+          continue;
+        }
+        // Push the callees in reverse so that the first call is placed first.
+        ArrayRef<const LinkerPatch> patches = method_data.compiled_method->GetPatches();
+        for (auto it = patches.rbegin(); it != patches.rend(); ++it) {
+          // Invoked methods are loaded from .bss in app code and through relative method
+          // references in the boot image.
+          if (it->GetType() != LinkerPatch::Type::kMethodBssEntry &&
+              it->GetType() != LinkerPatch::Type::kMethodRelative &&
+              it->GetType() != LinkerPatch::Type::kCallRelative) {
+            continue;
+          }
+          auto callee = method_indexes.find(it->TargetMethod());
+          if (callee != method_indexes.end() &&
+              !placed[callee->second] &&
+              ordered_methods_[callee->second].hotness_bits == method_data.hotness_bits) {
+            worklist.push_back(callee->second);
+          }
+        }
+      }
+    }
+    DCHECK_EQ(grouped_methods.size(), ordered_methods_.size());
+    ordered_methods_ = std::move(grouped_methods);
+  }
+
   // Cached profile index for the current dex file.
   ProfileCompilationInfo::ProfileIndexType profile_index_;
   const DexFile* profile_index_dex_file_;
@@ -1222,9 +1290,18 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
     *method_header = OatQuickMethodHeader(code_info_offset);
 
     if (!deduped) {
+      if ((method_data.hotness_bits & OrderedMethodData::kStartupBit) != 0u) {
+        if (startup_code_end_ == 0u) {
+          startup_code_begin_ = code_offset - sizeof(*method_header);
+        }
+        startup_code_end_ = code_offset + code_size;
+      }
       // Update offsets. (Checksum is updated when writing.)
       offset_ += sizeof(*method_header);  // Method header is prepended before code.
       offset_ += code_size;
+    } else {
+      writer_->num_deduped_methods_ += 1u;
+      writer_->size_deduped_code_ += sizeof(*method_header) + code_size;
     }
 
     // Exclude dex methods without native code.
@@ -1268,6 +1345,15 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
     return offset_;
   }
 
+  // The range of the code of startup methods, which are laid out next to each other.
+  uint32_t GetStartupCodeBegin() const {
+    return startup_code_begin_;
+  }
+
+  uint32_t GetStartupCodeSize() const {
+    return startup_code_end_ - startup_code_begin_;
+  }
+
  private:
   LayoutReserveOffsetCodeMethodVisitor(OatWriter* writer,
                                        size_t offset,
@@ -1317,6 +1403,10 @@ class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisi
   // Offset of the code of the compiled methods.
   size_t offset_;
 
+  // Range of the code of the compiled startup methods.
+  uint32_t startup_code_begin_ = 0u;
+  uint32_t startup_code_end_ = 0u;
+
   // Deduplication is already done on a pointer basis by the compiler driver,
   // so we can simply compare the pointers to find out if things are duplicated.
   SafeMap<const CompiledMethod*, uint32_t, CodeOffsetsKeyComparator> dedupe_map_;
@@ -2318,6 +2408,8 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
     success = layout_reserve_code_visitor.Visit();
     DCHECK(success);
     offset = layout_reserve_code_visitor.GetOffset();
+    oat_header_->SetStartupCodeRange(layout_reserve_code_visitor.GetStartupCodeBegin(),
+                                     layout_reserve_code_visitor.GetStartupCodeSize());
 
     // Save the method order because the WriteCodeMethodVisitor will need this
     // order again.
@@ -2679,6 +2771,9 @@ bool OatWriter::CheckOatSize(OutputStream* out, size_t file_offset, size_t relat
     CHECK_EQ(file_offset + size_total - vdex_size_, static_cast<size_t>(oat_end_file_offset));
   }
 
+  VLOG(compiler) << "Deduplicated code of " << num_deduped_methods_ << " methods, saving "
+                 << PrettySize(size_deduped_code_) << " (" << size_deduped_code_ << "B)";
+
   CHECK_EQ(file_offset + oat_size_, static_cast<size_t>(oat_end_file_offset));
   CHECK_EQ(oat_size_, relative_offset);
 
@@ -574,6 +574,11 @@ class OatWriter {
   uint32_t size_string_bss_mappings_ = 0;
   uint32_t size_method_type_bss_mappings_ = 0;
 
+  // Methods whose code is shared with another method, and the code size this saves.
+  // Not part of the file size, so not included in the stats above.
+  uint32_t num_deduped_methods_ = 0;
+  uint32_t size_deduped_code_ = 0;
+
   // The helper for processing relative patches is external so that we can patch across oat files.
   MultiOatRelativePatcher* relative_patcher_;
 
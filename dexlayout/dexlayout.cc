@@ -1872,18 +1872,55 @@ void DexLayout::DumpDexFile() {
   }
 }
 
+// Returns whether the profile says that `class_data` has code which runs during startup.
+// Static initializers of profile classes are assumed to run during startup.
+static bool HasStartupMethods(const DexFile* dex_file,
+                              const ProfileCompilationInfo* info,
+                              bool is_profile_class,
+                              dex_ir::ClassData* class_data) {
+  if (class_data == nullptr) {
+    return false;
+  }
+  for (size_t i = 0; i < 2; ++i) {
+    for (auto& method : *(i == 0 ? class_data->DirectMethods() : class_data->VirtualMethods())) {
+      const bool is_clinit = (method.GetAccessFlags() & kAccConstructor) != 0 &&
+          (method.GetAccessFlags() & kAccStatic) != 0;
+      if ((is_profile_class && is_clinit) ||
+          info->GetMethodHotness(
+              MethodReference(dex_file, method.GetMethodId()->GetIndex())).IsStartup()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void DexLayout::LayoutClassDefsAndClassData(const DexFile* dex_file) {
-  std::vector<dex_ir::ClassDef*> new_class_def_order;
+  // Order the classes that run code during startup first, then the other classes of the
+  // profile, and then the rest, so that the class data read at startup shares few pages.
+  static constexpr size_t kStartupClass = 0u;
+  static constexpr size_t kProfileClass = 1u;
+  static constexpr size_t kOtherClass = 2u;
+  std::vector<size_t> class_def_kinds;
+  class_def_kinds.reserve(header_->ClassDefs().Size());
   for (auto& class_def : header_->ClassDefs()) {
     dex::TypeIndex type_idx(class_def->ClassType()->GetIndex());
-    if (info_->ContainsClass(*dex_file, type_idx)) {
-      new_class_def_order.push_back(class_def.get());
+    const bool is_profile_class = info_->ContainsClass(*dex_file, type_idx);
+    if (HasStartupMethods(dex_file, info_, is_profile_class, class_def->GetClassData())) {
+      class_def_kinds.push_back(kStartupClass);
+    } else {
+      class_def_kinds.push_back(is_profile_class ? kProfileClass : kOtherClass);
     }
   }
-  for (auto& class_def : header_->ClassDefs()) {
-    dex::TypeIndex type_idx(class_def->ClassType()->GetIndex());
-    if (!info_->ContainsClass(*dex_file, type_idx)) {
-      new_class_def_order.push_back(class_def.get());
+  std::vector<dex_ir::ClassDef*> new_class_def_order;
+  new_class_def_order.reserve(class_def_kinds.size());
+  for (size_t kind : {kStartupClass, kProfileClass, kOtherClass}) {
+    size_t class_def_index = 0;
+    for (auto& class_def : header_->ClassDefs()) {
+      if (class_def_kinds[class_def_index] == kind) {
+        new_class_def_order.push_back(class_def.get());
+      }
+      ++class_def_index;
     }
   }
   std::unordered_set<dex_ir::ClassData*> visited_class_data;
@@ -589,6 +589,13 @@ DISASSEMBLER_ENTRY(cmp,
               load = true;
               src_reg_file = dst_reg_file = SSE;
               break;
+            case 0x17:
+              opcode1 = "ptest";
+              prefix[2] = 0;
+              has_modrm = true;
+              load = true;
+              src_reg_file = dst_reg_file = SSE;
+              break;
             case 0x29:
               opcode1 = "pcmpeqq";
               prefix[2] = 0;
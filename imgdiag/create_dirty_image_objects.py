@@ -15,8 +15,10 @@
 # limitations under the License.
 
 import argparse
+from collections import Counter
 from collections import defaultdict
 from enum import Enum
+import json
 import os
 import re
 
@@ -102,6 +104,27 @@ def process_dirty_entries(entries, sort_type):
   return (dirty_obj_lines, sort_keys)
 
 
+def create_report(file_lines):
+  """Sums dirty object counts by class and by dirty field over all processes."""
+
+  def count_prefixed(lines, prefix):
+    return Counter(l.strip().removeprefix(prefix) for l in lines if prefix in l)
+
+  report = {'processes': [os.path.basename(path) for path, _ in file_lines]}
+  for key, prefix in (('classes', 'dirty_obj_class: '), ('fields', 'dirty_field: ')):
+    objects = Counter()
+    processes = Counter()
+    for _, lines in file_lines:
+      counts = count_prefixed(lines, prefix)
+      objects.update(counts)
+      processes.update(counts.keys())
+    report[key] = [
+        {'name': name, 'objects': count, 'processes': processes[name]}
+        for name, count in objects.most_common()
+    ]
+  return report
+
+
 def main():
   parser = argparse.ArgumentParser(
       description=(
@@ -138,6 +161,14 @@ def main():
       default='dirty-image-objects.txt',
       help='Output file for dirty image objects.',
   )
+  parser.add_argument(
+      '--report-filename',
+      default=None,
+      help=(
+          'If set, also write a JSON report with dirty object counts by class'
+          ' and by field, and the number of processes they are dirty in.'
+      ),
+  )
   parser.add_argument(
       '--print-stats',
       action=argparse.BooleanOptionalAction,
@@ -148,9 +179,11 @@ def main():
   args = parser.parse_args()
 
   entries = list()
+  file_lines = list()
   for path in args.imgdiag_files:
     with open(path) as f:
       lines = f.readlines()
+    file_lines.append((path, lines))
     prefix = 'dirty_obj: '
     lines = [l.strip().removeprefix(prefix) for l in lines if prefix in l]
     entries.append((path, set(lines)))
@@ -172,6 +205,10 @@ def main():
   with open(args.output_filename, 'w') as f:
     f.writelines(dirty_image_objects)
 
+  if args.report_filename:
+    with open(args.report_filename, 'w') as f:
+      json.dump(create_report(file_lines), f, indent=2)
+
   if args.print_stats:
     print(','.join(k for k, v in entries), ',obj_count')
     total_count = 0
@@ -636,6 +636,7 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
     }
     std::string path_from_root = GetPathFromClass(entry, parent_map_);
     os_ << "dirty_obj: " << path_from_root << "\n";
+    os_ << "dirty_obj_class: " << klass->GetDescriptor(&temp) << "\n";
     PrintEntryPages(reinterpret_cast<uintptr_t>(entry), EntrySize(entry), os_);
 
     std::unordered_set<ArtField*> dirty_instance_fields;
@@ -681,6 +682,7 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
         os_ << tabs << ArtField::PrettyField(field)
             << " original=" << PrettyFieldValue(field, entry)
             << " remote=" << PrettyFieldValue(field, remote_entry) << "\n";
+        os_ << "dirty_field: " << ArtField::PrettyField(field) << "\n";
       }
     }
     if (!dirty_static_fields.empty()) {
@@ -692,6 +694,7 @@ class RegionSpecializedBase<mirror::Object> : public RegionCommon<mirror::Object
         os_ << tabs << ArtField::PrettyField(field)
             << " original=" << PrettyFieldValue(field, entry)
             << " remote=" << PrettyFieldValue(field, remote_entry) << "\n";
+        os_ << "dirty_field: " << ArtField::PrettyField(field) << "\n";
       }
     }
     os_ << "\n";
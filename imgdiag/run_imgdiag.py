@@ -16,13 +16,14 @@
 
 import argparse
 from collections import namedtuple
+from concurrent.futures import ThreadPoolExecutor
 import subprocess
 
 try:
   from tqdm import tqdm
 except:
 
-  def tqdm(x):
+  def tqdm(x, **kwargs):
     return x
 
 
@@ -95,6 +96,12 @@ def main():
       default='./',
       help='Directory for imgdiag output files on the host.',
   )
+  parser.add_argument(
+      '--jobs',
+      type=int,
+      default=4,
+      help='Number of imgdiag processes to run on the device at the same time.',
+  )
 
   args = parser.parse_args()
 
@@ -125,7 +132,7 @@ def main():
   )
   subprocess.run(args=f'mkdir -p {args.host_out_dir}', check=True, shell=True)
 
-  for entry in tqdm(zygote_children):
+  def run(entry):
     get_mem_stats(
         zygote_pid=entry.ppid,
         target_pid=entry.pid,
@@ -136,6 +143,10 @@ def main():
         host_out_dir=args.host_out_dir,
     )
 
+  # Each imgdiag call mostly waits on the device, so run several at once.
+  with ThreadPoolExecutor(max_workers=max(args.jobs, 1)) as executor:
+    list(tqdm(executor.map(run, zygote_children), total=len(zygote_children)))
+
 
 if __name__ == '__main__':
   main()
@@ -179,11 +179,15 @@ class ArenaAllocatorMemoryTool {
 
 class Arena {
  public:
-  Arena() : bytes_allocated_(0), memory_(nullptr), size_(0), next_(nullptr) {}
+  Arena()
+      : bytes_allocated_(0), dirty_bytes_(0), memory_(nullptr), size_(0), next_(nullptr) {}
 
   virtual ~Arena() { }
   // Reset is for pre-use and uses memset for performance.
   void Reset();
+  // Like Reset() but for users that do not need zero-initialized memory. The memory left
+  // over from previous uses is only cleared by the next Reset().
+  void ResetUninitialized();
   // Release is used inbetween uses and uses madvise for memory usage.
   virtual void Release() { }
   uint8_t* Begin() const {
@@ -211,6 +215,9 @@ class Arena {
 
  protected:
   size_t bytes_allocated_;
+  // Size of the memory at the start of the arena that was used before the last
+  // ResetUninitialized() and has not been cleared yet.
+  size_t dirty_bytes_;
   uint8_t* memory_;
   size_t size_;
   Arena* next_;
@@ -232,6 +239,10 @@ class ArenaPool {
   virtual ~ArenaPool() = default;
 
   virtual Arena* AllocArena(size_t size) = 0;
+  // Allocate an arena whose memory does not need to be zero-initialized.
+  virtual Arena* AllocUninitializedArena(size_t size) {
+    return AllocArena(size);
+  }
   virtual void FreeArenaChain(Arena* first) = 0;
   virtual size_t GetBytesAllocated() const = 0;
   virtual void ReclaimMemory() = 0;
@@ -20,6 +20,7 @@
 #include "gtest/gtest.h"
 #include "malloc_arena_pool.h"
 #include "memory_tool.h"
+#include "scoped_arena_allocator.h"
 
 namespace art {
 
@@ -349,5 +350,32 @@ TEST_F(ArenaAllocatorTest, ReallocAlignment) {
   }
 }
 
+TEST_F(ArenaAllocatorTest, ZeroedAfterUninitializedReuse) {
+  if (arena_allocator::kArenaAllocatorPreciseTracking) {
+    printf("WARNING: TEST DISABLED FOR precise arena tracking\n");
+    return;
+  }
+
+  MallocArenaPool pool;
+  static constexpr size_t kSize = 1024;
+  {
+    // Dirty an arena through an allocator that does not need zero-initialized memory.
+    ArenaStack arena_stack(&pool);
+    ScopedArenaAllocator allocator(&arena_stack);
+    memset(allocator.Alloc(kSize), 0xff, kSize);
+  }
+  {
+    // Reuse the arena without clearing it and dirty it only partially.
+    ArenaStack arena_stack(&pool);
+    ScopedArenaAllocator allocator(&arena_stack);
+    memset(allocator.Alloc(kSize / 2), 0xaa, kSize / 2);
+  }
+  // The ArenaAllocator must still see all of the memory zeroed.
+  ArenaAllocator allocator(&pool);
+  uint8_t* data = allocator.AllocArray<uint8_t>(kSize);
+  for (size_t i = 0; i != kSize; ++i) {
+    ASSERT_EQ(0u, data[i]) << i;
+  }
+}
 
 }  // namespace art
@@ -120,9 +120,10 @@ void BitVector::Intersect(const BitVector* src) {
   // Get the minimum size between us and source.
   uint32_t min_size = (storage_size_ < src_storage_size) ? storage_size_ : src_storage_size;
 
+  const uint32_t* src_storage = src->GetRawStorage();
   uint32_t idx;
   for (idx = 0; idx < min_size; idx++) {
-    storage_[idx] &= src->GetRawStorageWord(idx);
+    storage_[idx] &= src_storage[idx];
   }
 
   // Now, due to this being an intersection, there are two possibilities:
@@ -157,15 +158,16 @@ bool BitVector::Union(const BitVector* src) {
     DCHECK_LT(static_cast<uint32_t> (highest_bit), storage_size_ * kWordBits);
   }
 
+  // Accumulate the new bits instead of branching on each word, so that the loop vectorizes.
+  const uint32_t* src_storage = src->GetRawStorage();
+  uint32_t new_bits = 0u;
   for (uint32_t idx = 0; idx < src_size; idx++) {
     uint32_t existing = storage_[idx];
-    uint32_t update = existing | src->GetRawStorageWord(idx);
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+    uint32_t update = existing | src_storage[idx];
+    new_bits |= update ^ existing;
+    storage_[idx] = update;
   }
-  return changed;
+  return changed || new_bits != 0u;
 }
 
 bool BitVector::UnionIfNotIn(const BitVector* union_with, const BitVector* not_in) {
@@ -191,26 +193,25 @@ bool BitVector::UnionIfNotIn(const BitVector* union_with, const BitVector* not_i
 
   uint32_t not_in_size = not_in->GetStorageSize();
 
+  // As in Union(), accumulate the new bits so that the loops vectorize.
+  const uint32_t* union_with_storage = union_with->GetRawStorage();
+  const uint32_t* not_in_storage = not_in->GetRawStorage();
+  uint32_t new_bits = 0u;
   uint32_t idx = 0;
-  for (; idx < std::min(not_in_size, union_with_size); idx++) {
+  for (uint32_t end = std::min(not_in_size, union_with_size); idx < end; idx++) {
     uint32_t existing = storage_[idx];
-    uint32_t update = existing |
-        (union_with->GetRawStorageWord(idx) & ~not_in->GetRawStorageWord(idx));
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+    uint32_t update = existing | (union_with_storage[idx] & ~not_in_storage[idx]);
+    new_bits |= update ^ existing;
+    storage_[idx] = update;
   }
 
   for (; idx < union_with_size; idx++) {
     uint32_t existing = storage_[idx];
-    uint32_t update = existing | union_with->GetRawStorageWord(idx);
-    if (existing != update) {
-      changed = true;
-      storage_[idx] = update;
-    }
+    uint32_t update = existing | union_with_storage[idx];
+    new_bits |= update ^ existing;
+    storage_[idx] = update;
   }
-  return changed;
+  return changed || new_bits != 0u;
 }
 
 void BitVector::Subtract(const BitVector *src) {
@@ -223,8 +224,9 @@ void BitVector::Subtract(const BitVector *src) {
   //   There is no need to do more:
   //     If we are bigger than src, the upper bits are unchanged.
   //     If we are smaller than src, the nonexistent upper bits are 0 and thus can't get subtracted.
+  const uint32_t* src_storage = src->GetRawStorage();
   for (uint32_t idx = 0; idx < min_size; idx++) {
-    storage_[idx] &= (~(src->GetRawStorageWord(idx)));
+    storage_[idx] &= ~src_storage[idx];
   }
 }
 
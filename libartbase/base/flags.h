@@ -301,6 +301,11 @@ struct Flags {
   // MetricsReportingMods and MetricsReportingNumMods.
   Flag<bool> MetricsWriteToLogcat{ "metrics.write-to-logcat", false, FlagType::kCmdlineOnly};
 
+  // Whether or not we should write metrics as trace counters.
+  // Note that the actual write is still controlled by
+  // MetricsReportingMods and MetricsReportingNumMods.
+  Flag<bool> MetricsWriteToTrace{"metrics.write-to-trace", false, FlagType::kDeviceConfig};
+
   // Whether or not we should write metrics to a file.
   // Note that the actual write is still controlled by
   // MetricsReportingMods and MetricsReportingNumMods.
@@ -21,6 +21,7 @@
 
 #include <functional>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -233,6 +234,7 @@ class HashSet {
         pred_(pred),
         num_elements_(0u),
         num_buckets_(0u),
+        bucket_index_multiplier_(0u),
         elements_until_expand_(0u),
         owns_data_(false),
         data_(nullptr),
@@ -249,6 +251,7 @@ class HashSet {
         pred_(other.pred_),
         num_elements_(other.num_elements_),
         num_buckets_(0),
+        bucket_index_multiplier_(0u),
         elements_until_expand_(other.elements_until_expand_),
         owns_data_(false),
         data_(nullptr),
@@ -269,6 +272,7 @@ class HashSet {
         pred_(std::move(other.pred_)),
         num_elements_(other.num_elements_),
         num_buckets_(other.num_buckets_),
+        bucket_index_multiplier_(other.bucket_index_multiplier_),
         elements_until_expand_(other.elements_until_expand_),
         owns_data_(other.owns_data_),
         data_(other.data_),
@@ -276,6 +280,7 @@ class HashSet {
         max_load_factor_(other.max_load_factor_) {
     other.num_elements_ = 0u;
     other.num_buckets_ = 0u;
+    other.bucket_index_multiplier_ = 0u;
     other.elements_until_expand_ = 0u;
     other.owns_data_ = false;
     other.data_ = nullptr;
@@ -307,6 +312,7 @@ class HashSet {
         pred_(pred),
         num_elements_(0u),
         num_buckets_(buffer_size),
+        bucket_index_multiplier_(ComputeBucketIndexMultiplier(buffer_size)),
         elements_until_expand_(buffer_size * max_load_factor),
         owns_data_(false),
         data_(buffer),
@@ -329,6 +335,7 @@ class HashSet {
     num_elements_ = static_cast<uint64_t>(temp);
     offset = ReadFromBytes(ptr, offset, &temp);
     num_buckets_ = static_cast<uint64_t>(temp);
+    bucket_index_multiplier_ = ComputeBucketIndexMultiplier(num_buckets_);
     CHECK_LE(num_elements_, num_buckets_);
     offset = ReadFromBytes(ptr, offset, &temp);
     elements_until_expand_ = static_cast<uint64_t>(temp);
@@ -567,6 +574,7 @@ class HashSet {
     swap(pred_, other.pred_);
     std::swap(data_, other.data_);
     std::swap(num_buckets_, other.num_buckets_);
+    std::swap(bucket_index_multiplier_, other.bucket_index_multiplier_);
     std::swap(num_elements_, other.num_elements_);
     std::swap(elements_until_expand_, other.elements_until_expand_);
     std::swap(min_load_factor_, other.min_load_factor_);
@@ -578,6 +586,20 @@ class HashSet {
     return allocfn_;
   }
 
+  // Return a set that shares the storage of this set without owning it. The view sees
+  // the elements of this set as long as this set does not reallocate its storage, and
+  // it must not be used to insert or erase elements.
+  HashSet View() const {
+    HashSet view(min_load_factor_, max_load_factor_, hashfn_, pred_, allocfn_);
+    view.num_elements_ = num_elements_;
+    view.num_buckets_ = num_buckets_;
+    view.bucket_index_multiplier_ = bucket_index_multiplier_;
+    view.elements_until_expand_ = elements_until_expand_;
+    view.data_ = data_;
+    DCHECK(!view.owns_data_);
+    return view;
+  }
+
   void ShrinkToMaximumLoad() {
     Resize(size() / max_load_factor_);
   }
@@ -690,9 +712,28 @@ class HashSet {
     if (UNLIKELY(num_buckets_ == 0)) {
       return 0;
     }
+#if defined(__SIZEOF_INT128__)
+    // Replace the division with two multiplications for 32-bit values, see
+    // ComputeBucketIndexMultiplier(). The result is the same as the `%` below.
+    if (LIKELY(hash <= std::numeric_limits<uint32_t>::max() &&
+               num_buckets_ <= std::numeric_limits<uint32_t>::max())) {
+      uint64_t fraction = bucket_index_multiplier_ * static_cast<uint64_t>(hash);
+      return static_cast<size_t>((static_cast<unsigned __int128>(fraction) * num_buckets_) >> 64);
+    }
+#endif
     return hash % num_buckets_;
   }
 
+  // Returns ceil(2^64 / `num_buckets`) modulo 2^64, so that the bucket index of a 32-bit `hash`
+  // is the high half of the 128-bit product of the low half of `multiplier * hash` and
+  // `num_buckets`. See D. Lemire et al., "Faster Remainder by Direct Computation" (2019).
+  static uint64_t ComputeBucketIndexMultiplier(size_t num_buckets) {
+    if (num_buckets == 0u || num_buckets > std::numeric_limits<uint32_t>::max()) {
+      return 0u;  // Unused.
+    }
+    return std::numeric_limits<uint64_t>::max() / num_buckets + 1u;
+  }
+
   size_t NextIndex(size_t index) const {
     if (UNLIKELY(++index >= num_buckets_)) {
       DCHECK_EQ(index, NumBuckets());
@@ -742,6 +783,7 @@ class HashSet {
   // Allocate a number of buckets.
   void AllocateStorage(size_t num_buckets) {
     num_buckets_ = num_buckets;
+    bucket_index_multiplier_ = ComputeBucketIndexMultiplier(num_buckets);
     data_ = allocfn_.allocate(num_buckets_);
     owns_data_ = true;
     for (size_t i = 0; i < num_buckets_; ++i) {
@@ -762,6 +804,7 @@ class HashSet {
     }
     data_ = nullptr;
     num_buckets_ = 0;
+    bucket_index_multiplier_ = 0u;
   }
 
   // Expand the set based on the load factors.
@@ -843,6 +886,7 @@ class HashSet {
   Pred pred_;  // Equals function.
   size_t num_elements_;  // Number of inserted elements.
   size_t num_buckets_;  // Number of hash table buckets.
+  uint64_t bucket_index_multiplier_;  // For computing `hash % num_buckets_`.
   size_t elements_until_expand_;  // Maximum number of elements until we expand the table.
   bool owns_data_;  // If we own data_ and are responsible for freeing it.
   T* data_;  // Backing storage.
@@ -854,6 +898,7 @@ class HashSet {
 
   ART_FRIEND_TEST(InternTableTest, CrossHash);
   ART_FRIEND_TEST(HashSetTest, Preallocated);
+  ART_FRIEND_TEST(HashSetTest, IndexForHash);
 };
 
 template <class T, class EmptyFn, class HashFn, class Pred, class Alloc>
@@ -381,6 +381,41 @@ TEST_F(HashSetTest, DoubleInsert) {
   ASSERT_EQ(1u, hash_set.size());
 }
 
+TEST_F(HashSetTest, View) {
+  HashSet<std::string> hash_set;
+  hash_set.insert("a");
+  hash_set.insert("b");
+  {
+    HashSet<std::string> view = hash_set.View();
+    ASSERT_EQ(2u, view.size());
+    ASSERT_EQ(hash_set.NumBuckets(), view.NumBuckets());
+    EXPECT_TRUE(view.find("a") != view.end());
+    EXPECT_TRUE(view.find("b") != view.end());
+    EXPECT_TRUE(view.find("c") == view.end());
+    EXPECT_EQ(&*hash_set.find("a"), &*view.find("a"));
+  }
+  // Destroying the view does not release the storage of the original set.
+  EXPECT_TRUE(hash_set.find("a") != hash_set.end());
+}
+
+TEST_F(HashSetTest, IndexForHash) {
+  static constexpr size_t kHashes[] = {
+      0u, 1u, 2u, 63u, 64u, 65u, 0x7fffffffu, 0x80000000u, 0xfffffffeu, 0xffffffffu,
+  };
+  for (size_t num_buckets : {1u, 2u, 3u, 7u, 100u, 1000u, 65537u}) {
+    std::vector<std::string> buffer(num_buckets);
+    HashSet<std::string> hash_set(buffer.data(), buffer.size());
+    ASSERT_EQ(num_buckets, hash_set.NumBuckets());
+    for (size_t hash : kHashes) {
+      EXPECT_EQ(hash % num_buckets, hash_set.IndexForHash(hash)) << hash << " " << num_buckets;
+    }
+    for (size_t i = 0; i != 1000u; ++i) {
+      size_t hash = PRand();
+      EXPECT_EQ(hash % num_buckets, hash_set.IndexForHash(hash)) << hash << " " << num_buckets;
+    }
+  }
+}
+
 TEST_F(HashSetTest, Preallocated) {
   static const size_t kBufferSize = 64;
   uint32_t buffer[kBufferSize];
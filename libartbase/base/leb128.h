@@ -102,6 +102,20 @@ static inline bool DecodeUnsignedLeb128Checked(const uint8_t** data,
   return true;
 }
 
+// Returns the position just past `count` consecutive unsigned LEB128 values starting at
+// `data`. This is cheaper than decoding the values when they are not needed. Like
+// DecodeUnsignedLeb128(), this function treats the fifth byte of a value as its last one.
+static inline const uint8_t* SkipUnsignedLeb128(const uint8_t* data, size_t count) {
+  for (; count != 0u; --count) {
+    const uint8_t* last = data + 4;
+    while (*data > 0x7f && data != last) {
+      ++data;
+    }
+    ++data;
+  }
+  return data;
+}
+
 // Reads an unsigned LEB128 + 1 value. updating the given pointer to point
 // just past the end of the read value. This function tolerates
 // non-zero high-order bits in the fifth encoded byte.
@@ -16,6 +16,8 @@
 
 #include "leb128.h"
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 #include "histogram-inl.h"
 #include "time_utils.h"
@@ -172,6 +174,23 @@ TEST(Leb128Test, UnsignedStream) {
   EXPECT_EQ(data_size, static_cast<size_t>(encoded_data_ptr - encoded_data));
 }
 
+TEST(Leb128Test, UnsignedSkip) {
+  uint8_t encoded_data[5 * arraysize(uleb128_tests) + 5];
+  uint8_t* end = encoded_data;
+  for (size_t i = 0; i < arraysize(uleb128_tests); ++i) {
+    end = EncodeUnsignedLeb128(end, uleb128_tests[i].decoded);
+  }
+  // A value with garbage in the high-order bits of the fifth byte.
+  static constexpr uint8_t kGarbageValue[] = {0xff, 0xff, 0xff, 0xff, 0xff};
+  end = std::copy(kGarbageValue, kGarbageValue + arraysize(kGarbageValue), end);
+  const uint8_t* expected = encoded_data;
+  for (size_t i = 0; i <= arraysize(uleb128_tests); ++i) {
+    EXPECT_EQ(expected, SkipUnsignedLeb128(encoded_data, i)) << " i = " << i;
+    DecodeUnsignedLeb128(&expected);
+  }
+  EXPECT_EQ(end, SkipUnsignedLeb128(encoded_data, arraysize(uleb128_tests) + 1u));
+}
+
 TEST(Leb128Test, SignedSinglesVector) {
   // Test individual encodings.
   for (size_t i = 0; i < arraysize(sleb128_tests); ++i) {
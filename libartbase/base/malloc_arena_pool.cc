@@ -76,12 +76,24 @@ MallocArena::~MallocArena() {
 }
 
 void Arena::Reset() {
-  if (bytes_allocated_ > 0) {
-    memset(Begin(), 0, bytes_allocated_);
+  size_t used_bytes = std::max(bytes_allocated_, dirty_bytes_);
+  if (used_bytes > 0) {
+    memset(Begin(), 0, used_bytes);
     bytes_allocated_ = 0;
+    dirty_bytes_ = 0;
   }
 }
 
+void Arena::ResetUninitialized() {
+  if (kRunningOnMemoryTool) {
+    // Keep the memory tool annotations simple by clearing the memory eagerly.
+    Reset();
+    return;
+  }
+  dirty_bytes_ = std::max(bytes_allocated_, dirty_bytes_);
+  bytes_allocated_ = 0;
+}
+
 MallocArenaPool::MallocArenaPool() : free_arenas_(nullptr) {
 }
 
@@ -103,6 +115,18 @@ void MallocArenaPool::LockReclaimMemory() {
 }
 
 Arena* MallocArenaPool::AllocArena(size_t size) {
+  Arena* ret = TakeOrCreateArena(size);
+  ret->Reset();
+  return ret;
+}
+
+Arena* MallocArenaPool::AllocUninitializedArena(size_t size) {
+  Arena* ret = TakeOrCreateArena(size);
+  ret->ResetUninitialized();
+  return ret;
+}
+
+Arena* MallocArenaPool::TakeOrCreateArena(size_t size) {
   Arena* ret = nullptr;
   {
     std::lock_guard<std::mutex> lock(lock_);
@@ -114,7 +138,6 @@ Arena* MallocArenaPool::AllocArena(size_t size) {
   if (ret == nullptr) {
     ret = new MallocArena(size);
   }
-  ret->Reset();
   return ret;
 }
 
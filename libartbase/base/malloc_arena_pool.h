@@ -28,6 +28,7 @@ class MallocArenaPool final : public ArenaPool {
   MallocArenaPool();
   ~MallocArenaPool();
   Arena* AllocArena(size_t size) override;
+  Arena* AllocUninitializedArena(size_t size) override;
   void FreeArenaChain(Arena* first) override;
   size_t GetBytesAllocated() const override;
   void ReclaimMemory() override;
@@ -36,6 +37,8 @@ class MallocArenaPool final : public ArenaPool {
   void TrimMaps() override;
 
  private:
+  Arena* TakeOrCreateArena(size_t size);
+
   Arena* free_arenas_;
   // Use a std::mutex here as Arenas are at the bottom of the lock hierarchy when malloc is used.
   mutable std::mutex lock_;
@@ -864,6 +864,21 @@ int MemMap::MadviseDontFork() {
   return -1;
 }
 
+int MemMap::MadviseHugePages() {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  uint8_t* begin = AlignUp(begin_, kTransparentHugePageSize);
+  uint8_t* end = AlignDown(begin_ + size_, kTransparentHugePageSize);
+  if (begin >= end) {
+    // No whole huge page to advise.
+    return 0;
+  }
+  return madvise(begin, end - begin, MADV_HUGEPAGE);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
 bool MemMap::Sync() {
 #ifdef _WIN32
   // TODO: add FlushViewOfFile support.
@@ -41,6 +41,9 @@ namespace art {
 #define USE_ART_LOW_4G_ALLOCATOR 0
 #endif
 
+// Size of a PMD-level transparent huge page on the architectures we support.
+static constexpr size_t kTransparentHugePageSize = 2 * MB;
+
 #ifdef __linux__
 static constexpr bool kMadviseZeroes = true;
 #define HAVE_MREMAP_SYSCALL true
@@ -251,6 +254,10 @@ class MemMap {
     FillWithZero(/* release_eagerly= */ true);
   }
   int MadviseDontFork();
+  // Ask the kernel to back the huge-page aligned part of this map with transparent huge pages.
+  // Returns 0 on success, including when the map holds no whole huge page, and -1 with errno
+  // set if the advice could not be applied.
+  int MadviseHugePages();
 
   int GetProtect() const {
     return prot_;
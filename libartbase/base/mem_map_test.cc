@@ -890,6 +890,32 @@ TEST_F(MemMapTest, Reservation) {
   ASSERT_FALSE(map2.IsValid());
 }
 
+TEST_F(MemMapTest, MadviseHugePages) {
+  CommonInit();
+  std::string error_msg;
+  // A map without a whole huge page has nothing to advise.
+  MemMap small_map = MemMap::MapAnonymous("MadviseHugePages small",
+                                          MemMap::GetPageSize(),
+                                          PROT_READ | PROT_WRITE,
+                                          /*low_4gb=*/ false,
+                                          &error_msg);
+  ASSERT_TRUE(small_map.IsValid()) << error_msg;
+  EXPECT_EQ(0, small_map.MadviseHugePages());
+
+  MemMap large_map = MemMap::MapAnonymous("MadviseHugePages large",
+                                          2 * kTransparentHugePageSize,
+                                          PROT_READ | PROT_WRITE,
+                                          /*low_4gb=*/ false,
+                                          &error_msg);
+  ASSERT_TRUE(large_map.IsValid()) << error_msg;
+  errno = 0;
+  if (large_map.MadviseHugePages() != 0) {
+    // Kernels without transparent huge pages reject the advice. The caller must be able to
+    // report why.
+    EXPECT_NE(0, errno);
+  }
+}
+
 }  // namespace art
 
 namespace {
@@ -54,12 +54,16 @@
   METRIC(FullGcTracingThroughputAvg, MetricsAverage)                \
   METRIC(JitMethodCompileTotalTime, MetricsCounter)                 \
   METRIC(JitMethodCompileCount, MetricsCounter)                     \
+  METRIC(JitCodeBytesAllocated, MetricsCounter)                     \
+  METRIC(JitStackMapBytesAllocated, MetricsCounter)                 \
+  METRIC(JitCodeInvalidationCount, MetricsCounter)                  \
   METRIC(YoungGcCollectionTime, MetricsHistogram, 15, 0, 60'000)    \
   METRIC(FullGcCollectionTime, MetricsHistogram, 15, 0, 60'000)     \
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)        \
   METRIC(FullGcThroughput, MetricsHistogram, 15, 0, 10'000)         \
   METRIC(YoungGcTracingThroughput, MetricsHistogram, 15, 0, 10'000) \
   METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)  \
+  METRIC(ThreadTimeToSuspend, MetricsHistogram, 15, 0, 10'000)      \
   METRIC(GcWorldStopTime, MetricsCounter)                           \
   METRIC(GcWorldStopCount, MetricsCounter)                          \
   METRIC(YoungGcScannedBytes, MetricsCounter)                       \
@@ -67,7 +71,22 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(TlabRefillCount, MetricsCounter)                           \
+  METRIC(TlabGrowCount, MetricsCounter)                             \
+  METRIC(TlabShrinkCount, MetricsCounter)                           \
+  METRIC(FinalizerEnqueueCount, MetricsCounter)                     \
+  METRIC(RosAllocIdleRunRevokeBytes, MetricsCounter)                \
+  ART_STARTUP_METRICS(METRIC)
+
+// Durations of the runtime startup phases, reported as Event Metrics. A process forked from the
+// zygote runs in the runtime the zygote started, so these are kept when the metrics are reset.
+#define ART_STARTUP_METRICS(METRIC)                               \
+  METRIC(StartupHeapCreationTime, MetricsCounter)                 \
+  METRIC(StartupClassLinkerInitTime, MetricsCounter)              \
+  METRIC(StartupIntrinsicsInitTime, MetricsCounter)               \
+  METRIC(StartupJitCreationTime, MetricsCounter)                  \
+  METRIC(StartupPluginAndAgentLoadingTime, MetricsCounter)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
 #define ART_VALUE_METRICS(METRIC)                              \
@@ -88,6 +107,9 @@
   METRIC(TotalGcCollectionTimeDelta, MetricsDeltaCounter)      \
   METRIC(YoungGcCountDelta, MetricsDeltaCounter)               \
   METRIC(FullGcCountDelta, MetricsDeltaCounter)                \
+  METRIC(TlabRefillCountDelta, MetricsDeltaCounter)            \
+  METRIC(FinalizerEnqueueCountDelta, MetricsDeltaCounter)      \
+  METRIC(RosAllocIdleRunRevokeBytesDelta, MetricsDeltaCounter) \
   METRIC(TimeElapsedDelta, MetricsDeltaCounter)
 
 #define ART_METRICS(METRIC) \
@@ -285,6 +307,8 @@ class MetricsBackend {
   friend class MetricsDeltaCounter;
   template <DatumId histogram_type, size_t num_buckets, int64_t low_value, int64_t high_value>
   friend class MetricsHistogram;
+  template <DatumId histogram_type, size_t num_buckets, int64_t low_value, int64_t high_value>
+  friend class MetricsShardedHistogram;
   template <DatumId datum_id, typename T, const T& AccumulatorFunction(const T&, const T&)>
   friend class MetricsAccumulator;
   template <DatumId datum_id, typename T>
@@ -458,6 +482,20 @@ class MetricsHistogram final : public MetricsBase<int64_t> {
     buckets_[i].fetch_add(1u, std::memory_order::memory_order_relaxed);
   }
 
+  static constexpr size_t FindBucketId(int64_t value) {
+    // Values below the minimum are clamped into the first bucket.
+    if (value <= minimum_value_) {
+      return 0;
+    }
+    // Values above the maximum are clamped into the last bucket.
+    if (value >= maximum_value_) {
+      return num_buckets_ - 1;
+    }
+    // Otherise, linearly interpolate the value into the right bucket
+    constexpr size_t bucket_width = maximum_value_ - minimum_value_;
+    return static_cast<size_t>(value - minimum_value_) * num_buckets_ / bucket_width;
+  }
+
   void Report(const std::vector<MetricsBackend*>& backends) const {
     for (MetricsBackend* backend : backends) {
       backend->ReportHistogram(histogram_type_, minimum_value_, maximum_value_, GetBuckets());
@@ -472,20 +510,6 @@ class MetricsHistogram final : public MetricsBase<int64_t> {
   }
 
  private:
-  inline constexpr size_t FindBucketId(int64_t value) const {
-    // Values below the minimum are clamped into the first bucket.
-    if (value <= minimum_value_) {
-      return 0;
-    }
-    // Values above the maximum are clamped into the last bucket.
-    if (value >= maximum_value_) {
-      return num_buckets_ - 1;
-    }
-    // Otherise, linearly interpolate the value into the right bucket
-    constexpr size_t bucket_width = maximum_value_ - minimum_value_;
-    return static_cast<size_t>(value - minimum_value_) * num_buckets_ / bucket_width;
-  }
-
   std::vector<value_t> GetBuckets() const {
     // The loads from buckets_ will all be memory_order_seq_cst, which means they will be acquire
     // loads. This is a stricter memory order than is needed, but this should not be a
@@ -504,6 +528,77 @@ class MetricsHistogram final : public MetricsBase<int64_t> {
   friend class ArtMetrics;
 };
 
+// Number of shards of the metrics for hot paths, see MetricsShardedHistogram.
+static constexpr size_t kMetricsNumShards = 8;
+// Alignment of the shards, the cache line size of the supported architectures.
+static constexpr size_t kMetricsShardAlignment = 64;
+
+// Returns the shard of the calling thread. Threads are assigned shards round-robin.
+size_t GetMetricsShardIndex();
+
+// A histogram for hot paths that may be added to by many threads at the same time. Each thread
+// adds to one of several copies of the buckets, each on its own cache lines, so that concurrent
+// additions rarely contend on the same cache line. The copies are merged when reported.
+template <DatumId histogram_type_,
+          size_t num_buckets_,
+          int64_t minimum_value_,
+          int64_t maximum_value_>
+class MetricsShardedHistogram final : public MetricsBase<int64_t> {
+ public:
+  using value_t = uint32_t;
+
+  constexpr MetricsShardedHistogram() : shards_{} {}
+
+  void Add(int64_t value) override {
+    const size_t i =
+        MetricsHistogram<histogram_type_, num_buckets_, minimum_value_, maximum_value_>::
+            FindBucketId(value);
+    shards_[GetMetricsShardIndex()].buckets[i].fetch_add(
+        1u, std::memory_order::memory_order_relaxed);
+  }
+
+  void Report(const std::vector<MetricsBackend*>& backends) const {
+    std::vector<value_t> buckets = GetBuckets();
+    for (MetricsBackend* backend : backends) {
+      backend->ReportHistogram(histogram_type_, minimum_value_, maximum_value_, buckets);
+    }
+  }
+
+ protected:
+  void Reset() {
+    for (Shard& shard : shards_) {
+      for (auto& bucket : shard.buckets) {
+        bucket = 0;
+      }
+    }
+  }
+
+ private:
+  struct alignas(kMetricsShardAlignment) Shard {
+    std::array<std::atomic<value_t>, num_buckets_> buckets;
+  };
+
+  std::vector<value_t> GetBuckets() const {
+    std::vector<value_t> buckets(num_buckets_, 0u);
+    for (const Shard& shard : shards_) {
+      for (size_t i = 0; i != num_buckets_; ++i) {
+        buckets[i] += shard.buckets[i].load(std::memory_order::memory_order_relaxed);
+      }
+    }
+    return buckets;
+  }
+
+  bool IsNull() const override {
+    std::vector<value_t> buckets = GetBuckets();
+    return std::all_of(buckets.cbegin(), buckets.cend(), [](value_t i) { return i == 0; });
+  }
+
+  std::array<Shard, kMetricsNumShards> shards_;
+  static_assert(std::atomic<value_t>::is_always_lock_free);
+
+  friend class ArtMetrics;
+};
+
 template <DatumId datum_id, typename T, const T& AccumulatorFunction(const T&, const T&)>
 class MetricsAccumulator final : MetricsBase<T> {
  public:
@@ -669,6 +764,30 @@ class FileBackend : public StringBackend {
   std::string filename_;
 };
 
+// A backend that emits metrics as trace counters, so that they can be correlated with the rest of
+// a system trace. Counters are emitted with their current value and histograms with their total
+// number of samples. Nothing is emitted while tracing is disabled.
+class TraceBackend : public MetricsBackend {
+ public:
+  void BeginOrUpdateSession([[maybe_unused]] const SessionData& session_data) override {}
+
+  void BeginReport(uint64_t timestamp_millis) override;
+
+  void ReportCounter(DatumId counter_type, uint64_t value) override;
+
+  void ReportHistogram(DatumId histogram_type,
+                       int64_t low_value,
+                       int64_t high_value,
+                       const std::vector<uint32_t>& buckets) override;
+
+  void EndReport() override {}
+
+ private:
+  void EmitCounter(DatumId datum, uint64_t value);
+
+  bool enabled_ = false;
+};
+
 /**
  * AutoTimer simplifies time-based metrics collection.
  *
@@ -748,8 +867,8 @@ class ArtMetrics {
   void ReportAllMetricsAndResetValueMetrics(const std::vector<MetricsBackend*>& backends);
   void DumpForSigQuit(std::ostream& os);
 
-  // Resets all metrics to their initial value. This is intended to be used after forking from the
-  // zygote so we don't attribute parent values to the child process.
+  // Resets all metrics except the startup metrics to their initial value. This is intended to be
+  // used after forking from the zygote so we don't attribute parent values to the child process.
   void Reset();
 
 #define METRIC_ACCESSORS(name, Kind, ...)                                        \
@@ -14,12 +14,15 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include "android-base/file.h"
 #include "android-base/logging.h"
 #include "base/macros.h"
 #include "base/scoped_flock.h"
+#include "base/systrace.h"
 #include "metrics.h"
 
 #pragma clang diagnostic push
@@ -67,6 +70,13 @@ ArtMetrics::ArtMetrics()
 {
 }
 
+size_t GetMetricsShardIndex() {
+  static std::atomic<size_t> next_shard_index(0u);
+  thread_local size_t shard_index =
+      next_shard_index.fetch_add(1u, std::memory_order_relaxed) % kMetricsNumShards;
+  return shard_index;
+}
+
 void ArtMetrics::ReportAllMetricsAndResetValueMetrics(
     const std::vector<MetricsBackend*>& backends) {
   uint64_t current_timestamp_ = MilliTime();
@@ -101,7 +111,21 @@ void ArtMetrics::DumpForSigQuit(std::ostream& os) {
 
 void ArtMetrics::Reset() {
   beginning_timestamp_ = MilliTime();
-#define RESET_METRIC(name, ...) name##_.Reset();
+  // The startup metrics are only added once, when the runtime starts.
+  auto is_startup_metric = [](DatumId datum_id) {
+    switch (datum_id) {
+#define STARTUP_METRIC_CASE(name, ...) case DatumId::k##name:
+      ART_STARTUP_METRICS(STARTUP_METRIC_CASE)
+#undef STARTUP_METRIC_CASE
+        return true;
+      default:
+        return false;
+    }
+  };
+#define RESET_METRIC(name, ...)                  \
+  if (!is_startup_metric(DatumId::k##name)) {    \
+    name##_.Reset();                             \
+  }
   ART_METRICS(RESET_METRIC)
 #undef RESET_METRIC
 }
@@ -289,6 +313,36 @@ void FileBackend::EndReport() {
   }
 }
 
+void TraceBackend::BeginReport([[maybe_unused]] uint64_t timestamp_millis) {
+  // Check once per report rather than once per datum.
+  enabled_ = ATraceEnabled();
+}
+
+void TraceBackend::ReportCounter(DatumId counter_type, uint64_t value) {
+  EmitCounter(counter_type, value);
+}
+
+void TraceBackend::ReportHistogram(DatumId histogram_type,
+                                   [[maybe_unused]] int64_t low_value,
+                                   [[maybe_unused]] int64_t high_value,
+                                   const std::vector<uint32_t>& buckets) {
+  uint64_t total = 0u;
+  for (uint32_t count : buckets) {
+    total += count;
+  }
+  EmitCounter(histogram_type, total);
+}
+
+void TraceBackend::EmitCounter(DatumId datum, uint64_t value) {
+  if (!enabled_) {
+    return;
+  }
+  std::string name = "ART " + DatumName(datum);
+  ATraceIntegerValue(name.c_str(),
+                     static_cast<int32_t>(
+                         std::min<uint64_t>(value, std::numeric_limits<int32_t>::max())));
+}
+
 // Make sure CompilationReasonName and CompilationReasonForName are inverses.
 static_assert(CompilationReasonFromName(CompilationReasonName(CompilationReason::kError)) ==
               CompilationReason::kError);
@@ -164,6 +164,32 @@ TEST_F(MetricsTest, SimpleHistogramTest) {
   EXPECT_EQ(0u, buckets[4u]);
 }
 
+TEST_F(MetricsTest, ShardedHistogramTest) {
+  MetricsShardedHistogram<DatumId::kYoungGcCollectionTime, 5, 0, 100> histogram;
+
+  // Add from several threads so that the values end up in different shards.
+  static constexpr size_t kNumThreads = 2 * kMetricsNumShards;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([&histogram]() {
+      histogram.Add(10);  // bucket 0: 0-19
+      histogram.Add(25);  // bucket 1: 20-39
+      histogram.Add(70);  // bucket 3: 60-79
+      histogram.Add(70);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<uint32_t> buckets{GetBuckets(histogram)};
+  EXPECT_EQ(kNumThreads, buckets[0u]);
+  EXPECT_EQ(kNumThreads, buckets[1u]);
+  EXPECT_EQ(0u, buckets[2u]);
+  EXPECT_EQ(2u * kNumThreads, buckets[3u]);
+  EXPECT_EQ(0u, buckets[4u]);
+}
+
 // Make sure values added outside the range of the histogram go into the first or last bucket.
 TEST_F(MetricsTest, HistogramOutOfRangeTest) {
   MetricsHistogram<DatumId::kYoungGcCollectionTime, 2, 0, 100> histogram;
@@ -297,12 +323,21 @@ TEST_F(MetricsTest, ResetMetrics) {
   // Make sure the metrics all have a nonzero value.
   metrics.ReportAllMetricsAndResetValueMetrics({&non_zero_backend});
 
-  // Reset the metrics and make sure they are all zero again
+  // Reset the metrics and make sure they are all zero again, except the startup metrics.
   metrics.Reset();
 
   class ZeroBackend : public TestBackendBase {
    public:
     void ReportCounter(DatumId counter_type, uint64_t value) override {
+      switch (counter_type) {
+#define STARTUP_METRIC_CASE(name, ...) case DatumId::k##name:
+        ART_STARTUP_METRICS(STARTUP_METRIC_CASE)
+#undef STARTUP_METRIC_CASE
+          EXPECT_EQ(value, 42u) << "Unexpected value for counter " << DatumName(counter_type);
+          return;
+        default:
+          break;
+      }
       if (counter_type == DatumId::kTimeElapsedDelta) {
         // TimeElapsedData can be greater than 0 if the test takes more than 1ms to run
         EXPECT_GE(value, 0u) << "Unexpected value for counter " << DatumName(counter_type);
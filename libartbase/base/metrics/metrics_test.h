@@ -62,9 +62,8 @@ uint64_t CounterValue(const MetricType& counter) {
   return counter_value;
 }
 
-template <DatumId histogram_type, size_t num_buckets, int64_t low_value, int64_t high_value>
-std::vector<uint32_t> GetBuckets(
-    const MetricsHistogram<histogram_type, num_buckets, low_value, high_value>& histogram) {
+template <typename Histogram>
+std::vector<uint32_t> GetBuckets(const Histogram& histogram) {
   std::vector<uint32_t> buckets;
   struct HistogramBackend : public TestBackendBase {
     explicit HistogramBackend(std::vector<uint32_t>* buckets) : buckets_{buckets} {}
@@ -55,13 +55,13 @@ uint8_t* ArenaStack::AllocateFromNextArena(size_t rounded_bytes) {
   UpdateBytesAllocated();
   size_t allocation_size = std::max(arena_allocator::kArenaDefaultSize, rounded_bytes);
   if (UNLIKELY(top_arena_ == nullptr)) {
-    top_arena_ = bottom_arena_ = stats_and_pool_.pool->AllocArena(allocation_size);
+    top_arena_ = bottom_arena_ = stats_and_pool_.pool->AllocUninitializedArena(allocation_size);
     top_arena_->next_ = nullptr;
   } else if (top_arena_->next_ != nullptr && top_arena_->next_->Size() >= allocation_size) {
     top_arena_ = top_arena_->next_;
   } else {
     Arena* tail = top_arena_->next_;
-    top_arena_->next_ = stats_and_pool_.pool->AllocArena(allocation_size);
+    top_arena_->next_ = stats_and_pool_.pool->AllocUninitializedArena(allocation_size);
     top_arena_ = top_arena_->next_;
     top_arena_->next_ = tail;
   }
@@ -36,6 +36,7 @@ import android.annotation.Nullable;
 import android.annotation.SuppressLint;
 import android.annotation.SystemApi;
 import android.annotation.SystemService;
+import android.app.ActivityManager;
 import android.app.job.JobInfo;
 import android.apphibernation.AppHibernationManager;
 import android.content.Context;
@@ -43,6 +44,7 @@ import android.os.Binder;
 import android.os.Build;
 import android.os.CancellationSignal;
 import android.os.ParcelFileDescriptor;
+import android.os.PowerManager;
 import android.os.Process;
 import android.os.RemoteException;
 import android.os.ServiceSpecificException;
@@ -407,6 +409,11 @@ public final class ArtManagerLocal {
      * usage is always bound by {@code dalvik.vm.*dex2oat-cpu-set} regardless of the number of
      * threads.
      *
+     * For {@link ReasonMapping#REASON_BG_DEXOPT}, the concurrency also follows the state of the
+     * device when the operation starts: it is raised to the system property {@code
+     * pm.dexopt.bg-dexopt.max-concurrency}, if set, while the device has no thermal throttling, and
+     * it is lowered to 1 while the device is throttled or low on memory.
+     *
      * When this operation ends (either completed or cancelled), callbacks added by {@link
      * #addDexoptDoneCallback(Executor, DexoptDoneCallback)} are called.
      *
@@ -459,7 +466,7 @@ public final class ArtManagerLocal {
         Utils.check(params.getDexoptParams().getReason().equals(reason));
 
         ExecutorService dexoptExecutor =
-                Executors.newFixedThreadPool(ReasonMapping.getConcurrencyForReason(reason));
+                Executors.newFixedThreadPool(getConcurrencyForBatchDexopt(reason));
         Map<Integer, DexoptResult> dexoptResults = new HashMap<>();
         try (var pin = mInjector.createArtdPin()) {
             if (reason.equals(ReasonMapping.REASON_BG_DEXOPT)) {
@@ -1093,6 +1100,33 @@ public final class ArtManagerLocal {
         }
     }
 
+    /**
+     * Returns the number of packages to dexopt simultaneously for {@code reason}, adjusted for
+     * background dexopt so that it finishes sooner on a cool device and does not add to the load
+     * of a hot or memory-constrained one.
+     */
+    @VisibleForTesting
+    @RequiresApi(Build.VERSION_CODES.UPSIDE_DOWN_CAKE)
+    int getConcurrencyForBatchDexopt(@NonNull @BatchDexoptReason String reason) {
+        int concurrency = ReasonMapping.getConcurrencyForReason(reason);
+        if (!reason.equals(ReasonMapping.REASON_BG_DEXOPT)) {
+            return concurrency;
+        }
+        int thermalStatus = mInjector.getThermalStatus();
+        if (thermalStatus >= PowerManager.THERMAL_STATUS_LIGHT || mInjector.isLowMemory()) {
+            Log.i(TAG,
+                    "Reducing background dexopt concurrency to 1 (thermal status: " + thermalStatus
+                            + ")");
+            return 1;
+        }
+        if (thermalStatus == PowerManager.THERMAL_STATUS_NONE) {
+            return Math.max(concurrency,
+                    SystemProperties.getInt(
+                            "pm.dexopt.bg-dexopt.max-concurrency", concurrency /* def */));
+        }
+        return concurrency;
+    }
+
     @RequiresApi(Build.VERSION_CODES.UPSIDE_DOWN_CAKE)
     @Nullable
     private DexoptResult maybeDexoptPackagesSupplementaryPass(
@@ -1531,6 +1565,26 @@ public final class ArtManagerLocal {
             return Objects.requireNonNull(mContext.getSystemService(StorageManager.class));
         }
 
+        /** Returns the current thermal status, in {@code PowerManager.THERMAL_STATUS_*}. */
+        @RequiresApi(Build.VERSION_CODES.UPSIDE_DOWN_CAKE)
+        public int getThermalStatus() {
+            PowerManager powerManager = mContext.getSystemService(PowerManager.class);
+            return powerManager != null ? powerManager.getCurrentThermalStatus()
+                                        : PowerManager.THERMAL_STATUS_NONE;
+        }
+
+        /** Returns whether the system considers itself to be low on memory. */
+        @RequiresApi(Build.VERSION_CODES.UPSIDE_DOWN_CAKE)
+        public boolean isLowMemory() {
+            ActivityManager activityManager = mContext.getSystemService(ActivityManager.class);
+            if (activityManager == null) {
+                return false;
+            }
+            var memoryInfo = new ActivityManager.MemoryInfo();
+            activityManager.getMemoryInfo(memoryInfo);
+            return memoryInfo.lowMemory;
+        }
+
         @RequiresApi(Build.VERSION_CODES.UPSIDE_DOWN_CAKE)
         @NonNull
         public String getTempDir() {
@@ -50,6 +50,7 @@ import static org.mockito.Mockito.when;
 import android.apphibernation.AppHibernationManager;
 import android.os.CancellationSignal;
 import android.os.ParcelFileDescriptor;
+import android.os.PowerManager;
 import android.os.Process;
 import android.os.ServiceSpecificException;
 import android.os.SystemProperties;
@@ -163,6 +164,8 @@ public class ArtManagerLocalTest {
         lenient().when(mInjector.getDexUseManager()).thenReturn(mDexUseManager);
         lenient().when(mInjector.getCurrentTimeMillis()).thenReturn(CURRENT_TIME_MS);
         lenient().when(mInjector.getStorageManager()).thenReturn(mStorageManager);
+        lenient().when(mInjector.getThermalStatus()).thenReturn(PowerManager.THERMAL_STATUS_NONE);
+        lenient().when(mInjector.isLowMemory()).thenReturn(false);
         lenient()
                 .when(mInjector.getArtFileManager())
                 .thenReturn(new ArtFileManager(mArtFileManagerInjector));
@@ -568,6 +571,24 @@ public class ArtManagerLocalTest {
                         any(), any(), any(), any());
     }
 
+    @Test
+    public void testGetConcurrencyForBatchDexopt() throws Exception {
+        when(SystemProperties.getInt(eq("pm.dexopt.bg-dexopt.max-concurrency"), anyInt()))
+                .thenReturn(6);
+
+        // Boot reasons are not adjusted.
+        when(mInjector.getThermalStatus()).thenReturn(PowerManager.THERMAL_STATUS_SEVERE);
+        assertThat(mArtManagerLocal.getConcurrencyForBatchDexopt("first-boot")).isEqualTo(3);
+
+        assertThat(mArtManagerLocal.getConcurrencyForBatchDexopt("bg-dexopt")).isEqualTo(1);
+
+        when(mInjector.getThermalStatus()).thenReturn(PowerManager.THERMAL_STATUS_NONE);
+        assertThat(mArtManagerLocal.getConcurrencyForBatchDexopt("bg-dexopt")).isEqualTo(6);
+
+        when(mInjector.isLowMemory()).thenReturn(true);
+        assertThat(mArtManagerLocal.getConcurrencyForBatchDexopt("bg-dexopt")).isEqualTo(1);
+    }
+
     @Test
     public void testDexoptPackagesRecentlyInstalled() throws Exception {
         // The package is recently installed but hasn't been used.
@@ -16,13 +16,17 @@
 
 #include "art_dex_file_loader.h"
 
+#include <dirent.h>
 #include <sys/mman.h>
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
+#include "android-base/strings.h"
 #include "base/common_art_test.h"
+#include "base/file_utils.h"
 #include "base/mem_map.h"
 #include "base/os.h"
 #include "base/stl_util.h"
@@ -34,6 +38,7 @@
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file.h"
 #include "dex/dex_file_loader.h"
+#include "ziparchive/zip_writer.h"
 
 namespace art {
 
@@ -361,4 +366,121 @@ TEST_F(ArtDexFileLoaderTest, GetDexCanonicalLocation) {
   ASSERT_EQ(0, unlink(dex_location_sym.c_str()));
 }
 
+// Returns the names of the files in `directory`.
+static std::vector<std::string> ListFiles(const std::string& directory) {
+  std::vector<std::string> names;
+  std::unique_ptr<DIR, int (*)(DIR*)> dir(opendir(directory.c_str()), closedir);
+  CHECK(dir != nullptr) << directory;
+  for (dirent* entry = readdir(dir.get()); entry != nullptr; entry = readdir(dir.get())) {
+    std::string name = entry->d_name;
+    if (name != "." && name != "..") {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+TEST_F(ArtDexFileLoaderTest, ExtractedDexCache) {
+  // Write a dex file as a compressed entry, which cannot be mapped from the zip.
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("Nested"));
+  ASSERT_TRUE(dex != nullptr);
+  ScratchFile zip_file;
+  {
+    FILE* file = fdopen(DupCloexec(zip_file.GetFd()), "w+b");
+    ASSERT_TRUE(file != nullptr);
+    ZipWriter writer(file);
+    ASSERT_EQ(0, writer.StartEntry("classes.dex", ZipWriter::kCompress));
+    ASSERT_EQ(0, writer.WriteBytes(dex->Begin(), dex->Size()));
+    ASSERT_EQ(0, writer.FinishEntry());
+    ASSERT_EQ(0, writer.Finish());
+    ASSERT_EQ(0, fclose(file));
+  }
+
+  ScratchDir cache_dir;
+  DexFileLoader::SetExtractedDexCacheDirectory(cache_dir.GetPath());
+  auto open_zip = [&]() {
+    std::vector<std::unique_ptr<const DexFile>> dex_files;
+    std::string error_msg;
+    ArtDexFileLoader dex_file_loader(zip_file.GetFilename());
+    EXPECT_TRUE(dex_file_loader.Open(/*verify=*/ true,
+                                     /*verify_checksum=*/ true,
+                                     &error_msg,
+                                     &dex_files))
+        << error_msg;
+    ASSERT_EQ(1u, dex_files.size());
+    ASSERT_EQ(dex->Size(), dex_files[0]->Size());
+    EXPECT_EQ(0, memcmp(dex->Begin(), dex_files[0]->Begin(), dex->Size()));
+  };
+
+  // The first open extracts the entry to the cache, without leaving a temporary file behind.
+  open_zip();
+  std::vector<std::string> files = ListFiles(cache_dir.GetPath());
+  ASSERT_EQ(1u, files.size());
+  EXPECT_TRUE(android::base::StartsWith(files[0], "extracted-")) << files[0];
+  EXPECT_TRUE(android::base::EndsWith(files[0], ".dex")) << files[0];
+  const std::string cache_path = cache_dir.GetPath() + "/" + files[0];
+
+  // The second open reuses the extraction.
+  open_zip();
+  EXPECT_EQ(files, ListFiles(cache_dir.GetPath()));
+
+  // A corrupt extraction is replaced.
+  {
+    std::unique_ptr<File> file(OS::OpenFileReadWrite(cache_path.c_str()));
+    ASSERT_TRUE(file != nullptr);
+    const uint8_t garbage[] = { 0xde, 0xad, 0xbe, 0xef };
+    ASSERT_TRUE(file->PwriteFully(garbage, sizeof(garbage), /*offset=*/ 0));
+    ASSERT_EQ(0, file->FlushClose());
+  }
+  open_zip();
+  EXPECT_EQ(files, ListFiles(cache_dir.GetPath()));
+  open_zip();
+
+  DexFileLoader::SetExtractedDexCacheDirectory("");
+  ASSERT_EQ(0, unlink(cache_path.c_str()));
+}
+
+TEST_F(ArtDexFileLoaderTest, OpenZipManyCompressedDexFiles) {
+  // Write a multidex zip whose entries are compressed, except one that can be mapped from the
+  // zip, so that the compressed ones get extracted in parallel.
+  std::vector<std::unique_ptr<const DexFile>> dexes;
+  for (const char* name : { "Main", "Nested", "GetMethodSignature", "Lookup", "VerifierDeps" }) {
+    dexes.push_back(OpenTestDexFile(name));
+    ASSERT_TRUE(dexes.back() != nullptr);
+  }
+  static constexpr size_t kStoredIndex = 2u;
+  ScratchFile zip_file;
+  {
+    FILE* file = fdopen(DupCloexec(zip_file.GetFd()), "w+b");
+    ASSERT_TRUE(file != nullptr);
+    ZipWriter writer(file);
+    for (size_t i = 0; i != dexes.size(); ++i) {
+      size_t flags = (i == kStoredIndex) ? ZipWriter::kAlign32 : ZipWriter::kCompress;
+      std::string entry_name = DexFileLoader::GetMultiDexClassesDexName(i);
+      ASSERT_EQ(0, writer.StartEntry(entry_name.c_str(), flags));
+      ASSERT_EQ(0, writer.WriteBytes(dexes[i]->Begin(), dexes[i]->Size()));
+      ASSERT_EQ(0, writer.FinishEntry());
+    }
+    ASSERT_EQ(0, writer.Finish());
+    ASSERT_EQ(0, fclose(file));
+  }
+
+  std::vector<std::unique_ptr<const DexFile>> dex_files;
+  std::string error_msg;
+  ArtDexFileLoader dex_file_loader(zip_file.GetFilename());
+  ASSERT_TRUE(dex_file_loader.Open(/*verify=*/ true,
+                                   /*verify_checksum=*/ true,
+                                   &error_msg,
+                                   &dex_files))
+      << error_msg;
+  // The dex files are opened in order, whichever thread extracted them.
+  ASSERT_EQ(dexes.size(), dex_files.size());
+  for (size_t i = 0; i != dexes.size(); ++i) {
+    EXPECT_EQ(DexFileLoader::GetMultiDexLocation(i, zip_file.GetFilename().c_str()),
+              dex_files[i]->GetLocation());
+    ASSERT_EQ(dexes[i]->Size(), dex_files[i]->Size());
+    EXPECT_EQ(0, memcmp(dexes[i]->Begin(), dex_files[i]->Begin(), dexes[i]->Size()));
+  }
+}
+
 }  // namespace art
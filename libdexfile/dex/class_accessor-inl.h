@@ -179,24 +179,26 @@ inline IterationRange<ClassAccessor::DataIterator<ClassAccessor::Field>>
 // Return an iteration range for the first <count> methods.
 inline IterationRange<ClassAccessor::DataIterator<ClassAccessor::Method>>
     ClassAccessor::GetMethodsInternal(size_t count) const {
-  // Skip over the fields.
-  Field field(dex_file_, ptr_pos_, hiddenapi_ptr_pos_);
-  VisitMembers(NumFields(), VoidFunctor(), &field);
+  // Skip over the fields without decoding them. Each field has an index delta and access flags.
+  const uint8_t* methods_ptr_pos = SkipUnsignedLeb128(ptr_pos_, 2u * NumFields());
+  const uint8_t* methods_hiddenapi_ptr_pos = (hiddenapi_ptr_pos_ != nullptr)
+      ? SkipUnsignedLeb128(hiddenapi_ptr_pos_, NumFields())
+      : nullptr;
   // Return the iterator pair.
   return {
       DataIterator<Method>(dex_file_,
                            0u,
                            num_direct_methods_,
                            count,
-                           field.ptr_pos_,
-                           field.hiddenapi_ptr_pos_),
+                           methods_ptr_pos,
+                           methods_hiddenapi_ptr_pos),
       DataIterator<Method>(dex_file_,
                            count,
                            num_direct_methods_,
                            count,
                            // The following pointers are bogus but unused in the `end` iterator.
-                           field.ptr_pos_,
-                           field.hiddenapi_ptr_pos_) };
+                           methods_ptr_pos,
+                           methods_hiddenapi_ptr_pos) };
 }
 
 inline IterationRange<ClassAccessor::DataIterator<ClassAccessor::Field>> ClassAccessor::GetFields()
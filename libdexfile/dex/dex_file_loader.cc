@@ -17,9 +17,16 @@
 #include "dex_file_loader.h"
 
 #include <sys/stat.h>
+#include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
 
 #include "android-base/stringprintf.h"
 #include "base/bit_utils.h"
@@ -29,6 +36,7 @@
 #include "base/stl_util.h"
 #include "base/systrace.h"
 #include "base/unix_file/fd_file.h"
+#include "base/utils.h"
 #include "base/zip_archive.h"
 #include "compact_dex_file.h"
 #include "dex_file.h"
@@ -51,6 +59,10 @@ namespace {
 // seems an excessive number.
 static constexpr size_t kWarnOnManyDexFilesThreshold = 100;
 
+// Maximum number of threads, including the calling one, extracting the compressed dex files
+// of a multidex zip in parallel.
+static constexpr size_t kMaxParallelExtractionThreads = 4;
+
 using android::base::StringPrintf;
 
 class VectorContainer : public DexFileContainer {
@@ -122,10 +134,120 @@ class MemMapContainer : public DexFileContainer {
   DISALLOW_COPY_AND_ASSIGN(MemMapContainer);
 };
 
+#ifndef _WIN32
+// Directory for dex files extracted from zip entries, see `SetExtractedDexCacheDirectory()`.
+std::mutex extracted_dex_cache_lock;
+std::string extracted_dex_cache_directory;
+
+// Returns the path of the cached extraction of `entry_name` in the zip at `location`, or an
+// empty string if there is no cache. The CRC32 and size of the entry are part of the name, so
+// an updated APK does not pick up a stale extraction.
+std::string GetExtractedDexCachePath(const std::string& location,
+                                     const char* entry_name,
+                                     ZipEntry* zip_entry) {
+  std::lock_guard<std::mutex> lock(extracted_dex_cache_lock);
+  if (extracted_dex_cache_directory.empty()) {
+    return std::string();
+  }
+  size_t location_hash = std::hash<std::string>()(location + DexFileLoader::kMultiDexSeparator +
+                                                  entry_name);
+  return StringPrintf("%s/extracted-%zx-%08x-%u.dex",
+                      extracted_dex_cache_directory.c_str(),
+                      location_hash,
+                      zip_entry->GetCrc32(),
+                      zip_entry->GetUncompressedLength());
+}
+
+// Map a cached extraction, checking it against the zip entry. The mapping is private but
+// clean, so its pages are shared through the page cache with other processes mapping it.
+MemMap MapExtractedDexCacheFile(const std::string& path, ZipEntry* zip_entry) {
+  std::unique_ptr<File> file(OS::OpenFileForReading(path.c_str()));
+  if (file == nullptr || file->GetLength() != zip_entry->GetUncompressedLength()) {
+    return MemMap::Invalid();
+  }
+  std::string error_msg;
+  MemMap map = MemMap::MapFile(zip_entry->GetUncompressedLength(),
+                               PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE,
+                               file->Fd(),
+                               /*start=*/ 0,
+                               /*low_4gb=*/ false,
+                               path.c_str(),
+                               &error_msg);
+  if (!map.IsValid()) {
+    LOG(WARNING) << "Failed to map extracted dex file " << path << ": " << error_msg;
+    return MemMap::Invalid();
+  }
+  if (crc32(crc32(0L, Z_NULL, 0), map.Begin(), map.Size()) != zip_entry->GetCrc32()) {
+    LOG(WARNING) << "Removing corrupt extracted dex file " << path;
+    unlink(path.c_str());
+    return MemMap::Invalid();
+  }
+  return map;
+}
+
+// Extract the zip entry to the cache file at `path` and map it. The file is written under a
+// temporary name and renamed, so other processes never see a partial extraction. The temporary
+// name is unique to the thread, as threads of the same process can extract the same entry for
+// different class loaders.
+MemMap ExtractToDexCacheFile(const std::string& path, ZipEntry* zip_entry) {
+  std::string temp_path = StringPrintf("%s.%d.%u.tmp", path.c_str(), getpid(), GetTid());
+  std::unique_ptr<File> file(OS::CreateEmptyFileWriteOnly(temp_path.c_str()));
+  if (file == nullptr) {
+    return MemMap::Invalid();
+  }
+  std::string error_msg;
+  bool success = zip_entry->ExtractToFile(*file, &error_msg);
+  if (!success) {
+    LOG(WARNING) << "Failed to extract dex file to " << temp_path << ": " << error_msg;
+    file->Erase();
+  } else if (file->FlushCloseOrErase() != 0 || rename(temp_path.c_str(), path.c_str()) != 0) {
+    PLOG(WARNING) << "Failed to write extracted dex file " << path;
+    success = false;
+  }
+  if (!success) {
+    unlink(temp_path.c_str());
+    return MemMap::Invalid();
+  }
+  return MapExtractedDexCacheFile(path, zip_entry);
+}
+#endif
+
+// Extract a zip entry that cannot be mapped directly, through the extracted dex cache if set.
+MemMap ExtractDexZipEntry(const std::string& location,
+                          const char* entry_name,
+                          ZipEntry* zip_entry,
+                          std::string* error_msg) {
+  DEXFILE_SCOPED_TRACE(std::string("Extract dex file ") + location);
+  MemMap map;
+#ifndef _WIN32
+  std::string cache_path = GetExtractedDexCachePath(location, entry_name, zip_entry);
+  if (!cache_path.empty()) {
+    map = MapExtractedDexCacheFile(cache_path, zip_entry);
+    if (!map.IsValid()) {
+      map = ExtractToDexCacheFile(cache_path, zip_entry);
+    }
+  }
+#endif
+  if (!map.IsValid()) {
+    map = zip_entry->ExtractToMemMap(location.c_str(), entry_name, error_msg);
+  }
+  return map;
+}
+
 }  // namespace
 
 const File DexFileLoader::kInvalidFile;
 
+void DexFileLoader::SetExtractedDexCacheDirectory(const std::string& directory) {
+#ifdef _WIN32
+  UNUSED(directory);
+#else
+  std::lock_guard<std::mutex> lock(extracted_dex_cache_lock);
+  extracted_dex_cache_directory = directory;
+#endif
+}
+
 bool DexFileLoader::IsMagicValid(uint32_t magic) {
   return IsMagicValid(reinterpret_cast<uint8_t*>(&magic));
 }
@@ -386,6 +508,7 @@ bool DexFileLoader::Open(bool verify,
       DCHECK(!error_msg->empty());
       return false;
     }
+    std::vector<MemMap> extracted_maps = ExtractZipEntriesInParallel(*zip_archive);
     size_t multidex_count = 0;
     for (size_t i = 0;; ++i) {
       std::string name = GetMultiDexClassesDexName(i);
@@ -394,6 +517,7 @@ bool DexFileLoader::Open(bool verify,
                                  location_,
                                  verify,
                                  verify_checksum,
+                                 i < extracted_maps.size() ? &extracted_maps[i] : nullptr,
                                  &multidex_count,
                                  error_code,
                                  error_msg,
@@ -505,11 +629,67 @@ std::unique_ptr<DexFile> DexFileLoader::OpenCommon(std::shared_ptr<DexFileContai
   return dex_file;
 }
 
+bool DexFileLoader::NeedsExtraction(const ZipEntry& zip_entry) const {
+  return !file_->IsValid() ||
+         !zip_entry.IsUncompressed() ||
+         !zip_entry.IsAlignedTo(alignof(DexFile::Header));
+}
+
+std::vector<MemMap> DexFileLoader::ExtractZipEntriesInParallel(
+    const ZipArchive& zip_archive) const {
+  std::vector<std::unique_ptr<ZipEntry>> zip_entries;
+  size_t num_to_extract = 0u;
+  for (size_t i = 0;; ++i) {
+    std::string error_msg;
+    std::unique_ptr<ZipEntry> zip_entry(
+        zip_archive.Find(GetMultiDexClassesDexName(i).c_str(), &error_msg));
+    if (zip_entry == nullptr) {
+      break;
+    }
+    if (zip_entry->GetUncompressedLength() == 0u || !NeedsExtraction(*zip_entry)) {
+      zip_entry.reset();  // Handled by OpenFromZipEntry().
+    } else {
+      ++num_to_extract;
+    }
+    zip_entries.push_back(std::move(zip_entry));
+  }
+  std::vector<MemMap> maps;
+  if (num_to_extract < 2u) {
+    return maps;  // Nothing to gain from extracting in parallel.
+  }
+
+  DEXFILE_SCOPED_TRACE(std::string("Extract dex files in parallel ") + location_);
+  maps.resize(zip_entries.size());
+  // Failed extractions leave an invalid map, and OpenFromZipEntry() retries and reports them.
+  std::atomic<size_t> next_index(0u);
+  auto extract = [&]() {
+    for (size_t i = next_index.fetch_add(1u); i < zip_entries.size();
+         i = next_index.fetch_add(1u)) {
+      if (zip_entries[i] != nullptr) {
+        std::string error_msg;
+        maps[i] = ExtractDexZipEntry(
+            location_, GetMultiDexClassesDexName(i).c_str(), zip_entries[i].get(), &error_msg);
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  size_t num_threads = std::min(num_to_extract, kMaxParallelExtractionThreads);
+  for (size_t i = 1u; i < num_threads; ++i) {
+    threads.emplace_back(extract);
+  }
+  extract();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return maps;
+}
+
 bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
                                      const char* entry_name,
                                      const std::string& location,
                                      bool verify,
                                      bool verify_checksum,
+                                     MemMap* extracted_map,
                                      size_t* multidex_count,
                                      DexFileLoaderErrorCode* error_code,
                                      std::string* error_msg,
@@ -529,7 +709,9 @@ bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
   CHECK(MemMap::IsInitialized());
   MemMap map;
   bool is_file_map = false;
-  if (file_->IsValid() && zip_entry->IsUncompressed()) {
+  if (extracted_map != nullptr && extracted_map->IsValid()) {
+    map = std::move(*extracted_map);
+  } else if (file_->IsValid() && zip_entry->IsUncompressed()) {
     if (!zip_entry->IsAlignedTo(alignof(DexFile::Header))) {
       // Do not mmap unaligned ZIP entries because
       // doing so would fail dex verification which requires 4 byte alignment.
@@ -548,11 +730,9 @@ bool DexFileLoader::OpenFromZipEntry(const ZipArchive& zip_archive,
     }
   }
   if (!map.IsValid()) {
-    DEXFILE_SCOPED_TRACE(std::string("Extract dex file ") + location);
-
     // Default path for compressed ZIP entries,
     // and fallback for stored ZIP entries.
-    map = zip_entry->ExtractToMemMap(location.c_str(), entry_name, error_msg);
+    map = ExtractDexZipEntry(location, entry_name, zip_entry.get(), error_msg);
   }
   if (!map.IsValid()) {
     *error_msg = StringPrintf("Failed to extract '%s' from '%s': %s", entry_name, location.c_str(),
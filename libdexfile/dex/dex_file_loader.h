@@ -35,6 +35,7 @@ namespace art {
 class MemMap;
 class OatDexFile;
 class ZipArchive;
+class ZipEntry;
 
 enum class DexFileLoaderErrorCode {
   kNoError,
@@ -150,6 +151,11 @@ class DexFileLoader {
   //     the dex_location where its file name part has been made canonical.
   static std::string GetDexCanonicalLocation(const char* dex_location);
 
+  // Set the directory where dex files that cannot be mapped directly from a zip file are
+  // extracted to, so that processes of the same app map the same extraction instead of each
+  // inflating it to anonymous memory. An empty directory disables the cache.
+  static void SetExtractedDexCacheDirectory(const std::string& directory);
+
   // For normal dex files, location and base location coincide. If a dex file is part of a multidex
   // archive, the base location is the name of the originating jar/apk, stripped of any internal
   // classes*.dex path.
@@ -320,12 +326,22 @@ class DexFileLoader {
                                              std::unique_ptr<DexFileContainer> container,
                                              VerifyResult* verify_result);
 
-  // Open .dex files from the entry_name in a zip archive.
+  // Returns whether the dex file in `zip_entry` cannot be mapped directly from the zip.
+  bool NeedsExtraction(const ZipEntry& zip_entry) const;
+
+  // Extract the dex files of a multidex zip that cannot be mapped directly on several threads.
+  // Returns a map for each classes<N>.dex entry, invalid for entries that were not extracted,
+  // or an empty vector if there are not enough entries to extract to use several threads.
+  std::vector<MemMap> ExtractZipEntriesInParallel(const ZipArchive& zip_archive) const;
+
+  // Open .dex files from the entry_name in a zip archive. If `extracted_map` is valid, it holds
+  // the entry extracted by ExtractZipEntriesInParallel() and is used instead of extracting again.
   bool OpenFromZipEntry(const ZipArchive& zip_archive,
                         const char* entry_name,
                         const std::string& location,
                         bool verify,
                         bool verify_checksum,
+                        /*inout*/ MemMap* extracted_map,
                         /*inout*/ size_t* multidex_count,
                         /*out*/ DexFileLoaderErrorCode* error_code,
                         /*out*/ std::string* error_msg,
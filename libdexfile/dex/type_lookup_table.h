@@ -31,6 +31,13 @@ class DexFile;
  * This class instantiated at compile time by calling Create() method and written into OAT file.
  * At runtime, the raw data is read from memory-mapped file by calling Open() method. The table
  * memory remains clean.
+ *
+ * A lookup uses the descriptor hash passed by the caller, which is computed once and shared by
+ * the lookups in all dex files of a class path. A minimal perfect hash function needs its own
+ * seeds for each table, so it would rehash the descriptor for each dex file. Most of these
+ * lookups are for classes that the dex file does not define, and a perfect hash still needs a
+ * string comparison to reject those, while the partial hash bits stored in each entry usually
+ * reject them without touching the string data.
  */
 class TypeLookupTable {
  public:
@@ -16,6 +16,8 @@
 
 #include "utf.h"
 
+#include <cstring>
+
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
@@ -27,6 +29,15 @@ namespace art {
 
 using android::base::StringAppendF;
 
+static constexpr uint64_t kAsciiHighBits = UINT64_C(0x8080808080808080);
+
+// Returns whether the eight bytes at `ptr` are all ASCII characters.
+static inline bool IsAsciiWord(const char* ptr) {
+  uint64_t word;
+  memcpy(&word, ptr, sizeof(word));
+  return (word & kAsciiHighBits) == 0u;
+}
+
 // This is used only from debugger and test code.
 size_t CountModifiedUtf8Chars(const char* utf8) {
   return CountModifiedUtf8Chars(utf8, strlen(utf8));
@@ -52,6 +63,14 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   size_t len = 0;
   const char* end = utf8 + byte_count;
   for (; utf8 < end; ++utf8) {
+    // Skip runs of ASCII characters eight bytes at a time.
+    while (static_cast<size_t>(end - utf8) >= sizeof(uint64_t) && IsAsciiWord(utf8)) {
+      utf8 += sizeof(uint64_t);
+      len += sizeof(uint64_t);
+    }
+    if (utf8 == end) {
+      break;
+    }
     int ic = *utf8;
     len++;
     if (LIKELY((ic & 0x80) == 0)) {
@@ -110,6 +129,16 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 
   // String contains non-ASCII characters.
   for (const char *p = in_start; p < in_end;) {
+    // Copy runs of ASCII characters eight bytes at a time.
+    while (static_cast<size_t>(in_end - p) >= sizeof(uint64_t) && IsAsciiWord(p)) {
+      for (size_t i = 0; i != sizeof(uint64_t); ++i) {
+        *out_p++ = static_cast<uint8_t>(p[i]);
+      }
+      p += sizeof(uint64_t);
+    }
+    if (p == in_end) {
+      break;
+    }
     const uint32_t ch = GetUtf16FromUtf8(&p);
     const uint16_t leading = GetLeadingUtf16Char(ch);
     const uint16_t trailing = GetTrailingUtf16Char(ch);
@@ -158,16 +187,37 @@ int32_t ComputeUtf16HashFromModifiedUtf8(const char* utf8, size_t utf16_length)
 }
 
 uint32_t ComputeModifiedUtf8Hash(const char* chars) {
-  uint32_t hash = StartModifiedUtf8Hash();
-  while (*chars != '\0') {
-    hash = UpdateModifiedUtf8Hash(hash, *chars);
-    ++chars;
+  return ComputeModifiedUtf8Hash(std::string_view(chars));
+}
+
+static constexpr uint32_t PowerOf31(size_t exponent) {
+  uint32_t result = 1u;
+  for (size_t i = 0; i != exponent; ++i) {
+    result *= 31u;
   }
-  return hash;
+  return result;
 }
 
 uint32_t ComputeModifiedUtf8Hash(std::string_view chars) {
-  return UpdateModifiedUtf8Hash(StartModifiedUtf8Hash(), chars);
+  // Hash eight characters per step. Expanding the powers of 31 gives the same result as
+  // `UpdateModifiedUtf8Hash()` one character at a time, with a much shorter dependency chain.
+  static constexpr size_t kStep = 8u;
+  static constexpr uint32_t kPowers[kStep + 1u] = {
+      PowerOf31(0u), PowerOf31(1u), PowerOf31(2u), PowerOf31(3u), PowerOf31(4u),
+      PowerOf31(5u), PowerOf31(6u), PowerOf31(7u), PowerOf31(8u)
+  };
+  uint32_t hash = StartModifiedUtf8Hash();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(chars.data());
+  size_t remaining = chars.size();
+  for (; remaining >= kStep; remaining -= kStep, data += kStep) {
+    uint32_t step_hash = 0u;
+    for (size_t i = 0; i != kStep; ++i) {
+      step_hash += data[i] * kPowers[kStep - 1u - i];
+    }
+    hash = hash * kPowers[kStep] + step_hash;
+  }
+  return UpdateModifiedUtf8Hash(
+      hash, std::string_view(reinterpret_cast<const char*>(data), remaining));
 }
 
 int CompareModifiedUtf8ToUtf16AsCodePointValues(const char* utf8, const uint16_t* utf16,
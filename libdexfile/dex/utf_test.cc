@@ -17,6 +17,7 @@
 #include "utf.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include <android-base/stringprintf.h>
@@ -387,6 +388,61 @@ TEST_F(UtfTest, NonAscii) {
   EXPECT_EQ(static_cast<uint8_t>(kNonAsciiCharacter), hash);
 }
 
+TEST_F(UtfTest, LongMixedStrings) {
+  // Runs of ASCII characters of various lengths between multi-byte sequences exercise
+  // both the word-at-a-time paths and the per-character paths.
+  for (size_t run_length = 0; run_length != 20u; ++run_length) {
+    std::string utf8;
+    std::vector<uint16_t> expected_utf16;
+    uint32_t expected_hash = StartModifiedUtf8Hash();
+    for (size_t i = 0; i != 3u; ++i) {
+      for (size_t j = 0; j != run_length; ++j) {
+        char c = static_cast<char>('a' + (i + j) % 26u);
+        utf8.push_back(c);
+        expected_utf16.push_back(static_cast<uint16_t>(c));
+      }
+      // U+00E9 in two bytes and U+20AC in three bytes.
+      for (const char* sequence : { "\xc3\xa9", "\xe2\x82\xac" }) {
+        utf8.append(sequence);
+      }
+      expected_utf16.push_back(0xe9u);
+      expected_utf16.push_back(0x20acu);
+    }
+    for (char c : utf8) {
+      expected_hash = UpdateModifiedUtf8Hash(expected_hash, c);
+    }
+
+    ASSERT_EQ(expected_utf16.size(), CountModifiedUtf8Chars(utf8.c_str(), utf8.size()));
+    std::vector<uint16_t> utf16(expected_utf16.size());
+    ConvertModifiedUtf8ToUtf16(utf16.data(), utf16.size(), utf8.c_str(), utf8.size());
+    EXPECT_EQ(expected_utf16, utf16);
+    EXPECT_EQ(expected_hash, ComputeModifiedUtf8Hash(utf8.c_str()));
+    EXPECT_EQ(expected_hash, ComputeModifiedUtf8Hash(std::string_view(utf8)));
+  }
+}
+
+TEST_F(UtfTest, ComputeUtf16Hash) {
+  // Lengths around multiples of four exercise both the unrolled loop and the remainder.
+  std::vector<uint16_t> utf16;
+  std::vector<uint8_t> latin1;
+  for (size_t length = 0; length != 20u; ++length) {
+    uint32_t expected_utf16_hash = 0u;
+    uint32_t expected_latin1_hash = 0u;
+    for (size_t i = 0; i != length; ++i) {
+      expected_utf16_hash = expected_utf16_hash * 31u + utf16[i];
+      expected_latin1_hash = expected_latin1_hash * 31u + latin1[i];
+    }
+    EXPECT_EQ(static_cast<int32_t>(expected_utf16_hash),
+              ComputeUtf16Hash(utf16.data(), utf16.size()));
+    EXPECT_EQ(static_cast<int32_t>(expected_latin1_hash),
+              ComputeUtf16Hash(latin1.data(), latin1.size()));
+    EXPECT_EQ(static_cast<int32_t>(expected_latin1_hash),
+              ComputeUtf16Hash(reinterpret_cast<const char*>(latin1.data()), latin1.size()));
+    utf16.push_back(static_cast<uint16_t>(0xfff0u + length));
+    latin1.push_back(static_cast<uint8_t>(0xf0u + length));
+  }
+}
+
 TEST_F(UtfTest, PrintableStringUtf8) {
   // Note: This is UTF-8, not Modified-UTF-8.
   const uint8_t kTestSequence[] = { 0xf0, 0x90, 0x80, 0x80, 0 };
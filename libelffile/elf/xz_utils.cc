@@ -16,6 +16,7 @@
 
 #include "xz_utils.h"
 
+#include <algorithm>
 #include <mutex>
 #include <vector>
 
@@ -134,4 +135,23 @@ void XzDecompress(ArrayRef<const uint8_t> src, std::vector<uint8_t>* dst) {
   dst->resize(dst_offset);
 }
 
+std::vector<ArrayRef<const uint8_t>> XzSplitIntoChunks(ArrayRef<const uint8_t> src,
+                                                       size_t max_chunks,
+                                                       size_t block_size) {
+  DCHECK_NE(max_chunks, 0u);
+  DCHECK_NE(block_size, 0u);
+  size_t num_blocks = RoundUp(src.size(), block_size) / block_size;
+  size_t num_chunks = std::max<size_t>(std::min(max_chunks, num_blocks), 1u);
+  size_t chunk_size = RoundUp(num_blocks, num_chunks) / num_chunks * block_size;
+  std::vector<ArrayRef<const uint8_t>> chunks;
+  chunks.reserve(num_chunks);
+  for (size_t offset = 0; offset < src.size(); offset += chunk_size) {
+    chunks.push_back(src.SubArray(offset, std::min(chunk_size, src.size() - offset)));
+  }
+  if (chunks.empty()) {
+    chunks.push_back(src);
+  }
+  return chunks;
+}
+
 }  // namespace art
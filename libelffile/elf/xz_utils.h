@@ -33,6 +33,13 @@ void XzCompress(ArrayRef<const uint8_t> src,
 
 void XzDecompress(ArrayRef<const uint8_t> src, std::vector<uint8_t>* dst);
 
+// Split `src` into at most `max_chunks` chunks made of whole compression blocks, so that
+// they can be compressed independently (e.g. on several threads). The xz format allows
+// concatenated streams, so the concatenation of the compressed chunks decompresses to `src`.
+std::vector<ArrayRef<const uint8_t>> XzSplitIntoChunks(ArrayRef<const uint8_t> src,
+                                                       size_t max_chunks,
+                                                       size_t block_size = kXzDefaultBlockSize);
+
 }  // namespace art
 
 #endif  // ART_LIBELFFILE_ELF_XZ_UTILS_H_
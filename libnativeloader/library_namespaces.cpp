@@ -446,11 +446,15 @@ Result<NativeLoaderNamespace*> LibraryNamespaces::Create(JNIEnv* env,
 
 NativeLoaderNamespace* LibraryNamespaces::FindNamespaceByClassLoader(JNIEnv* env,
                                                                      jobject class_loader) {
+  if (last_found_ != nullptr && env->IsSameObject(last_found_->first, class_loader)) {
+    return &last_found_->second;
+  }
   auto it = std::find_if(namespaces_.begin(), namespaces_.end(),
                          [&](const std::pair<jweak, NativeLoaderNamespace>& value) {
                            return env->IsSameObject(value.first, class_loader);
                          });
   if (it != namespaces_.end()) {
+    last_found_ = &*it;
     return &it->second;
   }
 
@@ -64,7 +64,7 @@ Result<ApiDomain> GetApiDomainFromPathList(const std::string& path_list);
 // object for a given ClassLoader.
 class LibraryNamespaces {
  public:
-  LibraryNamespaces() : initialized_(false), app_main_namespace_(nullptr) {}
+  LibraryNamespaces() : initialized_(false), app_main_namespace_(nullptr), last_found_(nullptr) {}
 
   LibraryNamespaces(LibraryNamespaces&&) = default;
   LibraryNamespaces(const LibraryNamespaces&) = delete;
@@ -75,6 +75,7 @@ class LibraryNamespaces {
     namespaces_.clear();
     initialized_ = false;
     app_main_namespace_ = nullptr;
+    last_found_ = nullptr;
   }
   Result<NativeLoaderNamespace*> Create(JNIEnv* env,
                                         uint32_t target_sdk_version,
@@ -94,6 +95,10 @@ class LibraryNamespaces {
   bool initialized_;
   NativeLoaderNamespace* app_main_namespace_;
   std::list<std::pair<jweak, NativeLoaderNamespace>> namespaces_;
+  // The last entry of `namespaces_` found by FindNamespaceByClassLoader(). Apps usually load all
+  // their libraries through the same class loader, so this avoids scanning `namespaces_` with a
+  // JNI call per entry on each load.
+  std::pair<jweak, NativeLoaderNamespace>* last_found_;
 };
 
 std::optional<std::string> FindApexNamespaceName(const std::string& location);
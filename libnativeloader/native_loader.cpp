@@ -22,6 +22,7 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -70,10 +71,19 @@ constexpr const char* kNativeloaderExtraLibs = "nativeloader-extra-libs";
 std::mutex g_namespaces_mutex;
 LibraryNamespaces* g_namespaces GUARDED_BY(g_namespaces_mutex) = new LibraryNamespaces;
 NativeLoaderNamespace* g_nativeloader_extra_libs_namespace GUARDED_BY(g_namespaces_mutex) = nullptr;
+// APEX namespaces looked up so far, by name. Boot classpath libraries are typically loaded from a
+// handful of APEXes, so this saves asking the linker for the same namespace on every load.
+std::map<std::string, NativeLoaderNamespace>* g_apex_namespaces GUARDED_BY(g_namespaces_mutex) =
+    new std::map<std::string, NativeLoaderNamespace>;
 
 std::optional<NativeLoaderNamespace> FindApexNamespace(const char* caller_location) {
   std::optional<std::string> name = nativeloader::FindApexNamespaceName(caller_location);
   if (name.has_value()) {
+    std::lock_guard<std::mutex> guard(g_namespaces_mutex);
+    auto it = g_apex_namespaces->find(name.value());
+    if (it != g_apex_namespaces->end()) {
+      return it->second;
+    }
     // Native Bridge is never used for APEXes.
     Result<NativeLoaderNamespace> ns =
         NativeLoaderNamespace::GetExportedNamespace(name.value(), /*is_bridged=*/false);
@@ -82,6 +92,7 @@ std::optional<NativeLoaderNamespace> FindApexNamespace(const char* caller_locati
                         name.value().c_str(),
                         caller_location,
                         ns.error().message().c_str());
+    g_apex_namespaces->emplace(name.value(), ns.value());
     return ns.value();
   }
   return std::nullopt;
@@ -196,6 +207,7 @@ void ResetNativeLoader() {
   g_namespaces->Reset();
   delete g_nativeloader_extra_libs_namespace;
   g_nativeloader_extra_libs_namespace = nullptr;
+  g_apex_namespaces->clear();
 #endif
 }
 
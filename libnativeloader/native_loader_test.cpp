@@ -118,6 +118,32 @@ TEST_P(NativeLoaderTest, OpenNativeLibraryWithoutClassloaderInApex) {
   EXPECT_EQ(errmsg, nullptr);
 }
 
+TEST_P(NativeLoaderTest, OpenNativeLibraryWithoutClassloaderInApexCachesNamespace) {
+  const char* test_lib_path = "libfoo.so";
+  void* fake_handle = &fake_handle;  // Arbitrary non-null value
+  EXPECT_CALL(*mock, mock_get_exported_namespace(false, StrEq("com_android_art"))).Times(1);
+  EXPECT_CALL(*mock,
+              mock_dlopen_ext(false, StrEq(test_lib_path), RTLD_NOW, NsEq("com_android_art")))
+      .Times(2)
+      .WillRepeatedly(Return(fake_handle));
+
+  const char* caller_location = "/apex/com.android.art/javalib/myloadinglib.jar";
+  for (int i = 0; i != 2; ++i) {
+    bool needs_native_bridge = false;
+    char* errmsg = nullptr;
+    EXPECT_EQ(fake_handle,
+              OpenNativeLibrary(env.get(),
+                                /*target_sdk_version=*/17,
+                                test_lib_path,
+                                /*class_loader=*/nullptr,
+                                caller_location,
+                                /*library_path=*/nullptr,
+                                &needs_native_bridge,
+                                &errmsg));
+    EXPECT_EQ(errmsg, nullptr);
+  }
+}
+
 TEST_P(NativeLoaderTest, OpenNativeLibraryWithoutClassloaderInFramework) {
   const char* test_lib_path = "libfoo.so";
   void* fake_handle = &fake_handle;  // Arbitrary non-null value
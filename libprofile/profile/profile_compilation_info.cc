@@ -1851,6 +1851,14 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
     return status;
   }
 
+  // If all dex files were filtered out, the other sections cannot contribute anything. Do not
+  // read and inflate them. This makes loading the profile of an unrelated split cheap.
+  if (std::none_of(dex_profile_index_remap.begin(),
+                   dex_profile_index_remap.end(),
+                   [](ProfileIndexType index) { return index != MaxProfileIndex(); })) {
+    return ProfileLoadStatus::kSuccess;
+  }
+
   // Process all other sections.
   dchecked_vector<ExtraDescriptorIndex> extra_descriptors_remap;
   for (uint32_t i = 1u; i != section_count; ++i) {
@@ -1866,18 +1874,14 @@ ProfileCompilationInfo::ProfileLoadStatus ProfileCompilationInfo::LoadInternal(
             *source, section_info, &extra_descriptors_remap, error);
         break;
       case FileSectionType::kClasses:
-        // Skip if all dex files were filtered out.
-        if (!info_.empty() && merge_classes) {
+        if (merge_classes) {
           status = ReadClassesSection(
               *source, section_info, dex_profile_index_remap, extra_descriptors_remap, error);
         }
         break;
       case FileSectionType::kMethods:
-        // Skip if all dex files were filtered out.
-        if (!info_.empty()) {
-          status = ReadMethodsSection(
-              *source, section_info, dex_profile_index_remap, extra_descriptors_remap, error);
-        }
+        status = ReadMethodsSection(
+            *source, section_info, dex_profile_index_remap, extra_descriptors_remap, error);
         break;
       case FileSectionType::kAggregationCounts:
         // This section is only used on server side.
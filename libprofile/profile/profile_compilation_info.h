@@ -438,7 +438,8 @@ class ProfileCompilationInfo {
   }
 
   // Load or Merge profile information from the given file descriptor.
-  // If the current profile is non-empty the load will fail.
+  // If the current profile is non-empty, the data is merged into it. The file data is checked
+  // as it is read, so on failure the current profile may hold part of it.
   // If merge_classes is set to false, classes will not be merged/loaded.
   // If filter_fn is present, it will be used to filter out profile data belonging
   // to dex file which do not comply with the filter
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -349,6 +350,7 @@ class OatDumperOptions {
                    const char* method_filter,
                    bool list_classes,
                    bool list_methods,
+                   bool code_size_summary,
                    bool dump_header_only,
                    const char* export_dex_location,
                    const char* app_image,
@@ -363,6 +365,7 @@ class OatDumperOptions {
         method_filter_(method_filter),
         list_classes_(list_classes),
         list_methods_(list_methods),
+        code_size_summary_(code_size_summary),
         dump_header_only_(dump_header_only),
         export_dex_location_(export_dex_location),
         app_image_(app_image),
@@ -379,6 +382,7 @@ class OatDumperOptions {
   const char* const method_filter_;
   const bool list_classes_;
   const bool list_methods_;
+  const bool code_size_summary_;
   const bool dump_header_only_;
   const char* const export_dex_location_;
   const char* const app_image_;
@@ -408,7 +412,10 @@ class OatDumper {
     CHECK(options_.class_loader_ != nullptr);
     CHECK(options_.class_filter_ != nullptr);
     CHECK(options_.method_filter_ != nullptr);
-    AddAllOffsets();
+    if (!options_.code_size_summary_) {
+      // The summary does not disassemble, so it does not need the code region boundaries.
+      AddAllOffsets();
+    }
   }
 
   ~OatDumper() {
@@ -471,8 +478,12 @@ class OatDumper {
                            GetQuickToInterpreterBridgeOffset);
     DUMP_OAT_HEADER_OFFSET("NTERP_TRAMPOLINE",
                            GetNterpTrampolineOffset);
+    DUMP_OAT_HEADER_OFFSET("STARTUP CODE", GetStartupCodeOffset);
 #undef DUMP_OAT_HEADER_OFFSET
 
+    os << "STARTUP CODE SIZE:\n";
+    os << oat_header.GetStartupCodeSize() << "\n\n";
+
     // Print the key-value store.
     {
       os << "KEY VALUE STORE:\n";
@@ -583,6 +594,11 @@ class OatDumper {
       }
     }
 
+    if (options_.code_size_summary_ && !options_.dump_header_only_) {
+      DumpCodeSizeSummary(os);
+      return success;
+    }
+
     if (!options_.dump_header_only_) {
       VariableIndentationOutputStream vios(&os);
       VdexFile::VdexFileHeader vdex_header = oat_file_.GetVdexFile()->GetVdexFileHeader();
@@ -876,6 +892,79 @@ class OatDumper {
     offsets_.insert(oat_method.GetVmapTableOffset());
   }
 
+  // Prints the compiled code size of each dex file, how much of it is in the startup code range,
+  // and the classes with the most code. This only reads the OatClass and OatMethod offsets of
+  // each class, so it is much faster than a full dump. Deduplicated code is counted once.
+  void DumpCodeSizeSummary(std::ostream& os) {
+    static constexpr size_t kNumLargestClasses = 50u;
+    const OatHeader& oat_header = oat_file_.GetOatHeader();
+    const uint32_t startup_code_begin = oat_header.GetStartupCodeOffset();
+    const uint32_t startup_code_end = startup_code_begin + oat_header.GetStartupCodeSize();
+    std::unordered_set<uint32_t> seen_code_offsets;
+    std::vector<std::pair<size_t, std::string>> class_code_sizes;
+    size_t total_num_methods = 0u;
+    size_t total_code_size = 0u;
+    size_t startup_num_methods = 0u;
+    size_t startup_code_size = 0u;
+    os << "CODE SIZE SUMMARY:\n";
+    for (const OatDexFile* oat_dex_file : oat_dex_files_) {
+      CHECK(oat_dex_file != nullptr);
+      std::string error_msg;
+      const DexFile* const dex_file = OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        os << oat_dex_file->GetDexFileLocation() << ": NOT FOUND: " << error_msg << "\n";
+        continue;
+      }
+      size_t num_methods = 0u;
+      size_t code_size = 0u;
+      for (ClassAccessor accessor : dex_file->GetClasses()) {
+        std::string class_name = DescriptorToDot(accessor.GetDescriptor());
+        if (class_name.find(options_.class_filter_) == std::string::npos) {
+          continue;
+        }
+        const OatFile::OatClass oat_class = oat_dex_file->GetOatClass(accessor.GetClassDefIndex());
+        size_t class_code_size = 0u;
+        for (uint32_t i = 0; i < accessor.NumMethods(); ++i) {
+          const OatFile::OatMethod oat_method = oat_class.GetOatMethod(i);
+          uint32_t method_code_size = oat_method.GetQuickCodeSize();
+          if (method_code_size == 0u ||
+              !seen_code_offsets.insert(oat_method.GetCodeOffset()).second) {
+            continue;
+          }
+          ++num_methods;
+          class_code_size += method_code_size;
+          uint32_t code_offset = AlignCodeOffset(oat_method.GetCodeOffset());
+          if (code_offset >= startup_code_begin && code_offset < startup_code_end) {
+            ++startup_num_methods;
+            startup_code_size += method_code_size;
+          }
+        }
+        if (class_code_size != 0u) {
+          code_size += class_code_size;
+          class_code_sizes.emplace_back(class_code_size, std::move(class_name));
+        }
+      }
+      os << oat_dex_file->GetDexFileLocation() << ": " << num_methods << " methods, "
+         << PrettySize(code_size) << "\n";
+      total_num_methods += num_methods;
+      total_code_size += code_size;
+    }
+    os << "total: " << total_num_methods << " methods, " << PrettySize(total_code_size) << "\n";
+    os << "startup code: " << startup_num_methods << " methods, " << PrettySize(startup_code_size)
+       << "\n\n";
+
+    size_t num_largest = std::min(kNumLargestClasses, class_code_sizes.size());
+    std::partial_sort(class_code_sizes.begin(),
+                      class_code_sizes.begin() + num_largest,
+                      class_code_sizes.end(),
+                      std::greater<>());
+    os << "LARGEST CLASSES BY CODE SIZE:\n";
+    for (size_t i = 0; i != num_largest; ++i) {
+      os << class_code_sizes[i].second << ": " << PrettySize(class_code_sizes[i].first) << "\n";
+    }
+    os << "\n" << std::flush;
+  }
+
   bool DumpOatDexFile(std::ostream& os, const OatDexFile& oat_dex_file) {
     bool success = true;
     bool stop_analysis = false;
@@ -1891,6 +1980,11 @@ class ImageDumper {
                                                          oat_dex_file->FileSize()));
     }
 
+    if (oat_dumper_options_->code_size_summary_) {
+      // Skip the objects and only summarize the code of the oat file.
+      return oat_dumper_->Dump(os);
+    }
+
     os << "OBJECTS:\n" << std::flush;
 
     // Loop through the image space and dump its objects.
@@ -2873,15 +2967,11 @@ class IMTDumper {
       std::cerr << "    <No IMT?>" << std::endl;
       return;
     }
-    size_t table_index = 0;
-    for (;;) {
-      ArtMethod* ptr = table->GetInterfaceMethod(table_index, pointer_size);
-      if (ptr == nullptr) {
-        return;
-      }
-      table_index++;
-      std::cerr << "    " << ptr->PrettyMethod(true) << std::endl;
-    }
+    table->Visit([](const std::pair<ArtMethod*, ArtMethod*>& methods)
+                     REQUIRES_SHARED(Locks::mutator_lock_) {
+      std::cerr << "    " << methods.first->PrettyMethod(true) << std::endl;
+      return methods;
+    }, pointer_size);
   }
 
   static ImTable* PrepareAndGetImTable(Runtime* runtime,
@@ -3020,25 +3110,23 @@ class IMTDumper {
           continue;
         }
 
-        size_t table_index = 0;
-        for (;;) {
-          ArtMethod* ptr2 = current_table->GetInterfaceMethod(table_index, pointer_size);
-          if (ptr2 == nullptr) {
-            break;
-          }
-          table_index++;
-
-          std::string p_name = ptr2->PrettyMethod(true);
-          if (android::base::StartsWith(p_name, method)) {
-            std::cerr << "  Slot "
-                      << index
-                      << " ("
-                      << current_table->NumEntries(pointer_size)
-                      << ")"
-                      << std::endl;
-            PrintTable(current_table, pointer_size);
-            return;
+        bool found = false;
+        current_table->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods)
+                                 REQUIRES_SHARED(Locks::mutator_lock_) {
+          if (!found && android::base::StartsWith(methods.first->PrettyMethod(true), method)) {
+            found = true;
           }
+          return methods;
+        }, pointer_size);
+        if (found) {
+          std::cerr << "  Slot "
+                    << index
+                    << " ("
+                    << current_table->NumEntries(pointer_size)
+                    << ")"
+                    << std::endl;
+          PrintTable(current_table, pointer_size);
+          return;
         }
       } else {
         std::string p_name = ptr->PrettyMethod(true);
@@ -3173,6 +3261,8 @@ struct OatdumpArgs : public CmdlineArgs {
       list_classes_ = true;
     } else if (StartsWith(option, "--list-methods")) {
       list_methods_ = true;
+    } else if (option == "--code-size-summary") {
+      code_size_summary_ = true;
     } else if (StartsWith(option, "--export-dex-to=")) {
       export_dex_location_ = raw_option + strlen("--export-dex-to=");
     } else if (StartsWith(option, "--addr2instr=")) {
@@ -3319,6 +3409,11 @@ Options:
         "      Example: --list-methods\n"
         "      Example: --list-methods --class-filter=com.example --method-filter=foo\n"
         "\n"
+        "  --code-size-summary may be used to print the compiled code size of each dex file,\n"
+        "      of the startup code and of the largest classes, instead of a full dump\n"
+        "      (can be used with --class-filter).\n"
+        "      Example: --code-size-summary\n"
+        "\n"
         "  --symbolize=<file.oat>: output a copy of file.oat with elf symbols included.\n"
         "      Example: --symbolize=/system/framework/boot.oat\n"
         "\n"
@@ -3384,6 +3479,7 @@ Options:
   bool only_keep_debug_ = false;
   bool list_classes_ = false;
   bool list_methods_ = false;
+  bool code_size_summary_ = false;
   bool dump_header_only_ = false;
   bool imt_stat_dump_ = false;
   uint32_t addr2instr_ = 0;
@@ -3409,6 +3505,7 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
                                                    args_->method_filter_,
                                                    args_->list_classes_,
                                                    args_->list_methods_,
+                                                   args_->code_size_summary_,
                                                    args_->dump_header_only_,
                                                    args_->export_dex_location_,
                                                    args_->app_image_,
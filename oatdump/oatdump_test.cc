@@ -65,6 +65,16 @@ TEST_P(OatDumpTest, TestListMethods) {
       GetParam(), kArgImage | kArgBcp | kArgIsa, {"--list-methods"}, kExpectImage | kExpectOat));
 }
 
+TEST_P(OatDumpTest, TestCodeSizeSummary) {
+  TEST_DISABLED_FOR_RISCV64();
+  TEST_DISABLED_FOR_ARM_AND_ARM64();
+  std::string error_msg;
+  ASSERT_TRUE(Exec(GetParam(),
+                   kArgImage | kArgBcp | kArgIsa,
+                   {"--code-size-summary"},
+                   kExpectImage | kExpectOat));
+}
+
 TEST_P(OatDumpTest, TestSymbolize) {
   if (GetParam() == Flavor::kDynamic) {
     TEST_DISABLED_FOR_TARGET();  // Can not write files inside the apex directory.
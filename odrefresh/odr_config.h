@@ -56,7 +56,8 @@ const std::unordered_set<std::string> kIgnoredSystemProperties{
     "dalvik.vm.restore-dex2oat-cpu-set",
     "dalvik.vm.restore-dex2oat-threads",
     "dalvik.vm.background-dex2oat-cpu-set",
-    "dalvik.vm.background-dex2oat-threads"};
+    "dalvik.vm.background-dex2oat-threads",
+    "dalvik.vm.systemserver-dex2oat-parallelism"};
 
 struct SystemPropertyConfig {
   const char* name;
@@ -28,6 +28,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdarg>
 #include <cstdint>
@@ -42,6 +43,7 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ostream>
 #include <set>
@@ -49,6 +51,7 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -137,6 +140,12 @@ void EraseFiles(const std::vector<std::unique_ptr<File>>& files) {
   }
 }
 
+void SetCloseOnExec(int fd) {
+  if (fcntl(fd, F_SETFD, FD_CLOEXEC) != 0) {
+    PLOG(WARNING) << "Failed to set FD_CLOEXEC on fd " << fd;
+  }
+}
+
 // Moves `files` to the directory `output_directory_path`.
 //
 // If any of the files cannot be moved, then all copies of the files are removed from both
@@ -298,23 +307,6 @@ Result<void> CheckComponents(
   return {};
 }
 
-Result<void> CheckSystemServerComponents(
-    const std::vector<art_apex::SystemServerComponent>& expected_components,
-    const std::vector<art_apex::SystemServerComponent>& actual_components) {
-  return CheckComponents<art_apex::SystemServerComponent>(
-      expected_components,
-      actual_components,
-      [](const art_apex::SystemServerComponent& expected,
-         const art_apex::SystemServerComponent& actual) -> Result<void> {
-        if (expected.getIsInClasspath() != actual.getIsInClasspath()) {
-          return Errorf("isInClasspath differs ({} != {})",
-                        expected.getIsInClasspath(),
-                        actual.getIsInClasspath());
-        }
-
-        return {};
-      });
-}
 
 template <typename T>
 std::vector<T> GenerateComponents(
@@ -445,6 +437,18 @@ Result<void> AddDex2OatConcurrencyArguments(/*inout*/ CmdlineBuilder& args,
   return {};
 }
 
+// Returns how many system server jars may be compiled at the same time. Each dex2oat
+// invocation has its own heap of up to `dalvik.vm.dex2oat-Xmx`, so this also bounds the memory
+// used by the compilation.
+size_t GetSystemServerCompilationParallelism(const OdrSystemProperties& system_properties) {
+  std::string value = system_properties.GetOrEmpty("dalvik.vm.systemserver-dex2oat-parallelism");
+  int parallelism;
+  if (value.empty() || !ParseInt(value, &parallelism, /*min=*/1)) {
+    return 1u;
+  }
+  return static_cast<size_t>(parallelism);
+}
+
 void AddDex2OatDebugInfo(/*inout*/ CmdlineBuilder& args) {
   args.Add("--generate-mini-debug-info");
   args.Add("--strip");
@@ -638,6 +642,42 @@ bool HasVettedDeviceSystemServerProfiles() {
 
 }  // namespace
 
+Result<std::set<std::string>> GetChangedSystemServerJars(
+    const std::vector<art_apex::SystemServerComponent>& expected_components,
+    const std::vector<art_apex::SystemServerComponent>& actual_components) {
+  if (expected_components.size() != actual_components.size()) {
+    return Errorf(
+        "Component count differs ({} != {})", expected_components.size(), actual_components.size());
+  }
+
+  std::set<std::string> changed_jars;
+  bool classpath_changed = false;
+  for (size_t i = 0; i < expected_components.size(); ++i) {
+    const art_apex::SystemServerComponent& expected = expected_components[i];
+    const art_apex::SystemServerComponent& actual = actual_components[i];
+
+    if (expected.getFile() != actual.getFile()) {
+      return Errorf(
+          "Component {} file differs ('{}' != '{}')", i, expected.getFile(), actual.getFile());
+    }
+
+    bool changed = expected.getSize() != actual.getSize() ||
+                   expected.getChecksums() != actual.getChecksums() ||
+                   expected.getIsInClasspath() != actual.getIsInClasspath();
+    if (changed) {
+      LOG(INFO) << ART_FORMAT("Component {} ('{}') changed", i, expected.getFile());
+      // Once a classpath jar changed, every jar from there on is recompiled, whether or not its
+      // class loader context really contains the changed jar.
+      classpath_changed |= expected.getIsInClasspath() || actual.getIsInClasspath();
+    }
+    if (changed || classpath_changed) {
+      changed_jars.insert(expected.getFile());
+    }
+  }
+
+  return changed_jars;
+}
+
 CompilationOptions CompilationOptions::CompileAll(const OnDeviceRefresh& odr) {
   CompilationOptions options;
   for (InstructionSet isa : odr.Config().GetBootClasspathIsas()) {
@@ -1039,8 +1079,13 @@ bool OnDeviceRefresh::SystemServerArtifactsExist(
     bool on_system,
     /*out*/ std::string* error_msg,
     /*out*/ std::set<std::string>* jars_missing_artifacts,
-    /*out*/ std::vector<std::string>* checked_artifacts) const {
+    /*out*/ std::vector<std::string>* checked_artifacts,
+    const std::set<std::string>& stale_jars) const {
   for (const std::string& jar_path : all_systemserver_jars_) {
+    if (ContainsElement(stale_jars, jar_path)) {
+      jars_missing_artifacts->insert(jar_path);
+      continue;
+    }
     const std::string image_location = GetSystemServerImagePath(on_system, jar_path);
     const OdrArtifacts artifacts = OdrArtifacts::ForSystemServer(image_location);
     // .art files are optional and are not generated for all jars by the build system.
@@ -1342,12 +1387,17 @@ WARN_UNUSED PreconditionCheckResult OnDeviceRefresh::CheckPreconditionForData(
     return PreconditionCheckResult::SystemServerNotOk(OdrMetrics::Trigger::kApexVersionMismatch);
   }
 
-  result = CheckSystemServerComponents(current_system_server_components,
-                                       cached_system_server_components->getComponent());
-  if (!result.ok()) {
-    LOG(INFO) << "SystemServerComponents mismatch: " << result.error();
+  Result<std::set<std::string>> changed_jars = GetChangedSystemServerJars(
+      current_system_server_components, cached_system_server_components->getComponent());
+  if (!changed_jars.ok()) {
+    LOG(INFO) << "SystemServerComponents mismatch: " << changed_jars.error();
     return PreconditionCheckResult::SystemServerNotOk(OdrMetrics::Trigger::kDexFilesChanged);
   }
+  if (!changed_jars->empty()) {
+    // Only recompile the jars whose inputs changed.
+    return PreconditionCheckResult::SystemServerJarsNotOk(OdrMetrics::Trigger::kDexFilesChanged,
+                                                          std::move(*changed_jars));
+  }
 
   return PreconditionCheckResult::AllOk();
 }
@@ -1465,8 +1515,11 @@ std::set<std::string> OnDeviceRefresh::CheckSystemServerArtifactsAreUpToDate(
   std::set<std::string> jars_missing_artifacts_on_data;
   std::string error_msg;
   if (data_result.IsSystemServerOk()) {
-    SystemServerArtifactsExist(
-        /*on_system=*/false, &error_msg, &jars_missing_artifacts_on_data, checked_artifacts);
+    SystemServerArtifactsExist(/*on_system=*/false,
+                               &error_msg,
+                               &jars_missing_artifacts_on_data,
+                               checked_artifacts,
+                               /*stale_jars=*/data_result.GetSystemServerJarsNotOk());
   } else {
     jars_missing_artifacts_on_data = AllSystemServerJars();
   }
@@ -1477,7 +1530,7 @@ std::set<std::string> OnDeviceRefresh::CheckSystemServerArtifactsAreUpToDate(
                         jars_missing_artifacts_on_data.end(),
                         std::inserter(jars_to_compile, jars_to_compile.end()));
   if (!jars_to_compile.empty()) {
-    if (data_result.IsSystemServerOk()) {
+    if (data_result.IsSystemServerOk() && data_result.GetSystemServerJarsNotOk().empty()) {
       LOG(INFO) << "Incomplete system_server artifacts on /data: " << error_msg;
       metrics.SetTrigger(OdrMetrics::Trigger::kMissingArtifacts);
     } else {
@@ -1674,7 +1727,9 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oat(
     const std::vector<std::string>& input_boot_images,
     const OdrArtifacts& artifacts,
     CmdlineBuilder&& extra_args,
-    /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii) const {
+    /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii,
+    /*inout*/ std::unique_lock<std::mutex>& spawn_lock) const {
+  DCHECK(spawn_lock.owns_lock());
   CmdlineBuilder args;
   args.Add(config_.GetDex2Oat());
 
@@ -1760,8 +1815,27 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oat(
     return CompilationResult::Ok();
   }
 
+  ExecCallbacks callbacks{
+      .on_start =
+          [&](pid_t) {
+            // dex2oat has inherited its files. Don't let dex2oat invocations that are spawned
+            // later inherit them as well.
+            for (const std::unique_ptr<File>& file : readonly_files_raii) {
+              SetCloseOnExec(file->Fd());
+            }
+            for (const std::unique_ptr<File>& file : staging_files) {
+              SetCloseOnExec(file->Fd());
+            }
+            spawn_lock.unlock();
+          },
+  };
+  ProcessStat stat;
   std::string error_msg;
-  ExecResult dex2oat_result = exec_utils_->ExecAndReturnResult(args.Get(), timeout, &error_msg);
+  ExecResult dex2oat_result =
+      exec_utils_->ExecAndReturnResult(args.Get(), timeout, callbacks, &stat, &error_msg);
+  if (spawn_lock.owns_lock()) {
+    spawn_lock.unlock();  // dex2oat could not be spawned.
+  }
 
   if (dex2oat_result.exit_code != 0) {
     return CompilationResult::Dex2oatError(
@@ -1790,6 +1864,7 @@ OnDeviceRefresh::RunDex2oatForBootClasspath(const std::string& staging_dir,
                                             const std::vector<std::string>& input_boot_images,
                                             const std::string& output_path) const {
   CmdlineBuilder args;
+  std::unique_lock<std::mutex> spawn_lock(dex2oat_spawn_lock_);
   std::vector<std::unique_ptr<File>> readonly_files_raii;
 
   // Compile as a single image for fewer files and slightly less memory overhead.
@@ -1862,7 +1937,8 @@ OnDeviceRefresh::RunDex2oatForBootClasspath(const std::string& staging_dir,
       input_boot_images,
       OdrArtifacts::ForBootImage(output_path),
       std::move(args),
-      readonly_files_raii);
+      readonly_files_raii,
+      spawn_lock);
 }
 
 WARN_UNUSED CompilationResult
@@ -1966,6 +2042,7 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oatForSystemServer(
     const std::string& dex_file,
     const std::vector<std::string>& classloader_context) const {
   CmdlineBuilder args;
+  std::unique_lock<std::mutex> spawn_lock(dex2oat_spawn_lock_);
   std::vector<std::unique_ptr<File>> readonly_files_raii;
   InstructionSet isa = config_.GetSystemServerIsa();
   std::string output_path = GetSystemServerImagePath(/*on_system=*/false, dex_file);
@@ -2026,7 +2103,8 @@ WARN_UNUSED CompilationResult OnDeviceRefresh::RunDex2oatForSystemServer(
                     GetBestBootImages(isa, /*include_mainline_extension=*/true),
                     OdrArtifacts::ForSystemServer(output_path),
                     std::move(args),
-                    readonly_files_raii);
+                    readonly_files_raii,
+                    spawn_lock);
 }
 
 WARN_UNUSED CompilationResult
@@ -2043,17 +2121,12 @@ OnDeviceRefresh::CompileSystemServer(const std::string& staging_dir,
     return CompilationResult::Error(OdrMetrics::Status::kNoSpace, "Insufficient space");
   }
 
+  // The class loader context of a jar only refers to the dex files of the jars before it, not to
+  // their compiled artifacts, so the jars can be compiled in any order.
+  std::vector<std::pair<std::string, std::vector<std::string>>> jobs;
   for (const std::string& jar : all_systemserver_jars_) {
     if (ContainsElement(system_server_jars_to_compile, jar)) {
-      CompilationResult current_result =
-          RunDex2oatForSystemServer(staging_dir, jar, classloader_context);
-      result.Merge(current_result);
-
-      if (current_result.IsOk()) {
-        on_dex2oat_success();
-      } else {
-        LOG(ERROR) << ART_FORMAT("Compilation of {} failed: {}", Basename(jar), result.error_msg);
-      }
+      jobs.emplace_back(jar, classloader_context);
     }
 
     if (ContainsElement(systemserver_classpath_jars_, jar)) {
@@ -2061,6 +2134,40 @@ OnDeviceRefresh::CompileSystemServer(const std::string& staging_dir,
     }
   }
 
+  std::vector<CompilationResult> results(jobs.size(), CompilationResult::Ok());
+  std::atomic<size_t> next_job = 0u;
+  std::mutex progress_lock;
+  auto run_jobs = [&]() {
+    for (size_t i = next_job.fetch_add(1u); i < jobs.size(); i = next_job.fetch_add(1u)) {
+      const auto& [jar, context] = jobs[i];
+      results[i] = RunDex2oatForSystemServer(staging_dir, jar, context);
+      if (results[i].IsOk()) {
+        std::lock_guard<std::mutex> lock(progress_lock);
+        on_dex2oat_success();
+      } else {
+        LOG(ERROR) << ART_FORMAT(
+            "Compilation of {} failed: {}", Basename(jar), results[i].error_msg);
+      }
+    }
+  };
+  size_t parallelism =
+      std::min(GetSystemServerCompilationParallelism(config_.GetSystemProperties()), jobs.size());
+  Timer timer;
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < parallelism; ++i) {
+    threads.emplace_back(run_jobs);
+  }
+  run_jobs();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Merge in the order of the jars, so that the reported failure does not depend on timing.
+  for (const CompilationResult& current_result : results) {
+    result.Merge(current_result);
+  }
+  // The jobs overlap, so report the wall time rather than the sum of their compilation times.
+  result.elapsed_time_ms = timer.duration().count();
   return result;
 }
 
@@ -20,10 +20,12 @@
 #include <ctime>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "android-base/function_ref.h"
@@ -129,6 +131,16 @@ class PreconditionCheckResult {
                                    /*boot_image_mainline_extension_ok=*/true,
                                    /*system_server_ok=*/false);
   }
+  // Only the artifacts of the given system server jars are invalid.
+  static PreconditionCheckResult SystemServerJarsNotOk(OdrMetrics::Trigger trigger,
+                                                       std::set<std::string>&& jars) {
+    PreconditionCheckResult result(trigger,
+                                   /*primary_boot_image_ok=*/true,
+                                   /*boot_image_mainline_extension_ok=*/true,
+                                   /*system_server_ok=*/true);
+    result.system_server_jars_not_ok_ = std::move(jars);
+    return result;
+  }
   static PreconditionCheckResult AllOk() {
     return PreconditionCheckResult(/*trigger=*/std::nullopt,
                                    /*primary_boot_image_ok=*/true,
@@ -140,6 +152,10 @@ class PreconditionCheckResult {
   bool IsPrimaryBootImageOk() const { return primary_boot_image_ok_; }
   bool IsBootImageMainlineExtensionOk() const { return boot_image_mainline_extension_ok_; }
   bool IsSystemServerOk() const { return system_server_ok_; }
+  // The system server jars whose artifacts are invalid even though `IsSystemServerOk()`.
+  const std::set<std::string>& GetSystemServerJarsNotOk() const {
+    return system_server_jars_not_ok_;
+  }
 
  private:
   // Use static factory methods instead.
@@ -157,8 +173,17 @@ class PreconditionCheckResult {
   bool primary_boot_image_ok_;
   bool boot_image_mainline_extension_ok_;
   bool system_server_ok_;
+  std::set<std::string> system_server_jars_not_ok_;
 };
 
+// Returns the system server jars whose artifacts are invalidated by the differences between the
+// components. These are the jars that changed, plus every jar from the first changed classpath
+// jar onward, because the classpath jars before a jar form its class loader context. Returns an
+// error if the set or the order of jars differs. Exposed for testing.
+android::base::Result<std::set<std::string>> GetChangedSystemServerJars(
+    const std::vector<com::android::art::SystemServerComponent>& expected_components,
+    const std::vector<com::android::art::SystemServerComponent>& actual_components);
+
 class OnDeviceRefresh final {
  public:
   explicit OnDeviceRefresh(const OdrConfig& config);
@@ -277,11 +302,13 @@ class OnDeviceRefresh final {
   // order of compilation. Returns true if all are present, false otherwise.
   // Adds the paths to the jars that are missing artifacts in `jars_with_missing_artifacts`.
   // If `checked_artifacts` is present, adds checked artifacts to `checked_artifacts`.
+  // The jars in `stale_jars` are treated as missing artifacts without checking them.
   bool SystemServerArtifactsExist(
       bool on_system,
       /*out*/ std::string* error_msg,
       /*out*/ std::set<std::string>* jars_missing_artifacts,
-      /*out*/ std::vector<std::string>* checked_artifacts = nullptr) const;
+      /*out*/ std::vector<std::string>* checked_artifacts = nullptr,
+      const std::set<std::string>& stale_jars = {}) const;
 
   // Returns true if all of the system properties listed in `kSystemProperties` are set to the
   // default values. This function is usually called when cache-info.xml does not exist (i.e.,
@@ -334,7 +361,8 @@ class OnDeviceRefresh final {
              const std::vector<std::string>& input_boot_images,
              const OdrArtifacts& artifacts,
              tools::CmdlineBuilder&& extra_args,
-             /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii) const;
+             /*inout*/ std::vector<std::unique_ptr<File>>& readonly_files_raii,
+             /*inout*/ std::unique_lock<std::mutex>& spawn_lock) const;
 
   WARN_UNUSED CompilationResult
   RunDex2oatForBootClasspath(const std::string& staging_dir,
@@ -388,6 +416,11 @@ class OnDeviceRefresh final {
 
   android::base::function_ref<bool()> check_compilation_space_;
 
+  // Held from opening the files passed to a dex2oat invocation until dex2oat is spawned, at
+  // which point the files are marked close-on-exec. Otherwise dex2oat invocations that run
+  // concurrently would inherit the files of each other.
+  mutable std::mutex dex2oat_spawn_lock_;
+
   DISALLOW_COPY_AND_ASSIGN(OnDeviceRefresh);
 };
 
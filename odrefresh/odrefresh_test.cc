@@ -16,16 +16,20 @@
 
 #include "odrefresh.h"
 
+#include <fcntl.h>
 #include <unistd.h>
 
 #include <functional>
 #include <memory>
+#include <set>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "android-base/file.h"
 #include "android-base/parseint.h"
+#include "android-base/result.h"
 #include "android-base/scopeguard.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
@@ -48,6 +52,7 @@
 namespace art {
 namespace odrefresh {
 
+using ::android::base::Result;
 using ::android::base::Split;
 using ::android::modules::sdklevel::IsAtLeastU;
 using ::testing::_;
@@ -72,6 +77,31 @@ android::base::ScopeGuard<std::function<void()>> ScopedCreateEmptyFile(const std
   return android::base::ScopeGuard([=]() { unlink(name.c_str()); });
 }
 
+// Returns the FDs passed in `--*-fd=` and `--*-fds=` flags.
+std::vector<int> GetFdsFromArgs(const std::vector<std::string>& arg_vector) {
+  std::vector<int> fds;
+  for (const std::string& arg : arg_vector) {
+    size_t pos = arg.find("-fd=");
+    size_t length = 4;
+    if (pos == std::string::npos) {
+      pos = arg.find("-fds=");
+      length = 5;
+    }
+    if (!android::base::StartsWith(arg, "--") || pos == std::string::npos) {
+      continue;
+    }
+    for (const std::string& value : Split(arg.substr(pos + length), ":")) {
+      int fd;
+      if (android::base::ParseInt(value, &fd, /*min=*/0)) {
+        fds.push_back(fd);
+      }
+    }
+  }
+  return fds;
+}
+
+bool IsCloseOnExec(int fd) { return (fcntl(fd, F_GETFD) & FD_CLOEXEC) != 0; }
+
 class MockExecUtils : public ExecUtils {
  public:
   // A workaround to avoid MOCK_METHOD on a method with an `std::string*` parameter, which will lead
@@ -82,6 +112,26 @@ class MockExecUtils : public ExecUtils {
     return {.status = ExecResult::kExited, .exit_code = DoExecAndReturnCode(arg_vector)};
   }
 
+  ExecResult ExecAndReturnResult(const std::vector<std::string>& arg_vector,
+                                 int,
+                                 const ExecCallbacks& callbacks,
+                                 ProcessStat*,
+                                 std::string*) const override {
+    // The FDs passed to dex2oat must be inherited when it is spawned, but not by the processes
+    // spawned after it.
+    std::vector<int> fds = GetFdsFromArgs(arg_vector);
+    for (int fd : fds) {
+      EXPECT_FALSE(IsCloseOnExec(fd)) << "fd " << fd;
+    }
+    callbacks.on_start(/*pid=*/0);
+    for (int fd : fds) {
+      EXPECT_TRUE(IsCloseOnExec(fd)) << "fd " << fd;
+    }
+    int exit_code = DoExecAndReturnCode(arg_vector);
+    callbacks.on_end(/*pid=*/0);
+    return {.status = ExecResult::kExited, .exit_code = exit_code};
+  }
+
   MOCK_METHOD(int, DoExecAndReturnCode, (const std::vector<std::string>& arg_vector), (const));
 };
 
@@ -578,6 +628,43 @@ TEST_F(OdRefreshTest, ContinueWhenSystemServerCompilationFailed) {
       ExitCode::kCompilationFailed);
 }
 
+TEST_F(OdRefreshTest, ParallelSystemServerJars) {
+  config_.MutableSystemProperties()->emplace("dalvik.vm.systemserver-dex2oat-parallelism", "3");
+  // The class loader contexts are the same as for sequential compilation.
+  EXPECT_CALL(*mock_exec_utils_,
+              DoExecAndReturnCode(AllOf(Contains(Flag("--dex-file=", location_provider_jar_)),
+                                        Contains("--class-loader-context=PCL[]"))))
+      .WillOnce(Return(0));
+  EXPECT_CALL(
+      *mock_exec_utils_,
+      DoExecAndReturnCode(AllOf(
+          Contains(Flag("--dex-file=", services_jar_)),
+          Contains(Flag("--class-loader-context=",
+                        ART_FORMAT("PCL[{}]", location_provider_jar_))))))
+      .WillOnce(Return(1));
+  EXPECT_CALL(
+      *mock_exec_utils_,
+      DoExecAndReturnCode(AllOf(
+          Contains(Flag("--dex-file=", services_foo_jar_)),
+          Contains(Flag("--class-loader-context=",
+                        ART_FORMAT("PCL[];PCL[{}:{}]", location_provider_jar_, services_jar_))))))
+      .WillOnce(Return(0));
+  EXPECT_CALL(
+      *mock_exec_utils_,
+      DoExecAndReturnCode(AllOf(
+          Contains(Flag("--dex-file=", services_bar_jar_)),
+          Contains(Flag("--class-loader-context=",
+                        ART_FORMAT("PCL[];PCL[{}:{}]", location_provider_jar_, services_jar_))))))
+      .WillOnce(Return(0));
+
+  EXPECT_EQ(
+      odrefresh_->Compile(*metrics_,
+                          CompilationOptions{
+                              .system_server_jars_to_compile = odrefresh_->AllSystemServerJars(),
+                          }),
+      ExitCode::kCompilationFailed);
+}
+
 // Test setup: The compiler filter is explicitly set to "speed-profile". Use it regardless of
 // whether the profile exists or not. Dex2oat will fall back to "verify" if the profile doesn't
 // exist.
@@ -993,5 +1080,72 @@ TEST_F(OdRefreshTest, CompileSystemServerChoosesBootImage_OnSystem) {
       ExitCode::kCompilationSuccess);
 }
 
+std::vector<com::android::art::SystemServerComponent> GetSystemServerComponentsForTest(
+    const std::vector<std::string>& checksums) {
+  std::vector<com::android::art::SystemServerComponent> components;
+  components.push_back({"/system/framework/a.jar", 1, checksums[0], /*isInClasspath=*/true});
+  components.push_back({"/system/framework/b.jar", 1, checksums[1], /*isInClasspath=*/true});
+  components.push_back({"/system/framework/c.jar", 1, checksums[2], /*isInClasspath=*/true});
+  components.push_back({"/system/framework/d.jar", 1, checksums[3], /*isInClasspath=*/false});
+  components.push_back({"/system/framework/e.jar", 1, checksums[4], /*isInClasspath=*/false});
+  return components;
+}
+
+TEST(OdRefreshChangedSystemServerJarsTest, Unchanged) {
+  auto components = GetSystemServerComponentsForTest({"1", "2", "3", "4", "5"});
+  Result<std::set<std::string>> changed_jars =
+      GetChangedSystemServerJars(components, components);
+  ASSERT_RESULT_OK(changed_jars);
+  EXPECT_TRUE(changed_jars->empty());
+}
+
+TEST(OdRefreshChangedSystemServerJarsTest, ClasspathJarChanged) {
+  // Recompiles the changed classpath jar and every jar after it, but not the ones before it.
+  Result<std::set<std::string>> changed_jars =
+      GetChangedSystemServerJars(GetSystemServerComponentsForTest({"1", "2", "3", "4", "5"}),
+                                 GetSystemServerComponentsForTest({"1", "x", "3", "4", "5"}));
+  ASSERT_RESULT_OK(changed_jars);
+  EXPECT_THAT(*changed_jars,
+              ElementsAre("/system/framework/b.jar",
+                          "/system/framework/c.jar",
+                          "/system/framework/d.jar",
+                          "/system/framework/e.jar"));
+}
+
+TEST(OdRefreshChangedSystemServerJarsTest, StandaloneJarChanged) {
+  // A standalone jar is not in the class loader context of any other jar.
+  Result<std::set<std::string>> changed_jars =
+      GetChangedSystemServerJars(GetSystemServerComponentsForTest({"1", "2", "3", "4", "5"}),
+                                 GetSystemServerComponentsForTest({"1", "2", "3", "x", "5"}));
+  ASSERT_RESULT_OK(changed_jars);
+  EXPECT_THAT(*changed_jars, ElementsAre("/system/framework/d.jar"));
+}
+
+TEST(OdRefreshChangedSystemServerJarsTest, ClasspathMembershipChanged) {
+  auto expected = GetSystemServerComponentsForTest({"1", "2", "3", "4", "5"});
+  auto actual = expected;
+  actual[2] = {"/system/framework/c.jar", 1, "3", /*isInClasspath=*/false};
+  Result<std::set<std::string>> changed_jars = GetChangedSystemServerJars(expected, actual);
+  ASSERT_RESULT_OK(changed_jars);
+  EXPECT_THAT(*changed_jars,
+              ElementsAre("/system/framework/c.jar",
+                          "/system/framework/d.jar",
+                          "/system/framework/e.jar"));
+}
+
+TEST(OdRefreshChangedSystemServerJarsTest, JarsReordered) {
+  auto expected = GetSystemServerComponentsForTest({"1", "2", "3", "4", "5"});
+  auto actual = expected;
+  std::swap(actual[0], actual[1]);
+  EXPECT_FALSE(GetChangedSystemServerJars(expected, actual).ok());
+}
+
+TEST(OdRefreshChangedSystemServerJarsTest, JarRemoved) {
+  auto expected = GetSystemServerComponentsForTest({"1", "2", "3", "4", "5"});
+  auto actual = expected;
+  actual.pop_back();
+  EXPECT_FALSE(GetChangedSystemServerJars(expected, actual).ok());
+}
+
 }  // namespace odrefresh
 }  // namespace art
@@ -40,6 +40,8 @@
 
 #include "art_jvmti.h"
 #include "gc/allocation_listener.h"
+#include "gc/heap.h"
+#include "gc/space/region_space.h"
 #include "instrumentation.h"
 #include "jni/jni_env_ext-inl.h"
 #include "jvmti_allocator.h"
@@ -76,6 +78,16 @@ void JvmtiWeakTable<T>::UpdateTableWithReadBarrier() {
   UpdateTableWith<decltype(WithReadBarrierUpdater), kIgnoreNull>(WithReadBarrierUpdater);
 }
 
+template <typename T>
+bool JvmtiWeakTable<T>::MayBeStoredAsFromSpaceReference(art::ObjPtr<art::mirror::Object> obj) {
+  art::gc::space::RegionSpace* region_space = art::Runtime::Current()->GetHeap()->GetRegionSpace();
+  // Newly allocated regions only hold objects allocated after the flip, which have never had a
+  // from-space copy.
+  return region_space != nullptr &&
+         region_space->IsInToSpace(obj.Ptr()) &&
+         !region_space->IsInNewlyAllocatedRegion(obj.Ptr());
+}
+
 template <typename T>
 bool JvmtiWeakTable<T>::GetTagSlowPath(art::Thread* self, art::ObjPtr<art::mirror::Object> obj, T* result) {
   // Under concurrent GC, there is a window between moving objects and sweeping of system
@@ -114,7 +126,10 @@ bool JvmtiWeakTable<T>::RemoveLocked(art::Thread* self, art::ObjPtr<art::mirror:
     return true;
   }
 
-  if (art::gUseReadBarrier && self->GetIsGcMarking() && !update_since_last_sweep_) {
+  if (art::gUseReadBarrier &&
+      self->GetIsGcMarking() &&
+      !update_since_last_sweep_ &&
+      MayBeStoredAsFromSpaceReference(obj)) {
     // Under concurrent GC, there is a window between moving objects and sweeping of system
     // weaks in which mutators are active. We may receive a to-space object pointer in obj,
     // but still have from-space pointers in the table. Explicitly update the table once.
@@ -156,7 +171,10 @@ bool JvmtiWeakTable<T>::SetLocked(art::Thread* self, art::ObjPtr<art::mirror::Ob
     return true;
   }
 
-  if (art::gUseReadBarrier && self->GetIsGcMarking() && !update_since_last_sweep_) {
+  if (art::gUseReadBarrier &&
+      self->GetIsGcMarking() &&
+      !update_since_last_sweep_ &&
+      MayBeStoredAsFromSpaceReference(obj)) {
     // Under concurrent GC, there is a window between moving objects and sweeping of system
     // weaks in which mutators are active. We may receive a to-space object pointer in obj,
     // but still have from-space pointers in the table. Explicitly update the table once.
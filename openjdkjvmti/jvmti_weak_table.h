@@ -155,13 +155,22 @@ class JvmtiWeakTable : public art::gc::SystemWeakHolder {
     if (art::gUseReadBarrier &&
         self != nullptr &&
         self->GetIsGcMarking() &&
-        !update_since_last_sweep_) {
+        !update_since_last_sweep_ &&
+        MayBeStoredAsFromSpaceReference(obj)) {
       return GetTagSlowPath(self, obj, result);
     }
 
     return false;
   }
 
+  // Returns whether the table may hold a from-space reference for the to-space reference `obj`
+  // during concurrent copying, i.e. whether `obj` was evacuated by the current collection. Objects
+  // allocated since the collection started, or not moved by it, are always stored as looked up,
+  // so a lookup that misses them does not need to update the table.
+  ALWAYS_INLINE
+  static bool MayBeStoredAsFromSpaceReference(art::ObjPtr<art::mirror::Object> obj)
+      REQUIRES_SHARED(art::Locks::mutator_lock_);
+
   // Slow-path for GetTag. We didn't find the object, but we might be storing from-pointers and
   // are asked to retrieve with a to-pointer.
   ALWAYS_INLINE
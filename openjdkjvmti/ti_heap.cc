@@ -758,6 +758,9 @@ static jvmtiError DoIterateThroughHeap(T fn,
   const HeapFilter heap_filter(heap_filter_int);
   art::StackHandleScope<1> hs(self);
   art::Handle<art::mirror::Class> filter_klass(hs.NewHandle(soa.Decode<art::mirror::Class>(klass)));
+  // Objects of the same class tend to be allocated together, so remember the last class tag.
+  art::mirror::Class* last_klass = nullptr;
+  jlong last_class_tag = 0;
   auto visitor = [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
     // Early return, as we can't really stop visiting.
     if (stop_reports) {
@@ -766,22 +769,33 @@ static jvmtiError DoIterateThroughHeap(T fn,
 
     art::ScopedAssertNoThreadSuspension no_suspension("IterateThroughHeapCallback");
 
-    jlong tag = 0;
-    tag_table->GetTag(obj, &tag);
-
-    jlong class_tag = 0;
+    // Apply the class filter first, as it does not need the tags.
     art::ObjPtr<art::mirror::Class> klass = obj->GetClass();
-    tag_table->GetTag(klass.Ptr(), &class_tag);
+    if (filter_klass != nullptr) {
+      if (filter_klass.Get() != klass) {
+        return;
+      }
+    }
+
+    jlong tag = 0;
+    tag_table->Lock();
+    tag_table->GetTagLocked(obj, &tag);
+    if (klass.Ptr() != last_klass) {
+      last_klass = klass.Ptr();
+      last_class_tag = 0;
+      tag_table->GetTagLocked(klass, &last_class_tag);
+    }
+    tag_table->Unlock();
+    jlong class_tag = last_class_tag;
     // For simplicity, even if we find a tag = 0, assume 0 = not tagged.
 
     if (!heap_filter.ShouldReportByHeapFilter(tag, class_tag)) {
       return;
     }
 
-    if (filter_klass != nullptr) {
-      if (filter_klass.Get() != klass) {
-        return;
-      }
+    if (obj->IsClass()) {
+      // The callbacks below may change the tag of this class, which may be the cached one.
+      last_klass = nullptr;
     }
 
     jlong size = obj->SizeOf();
@@ -1724,23 +1724,10 @@ bool CompareClasses(art::ObjPtr<art::mirror::Class> l, art::ObjPtr<art::mirror::
 }
 
 bool Redefiner::ClassRedefinition::CollectAndCreateNewInstances(
+    const std::vector<art::Handle<art::mirror::Object>>& old_instances,
     /*out*/ RedefinitionDataIter* cur_data) {
-  if (!cur_data->IsInitialStructural()) {
-    // An earlier structural redefinition already remade all the instances.
-    return true;
-  }
-  art::gc::Heap* heap = driver_->runtime_->GetHeap();
+  DCHECK(cur_data->IsInitialStructural());
   art::VariableSizedHandleScope hs(driver_->self_);
-  art::Handle<art::mirror::Class> old_klass(hs.NewHandle(cur_data->GetMirrorClass()));
-  std::vector<art::Handle<art::mirror::Object>> old_instances;
-  auto is_instance = [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    return obj->InstanceOf(old_klass.Get());
-  };
-  heap->VisitObjects([&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    if (is_instance(obj)) {
-      old_instances.push_back(hs.NewHandle(obj));
-    }
-  });
   VLOG(plugin) << "Collected " << old_instances.size() << " instances to recreate!";
   art::Handle<art::mirror::ObjectArray<art::mirror::Class>> old_classes_arr(
       hs.NewHandle(cur_data->GetOldClasses()));
@@ -2204,9 +2191,52 @@ bool Redefiner::EnsureAllClassAllocationsFinished(RedefinitionDataHolder& holder
 }
 
 bool Redefiner::CollectAndCreateNewInstances(RedefinitionDataHolder& holder) {
+  // Find the instances of every initial structural redefinition in a single heap walk. The old
+  // classes arrays already hold each redefined class together with all its subtypes, so an object
+  // belongs to a redefinition exactly when its class is in that redefinition's old classes.
+  size_t num_redefinitions = 0;
+  bool any_structural = false;
   for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
+    ++num_redefinitions;
+    any_structural = any_structural || data.IsInitialStructural();
+  }
+  art::VariableSizedHandleScope hs(self_);
+  std::vector<std::vector<art::Handle<art::mirror::Object>>> old_instances(num_redefinitions);
+  if (any_structural) {
+    // Built inside the walk since classes might move before it suspends the other threads.
+    std::unordered_map<art::mirror::Class*, std::vector<int32_t>> redefinitions_by_class;
+    bool built_index = false;
+    runtime_->GetHeap()->VisitObjects(
+        [&](art::mirror::Object* obj) REQUIRES_SHARED(art::Locks::mutator_lock_) {
+          if (UNLIKELY(!built_index)) {
+            for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
+              if (!data.IsInitialStructural()) {
+                continue;
+              }
+              for (art::ObjPtr<art::mirror::Class> k :
+                   data.GetOldClasses()->Iterate<art::mirror::Class>()) {
+                redefinitions_by_class[k.Ptr()].push_back(data.GetIndex());
+              }
+            }
+            built_index = true;
+          }
+          auto it = redefinitions_by_class.find(obj->GetClass());
+          if (it != redefinitions_by_class.end()) {
+            art::Handle<art::mirror::Object> hobj(hs.NewHandle(obj));
+            for (int32_t index : it->second) {
+              old_instances[index].push_back(hobj);
+            }
+          }
+        });
+  }
+  for (RedefinitionDataIter data = holder.begin(); data != holder.end(); ++data) {
+    if (!data.IsInitialStructural()) {
+      // An earlier structural redefinition already remade all the instances.
+      continue;
+    }
     // Allocate the data this redefinition requires.
-    if (!data.GetRedefinition().CollectAndCreateNewInstances(&data)) {
+    if (!data.GetRedefinition().CollectAndCreateNewInstances(old_instances[data.GetIndex()],
+                                                             &data)) {
       return false;
     }
   }
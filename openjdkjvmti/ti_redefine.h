@@ -175,8 +175,11 @@ class Redefiner {
     bool FinishNewClassAllocations(RedefinitionDataHolder& holder,
                                    /*out*/RedefinitionDataIter* cur_data)
         REQUIRES_SHARED(art::Locks::mutator_lock_);
-    bool CollectAndCreateNewInstances(/*out*/RedefinitionDataIter* cur_data)
-        REQUIRES_SHARED(art::Locks::mutator_lock_);
+    // Creates the replacement objects for `old_instances`, the instances of the class and all its
+    // subtypes found by `Redefiner::CollectAndCreateNewInstances`.
+    bool CollectAndCreateNewInstances(
+        const std::vector<art::Handle<art::mirror::Object>>& old_instances,
+        /*out*/RedefinitionDataIter* cur_data) REQUIRES_SHARED(art::Locks::mutator_lock_);
 
     bool AllocateAndRememberNewDexFileCookie(
         art::Handle<art::mirror::ClassLoader> source_class_loader,
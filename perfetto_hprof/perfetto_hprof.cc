@@ -894,7 +894,9 @@ class HeapGraphDumper {
 
   // Returns true if `*obj` has a type that's supposed to be ignored.
   bool IsIgnored(art::mirror::Object* obj) const REQUIRES_SHARED(art::Locks::mutator_lock_) {
-    if (obj->IsClass()) {
+    // This is called for every object and every reference, so avoid building the descriptor
+    // in the common case where nothing is ignored.
+    if (ignored_types_.empty() || obj->IsClass()) {
       return false;
     }
     art::mirror::Class* klass = obj->GetClass();
@@ -50,11 +50,27 @@ ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
   uint32_t number_of_classes = info.GetNumberOfResolvedClasses();
 
   // Merge all current profiles.
+  bool ignore_load_failures = options.IsForceMerge() || options.IsForceMergeAndAnalyze();
   for (size_t i = 0; i < profile_files.size(); i++) {
-    ProfileCompilationInfo cur_info(options.IsBootImageMerge());
-    if (!cur_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
+    int fd = profile_files[i]->Fd();
+    bool loaded;
+    if (ignore_load_failures) {
+      // Skipping a profile that fails to load requires loading it separately, so that a failure
+      // half way through does not leave part of it in the merged profile.
+      ProfileCompilationInfo cur_info(options.IsBootImageMerge());
+      loaded = cur_info.Load(fd, /*merge_classes=*/ true, filter_fn);
+      if (loaded && !info.MergeWith(cur_info)) {
+        LOG(WARNING) << "Could not merge profile file at index " << i;
+        return ProfmanResult::kErrorBadProfiles;
+      }
+    } else {
+      // Any failure aborts the merge, so read the profile straight into the merged one. This
+      // avoids building a copy of each profile only to remap and merge it afterwards.
+      loaded = info.Load(fd, /*merge_classes=*/ true, filter_fn);
+    }
+    if (!loaded) {
       LOG(WARNING) << "Could not load profile file at index " << i;
-      if (options.IsForceMerge() || options.IsForceMergeAndAnalyze()) {
+      if (ignore_load_failures) {
         // If we have to merge forcefully, ignore load failures.
         // This is useful for boot image profiles to ignore stale profiles which are
         // cleared lazily.
@@ -62,16 +78,11 @@ ProfmanResult::ProcessingResult ProfileAssistant::ProcessProfilesInternal(
       }
       // TODO: Do we really need to use a different error code for version mismatch?
       ProfileCompilationInfo wrong_info(!options.IsBootImageMerge());
-      if (wrong_info.Load(profile_files[i]->Fd(), /*merge_classes=*/ true, filter_fn)) {
+      if (wrong_info.Load(fd, /*merge_classes=*/ true, filter_fn)) {
         return ProfmanResult::kErrorDifferentVersions;
       }
       return ProfmanResult::kErrorBadProfiles;
     }
-
-    if (!info.MergeWith(cur_info)) {
-      LOG(WARNING) << "Could not merge profile file at index " << i;
-      return ProfmanResult::kErrorBadProfiles;
-    }
   }
 
   // If we perform a forced merge do not analyze the difference between profiles.
@@ -599,7 +599,12 @@ static void TestUnlockObject(StubTest* test) NO_THREAD_SAFETY_ANALYSIS {
       if (counts[index] == 0) {
         EXPECT_EQ(LockWord::LockState::kHashCode, iter_state);
       } else {
-        EXPECT_EQ(LockWord::LockState::kFatLocked, iter_state);
+        // The hash code of an object we hold a thin lock on does not inflate the lock.
+        EXPECT_EQ(LockWord::LockState::kThinLocked, iter_state);
+        EXPECT_TRUE(lock_iter.ThinLockHasHashCode());
+        Monitor::InflateThinLocked(self, objects[index], lock_iter, 0u);
+        EXPECT_EQ(LockWord::LockState::kFatLocked,
+                  objects[index]->GetLockWord(false).GetState());
       }
     } else {
       bool take_lock;  // Whether to lock or unlock in this step.
@@ -765,6 +765,18 @@ inline void ArtMethod::UpdateCounter(int32_t new_samples) {
   }
 }
 
+inline void ArtMethod::DecayCounter(uint16_t threshold) {
+  if (IsAbstract() || IsMemorySharedMethod()) {
+    return;
+  }
+  uint16_t old_hotness_count = hotness_count_;
+  // A zero counter is either about to be reset, or was explicitly made hot.
+  if (old_hotness_count == 0u || old_hotness_count >= threshold) {
+    return;
+  }
+  hotness_count_ = threshold - (threshold - old_hotness_count) / 2u;
+}
+
 inline bool ArtMethod::CounterIsHot() {
   DCHECK(!IsAbstract());
   return hotness_count_ == 0;
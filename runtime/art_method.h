@@ -987,6 +987,8 @@ class EXPORT ArtMethod final {
 
   ALWAYS_INLINE void ResetCounter(uint16_t new_value);
   ALWAYS_INLINE void UpdateCounter(int32_t new_samples);
+  // Halve the samples accumulated since the counter was reset to `threshold`.
+  ALWAYS_INLINE void DecayCounter(uint16_t threshold);
   ALWAYS_INLINE void SetHotCounter();
   ALWAYS_INLINE bool CounterIsHot();
   ALWAYS_INLINE uint16_t GetCounter();
@@ -29,6 +29,9 @@
 
 #include "base/bit_utils.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
+#include "jit/debugger_interface.h"
+#include "jit/jit.h"
+#include "runtime.h"
 #include "thread-inl.h"
 
 #else
@@ -89,7 +92,13 @@ struct UnwindHelper : public TLSData {
 };
 
 void BacktraceCollector::Collect() {
-  unwindstack::Unwinder* unwinder = UnwindHelper::Get(Thread::Current(), max_depth_)->Unwinder();
+  Thread* self = Thread::Current();
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr && jit->LazyMiniDebugInfo() && !Locks::jit_lock_->IsExclusiveHeld(self)) {
+    // The unwinder needs the debug info of JIT code to walk through JIT frames.
+    MaterializeNativeDebugInfoForJit();
+  }
+  unwindstack::Unwinder* unwinder = UnwindHelper::Get(self, max_depth_)->Unwinder();
   if (!CollectImpl(unwinder)) {
     // Reparse process mmaps to detect newly loaded libraries and retry,
     // but only if any maps changed (we don't want to hide racy failures).
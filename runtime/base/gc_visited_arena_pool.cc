@@ -407,6 +407,21 @@ void GcVisitedArenaPool::FreeArenaChain(Arena* first) {
   }
 }
 
+void GcVisitedArenaPool::ReleaseFreedPages(uint8_t* begin, size_t size) {
+  DCHECK_ALIGNED_PARAM(begin, gPageSize);
+  DCHECK_ALIGNED_PARAM(size, gPageSize);
+  // Hold the lock exclusively to serialize with MarkCompact::ProcessLinearAlloc().
+  WriterMutexLock wmu(Thread::Current(), lock_);
+  if (defer_arena_freeing_) {
+    // The userfaultfd GC is between its compaction pause and the end of compaction and
+    // could map stale contents of these pages again. Keep them; this only costs memory.
+    return;
+  }
+  // Pre-zygote-fork arenas are also handled here since MADV_REMOVE fails with
+  // EINVAL on their private anonymous mappings.
+  TrackedArena::ReleasePages(begin, size, /*pre_zygote_fork=*/false);
+}
+
 void GcVisitedArenaPool::DeleteUnusedArenas() {
   TrackedArena* arena;
   {
@@ -212,6 +212,10 @@ class GcVisitedArenaPool final : public ArenaPool {
   // Clear defer_arena_freeing_ and delete all unused arenas.
   void DeleteUnusedArenas() REQUIRES(!lock_);
 
+  // Release the page-aligned range [begin, begin + size) of an allocated arena which only
+  // holds freed allocations. The range stays allocated and reads as zeros afterwards.
+  EXPORT void ReleaseFreedPages(uint8_t* begin, size_t size) REQUIRES(!lock_);
+
  private:
   void FreeRangeLocked(uint8_t* range_begin, size_t range_size) REQUIRES(lock_);
   // Add a map (to be visited by userfaultfd) to the pool of at least min_size
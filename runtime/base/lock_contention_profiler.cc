@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lock_contention_profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+
+#include "base/bit_utils.h"
+#include "base/logging.h"
+#include "base/systrace.h"
+#include "base/time_utils.h"
+
+namespace art HIDDEN {
+
+std::atomic<uint32_t> LockContentionProfiler::sampling_interval_(0u);
+std::atomic<uint32_t> LockContentionProfiler::sample_counter_(0u);
+std::atomic<uint64_t> LockContentionProfiler::dropped_samples_(0u);
+LockContentionProfiler::Site LockContentionProfiler::sites_[kMaxSites];
+
+void LockContentionProfiler::SetSamplingInterval(uint32_t interval) {
+  sampling_interval_.store(interval, std::memory_order_relaxed);
+}
+
+size_t LockContentionProfiler::BucketForWait(uint64_t wait_ns) {
+  uint64_t wait_us = wait_ns / 1000u;
+  if (wait_us < 2u) {
+    return 0u;
+  }
+  return std::min<size_t>(MostSignificantBit(wait_us), kNumBuckets - 1u);
+}
+
+LockContentionProfiler::Site* LockContentionProfiler::FindOrAddSite(uintptr_t site,
+                                                                    std::string_view name) {
+  DCHECK_NE(site, 0u);
+  static_assert(IsPowerOfTwo(kMaxSites));
+  size_t index = (site * UINT64_C(0x9e3779b97f4a7c15)) >> (64 - WhichPowerOf2(kMaxSites));
+  for (size_t probe = 0; probe != kMaxSites; ++probe) {
+    Site* entry = &sites_[(index + probe) & (kMaxSites - 1u)];
+    uintptr_t key = entry->key.load(std::memory_order_acquire);
+    if (key == site) {
+      return entry;
+    }
+    if (key == 0u) {
+      if (entry->key.compare_exchange_strong(key, site, std::memory_order_acq_rel)) {
+        // We own the new entry. Readers ignore the name until it is published.
+        size_t length = std::min(name.size(), kMaxNameLength - 1u);
+        memcpy(entry->name, name.data(), length);
+        entry->name[length] = '\0';
+        entry->named.store(true, std::memory_order_release);
+        return entry;
+      }
+      if (key == site) {
+        return entry;  // Another thread added the same site.
+      }
+    }
+  }
+  return nullptr;
+}
+
+bool LockContentionProfiler::HasSite(uintptr_t site) {
+  DCHECK_NE(site, 0u);
+  size_t index = (site * UINT64_C(0x9e3779b97f4a7c15)) >> (64 - WhichPowerOf2(kMaxSites));
+  for (size_t probe = 0; probe != kMaxSites; ++probe) {
+    uintptr_t key = sites_[(index + probe) & (kMaxSites - 1u)].key.load(std::memory_order_acquire);
+    if (key == site) {
+      return true;
+    }
+    if (key == 0u) {
+      return false;
+    }
+  }
+  return false;
+}
+
+void LockContentionProfiler::RecordWait(uintptr_t site, std::string_view name, uint64_t wait_ns) {
+  Site* entry = FindOrAddSite(site, name);
+  if (entry == nullptr) {
+    dropped_samples_.fetch_add(1u, std::memory_order_relaxed);
+    return;
+  }
+  entry->count.fetch_add(1u, std::memory_order_relaxed);
+  entry->total_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  uint64_t max_ns = entry->max_ns.load(std::memory_order_relaxed);
+  while (wait_ns > max_ns &&
+         !entry->max_ns.compare_exchange_weak(max_ns, wait_ns, std::memory_order_relaxed)) {
+  }
+  entry->buckets[BucketForWait(wait_ns)].fetch_add(1u, std::memory_order_relaxed);
+  if (ATraceEnabled()) {
+    std::string counter_name = "Lock contention (us) ";
+    // Prefer the name of the site, `name` may be empty if the site was known to the caller.
+    counter_name.append(
+        entry->named.load(std::memory_order_acquire) ? std::string_view(entry->name) : name);
+    uint64_t wait_us = wait_ns / 1000u;
+    ATraceIntegerValue(counter_name.c_str(),
+                       static_cast<int32_t>(std::min<uint64_t>(
+                           wait_us, std::numeric_limits<int32_t>::max())));
+  }
+}
+
+void LockContentionProfiler::Dump(std::ostream& os) {
+  uint32_t interval = sampling_interval_.load(std::memory_order_relaxed);
+  if (interval == 0u) {
+    return;
+  }
+  os << "Lock contention samples (1 in " << interval << " contentions):\n";
+  for (const Site& entry : sites_) {
+    if (entry.key.load(std::memory_order_acquire) == 0u ||
+        !entry.named.load(std::memory_order_acquire)) {
+      continue;
+    }
+    uint64_t count = entry.count.load(std::memory_order_relaxed);
+    if (count == 0u) {
+      continue;
+    }
+    uint64_t total_ns = entry.total_ns.load(std::memory_order_relaxed);
+    os << "  " << entry.name << ": " << count << " samples, mean "
+       << PrettyDuration(total_ns / count) << ", max "
+       << PrettyDuration(entry.max_ns.load(std::memory_order_relaxed)) << "\n    ";
+    // Print the non-empty buckets as "<upper bound in us>:<count>".
+    for (size_t i = 0; i != kNumBuckets; ++i) {
+      uint64_t bucket_count = entry.buckets[i].load(std::memory_order_relaxed);
+      if (bucket_count != 0u) {
+        if (i == kNumBuckets - 1u) {
+          os << " >" << (UINT64_C(1) << i) << "us:" << bucket_count;
+        } else {
+          os << " <" << (UINT64_C(2) << i) << "us:" << bucket_count;
+        }
+      }
+    }
+    os << "\n";
+  }
+  uint64_t dropped = dropped_samples_.load(std::memory_order_relaxed);
+  if (dropped != 0u) {
+    os << "  (" << dropped << " samples at untracked sites)\n";
+  }
+}
+
+void LockContentionProfiler::ResetForTesting() {
+  for (Site& entry : sites_) {
+    entry.key.store(0u, std::memory_order_relaxed);
+    entry.named.store(false, std::memory_order_relaxed);
+    entry.count.store(0u, std::memory_order_relaxed);
+    entry.total_ns.store(0u, std::memory_order_relaxed);
+    entry.max_ns.store(0u, std::memory_order_relaxed);
+    for (std::atomic<uint64_t>& bucket : entry.buckets) {
+      bucket.store(0u, std::memory_order_relaxed);
+    }
+  }
+  dropped_samples_.store(0u, std::memory_order_relaxed);
+  sample_counter_.store(0u, std::memory_order_relaxed);
+}
+
+}  // namespace art
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_BASE_LOCK_CONTENTION_PROFILER_H_
+#define ART_RUNTIME_BASE_LOCK_CONTENTION_PROFILER_H_
+
+#include <atomic>
+#include <iosfwd>
+#include <string_view>
+
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+// Sampling profiler for contended acquisitions of monitors and runtime mutexes.
+//
+// One in every `interval` contended acquisitions is timed. The wait is added to a histogram
+// of wait times for its lock site, and emitted as a trace counter named after the site so
+// that it shows up next to the existing contention slices in Perfetto traces. Recording is
+// lock-free since it runs on the contention path of the runtime's own mutexes.
+class LockContentionProfiler {
+ public:
+  // Number of power-of-two buckets of the wait time histograms, in microseconds. The last
+  // bucket holds all waits of more than a second.
+  static constexpr size_t kNumBuckets = 21;
+  // Maximum number of distinct lock sites. Further sites are only counted in total.
+  static constexpr size_t kMaxSites = 256;
+
+  // Sample one in `interval` contended acquisitions, or none if `interval` is zero.
+  EXPORT static void SetSamplingInterval(uint32_t interval);
+
+  static bool IsEnabled() {
+    return sampling_interval_.load(std::memory_order_relaxed) != 0u;
+  }
+
+  // Returns whether the contended acquisition that is about to block should be timed.
+  ALWAYS_INLINE static bool ShouldSample() {
+    uint32_t interval = sampling_interval_.load(std::memory_order_relaxed);
+    return UNLIKELY(interval != 0u) &&
+           sample_counter_.fetch_add(1u, std::memory_order_relaxed) % interval == 0u;
+  }
+
+  // Record a sampled wait of `wait_ns` at the lock site identified by the non-zero `site`.
+  // The site keeps the `name` it was first recorded with.
+  EXPORT static void RecordWait(uintptr_t site, std::string_view name, uint64_t wait_ns);
+
+  // Returns whether `site` was already recorded. Callers with expensive names use this to
+  // only build the name for the first sample of a site.
+  EXPORT static bool HasSite(uintptr_t site);
+
+  // Print the wait time histograms of all sites seen so far.
+  EXPORT static void Dump(std::ostream& os);
+
+  // Forget all sites. Only safe when no thread records concurrently.
+  EXPORT static void ResetForTesting();
+
+  // Returns the histogram bucket of a wait of `wait_ns`.
+  static size_t BucketForWait(uint64_t wait_ns);
+
+ private:
+  static constexpr size_t kMaxNameLength = 128;
+
+  struct Site {
+    std::atomic<uintptr_t> key;
+    std::atomic<bool> named;
+    char name[kMaxNameLength];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total_ns;
+    std::atomic<uint64_t> max_ns;
+    std::atomic<uint64_t> buckets[kNumBuckets];
+  };
+
+  static Site* FindOrAddSite(uintptr_t site, std::string_view name);
+
+  static std::atomic<uint32_t> sampling_interval_;
+  static std::atomic<uint32_t> sample_counter_;
+  static std::atomic<uint64_t> dropped_samples_;
+  static Site sites_[kMaxSites];
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(LockContentionProfiler);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_BASE_LOCK_CONTENTION_PROFILER_H_
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lock_contention_profiler.h"
+
+#include <sstream>
+
+#include "base/common_art_test.h"
+
+namespace art HIDDEN {
+
+class LockContentionProfilerTest : public CommonArtTest {
+ protected:
+  void TearDown() override {
+    LockContentionProfiler::SetSamplingInterval(0u);
+    LockContentionProfiler::ResetForTesting();
+    CommonArtTest::TearDown();
+  }
+};
+
+TEST_F(LockContentionProfilerTest, Buckets) {
+  EXPECT_EQ(0u, LockContentionProfiler::BucketForWait(0u));
+  EXPECT_EQ(0u, LockContentionProfiler::BucketForWait(1999u));
+  EXPECT_EQ(1u, LockContentionProfiler::BucketForWait(2000u));
+  EXPECT_EQ(1u, LockContentionProfiler::BucketForWait(3999u));
+  EXPECT_EQ(2u, LockContentionProfiler::BucketForWait(4000u));
+  EXPECT_EQ(LockContentionProfiler::kNumBuckets - 1u,
+            LockContentionProfiler::BucketForWait(UINT64_C(3600) * 1000 * 1000 * 1000));
+}
+
+TEST_F(LockContentionProfilerTest, Sampling) {
+  EXPECT_FALSE(LockContentionProfiler::IsEnabled());
+  EXPECT_FALSE(LockContentionProfiler::ShouldSample());
+
+  LockContentionProfiler::SetSamplingInterval(4u);
+  EXPECT_TRUE(LockContentionProfiler::IsEnabled());
+  size_t num_sampled = 0u;
+  for (size_t i = 0; i != 40u; ++i) {
+    if (LockContentionProfiler::ShouldSample()) {
+      ++num_sampled;
+    }
+  }
+  EXPECT_EQ(10u, num_sampled);
+}
+
+TEST_F(LockContentionProfilerTest, RecordAndDump) {
+  LockContentionProfiler::SetSamplingInterval(1u);
+  LockContentionProfiler::RecordWait(1u, "first site", 3000u);
+  LockContentionProfiler::RecordWait(1u, "ignored name", 5000u);
+  LockContentionProfiler::RecordWait(2u, "second site", 1000u);
+
+  std::ostringstream oss;
+  LockContentionProfiler::Dump(oss);
+  std::string dump = oss.str();
+  EXPECT_NE(std::string::npos, dump.find("first site: 2 samples")) << dump;
+  EXPECT_NE(std::string::npos, dump.find("second site: 1 samples")) << dump;
+  EXPECT_EQ(std::string::npos, dump.find("ignored name")) << dump;
+  EXPECT_NE(std::string::npos, dump.find("<4us:1 <8us:1")) << dump;
+}
+
+TEST_F(LockContentionProfilerTest, HasSite) {
+  LockContentionProfiler::SetSamplingInterval(1u);
+  EXPECT_FALSE(LockContentionProfiler::HasSite(1u));
+  LockContentionProfiler::RecordWait(1u, "first site", 3000u);
+  EXPECT_TRUE(LockContentionProfiler::HasSite(1u));
+  EXPECT_FALSE(LockContentionProfiler::HasSite(2u));
+
+  // A known site is recorded under its first name, even without a name.
+  LockContentionProfiler::RecordWait(1u, "", 5000u);
+  std::ostringstream oss;
+  LockContentionProfiler::Dump(oss);
+  EXPECT_NE(std::string::npos, oss.str().find("first site: 2 samples")) << oss.str();
+}
+
+}  // namespace art
@@ -83,9 +83,10 @@ MemMapArena::~MemMapArena() {
 }
 
 void MemMapArena::Release() {
-  if (bytes_allocated_ > 0) {
+  if (bytes_allocated_ > 0 || dirty_bytes_ > 0) {
     map_.MadviseDontNeedAndZero();
     bytes_allocated_ = 0;
+    dirty_bytes_ = 0;
   }
 }
 
@@ -114,6 +115,18 @@ void MemMapArenaPool::LockReclaimMemory() {
 }
 
 Arena* MemMapArenaPool::AllocArena(size_t size) {
+  Arena* ret = TakeOrCreateArena(size);
+  ret->Reset();
+  return ret;
+}
+
+Arena* MemMapArenaPool::AllocUninitializedArena(size_t size) {
+  Arena* ret = TakeOrCreateArena(size);
+  ret->ResetUninitialized();
+  return ret;
+}
+
+Arena* MemMapArenaPool::TakeOrCreateArena(size_t size) {
   Arena* ret = nullptr;
   {
     std::lock_guard<std::mutex> lock(lock_);
@@ -125,7 +138,6 @@ Arena* MemMapArenaPool::AllocArena(size_t size) {
   if (ret == nullptr) {
     ret = new MemMapArena(size, low_4gb_, name_);
   }
-  ret->Reset();
   return ret;
 }
 
@@ -26,6 +26,7 @@ class MemMapArenaPool final : public ArenaPool {
   explicit MemMapArenaPool(bool low_4gb = false, const char* name = "LinearAlloc");
   virtual ~MemMapArenaPool();
   Arena* AllocArena(size_t size) override;
+  Arena* AllocUninitializedArena(size_t size) override;
   void FreeArenaChain(Arena* first) override;
   size_t GetBytesAllocated() const override;
   void ReclaimMemory() override;
@@ -34,6 +35,8 @@ class MemMapArenaPool final : public ArenaPool {
   void TrimMaps() override;
 
  private:
+  Arena* TakeOrCreateArena(size_t size);
+
   const bool low_4gb_;
   const char* name_;
   Arena* free_arenas_;
@@ -214,23 +214,20 @@ inline void ReaderWriterMutex::SharedUnlock(Thread* self) {
   AssertSharedHeld(self);
   RegisterAsUnlocked(self);
 #if ART_USE_FUTEXES
-  bool done = false;
-  do {
-    int32_t cur_state = state_.load(std::memory_order_relaxed);
-    if (LIKELY(cur_state > 0)) {
-      // Reduce state by 1 and impose lock release load/store ordering.
-      // Note, the num_contenders_ load below musn't reorder before the CompareAndSet.
-      done = state_.CompareAndSetWeakSequentiallyConsistent(cur_state, cur_state - 1);
-      if (done && (cur_state - 1) == 0) {  // Weak CAS may fail spuriously.
-        if (num_contenders_.load(std::memory_order_seq_cst) > 0) {
-          // Wake any exclusive waiters as there are now no readers.
-          futex(state_.Address(), FUTEX_WAKE_PRIVATE, kWakeAll, nullptr, nullptr, 0);
-        }
-      }
-    } else {
-      LOG(FATAL) << "Unexpected state_:" << cur_state << " for " << name_;
+  // While we hold the lock shared, `state_` is positive and no writer can change it, so we can
+  // drop our reader with a single atomic decrement instead of a CAS loop that other readers
+  // would keep failing under contention. This also imposes lock release load/store ordering.
+  // Note, the num_contenders_ load below musn't reorder before the decrement.
+  int32_t cur_state = state_.fetch_sub(1, std::memory_order_seq_cst);
+  if (UNLIKELY(cur_state <= 0)) {
+    LOG(FATAL) << "Unexpected state_:" << cur_state << " for " << name_;
+  }
+  if (cur_state == 1) {
+    if (num_contenders_.load(std::memory_order_seq_cst) > 0) {
+      // Wake any exclusive waiters as there are now no readers.
+      futex(state_.Address(), FUTEX_WAKE_PRIVATE, kWakeAll, nullptr, nullptr, 0);
     }
-  } while (!done);
+  }
 #else
   CHECK_MUTEX_CALL(pthread_rwlock_unlock, (&rwlock_));
 #endif
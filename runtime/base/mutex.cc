@@ -24,6 +24,7 @@
 #include "android-base/stringprintf.h"
 
 #include "base/atomic.h"
+#include "base/lock_contention_profiler.h"
 #include "base/logging.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
@@ -167,13 +168,16 @@ class ScopedAllMutexesLock final {
 };
 
 // Scoped class that generates events at the beginning and end of lock contention.
+// Monitor locks are left to the `Monitor`, which samples them per lock site.
 class ScopedContentionRecorder final : public ValueObject {
  public:
   ScopedContentionRecorder(BaseMutex* mutex, uint64_t blocked_tid, uint64_t owner_tid)
-      : mutex_(kLogLockContentions ? mutex : nullptr),
+      : sampled_mutex_((mutex->GetLevel() != kMonitorLock &&
+                        LockContentionProfiler::ShouldSample()) ? mutex : nullptr),
+        mutex_(kLogLockContentions ? mutex : nullptr),
         blocked_tid_(kLogLockContentions ? blocked_tid : 0),
         owner_tid_(kLogLockContentions ? owner_tid : 0),
-        start_nano_time_(kLogLockContentions ? NanoTime() : 0) {
+        start_nano_time_(kLogLockContentions || sampled_mutex_ != nullptr ? NanoTime() : 0) {
     if (ATraceEnabled()) {
       std::string msg = StringPrintf("Lock contention on %s (owner tid: %" PRIu64 ")",
                                      mutex->GetName(), owner_tid);
@@ -183,13 +187,22 @@ class ScopedContentionRecorder final : public ValueObject {
 
   ~ScopedContentionRecorder() {
     ATraceEnd();
-    if (kLogLockContentions) {
+    if (kLogLockContentions || sampled_mutex_ != nullptr) {
       uint64_t end_nano_time = NanoTime();
-      mutex_->RecordContention(blocked_tid_, owner_tid_, end_nano_time - start_nano_time_);
+      if (kLogLockContentions) {
+        mutex_->RecordContention(blocked_tid_, owner_tid_, end_nano_time - start_nano_time_);
+      }
+      if (sampled_mutex_ != nullptr) {
+        // Mutexes of the same name share a site, as their names are mostly literals.
+        LockContentionProfiler::RecordWait(reinterpret_cast<uintptr_t>(sampled_mutex_->GetName()),
+                                           sampled_mutex_->GetName(),
+                                           end_nano_time - start_nano_time_);
+      }
     }
   }
 
  private:
+  BaseMutex* const sampled_mutex_;
   BaseMutex* const mutex_;
   const uint64_t blocked_tid_;
   const uint64_t owner_tid_;
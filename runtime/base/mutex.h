@@ -79,6 +79,10 @@ class BaseMutex {
     return name_;
   }
 
+  LockLevel GetLevel() const {
+    return level_;
+  }
+
   virtual bool IsMutex() const { return false; }
   virtual bool IsReaderWriterMutex() const { return false; }
   virtual bool IsMutatorMutex() const { return false; }
@@ -438,6 +442,12 @@ class EXPORT SHARED_LOCKABLE ReaderWriterMutex : public BaseMutex {
 // *) The most important consequence of this behaviour is that all threads must be in one of the
 // suspended states before exclusive ownership of the mutator mutex is sought.
 //
+// *) Since runnable threads are tracked in their own thread state and flags rather than in the
+// shared state word, transitions to and from kRunnable never write the mutex's shared cache line.
+// In effect, the thread states form a distributed reader count, and exclusive acquisition pays
+// for it by having to suspend every thread first. Only explicit SharedLock() calls, e.g. from
+// threads that are not attached as runnable mutators, touch the shared state word.
+//
 std::ostream& operator<<(std::ostream& os, const MutatorMutex& mu);
 class SHARED_LOCKABLE MutatorMutex : public ReaderWriterMutex {
  public:
@@ -651,8 +651,18 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
             continue;
           }
 
+          const ListOfDependentPairs& dependents = GetDependents(invalidated);
+          if (!dependents.empty()) {
+            const dex::ClassDef* class_def = invalidated->GetDeclaringClass()->GetClassDef();
+            if (class_def != nullptr &&
+                RecordInvalidation(class_def) == kMaxInvalidationsPerClass) {
+              VLOG(class_linker) << "CHA stops speculating on methods of "
+                                 << invalidated->GetDeclaringClass()->PrettyClass();
+            }
+          }
+
           // Invalidate all dependents.
-          for (const auto& dependent : GetDependents(invalidated)) {
+          for (const auto& dependent : dependents) {
             ArtMethod* method = dependent.first;;
             OatQuickMethodHeader* method_header = dependent.second;
             VLOG(class_linker) << "CHA invalidated compiled code for " << method->PrettyMethod();
@@ -691,6 +701,24 @@ void ClassHierarchyAnalysis::InvalidateSingleImplementationMethods(
   }
 }
 
+uint32_t ClassHierarchyAnalysis::RecordInvalidation(const dex::ClassDef* class_def) {
+  return ++invalidation_counts_[class_def];
+}
+
+uint32_t ClassHierarchyAnalysis::GetInvalidationCount(const dex::ClassDef* class_def) {
+  auto it = invalidation_counts_.find(class_def);
+  return (it == invalidation_counts_.end()) ? 0u : it->second;
+}
+
+bool ClassHierarchyAnalysis::IsFrequentlyInvalidated(ArtMethod* method) {
+  const dex::ClassDef* class_def = method->GetDeclaringClass()->GetClassDef();
+  if (class_def == nullptr) {
+    return false;
+  }
+  MutexLock cha_mu(Thread::Current(), *Locks::cha_lock_);
+  return GetInvalidationCount(class_def) >= kMaxInvalidationsPerClass;
+}
+
 void ClassHierarchyAnalysis::RemoveDependenciesForLinearAlloc(Thread* self,
                                                               const LinearAlloc* linear_alloc) {
   MutexLock mu(self, *Locks::cha_lock_);
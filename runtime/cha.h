@@ -73,12 +73,21 @@ class LinearAlloc;
  * after it is invalidated. Care needs to be taken between cha_lock_ and
  * JitCodeCache::lock_ to guarantee the atomicity.
  *
+ * Some hierarchies keep growing while an app runs, e.g. when plugins or
+ * generated classes are loaded lazily. Each new override then invalidates
+ * compiled code and deoptimizes frames on stack. To avoid such deoptimization
+ * storms, we count, per declaring class, how many times compiled code got
+ * invalidated because of a CHA assumption on one of its methods. Once that
+ * count reaches kMaxInvalidationsPerClass, the compiler stops speculating on
+ * single-implementation for methods of that class and relies on inline caches
+ * instead.
+ *
  * We base our CHA on dynamically linked class profiles instead of doing static
  * analysis. Static analysis can be too aggressive due to dynamic class loading
  * at runtime, and too conservative since some classes may not be really loaded
  * at runtime.
  */
-class ClassHierarchyAnalysis {
+class EXPORT ClassHierarchyAnalysis {
  public:
   // Types for recording CHA dependencies.
   // For invalidating CHA dependency, we need to know both the ArtMethod and
@@ -89,6 +98,10 @@ class ClassHierarchyAnalysis {
   using MethodAndMethodHeaderPair = std::pair<ArtMethod*, OatQuickMethodHeader*>;
   using ListOfDependentPairs = std::vector<MethodAndMethodHeaderPair>;
 
+  // Number of CHA invalidations of compiled code after which we stop
+  // devirtualizing calls to methods declared in the same class.
+  static constexpr uint32_t kMaxInvalidationsPerClass = 4;
+
   ClassHierarchyAnalysis() {}
 
   // Add a dependency that compiled code with `dependent_header` for `dependent_method`
@@ -122,6 +135,19 @@ class ClassHierarchyAnalysis {
                                             PointerSize pointer_size)
       const REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return whether compiled code that relied on the single-implementation of
+  // methods declared in the class of `method` got invalidated often enough that
+  // the compiler should not speculate on it anymore.
+  bool IsFrequentlyInvalidated(ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::cha_lock_);
+
+  // Record that compiled code relying on a CHA assumption about a method declared
+  // in the class defined by `class_def` got invalidated. Return the new count.
+  uint32_t RecordInvalidation(const dex::ClassDef* class_def) REQUIRES(Locks::cha_lock_);
+
+  // Return the number of recorded invalidations for the class defined by `class_def`.
+  uint32_t GetInvalidationCount(const dex::ClassDef* class_def) REQUIRES(Locks::cha_lock_);
+
   // Update CHA info for methods that `klass` overrides, after loading `klass`.
   void UpdateAfterLoadingOf(Handle<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -172,6 +198,12 @@ class ClassHierarchyAnalysis {
   std::unordered_map<ArtMethod*, ListOfDependentPairs> cha_dependency_map_
     GUARDED_BY(Locks::cha_lock_);
 
+  // Number of times compiled code got invalidated because a method declared in
+  // a given class lost its single-implementation status. Keyed by class def so
+  // that the key doesn't move with the class object.
+  std::unordered_map<const dex::ClassDef*, uint32_t> invalidation_counts_
+    GUARDED_BY(Locks::cha_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(ClassHierarchyAnalysis);
 };
 
@@ -91,4 +91,24 @@ TEST_F(CHATest, CHACheckDependency) {
   ASSERT_TRUE(cha.GetDependents(METHOD3).empty());
 }
 
+TEST_F(CHATest, CHAInvalidationCount) {
+  ClassHierarchyAnalysis cha;
+  MutexLock cha_mu(Thread::Current(), *Locks::cha_lock_);
+
+  const dex::ClassDef* class_def1 = reinterpret_cast<const dex::ClassDef*>(256u);
+  const dex::ClassDef* class_def2 = reinterpret_cast<const dex::ClassDef*>(512u);
+  ASSERT_EQ(cha.GetInvalidationCount(class_def1), 0u);
+  ASSERT_EQ(cha.GetInvalidationCount(class_def2), 0u);
+
+  for (uint32_t i = 1; i <= ClassHierarchyAnalysis::kMaxInvalidationsPerClass; ++i) {
+    ASSERT_EQ(cha.RecordInvalidation(class_def1), i);
+  }
+  ASSERT_EQ(cha.GetInvalidationCount(class_def1),
+            ClassHierarchyAnalysis::kMaxInvalidationsPerClass);
+  ASSERT_EQ(cha.GetInvalidationCount(class_def2), 0u);
+
+  ASSERT_EQ(cha.RecordInvalidation(class_def2), 1u);
+  ASSERT_EQ(cha.GetInvalidationCount(class_def2), 1u);
+}
+
 }  // namespace art
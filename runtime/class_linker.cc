@@ -2699,6 +2699,7 @@ void ClassLinker::PrepareToDeleteClassLoader(Thread* self,
     CHAOnDeleteUpdateClassVisitor visitor(data.allocator);
     data.class_table->Visit<kWithoutReadBarrier>(visitor);
   }
+  runtime->GetInstrumentation()->RemoveEntryExitHooksForMethodsIn(*data.allocator);
   {
     MutexLock lock(self, critical_native_code_with_clinit_check_lock_);
     auto end = critical_native_code_with_clinit_check_.end();
@@ -4646,16 +4647,37 @@ ObjPtr<mirror::Class> ClassLinker::InsertClass(const char* descriptor,
     }
     LOG(INFO) << "Loaded class " << descriptor << source;
   }
+  Thread* self = Thread::Current();
+  const ObjPtr<mirror::ClassLoader> class_loader = klass->GetClassLoader();
+  bool inserted = false;
   {
-    WriterMutexLock mu(Thread::Current(), *Locks::classlinker_classes_lock_);
-    const ObjPtr<mirror::ClassLoader> class_loader = klass->GetClassLoader();
+    // The class table's own lock makes the lookup and insertion atomic, so threads loading
+    // classes concurrently only need the shared lock here. The exclusive lock is needed only
+    // to create the class table, or to log the new root of a boot class for the GC.
+    ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    ClassTable* const class_table = ClassTableForClassLoader(class_loader);
+    if (LIKELY(class_table != nullptr) && (class_loader != nullptr || !log_new_roots_)) {
+      VerifyObject(klass);
+      ObjPtr<mirror::Class> existing = class_table->InsertWithHashIfAbsent(descriptor, klass, hash);
+      if (existing != nullptr) {
+        return existing;
+      }
+      if (class_loader != nullptr) {
+        // Since we added a class to the class table, do the write barrier as required for
+        // remembered sets and generational GCs.
+        WriteBarrier::ForEveryFieldWrite(class_loader);
+      }
+      inserted = true;
+    }
+  }
+  if (!inserted) {
+    WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
     ClassTable* const class_table = InsertClassTableForClassLoader(class_loader);
-    ObjPtr<mirror::Class> existing = class_table->Lookup(descriptor, hash);
+    VerifyObject(klass);
+    ObjPtr<mirror::Class> existing = class_table->InsertWithHashIfAbsent(descriptor, klass, hash);
     if (existing != nullptr) {
       return existing;
     }
-    VerifyObject(klass);
-    class_table->InsertWithHash(klass, hash);
     WriteBarrierOnClassLoaderLocked(class_loader, klass);
   }
   if (kIsDebugBuild) {
@@ -6696,10 +6718,13 @@ void ClassLinker::FillIMTAndConflictTables(ObjPtr<mirror::Class> klass) {
 ImtConflictTable* ClassLinker::CreateImtConflictTable(size_t count,
                                                       LinearAlloc* linear_alloc,
                                                       PointerSize image_pointer_size) {
-  void* data = linear_alloc->Alloc(Thread::Current(),
-                                   ImtConflictTable::ComputeSize(count, image_pointer_size),
-                                   LinearAllocKind::kNoGCRoots);
-  return (data != nullptr) ? new (data) ImtConflictTable(count, image_pointer_size) : nullptr;
+  void* data = linear_alloc->Alloc(
+      Thread::Current(),
+      ImtConflictTable::ComputeSizeForNewTable(count, image_pointer_size),
+      LinearAllocKind::kNoGCRoots);
+  return (data != nullptr)
+      ? new (data) ImtConflictTable(count, image_pointer_size, /*allow_hashed_layout=*/ true)
+      : nullptr;
 }
 
 ImtConflictTable* ClassLinker::CreateImtConflictTable(size_t count, LinearAlloc* linear_alloc) {
@@ -6805,9 +6830,7 @@ void ClassLinker::FillIMTFromIfTable(ObjPtr<mirror::IfTable> if_table,
           continue;
         }
         ImtConflictTable* table = imt[imt_index]->GetImtConflictTable(image_pointer_size_);
-        const size_t num_entries = table->NumEntries(image_pointer_size_);
-        table->SetInterfaceMethod(num_entries, image_pointer_size_, interface_method);
-        table->SetImplementationMethod(num_entries, image_pointer_size_, implementation_method);
+        table->AddEntry(interface_method, implementation_method, image_pointer_size_);
       }
     }
   }
@@ -7378,28 +7401,38 @@ class ClassLinker::LinkMethodsHelper {
                        ArtMethod** out_imt)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void ClobberOldMethods(LengthPrefixedArray<ArtMethod>* old_methods,
-                         LengthPrefixedArray<ArtMethod>* methods) {
-    if (kIsDebugBuild && old_methods != nullptr) {
-      CHECK(methods != nullptr);
+  // Free the old methods replaced by `ReallocMethods()` in the class loader's LinearAlloc.
+  void FreeOldMethods(LengthPrefixedArray<ArtMethod>* old_methods,
+                      LengthPrefixedArray<ArtMethod>* methods)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (old_methods == nullptr || methods == old_methods) {
+      return;
+    }
+    CHECK(methods != nullptr);
+    LinearAlloc* allocator = class_linker_->GetAllocatorForClassLoader(klass_->GetClassLoader());
+    const size_t old_size = LengthPrefixedArray<ArtMethod>::ComputeSize(old_methods->size(),
+                                                                        kMethodSize,
+                                                                        kMethodAlignment);
+    if (!kIsDebugBuild && old_size < gPageSize) {
+      // No page to release, so there is no need to wait for the GC.
+      allocator->Free(self_, old_methods, old_size);
+      return;
+    }
+    // Need to make sure the GC is not running since it could be scanning the methods we are
+    // about to overwrite or release.
+    ScopedThreadStateChange tsc(self_, ThreadState::kSuspended);
+    gc::ScopedGCCriticalSection gcs(self_,
+                                    gc::kGcCauseClassLinker,
+                                    gc::kCollectorTypeClassLinker);
+    if (kIsDebugBuild) {
       // Put some random garbage in old methods to help find stale pointers.
-      if (methods != old_methods) {
-        // Need to make sure the GC is not running since it could be scanning the methods we are
-        // about to overwrite.
-        ScopedThreadStateChange tsc(self_, ThreadState::kSuspended);
-        gc::ScopedGCCriticalSection gcs(self_,
-                                        gc::kGcCauseClassLinker,
-                                        gc::kCollectorTypeClassLinker);
-        const size_t old_size = LengthPrefixedArray<ArtMethod>::ComputeSize(old_methods->size(),
-                                                                            kMethodSize,
-                                                                            kMethodAlignment);
-        memset(old_methods, 0xFEu, old_size);
-        // Set size to 0 to avoid visiting declaring classes.
-        if (gUseUserfaultfd) {
-          old_methods->SetSize(0);
-        }
+      memset(old_methods, 0xFEu, old_size);
+      // Set size to 0 to avoid visiting declaring classes.
+      if (gUseUserfaultfd) {
+        old_methods->SetSize(0);
       }
     }
+    allocator->Free(self_, old_methods, old_size);
   }
 
   NO_INLINE
@@ -8754,7 +8787,7 @@ bool ClassLinker::LinkMethodsHelper<kPointerSize>::LinkMethods(
         break;
       }
     }
-    LengthPrefixedArray<ArtMethod>* old_methods = kIsDebugBuild ? klass->GetMethodsPtr() : nullptr;
+    LengthPrefixedArray<ArtMethod>* old_methods = klass->GetMethodsPtr();
     if (have_super_with_defaults) {
       if (!FindCopiedMethodsForInterface(klass.Get(), num_virtual_methods, iftable)) {
         self->AssertPendingException();
@@ -8772,10 +8805,8 @@ bool ClassLinker::LinkMethodsHelper<kPointerSize>::LinkMethods(
       }
     }
     klass->SetIfTable(iftable);
-    if (kIsDebugBuild) {
-      // May cause thread suspension, so do this after we're done with `ObjPtr<> iftable`.
-      ClobberOldMethods(old_methods, klass->GetMethodsPtr());
-    }
+    // May cause thread suspension, so do this after we're done with `ObjPtr<> iftable`.
+    FreeOldMethods(old_methods, klass->GetMethodsPtr());
     return true;
   } else if (LIKELY(klass->HasSuperClass())) {
     // We set up the interface lookup table now because we need it to determine if we need
@@ -8866,7 +8897,7 @@ bool ClassLinker::LinkMethodsHelper<kPointerSize>::LinkMethods(
       return false;
     }
 
-    LengthPrefixedArray<ArtMethod>* old_methods = kIsDebugBuild ? klass->GetMethodsPtr() : nullptr;
+    LengthPrefixedArray<ArtMethod>* old_methods = klass->GetMethodsPtr();
     if (num_new_copied_methods_ != 0u) {
       ReallocMethods(klass.Get());
     }
@@ -8916,8 +8947,8 @@ bool ClassLinker::LinkMethodsHelper<kPointerSize>::LinkMethods(
     klass->SetIfTable(iftable.Get());
     if (kIsDebugBuild) {
       CheckVTable(self, klass, kPointerSize);
-      ClobberOldMethods(old_methods, klass->GetMethodsPtr());
     }
+    FreeOldMethods(old_methods, klass->GetMethodsPtr());
     return true;
   } else {
     return LinkJavaLangObjectMethods(self, klass);
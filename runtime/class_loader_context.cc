@@ -477,10 +477,9 @@ bool ClassLoaderContext::OpenDexFiles(const std::string& classpath_dir,
       std::string error_msg;
       std::optional<uint32_t> dex_checksum;
       if (only_read_checksums) {
-        bool zip_file_only_contains_uncompress_dex;
-        ArtDexFileLoader dex_file_loader(&file, location);
-        if (!dex_file_loader.GetMultiDexChecksum(
-                &dex_checksum, &error_msg, &zip_file_only_contains_uncompress_dex)) {
+        // Shared libraries are often part of the context of many apps and dex files, so use the
+        // process-wide checksum cache rather than reading their zip central directory each time.
+        if (!OatFileAssistant::GetMultiDexChecksum(&file, location, &dex_checksum, &error_msg)) {
           LOG(WARNING) << "Could not get dex checksums for location " << location
                        << ", fd=" << file.Fd();
           dex_files_state_ = kDexFilesOpenFailed;
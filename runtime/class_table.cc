@@ -23,12 +23,25 @@
 
 namespace art HIDDEN {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      frozen_sets_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
 }
 
+void ClassTable::PublishFrozenSetsLocked() {
+  DCHECK(!classes_.empty());
+  auto frozen_sets = std::make_unique<std::vector<ClassSet>>();
+  frozen_sets->reserve(classes_.size() - 1u);
+  for (size_t i = 0; i != classes_.size() - 1u; ++i) {
+    frozen_sets->push_back(classes_[i].View());
+  }
+  frozen_sets_.store(frozen_sets.get(), std::memory_order_release);
+  frozen_sets_storage_.push_back(std::move(frozen_sets));
+}
+
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
   // Propagate the min/max load factor from the old active set.
@@ -36,6 +49,7 @@ void ClassTable::FreezeSnapshot() {
   const ClassSet& last_set = classes_.back();
   ClassSet new_set(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
   classes_.push_back(std::move(new_set));
+  PublishFrozenSetsLocked();
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
@@ -106,15 +120,30 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  // Search the frozen sets without the lock first. Search from the last table, assuming
+  // that apps shall search for their own classes more often than for boot image classes.
+  // For prebuilt boot images, this also helps by searching the large table from the
+  // framework boot image extension compiled as single-image before the individual small
+  // tables from the primary boot image compiled as multi-image.
+  const std::vector<ClassSet>* frozen_sets = frozen_sets_.load(std::memory_order_acquire);
+  size_t num_searched_sets = 0u;
+  if (frozen_sets != nullptr) {
+    for (const ClassSet& class_set : ReverseRange(*frozen_sets)) {
+      auto it = class_set.FindWithHash(pair, hash);
+      if (it != class_set.end()) {
+        return it->Read();
+      }
+    }
+    num_searched_sets = frozen_sets->size();
+  }
+  // Frozen sets keep their position in `classes_`, so only the sets added after the
+  // snapshot and the active set remain to be searched.
   ReaderMutexLock mu(Thread::Current(), lock_);
-  // Search from the last table, assuming that apps shall search for their own classes
-  // more often than for boot image classes. For prebuilt boot images, this also helps
-  // by searching the large table from the framework boot image extension compiled as
-  // single-image before the individual small tables from the primary boot image
-  // compiled as multi-image.
-  for (ClassSet& class_set : ReverseRange(classes_)) {
-    auto it = class_set.FindWithHash(pair, hash);
-    if (it != class_set.end()) {
+  DCHECK_LT(num_searched_sets, classes_.size());
+  for (size_t i = classes_.size(); i != num_searched_sets; ) {
+    --i;
+    auto it = classes_[i].FindWithHash(pair, hash);
+    if (it != classes_[i].end()) {
       return it->Read();
     }
   }
@@ -130,6 +159,21 @@ void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
 }
 
+ObjPtr<mirror::Class> ClassTable::InsertWithHashIfAbsent(const char* descriptor,
+                                                         ObjPtr<mirror::Class> klass,
+                                                         size_t hash) {
+  DescriptorHashPair pair(descriptor, hash);
+  WriterMutexLock mu(Thread::Current(), lock_);
+  for (ClassSet& class_set : ReverseRange(classes_)) {
+    auto it = class_set.FindWithHash(pair, hash);
+    if (it != class_set.end()) {
+      return it->Read();
+    }
+  }
+  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  return nullptr;
+}
+
 bool ClassTable::InsertStrongRoot(ObjPtr<mirror::Object> obj) {
   WriterMutexLock mu(Thread::Current(), lock_);
   DCHECK(obj != nullptr);
@@ -179,6 +223,7 @@ void ClassTable::AddClassSet(ClassSet&& set) {
   // TODO: Make use of this in `ClassLinker::FindClass()`.
   DCHECK(!classes_.empty());
   classes_.insert(classes_.end() - 1, std::move(set));
+  PublishFrozenSetsLocked();
 }
 
 void ClassTable::ClearStrongRoots() {
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -241,6 +243,14 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Insert `klass` unless a class with the same descriptor is already in the table. Returns
+  // the existing class, or null if `klass` was inserted.
+  ObjPtr<mirror::Class> InsertWithHashIfAbsent(const char* descriptor,
+                                               ObjPtr<mirror::Class> klass,
+                                               size_t hash)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Return true if we inserted the strong root, false if it already exists.
   bool InsertStrongRoot(ObjPtr<mirror::Object> obj)
       REQUIRES(!lock_)
@@ -287,6 +297,9 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Publish views of all the class sets but the last one for lock-free lookups.
+  void PublishFrozenSetsLocked() REQUIRES(lock_);
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
@@ -297,6 +310,13 @@ class ClassTable {
   std::vector<GcRoot<mirror::Object>> strong_roots_ GUARDED_BY(lock_);
   // Keep track of oat files with GC roots associated with dex caches in `strong_roots_`.
   std::vector<const OatFile*> oat_files_ GUARDED_BY(lock_);
+  // Views of the frozen class sets, i.e. all but the last one, which `Lookup()` searches
+  // without taking `lock_`. Frozen sets are never modified, so their storage outlives any
+  // reordering of `classes_`. Replaced views are kept alive for concurrent readers; this
+  // happens only when a class set is added or frozen.
+  std::atomic<const std::vector<ClassSet>*> frozen_sets_;
+  std::vector<std::unique_ptr<const std::vector<ClassSet>>> frozen_sets_storage_
+      GUARDED_BY(lock_);
 
   friend class linker::ImageWriter;  // for InsertWithoutLocks.
 };
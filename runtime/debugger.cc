@@ -188,6 +188,8 @@ bool Dbg::DdmHandleChunk(JNIEnv* env,
                          /*out*/uint32_t* out_type,
                          /*out*/std::vector<uint8_t>* out_data) {
   ScopedObjectAccess soa(env);
+  // Resolve the `Chunk` fields used below before we hold any unprotected references.
+  WellKnownClasses::EnsureLazyMembersInitialized();
   StackHandleScope<1u> hs(soa.Self());
   Handle<mirror::ByteArray> data_array =
       hs.NewHandle(mirror::ByteArray::Alloc(soa.Self(), data.size()));
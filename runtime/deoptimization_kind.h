@@ -32,7 +32,8 @@ enum class DeoptimizationKind {
   kCHA,
   kDebugging,
   kFullFrame,
-  kLast = kFullFrame
+  kJitOsr,
+  kLast = kJitOsr
 };
 
 inline const char* GetDeoptimizationKindName(DeoptimizationKind kind) {
@@ -46,6 +47,7 @@ inline const char* GetDeoptimizationKindName(DeoptimizationKind kind) {
     case DeoptimizationKind::kCHA: return "class hierarchy analysis";
     case DeoptimizationKind::kDebugging: return "Deopt requested for debug support";
     case DeoptimizationKind::kFullFrame: return "full frame";
+    case DeoptimizationKind::kJitOsr: return "baseline frame left for OSR code";
   }
   LOG(FATAL) << "Unexpected kind " << static_cast<size_t>(kind);
   UNREACHABLE();
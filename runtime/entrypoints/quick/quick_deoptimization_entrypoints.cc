@@ -82,4 +82,17 @@ extern "C" NO_RETURN void artDeoptimizeFromCompiledCode(DeoptimizationKind kind,
   artDeoptimizeImpl(self, kind, true, /* skip_method_exit_callbacks= */ false);
 }
 
+// This is called when a baseline frame stopped at a suspend check should continue in the
+// OSR code of its method. The caller pushed the deoptimization context.
+extern "C" NO_RETURN void artDeoptimizeForOsr(Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  // Baseline code is not debuggable, so only deoptimize the frame at the suspend check, whose
+  // environment is kept live. The method is still executing, so don't skip method exit callbacks.
+  artDeoptimizeImpl(self,
+                    DeoptimizationKind::kJitOsr,
+                    /* single_frame= */ true,
+                    /* skip_method_exit_callbacks= */ false);
+}
+
 }  // namespace art
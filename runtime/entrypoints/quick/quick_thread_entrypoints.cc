@@ -35,6 +35,42 @@ extern "C" void artDeoptimizeIfNeeded(Thread* self, uintptr_t result, bool is_re
   instr->DeoptimizeIfNeeded(self, sp, type, jvalue, is_ref);
 }
 
+extern "C" NO_RETURN void artDeoptimizeForOsr(Thread* self);
+
+// Deoptimize the caller of the runtime method at `sp` if it is a baseline frame
+// stuck in a loop that now has OSR code, see Jit::ShouldDeoptimizeBaselineFrameForOsr.
+// Like `Instrumentation::DeoptimizeIfNeeded()`, this resumes at the suspend check's dex pc.
+static void MaybeDeoptimizeForOsr(Thread* self, ArtMethod** sp)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  // Only the thread that ran out of baseline hotness checks its caller, so that other suspend
+  // checks do not pay for the method header lookup.
+  if (LIKELY(!self->IsOsrFromBaselineRequested())) {
+    return;
+  }
+  self->SetOsrFromBaselineRequested(false);
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  QuickMethodFrameInfo frame_info = Runtime::Current()->GetRuntimeMethodFrameInfo(*sp);
+  uintptr_t caller_sp = reinterpret_cast<uintptr_t>(sp) + frame_info.FrameSizeInBytes();
+  ArtMethod* caller = *(reinterpret_cast<ArtMethod**>(caller_sp));
+  uintptr_t caller_pc = *reinterpret_cast<uintptr_t*>(caller_sp - sizeof(void*));
+  if (caller == nullptr || caller->IsNative() || caller->IsRuntimeMethod()) {
+    return;
+  }
+  if (jit->ShouldDeoptimizeBaselineFrameForOsr(self, caller, caller_pc)) {
+    JValue result;
+    result.SetJ(0);
+    self->PushDeoptimizationContext(result,
+                                    /* is_reference= */ false,
+                                    /* exception= */ nullptr,
+                                    /* from_code= */ false,
+                                    DeoptimizationMethodType::kKeepDexPc);
+    artDeoptimizeForOsr(self);
+  }
+}
+
 extern "C" void artTestSuspendFromCode(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
   // Called when there is a pending checkpoint or suspend request.
   ScopedQuickEntrypointChecks sqec(self);
@@ -47,6 +83,7 @@ extern "C" void artTestSuspendFromCode(Thread* self) REQUIRES_SHARED(Locks::muta
   result.SetJ(0);
   Runtime::Current()->GetInstrumentation()->DeoptimizeIfNeeded(
       self, sp, DeoptimizationMethodType::kKeepDexPc, result, /* is_ref= */ false);
+  MaybeDeoptimizeForOsr(self, sp);
 }
 
 extern "C" void artImplicitSuspendFromCode(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -61,6 +98,7 @@ extern "C" void artImplicitSuspendFromCode(Thread* self) REQUIRES_SHARED(Locks::
   result.SetJ(0);
   Runtime::Current()->GetInstrumentation()->DeoptimizeIfNeeded(
       self, sp, DeoptimizationMethodType::kKeepDexPc, result, /* is_ref= */ false);
+  MaybeDeoptimizeForOsr(self, sp);
 }
 
 extern "C" void artCompileOptimized(ArtMethod* method, Thread* self)
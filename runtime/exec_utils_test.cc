@@ -136,9 +136,13 @@ TEST_P(ExecUtilsTest, ExecError) {
   // Historical note: Running on Valgrind failed due to some memory
   // that leaks in thread alternate signal stacks.
   ExecResult result = exec_utils_->ExecAndReturnResult(command, /*timeout_sec=*/-1, &error_msg);
-  EXPECT_EQ(result.status, ExecResult::kSignaled);
-  EXPECT_EQ(result.signal, SIGABRT);
-  EXPECT_FALSE(error_msg.empty());
+  if (result.status == ExecResult::kStartFailed) {
+    EXPECT_FALSE(error_msg.empty());
+  } else {
+    // Bionic reports a failed exec in the child as exit code 127.
+    EXPECT_EQ(result.status, ExecResult::kExited);
+    EXPECT_EQ(result.exit_code, 127);
+  }
 }
 
 TEST_P(ExecUtilsTest, EnvSnapshotAdditionsAreNotVisible) {
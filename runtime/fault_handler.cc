@@ -66,7 +66,9 @@ static bool art_sigbus_handler(int sig, siginfo_t* info, void* context) {
 FaultManager::FaultManager()
     : generated_code_ranges_lock_("FaultHandler generated code ranges lock",
                                   LockLevel::kGenericBottomLock),
-      initialized_(false) {}
+      initialized_(false),
+      generated_code_ranges_generation_(0u),
+      last_generated_code_range_(0u) {}
 
 FaultManager::~FaultManager() {
 }
@@ -362,10 +364,18 @@ inline FaultManager::GeneratedCodeRange* FaultManager::CreateGeneratedCodeRange(
   }
 }
 
-inline void FaultManager::FreeGeneratedCodeRange(GeneratedCodeRange* range) {
-  std::less<GeneratedCodeRange*> less;
+inline size_t FaultManager::GetLocalGeneratedCodeRangeIndex(
+    const GeneratedCodeRange* range) const {
+  std::less<const GeneratedCodeRange*> less;
   if (!less(range, generated_code_ranges_storage_) &&
       less(range, generated_code_ranges_storage_ + kNumLocalGeneratedCodeRanges)) {
+    return static_cast<size_t>(range - generated_code_ranges_storage_);
+  }
+  return kNumLocalGeneratedCodeRanges;
+}
+
+inline void FaultManager::FreeGeneratedCodeRange(GeneratedCodeRange* range) {
+  if (GetLocalGeneratedCodeRangeIndex(range) != kNumLocalGeneratedCodeRanges) {
     MutexLock lock(Thread::Current(), generated_code_ranges_lock_);
     range->start = nullptr;
     range->size = 0u;
@@ -432,6 +442,11 @@ void FaultManager::RemoveGeneratedCodeRange(const void* start, size_t size) {
         // retained nodes, if any.
         before->store(next, std::memory_order_relaxed);
       }
+      // Invalidate the last matched range in `IsInGeneratedCode()`. Threads that read
+      // the new generation with the acquire load shall also see the updated links above
+      // and shall not find the removed range. The checkpoint below waits for any thread
+      // that is still looking at the range using the old generation.
+      generated_code_ranges_generation_.fetch_add(1u, std::memory_order_release);
     }
   }
   CHECK(range != nullptr);
@@ -510,10 +525,30 @@ bool FaultManager::IsInGeneratedCode(siginfo_t* siginfo, void* context) {
     return false;
   }
 
+  // Check the last matched range first. The `generated_code_ranges_storage_` is never
+  // deallocated, so reading a stale entry is safe, and the generation check ensures that
+  // the slot has not been reused since the entry was recorded.
+  uint32_t generation = generated_code_ranges_generation_.load(std::memory_order_acquire);
+  uint64_t last_range = last_generated_code_range_.load(std::memory_order_acquire);
+  if (static_cast<uint32_t>(last_range >> 32) == generation &&
+      static_cast<uint32_t>(last_range) != 0u) {
+    size_t index = static_cast<uint32_t>(last_range) - 1u;
+    DCHECK_LT(index, kNumLocalGeneratedCodeRanges);
+    const GeneratedCodeRange& range = generated_code_ranges_storage_[index];
+    if (fault_pc - reinterpret_cast<uintptr_t>(range.start) < range.size) {
+      return true;
+    }
+  }
+
   // Walk over the list of registered code ranges.
   GeneratedCodeRange* range = generated_code_ranges_.load(std::memory_order_acquire);
   while (range != nullptr) {
     if (fault_pc - reinterpret_cast<uintptr_t>(range->start) < range->size) {
+      size_t index = GetLocalGeneratedCodeRangeIndex(range);
+      if (index != kNumLocalGeneratedCodeRanges) {
+        uint64_t new_last_range = (static_cast<uint64_t>(generation) << 32) | (index + 1u);
+        last_generated_code_range_.store(new_last_range, std::memory_order_release);
+      }
       return true;
     }
     // We may or may not see ranges that were concurrently removed, depending
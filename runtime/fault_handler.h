@@ -84,6 +84,9 @@ class FaultManager {
 
   GeneratedCodeRange* CreateGeneratedCodeRange(const void* start, size_t size)
       REQUIRES(generated_code_ranges_lock_);
+  // Returns the index of `range` in `generated_code_ranges_storage_`, or
+  // `kNumLocalGeneratedCodeRanges` if it was allocated on the heap.
+  size_t GetLocalGeneratedCodeRangeIndex(const GeneratedCodeRange* range) const;
   void FreeGeneratedCodeRange(GeneratedCodeRange* range) REQUIRES(!generated_code_ranges_lock_);
 
   // The HandleFaultByOtherHandlers function is only called by HandleFault function for generated code.
@@ -116,6 +119,14 @@ class FaultManager {
   GeneratedCodeRange* free_generated_code_ranges_
        GUARDED_BY(generated_code_ranges_lock_);
 
+  // Implicit null checks that actually throw tend to fault repeatedly in the same code range,
+  // so `IsInGeneratedCode()` remembers the last matched local range and checks it before
+  // walking the list. The entry is encoded as `(generation << 32) | (index + 1)` and it is
+  // valid only while `generation` matches `generated_code_ranges_generation_`, which is
+  // incremented by every removal before it runs the checkpoint that allows reusing the slot.
+  std::atomic<uint32_t> generated_code_ranges_generation_;
+  std::atomic<uint64_t> last_generated_code_range_;
+
   DISALLOW_COPY_AND_ASSIGN(FaultManager);
 };
 
@@ -71,7 +71,8 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
   while (!IsAligned<sizeof(intptr_t)>(card_cur) && card_cur < card_end) {
     if (*card_cur >= minimum_age) {
       uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-      bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
+      bitmap->VisitMarkedRange</*kVisitOnce=*/ false, /*kPrefetchObjects=*/ true>(
+          start, start + kCardSize, visitor);
       ++cards_scanned;
     }
     ++card_cur;
@@ -104,7 +105,8 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
           auto* card = reinterpret_cast<uint8_t*>(word_cur) + i;
           DCHECK(*card == static_cast<uint8_t>(start_word) || *card == kCardDirty)
               << "card " << static_cast<size_t>(*card) << " intptr_t " << (start_word & 0xFF);
-          bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
+          bitmap->VisitMarkedRange</*kVisitOnce=*/ false, /*kPrefetchObjects=*/ true>(
+              start, start + kCardSize, visitor);
           ++cards_scanned;
         }
         start_word >>= 8;
@@ -118,7 +120,8 @@ inline size_t CardTable::Scan(ContinuousSpaceBitmap* bitmap,
     while (card_cur < card_end) {
       if (*card_cur >= minimum_age) {
         uintptr_t start = reinterpret_cast<uintptr_t>(AddrFromCard(card_cur));
-        bitmap->VisitMarkedRange(start, start + kCardSize, visitor);
+        bitmap->VisitMarkedRange</*kVisitOnce=*/ false, /*kPrefetchObjects=*/ true>(
+            start, start + kCardSize, visitor);
         ++cards_scanned;
       }
       ++card_cur;
@@ -53,6 +53,12 @@ namespace accounting {
  * byte is equal to `kCardDirty`. See CardTable::Create for details.
  */
 
+void CardTable::AdviseTransparentHugePages() {
+  if (mem_map_.MadviseHugePages() != 0) {
+    PLOG(WARNING) << "Failed to enable transparent huge pages for the card table";
+  }
+}
+
 CardTable* CardTable::Create(const uint8_t* heap_begin, size_t heap_capacity) {
   ScopedTrace trace(__PRETTY_FUNCTION__);
   /* Set up the card table */
@@ -102,6 +102,9 @@ class CardTable {
     return mem_map_.BaseSize();
   }
 
+  // Back the card table with transparent huge pages where possible.
+  void AdviseTransparentHugePages();
+
   /*
    * Modify cards in the range from scan_begin (inclusive) to scan_end (exclusive). Each card
    * value v is replaced by visitor(v). Visitor() should not have side-effects.
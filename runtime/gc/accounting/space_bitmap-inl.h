@@ -101,7 +101,31 @@ inline mirror::Object* SpaceBitmap<kAlignment>::FindPrecedingObject(uintptr_t vi
 }
 
 template<size_t kAlignment>
-template<bool kVisitOnce, typename Visitor>
+inline size_t SpaceBitmap<kAlignment>::FindNonZeroWord(size_t index_begin,
+                                                       size_t index_end) const {
+  // OR a few words together so that runs of empty words cost one branch per block. The loads are
+  // independent, which lets the compiler use paired / wide loads.
+  static constexpr size_t kWordsPerBlock = 4;
+  size_t i = index_begin;
+  for (; i + kWordsPerBlock <= index_end; i += kWordsPerBlock) {
+    const uintptr_t block = bitmap_begin_[i].load(std::memory_order_relaxed) |
+                            bitmap_begin_[i + 1].load(std::memory_order_relaxed) |
+                            bitmap_begin_[i + 2].load(std::memory_order_relaxed) |
+                            bitmap_begin_[i + 3].load(std::memory_order_relaxed);
+    if (block != 0) {
+      break;
+    }
+  }
+  for (; i < index_end; ++i) {
+    if (bitmap_begin_[i].load(std::memory_order_relaxed) != 0) {
+      return i;
+    }
+  }
+  return index_end;
+}
+
+template<size_t kAlignment>
+template<bool kVisitOnce, bool kPrefetchObjects, typename Visitor>
 inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
                                                       uintptr_t visit_end,
                                                       Visitor&& visitor) const {
@@ -150,30 +174,37 @@ inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
       do {
         const size_t shift = CTZ(left_edge);
         mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+        left_edge ^= (static_cast<uintptr_t>(1)) << shift;
+        if (kPrefetchObjects && left_edge != 0) {
+          __builtin_prefetch(reinterpret_cast<void*>(ptr_base + CTZ(left_edge) * kAlignment));
+        }
         visitor(obj);
         if (kVisitOnce) {
           return;
         }
-        left_edge ^= (static_cast<uintptr_t>(1)) << shift;
       } while (left_edge != 0);
     }
 
-    // Traverse the middle, full part.
-    for (size_t i = index_start + 1; i < index_end; ++i) {
+    // Traverse the middle, full part, skipping over empty words.
+    for (size_t i = FindNonZeroWord(index_start + 1, index_end);
+         i < index_end;
+         i = FindNonZeroWord(i + 1, index_end)) {
       uintptr_t w = bitmap_begin_[i].load(std::memory_order_relaxed);
-      if (w != 0) {
-        const uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
-        // Iterate on the bits set in word `w`, from the least to the most significant bit.
-        do {
-          const size_t shift = CTZ(w);
-          mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
-          visitor(obj);
-          if (kVisitOnce) {
-            return;
-          }
-          w ^= (static_cast<uintptr_t>(1)) << shift;
-        } while (w != 0);
-      }
+      DCHECK_NE(w, 0u);
+      const uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
+      // Iterate on the bits set in word `w`, from the least to the most significant bit.
+      do {
+        const size_t shift = CTZ(w);
+        mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+        w ^= (static_cast<uintptr_t>(1)) << shift;
+        if (kPrefetchObjects && w != 0) {
+          __builtin_prefetch(reinterpret_cast<void*>(ptr_base + CTZ(w) * kAlignment));
+        }
+        visitor(obj);
+        if (kVisitOnce) {
+          return;
+        }
+      } while (w != 0);
     }
 
     // Right edge is unique.
@@ -197,11 +228,14 @@ inline void SpaceBitmap<kAlignment>::VisitMarkedRange(uintptr_t visit_begin,
     do {
       const size_t shift = CTZ(right_edge);
       mirror::Object* obj = reinterpret_cast<mirror::Object*>(ptr_base + shift * kAlignment);
+      right_edge ^= (static_cast<uintptr_t>(1)) << shift;
+      if (kPrefetchObjects && right_edge != 0) {
+        __builtin_prefetch(reinterpret_cast<void*>(ptr_base + CTZ(right_edge) * kAlignment));
+      }
       visitor(obj);
       if (kVisitOnce) {
         return;
       }
-      right_edge ^= (static_cast<uintptr_t>(1)) << shift;
     } while (right_edge != 0);
   }
 #endif
@@ -214,7 +248,7 @@ void SpaceBitmap<kAlignment>::Walk(Visitor&& visitor) {
 
   uintptr_t end = OffsetToIndex(HeapLimit() - heap_begin_ - 1);
   Atomic<uintptr_t>* bitmap_begin = bitmap_begin_;
-  for (uintptr_t i = 0; i <= end; ++i) {
+  for (uintptr_t i = FindNonZeroWord(0, end + 1); i <= end; i = FindNonZeroWord(i + 1, end + 1)) {
     uintptr_t w = bitmap_begin[i].load(std::memory_order_relaxed);
     if (w != 0) {
       uintptr_t ptr_base = IndexToOffset(i) + heap_begin_;
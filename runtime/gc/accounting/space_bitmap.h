@@ -140,10 +140,12 @@ class SpaceBitmap {
   mirror::Object* FindPrecedingObject(uintptr_t visit_begin, uintptr_t visit_end = 0) const;
 
   // Visit the live objects in the range [visit_begin, visit_end). If kVisitOnce
-  // is true, then only the first live object will be visited.
+  // is true, then only the first live object will be visited. If kPrefetchObjects is true, the
+  // next live object in the same bitmap word is prefetched before visiting the current one, which
+  // helps visitors that read the objects.
   // TODO: Use lock annotations when clang is fixed.
   // REQUIRES(Locks::heap_bitmap_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
-  template <bool kVisitOnce = false, typename Visitor>
+  template <bool kVisitOnce = false, bool kPrefetchObjects = false, typename Visitor>
   void VisitMarkedRange(uintptr_t visit_begin, uintptr_t visit_end, Visitor&& visitor) const
       NO_THREAD_SAFETY_ANALYSIS;
 
@@ -255,6 +257,10 @@ class SpaceBitmap {
   template<bool kSetBit>
   bool Modify(const mirror::Object* obj);
 
+  // Return the index of the first non-zero word in [index_begin, index_end), or index_end if
+  // there is none. Sparse bitmaps are mostly zero words, so they are tested in blocks.
+  size_t FindNonZeroWord(size_t index_begin, size_t index_end) const;
+
   // Backing storage for bitmap.
   MemMap mem_map_;
 
@@ -241,6 +241,11 @@ TYPED_TEST(SpaceBitmapTest, VisitorAlignment) {
     auto count_fn = [&count]([[maybe_unused]] mirror::Object* obj) { count++; };
     space_bitmap->VisitMarkedRange(range_begin, range_end, count_fn);
     EXPECT_EQ(count, manual_count);
+    // The prefetching variant must visit exactly the same objects.
+    count = 0;
+    space_bitmap->template VisitMarkedRange</*kVisitOnce=*/ false, /*kPrefetchObjects=*/ true>(
+        range_begin, range_end, count_fn);
+    EXPECT_EQ(count, manual_count);
   };
   RunTest<SpaceBitmap>(TypeParam::GetObjectAlignment(), count_test_fn);
 }
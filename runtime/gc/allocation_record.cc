@@ -16,10 +16,13 @@
 
 #include "allocation_record.h"
 
+#include <cmath>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG
 #include "base/stl_util.h"
+#include "base/time_utils.h"
 #include "obj_ptr-inl.h"
 #include "object_callbacks.h"
 #include "stack.h"
@@ -54,6 +57,69 @@ void AllocRecordObjectMap::SetMaxStackDepth(size_t max_stack_depth) {
   max_stack_depth_ = max_stack_depth;
 }
 
+void AllocRecordObjectMap::SetSampleInterval(size_t sample_interval) {
+  sample_interval_ = sample_interval;
+}
+
+const AllocRecordStackTrace* AllocRecordObjectMap::InternStackTrace(AllocRecordStackTrace&& trace,
+                                                                    uint32_t* id) {
+  // try_emplace() leaves `trace` untouched if an identical trace is already present.
+  auto result =
+      stack_traces_.try_emplace(std::move(trace), StackTraceInfo{next_stack_trace_id_, 0u});
+  if (result.second) {
+    ++next_stack_trace_id_;
+  }
+  StackTraceInfo& info = result.first->second;
+  ++info.ref_count;
+  *id = info.id;
+  return &result.first->first;
+}
+
+void AllocRecordObjectMap::ReleaseStackTrace(const AllocRecordStackTrace* trace) {
+  auto it = stack_traces_.find(*trace);
+  DCHECK(it != stack_traces_.end());
+  DCHECK_EQ(&it->first, trace);
+  DCHECK_GT(it->second.ref_count, 0u);
+  if (--it->second.ref_count == 0) {
+    stack_traces_.erase(it);
+  }
+}
+
+bool AllocRecordObjectMap::ShouldSampleAllocation(size_t byte_count) {
+  const size_t sample_interval = sample_interval_;
+  if (sample_interval == 0) {
+    return true;
+  }
+  // Per-thread state, so that the check does not need a lock. The distance to the next sample is
+  // drawn from an exponential distribution, which makes the sampling a Poisson process in the
+  // number of allocated bytes and avoids aliasing with periodic allocation patterns.
+  thread_local size_t bytes_until_sample = 0;
+  thread_local uint64_t rng_state = 0;
+  auto next_sample_distance = [sample_interval]() {
+    if (UNLIKELY(rng_state == 0)) {
+      rng_state = (static_cast<uint64_t>(GetTid()) << 32) ^ NanoTime();
+      rng_state = (rng_state == 0) ? 1u : rng_state;
+    }
+    // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    const uint64_t random = rng_state * UINT64_C(0x2545F4914F6CDD1D);
+    // Uniform in (0, 1].
+    const double uniform = (static_cast<double>(random >> 11) + 1.0) * 0x1.0p-53;
+    return std::max<size_t>(1u, static_cast<size_t>(-std::log(uniform) * sample_interval));
+  };
+  if (UNLIKELY(bytes_until_sample == 0)) {
+    bytes_until_sample = next_sample_distance();
+  }
+  if (bytes_until_sample > byte_count) {
+    bytes_until_sample -= byte_count;
+    return false;
+  }
+  bytes_until_sample = next_sample_distance();
+  return true;
+}
+
 AllocRecordObjectMap::~AllocRecordObjectMap() {
   Clear();
 }
@@ -69,16 +135,16 @@ void AllocRecordObjectMap::VisitRoots(RootVisitor* visitor) {
   size_t count = recent_record_max_;
   // Only visit the last recent_record_max_ number of allocation records in entries_ and mark the
   // klass_ fields as strong roots.
-  for (auto it = entries_.rbegin(), end = entries_.rend(); it != end; ++it) {
-    AllocRecord& record = it->second;
-    if (count > 0) {
-      buffered_visitor.VisitRootIfNonNull(record.GetClassGcRoot());
-      --count;
-    }
-    // Visit all of the stack frames to make sure no methods in the stack traces get unloaded by
-    // class unloading.
-    for (size_t i = 0, depth = record.GetDepth(); i < depth; ++i) {
-      const AllocRecordStackTraceElement& element = record.StackElement(i);
+  for (auto it = entries_.rbegin(), end = entries_.rend(); it != end && count > 0; ++it) {
+    buffered_visitor.VisitRootIfNonNull(it->second.GetClassGcRoot());
+    --count;
+  }
+  // Visit all of the stack frames to make sure no methods in the stack traces get unloaded by
+  // class unloading. Every trace in stack_traces_ is referenced by at least one record.
+  for (const auto& pair : stack_traces_) {
+    const AllocRecordStackTrace& trace = pair.first;
+    for (size_t i = 0, depth = trace.GetDepth(); i < depth; ++i) {
+      const AllocRecordStackTraceElement& element = trace.GetStackElement(i);
       DCHECK(element.GetMethod() != nullptr);
       element.GetMethod()->VisitRoots(buffered_visitor, kRuntimePointerSize);
     }
@@ -122,6 +188,7 @@ void AllocRecordObjectMap::SweepAllocationRecords(IsMarkedVisitor* visitor) {
         SweepClassObject(&record, visitor);
         ++it;
       } else {
+        ReleaseStackTrace(record.GetStackTrace());
         it = entries_.erase(it);
         ++count_deleted;
       }
@@ -169,11 +236,16 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
       }
       CHECK(records != nullptr);
       records->SetMaxStackDepth(heap->GetAllocTrackerStackDepth());
+      records->SetSampleInterval(heap->GetAllocTrackerSampleInterval());
       size_t sz = sizeof(AllocRecordStackTraceElement) * records->max_stack_depth_ +
                   sizeof(AllocRecord) + sizeof(AllocRecordStackTrace);
       LOG(INFO) << "Enabling alloc tracker (" << records->alloc_record_max_ << " entries of "
                 << records->max_stack_depth_ << " frames, taking up to "
                 << PrettySize(sz * records->alloc_record_max_) << ")";
+      if (records->sample_interval_ != 0) {
+        LOG(INFO) << "Sampling one allocation every " << PrettySize(records->sample_interval_)
+                  << " on average";
+      }
     }
     Runtime::Current()->GetInstrumentation()->InstrumentQuickAllocEntryPoints();
     {
@@ -201,6 +273,10 @@ void AllocRecordObjectMap::SetAllocTrackingEnabled(bool enable) {
 void AllocRecordObjectMap::RecordAllocation(Thread* self,
                                             ObjPtr<mirror::Object>* obj,
                                             size_t byte_count) {
+  // Decide whether to sample before walking the stack, which is the expensive part.
+  if (!ShouldSampleAllocation(byte_count)) {
+    return;
+  }
   // Get stack trace outside of lock in case there are allocations during the stack walk.
   // b/27858645.
   AllocRecordStackTrace trace;
@@ -257,13 +333,16 @@ void AllocRecordObjectMap::RecordAllocation(Thread* self,
   // Erase extra unfilled elements.
   trace.SetTid(self->GetTid());
 
-  // Add the record.
-  Put(obj->Ptr(), AllocRecord(byte_count, (*obj)->GetClass(), std::move(trace)));
+  // Add the record, sharing the stack trace with earlier records where possible.
+  uint32_t stack_trace_id = 0;
+  const AllocRecordStackTrace* interned_trace = InternStackTrace(std::move(trace), &stack_trace_id);
+  Put(obj->Ptr(), AllocRecord(byte_count, (*obj)->GetClass(), interned_trace, stack_trace_id));
   DCHECK_LE(Size(), alloc_record_max_);
 }
 
 void AllocRecordObjectMap::Clear() {
   entries_.clear();
+  stack_traces_.clear();
 }
 
 AllocRecordObjectMap::AllocRecordObjectMap()
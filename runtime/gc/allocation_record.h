@@ -19,6 +19,7 @@
 
 #include <list>
 #include <memory>
+#include <unordered_map>
 
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -156,16 +157,25 @@ template <typename T> struct EqAllocRecordTypesPtr {
 
 class AllocRecord {
  public:
-  // All instances of AllocRecord should be managed by an instance of AllocRecordObjectMap.
-  AllocRecord(size_t count, mirror::Class* klass, AllocRecordStackTrace&& trace)
-      : byte_count_(count), klass_(klass), trace_(std::move(trace)) {}
+  // All instances of AllocRecord should be managed by an instance of AllocRecordObjectMap, which
+  // also owns the deduplicated stack trace.
+  AllocRecord(size_t count,
+              mirror::Class* klass,
+              const AllocRecordStackTrace* trace,
+              uint32_t stack_trace_id)
+      : byte_count_(count), klass_(klass), trace_(trace), stack_trace_id_(stack_trace_id) {}
 
   size_t GetDepth() const {
-    return trace_.GetDepth();
+    return trace_->GetDepth();
   }
 
   const AllocRecordStackTrace* GetStackTrace() const {
-    return &trace_;
+    return trace_;
+  }
+
+  // Compact id of the stack trace, shared by all records with an identical stack trace.
+  uint32_t GetStackTraceId() const {
+    return stack_trace_id_;
   }
 
   size_t ByteCount() const {
@@ -173,7 +183,7 @@ class AllocRecord {
   }
 
   pid_t GetTid() const {
-    return trace_.GetTid();
+    return trace_->GetTid();
   }
 
   mirror::Class* GetClass() const REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -188,15 +198,15 @@ class AllocRecord {
   }
 
   const AllocRecordStackTraceElement& StackElement(size_t index) const {
-    return trace_.GetStackElement(index);
+    return trace_->GetStackElement(index);
   }
 
  private:
   const size_t byte_count_;
   // The klass_ could be a strong or weak root for GC
   GcRoot<mirror::Class> klass_;
-  // TODO: Share between alloc records with identical stack traces.
-  AllocRecordStackTrace trace_;
+  const AllocRecordStackTrace* trace_;
+  uint32_t stack_trace_id_;
 };
 
 class AllocRecordObjectMap {
@@ -205,6 +215,8 @@ class AllocRecordObjectMap {
   static constexpr size_t kDefaultNumRecentRecords = 64 * 1024 - 1;
   static constexpr size_t kDefaultAllocStackDepth = 16;
   static constexpr size_t kMaxSupportedStackDepth = 128;
+  // Record every allocation by default.
+  static constexpr size_t kDefaultSampleInterval = 0;
 
   // GcRoot<mirror::Object> pointers in the list are weak roots, and the last recent_record_max_
   // number of AllocRecord::klass_ pointers are strong roots (and the rest of klass_ pointers are
@@ -228,11 +240,33 @@ class AllocRecordObjectMap {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::alloc_tracker_lock_) {
     if (entries_.size() == alloc_record_max_) {
+      ReleaseStackTrace(entries_.front().second.GetStackTrace());
       entries_.pop_front();
     }
     entries_.push_back(EntryPair(GcRoot<mirror::Object>(obj), std::move(record)));
   }
 
+  // Number of distinct stack traces referenced by the allocation records.
+  size_t NumStackTraces() const REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
+    return stack_traces_.size();
+  }
+
+  // Visit each distinct stack trace together with its id, see AllocRecord::GetStackTraceId().
+  template <typename Visitor>
+  void VisitStackTraces(const Visitor& visitor) const
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
+    for (const auto& pair : stack_traces_) {
+      visitor(pair.second.id, pair.first);
+    }
+  }
+
+  // Mean number of bytes between two recorded allocations of a thread, 0 if every allocation is
+  // recorded. Consumers scale sampled byte counts by this to estimate the allocated bytes.
+  size_t GetSampleInterval() const {
+    return sample_interval_;
+  }
+
   size_t Size() const REQUIRES_SHARED(Locks::alloc_tracker_lock_) {
     return entries_.size();
   }
@@ -294,15 +328,34 @@ class AllocRecordObjectMap {
   void Clear() REQUIRES(Locks::alloc_tracker_lock_);
 
  private:
+  struct StackTraceInfo {
+    uint32_t id;
+    size_t ref_count;
+  };
+
+  // Return the shared copy of the trace, adding it to stack_traces_ if it is not present yet.
+  const AllocRecordStackTrace* InternStackTrace(AllocRecordStackTrace&& trace, uint32_t* id)
+      REQUIRES(Locks::alloc_tracker_lock_);
+  // Drop a record's reference to its stack trace, deleting the trace if it was the last one.
+  void ReleaseStackTrace(const AllocRecordStackTrace* trace) REQUIRES(Locks::alloc_tracker_lock_);
+  // Return whether the current thread should record an allocation of byte_count bytes.
+  bool ShouldSampleAllocation(size_t byte_count);
+
   size_t alloc_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumAllocRecords;
   size_t recent_record_max_ GUARDED_BY(Locks::alloc_tracker_lock_) = kDefaultNumRecentRecords;
   size_t max_stack_depth_ = kDefaultAllocStackDepth;
+  size_t sample_interval_ = kDefaultSampleInterval;
   bool allow_new_record_ GUARDED_BY(Locks::alloc_tracker_lock_) = true;
   ConditionVariable new_record_condition_ GUARDED_BY(Locks::alloc_tracker_lock_);
   // see the comment in typedef of EntryList
   EntryList entries_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // Stack traces shared by the records in entries_, reference counted by the records.
+  std::unordered_map<AllocRecordStackTrace, StackTraceInfo, HashAllocRecordTypes> stack_traces_
+      GUARDED_BY(Locks::alloc_tracker_lock_);
+  uint32_t next_stack_trace_id_ GUARDED_BY(Locks::alloc_tracker_lock_) = 1;
 
   void SetMaxStackDepth(size_t max_stack_depth) REQUIRES(Locks::alloc_tracker_lock_);
+  void SetSampleInterval(size_t sample_interval) REQUIRES(Locks::alloc_tracker_lock_);
 };
 
 }  // namespace gc
@@ -2108,6 +2108,8 @@ void RosAlloc::DumpStats(std::ostream& os) {
   std::unique_ptr<size_t[]> num_slots(new size_t[kNumOfSizeBrackets]());
   std::unique_ptr<size_t[]> num_used_slots(new size_t[kNumOfSizeBrackets]());
   std::unique_ptr<size_t[]> num_metadata_bytes(new size_t[kNumOfSizeBrackets]());
+  std::unique_ptr<size_t[]> num_thread_local_runs(new size_t[kNumOfSizeBrackets]());
+  std::unique_ptr<size_t[]> num_thread_local_free_slots(new size_t[kNumOfSizeBrackets]());
   ReaderMutexLock rmu(self, bulk_free_lock_);
   MutexLock lock_mu(self, lock_);
   for (size_t i = 0; i < page_map_size_; ) {
@@ -2143,6 +2145,10 @@ void RosAlloc::DumpStats(std::ostream& os) {
         size_t num_free_slots = run->NumberOfFreeSlots();
         num_used_slots[idx] += numOfSlots[idx] - num_free_slots;
         num_metadata_bytes[idx] += headerSizes[idx];
+        if (run->IsThreadLocal()) {
+          num_thread_local_runs[idx]++;
+          num_thread_local_free_slots[idx] += num_free_slots;
+        }
         i += num_pages;
         break;
       }
@@ -2161,7 +2167,10 @@ void RosAlloc::DumpStats(std::ostream& os) {
        << " #metadata_bytes=" << PrettySize(num_metadata_bytes[i])
        << " #slots=" << num_slots[i] << " (" << PrettySize(num_slots[i] * bracketSizes[i]) << ")"
        << " #used_slots=" << num_used_slots[i]
-       << " (" << PrettySize(num_used_slots[i] * bracketSizes[i]) << ")\n";
+       << " (" << PrettySize(num_used_slots[i] * bracketSizes[i]) << ")"
+       << " #thread_local_runs=" << num_thread_local_runs[i]
+       << " #thread_local_free_slots=" << num_thread_local_free_slots[i]
+       << " (" << PrettySize(num_thread_local_free_slots[i] * bracketSizes[i]) << ")\n";
   }
   os << "Large #allocations=" << num_large_objects
      << " #pages=" << num_pages_large_objects
@@ -2169,16 +2178,28 @@ void RosAlloc::DumpStats(std::ostream& os) {
   size_t total_num_pages = 0;
   size_t total_metadata_bytes = 0;
   size_t total_allocated_bytes = 0;
+  size_t total_free_slot_bytes = 0;
+  size_t total_thread_local_free_bytes = 0;
   for (size_t i = 0; i < kNumOfSizeBrackets; ++i) {
     total_num_pages += num_pages_runs[i];
     total_metadata_bytes += num_metadata_bytes[i];
     total_allocated_bytes += num_used_slots[i] * bracketSizes[i];
+    total_free_slot_bytes += (num_slots[i] - num_used_slots[i]) * bracketSizes[i];
+    total_thread_local_free_bytes += num_thread_local_free_slots[i] * bracketSizes[i];
   }
+  const size_t total_run_bytes = total_num_pages * gPageSize;
   total_num_pages += num_pages_large_objects;
   total_allocated_bytes += num_pages_large_objects * gPageSize;
   os << "Total #total_bytes=" << PrettySize(total_num_pages * gPageSize)
      << " #metadata_bytes=" << PrettySize(total_metadata_bytes)
      << " #used_bytes=" << PrettySize(total_allocated_bytes) << "\n";
+  // Free slots in runs can only be reused by allocations of the same bracket, so they are the
+  // fragmentation overhead of the run pages. Free slots in thread-local runs are only usable by
+  // their owning thread.
+  os << "Run fragmentation #free_slot_bytes=" << PrettySize(total_free_slot_bytes)
+     << " (" << (total_run_bytes != 0 ? 100 * total_free_slot_bytes / total_run_bytes : 0)
+     << "% of run bytes) #thread_local_free_bytes=" << PrettySize(total_thread_local_free_bytes)
+     << "\n";
   os << "\n";
 }
 
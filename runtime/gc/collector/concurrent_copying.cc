@@ -18,6 +18,7 @@
 
 #include "art_field-inl.h"
 #include "barrier.h"
+#include "base/bounded_fifo.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
 #include "base/histogram-inl.h"
@@ -53,8 +54,13 @@ namespace collector {
 
 static constexpr size_t kDefaultGcMarkStackSize = 2 * MB;
 // If kFilterModUnionCards then we attempt to filter cards that don't need to be dirty in the mod
-// union table. Disabled since it does not seem to help the pause much.
+// union table after every GC. Disabled since it does not seem to help the pause much.
 static constexpr bool kFilterModUnionCards = kIsDebugBuild;
+// If kFilterModUnionCardsAfterFullGc then the mod union tables are filtered after full-heap
+// cycles of generational CC. The zygote space card cache otherwise only grows, and every young
+// GC visits all of its cards concurrently. Filtering once per full GC keeps it limited to cards
+// that still point outside the immune spaces at a cost similar to a single young GC visit.
+static constexpr bool kFilterModUnionCardsAfterFullGc = true;
 // If kDisallowReadBarrierDuringScan is true then the GC aborts if there are any read barrier that
 // occur during ConcurrentCopying::Scan in GC thread. May be used to diagnose possibly unnecessary
 // read barriers. Only enabled for kIsDebugBuild to avoid performance hit.
@@ -66,6 +72,10 @@ static constexpr size_t kReadBarrierMarkStackSize = 512 * KB;
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
 // Verify that there are no missing card marks.
 static constexpr bool kVerifyNoMissingCardMarks = kIsDebugBuild;
+// Number of references popped ahead from the GC mark stack so that their headers, and then their
+// classes, are prefetched before the objects are scanned. Must be a power of two, 0 disables
+// prefetching.
+static constexpr size_t kMarkStackPrefetchDepth = 8;
 
 ConcurrentCopying::ConcurrentCopying(Heap* heap,
                                      bool young_gen,
@@ -2147,12 +2157,7 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
                                               REQUIRES_SHARED(Locks::mutator_lock_) {
                                             ProcessMarkStackRef(ref);
                                           });
-    while (!gc_mark_stack_->IsEmpty()) {
-      mirror::Object* to_ref = gc_mark_stack_->PopBack();
-      ProcessMarkStackRef(to_ref);
-      ++count;
-    }
-    gc_mark_stack_->Reset();
+    count += ProcessGcMarkStack();
   } else if (mark_stack_mode == kMarkStackModeShared) {
     // Do an empty checkpoint to avoid a race with a mutator preempted in the middle of a read
     // barrier but before pushing onto the mark stack. b/32508093. Note the weak ref access is
@@ -2192,16 +2197,47 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
       CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
     }
     // Process the GC mark stack in the exclusive mode. No need to take the lock.
+    count += ProcessGcMarkStack();
+  }
+
+  // Return true if the stack was empty.
+  return count == 0;
+}
+
+size_t ConcurrentCopying::ProcessGcMarkStack() {
+  size_t count = 0;
+  if (kMarkStackPrefetchDepth == 0) {
     while (!gc_mark_stack_->IsEmpty()) {
-      mirror::Object* to_ref = gc_mark_stack_->PopBack();
+      ProcessMarkStackRef(gc_mark_stack_->PopBack());
+      ++count;
+    }
+  } else {
+    // Keep a window of popped references in flight. Each reference's header is prefetched when
+    // it enters the window, and its class once it is next in line, at which point the header
+    // should be in the cache. Scanning may push more references, which are picked up as the
+    // window is refilled.
+    BoundedFifoPowerOfTwo<mirror::Object*, std::max<size_t>(kMarkStackPrefetchDepth, 1u)> fifo;
+    while (true) {
+      while (!gc_mark_stack_->IsEmpty() && fifo.size() < kMarkStackPrefetchDepth) {
+        mirror::Object* ref = gc_mark_stack_->PopBack();
+        DCHECK(ref != nullptr);
+        __builtin_prefetch(ref);
+        fifo.push_back(ref);
+      }
+      if (fifo.empty()) {
+        break;
+      }
+      mirror::Object* to_ref = fifo.front();
+      fifo.pop_front();
+      if (!fifo.empty()) {
+        __builtin_prefetch(fifo.front()->GetClass<kVerifyNone, kWithoutReadBarrier>().Ptr());
+      }
       ProcessMarkStackRef(to_ref);
       ++count;
     }
-    gc_mark_stack_->Reset();
   }
-
-  // Return true if the stack was empty.
-  return count == 0;
+  gc_mark_stack_->Reset();
+  return count;
 }
 
 template <typename Processor>
@@ -3783,7 +3819,9 @@ void ConcurrentCopying::FinishPhase() {
       WriterMutexLock mu2(self, *Locks::heap_bitmap_lock_);
       heap_->ClearMarkedObjects(should_eagerly_release_memory);
     }
-    if (kUseBakerReadBarrier && kFilterModUnionCards) {
+    if (kUseBakerReadBarrier &&
+        (kFilterModUnionCards ||
+         (kFilterModUnionCardsAfterFullGc && use_generational_cc_ && !young_gen_))) {
       TimingLogger::ScopedTiming split("FilterModUnionCards", GetTimings());
       ReaderMutexLock mu2(self, *Locks::heap_bitmap_lock_);
       for (space::ContinuousSpace* space : immune_spaces_.GetSpaces()) {
@@ -3860,6 +3898,13 @@ void ConcurrentCopying::ProcessReferences(Thread* self) {
   GetHeap()->GetReferenceProcessor()->ProcessReferences(self, GetTimings());
 }
 
+void ConcurrentCopying::TraceCollectorMetrics() {
+  TraceGCMetric("objects_moved",
+                objects_moved_.load(std::memory_order_relaxed) + objects_moved_gc_thread_);
+  TraceGCMetric("bytes_moved",
+                bytes_moved_.load(std::memory_order_relaxed) + bytes_moved_gc_thread_);
+}
+
 void ConcurrentCopying::RevokeAllThreadLocalBuffers() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   region_space_->RevokeAllThreadLocalBuffers();
@@ -3886,6 +3931,8 @@ mirror::Object* ConcurrentCopying::MarkFromReadBarrierWithMeasurements(Thread* c
 void ConcurrentCopying::DumpPerformanceInfo(std::ostream& os) {
   GarbageCollector::DumpPerformanceInfo(os);
   size_t num_gc_cycles = GetCumulativeTimings().GetIterations();
+  // Acquires region_lock_, so must be done before taking the histogram lock below.
+  region_space_->DumpLivenessHistogram(os);
   MutexLock mu(Thread::Current(), rb_slow_path_histogram_lock_);
   if (rb_slow_path_time_histogram_.SampleSize() > 0) {
     Histogram<uint64_t>::CumulativeData cumulative_data;
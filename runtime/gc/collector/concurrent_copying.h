@@ -103,6 +103,7 @@ class ConcurrentCopying : public GarbageCollector {
     return kCollectorTypeCC;
   }
   void RevokeAllThreadLocalBuffers() override;
+  void TraceCollectorMetrics() override;
   // Creates inter-region ref bitmaps for region-space and non-moving-space.
   // Gets called in Heap construction after the two spaces are created.
   void CreateInterRegionRefBitmaps();
@@ -212,6 +213,9 @@ class ConcurrentCopying : public GarbageCollector {
   void ProcessMarkStack() override REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   bool ProcessMarkStackOnce() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Drain gc_mark_stack_ without taking mark_stack_lock_, prefetching ahead of the scan.
+  // Returns the number of references processed.
+  size_t ProcessGcMarkStack() REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
   void ProcessMarkStackRef(mirror::Object* to_ref) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
   void GrayAllDirtyImmuneObjects()
@@ -42,50 +42,6 @@ namespace art HIDDEN {
 namespace gc {
 namespace collector {
 
-namespace {
-
-// Report a GC metric via the ATrace interface.
-void TraceGCMetric(const char* name, int64_t value) {
-  // ART's interface with systrace (through libartpalette) only supports
-  // reporting 32-bit (signed) integer values at the moment. Upon
-  // underflows/overflows, clamp metric values at `int32_t` min/max limits and
-  // report these events via a corresponding underflow/overflow counter; also
-  // log a warning about the first underflow/overflow occurrence.
-  //
-  // TODO(b/300015145): Consider extending libarpalette to allow reporting this
-  // value as a 64-bit (signed) integer (instead of a 32-bit (signed) integer).
-  // Note that this is likely unnecessary at the moment (November 2023) for any
-  // size-related GC metric, given the maximum theoretical size of a managed
-  // heap (4 GiB).
-  if (UNLIKELY(value < std::numeric_limits<int32_t>::min())) {
-    ATraceIntegerValue(name, std::numeric_limits<int32_t>::min());
-    std::string underflow_counter_name = std::string(name) + " int32_t underflow";
-    ATraceIntegerValue(underflow_counter_name.c_str(), 1);
-    static bool int32_underflow_reported = false;
-    if (!int32_underflow_reported) {
-      LOG(WARNING) << "GC Metric \"" << name << "\" with value " << value
-                   << " causing a 32-bit integer underflow";
-      int32_underflow_reported = true;
-    }
-    return;
-  }
-  if (UNLIKELY(value > std::numeric_limits<int32_t>::max())) {
-    ATraceIntegerValue(name, std::numeric_limits<int32_t>::max());
-    std::string overflow_counter_name = std::string(name) + " int32_t overflow";
-    ATraceIntegerValue(overflow_counter_name.c_str(), 1);
-    static bool int32_overflow_reported = false;
-    if (!int32_overflow_reported) {
-      LOG(WARNING) << "GC Metric \"" << name << "\" with value " << value
-                   << " causing a 32-bit integer overflow";
-      int32_overflow_reported = true;
-    }
-    return;
-  }
-  ATraceIntegerValue(name, value);
-}
-
-}  // namespace
-
 Iteration::Iteration()
     : duration_ns_(0), timings_("GC iteration timing logger", true, VLOG_IS_ON(heap)) {
   Reset(kGcCauseBackground, false);  // Reset to some place holder values.
@@ -190,6 +146,46 @@ uint64_t GarbageCollector::ExtractRssFromMincore(
   return rss;
 }
 
+// Report a GC metric via the ATrace interface.
+void GarbageCollector::TraceGCMetric(const char* name, int64_t value) {
+  // ART's interface with systrace (through libartpalette) only supports
+  // reporting 32-bit (signed) integer values at the moment. Upon
+  // underflows/overflows, clamp metric values at `int32_t` min/max limits and
+  // report these events via a corresponding underflow/overflow counter; also
+  // log a warning about the first underflow/overflow occurrence.
+  //
+  // TODO(b/300015145): Consider extending libarpalette to allow reporting this
+  // value as a 64-bit (signed) integer (instead of a 32-bit (signed) integer).
+  // Note that this is likely unnecessary at the moment (November 2023) for any
+  // size-related GC metric, given the maximum theoretical size of a managed
+  // heap (4 GiB).
+  if (UNLIKELY(value < std::numeric_limits<int32_t>::min())) {
+    ATraceIntegerValue(name, std::numeric_limits<int32_t>::min());
+    std::string underflow_counter_name = std::string(name) + " int32_t underflow";
+    ATraceIntegerValue(underflow_counter_name.c_str(), 1);
+    static bool int32_underflow_reported = false;
+    if (!int32_underflow_reported) {
+      LOG(WARNING) << "GC Metric \"" << name << "\" with value " << value
+                   << " causing a 32-bit integer underflow";
+      int32_underflow_reported = true;
+    }
+    return;
+  }
+  if (UNLIKELY(value > std::numeric_limits<int32_t>::max())) {
+    ATraceIntegerValue(name, std::numeric_limits<int32_t>::max());
+    std::string overflow_counter_name = std::string(name) + " int32_t overflow";
+    ATraceIntegerValue(overflow_counter_name.c_str(), 1);
+    static bool int32_overflow_reported = false;
+    if (!int32_overflow_reported) {
+      LOG(WARNING) << "GC Metric \"" << name << "\" with value " << value
+                   << " causing a 32-bit integer overflow";
+      int32_overflow_reported = true;
+    }
+    return;
+  }
+  ATraceIntegerValue(name, value);
+}
+
 void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   ScopedTrace trace(android::base::StringPrintf("%s %s GC", PrettyCause(gc_cause), GetName()));
   Thread* self = Thread::Current();
@@ -274,6 +270,12 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   TraceGCMetric("freed_normal_object_bytes", current_iteration->GetFreedBytes());
   TraceGCMetric("freed_large_object_bytes", current_iteration->GetFreedLargeObjectBytes());
   TraceGCMetric("freed_bytes", freed_bytes);
+  TraceGCMetric("freed_objects",
+                current_iteration->GetFreedObjects() + current_iteration->GetFreedLargeObjects());
+  TraceGCMetric("scanned_bytes", current_iteration->GetScannedBytes());
+  TraceGCMetric("pause_time_us", total_pause_time_us);
+  TraceGCMetric("gc_duration_us", NsToUs(duration_ns));
+  TraceCollectorMetrics();
 
   is_transaction_active_ = false;
 }
@@ -150,6 +150,11 @@ class GarbageCollector : public RootVisitor, public IsMarkedVisitor, public Mark
   virtual void RunPhases() = 0;
   // Revoke all the thread-local buffers.
   virtual void RevokeAllThreadLocalBuffers() = 0;
+  // Report collector specific counters of the iteration that just finished via TraceGCMetric().
+  virtual void TraceCollectorMetrics() {}
+
+  // Report a GC metric via the ATrace interface, which surfaces it as a counter track in Perfetto.
+  static void TraceGCMetric(const char* name, int64_t value);
 
   static constexpr size_t kPauseBucketSize = 500;
   static constexpr size_t kPauseBucketCount = 32;
@@ -38,6 +38,7 @@
 #include "android-base/parseint.h"
 #include "android-base/properties.h"
 #include "android-base/strings.h"
+#include "base/bounded_fifo.h"
 #include "base/file_utils.h"
 #include "base/memfd.h"
 #include "base/quasi_atomic.h"
@@ -300,6 +301,8 @@ namespace collector {
 // significantly.
 static constexpr bool kCheckLocks = kDebugLocking;
 static constexpr bool kVerifyRootsMarked = kIsDebugBuild;
+// Prefetch objects popped from the mark-stack a few iterations before scanning them.
+static constexpr bool kUseMarkStackPrefetch = true;
 // Two threads should suffice on devices.
 static constexpr size_t kMaxNumUffdWorkers = 2;
 // Number of compaction buffers reserved for mutator threads in SIGBUS feature
@@ -307,6 +310,12 @@ static constexpr size_t kMaxNumUffdWorkers = 2;
 // of mutator threads trying to access the moving-space during one compaction
 // phase.
 static constexpr size_t kMutatorCompactionBufferCount = 2048;
+// Maximum number of thread-pool workers compacting the moving-space alongside
+// the gc-thread in SIGBUS feature case.
+static constexpr size_t kMaxNumParallelCompactionWorkers = 4;
+// Number of contiguous moving-space pages claimed at a time by a parallel
+// compaction worker.
+static constexpr size_t kParallelCompactionChunkPages = 16;
 // Minimum from-space chunk to be madvised (during concurrent compaction) in one go.
 static constexpr ssize_t kMinFromSpaceMadviseSize = 1 * MB;
 // Concurrent compaction termination logic is different (and slightly more efficient) if the
@@ -367,8 +376,8 @@ bool MarkCompact::CreateUserfaultfd(bool post_fork) {
           CHECK_EQ(gUffdFeatures & kUffdFeaturesForSigbus, kUffdFeaturesForSigbus);
           api.features |= kUffdFeaturesForSigbus;
         }
-        if (uffd_minor_fault_supported_) {
-          // NOTE: This option is currently disabled.
+        if (uffd_minor_fault_supported_ || linear_alloc_minor_fault_supported_) {
+          // NOTE: Minor-fault for the moving space is currently disabled.
           CHECK_EQ(gUffdFeatures & kUffdFeaturesForMinorFault, kUffdFeaturesForMinorFault);
           api.features |= kUffdFeaturesForMinorFault;
         }
@@ -395,6 +404,12 @@ static bool IsSigbusFeatureAvailable() {
   return (gUffdFeatures & kUffdFeaturesForSigbus) == kUffdFeaturesForSigbus;
 }
 
+static bool IsLinearAllocMinorFaultAvailable() {
+  // Minor-fault mode for linear-alloc relies on MREMAP_DONTUNMAP leaving the
+  // shmem pages in place while the space is moved to its shadow map.
+  return gHaveMremapDontunmap && MarkCompact::GetUffdAndMinorFault().second;
+}
+
 size_t MarkCompact::InitializeInfoMap(uint8_t* p, size_t moving_space_sz) {
   size_t nr_moving_pages = DivideByPageSize(moving_space_sz);
 
@@ -421,15 +436,19 @@ MarkCompact::MarkCompact(Heap* heap)
       moving_space_bitmap_(bump_pointer_space_->GetMarkBitmap()),
       moving_space_begin_(bump_pointer_space_->Begin()),
       moving_space_end_(bump_pointer_space_->Limit()),
+      old_gen_end_(moving_space_begin_),
       moving_to_space_fd_(kFdUnused),
       moving_from_space_fd_(kFdUnused),
       uffd_(kFdUnused),
       sigbus_in_progress_count_(kSigbusCounterCompactionDoneMask),
+      uffd_faulted_pages_(0),
       compaction_in_progress_count_(0),
+      parallel_compaction_page_idx_(0),
       thread_pool_counter_(0),
       compacting_(false),
       uffd_initialized_(false),
       uffd_minor_fault_supported_(false),
+      linear_alloc_minor_fault_supported_(IsLinearAllocMinorFaultAvailable()),
       use_uffd_sigbus_(IsSigbusFeatureAvailable()),
       minor_fault_initialized_(false),
       map_linear_alloc_shared_(false),
@@ -444,6 +463,9 @@ MarkCompact::MarkCompact(Heap* heap)
   // doing uffd registration first. For now, just assert that we are not using
   // minor-fault. Eventually, a cleanup of linear-alloc update logic to only
   // use private anonymous would be ideal.
+  // Linear-alloc arenas created after the fork don't have this problem as they
+  // are MAP_SHARED from the beginning (see AddLinearAllocSpaceData()), and so
+  // they use minor-fault independently of this flag.
   CHECK(!uffd_minor_fault_supported_);
 
   // TODO: Depending on how the bump-pointer space move is implemented. If we
@@ -562,7 +584,10 @@ void MarkCompact::AddLinearAllocSpaceData(uint8_t* begin, size_t len) {
   size_t alignment = Heap::BestPageTableAlignment(len);
   bool is_shared = false;
   // We use MAP_SHARED on non-zygote processes for leveraging userfaultfd's minor-fault feature.
-  if (map_linear_alloc_shared_) {
+  // Arenas added after the fork are mapped MAP_SHARED here, before they are
+  // handed out, which avoids the re-mmap gap described in the constructor.
+  if (map_linear_alloc_shared_ ||
+      (linear_alloc_minor_fault_supported_ && !Runtime::Current()->IsZygote())) {
     void* ret = mmap(begin,
                      len,
                      PROT_READ | PROT_WRITE,
@@ -725,6 +750,11 @@ void MarkCompact::MarkZygoteLargeObjects() {
   }
 }
 
+void MarkCompact::TraceCollectorMetrics() {
+  TraceGCMetric("compacted_pages", moving_first_objs_count_ + black_page_count_);
+  TraceGCMetric("uffd_faulted_pages", uffd_faulted_pages_.load(std::memory_order_relaxed));
+}
+
 void MarkCompact::InitializePhase() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   mark_stack_ = heap_->GetMarkStack();
@@ -735,6 +765,7 @@ void MarkCompact::InitializePhase() {
   black_page_count_ = 0;
   bytes_scanned_ = 0;
   freed_objects_ = 0;
+  uffd_faulted_pages_.store(0, std::memory_order_relaxed);
   // The first buffer is used by gc-thread.
   compaction_buffer_counter_.store(1, std::memory_order_relaxed);
   from_space_slide_diff_ = from_space_begin_ - bump_pointer_space_->Begin();
@@ -803,7 +834,7 @@ void MarkCompact::RunPhases() {
     ReclaimPhase();
     PrepareForCompaction();
   }
-  if (uffd_ != kFallbackMode && !use_uffd_sigbus_) {
+  if (uffd_ != kFallbackMode && heap_->GetThreadPool() != nullptr) {
     heap_->GetThreadPool()->WaitForWorkersToBeCreated();
   }
 
@@ -1005,6 +1036,18 @@ class MarkCompact::ConcurrentCompactionGcTask : public SelfDeletingTask {
   size_t index_;
 };
 
+class MarkCompact::ParallelCompactionGcTask : public SelfDeletingTask {
+ public:
+  explicit ParallelCompactionGcTask(MarkCompact* collector) : collector_(collector) {}
+
+  void Run([[maybe_unused]] Thread* self) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    collector_->ParallelCompactMovingSpace();
+  }
+
+ private:
+  MarkCompact* const collector_;
+};
+
 void MarkCompact::PrepareForCompaction() {
   uint8_t* space_begin = bump_pointer_space_->Begin();
   size_t vector_len = (black_allocations_begin_ - space_begin) / kOffsetChunkSize;
@@ -1038,6 +1081,22 @@ void MarkCompact::PrepareForCompaction() {
   // of the corresponding chunk. For old-to-new address computation we need
   // every element to reflect total live-bytes till the corresponding chunk.
 
+  if (VLOG_IS_ON(gc) && old_gen_end_ < black_allocations_begin_) {
+    // Report how much of the young generation survived this cycle. A low
+    // survival ratio indicates that a young-generation collection, which only
+    // compacts the memory beyond old_gen_end_, would be profitable.
+    DCHECK_ALIGNED_PARAM(old_gen_end_, gPageSize);
+    size_t young_gen_live_bytes = 0;
+    for (size_t i = (old_gen_end_ - space_begin) / kOffsetChunkSize; i < vector_len; i++) {
+      young_gen_live_bytes += chunk_info_vec_[i];
+    }
+    size_t young_gen_bytes = black_allocations_begin_ - old_gen_end_;
+    VLOG(gc) << "CMC young-generation survival: " << PrettySize(young_gen_live_bytes) << "/"
+             << PrettySize(young_gen_bytes) << " ("
+             << (100.0 * young_gen_live_bytes / young_gen_bytes) << "%), old-generation "
+             << PrettySize(old_gen_end_ - space_begin);
+  }
+
   // Live-bytes count is required to compute post_compact_end_ below.
   uint32_t total;
   // Update the vector one past the heap usage as it is required for black
@@ -1111,6 +1170,14 @@ void MarkCompact::PrepareForCompaction() {
         pool->AddTask(thread_running_gc_, new ConcurrentCompactionGcTask(this, i + 1));
       }
       CHECK_EQ(pool->GetTaskCount(thread_running_gc_), num_threads);
+    } else if (heap_->GetThreadPool() == nullptr && heap_->GetParallelGCThreadCount() > 0) {
+      // With SIGBUS feature, mutators handle their own faults. So the
+      // thread-pool is only used by workers compacting the moving-space in
+      // parallel with the gc-thread (see ParallelCompactMovingSpace()). The
+      // pool must be created here as threads cannot be created during the
+      // compaction pause.
+      heap_->CreateThreadPool(
+          std::min(heap_->GetParallelGCThreadCount(), kMaxNumParallelCompactionWorkers));
     }
     /*
      * Possible scenarios for mappings:
@@ -1905,7 +1972,7 @@ void MarkCompact::SlideBlackPage(mirror::Object* first_obj,
     // in-between.
     std::memcpy(dest, src_addr, remaining_bytes);
     DCHECK_LT(reinterpret_cast<uintptr_t>(found_obj), page_end);
-    moving_space_bitmap_->VisitMarkedRange(
+    moving_space_bitmap_->VisitMarkedRange</*kVisitOnce=*/ false, /*kPrefetchObjects=*/ true>(
             reinterpret_cast<uintptr_t>(found_obj) + mirror::kObjectHeaderSize,
             page_end,
             [&found_obj, pre_compact_addr, dest, this, verify_obj_callback] (mirror::Object* obj)
@@ -2336,6 +2403,37 @@ void MarkCompact::CompactMovingSpace(uint8_t* page) {
   DCHECK_EQ(to_space_end, bump_pointer_space_->Begin());
 }
 
+void MarkCompact::ParallelCompactMovingSpace() {
+  DCHECK(use_uffd_sigbus_);
+  DCHECK(!minor_fault_initialized_);
+  Thread* self = Thread::Current();
+  uint8_t* const begin = bump_pointer_space_->Begin();
+  const size_t nr_moving_space_used_pages = moving_first_objs_count_ + black_page_count_;
+  while (true) {
+    size_t idx = parallel_compaction_page_idx_.fetch_add(kParallelCompactionChunkPages,
+                                                         std::memory_order_relaxed);
+    if (idx >= nr_moving_space_used_pages) {
+      break;
+    }
+    size_t end_idx = std::min(idx + kParallelCompactionChunkPages, nr_moving_space_used_pages);
+    // The gc-thread compacts in reverse direction. If the last page of the
+    // chunk is already taken, then in all likelihood the gc-thread has caught
+    // up with us and the remaining pages are already taken care of.
+    if (moving_pages_status_[end_idx - 1].load(std::memory_order_relaxed) !=
+        PageState::kUnprocessed) {
+      break;
+    }
+    // Every page is independently compacted using its first-object and
+    // pre-compact offset, and claimed by changing its state. So we can use the
+    // same code path as mutators processing a page in SIGBUS handler. The
+    // compaction buffer is claimed on first use and cached in thread-local.
+    for (; idx < end_idx; idx++) {
+      ConcurrentlyProcessMovingPage<kCopyMode>(
+          begin + idx * gPageSize, self->GetThreadLocalGcBuffer(), nr_moving_space_used_pages);
+    }
+  }
+}
+
 void MarkCompact::UpdateNonMovingPage(mirror::Object* first, uint8_t* page) {
   DCHECK_LT(reinterpret_cast<uint8_t*>(first), page + gPageSize);
   // For every object found in the page, visit the previous object. This ensures
@@ -3126,6 +3224,10 @@ void MarkCompact::KernelPreparation() {
     // Prepare linear-alloc for concurrent compaction.
     for (auto& data : linear_alloc_spaces_data_) {
       bool mmap_again = map_shared && !data.already_shared_;
+      // Spaces which were MAP_SHARED before this pause can be updated in place
+      // in minor-fault mode, avoiding the copy and UFFDIO_COPY for each page.
+      data.minor_fault_ =
+          minor_fault_initialized_ || (linear_alloc_minor_fault_supported_ && data.already_shared_);
       DCHECK_EQ(static_cast<ssize_t>(data.shadow_.Size()), data.end_ - data.begin_);
       // There could be threads running in suspended mode when the compaction
       // pause is being executed. In order to make the userfaultfd setup atomic,
@@ -3134,7 +3236,7 @@ void MarkCompact::KernelPreparation() {
         // See the comment in the constructor as to why it's conditionally done.
         RegisterUffd(data.begin_,
                      data.shadow_.Size(),
-                     minor_fault_initialized_ ? kMinorFaultMode : kCopyMode);
+                     data.minor_fault_ ? kMinorFaultMode : kCopyMode);
       }
       KernelPrepareRangeForUffd(data.begin_,
                                 data.shadow_.Begin(),
@@ -3144,7 +3246,7 @@ void MarkCompact::KernelPreparation() {
         data.already_shared_ = true;
         RegisterUffd(data.begin_,
                      data.shadow_.Size(),
-                     minor_fault_initialized_ ? kMinorFaultMode : kCopyMode);
+                     data.minor_fault_ ? kMinorFaultMode : kCopyMode);
       }
     }
   }
@@ -3194,9 +3296,10 @@ void MarkCompact::ConcurrentCompaction(uint8_t* buf) {
       break;
     }
     uint8_t* fault_page = AlignDown(fault_addr, gPageSize);
+    uffd_faulted_pages_.fetch_add(1, std::memory_order_relaxed);
     if (HasAddress(reinterpret_cast<mirror::Object*>(fault_addr))) {
       ConcurrentlyProcessMovingPage<kMode>(fault_page, buf, nr_moving_space_used_pages);
-    } else if (minor_fault_initialized_) {
+    } else if (IsMinorFaultLinearAllocPage(fault_page)) {
       ConcurrentlyProcessLinearAllocPage<kMinorFaultMode>(
           fault_page, (msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_MINOR) != 0);
     } else {
@@ -3252,6 +3355,7 @@ bool MarkCompact::SigbusHandler(siginfo_t* info) {
     if (HasAddress(reinterpret_cast<mirror::Object*>(fault_page))) {
       Thread* self = Thread::Current();
       Locks::mutator_lock_->AssertSharedHeld(self);
+      uffd_faulted_pages_.fetch_add(1, std::memory_order_relaxed);
       size_t nr_moving_space_used_pages = moving_first_objs_count_ + black_page_count_;
       if (minor_fault_initialized_) {
         ConcurrentlyProcessMovingPage<kMinorFaultMode>(
@@ -3265,7 +3369,8 @@ bool MarkCompact::SigbusHandler(siginfo_t* info) {
       // Find the linear-alloc space containing fault-addr
       for (auto& data : linear_alloc_spaces_data_) {
         if (data.begin_ <= fault_page && data.end_ > fault_page) {
-          if (minor_fault_initialized_) {
+          uffd_faulted_pages_.fetch_add(1, std::memory_order_relaxed);
+          if (data.minor_fault_) {
             ConcurrentlyProcessLinearAllocPage<kMinorFaultMode>(fault_page, false);
           } else {
             ConcurrentlyProcessLinearAllocPage<kCopyMode>(fault_page, false);
@@ -3518,6 +3623,7 @@ void MarkCompact::ConcurrentlyProcessLinearAllocPage(uint8_t* fault_page, bool i
       }
     }
     DCHECK_NE(space_data, nullptr);
+    DCHECK_EQ(space_data->minor_fault_, kMode == kMinorFaultMode);
     ptrdiff_t diff = space_data->shadow_.Begin() - space_data->begin_;
     size_t page_idx = DivideByPageSize(fault_page - space_data->begin_);
     Atomic<PageState>* state_arr =
@@ -3608,6 +3714,15 @@ void MarkCompact::ConcurrentlyProcessLinearAllocPage(uint8_t* fault_page, bool i
   }
 }
 
+bool MarkCompact::IsMinorFaultLinearAllocPage(uint8_t* page) const {
+  for (const auto& data : linear_alloc_spaces_data_) {
+    if (data.begin_ <= page && page < data.end_) {
+      return data.minor_fault_;
+    }
+  }
+  return false;
+}
+
 void MarkCompact::ProcessLinearAlloc() {
   GcVisitedArenaPool* arena_pool =
       static_cast<GcVisitedArenaPool*>(Runtime::Current()->GetLinearAllocArenaPool());
@@ -3617,6 +3732,7 @@ void MarkCompact::ProcessLinearAlloc() {
     size_t arena_size;
     uint8_t* arena_begin;
     ptrdiff_t diff;
+    bool minor_fault;
     bool others_processing;
     {
       // Acquire arena-pool's lock (in shared-mode) so that the arena being updated
@@ -3645,7 +3761,8 @@ void MarkCompact::ProcessLinearAlloc() {
       }
       CHECK_NE(space_data, nullptr);
       diff = space_data->shadow_.Begin() - space_data->begin_;
-      auto visitor = [space_data, last_byte, diff, this, &others_processing](
+      minor_fault = space_data->minor_fault_;
+      auto visitor = [space_data, last_byte, diff, minor_fault, this, &others_processing](
                          uint8_t* page_begin,
                          uint8_t* first_obj,
                          size_t page_size) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -3661,7 +3778,7 @@ void MarkCompact::ProcessLinearAlloc() {
             reinterpret_cast<Atomic<PageState>*>(space_data->page_status_map_.Begin());
         PageState expected_state = PageState::kUnprocessed;
         PageState desired_state =
-            minor_fault_initialized_ ? PageState::kProcessing : PageState::kProcessingAndMapping;
+            minor_fault ? PageState::kProcessing : PageState::kProcessingAndMapping;
         // Acquire order to ensure that we don't start accessing the shadow page,
         // which is shared with other threads, prior to CAS. Also, for same
         // reason, we used 'release' order for changing the state to 'processed'.
@@ -3676,7 +3793,7 @@ void MarkCompact::ProcessLinearAlloc() {
             updater.SingleObjectArena(page_begin + diff, page_size);
           }
           expected_state = PageState::kProcessing;
-          if (!minor_fault_initialized_) {
+          if (!minor_fault) {
             MapUpdatedLinearAllocPage(
                 page_begin, page_begin + diff, state_arr[page_idx], updater.WasLastPageTouched());
           } else if (!state_arr[page_idx].compare_exchange_strong(
@@ -3699,7 +3816,7 @@ void MarkCompact::ProcessLinearAlloc() {
     // If we are not in minor-fault mode and if no other thread was found to be
     // processing any pages in this arena, then we can madvise the shadow size.
     // Otherwise, we will double the memory use for linear-alloc.
-    if (!minor_fault_initialized_ && !others_processing) {
+    if (!minor_fault && !others_processing) {
       ZeroAndReleaseMemory(arena_begin + diff, arena_size);
     }
   }
@@ -3732,7 +3849,9 @@ void MarkCompact::UnregisterUffd(uint8_t* start, size_t len) {
   // have to explicitly wake up the threads in minor-fault case.
   // TODO: The fix in the kernel is being worked on. Once the kernel version
   // containing the fix is known, make it conditional on that as well.
-  if (minor_fault_initialized_) {
+  // Waking up a range without waiters is harmless, so do it whenever any space
+  // may have been registered in minor-fault mode.
+  if (minor_fault_initialized_ || linear_alloc_minor_fault_supported_) {
     CHECK_EQ(ioctl(uffd_, UFFDIO_WAKE, &range), 0)
         << "ioctl_userfaultfd: wake failed: " << strerror(errno)
         << ". addr:" << static_cast<void*>(start) << " len:" << PrettySize(len);
@@ -3771,7 +3890,23 @@ void MarkCompact::CompactionPhase() {
       ZeropageIoctl(unused_first_page, /*tolerate_eexist*/ true, /*tolerate_enoent*/ false);
       UnregisterUffd(unused_first_page, moving_space_size - used_size);
     }
+    // With SIGBUS feature, thread-pool workers (if any) compact pages from the
+    // beginning of the moving-space while the gc-thread compacts from the end.
+    ThreadPool* pool = use_uffd_sigbus_ ? heap_->GetThreadPool() : nullptr;
+    if (pool != nullptr) {
+      parallel_compaction_page_idx_.store(0, std::memory_order_relaxed);
+      size_t num_threads = pool->GetThreadCount();
+      for (size_t i = 0; i < num_threads; i++) {
+        pool->AddTask(thread_running_gc_, new ParallelCompactionGcTask(this));
+      }
+      pool->StartWorkers(thread_running_gc_);
+    }
     CompactMovingSpace<kCopyMode>(compaction_buffers_map_.Begin());
+    if (pool != nullptr) {
+      // Workers must be done before we unregister the moving-space below.
+      pool->Wait(thread_running_gc_, /*do_work=*/false, /*may_hold_locks=*/true);
+      pool->StopWorkers(thread_running_gc_);
+    }
   }
 
   // Make sure no mutator is reading from the from-space before unregistering
@@ -3861,7 +3996,7 @@ void MarkCompact::CompactionPhase() {
     // pages, which is good in reducing the mremap (done in STW pause) time in
     // next GC cycle.
     data.shadow_.MadviseDontNeedAndZero();
-    if (minor_fault_initialized_) {
+    if (data.minor_fault_) {
       DCHECK_EQ(mprotect(data.shadow_.Begin(), data.shadow_.Size(), PROT_NONE), 0)
           << "mprotect failed: " << strerror(errno);
     }
@@ -4235,9 +4370,32 @@ void MarkCompact::ScanObject(mirror::Object* obj) {
 // Scan anything that's on the mark stack.
 void MarkCompact::ProcessMarkStack() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
-  // TODO: try prefetch like in CMS
-  while (!mark_stack_->IsEmpty()) {
-    mirror::Object* obj = mark_stack_->PopBack();
+  // Scanning an object is dominated by the cache-miss on its header, so keep
+  // a few objects in flight. This is the same scheme and FIFO size as
+  // MarkSweep's: four objects cover the miss latency without prefetching
+  // objects that get evicted before they are scanned.
+  static constexpr size_t kFifoSize = 4;
+  BoundedFifoPowerOfTwo<mirror::Object*, kFifoSize> prefetch_fifo;
+  for (;;) {
+    mirror::Object* obj = nullptr;
+    if (kUseMarkStackPrefetch) {
+      while (!mark_stack_->IsEmpty() && prefetch_fifo.size() < kFifoSize) {
+        mirror::Object* mark_stack_obj = mark_stack_->PopBack();
+        DCHECK(mark_stack_obj != nullptr);
+        __builtin_prefetch(mark_stack_obj);
+        prefetch_fifo.push_back(mark_stack_obj);
+      }
+      if (prefetch_fifo.empty()) {
+        break;
+      }
+      obj = prefetch_fifo.front();
+      prefetch_fifo.pop_front();
+    } else {
+      if (mark_stack_->IsEmpty()) {
+        break;
+      }
+      obj = mark_stack_->PopBack();
+    }
     DCHECK(obj != nullptr);
     ScanObject</*kUpdateLiveWords*/ true>(obj);
   }
@@ -4435,6 +4593,8 @@ void MarkCompact::FinishPhase() {
     // unmap the buffers used by worker threads.
     compaction_buffers_map_.SetSize(gPageSize);
   }
+  // Whatever survived this cycle is considered old in the next one.
+  old_gen_end_ = post_compact_end_;
   info_map_.MadviseDontNeedAndZero();
   live_words_bitmap_->ClearBitmap();
   // TODO: We can clear this bitmap right before compaction pause. But in that
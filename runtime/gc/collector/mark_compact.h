@@ -126,6 +126,7 @@ class MarkCompact final : public GarbageCollector {
       REQUIRES(Locks::heap_bitmap_lock_);
 
   void RevokeAllThreadLocalBuffers() override;
+  void TraceCollectorMetrics() override;
 
   void DelayReferenceReferent(ObjPtr<mirror::Class> klass,
                               ObjPtr<mirror::Reference> reference) override
@@ -345,6 +346,11 @@ class MarkCompact final : public GarbageCollector {
   template <int kMode>
   void CompactMovingSpace(uint8_t* page) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called by thread-pool workers, when using SIGBUS feature, to compact
+  // moving-space pages in increasing address order while the gc-thread is
+  // compacting them in CompactMovingSpace() in the reverse order.
+  void ParallelCompactMovingSpace() REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Compact the given page as per func and change its state. Also map/copy the
   // page, if required.
   template <int kMode, typename CompactionFn>
@@ -507,6 +513,9 @@ class MarkCompact final : public GarbageCollector {
   template <int kMode>
   void ConcurrentlyProcessLinearAllocPage(uint8_t* fault_page, bool is_minor_fault)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  // Returns true if 'page' belongs to a linear-alloc space which is registered
+  // with userfaultfd in minor-fault mode in the ongoing compaction.
+  bool IsMinorFaultLinearAllocPage(uint8_t* page) const;
 
   // Process concurrently all the pages in linear-alloc. Called by gc-thread.
   void ProcessLinearAlloc() REQUIRES_SHARED(Locks::mutator_lock_);
@@ -622,7 +631,8 @@ class MarkCompact final : public GarbageCollector {
           page_status_map_(std::move(page_status_map)),
           begin_(begin),
           end_(end),
-          already_shared_(already_shared) {}
+          already_shared_(already_shared),
+          minor_fault_(false) {}
 
     MemMap shadow_;
     MemMap page_status_map_;
@@ -630,6 +640,9 @@ class MarkCompact final : public GarbageCollector {
     uint8_t* end_;
     // Indicates if the linear-alloc is already MAP_SHARED.
     bool already_shared_;
+    // Indicates if the space is registered with userfaultfd in minor-fault
+    // mode in the ongoing compaction. Set in KernelPreparation().
+    bool minor_fault_;
   };
 
   std::vector<LinearAllocSpaceData> linear_alloc_spaces_data_;
@@ -741,6 +754,10 @@ class MarkCompact final : public GarbageCollector {
   // End of compacted space. Use for computing post-compact addr of black
   // allocated objects. Aligned up to page size.
   uint8_t* post_compact_end_;
+  // Post-compact end of the previous GC cycle. Objects below it have survived
+  // at least one GC cycle, whereas the ones beyond it were allocated since and
+  // form the young generation of the current cycle.
+  uint8_t* old_gen_end_;
   // Cache (black_allocations_begin_ - post_compact_end_) for post-compact
   // address computations.
   ptrdiff_t black_objs_slide_diff_;
@@ -774,6 +791,9 @@ class MarkCompact final : public GarbageCollector {
   // indicate that. Mutator threads check for the flag when incrementing in the
   // handler.
   std::atomic<SigbusCounterType> sigbus_in_progress_count_;
+  // Number of pages whose compaction was triggered by a userfault, either via
+  // SIGBUS in a mutator or via a uffd read in the compaction thread-pool.
+  std::atomic<size_t> uffd_faulted_pages_;
   // Number of mutator-threads/uffd-workers working on moving-space page. It
   // must be 0 before gc-thread can unregister the space after it's done
   // sequentially compacting all pages of the space.
@@ -781,6 +801,9 @@ class MarkCompact final : public GarbageCollector {
   // When using SIGBUS feature, this counter is used by mutators to claim a page
   // out of compaction buffers to be used for the entire compaction cycle.
   std::atomic<uint16_t> compaction_buffer_counter_;
+  // Index of the next moving-space page to be claimed by thread-pool workers
+  // in ParallelCompactMovingSpace().
+  std::atomic<size_t> parallel_compaction_page_idx_;
   // Used to exit from compaction loop at the end of concurrent compaction
   uint8_t thread_pool_counter_;
   // True while compacting.
@@ -794,6 +817,10 @@ class MarkCompact final : public GarbageCollector {
   // Flag indicating if userfaultfd supports minor-faults. Set appropriately in
   // CreateUserfaultfd(), where we get this information from the kernel.
   const bool uffd_minor_fault_supported_;
+  // Flag indicating if linear-alloc arenas created in non-zygote processes can
+  // be mapped MAP_SHARED right away and then updated in minor-fault mode,
+  // independent of whether the moving space uses minor-faults.
+  const bool linear_alloc_minor_fault_supported_;
   // Flag indicating if we should use sigbus signals instead of threads to
   // handle userfaults.
   const bool use_uffd_sigbus_;
@@ -824,6 +851,7 @@ class MarkCompact final : public GarbageCollector {
   class LinearAllocPageUpdater;
   class ImmuneSpaceUpdateObjVisitor;
   class ConcurrentCompactionGcTask;
+  class ParallelCompactionGcTask;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkCompact);
 };
@@ -202,6 +202,8 @@ void MarkSweep::PausePhase() {
     RevokeAllThreadLocalAllocationStacks(self);
   }
   heap_->PreSweepingGcVerification(this);
+  // Unloaded classes are freed by the sweeping below, drop the cached pointers to them.
+  Runtime::Current()->GetThreadList()->ClearTypeCheckCaches();
   // Disallow new system weaks to prevent a race which occurs when someone adds a new system
   // weak before we sweep them. Since this new system weak may not be marked, the GC may
   // incorrectly sweep it. This also fixes a race where interning may attempt to return a strong
@@ -1098,7 +1100,8 @@ void MarkSweep::ReMarkRoots() {
 void MarkSweep::SweepSystemWeaks(Thread* self) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
-  Runtime::Current()->SweepSystemWeaks(this);
+  // Objects do not move, so idle monitors can be deflated if this runs in a pause.
+  Runtime::Current()->SweepSystemWeaks(this, /*deflate_idle_monitors=*/ true);
 }
 
 class MarkSweep::VerifySystemWeakVisitor : public IsMarkedVisitor {
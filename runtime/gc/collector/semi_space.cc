@@ -502,7 +502,8 @@ void SemiSpace::MarkRoots() {
 void SemiSpace::SweepSystemWeaks() {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   Runtime* runtime = Runtime::Current();
-  runtime->SweepSystemWeaks(this);
+  // Marking already copied the live objects to their final address.
+  runtime->SweepSystemWeaks(this, /*deflate_idle_monitors=*/ true);
   runtime->GetThreadList()->SweepInterpreterCaches(this);
 }
 
@@ -44,6 +44,8 @@ enum GcCause {
   kGcCauseDisableMovingGc,
   // Not a real GC cause, used when we trim the heap.
   kGcCauseTrim,
+  // Not a real GC cause, used when we pre-clean cards between GCs.
+  kGcCauseCardPreClean,
   // Not a real GC cause, used to implement exclusion between GC and instrumentation.
   kGcCauseInstrumentation,
   // Not a real GC cause, used to add or remove app image spaces.
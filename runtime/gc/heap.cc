@@ -16,6 +16,7 @@
 
 #include "heap.h"
 
+#include <sched.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -103,6 +104,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "verify_object-inl.h"
 #include "well_known_classes.h"
 
@@ -149,6 +151,10 @@ DEFINE_RUNTIME_DEBUG_FLAG(Heap, kStressCollectorTransition);
 // Minimum amount of remaining bytes before a concurrent GC is triggered.
 static constexpr size_t kMinConcurrentRemainingBytes = 128 * KB;
 static constexpr size_t kMaxConcurrentRemainingBytes = 512 * KB;
+// Whether to move dirty cards of spaces with a mod-union table into the table between GCs, and
+// how long after a GC to do so.
+static constexpr bool kPreCleanCardsBetweenGcs = true;
+static constexpr uint64_t kCardPreCleanDelayNs = MsToNs(500);
 // Sticky GC throughput adjustment, divided by 4. Increasing this causes sticky GC to occur more
 // relative to partial/full GC. This may be desirable since sticky GCs interfere less with mutator
 // threads (lower pauses, use less memory bandwidth).
@@ -157,6 +163,9 @@ static double GetStickyGcThroughputAdjustment(bool use_generational_cc) {
 }
 // Whether or not we compact the zygote in PreZygoteFork.
 static constexpr bool kCompactZygote = kMovingCollector;
+// Whether zygote compaction packs the objects that apps are likely to write to together at the end
+// of the zygote space, rather than using them to fill holes in the non-moving space.
+static constexpr bool kGroupLikelyDirtyZygoteObjects = true;
 // How many reserve entries are at the end of the allocation stack, these are only needed if the
 // allocation stack overflows.
 static constexpr size_t kAllocationStackReserveSize = 1024;
@@ -263,6 +272,12 @@ static void VerifyBootImagesContiguity(const std::vector<gc::space::ImageSpace*>
   }
 }
 
+static void AdviseTransparentHugePages(MemMap* map) {
+  if (map->MadviseHugePages() != 0) {
+    PLOG(WARNING) << "Failed to enable transparent huge pages for " << map->GetName();
+  }
+}
+
 Heap::Heap(size_t initial_size,
            size_t growth_limit,
            size_t min_free,
@@ -298,13 +313,15 @@ Heap::Heap(size_t initial_size,
            bool verify_pre_gc_rosalloc,
            bool verify_pre_sweeping_rosalloc,
            bool verify_post_gc_rosalloc,
+           bool incremental_verify_heap,
            bool gc_stress_mode,
            bool measure_gc_performance,
            bool use_homogeneous_space_compaction_for_oom,
            bool use_generational_cc,
            uint64_t min_interval_homogeneous_space_compaction_by_oom,
            bool dump_region_info_before_gc,
-           bool dump_region_info_after_gc)
+           bool dump_region_info_after_gc,
+           bool use_transparent_huge_pages)
     : non_moving_space_(nullptr),
       rosalloc_space_(nullptr),
       dlmalloc_space_(nullptr),
@@ -363,7 +380,11 @@ Heap::Heap(size_t initial_size,
       verify_pre_gc_rosalloc_(verify_pre_gc_rosalloc),
       verify_pre_sweeping_rosalloc_(verify_pre_sweeping_rosalloc),
       verify_post_gc_rosalloc_(verify_post_gc_rosalloc),
+      incremental_verify_heap_(incremental_verify_heap),
       gc_stress_mode_(gc_stress_mode),
+      gc_cpu_affinity_requested_gen_(0),
+      gc_cpu_affinity_applied_gen_(0),
+      card_pre_clean_pending_(false),
       /* For GC a lot mode, we limit the allocation stacks to be kGcAlotInterval allocations. This
        * causes a lot of GC since we do a GC for alloc whenever the stack is full. When heap
        * verification is enabled, we limit the size of allocation stacks to speed up their
@@ -383,6 +404,10 @@ Heap::Heap(size_t initial_size,
       max_free_(max_free),
       target_utilization_(target_utilization),
       foreground_heap_growth_multiplier_(foreground_heap_growth_multiplier),
+      gc_cpu_budget_(0.0),
+      gc_cpu_budget_grow_bytes_(0),
+      last_gc_end_time_ns_(0),
+      bytes_allocated_after_last_gc_(0),
       stop_for_native_allocs_(stop_for_native_allocs),
       total_wait_time_(0),
       verify_object_mode_(kVerifyObjectModeDisabled),
@@ -415,12 +440,14 @@ Heap::Heap(size_t initial_size,
           "blocking gc count rate histogram", 1U, kGcCountRateMaxBucketCount),
       alloc_tracking_enabled_(false),
       alloc_record_depth_(AllocRecordObjectMap::kDefaultAllocStackDepth),
+      alloc_record_sample_interval_(AllocRecordObjectMap::kDefaultSampleInterval),
       backtrace_lock_(nullptr),
       seen_backtrace_count_(0u),
       unique_backtrace_count_(0u),
       gc_disabled_for_shutdown_(false),
       dump_region_info_before_gc_(dump_region_info_before_gc),
       dump_region_info_after_gc_(dump_region_info_after_gc),
+      use_transparent_huge_pages_(use_transparent_huge_pages),
       boot_image_spaces_(),
       boot_images_start_address_(0u),
       boot_images_size_(0u),
@@ -643,13 +670,23 @@ Heap::Heap(size_t initial_size,
     MemMap region_space_mem_map =
         space::RegionSpace::CreateMemMap(kRegionSpaceName, capacity_ * 2, request_begin);
     CHECK(region_space_mem_map.IsValid()) << "No region space mem map";
-    region_space_ = space::RegionSpace::Create(
-        kRegionSpaceName, std::move(region_space_mem_map), use_generational_cc_);
+    if (use_transparent_huge_pages_) {
+      AdviseTransparentHugePages(&region_space_mem_map);
+    }
+    region_space_ = space::RegionSpace::Create(kRegionSpaceName,
+                                               std::move(region_space_mem_map),
+                                               use_generational_cc_,
+                                               use_transparent_huge_pages_);
     AddSpace(region_space_);
   } else if (IsMovingGc(foreground_collector_type_)) {
     // Create bump pointer spaces.
     // We only to create the bump pointer if the foreground collector is a compacting GC.
     // TODO: Place bump-pointer spaces somewhere to minimize size of card table.
+    // The CMC moving space is registered with userfaultfd and populated a page at a time, which
+    // can't make use of huge pages.
+    if (use_transparent_huge_pages_ && foreground_collector_type_ != kCollectorTypeCMC) {
+      AdviseTransparentHugePages(&main_mem_map_1);
+    }
     bump_pointer_space_ = space::BumpPointerSpace::CreateFromMemMap("Bump pointer space 1",
                                                                     std::move(main_mem_map_1));
     CHECK(bump_pointer_space_ != nullptr) << "Failed to create bump pointer space";
@@ -723,6 +760,9 @@ Heap::Heap(size_t initial_size,
   card_table_.reset(accounting::CardTable::Create(reinterpret_cast<uint8_t*>(kMinHeapAddress),
                                                   4 * GB - kMinHeapAddress));
   CHECK(card_table_.get() != nullptr) << "Failed to create card table";
+  if (use_transparent_huge_pages_) {
+    card_table_->AdviseTransparentHugePages();
+  }
   if (foreground_collector_type_ == kCollectorTypeCC && kUseTableLookupReadBarrier) {
     rb_table_.reset(new accounting::ReadBarrierTable());
     DCHECK(rb_table_->IsAllCleared());
@@ -1121,6 +1161,67 @@ void Heap::UpdateProcessState(ProcessState old_process_state, ProcessState new_p
       // transition the collector.
       RequestCollectorTransition(background_collector_type_, 0);
     }
+    if (!foreground_gc_cpus_.empty() || !background_gc_cpus_.empty()) {
+      gc_cpu_affinity_requested_gen_.fetch_add(1, std::memory_order_relaxed);
+      Thread* heap_task_thread = task_processor_->GetRunningThread();
+      if (heap_task_thread != nullptr) {
+        ApplyGcCpuAffinity(heap_task_thread);
+      }
+    }
+  }
+}
+
+void Heap::SetGcCpuAffinity(const std::vector<int>& foreground_cpus,
+                            const std::vector<int>& background_cpus) {
+  foreground_gc_cpus_ = foreground_cpus;
+  background_gc_cpus_ = background_cpus;
+}
+
+bool Heap::GetGcCpuSet(cpu_set_t* cpu_set) const {
+  if (foreground_gc_cpus_.empty() && background_gc_cpus_.empty()) {
+    return false;
+  }
+  const std::vector<int>& cpus = Runtime::Current()->InJankPerceptibleProcessState()
+      ? foreground_gc_cpus_
+      : background_gc_cpus_;
+  CPU_ZERO(cpu_set);
+  if (cpus.empty()) {
+    // Only the other process state is restricted; allow all CPUs in this one.
+    const long num_cpus = sysconf(_SC_NPROCESSORS_CONF);  // NOLINT [runtime/int] [4]
+    for (long cpu = 0; cpu < num_cpus && cpu < CPU_SETSIZE; ++cpu) {  // NOLINT [runtime/int] [4]
+      CPU_SET(cpu, cpu_set);
+    }
+  } else {
+    for (int cpu : cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, cpu_set);
+      }
+    }
+  }
+  return CPU_COUNT(cpu_set) != 0;
+}
+
+void Heap::ApplyGcCpuAffinity(Thread* thread) {
+#if defined(ART_TARGET_ANDROID)
+  cpu_set_t cpu_set;
+  if (GetGcCpuSet(&cpu_set) &&
+      sched_setaffinity(thread->GetTid(), sizeof(cpu_set), &cpu_set) != 0) {
+    PLOG(WARNING) << "Failed to set GC CPU affinity of thread " << thread->GetTid();
+  }
+#else
+  UNUSED(thread);
+#endif
+}
+
+void Heap::MaybeUpdateThreadPoolCpuAffinity() {
+  uint32_t requested_gen = gc_cpu_affinity_requested_gen_.load(std::memory_order_relaxed);
+  if (thread_pool_ == nullptr || requested_gen == gc_cpu_affinity_applied_gen_) {
+    return;
+  }
+  gc_cpu_affinity_applied_gen_ = requested_gen;
+  cpu_set_t cpu_set;
+  if (GetGcCpuSet(&cpu_set)) {
+    thread_pool_->SetPthreadAffinity(cpu_set);
   }
 }
 
@@ -1130,6 +1231,11 @@ void Heap::CreateThreadPool(size_t num_threads) {
   }
   if (num_threads != 0) {
     thread_pool_.reset(ThreadPool::Create("Heap thread pool", num_threads));
+    cpu_set_t cpu_set;
+    if (GetGcCpuSet(&cpu_set)) {
+      thread_pool_->SetPthreadAffinity(cpu_set);
+    }
+    gc_cpu_affinity_applied_gen_ = gc_cpu_affinity_requested_gen_.load(std::memory_order_relaxed);
   }
 }
 
@@ -1291,6 +1397,12 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
   os << "Max memory " << PrettySize(GetMaxMemory()) << "\n";
   if (HasZygoteSpace()) {
     os << "Zygote space size " << PrettySize(zygote_space_->Size()) << "\n";
+    size_t num_resident_pages;
+    size_t num_private_pages;
+    if (zygote_space_->CountPrivatePages(&num_resident_pages, &num_private_pages)) {
+      os << "Zygote space resident pages " << num_resident_pages << ", private "
+         << num_private_pages << "\n";
+    }
   }
   os << "Total mutator paused time: " << PrettyDuration(total_paused_time) << "\n";
   os << "Total time waiting for GC to complete: " << PrettyDuration(total_wait_time_) << "\n";
@@ -1314,7 +1426,7 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
     }
   }
 
-  if (kDumpRosAllocStatsOnSigQuit && rosalloc_space_ != nullptr) {
+  if ((kDumpRosAllocStatsOnSigQuit || VLOG_IS_ON(heap)) && rosalloc_space_ != nullptr) {
     rosalloc_space_->DumpStats(os);
   }
 
@@ -1659,6 +1771,11 @@ void Heap::TrimSpaces(Thread* self) {
   uint64_t total_alloc_space_allocated = 0;
   uint64_t total_alloc_space_size = 0;
   uint64_t managed_reclaimed = 0;
+  if (rosalloc_space_ != nullptr && !Runtime::Current()->InJankPerceptibleProcessState()) {
+    // Return the partially used thread-local runs of idle threads so that the trim below can
+    // release pages that only those runs kept alive.
+    RevokeIdleRosAllocThreadLocalBuffers(self);
+  }
   {
     ScopedObjectAccess soa(self);
     for (const auto& space : continuous_spaces_) {
@@ -2229,6 +2346,7 @@ HomogeneousSpaceCompactResult Heap::PerformHomogeneousSpaceCompact() {
   // Finish GC.
   // Get the references we need to enqueue.
   SelfDeletingTask* clear = reference_processor_->CollectClearedReferences(self);
+  RequestLargeObjectUnmap(self);
   GrowForUtilization(semi_space_collector_);
   LogGC(kGcCauseHomogeneousSpaceCompact, collector);
   FinishGC(self, collector::kGcTypeFull);
@@ -2322,6 +2440,16 @@ void Heap::ChangeCollector(CollectorType collector_type) {
   }
 }
 
+// Whether `obj` is likely to be written to in apps forked from the zygote, with the same
+// heuristic as the image writer's dirty bins: plain `java.lang.Object` instances are mostly used
+// as locks and dex caches have their native arrays allocated lazily.
+static bool IsLikelyDirtiedAfterFork(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjPtr<mirror::Class> klass = obj->GetClass<kVerifyNone, kWithoutReadBarrier>();
+  // Only `j.l.Object` and primitive classes lack the superclass and there are no instances of
+  // primitive classes.
+  return !klass->HasSuperClass() || klass->IsDexCacheClass<kVerifyNone>();
+}
+
 // Special compacting collector which uses sub-optimal bin packing to reduce zygote space size.
 class ZygoteCompactingCollector final : public collector::SemiSpace {
  public:
@@ -2378,8 +2506,11 @@ class ZygoteCompactingCollector final : public collector::SemiSpace {
     size_t obj_size = obj->SizeOf<kDefaultVerifyFlags>();
     size_t alloc_size = RoundUp(obj_size, kObjectAlignment);
     mirror::Object* forward_address;
-    // Find the smallest bin which we can move obj in.
-    auto it = bins_.lower_bound(alloc_size);
+    // Find the smallest bin which we can move obj in. Objects likely to be dirtied after the fork
+    // go to the target space, so that they share as few pages as possible with clean objects.
+    auto it = (kGroupLikelyDirtyZygoteObjects && IsLikelyDirtiedAfterFork(obj))
+        ? bins_.end()
+        : bins_.lower_bound(alloc_size);
     if (it == bins_.end()) {
       // No available space in the bins, place it in the target space instead (grows the zygote
       // space).
@@ -2789,6 +2920,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       ++self->GetStats()->gc_for_alloc_count;
     }
     const size_t bytes_allocated_before_gc = GetBytesAllocated();
+    MaybeUpdateThreadPoolCpuAffinity();
 
     DCHECK_LT(gc_type, collector::kGcTypeMax);
     DCHECK_NE(gc_type, collector::kGcTypeNone);
@@ -2853,6 +2985,8 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
     collector->Run(gc_cause, clear_soft_references || runtime->IsZygote());
     IncrementFreedEver();
     RequestTrim(self);
+    RequestLargeObjectUnmap(self);
+    RequestCardPreClean(self);
     // Collect cleared references.
     clear = reference_processor_->CollectClearedReferences(self);
     // Grow the heap so that we know when to perform the next GC.
@@ -3016,9 +3150,17 @@ class ScanVisitor {
 // Verify a reference from an object.
 class VerifyReferenceVisitor : public SingleRootVisitor {
  public:
-  VerifyReferenceVisitor(Thread* self, Heap* heap, size_t* fail_count, bool verify_referent)
+  VerifyReferenceVisitor(Thread* self,
+                         Heap* heap,
+                         size_t* fail_count,
+                         bool verify_referent,
+                         bool log_failures = true)
       REQUIRES_SHARED(Locks::mutator_lock_)
-      : self_(self), heap_(heap), fail_count_(fail_count), verify_referent_(verify_referent) {
+      : self_(self),
+        heap_(heap),
+        fail_count_(fail_count),
+        verify_referent_(verify_referent),
+        log_failures_(log_failures) {
     CHECK_EQ(self_, Thread::Current());
   }
 
@@ -3072,6 +3214,9 @@ class VerifyReferenceVisitor : public SingleRootVisitor {
     }
     CHECK_EQ(self_, Thread::Current());  // fail_count_ is private to the calling thread.
     *fail_count_ += 1;
+    if (!log_failures_) {
+      return false;
+    }
     if (*fail_count_ == 1) {
       // Only print message for the first failure to prevent spam.
       LOG(ERROR) << "!!!!!!!!!!!!!!Heap corruption detected!!!!!!!!!!!!!!!!!!!";
@@ -3163,18 +3308,27 @@ class VerifyReferenceVisitor : public SingleRootVisitor {
   Heap* const heap_;
   size_t* const fail_count_;
   const bool verify_referent_;
+  const bool log_failures_;
 };
 
 // Verify all references within an object, for use with HeapBitmap::Visit.
 class VerifyObjectVisitor {
  public:
-  VerifyObjectVisitor(Thread* self, Heap* heap, size_t* fail_count, bool verify_referent)
-      : self_(self), heap_(heap), fail_count_(fail_count), verify_referent_(verify_referent) {}
+  VerifyObjectVisitor(Thread* self,
+                      Heap* heap,
+                      size_t* fail_count,
+                      bool verify_referent,
+                      bool log_failures = true)
+      : self_(self),
+        heap_(heap),
+        fail_count_(fail_count),
+        verify_referent_(verify_referent),
+        log_failures_(log_failures) {}
 
   void operator()(mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
     // Note: we are verifying the references in obj but not obj itself, this is because obj must
     // be live or else how did we find it in the live bitmap?
-    VerifyReferenceVisitor visitor(self_, heap_, fail_count_, verify_referent_);
+    VerifyReferenceVisitor visitor(self_, heap_, fail_count_, verify_referent_, log_failures_);
     // The class doesn't count as a reference but we should verify it anyways.
     obj->VisitReferences(visitor, visitor);
   }
@@ -3195,6 +3349,49 @@ class VerifyObjectVisitor {
   Heap* const heap_;
   size_t* const fail_count_;
   const bool verify_referent_;
+  const bool log_failures_;
+};
+
+// Minimum number of objects verified by each heap thread pool task.
+static constexpr size_t kMinObjectsPerVerifyTask = 4 * KB;
+
+// Verify the references of a range of objects on a heap thread pool worker. Failures are only
+// counted, as the detailed failure report visits the roots and must run on the GC thread.
+class VerifyObjectsTask : public Task {
+ public:
+  VerifyObjectsTask(Heap* heap,
+                    mirror::Object* const* begin,
+                    mirror::Object* const* end,
+                    bool verify_referent)
+      : heap_(heap), begin_(begin), end_(end), verify_referent_(verify_referent), fail_count_(0) {}
+
+  // The GC thread holds the mutator lock exclusively on behalf of the workers.
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    VerifyObjectVisitor visitor(
+        self, heap_, &fail_count_, verify_referent_, /*log_failures=*/ false);
+    for (mirror::Object* const* it = begin_; it != end_; ++it) {
+      visitor(*it);
+    }
+  }
+
+  mirror::Object* const* Begin() const {
+    return begin_;
+  }
+
+  mirror::Object* const* End() const {
+    return end_;
+  }
+
+  size_t GetFailCount() const {
+    return fail_count_;
+  }
+
+ private:
+  Heap* const heap_;
+  mirror::Object* const* const begin_;
+  mirror::Object* const* const end_;
+  const bool verify_referent_;
+  size_t fail_count_;
 };
 
 void Heap::PushOnAllocationStackWithInternalGC(Thread* self, ObjPtr<mirror::Object>* obj) {
@@ -3258,7 +3455,54 @@ size_t Heap::VerifyHeapReferences(bool verify_referents) {
   // 2. Allocated during the GC (pre sweep GC verification).
   // We don't want to verify the objects in the live stack since they themselves may be
   // pointing to dead objects if they are not reachable.
-  VisitObjectsPaused(visitor);
+  if (!incremental_verify_heap_) {
+    VisitObjectsPaused(visitor);
+  } else {
+    // Collect the objects of this GC's slice, so that the (much more expensive) verification of
+    // their references can be split between the heap thread pool workers. All the verification
+    // phases of a GC check the same slice, as the GC number only changes when the GC finishes.
+    const size_t slice = GetCurrentGcNum() % kNumHeapVerificationSlices;
+    std::vector<mirror::Object*> objects;
+    VisitObjectsPaused([&](mirror::Object* obj) {
+      if ((reinterpret_cast<uintptr_t>(obj) / kHeapVerificationSliceChunkSize) %
+              kNumHeapVerificationSlices == slice) {
+        objects.push_back(obj);
+      }
+    });
+    // Like the GC itself, leave the other cores alone in the background.
+    ThreadPool* thread_pool = GetThreadPool();
+    size_t thread_count =
+        (thread_pool != nullptr && Runtime::Current()->InJankPerceptibleProcessState())
+            ? GetParallelGCThreadCount() + 1
+            : 1u;
+    thread_count = std::min(thread_count, objects.size() / kMinObjectsPerVerifyTask + 1);
+    if (thread_count == 1u) {
+      for (mirror::Object* obj : objects) {
+        visitor(obj);
+      }
+    } else {
+      std::vector<std::unique_ptr<VerifyObjectsTask>> tasks;
+      const size_t objects_per_task = (objects.size() + thread_count - 1u) / thread_count;
+      for (size_t begin = 0; begin < objects.size(); begin += objects_per_task) {
+        size_t end = std::min(begin + objects_per_task, objects.size());
+        tasks.push_back(std::make_unique<VerifyObjectsTask>(
+            this, objects.data() + begin, objects.data() + end, verify_referents));
+        thread_pool->AddTask(self, tasks.back().get());
+      }
+      thread_pool->SetMaxActiveWorkers(thread_count - 1);
+      thread_pool->StartWorkers(self);
+      thread_pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ true);
+      thread_pool->StopWorkers(self);
+      // Verify the ranges with failures again on this thread to report them.
+      for (const std::unique_ptr<VerifyObjectsTask>& task : tasks) {
+        if (task->GetFailCount() != 0u) {
+          for (mirror::Object* const* it = task->Begin(); it != task->End(); ++it) {
+            visitor(*it);
+          }
+        }
+      }
+    }
+  }
   // Verify the roots:
   visitor.VerifyRoots();
   if (visitor.GetFailureCount() > 0) {
@@ -3783,6 +4027,10 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
       grow_bytes = 0;
     }
   }
+  if (gc_cpu_budget_ > 0.0 && IsGcConcurrent()) {
+    grow_bytes = GrowBytesForGcCpuBudget(grow_bytes, bytes_allocated, bytes_allocated_before_gc);
+    target_size = bytes_allocated + static_cast<uint64_t>(grow_bytes * multiplier);
+  }
   CHECK_LE(target_size, std::numeric_limits<size_t>::max())
       << " bytes_allocated:" << bytes_allocated
       << " bytes_freed:" << current_gc_iteration_.GetFreedBytes()
@@ -3839,6 +4087,45 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   }
 }
 
+uint64_t Heap::GrowBytesForGcCpuBudget(uint64_t grow_bytes,
+                                       size_t bytes_allocated,
+                                       size_t bytes_allocated_before_gc) {
+  const uint64_t now = NanoTime();
+  const uint64_t gc_duration = current_gc_iteration_.GetDurationNs();
+  uint64_t budget_grow_bytes =
+      gc_cpu_budget_grow_bytes_ != 0 ? gc_cpu_budget_grow_bytes_ : grow_bytes;
+  // The first GC has nothing to measure against, start from the utilization based growth.
+  if (last_gc_end_time_ns_ != 0 && now > last_gc_end_time_ns_ + gc_duration) {
+    const uint64_t mutator_time = now - last_gc_end_time_ns_ - gc_duration;
+    const size_t bytes_allocated_since_last_gc =
+        UnsignedDifference(bytes_allocated_before_gc, bytes_allocated_after_last_gc_);
+    const double allocation_rate =
+        static_cast<double>(bytes_allocated_since_last_gc) / mutator_time;  // bytes per ns.
+    // To spend gc_cpu_budget_ of the time in GC, the mutators need to run for
+    // gc_duration * (1 - budget) / budget between GCs, during which they allocate this much.
+    const double ideal_grow_bytes =
+        allocation_rate * gc_duration * (1.0 - gc_cpu_budget_) / gc_cpu_budget_;
+    // Move part of the way towards the ideal free space only, so that a single unusually short
+    // or long GC or allocation burst does not cause the heap size to swing.
+    static constexpr double kGcCpuBudgetGain = 0.5;
+    budget_grow_bytes = static_cast<uint64_t>(
+        budget_grow_bytes + kGcCpuBudgetGain * (ideal_grow_bytes - budget_grow_bytes));
+  }
+  // Keep the free space within the usual bounds, allowing it to exceed max_free_ by a fixed
+  // factor so that allocation heavy apps that would otherwise GC back to back can grow.
+  static constexpr uint64_t kGcCpuBudgetMaxFreeFactor = 4;
+  budget_grow_bytes = std::max(budget_grow_bytes, static_cast<uint64_t>(min_free_));
+  budget_grow_bytes = std::min(budget_grow_bytes, kGcCpuBudgetMaxFreeFactor * max_free_);
+  // `bytes_allocated` was sampled earlier and may exceed the current GetMaxMemory().
+  budget_grow_bytes = std::min(budget_grow_bytes,
+                               static_cast<uint64_t>(UnsignedDifference(GetMaxMemory(),
+                                                                        bytes_allocated)));
+  gc_cpu_budget_grow_bytes_ = budget_grow_bytes;
+  last_gc_end_time_ns_ = now;
+  bytes_allocated_after_last_gc_ = bytes_allocated;
+  return budget_grow_bytes;
+}
+
 void Heap::ClampGrowthLimit() {
   // Use heap bitmap lock to guard against races with BindLiveToMarkBitmap.
   ScopedObjectAccess soa(Thread::Current());
@@ -4051,6 +4338,59 @@ class Heap::HeapTrimTask : public HeapTask {
   }
 };
 
+class Heap::LargeObjectUnmapTask : public HeapTask {
+ public:
+  LargeObjectUnmapTask() : HeapTask(NanoTime()) {}
+  void Run(Thread* self) override {
+    space::LargeObjectSpace* los = Runtime::Current()->GetHeap()->GetLargeObjectsSpace();
+    if (los != nullptr) {
+      los->UnmapPendingFrees(self);
+    }
+  }
+};
+
+void Heap::RequestLargeObjectUnmap(Thread* self) {
+  if (large_object_space_ == nullptr || !large_object_space_->HasPendingUnmaps(self)) {
+    return;
+  }
+  if (CanAddHeapTask(self)) {
+    task_processor_->AddTask(self, new LargeObjectUnmapTask());
+  } else {
+    large_object_space_->UnmapPendingFrees(self);
+  }
+}
+
+class Heap::CardPreCleanTask : public HeapTask {
+ public:
+  explicit CardPreCleanTask(uint64_t target_time) : HeapTask(target_time) {}
+  void Run(Thread* self) override {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->card_pre_clean_pending_.store(false, std::memory_order_relaxed);
+    heap->PreCleanModUnionTableCards(self);
+  }
+};
+
+void Heap::RequestCardPreClean(Thread* self) {
+  if (!kPreCleanCardsBetweenGcs || mod_union_tables_.empty() || !CanAddHeapTask(self)) {
+    return;
+  }
+  if (card_pre_clean_pending_.exchange(true, std::memory_order_relaxed)) {
+    return;  // Already requested.
+  }
+  task_processor_->AddTask(self, new CardPreCleanTask(NanoTime() + kCardPreCleanDelayNs));
+}
+
+void Heap::PreCleanModUnionTableCards(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  // Exclude GCs, which own the mod-union tables while they run.
+  ScopedGCCriticalSection gcs(self, kGcCauseCardPreClean, kCollectorTypeCriticalSection);
+  for (const auto& table_pair : mod_union_tables_) {
+    // Ages the cards atomically with respect to mutators dirtying them, and records the dirty ones
+    // in the table, so that the next GC finds them there instead of in the card table.
+    table_pair.second->ProcessCards();
+  }
+}
+
 void Heap::ClearPendingTrim(Thread* self) {
   MutexLock mu(self, *pending_task_lock_);
   pending_heap_trim_ = nullptr;
@@ -4119,6 +4459,29 @@ void Heap::RevokeRosAllocThreadLocalBuffers(Thread* thread) {
   }
 }
 
+void Heap::RevokeIdleRosAllocThreadLocalBuffers(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  size_t freed_bytes_revoke = 0U;
+  {
+    ScopedSuspendAll ssa(__FUNCTION__);
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    for (Thread* thread : Runtime::Current()->GetThreadList()->GetList()) {
+      // Threads that were runnable when we suspended them are likely still allocating, so keep
+      // their runs. Threads that are waiting or in native code can refill their runs on demand.
+      if (thread->GetState() != ThreadState::kSuspended) {
+        freed_bytes_revoke += rosalloc_space_->RevokeThreadLocalBuffers(thread);
+      }
+    }
+  }
+  if (freed_bytes_revoke > 0U) {
+    IncrementNumberOfBytesFreedRevoke(freed_bytes_revoke);
+    GetMetrics()->RosAllocIdleRunRevokeBytes()->Add(freed_bytes_revoke);
+    GetMetrics()->RosAllocIdleRunRevokeBytesDelta()->Add(freed_bytes_revoke);
+  }
+  VLOG(heap) << "Revoked idle RosAlloc thread-local runs holding "
+             << PrettySize(freed_bytes_revoke) << " of free slots";
+}
+
 void Heap::RevokeAllThreadLocalBuffers() {
   if (rosalloc_space_ != nullptr) {
     size_t freed_bytes_revoke = rosalloc_space_->RevokeAllThreadLocalBuffers();
@@ -4407,6 +4770,37 @@ void Heap::JHPCheckNonTlabSampleAllocation(Thread* self, mirror::Object* obj, si
   VLOG(heap) << "JHP:NonTlab Non-moving or Large Allocation or RegisterNativeAllocation";
 }
 
+size_t Heap::AdaptiveTlabSize(Thread* self, size_t default_size, size_t max_size) {
+  // A thread which refills its TLAB this many times without an intervening GC
+  // gets its TLAB size doubled, reducing refill contention on the space lock.
+  static constexpr uint32_t kTlabGrowRefillCount = 64;
+  // A thread which refilled its TLAB fewer times than this between the last
+  // two GCs gets its TLAB size halved, reducing the space wasted in
+  // partially-used TLABs.
+  static constexpr uint32_t kTlabShrinkRefillCount = 4;
+  // TLABs are never scaled beyond 8 times their default size.
+  static constexpr uint8_t kMaxTlabSizeShift = 3;
+
+  Thread::TlabSizing* sizing = self->GetTlabSizing();
+  uint32_t gc_num = GetCurrentGcNum();
+  if (sizing->gc_num != gc_num) {
+    if (sizing->refill_count < kTlabShrinkRefillCount && sizing->size_shift > 0) {
+      sizing->size_shift--;
+      GetMetrics()->TlabShrinkCount()->Add(1);
+    }
+    sizing->refill_count = 0;
+    sizing->gc_num = gc_num;
+  }
+  if (++sizing->refill_count >= kTlabGrowRefillCount && sizing->size_shift < kMaxTlabSizeShift) {
+    sizing->size_shift++;
+    sizing->refill_count = 0;
+    GetMetrics()->TlabGrowCount()->Add(1);
+  }
+  GetMetrics()->TlabRefillCount()->Add(1);
+  GetMetrics()->TlabRefillCountDelta()->Add(1);
+  return std::min(default_size << sizing->size_shift, max_size);
+}
+
 size_t Heap::JHPCalculateNextTlabSize(Thread* self,
                                       size_t jhp_def_tlab_size,
                                       size_t alloc_size,
@@ -4539,7 +4933,9 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
     // TODO: for large allocations, which are rare, maybe we should allocate
     // that object and return. There is no need to revoke the current TLAB,
     // particularly if it's mostly unutilized.
-    size_t next_tlab_size = RoundDown(alloc_size + kDefaultTLABSize, gPageSize) - alloc_size;
+    size_t default_tlab_size =
+        AdaptiveTlabSize(self, kDefaultTLABSize, bump_pointer_space_->Capacity());
+    size_t next_tlab_size = RoundDown(alloc_size + default_tlab_size, gPageSize) - alloc_size;
     if (jhp_enabled) {
       next_tlab_size = JHPCalculateNextTlabSize(
           self, next_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -4564,8 +4960,9 @@ mirror::Object* Heap::AllocWithNewTLAB(Thread* self,
       if (LIKELY(!IsOutOfMemoryOnAllocation(allocator_type,
                                             space::RegionSpace::kRegionSize,
                                             grow))) {
-        size_t next_pr_tlab_size =
-            kUsePartialTlabs ? kPartialTlabSize : gc::space::RegionSpace::kRegionSize;
+        size_t next_pr_tlab_size = kUsePartialTlabs
+            ? AdaptiveTlabSize(self, kPartialTlabSize, gc::space::RegionSpace::kRegionSize)
+            : gc::space::RegionSpace::kRegionSize;
         if (jhp_enabled) {
           next_pr_tlab_size = JHPCalculateNextTlabSize(
               self, next_pr_tlab_size, alloc_size, &take_sample, &bytes_until_sample);
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_GC_HEAP_H_
 #define ART_RUNTIME_GC_HEAP_H_
 
+#include <sched.h>
+
 #include <android-base/logging.h>
 
 #include <iosfwd>
@@ -187,6 +189,13 @@ class Heap {
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
 
+  // With incremental heap verification, each GC verifies the references of the objects in one
+  // of `kNumHeapVerificationSlices` slices of the heap, so that the whole heap is covered every
+  // `kNumHeapVerificationSlices` GCs. Slices interleave over the address space in chunks of
+  // `kHeapVerificationSliceChunkSize` bytes so that every space contributes to each slice.
+  static constexpr size_t kNumHeapVerificationSlices = 8;
+  static constexpr size_t kHeapVerificationSliceChunkSize = 256 * KB;
+
   // Starting size of DlMalloc/RosAlloc spaces.
   static size_t GetDefaultStartingSize() {
     return gPageSize;
@@ -234,13 +243,15 @@ class Heap {
        bool verify_pre_gc_rosalloc,
        bool verify_pre_sweeping_rosalloc,
        bool verify_post_gc_rosalloc,
+       bool incremental_verify_heap,
        bool gc_stress_mode,
        bool measure_gc_performance,
        bool use_homogeneous_space_compaction,
        bool use_generational_cc,
        uint64_t min_interval_homogeneous_space_compaction_by_oom,
        bool dump_region_info_before_gc,
-       bool dump_region_info_after_gc);
+       bool dump_region_info_after_gc,
+       bool use_transparent_huge_pages);
 
   ~Heap();
 
@@ -359,7 +370,8 @@ class Heap {
 
   // Consistency check of all live references.
   void VerifyHeap() REQUIRES(!Locks::heap_bitmap_lock_);
-  // Returns how many failures occured.
+  // Returns how many failures occured. With `-Xgc:incrementalverify`, only the objects in one
+  // slice of the heap (plus all the roots) are checked in each GC, using the heap thread pool.
   size_t VerifyHeapReferences(bool verify_referents = true)
       REQUIRES(Locks::mutator_lock_, !*gc_complete_lock_);
   bool VerifyMissingCardMarks()
@@ -541,6 +553,15 @@ class Heap {
   // Scales heap growth, min free, and max free.
   double HeapGrowthMultiplier() const;
 
+  // Set the fraction of wall time concurrent GCs should take up. A non-zero budget replaces the
+  // target utilization based heap growth in GrowForUtilization() with a controller that sizes the
+  // free space from the measured allocation rate and GC duration. 0 disables the controller.
+  void SetGcCpuBudget(double budget) {
+    DCHECK_GE(budget, 0.0);
+    DCHECK_LT(budget, 1.0);
+    gc_cpu_budget_ = budget;
+  }
+
   // Freed bytes can be negative in cases where we copy objects from a compacted space to a
   // free-list backed space.
   void RecordFree(uint64_t freed_objects, int64_t freed_bytes);
@@ -787,6 +808,13 @@ class Heap {
   // values of conc_gc_threads_ and parallel_gc_threads_.
   void CreateThreadPool(size_t num_threads = 0);
   void WaitForWorkersToBeCreated();
+  // Set the CPUs GC threads should run on while the process is in the foreground and background
+  // respectively. An empty list leaves the affinity unrestricted for that process state.
+  void SetGcCpuAffinity(const std::vector<int>& foreground_cpus,
+                        const std::vector<int>& background_cpus);
+  // Apply the GC CPU affinity for the current process state to `thread`, which is expected to be
+  // a thread that only runs GC work, e.g. the HeapTaskDaemon.
+  void ApplyGcCpuAffinity(Thread* thread);
   void DeleteThreadPool();
   ThreadPool* GetThreadPool() {
     return thread_pool_.get();
@@ -882,6 +910,13 @@ class Heap {
   // Request an asynchronous trim.
   void RequestTrim(Thread* self) REQUIRES(!*pending_task_lock_);
 
+  // Request that the memory of large objects freed by the last sweep is unmapped on the heap task
+  // thread. Unmaps inline if heap tasks can not be scheduled.
+  void RequestLargeObjectUnmap(Thread* self);
+
+  // Request an asynchronous pre-cleaning of the cards of spaces with a mod-union table.
+  void RequestCardPreClean(Thread* self);
+
   // Retrieve the current GC number, i.e. the number n such that we completed n GCs so far.
   // Provides acquire ordering, so that if we read this first, and then check whether a GC is
   // required, we know that the GC number read actually preceded the test.
@@ -938,6 +973,11 @@ class Heap {
   // Reduce the number of bytes to the next sample position by this adjustment.
   void AdjustSampleOffset(size_t adjustment);
 
+  // Return the size of the next TLAB for `self`, which is `default_size` scaled
+  // as per the thread's recent TLAB refill rate, but at most `max_size`. Must
+  // be called once for each TLAB refill.
+  size_t AdaptiveTlabSize(Thread* self, size_t default_size, size_t max_size);
+
   // Allocation tracking support
   // Callers to this function use double-checked locking to ensure safety on allocation_records_
   bool IsAllocTrackingEnabled() const {
@@ -958,6 +998,16 @@ class Heap {
     alloc_record_depth_ = alloc_record_depth;
   }
 
+  // Return the mean number of bytes between sampled allocation records, 0 if all allocations are
+  // recorded.
+  size_t GetAllocTrackerSampleInterval() const {
+    return alloc_record_sample_interval_;
+  }
+
+  void SetAllocTrackerSampleInterval(size_t sample_interval) {
+    alloc_record_sample_interval_ = sample_interval;
+  }
+
   AllocRecordObjectMap* GetAllocationRecords() const REQUIRES(Locks::alloc_tracker_lock_) {
     return allocation_records_.get();
   }
@@ -1038,7 +1088,9 @@ class Heap {
  private:
   class ConcurrentGCTask;
   class CollectorTransitionTask;
+  class CardPreCleanTask;
   class HeapTrimTask;
+  class LargeObjectUnmapTask;
   class TriggerPostForkCCGcTask;
   class ReduceTargetFootprintTask;
 
@@ -1243,6 +1295,13 @@ class Heap {
                           size_t bytes_allocated_before_gc = 0)
       REQUIRES(!process_state_update_lock_);
 
+  // Returns the free space to leave after the GC that just finished so that GCs use about
+  // gc_cpu_budget_ of the time, starting from `grow_bytes` computed from the target utilization.
+  // Called from GrowForUtilization().
+  uint64_t GrowBytesForGcCpuBudget(uint64_t grow_bytes,
+                                   size_t bytes_allocated,
+                                   size_t bytes_allocated_before_gc);
+
   size_t GetPercentFree();
 
   // Swap the allocation stack with the live stack.
@@ -1284,6 +1343,15 @@ class Heap {
   // Trim the managed and native spaces by releasing unused memory back to the OS.
   void TrimSpaces(Thread* self) REQUIRES(!*gc_complete_lock_);
 
+  // Move the dirty cards of the spaces with a mod-union table into their tables, outside of a GC
+  // cycle. This keeps the number of cards the next GC has to process bounded for apps that write
+  // to image and zygote objects a lot.
+  void PreCleanModUnionTableCards(Thread* self) REQUIRES(!*gc_complete_lock_);
+
+  // Revoke the RosAlloc thread-local runs of threads that are not runnable. Suspends all threads.
+  void RevokeIdleRosAllocThreadLocalBuffers(Thread* self)
+      REQUIRES(!Locks::mutator_lock_, !Locks::thread_list_lock_);
+
   // Trim 0 pages at the end of reference tables.
   void TrimIndirectReferenceTables(Thread* self);
 
@@ -1323,6 +1391,13 @@ class Heap {
   // to incorporate foreground heap growth multiplier.
   void GrowHeapOnJankPerceptibleSwitch() REQUIRES(!process_state_update_lock_);
 
+  // Fill `cpu_set` with the GC CPUs for the current process state. Returns false if no GC CPU
+  // affinity was configured.
+  bool GetGcCpuSet(cpu_set_t* cpu_set) const;
+  // Called by the GC thread at the start of a collection to re-pin the thread pool workers if the
+  // process state changed since they were last pinned.
+  void MaybeUpdateThreadPoolCpuAffinity();
+
   // Update *_freed_ever_ counters to reflect current GC values.
   void IncrementFreedEver();
 
@@ -1553,6 +1628,8 @@ class Heap {
   bool verify_pre_gc_rosalloc_;
   bool verify_pre_sweeping_rosalloc_;
   bool verify_post_gc_rosalloc_;
+  // Whether `VerifyHeapReferences()` checks only a slice of the heap objects in each GC.
+  const bool incremental_verify_heap_;
   const bool gc_stress_mode_;
 
   // RAII that temporarily disables the rosalloc verification during
@@ -1584,6 +1661,19 @@ class Heap {
   // Parallel GC data structures.
   std::unique_ptr<ThreadPool> thread_pool_;
 
+  // CPUs the GC threads are restricted to in the foreground and background process states. Set
+  // once during runtime initialization. Empty means no restriction.
+  std::vector<int> foreground_gc_cpus_;
+  std::vector<int> background_gc_cpus_;
+  // Bumped on every process state change. The GC thread re-pins the thread pool workers when it
+  // observes a generation other than the one it last applied. The pool is only ever created and
+  // deleted by the GC thread, so updating it there avoids racing with its deletion.
+  std::atomic<uint32_t> gc_cpu_affinity_requested_gen_;
+  uint32_t gc_cpu_affinity_applied_gen_;
+
+  // True while a CardPreCleanTask is queued.
+  std::atomic<bool> card_pre_clean_pending_;
+
   // A bitmap that is set corresponding to the known live objects since the last GC cycle.
   std::unique_ptr<accounting::HeapBitmap> live_bitmap_ GUARDED_BY(Locks::heap_bitmap_lock_);
   // A bitmap that is set corresponding to the marked objects in the current GC cycle.
@@ -1628,6 +1718,15 @@ class Heap {
   // How much more we grow the heap when we are a foreground app instead of background.
   double foreground_heap_growth_multiplier_;
 
+  // Fraction of wall time we aim to spend in concurrent GCs, 0 if the heap grows for
+  // target_utilization_ instead.
+  double gc_cpu_budget_;
+  // State of the GC CPU budget controller, only accessed by the thread running the GC: the free
+  // space it chose last time, and the time and heap size when the last GC finished.
+  uint64_t gc_cpu_budget_grow_bytes_;
+  uint64_t last_gc_end_time_ns_;
+  size_t bytes_allocated_after_last_gc_;
+
   // The amount of native memory allocation since the last GC required to cause us to wait for a
   // collection as a result of native allocation. Very large values can cause the device to run
   // out of memory, due to lack of finalization to reclaim native memory.  Making it too small can
@@ -1727,6 +1826,7 @@ class Heap {
   Atomic<bool> alloc_tracking_enabled_;
   std::unique_ptr<AllocRecordObjectMap> allocation_records_;
   size_t alloc_record_depth_;
+  size_t alloc_record_sample_interval_;
 
   // Perfetto Java Heap Profiler support.
   HeapSampler heap_sampler_;
@@ -1748,6 +1848,10 @@ class Heap {
   bool dump_region_info_before_gc_;
   bool dump_region_info_after_gc_;
 
+  // Turned on by -XX:UseTransparentHugePages to back the moving space and the card table with
+  // transparent huge pages.
+  const bool use_transparent_huge_pages_;
+
   // Boot image spaces.
   std::vector<space::ImageSpace*> boot_image_spaces_;
 
@@ -16,8 +16,10 @@
 
 #include <algorithm>
 
+#include "base/bit_utils.h"
 #include "base/metrics/metrics.h"
 #include "class_linker-inl.h"
+#include "class_root-inl.h"
 #include "common_runtime_test.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
@@ -27,6 +29,7 @@
 #include "mirror/object_array-alloc-inl.h"
 #include "mirror/object_array-inl.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_list.h"
 
 namespace art HIDDEN {
 namespace gc {
@@ -275,5 +278,63 @@ TEST_F(ZygoteHeapTest, PreZygoteFork) {
   Runtime::Current()->GetHeap()->PreZygoteFork();
 }
 
+class IncrementalVerifyHeapTest : public CommonRuntimeTest {
+ public:
+  IncrementalVerifyHeapTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-Xgc:incrementalverify", nullptr));
+  }
+};
+
+TEST_F(IncrementalVerifyHeapTest, ReportsBadReference) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  // The holder must not move, so that it stays in the same slice of the heap.
+  ObjPtr<mirror::Class> array_class = GetClassRoot<mirror::ObjectArray<mirror::Object>>();
+  Handle<mirror::ObjectArray<mirror::Object>> holder(
+      hs.NewHandle(mirror::ObjectArray<mirror::Object>::Alloc(
+          self, array_class, 8, heap->GetCurrentNonMovingAllocator())));
+  ASSERT_TRUE(holder != nullptr);
+  // Point into the null elements of the holder, which no object starts at.
+  mirror::Object* bad_ref = reinterpret_cast<mirror::Object*>(
+      RoundUp(reinterpret_cast<uintptr_t>(holder.Get()) +
+                  mirror::ObjectArray<mirror::Object>::OffsetOfElement(2).Uint32Value(),
+              kObjectAlignment));
+  const size_t holder_slice =
+      (reinterpret_cast<uintptr_t>(holder.Get()) / Heap::kHeapVerificationSliceChunkSize) %
+      Heap::kNumHeapVerificationSlices;
+
+  // Each GC only verifies one slice, so the bad reference is only reported by the GCs that
+  // verify the slice of the holder.
+  bool reported = false;
+  for (size_t i = 0; i != 2 * Heap::kNumHeapVerificationSlices; ++i) {
+    size_t failures;
+    bool in_slice;
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+      ScopedSuspendAll ssa(__FUNCTION__);
+      ScopedLogSeverity sls(LogSeverity::FATAL);  // Silence the corruption report.
+      in_slice = heap->GetCurrentGcNum() % Heap::kNumHeapVerificationSlices == holder_slice;
+      holder->SetWithoutChecksAndWriteBarrier<false, false, kVerifyNone>(0, bad_ref);
+      failures = heap->VerifyHeapReferences();
+      holder->SetWithoutChecksAndWriteBarrier<false, false, kVerifyNone>(0, nullptr);
+    }
+    if (in_slice) {
+      EXPECT_NE(0u, failures) << i;
+      reported = true;
+    } else {
+      EXPECT_EQ(0u, failures) << i;
+    }
+    heap->CollectGarbage(/* clear_soft_references= */ false);
+  }
+  EXPECT_TRUE(reported);
+}
+
 }  // namespace gc
 }  // namespace art
@@ -43,6 +43,7 @@ static constexpr bool kAsyncReferenceQueueAdd = false;
 
 ReferenceProcessor::ReferenceProcessor()
     : collector_(nullptr),
+      rp_state_(RpState::kStarting),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
       soft_reference_queue_(Locks::reference_queue_soft_references_lock_),
       weak_reference_queue_(Locks::reference_queue_weak_references_lock_),
@@ -103,6 +104,28 @@ ObjPtr<mirror::Object> ReferenceProcessor::GetReferent(Thread* self,
     return referent;
   }
 
+  if (LIKELY(!reference->IsFinalizerReferenceInstance() &&
+             (kUseBakerReadBarrier || !gUseReadBarrier ||
+              !reference->IsPhantomReferenceInstance()))) {
+    // Try to answer without reference_processor_lock_. Once kInitClearingDone is reached the
+    // referent field holds its final value. In kInitMarkingDone a marked referent is the right
+    // answer as long as marking through finalizers has not started, which we check by re-reading
+    // the state after IsMarked(). An unmarked referent has to take the locked path below, since
+    // finalizer marking could still make it live.
+    RpState state = rp_state_.load(std::memory_order_acquire);
+    if (state == RpState::kInitClearingDone) {
+      return reference->GetReferent();
+    }
+    if (state == RpState::kInitMarkingDone) {
+      ObjPtr<mirror::Object> forwarded_ref = collector_->IsMarked(referent.Ptr());
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (forwarded_ref != nullptr &&
+          rp_state_.load(std::memory_order_relaxed) == RpState::kInitMarkingDone) {
+        return forwarded_ref;
+      }
+    }
+  }
+
   bool started_trace = false;
   uint64_t start_millis;
   auto finish_trace = [](uint64_t start_millis) {
@@ -192,7 +215,7 @@ void ReferenceProcessor::Setup(Thread* self,
   DCHECK(collector != nullptr);
   MutexLock mu(self, *Locks::reference_processor_lock_);
   collector_ = collector;
-  rp_state_ = RpState::kStarting;
+  rp_state_.store(RpState::kStarting, std::memory_order_relaxed);
   concurrent_ = concurrent;
   clear_soft_references_ = clear_soft_references;
 }
@@ -216,8 +239,8 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
       // Weak ref access is enabled at Zygote compaction by SemiSpace (concurrent_ == false).
       CHECK_EQ(!self->GetWeakRefAccessEnabled(), concurrent_);
     }
-    DCHECK(rp_state_ == RpState::kStarting);
-    rp_state_ = RpState::kInitMarkingDone;
+    DCHECK(rp_state_.load(std::memory_order_relaxed) == RpState::kStarting);
+    rp_state_.store(RpState::kInitMarkingDone, std::memory_order_release);
     condition_.Broadcast(self);
   }
   if (kIsDebugBuild && collector_->IsTransactionActive()) {
@@ -238,7 +261,11 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
     // then it is now safe to return, since it can only refer to marked objects. If it becomes
     // marked below, that is no longer guaranteed.
     MutexLock mu(self, *Locks::reference_processor_lock_);
-    rp_state_ = RpState::kInitClearingDone;
+    rp_state_.store(RpState::kInitClearingDone, std::memory_order_release);
+    // Order the state change before any marking through finalizers below, so that the lock-free
+    // kInitMarkingDone check in GetReferent() sees the new state if it may have observed such a
+    // mark.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
     // At this point, all mutator-accessible data is marked (black). Objects enqueued for
     // finalization will only be made available to the mutator via CollectClearedReferences after
     // we're fully done marking. Soft and WeakReferences accessible to the mutator have been
@@ -253,6 +280,9 @@ void ReferenceProcessor::ProcessReferences(Thread* self, TimingLogger* timings)
     // Preserve all white objects with finalize methods and schedule them for finalization.
     FinalizerStats finalizer_stats =
         finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector_);
+    metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+    metrics->FinalizerEnqueueCount()->Add(finalizer_stats.num_enqueued_);
+    metrics->FinalizerEnqueueCountDelta()->Add(finalizer_stats.num_enqueued_);
     if (ATraceEnabled()) {
       static constexpr size_t kBufSize = 80;
       char buf[kBufSize];
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 #define ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 
+#include <atomic>
+
 #include "base/macros.h"
 #include "base/locks.h"
 #include "jni.h"
@@ -107,9 +109,11 @@ class ReferenceProcessor {
   // it.
   collector::GarbageCollector* collector_;
   // Reference processor state. Only valid while weak reference processing is suspended.
-  // Used by GetReferent and friends to return early.
+  // Used by GetReferent and friends to return early. Only written while holding
+  // reference_processor_lock_, but GetReferent also reads it without the lock to answer queries
+  // for references whose state is already known without blocking.
   enum class RpState : uint8_t { kStarting, kInitMarkingDone, kInitClearingDone };
-  RpState rp_state_ GUARDED_BY(Locks::reference_processor_lock_);
+  std::atomic<RpState> rp_state_;
   bool concurrent_;  // Running concurrently with mutator? Only used by GC thread.
   bool clear_soft_references_;  // Only used by GC thread.
 
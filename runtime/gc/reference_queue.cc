@@ -134,6 +134,7 @@ size_t ReferenceQueue::GetLength() const {
 void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
                                           collector::GarbageCollector* collector,
                                           bool report_cleared) {
+  const bool active_transaction = Runtime::Current()->IsActiveTransaction();
   while (!IsEmpty()) {
     ObjPtr<mirror::Reference> ref = DequeuePendingReference();
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
@@ -141,7 +142,7 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
     // Reference.clear() would block.
     if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
       // Referent is white, clear it.
-      if (Runtime::Current()->IsActiveTransaction()) {
+      if (active_transaction) {
         ref->ClearReferent<true>();
       } else {
         ref->ClearReferent<false>();
@@ -166,6 +167,9 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
 FinalizerStats ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
                                                 collector::GarbageCollector* collector) {
   uint32_t num_refs(0), num_enqueued(0);
+  // The transaction state cannot change during reference processing, so look it up once rather
+  // than for every one of the potentially thousands of finalizable objects.
+  const bool active_transaction = Runtime::Current()->IsActiveTransaction();
   while (!IsEmpty()) {
     ObjPtr<mirror::FinalizerReference> ref = DequeuePendingReference()->AsFinalizerReference();
     ++num_refs;
@@ -173,9 +177,10 @@ FinalizerStats ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleare
     // do_atomic_update is false because this happens during the reference processing phase where
     // Reference.clear() would block.
     if (!collector->IsNullOrMarkedHeapReference(referent_addr, /*do_atomic_update=*/false)) {
+      // Only grey the zombie here. The caller drains the mark stack once for the whole batch.
       ObjPtr<mirror::Object> forward_address = collector->MarkObject(referent_addr->AsMirrorPtr());
       // Move the updated referent to the zombie field.
-      if (Runtime::Current()->IsActiveTransaction()) {
+      if (active_transaction) {
         ref->SetZombie<true>(forward_address);
         ref->ClearReferent<true>();
       } else {
@@ -20,11 +20,14 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "android-base/logging.h"
@@ -83,6 +86,38 @@ using ::android::base::StringPrintf;
 // supposed to be much smaller and allocating more that this would likely fail anyway.
 static constexpr size_t kMaxTotalImageReservationSize = 1 * GB;
 
+// Maximum number of threads, including the calling thread, used by `ParallelForEachIndex()`.
+static constexpr size_t kMaxImageLoadingThreads = 4u;
+
+// Call `fn(index)` for each index in [0, `count`) using short-lived helper threads.
+//
+// The boot image is loaded before the runtime thread pool exists and usually even before
+// the main thread is attached. The helper threads are not attached either, so `fn` must only
+// work on the raw image memory.
+template <typename Fn>
+void ParallelForEachIndex(size_t count, Fn&& fn) {
+  DCHECK_NE(count, 0u);
+  size_t hardware_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1u);
+  size_t num_threads = std::min({count, hardware_threads, kMaxImageLoadingThreads});
+  std::atomic<size_t> next_index(0u);
+  auto worker = [&]() NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t index = next_index.fetch_add(1u, std::memory_order_relaxed);
+         index < count;
+         index = next_index.fetch_add(1u, std::memory_order_relaxed)) {
+      fn(index);
+    }
+  };
+  std::vector<std::thread> helpers;
+  helpers.reserve(num_threads - 1u);
+  for (size_t i = 1u; i < num_threads; ++i) {
+    helpers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& helper : helpers) {
+    helper.join();
+  }
+}
+
 }  // namespace
 
 Atomic<uint32_t> ImageSpace::bitmap_index_(0);
@@ -1062,27 +1097,37 @@ class ImageSpace::Loader {
         Thread* const self = Thread::Current();
         static constexpr size_t kMinBlocks = 2u;
         const bool use_parallel = pool != nullptr && image_header.GetBlockCount() >= kMinBlocks;
-        bool failed_decompression = false;
-        for (const ImageHeader::Block& block : image_header.GetBlocks(temp_map.Begin())) {
-          auto function = [&](Thread*) {
-            const uint64_t start2 = NanoTime();
-            ScopedTrace trace("LZ4 decompress block");
-            bool result = block.Decompress(/*out_ptr=*/map.Begin(),
-                                           /*in_ptr=*/temp_map.Begin(),
-                                           error_msg);
-            if (!result) {
-              failed_decompression = true;
-              if (error_msg != nullptr) {
-                *error_msg = "Failed to decompress image block " + *error_msg;
-              }
+        // Without the runtime thread pool, for example for the boot image, use helper threads.
+        const bool use_helper_threads =
+            pool == nullptr && image_header.GetBlockCount() >= kMinBlocks;
+        std::atomic<bool> failed_decompression(false);
+        auto decompress_block = [&](const ImageHeader::Block& block) {
+          const uint64_t start2 = NanoTime();
+          ScopedTrace trace("Decompress image block");
+          bool result = block.Decompress(/*out_ptr=*/map.Begin(),
+                                         /*in_ptr=*/temp_map.Begin(),
+                                         error_msg);
+          if (!result) {
+            failed_decompression.store(true, std::memory_order_relaxed);
+            if (error_msg != nullptr) {
+              *error_msg = "Failed to decompress image block " + *error_msg;
+            }
+          }
+          VLOG(image) << "Decompress block " << block.GetDataSize() << " -> "
+                      << block.GetImageSize() << " in " << PrettyDuration(NanoTime() - start2);
+        };
+        if (use_helper_threads) {
+          const ImageHeader::Block* blocks = image_header.GetBlocks(temp_map.Begin()).begin();
+          ParallelForEachIndex(image_header.GetBlockCount(),
+                               [&](size_t index) { decompress_block(blocks[index]); });
+        } else {
+          for (const ImageHeader::Block& block : image_header.GetBlocks(temp_map.Begin())) {
+            auto function = [&](Thread*) { decompress_block(block); };
+            if (use_parallel) {
+              pool->AddTask(self, new FunctionTask(std::move(function)));
+            } else {
+              function(self);
             }
-            VLOG(image) << "Decompress block " << block.GetDataSize() << " -> "
-                        << block.GetImageSize() << " in " << PrettyDuration(NanoTime() - start2);
-          };
-          if (use_parallel) {
-            pool->AddTask(self, new FunctionTask(std::move(function)));
-          } else {
-            function(self);
           }
         }
         if (use_parallel) {
@@ -1096,7 +1141,7 @@ class ImageSpace::Loader {
         VLOG(image) << "Decompressing image took " << PrettyDuration(time) << " ("
                     << PrettySize(static_cast<uint64_t>(map.Size()) * MsToNs(1000) / (time + 1))
                     << "/s)";
-        if (failed_decompression) {
+        if (failed_decompression.load(std::memory_order_relaxed)) {
           DCHECK(error_msg == nullptr || !error_msg->empty());
           return MemMap::Invalid();
         }
@@ -2689,7 +2734,10 @@ class ImageSpace::BootImageLoader {
       }
     }
 
-    for (const std::unique_ptr<ImageSpace>& space : spaces) {
+    // All classes have been patched above. Each remaining object is patched in place and only
+    // reads its already patched class, so the spaces can be processed in parallel.
+    auto patch_objects = [&](size_t space_index) REQUIRES_SHARED(Locks::mutator_lock_) {
+      const std::unique_ptr<ImageSpace>& space = spaces[space_index];
       const ImageHeader& image_header = space->GetImageHeader();
 
       static_assert(IsAligned<kObjectAlignment>(sizeof(ImageHeader)), "Header alignment check");
@@ -2722,7 +2770,8 @@ class ImageSpace::BootImageLoader {
         }
         pos += RoundUp(object->SizeOf<kVerifyNone>(), kObjectAlignment);
       }
-    }
+    };
+    ParallelForEachIndex(spaces.size(), patch_objects);
     if (kIsDebugBuild && !kExtension) {
       // We used just Test() instead of Set() above but we need to use Set()
       // for class roots to satisfy a DCHECK() for extensions.
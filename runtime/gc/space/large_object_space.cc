@@ -83,6 +83,11 @@ class MemoryToolLargeObjectMapSpace final : public LargeObjectMapSpace {
     return LargeObjectMapSpace::Free(self, object_with_rdz);
   }
 
+  size_t FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) override {
+    // Go through Free() so that the redzones are accounted for.
+    return LargeObjectSpace::FreeList(self, num_ptrs, ptrs);
+  }
+
   bool Contains(const mirror::Object* obj) const override {
     return LargeObjectMapSpace::Contains(ObjectWithRedzone(obj));
   }
@@ -193,8 +198,7 @@ void LargeObjectMapSpace::SetAllLargeObjectsAsZygoteObjects(Thread* self, bool s
   }
 }
 
-size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
-  MutexLock mu(self, lock_);
+size_t LargeObjectMapSpace::FreeLocked(Thread* self, mirror::Object* ptr, bool defer_unmap) {
   auto it = large_objects_.find(ptr);
   if (UNLIKELY(it == large_objects_.end())) {
     ScopedObjectAccess soa(self);
@@ -206,10 +210,47 @@ size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
   size_t allocation_size = map_size;
   num_bytes_allocated_ -= allocation_size;
   --num_objects_allocated_;
+  if (defer_unmap) {
+    pending_unmaps_.push_back(std::move(it->second.mem_map));
+  }
   large_objects_.erase(it);
   return allocation_size;
 }
 
+size_t LargeObjectMapSpace::Free(Thread* self, mirror::Object* ptr) {
+  MutexLock mu(self, lock_);
+  return FreeLocked(self, ptr, /*defer_unmap=*/ false);
+}
+
+size_t LargeObjectMapSpace::FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) {
+  MutexLock mu(self, lock_);
+  size_t total = 0;
+  for (size_t i = 0; i < num_ptrs; ++i) {
+    total += FreeLocked(self, ptrs[i], /*defer_unmap=*/ true);
+  }
+  return total;
+}
+
+bool LargeObjectMapSpace::HasPendingUnmaps(Thread* self) const {
+  MutexLock mu(self, lock_);
+  return !pending_unmaps_.empty();
+}
+
+size_t LargeObjectMapSpace::UnmapPendingFrees(Thread* self) {
+  std::vector<MemMap> pending_unmaps;
+  {
+    MutexLock mu(self, lock_);
+    pending_unmaps.swap(pending_unmaps_);
+  }
+  // Unmap outside of lock_ so that allocations are not blocked behind the munmaps.
+  size_t freed_bytes = 0;
+  for (MemMap& mem_map : pending_unmaps) {
+    freed_bytes += mem_map.BaseSize();
+    mem_map.Reset();
+  }
+  return freed_bytes;
+}
+
 size_t LargeObjectMapSpace::AllocationSize(mirror::Object* obj, size_t* usable_size) {
   MutexLock mu(Thread::Current(), lock_);
   auto it = large_objects_.find(obj);
@@ -328,6 +369,20 @@ class AllocationInfo {
     DCHECK_ALIGNED_PARAM(bytes, LargeObjectSpace::ObjectAlignment());
     prev_free_ = bytes / LargeObjectSpace::ObjectAlignment();
   }
+  // The second allocation info of a free block on a segregated free list is otherwise unused, so
+  // it stores the slot indices of the neighbouring entries of that list instead.
+  uint32_t GetFreeListPrev() const {
+    return prev_free_;
+  }
+  uint32_t GetFreeListNext() const {
+    return alloc_size_;
+  }
+  void SetFreeListPrev(uint32_t slot) {
+    prev_free_ = slot;
+  }
+  void SetFreeListNext(uint32_t slot) {
+    alloc_size_ = slot;
+  }
 
  private:
   static constexpr uint32_t kFlagFree = 0x80000000;  // If block is free.
@@ -384,7 +439,9 @@ FreeListSpace::FreeListSpace(const std::string& name,
                              uint8_t* begin,
                              uint8_t* end)
     : LargeObjectSpace(name, begin, end, "free list space lock"),
-      mem_map_(std::move(mem_map)) {
+      mem_map_(std::move(mem_map)),
+      segregated_free_mask_(0u) {
+  segregated_free_lists_.fill(kNoFreeBlock);
   const size_t space_capacity = end - begin;
   free_end_ = space_capacity;
   CHECK_ALIGNED_PARAM(space_capacity, ObjectAlignment());
@@ -447,12 +504,84 @@ void FreeListSpace::ForEachMemMap(std::function<void(const MemMap&)> func) const
   func(mem_map_);
 }
 
-void FreeListSpace::RemoveFreePrev(AllocationInfo* info) {
-  CHECK_GT(info->GetPrevFree(), 0U);
-  auto it = free_blocks_.lower_bound(info);
-  CHECK(it != free_blocks_.end());
-  CHECK_EQ(*it, info);
+void FreeListSpace::AddFreeBlock(AllocationInfo* info) {
+  const size_t units = info->GetPrevFree();
+  DCHECK_GT(units, 0U);
+  if (!IsSegregatedFreeSize(units)) {
+    free_blocks_.insert(info);
+    return;
+  }
+  const uint32_t slot = GetSlotIndexForAllocationInfo(info);
+  const uint32_t head = segregated_free_lists_[units];
+  AllocationInfo* links = info->GetPrevFreeInfo() + 1;
+  links->SetFreeListPrev(kNoFreeBlock);
+  links->SetFreeListNext(head);
+  if (head != kNoFreeBlock) {
+    (allocation_info_[head].GetPrevFreeInfo() + 1)->SetFreeListPrev(slot);
+  }
+  segregated_free_lists_[units] = slot;
+  segregated_free_mask_ |= 1u << units;
+}
+
+void FreeListSpace::RemoveFreeBlock(AllocationInfo* info) {
+  const size_t units = info->GetPrevFree();
+  CHECK_GT(units, 0U);
+  if (!IsSegregatedFreeSize(units)) {
+    auto it = free_blocks_.lower_bound(info);
+    CHECK(it != free_blocks_.end());
+    CHECK_EQ(*it, info);
+    free_blocks_.erase(it);
+    return;
+  }
+  AllocationInfo* links = info->GetPrevFreeInfo() + 1;
+  const uint32_t prev = links->GetFreeListPrev();
+  const uint32_t next = links->GetFreeListNext();
+  if (prev == kNoFreeBlock) {
+    DCHECK_EQ(segregated_free_lists_[units], GetSlotIndexForAllocationInfo(info));
+    segregated_free_lists_[units] = next;
+    if (next == kNoFreeBlock) {
+      segregated_free_mask_ &= ~(1u << units);
+    }
+  } else {
+    (allocation_info_[prev].GetPrevFreeInfo() + 1)->SetFreeListNext(next);
+  }
+  if (next != kNoFreeBlock) {
+    (allocation_info_[next].GetPrevFreeInfo() + 1)->SetFreeListPrev(prev);
+  }
+}
+
+AllocationInfo* FreeListSpace::TakeFreeBlock(size_t units) {
+  auto lower_bound = [this](size_t min_units) REQUIRES(lock_) {
+    AllocationInfo temp_info;
+    temp_info.SetPrevFreeBytes(min_units * ObjectAlignment());
+    temp_info.SetByteSize(0, false);
+    return free_blocks_.lower_bound(&temp_info);
+  };
+  if (units < kMinSegregatedFreeUnits) {
+    // Blocks smaller than any segregated size are only in the set.
+    auto it = lower_bound(units);
+    if (it != free_blocks_.end() && (*it)->GetPrevFree() < kMinSegregatedFreeUnits) {
+      AllocationInfo* info = *it;
+      free_blocks_.erase(it);
+      return info;
+    }
+  }
+  if (units <= kMaxSegregatedFreeUnits) {
+    // Pick the smallest non-empty segregated list that fits.
+    const uint32_t fitting_mask = segregated_free_mask_ & ~((1u << units) - 1u);
+    if (fitting_mask != 0u) {
+      AllocationInfo* info = &allocation_info_[segregated_free_lists_[CTZ(fitting_mask)]];
+      RemoveFreeBlock(info);
+      return info;
+    }
+  }
+  auto it = lower_bound(std::max(units, kMaxSegregatedFreeUnits + 1));
+  if (it == free_blocks_.end()) {
+    return nullptr;
+  }
+  AllocationInfo* info = *it;
   free_blocks_.erase(it);
+  return info;
 }
 
 size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
@@ -483,7 +612,7 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
   if (prev_free_bytes != 0) {
     // Coalesce with previous free chunk.
     new_free_size += prev_free_bytes;
-    RemoveFreePrev(info);
+    RemoveFreeBlock(info);
     info = info->GetPrevFreeInfo();
     // The previous allocation info must not be free since we are supposed to always coalesce.
     DCHECK_EQ(info->GetPrevFreeBytes(), 0U) << "Previous allocation was free";
@@ -506,13 +635,13 @@ size_t FreeListSpace::Free(Thread* self, mirror::Object* obj) {
       DCHECK_ALIGNED_PARAM(next_next_info->ByteSize(), ObjectAlignment());
       new_free_info = next_next_info;
       new_free_size += next_next_info->GetPrevFreeBytes();
-      RemoveFreePrev(next_next_info);
+      RemoveFreeBlock(next_next_info);
     } else {
       new_free_info = next_info;
     }
     new_free_info->SetPrevFreeBytes(new_free_size);
-    free_blocks_.insert(new_free_info);
     info->SetByteSize(new_free_size, true);
+    AddFreeBlock(new_free_info);
     DCHECK_EQ(info->GetNextInfo(), new_free_info);
   }
   --num_objects_allocated_;
@@ -536,15 +665,10 @@ mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* byt
                                      size_t* usable_size, size_t* bytes_tl_bulk_allocated) {
   MutexLock mu(self, lock_);
   const size_t allocation_size = RoundUp(num_bytes, ObjectAlignment());
-  AllocationInfo temp_info;
-  temp_info.SetPrevFreeBytes(allocation_size);
-  temp_info.SetByteSize(0, false);
   AllocationInfo* new_info;
   // Find the smallest chunk at least num_bytes in size.
-  auto it = free_blocks_.lower_bound(&temp_info);
-  if (it != free_blocks_.end()) {
-    AllocationInfo* info = *it;
-    free_blocks_.erase(it);
+  AllocationInfo* info = TakeFreeBlock(allocation_size / ObjectAlignment());
+  if (info != nullptr) {
     // Fit our object in the previous allocation info free space.
     new_info = info->GetPrevFreeInfo();
     // Remove the newly allocated block from the info and update the prev_free_.
@@ -553,8 +677,8 @@ mirror::Object* FreeListSpace::Alloc(Thread* self, size_t num_bytes, size_t* byt
       AllocationInfo* new_free = info - info->GetPrevFree();
       new_free->SetPrevFreeBytes(0);
       new_free->SetByteSize(info->GetPrevFreeBytes(), true);
-      // If there is remaining space, insert back into the free set.
-      free_blocks_.insert(info);
+      // If there is remaining space, insert back into the free lists.
+      AddFreeBlock(info);
     }
   } else {
     // Try to steal some memory from the free space at the end of the space.
@@ -24,6 +24,7 @@
 #include "space.h"
 #include "thread-current-inl.h"
 
+#include <array>
 #include <set>
 #include <vector>
 
@@ -81,6 +82,15 @@ class LargeObjectSpace : public DiscontinuousSpace, public AllocSpace {
     return this;
   }
   collector::ObjectBytePair Sweep(bool swap_bitmaps);
+  // Returns true if a sweep freed objects whose memory has not been returned to the system yet.
+  virtual bool HasPendingUnmaps(Thread* self ATTRIBUTE_UNUSED) const {
+    return false;
+  }
+  // Return the memory of objects freed by previous sweeps to the system. Returns the number of
+  // bytes released. Called from a heap task so that the GC cycle does not pay for the munmaps.
+  virtual size_t UnmapPendingFrees(Thread* self ATTRIBUTE_UNUSED) {
+    return 0U;
+  }
   bool CanMoveObjects() const override {
     return false;
   }
@@ -171,6 +181,12 @@ class LargeObjectMapSpace : public LargeObjectSpace {
                         size_t* usable_size, size_t* bytes_tl_bulk_allocated) override
       REQUIRES(!lock_);
   size_t Free(Thread* self, mirror::Object* ptr) override REQUIRES(!lock_);
+  // Frees the objects under a single lock acquisition and defers unmapping their memory until
+  // UnmapPendingFrees() is called.
+  size_t FreeList(Thread* self, size_t num_ptrs, mirror::Object** ptrs) override
+      REQUIRES(!lock_);
+  bool HasPendingUnmaps(Thread* self) const override REQUIRES(!lock_);
+  size_t UnmapPendingFrees(Thread* self) override REQUIRES(!lock_);
   void Walk(DlMallocSpace::WalkCallback, void* arg) override REQUIRES(!lock_);
   // TODO: disabling thread safety analysis as this may be called when we already hold lock_.
   bool Contains(const mirror::Object* obj) const override NO_THREAD_SAFETY_ANALYSIS;
@@ -191,8 +207,14 @@ class LargeObjectMapSpace : public LargeObjectSpace {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Removes ptr from large_objects_ and updates the accounting. If defer_unmap is true the memory
+  // map is kept in pending_unmaps_ instead of being unmapped immediately.
+  size_t FreeLocked(Thread* self, mirror::Object* ptr, bool defer_unmap) REQUIRES(lock_);
+
   AllocationTrackingSafeMap<mirror::Object*, LargeObject, kAllocatorTagLOSMaps> large_objects_
       GUARDED_BY(lock_);
+  // Memory maps of swept objects which are waiting to be unmapped by UnmapPendingFrees().
+  std::vector<MemMap> pending_unmaps_ GUARDED_BY(lock_);
 };
 
 // A continuous large object space with a free-list to handle holes.
@@ -227,8 +249,22 @@ class FreeListSpace final : public LargeObjectSpace {
   uintptr_t GetAddressForAllocationInfo(const AllocationInfo* info) const {
     return GetAllocationAddressForSlot(GetSlotIndexForAllocationInfo(info));
   }
-  // Removes header from the free blocks set by finding the corresponding iterator and erasing it.
-  void RemoveFreePrev(AllocationInfo* info) REQUIRES(lock_);
+  // Free blocks between kMinSegregatedFreeUnits and kMaxSegregatedFreeUnits large-object alignment
+  // units in size are kept in per-size intrusive lists so that the common allocation sizes are
+  // found in constant time. All other free blocks are kept in free_blocks_. Free blocks are
+  // identified by the allocation info following them, whose prev_free_ holds their size.
+  static constexpr size_t kMinSegregatedFreeUnits = 2;
+  static constexpr size_t kMaxSegregatedFreeUnits = 16;
+  static constexpr uint32_t kNoFreeBlock = std::numeric_limits<uint32_t>::max();
+  static bool IsSegregatedFreeSize(size_t units) {
+    return units >= kMinSegregatedFreeUnits && units <= kMaxSegregatedFreeUnits;
+  }
+  // Add the free block preceding `info` to the segregated lists or to the free blocks set.
+  void AddFreeBlock(AllocationInfo* info) REQUIRES(lock_);
+  // Remove the free block preceding `info` from wherever AddFreeBlock() put it.
+  void RemoveFreeBlock(AllocationInfo* info) REQUIRES(lock_);
+  // Find, remove and return the smallest free block at least `units` in size, or null if none.
+  AllocationInfo* TakeFreeBlock(size_t units) REQUIRES(lock_);
   bool IsZygoteLargeObject(Thread* self, mirror::Object* obj) const override;
   void SetAllLargeObjectsAsZygoteObjects(Thread* self, bool set_mark_bit) override
       REQUIRES(!lock_)
@@ -252,6 +288,10 @@ class FreeListSpace final : public LargeObjectSpace {
   // Free bytes at the end of the space.
   size_t free_end_ GUARDED_BY(lock_);
   FreeBlocks free_blocks_ GUARDED_BY(lock_);
+  // Heads of the segregated free lists indexed by block size in units, as allocation info slot
+  // indices. Bit n of segregated_free_mask_ is set iff list n is not empty.
+  std::array<uint32_t, kMaxSegregatedFreeUnits + 1> segregated_free_lists_ GUARDED_BY(lock_);
+  uint32_t segregated_free_mask_ GUARDED_BY(lock_);
 };
 
 }  // namespace space
@@ -16,6 +16,8 @@
 
 #include "large_object_space.h"
 
+#include <algorithm>
+
 #include "base/time_utils.h"
 #include "space_test.h"
 
@@ -26,10 +28,12 @@ namespace space {
 class LargeObjectSpaceTest : public SpaceTest<CommonRuntimeTest> {
  public:
   void LargeObjectTest();
+  void SegregatedFreeListTest();
 
   static constexpr size_t kNumThreads = 10;
   static constexpr size_t kNumIterations = 1000;
   void RaceTest();
+  void DeferredUnmapTest();
 };
 
 
@@ -123,6 +127,61 @@ void LargeObjectSpaceTest::LargeObjectTest() {
   }
 }
 
+void LargeObjectSpaceTest::SegregatedFreeListTest() {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<LargeObjectSpace> los(FreeListSpace::Create("large object space", 128 * MB));
+  const size_t alignment = LargeObjectSpace::ObjectAlignment();
+  // Sizes covering the segregated free lists, the smaller blocks and the set of larger blocks.
+  std::vector<size_t> sizes;
+  for (size_t units = 1; units <= 20; ++units) {
+    sizes.push_back(units * alignment);
+  }
+  std::vector<mirror::Object*> objs;
+  for (size_t round = 0; round < 4; ++round) {
+    for (size_t size : sizes) {
+      size_t bytes_allocated = 0;
+      size_t bytes_tl_bulk_allocated = 0;
+      mirror::Object* obj =
+          los->Alloc(self, size, &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+      ASSERT_TRUE(obj != nullptr);
+      ASSERT_EQ(size, bytes_allocated);
+      objs.push_back(obj);
+    }
+  }
+  // Free every other object so that no free blocks coalesce, then allocate the same sizes again.
+  // Every request has an exactly fitting free block, which best fit must hand out instead of
+  // splitting a larger one or growing into the free space at the end.
+  std::vector<mirror::Object*> freed;
+  for (size_t i = 0; i < objs.size(); i += 2) {
+    freed.push_back(objs[i]);
+    los->Free(self, objs[i]);
+  }
+  std::sort(freed.begin(), freed.end());
+  std::vector<mirror::Object*> reallocated;
+  for (size_t i = 0; i < objs.size(); i += 2) {
+    size_t bytes_allocated = 0;
+    size_t bytes_tl_bulk_allocated = 0;
+    mirror::Object* obj = los->Alloc(
+        self, sizes[i % sizes.size()], &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+    ASSERT_TRUE(obj != nullptr);
+    reallocated.push_back(obj);
+    objs[i] = obj;
+  }
+  std::sort(reallocated.begin(), reallocated.end());
+  EXPECT_EQ(freed, reallocated);
+  for (mirror::Object* obj : objs) {
+    los->Free(self, obj);
+  }
+  EXPECT_EQ(0U, los->GetBytesAllocated());
+  // Everything must have coalesced back into a single free range.
+  size_t bytes_allocated = 0;
+  size_t bytes_tl_bulk_allocated = 0;
+  mirror::Object* obj =
+      los->Alloc(self, 100 * MB, &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+  EXPECT_TRUE(obj != nullptr);
+  los->Free(self, obj);
+}
+
 class AllocRaceTask : public Task {
  public:
   AllocRaceTask(size_t id, size_t iterations, size_t size, LargeObjectSpace* los) :
@@ -175,14 +234,53 @@ void LargeObjectSpaceTest::RaceTest() {
   }
 }
 
+void LargeObjectSpaceTest::DeferredUnmapTest() {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<LargeObjectSpace> los(LargeObjectMapSpace::Create("large object space"));
+  static constexpr size_t kNumObjects = 16;
+  std::vector<mirror::Object*> objs;
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    size_t bytes_allocated = 0;
+    size_t bytes_tl_bulk_allocated = 0;
+    mirror::Object* obj =
+        los->Alloc(self, (i + 1) * 4 * KB, &bytes_allocated, nullptr, &bytes_tl_bulk_allocated);
+    ASSERT_TRUE(obj != nullptr);
+    total_bytes += bytes_allocated;
+    objs.push_back(obj);
+  }
+  EXPECT_EQ(total_bytes, los->FreeList(self, objs.size(), objs.data()));
+  // The objects are gone from the space as soon as they are swept ...
+  EXPECT_EQ(0u, los->GetBytesAllocated());
+  EXPECT_EQ(0u, los->GetObjectsAllocated());
+  for (mirror::Object* obj : objs) {
+    EXPECT_FALSE(los->Contains(obj));
+  }
+  // ... but their memory is only returned once the pending unmaps are processed.
+  if (!Runtime::Current()->IsRunningOnMemoryTool()) {
+    EXPECT_TRUE(los->HasPendingUnmaps(self));
+    EXPECT_EQ(total_bytes, los->UnmapPendingFrees(self));
+  }
+  EXPECT_FALSE(los->HasPendingUnmaps(self));
+  EXPECT_EQ(0u, los->UnmapPendingFrees(self));
+}
+
 TEST_F(LargeObjectSpaceTest, LargeObjectTest) {
   LargeObjectTest();
 }
 
+TEST_F(LargeObjectSpaceTest, SegregatedFreeListTest) {
+  SegregatedFreeListTest();
+}
+
 TEST_F(LargeObjectSpaceTest, RaceTest) {
   RaceTest();
 }
 
+TEST_F(LargeObjectSpaceTest, DeferredUnmapTest) {
+  DeferredUnmapTest();
+}
+
 }  // namespace space
 }  // namespace gc
 }  // namespace art
@@ -32,6 +32,23 @@ namespace space {
 // value of the region size, evaculate the region.
 static constexpr uint kEvacuateLivePercentThreshold = 75U;
 
+// Same as kEvacuateLivePercentThreshold, but for regions of age at least
+// kRegionOldAge. The age of a region is the number of collections it was kept
+// through without being evacuated, so a region that received survivors in the
+// previous collection has an age of 0 and gets kEvacuateLivePercentThreshold.
+// Objects in old regions are likely to stay live, so copying a mostly live old
+// region rarely pays off. In between, the threshold is interpolated linearly.
+static constexpr uint kEvacuateLivePercentThresholdOld = 50U;
+static constexpr uint32_t kRegionOldAge = 4U;
+
+static uint EvacuateLivePercentThreshold(uint32_t age) {
+  if (age >= kRegionOldAge) {
+    return kEvacuateLivePercentThresholdOld;
+  }
+  return kEvacuateLivePercentThreshold -
+         (kEvacuateLivePercentThreshold - kEvacuateLivePercentThresholdOld) * age / kRegionOldAge;
+}
+
 // Whether we protect the unused and cleared regions.
 static constexpr bool kProtectClearedRegions = kIsDebugBuild;
 
@@ -94,12 +111,18 @@ MemMap RegionSpace::CreateMemMap(const std::string& name,
   return mem_map;
 }
 
-RegionSpace* RegionSpace::Create(
-    const std::string& name, MemMap&& mem_map, bool use_generational_cc) {
-  return new RegionSpace(name, std::move(mem_map), use_generational_cc);
+RegionSpace* RegionSpace::Create(const std::string& name,
+                                 MemMap&& mem_map,
+                                 bool use_generational_cc,
+                                 bool use_transparent_huge_pages) {
+  return new RegionSpace(
+      name, std::move(mem_map), use_generational_cc, use_transparent_huge_pages);
 }
 
-RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc)
+RegionSpace::RegionSpace(const std::string& name,
+                         MemMap&& mem_map,
+                         bool use_generational_cc,
+                         bool use_transparent_huge_pages)
     : ContinuousMemMapAllocSpace(name,
                                  std::move(mem_map),
                                  mem_map.Begin(),
@@ -108,6 +131,7 @@ RegionSpace::RegionSpace(const std::string& name, MemMap&& mem_map, bool use_gen
                                  kGcRetentionPolicyAlwaysCollect),
       region_lock_("Region lock", kRegionSpaceRegionLock),
       use_generational_cc_(use_generational_cc),
+      use_transparent_huge_pages_(use_transparent_huge_pages),
       time_(1U),
       num_regions_(mem_map_.Size() / kRegionSize),
       madvise_time_(0U),
@@ -218,14 +242,15 @@ bool RegionSpace::Region::GetUseGenerationalCC() {
   return art::Runtime::Current()->GetHeap()->GetUseGenerationalCC();
 }
 
-inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
+inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode, uint32_t time) {
   // Evacuation mode `kEvacModeNewlyAllocated` is only used during sticky-bit CC collections.
   DCHECK(GetUseGenerationalCC() || (evac_mode != kEvacModeNewlyAllocated));
   DCHECK((IsAllocated() || IsLarge()) && IsInToSpace());
   // The region should be evacuated if:
   // - the evacuation is forced (!large && `evac_mode == kEvacModeForceAll`); or
   // - the region was allocated after the start of the previous GC (newly allocated region); or
-  // - !large and the live ratio is below threshold (`kEvacuateLivePercentThreshold`).
+  // - !large and the live ratio is below threshold (see `EvacuateLivePercentThreshold()`),
+  //   which is lower for regions that have survived more collections.
   if (IsLarge()) {
     // It makes no sense to evacuate in the large case, since the region only contains zero or
     // one object. If the regions is completely empty, we'll reclaim it anyhow. If its one object
@@ -265,7 +290,11 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
       // Side node: live_percent == 0 does not necessarily mean
       // there's no live objects due to rounding (there may be a
       // few).
-      return live_bytes_ * 100U < kEvacuateLivePercentThreshold * bytes_allocated;
+      // `time` was incremented for the current collection, so a region
+      // allocated during the previous one has an age of 0.
+      DCHECK_LT(alloc_time_, time);
+      uint32_t age = time - alloc_time_ - 1;
+      return live_bytes_ * 100U < EvacuateLivePercentThreshold(age) * bytes_allocated;
     }
   }
   return false;
@@ -342,8 +371,19 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
+        bool should_evacuate = r->ShouldBeEvacuated(evac_mode, time_);
         bool is_newly_allocated = r->IsNewlyAllocated();
+        if (state == RegionState::kRegionStateAllocated &&
+            r->LiveBytes() != static_cast<size_t>(-1)) {
+          // Only non-large, non-newly allocated regions have meaningful live bytes here.
+          size_t live_percent = r->LiveBytes() * 100U / RoundUp(r->BytesAllocated(), kRegionSize);
+          size_t bucket = std::min(live_percent / (100U / kLivenessHistogramBuckets),
+                                   kLivenessHistogramBuckets - 1);
+          liveness_histogram_[bucket]++;
+          if (should_evacuate) {
+            evacuated_liveness_histogram_[bucket]++;
+          }
+        }
         if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
@@ -400,6 +440,24 @@ static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end, bool release_eage
   }
 }
 
+// Like ZeroAndProtectRegion, but only releases the huge-page aligned part of [begin, end) to the
+// kernel. The unaligned head and tail are zeroed in place since releasing them would split the
+// transparent huge pages they are part of.
+static void ZeroAndProtectHugePageRegion(uint8_t* begin, uint8_t* end, bool release_eagerly) {
+  uint8_t* huge_begin = AlignUp(begin, kTransparentHugePageSize);
+  uint8_t* huge_end = AlignDown(end, kTransparentHugePageSize);
+  if (huge_begin >= huge_end) {
+    memset(begin, 0, end - begin);
+  } else {
+    memset(begin, 0, huge_begin - begin);
+    ZeroMemory(huge_begin, huge_end - huge_begin, release_eagerly);
+    memset(huge_end, 0, end - huge_end);
+  }
+  if (kProtectClearedRegions) {
+    CheckedCall(mprotect, __FUNCTION__, begin, end - begin, PROT_NONE);
+  }
+}
+
 void RegionSpace::ReleaseFreeRegions() {
   MutexLock mu(Thread::Current(), region_lock_);
   for (size_t i = 0u; i < num_regions_; ++i) {
@@ -497,7 +555,11 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
   // Madvise the memory ranges.
   uint64_t start_time = NanoTime();
   for (const auto &iter : madvise_list) {
-    ZeroAndProtectRegion(iter.first, iter.second, release_eagerly);
+    if (use_transparent_huge_pages_) {
+      ZeroAndProtectHugePageRegion(iter.first, iter.second, release_eagerly);
+    } else {
+      ZeroAndProtectRegion(iter.first, iter.second, release_eagerly);
+    }
   }
   madvise_time_ += NanoTime() - start_time;
 
@@ -839,6 +901,18 @@ void RegionSpace::DumpRegions(std::ostream& os) {
   }
 }
 
+void RegionSpace::DumpLivenessHistogram(std::ostream& os) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  size_t bucket_width = 100U / kLivenessHistogramBuckets;
+  os << "Region liveness histogram (live%: evacuated/regions)";
+  for (size_t i = 0; i < kLivenessHistogramBuckets; ++i) {
+    os << " " << (i * bucket_width) << "-"
+       << (i == kLivenessHistogramBuckets - 1 ? 100U : (i + 1) * bucket_width) << ":"
+       << evacuated_liveness_histogram_[i] << "/" << liveness_histogram_[i];
+  }
+  os << "\n";
+}
+
 void RegionSpace::DumpNonFreeRegions(std::ostream& os) {
   MutexLock mu(Thread::Current(), region_lock_);
   for (size_t i = 0; i < num_regions_; ++i) {
@@ -22,6 +22,7 @@
 #include "space.h"
 #include "thread.h"
 
+#include <array>
 #include <functional>
 #include <map>
 
@@ -62,7 +63,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // guaranteed to be granted, if it is required, the caller should call Begin on the returned
   // space to confirm the request was granted.
   static MemMap CreateMemMap(const std::string& name, size_t capacity, uint8_t* requested_begin);
-  static RegionSpace* Create(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  static RegionSpace* Create(const std::string& name,
+                             MemMap&& mem_map,
+                             bool use_generational_cc,
+                             bool use_transparent_huge_pages = false);
 
   // Allocate `num_bytes`, returns null if the space is full.
   mirror::Object* Alloc(Thread* self,
@@ -142,6 +146,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // Dump region containing object `obj`. Precondition: `obj` is in the region space.
   void DumpRegionForObject(std::ostream& os, mirror::Object* obj) REQUIRES(!region_lock_);
   EXPORT void DumpNonFreeRegions(std::ostream& os) REQUIRES(!region_lock_);
+  // Dump the cumulative histogram of live percents of the regions considered
+  // for evacuation, along with how many of them got evacuated.
+  void DumpLivenessHistogram(std::ostream& os) REQUIRES(!region_lock_);
 
   EXPORT size_t RevokeThreadLocalBuffers(Thread* thread) override REQUIRES(!region_lock_);
   size_t RevokeThreadLocalBuffers(Thread* thread, const bool reuse) REQUIRES(!region_lock_);
@@ -388,7 +395,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   void ReleaseFreeRegions();
 
  private:
-  RegionSpace(const std::string& name, MemMap&& mem_map, bool use_generational_cc);
+  RegionSpace(const std::string& name,
+              MemMap&& mem_map,
+              bool use_generational_cc,
+              bool use_transparent_huge_pages);
 
   class Region {
    public:
@@ -557,7 +567,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     }
 
     // Return whether this region should be evacuated. Used by RegionSpace::SetFromSpace.
-    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode);
+    // `time` is the current collection time of the region space.
+    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode, uint32_t time);
 
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(GetUseGenerationalCC() || IsInUnevacFromSpace());
@@ -749,6 +760,9 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
 
   // Cached version of Heap::use_generational_cc_.
   const bool use_generational_cc_;
+  // Whether the space is backed by transparent huge pages. If so, ClearFromSpace only returns
+  // whole huge pages to the kernel and zeroes the rest in place, so as not to split them.
+  const bool use_transparent_huge_pages_;
   uint32_t time_;                  // The time as the number of collections since the startup.
   size_t num_regions_;             // The number of regions in this space.
   uint64_t madvise_time_;          // The amount of time spent in madvise for purging pages.
@@ -763,6 +777,13 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
   // regions are in non-free.
   size_t max_peak_num_non_free_regions_;
 
+  // Cumulative histograms, bucketed by live percent, of the regions considered
+  // for evacuation based on their live bytes, and of the ones evacuated.
+  static constexpr size_t kLivenessHistogramBuckets = 10;
+  std::array<size_t, kLivenessHistogramBuckets> liveness_histogram_ GUARDED_BY(region_lock_) = {};
+  std::array<size_t, kLivenessHistogramBuckets> evacuated_liveness_histogram_
+      GUARDED_BY(region_lock_) = {};
+
   // The pointer to the region array.
   std::unique_ptr<Region[]> regions_ GUARDED_BY(region_lock_);
 
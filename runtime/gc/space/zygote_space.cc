@@ -16,6 +16,10 @@
 
 #include "zygote_space.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "android-base/unique_fd.h"
 #include "base/mutex-inl.h"
 #include "base/utils.h"
 #include "gc/accounting/card_table-inl.h"
@@ -89,6 +93,44 @@ void ZygoteSpace::Dump(std::ostream& os) const {
       << ",name=\"" << GetName() << "\"]";
 }
 
+bool ZygoteSpace::CountPrivatePages(/*out*/ size_t* num_resident,
+                                    /*out*/ size_t* num_private) const {
+  // From https://www.kernel.org/doc/Documentation/vm/pagemap.txt:
+  //  * Bit  56    page exclusively mapped (since 4.2)
+  //  * Bit  63    page present
+  static constexpr uint64_t kPageExclusivelyMapped = UINT64_C(1) << 56;
+  static constexpr uint64_t kPagePresent = UINT64_C(1) << 63;
+  android::base::unique_fd pagemap(open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC));
+  if (pagemap == -1) {
+    return false;
+  }
+  const size_t page_size = MemMap::GetPageSize();
+  uintptr_t begin = AlignDown(reinterpret_cast<uintptr_t>(Begin()), page_size);
+  uintptr_t end = RoundUp(reinterpret_cast<uintptr_t>(End()), page_size);
+  *num_resident = 0u;
+  *num_private = 0u;
+  uint64_t entries[512];
+  for (uintptr_t page = begin; page != end;) {
+    size_t count = std::min<size_t>(arraysize(entries), (end - page) / page_size);
+    size_t bytes = count * sizeof(uint64_t);
+    off_t offset = (page / page_size) * sizeof(uint64_t);
+    if (TEMP_FAILURE_RETRY(pread(pagemap, entries, bytes, offset)) !=
+        static_cast<ssize_t>(bytes)) {
+      return false;
+    }
+    for (size_t i = 0; i != count; ++i) {
+      if ((entries[i] & kPagePresent) != 0u) {
+        ++*num_resident;
+        if ((entries[i] & kPageExclusivelyMapped) != 0u) {
+          ++*num_private;
+        }
+      }
+    }
+    page += count * page_size;
+  }
+  return true;
+}
+
 mirror::Object* ZygoteSpace::Alloc(Thread*, size_t, size_t*, size_t*, size_t*) {
   UNIMPLEMENTED(FATAL);
   UNREACHABLE();
@@ -40,6 +40,12 @@ class ZygoteSpace final : public ContinuousMemMapAllocSpace {
   void SetMarkBitInLiveObjects();
   void Dump(std::ostream& os) const override;
 
+  // Counts the resident pages of the space, and how many of them are mapped only by this
+  // process. In a forked app, zygote space pages are shared with the zygote until the app writes
+  // to them, so this measures the private dirty memory the app spends on the zygote space.
+  // Returns false if /proc/self/pagemap cannot be read.
+  bool CountPrivatePages(/*out*/ size_t* num_resident, /*out*/ size_t* num_private) const;
+
   SpaceType GetType() const override {
     return kSpaceTypeZygoteSpace;
   }
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "zygote_space.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include "base/mem_map.h"
+#include "common_runtime_test.h"
+#include "gc/accounting/space_bitmap-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art HIDDEN {
+namespace gc {
+namespace space {
+
+class ZygoteSpaceTest : public CommonRuntimeTest {
+ protected:
+  static constexpr size_t kNumPages = 16u;
+  static constexpr size_t kNumTouchedPages = 4u;
+
+  std::unique_ptr<ZygoteSpace> CreateZygoteSpace() {
+    std::string error_msg;
+    MemMap mem_map = MemMap::MapAnonymous("zygote space test",
+                                          kNumPages * MemMap::GetPageSize(),
+                                          PROT_READ | PROT_WRITE,
+                                          /*low_4gb=*/ true,
+                                          &error_msg);
+    CHECK(mem_map.IsValid()) << error_msg;
+    accounting::ContinuousSpaceBitmap live_bitmap = accounting::ContinuousSpaceBitmap::Create(
+        "zygote space test live bitmap", mem_map.Begin(), mem_map.Size());
+    accounting::ContinuousSpaceBitmap mark_bitmap = accounting::ContinuousSpaceBitmap::Create(
+        "zygote space test mark bitmap", mem_map.Begin(), mem_map.Size());
+    ScopedObjectAccess soa(Thread::Current());
+    return std::unique_ptr<ZygoteSpace>(ZygoteSpace::Create("zygote space test",
+                                                            std::move(mem_map),
+                                                            std::move(live_bitmap),
+                                                            std::move(mark_bitmap)));
+  }
+};
+
+TEST_F(ZygoteSpaceTest, CountPrivatePages) {
+  std::unique_ptr<ZygoteSpace> space = CreateZygoteSpace();
+  ASSERT_TRUE(space != nullptr);
+  const size_t page_size = MemMap::GetPageSize();
+
+  size_t num_resident = 0u;
+  size_t num_private = 0u;
+  ASSERT_TRUE(space->CountPrivatePages(&num_resident, &num_private));
+  EXPECT_EQ(0u, num_resident);
+  EXPECT_EQ(0u, num_private);
+
+  // Pages written by this process are resident and mapped only by this process.
+  for (size_t i = 0; i != kNumTouchedPages; ++i) {
+    space->Begin()[i * page_size] = 1u;
+  }
+  ASSERT_TRUE(space->CountPrivatePages(&num_resident, &num_private));
+  EXPECT_EQ(kNumTouchedPages, num_resident);
+  EXPECT_EQ(kNumTouchedPages, num_private);
+
+  // In a forked child, the pages are shared with the parent until the child writes to them.
+  // Report failures through the exit status, the child must not run gtest assertions.
+  pid_t pid = fork();
+  ASSERT_NE(-1, pid) << strerror(errno);
+  if (pid == 0) {
+    size_t child_resident = 0u;
+    size_t child_private = 0u;
+    if (!space->CountPrivatePages(&child_resident, &child_private) ||
+        child_resident != kNumTouchedPages ||
+        child_private != 0u) {
+      _exit(1);
+    }
+    space->Begin()[0] = 2u;
+    if (!space->CountPrivatePages(&child_resident, &child_private) ||
+        child_resident != kNumTouchedPages ||
+        child_private != 1u) {
+      _exit(2);
+    }
+    _exit(0);
+  }
+  int status = 0;
+  ASSERT_EQ(pid, TEMP_FAILURE_RETRY(waitpid(pid, &status, 0))) << strerror(errno);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(0, WEXITSTATUS(status));
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
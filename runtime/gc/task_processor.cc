@@ -143,6 +143,11 @@ void TaskProcessor::Start(Thread* self) {
   running_thread_ = self;
 }
 
+Thread* TaskProcessor::GetRunningThread() {
+  MutexLock mu(Thread::Current(), lock_);
+  return running_thread_;
+}
+
 void TaskProcessor::RunAllTasks(Thread* self) {
   while (true) {
     // Wait and get a task, may be interrupted.
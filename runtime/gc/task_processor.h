@@ -69,6 +69,8 @@ class TaskProcessor {
   // If wait is true, and no thread has been registered via Start(), we briefly
   // wait for one to be registered. If we time out, we return true.
   bool IsRunningThread(Thread* t, bool wait = false) REQUIRES(!lock_);
+  // Returns the thread registered via Start(), or null if none.
+  Thread* GetRunningThread() REQUIRES(!lock_);
 
  private:
   // Wait briefly for running_thread_ to become non-null. Return false on timeout.
@@ -20,6 +20,7 @@
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
+#include "base/bit_utils.h"
 #include "base/dumpable.h"
 #include "base/file_utils.h"
 #include "class_root-inl.h"
@@ -671,6 +672,70 @@ template bool ShouldDenyAccessToMemberImpl<ArtMethod>(ArtMethod* member,
                                                       AccessMethod access_method);
 }  // namespace detail
 
+// Members that application code was allowed to access, so that repeated reflective and JNI
+// lookups of the same hidden member skip decoding its dex flags and matching its signature
+// against the exemptions. The runtime flags of the member are not updated instead since that
+// would dirty boot image pages. Entries hold the member pointer in the low bits and the hidden
+// API generation they were decided in above them; colliding members simply replace each other.
+class AllowedAccessCache {
+ public:
+  static bool Contains(const void* member, uint32_t generation) {
+    uint64_t entry = MakeEntry(member, generation);
+    return entry != 0u && GetSlot(member).load(std::memory_order_relaxed) == entry;
+  }
+
+  static void Add(const void* member, uint32_t generation) {
+    uint64_t entry = MakeEntry(member, generation);
+    if (entry != 0u) {
+      GetSlot(member).store(entry, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  static constexpr size_t kNumEntries = 1024u;
+  static constexpr size_t kPointerBits = (sizeof(void*) == 8u) ? 48u : 32u;
+
+  // Returns 0 for members that cannot be cached.
+  static uint64_t MakeEntry(const void* member, uint32_t generation) {
+    uint64_t address = reinterpret_cast<uintptr_t>(member);
+    if ((address >> kPointerBits) != 0u) {
+      return 0u;
+    }
+    return address | (static_cast<uint64_t>(generation) << kPointerBits);
+  }
+
+  static std::atomic<uint64_t>& GetSlot(const void* member) {
+    static_assert(IsPowerOfTwo(kNumEntries));
+    return entries_[(reinterpret_cast<uintptr_t>(member) >> 4) & (kNumEntries - 1u)];
+  }
+
+  static std::atomic<uint64_t> entries_[kNumEntries];
+};
+
+std::atomic<uint64_t> AllowedAccessCache::entries_[AllowedAccessCache::kNumEntries];
+
+// Returns whether an access with `access_method` would have no side effects if allowed, so that
+// a cached decision can be used. Otherwise the access is reported again on the slow path.
+static bool CanUseCachedDecision(Runtime* runtime, AccessMethod access_method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (kLogAllAccesses || runtime->IsAotCompiler() || runtime->IsJavaDebuggable()) {
+    return false;
+  }
+  if (access_method == AccessMethod::kNone) {
+    return true;
+  }
+  if (kIsTargetBuild && !kIsTargetLinux && runtime->GetHiddenApiEventLogSampleRate() != 0u) {
+    return false;
+  }
+  if (access_method == AccessMethod::kReflection || access_method == AccessMethod::kJNI) {
+    // A StrictMode listener wants to hear about every access.
+    ArtField* consumer_field = WellKnownClasses::dalvik_system_VMRuntime_nonSdkApiUsageConsumer;
+    ObjPtr<mirror::Class> consumer_class = consumer_field->GetDeclaringClass();
+    return consumer_class->IsInitialized() && consumer_field->GetObject(consumer_class) == nullptr;
+  }
+  return true;
+}
+
 template <typename T>
 bool ShouldDenyAccessToMember(T* member,
                               const std::function<AccessContext()>& fn_get_access_context,
@@ -734,6 +799,14 @@ bool ShouldDenyAccessToMember(T* member,
       // If this is a proxy method, look at the interface method instead.
       member = detail::GetInterfaceMemberIfProxy(member);
 
+      // Read the generation before deciding, so that a decision racing with a
+      // change of the settings is not used under the new settings.
+      bool use_cache = CanUseCachedDecision(runtime, access_method);
+      uint32_t generation = runtime->GetHiddenApiGeneration();
+      if (use_cache && AllowedAccessCache::Contains(member, generation)) {
+        return false;
+      }
+
       // Decode hidden API access flags from the dex file.
       // This is an O(N) operation scaling with the number of fields/methods
       // in the class. Only do this on slow path and only do it once.
@@ -741,7 +814,11 @@ bool ShouldDenyAccessToMember(T* member,
       DCHECK(api_list.IsValid());
 
       // Member is hidden and caller is not exempted. Enter slow path.
-      return detail::ShouldDenyAccessToMemberImpl(member, api_list, access_method);
+      bool deny_access = detail::ShouldDenyAccessToMemberImpl(member, api_list, access_method);
+      if (!deny_access && use_cache) {
+        AllowedAccessCache::Add(member, generation);
+      }
+      return deny_access;
     }
 
     case Domain::kPlatform: {
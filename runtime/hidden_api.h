@@ -290,6 +290,11 @@ ALWAYS_INLINE inline uint32_t GetRuntimeFlags(ArtMethod* method)
       case Intrinsics::kSystemArrayCopyChar:
       case Intrinsics::kSystemArrayCopyByte:
       case Intrinsics::kSystemArrayCopyInt:
+      case Intrinsics::kSystemArrayCopyBoolean:
+      case Intrinsics::kSystemArrayCopyShort:
+      case Intrinsics::kSystemArrayCopyLong:
+      case Intrinsics::kSystemArrayCopyFloat:
+      case Intrinsics::kSystemArrayCopyDouble:
       case Intrinsics::kStringGetCharsNoCheck:
       case Intrinsics::kReferenceGetReferent:
       case Intrinsics::kReferenceRefersTo:
@@ -298,6 +303,8 @@ ALWAYS_INLINE inline uint32_t GetRuntimeFlags(ArtMethod* method)
       case Intrinsics::kCRC32Update:
       case Intrinsics::kCRC32UpdateBytes:
       case Intrinsics::kCRC32UpdateByteBuffer:
+      case Intrinsics::kCRC32CUpdateBytes:
+      case Intrinsics::kCRC32CUpdateDirectByteBuffer:
       case Intrinsics::kStringNewStringFromBytes:
       case Intrinsics::kStringNewStringFromChars:
       case Intrinsics::kStringNewStringFromString:
@@ -395,6 +395,34 @@ TEST_F(HiddenApiTest, CheckTestApiEnforcement) {
       ShouldDenyAccess(hiddenapi::ApiList::TestApi() | hiddenapi::ApiList::Blocked()), false);
 }
 
+TEST_F(HiddenApiTest, CheckGenerationChangesWithSettings) {
+  // Cached access decisions are only valid as long as the generation does not change.
+  uint32_t generation = runtime_->GetHiddenApiGeneration();
+  runtime_->SetHiddenApiEnforcementPolicy(hiddenapi::EnforcementPolicy::kEnabled);
+  ASSERT_NE(generation, runtime_->GetHiddenApiGeneration());
+
+  generation = runtime_->GetHiddenApiGeneration();
+  runtime_->SetTestApiEnforcementPolicy(hiddenapi::EnforcementPolicy::kEnabled);
+  ASSERT_NE(generation, runtime_->GetHiddenApiGeneration());
+
+  generation = runtime_->GetHiddenApiGeneration();
+  runtime_->SetTargetSdkVersion(
+      static_cast<uint32_t>(hiddenapi::ApiList::MaxTargetR().GetMaxAllowedSdkVersion()) + 1);
+  ASSERT_NE(generation, runtime_->GetHiddenApiGeneration());
+
+  generation = runtime_->GetHiddenApiGeneration();
+  runtime_->SetHiddenApiExemptions({"Ljava/lang/Object;"});
+  ASSERT_NE(generation, runtime_->GetHiddenApiGeneration());
+
+  generation = runtime_->GetHiddenApiGeneration();
+  SetChangeIdState(kHideMaxtargetsdkQHiddenApis, false);
+  ASSERT_NE(generation, runtime_->GetHiddenApiGeneration());
+
+  generation = runtime_->GetHiddenApiGeneration();
+  runtime_->SetHiddenApiEventLogSampleRate(0u);
+  ASSERT_EQ(generation, runtime_->GetHiddenApiGeneration());
+}
+
 TEST_F(HiddenApiTest, CheckMembersRead) {
   ASSERT_NE(nullptr, class1_field1_);
   ASSERT_NE(nullptr, class1_field12_);
@@ -32,11 +32,14 @@
 #include <sys/uio.h>
 #include <time.h>
 #include <unistd.h>
+#include <zlib.h>
 
+#include <memory>
 #include <set>
 
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
+#include <android-base/strings.h>
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
@@ -383,13 +386,43 @@ class EndianOutputBuffered : public EndianOutput {
   std::vector<uint8_t> buffer_;
 };
 
+// Writes the output to a file, or to any other stream such as a socket, optionally as gzip data.
+// Compressed data is streamed through a fixed size buffer, so that a dump never needs more memory
+// than its largest record. The compression uses gzip rather than zstd, which libart also links,
+// because heap analysis tools and `gunzip` read gzip dumps directly.
 class FileEndianOutput final : public EndianOutputBuffered {
  public:
-  FileEndianOutput(File* fp, size_t reserved_size)
-      : EndianOutputBuffered(reserved_size), fp_(fp), errors_(false) {
+  FileEndianOutput(File* fp, size_t reserved_size, bool compress)
+      : EndianOutputBuffered(reserved_size), fp_(fp), errors_(false), compress_(compress) {
     DCHECK(fp != nullptr);
+    if (compress_) {
+      compressed_.reset(new uint8_t[kCompressedBufferSize]);
+      zstream_.zalloc = Z_NULL;
+      zstream_.zfree = Z_NULL;
+      zstream_.opaque = Z_NULL;
+      // Add 16 to the window bits for a gzip header. Favor speed since the world is stopped.
+      errors_ = deflateInit2(&zstream_,
+                             Z_BEST_SPEED,
+                             Z_DEFLATED,
+                             /*windowBits=*/ MAX_WBITS + 16,
+                             /*memLevel=*/ 8,
+                             Z_DEFAULT_STRATEGY) != Z_OK;
+      if (errors_) {
+        compress_ = false;
+      }
+    }
   }
   ~FileEndianOutput() {
+    if (compress_) {
+      deflateEnd(&zstream_);
+    }
+  }
+
+  // Write out any data still held by the compressor. Must be called after the last record.
+  void Finish() {
+    if (compress_) {
+      Deflate(nullptr, 0u, Z_FINISH);
+    }
   }
 
   bool Errors() {
@@ -398,14 +431,44 @@ class FileEndianOutput final : public EndianOutputBuffered {
 
  protected:
   void HandleFlush(const uint8_t* buffer, size_t length) override {
-    if (!errors_) {
+    if (compress_) {
+      Deflate(buffer, length, Z_NO_FLUSH);
+    } else if (!errors_) {
       errors_ = !fp_->WriteFully(buffer, length);
     }
   }
 
  private:
+  void Deflate(const uint8_t* buffer, size_t length, int flush) {
+    if (errors_) {
+      return;
+    }
+    zstream_.next_in = const_cast<Bytef*>(buffer);
+    zstream_.avail_in = length;
+    // Run until the compressor leaves room in the output buffer, meaning it has consumed all the
+    // input, and for `Z_FINISH`, written the end of the stream.
+    do {
+      zstream_.next_out = compressed_.get();
+      zstream_.avail_out = kCompressedBufferSize;
+      if (deflate(&zstream_, flush) == Z_STREAM_ERROR) {
+        errors_ = true;
+        return;
+      }
+      size_t compressed_length = kCompressedBufferSize - zstream_.avail_out;
+      if (compressed_length != 0u && !fp_->WriteFully(compressed_.get(), compressed_length)) {
+        errors_ = true;
+        return;
+      }
+    } while (zstream_.avail_out == 0u);
+  }
+
+  static constexpr size_t kCompressedBufferSize = 64 * KB;
+
   File* fp_;
   bool errors_;
+  bool compress_;
+  z_stream zstream_;
+  std::unique_ptr<uint8_t[]> compressed_;
 };
 
 class VectorEndianOuputput final : public EndianOutputBuffered {
@@ -773,9 +836,12 @@ class Hprof : public SingleRootVisitor {
     std::unique_ptr<File> file(new File(out_fd, filename_, true));
     bool okay;
     {
-      FileEndianOutput file_output(file.get(), max_length);
+      // Compress the output if the dump is named like a gzip file.
+      FileEndianOutput file_output(
+          file.get(), max_length, android::base::EndsWith(filename_, ".gz"));
       output_ = &file_output;
       ProcessHeap(true);
+      file_output.Finish();
       okay = !file_output.Errors();
 
       if (okay) {
@@ -878,6 +944,8 @@ class Hprof : public SingleRootVisitor {
 
   HprofHeapId current_heap_ = HPROF_HEAP_DEFAULT;  // Which heap we're currently dumping.
   size_t objects_in_segment_ = 0;
+  // The continuous space of the last object dumped, if any.
+  const gc::space::ContinuousSpace* last_space_ = nullptr;
 
   size_t total_objects_ = 0u;
   size_t total_objects_with_stack_trace_ = 0u;
@@ -1104,13 +1172,19 @@ void Hprof::DumpHeapObject(mirror::Object* obj) {
   };
 
   RootCollector visitor;
-  // Collect all native roots.
-  if (!obj->IsClass()) {
+  // Collect all native roots. Besides classes, which are handled separately, only dex caches and
+  // class loaders have native roots, so avoid walking the fields of all other objects.
+  if (obj->IsDexCache() || obj->IsClassLoader()) {
     obj->VisitReferences(visitor, VoidFunctor());
   }
 
   gc::Heap* const heap = Runtime::Current()->GetHeap();
-  const gc::space::ContinuousSpace* const space = heap->FindContinuousSpaceFromObject(obj, true);
+  // The heap is walked one space at a time, so the previous object's space is a good guess.
+  const gc::space::ContinuousSpace* space = last_space_;
+  if (space == nullptr || !space->HasAddress(obj)) {
+    space = heap->FindContinuousSpaceFromObject(obj, true);
+    last_space_ = space;
+  }
   HprofHeapId heap_type = HPROF_HEAP_APP;
   if (space != nullptr) {
     if (space->IsZygoteSpace()) {
@@ -1593,6 +1667,7 @@ void Hprof::VisitRoot(mirror::Object* obj, const RootInfo& info) {
 // sent directly to DDMS.
 // If "fd" is >= 0, the output will be written to that file descriptor.
 // Otherwise, "filename" is used to create an output file.
+// If "filename" ends with ".gz", the output is gzip compressed as it is written.
 void DumpHeap(const char* filename, int fd, bool direct_to_ddms) {
   CHECK(filename != nullptr);
   Thread* self = Thread::Current();
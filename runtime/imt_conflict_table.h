@@ -19,6 +19,7 @@
 
 #include <cstddef>
 
+#include "base/bit_utils.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/macros.h"
@@ -32,6 +33,16 @@ class ArtMethod;
 // The table contains a list of pairs of { interface_method, implementation_method }
 // with the last entry being null to make an assembly implementation of a lookup
 // faster.
+//
+// Tables created by the class linker with at least `kMinHashedEntries` pairs use a hashed layout
+// instead, as the linear lookup is slow for classes implementing many interfaces. The first
+// entry of a hashed table is { null, hash_mask }, so that the linear lookup stops at it, and
+// it is followed by the buckets. The lookup of `interface_method` starts at the bucket
+// `(interface_method & hash_mask) / pointer_size` and goes on until it finds the method or an
+// empty bucket. Probing does not wrap around, there are enough buckets past the last hashed
+// one to guarantee that it always ends on an empty bucket.
+//
+// Tables in images always use the linear layout, as the hash depends on the method addresses.
 class ImtConflictTable {
   enum MethodIndex {
     kMethodInterface,
@@ -40,6 +51,9 @@ class ImtConflictTable {
   };
 
  public:
+  // Minimum number of entries of a table with the hashed layout.
+  static constexpr size_t kMinHashedEntries = 16;
+
   // Build a new table copying `other` and adding the new entry formed of
   // the pair { `interface_method`, `implementation_method` }
   ImtConflictTable(ImtConflictTable* other,
@@ -47,6 +61,15 @@ class ImtConflictTable {
                    ArtMethod* implementation_method,
                    PointerSize pointer_size) {
     const size_t count = other->NumEntries(pointer_size);
+    if (UseHashedLayout(count + 1u)) {
+      InitHashed(count + 1u, pointer_size);
+      other->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods) {
+        AddHashedEntry(methods.first, methods.second, pointer_size);
+        return methods;
+      }, pointer_size);
+      AddHashedEntry(interface_method, implementation_method, pointer_size);
+      return;
+    }
     for (size_t i = 0; i < count; ++i) {
       SetInterfaceMethod(i, pointer_size, other->GetInterfaceMethod(i, pointer_size));
       SetImplementationMethod(i, pointer_size, other->GetImplementationMethod(i, pointer_size));
@@ -58,13 +81,40 @@ class ImtConflictTable {
     SetImplementationMethod(count + 1, pointer_size, nullptr);
   }
 
-  // num_entries excludes the header.
+  // Build an empty table with the linear layout, to be filled with `num_entries` entries
+  // through the index-based setters. num_entries excludes the header.
   ImtConflictTable(size_t num_entries, PointerSize pointer_size) {
     SetInterfaceMethod(num_entries, pointer_size, nullptr);
     SetImplementationMethod(num_entries, pointer_size, nullptr);
   }
 
-  // Set an entry at an index.
+  // Build an empty table to be filled with `num_entries` entries through `AddEntry()`, with the
+  // hashed layout if there are enough entries. The memory of the table, of the size returned by
+  // `ComputeSizeForNewTable()`, must be zero-initialized.
+  ImtConflictTable(size_t num_entries, PointerSize pointer_size, bool allow_hashed_layout) {
+    if (allow_hashed_layout && UseHashedLayout(num_entries)) {
+      InitHashed(num_entries, pointer_size);
+    } else {
+      SetInterfaceMethod(num_entries, pointer_size, nullptr);
+      SetImplementationMethod(num_entries, pointer_size, nullptr);
+    }
+  }
+
+  // Add the pair { `interface_method`, `implementation_method` } to a table being filled.
+  void AddEntry(ArtMethod* interface_method,
+                ArtMethod* implementation_method,
+                PointerSize pointer_size) {
+    if (IsHashed(pointer_size)) {
+      AddHashedEntry(interface_method, implementation_method, pointer_size);
+      return;
+    }
+    const size_t index = NumEntries(pointer_size);
+    SetInterfaceMethod(index, pointer_size, interface_method);
+    SetImplementationMethod(index, pointer_size, implementation_method);
+  }
+
+  // Set an entry at an index. The index-based accessors are only meaningful for tables with
+  // the linear layout, use `Visit()` to iterate over the entries of any table.
   void SetInterfaceMethod(size_t index, PointerSize pointer_size, ArtMethod* method) {
     SetMethod(index * kMethodCount + kMethodInterface, pointer_size, method);
   }
@@ -91,8 +141,14 @@ class ImtConflictTable {
 
   // Return true if two conflict tables are the same.
   bool Equals(ImtConflictTable* other, PointerSize pointer_size) const {
-    size_t num = NumEntries(pointer_size);
-    if (num != other->NumEntries(pointer_size)) {
+    bool hashed = IsHashed(pointer_size);
+    if (hashed != other->IsHashed(pointer_size)) {
+      return false;
+    }
+    // Compare all the buckets of hashed tables, including the header with the hash mask.
+    size_t num = hashed ? 1u + NumBuckets(pointer_size) : NumEntries(pointer_size);
+    if (hashed ? (GetHashMask(pointer_size) != other->GetHashMask(pointer_size))
+               : (num != other->NumEntries(pointer_size))) {
       return false;
     }
     for (size_t i = 0; i < num; ++i) {
@@ -110,6 +166,24 @@ class ImtConflictTable {
   // and also returns one. The order is <interface, implementation>.
   template<typename Visitor>
   void Visit(const Visitor& visitor, PointerSize pointer_size) NO_THREAD_SAFETY_ANALYSIS {
+    if (IsHashed(pointer_size)) {
+      for (size_t i = 1u, end = 1u + NumBuckets(pointer_size); i != end; ++i) {
+        ArtMethod* interface_method = GetInterfaceMethod(i, pointer_size);
+        if (interface_method == nullptr) {
+          continue;
+        }
+        ArtMethod* implementation_method = GetImplementationMethod(i, pointer_size);
+        auto input = std::make_pair(interface_method, implementation_method);
+        std::pair<ArtMethod*, ArtMethod*> updated = visitor(input);
+        // The bucket depends on the address of the interface method, hashed tables
+        // are never relocated.
+        DCHECK_EQ(input.first, updated.first);
+        if (input.second != updated.second) {
+          SetImplementationMethod(i, pointer_size, updated.second);
+        }
+      }
+      return;
+    }
     uint32_t table_index = 0;
     for (;;) {
       ArtMethod* interface_method = GetInterfaceMethod(table_index, pointer_size);
@@ -133,6 +207,10 @@ class ImtConflictTable {
   // if not found.
   ArtMethod* Lookup(ArtMethod* interface_method, PointerSize pointer_size) const {
     uint32_t table_index = 0;
+    if (IsHashed(pointer_size)) {
+      // Skip the header, the probing below is the same as the linear lookup.
+      table_index = 1u + GetBucketIndex(interface_method, pointer_size);
+    }
     for (;;) {
       ArtMethod* current_interface_method = GetInterfaceMethod(table_index, pointer_size);
       if (current_interface_method == nullptr) {
@@ -148,6 +226,15 @@ class ImtConflictTable {
 
   // Compute the number of entries in this table.
   size_t NumEntries(PointerSize pointer_size) const {
+    if (IsHashed(pointer_size)) {
+      size_t count = 0u;
+      for (size_t i = 1u, end = 1u + NumBuckets(pointer_size); i != end; ++i) {
+        if (GetInterfaceMethod(i, pointer_size) != nullptr) {
+          ++count;
+        }
+      }
+      return count;
+    }
     uint32_t table_index = 0;
     while (GetInterfaceMethod(table_index, pointer_size) != nullptr) {
       ++table_index;
@@ -157,6 +244,9 @@ class ImtConflictTable {
 
   // Compute the size in bytes taken by this table.
   size_t ComputeSize(PointerSize pointer_size) const {
+    if (IsHashed(pointer_size)) {
+      return (1u + NumBuckets(pointer_size)) * EntrySize(pointer_size);  // Add the header.
+    }
     // Add the end marker.
     return ComputeSize(NumEntries(pointer_size), pointer_size);
   }
@@ -164,10 +254,19 @@ class ImtConflictTable {
   // Compute the size in bytes needed for copying the given `table` and add
   // one more entry.
   static size_t ComputeSizeWithOneMoreEntry(ImtConflictTable* table, PointerSize pointer_size) {
-    return table->ComputeSize(pointer_size) + EntrySize(pointer_size);
+    return ComputeSizeForNewTable(table->NumEntries(pointer_size) + 1u, pointer_size);
+  }
+
+  // Compute the size in bytes of a table with `num_entries` entries built with the hashed layout
+  // allowed, see the constructor taking `allow_hashed_layout`.
+  static size_t ComputeSizeForNewTable(size_t num_entries, PointerSize pointer_size) {
+    if (UseHashedLayout(num_entries)) {
+      return (1u + NumBuckets(GetCapacity(num_entries))) * EntrySize(pointer_size);
+    }
+    return ComputeSize(num_entries, pointer_size);
   }
 
-  // Compute size with a fixed number of entries.
+  // Compute size with a fixed number of entries, for the linear layout.
   static size_t ComputeSize(size_t num_entries, PointerSize pointer_size) {
     return (num_entries + 1) * EntrySize(pointer_size);  // Add one for null terminator.
   }
@@ -177,6 +276,70 @@ class ImtConflictTable {
   }
 
  private:
+  static bool UseHashedLayout(size_t num_entries) {
+    return num_entries >= kMinHashedEntries;
+  }
+
+  // Number of hashed buckets for `num_entries`, keeping the load factor at or below one half.
+  static size_t GetCapacity(size_t num_entries) {
+    return RoundUpToPowerOfTwo(2u * num_entries);
+  }
+
+  // Number of buckets of a hashed table. The probing for one of the at most `capacity / 2`
+  // entries ends at most `capacity / 2` buckets past the last hashed bucket.
+  static size_t NumBuckets(size_t capacity) {
+    return capacity + capacity / 2u;
+  }
+
+  bool IsHashed(PointerSize pointer_size) const {
+    return GetInterfaceMethod(0u, pointer_size) == nullptr &&
+           GetImplementationMethod(0u, pointer_size) != nullptr;
+  }
+
+  uintptr_t GetHashMask(PointerSize pointer_size) const {
+    DCHECK(IsHashed(pointer_size));
+    return reinterpret_cast<uintptr_t>(GetImplementationMethod(0u, pointer_size));
+  }
+
+  size_t NumBuckets(PointerSize pointer_size) const {
+    size_t pointer_shift = WhichPowerOf2(static_cast<size_t>(pointer_size));
+    return NumBuckets((GetHashMask(pointer_size) >> pointer_shift) + 1u);
+  }
+
+  size_t GetBucketIndex(ArtMethod* interface_method, PointerSize pointer_size) const {
+    size_t pointer_shift = WhichPowerOf2(static_cast<size_t>(pointer_size));
+    return (reinterpret_cast<uintptr_t>(interface_method) & GetHashMask(pointer_size)) >>
+           pointer_shift;
+  }
+
+  void InitHashed(size_t num_entries, PointerSize pointer_size) {
+    size_t capacity = GetCapacity(num_entries);
+    for (size_t i = 0u, end = 1u + NumBuckets(capacity); i != end; ++i) {
+      SetInterfaceMethod(i, pointer_size, nullptr);
+      SetImplementationMethod(i, pointer_size, nullptr);
+    }
+    // The mask selects the bucket index bits of the method address, without the low bits
+    // that are zero for all methods.
+    size_t pointer_shift = WhichPowerOf2(static_cast<size_t>(pointer_size));
+    uintptr_t hash_mask = (capacity - 1u) << pointer_shift;
+    SetImplementationMethod(0u, pointer_size, reinterpret_cast<ArtMethod*>(hash_mask));
+  }
+
+  void AddHashedEntry(ArtMethod* interface_method,
+                      ArtMethod* implementation_method,
+                      PointerSize pointer_size) {
+    DCHECK(interface_method != nullptr);
+    size_t index = 1u + GetBucketIndex(interface_method, pointer_size);
+    while (GetInterfaceMethod(index, pointer_size) != nullptr) {
+      DCHECK_NE(GetInterfaceMethod(index, pointer_size), interface_method);
+      ++index;
+    }
+    // Keep an empty bucket at the end, for the probing of methods not in the table.
+    DCHECK_LT(index, NumBuckets(pointer_size));
+    SetInterfaceMethod(index, pointer_size, interface_method);
+    SetImplementationMethod(index, pointer_size, implementation_method);
+  }
+
   void** AddressOfMethod(size_t index, PointerSize pointer_size) {
     if (pointer_size == PointerSize::k64) {
       return reinterpret_cast<void**>(&data64_[index]);
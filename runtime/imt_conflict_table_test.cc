@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "imt_conflict_table.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+
+class ImtConflictTableTest : public testing::Test {
+ protected:
+  static constexpr size_t kMaxEntries = 40u;
+  // The tables only compare the method pointers, use a stride similar to `ArtMethod` arrays.
+  static constexpr size_t kMethodStride = 5u;
+
+  ArtMethod* GetInterfaceMethod(size_t i) {
+    return reinterpret_cast<ArtMethod*>(&methods_[i * kMethodStride]);
+  }
+
+  ArtMethod* GetImplementationMethod(size_t i) {
+    return reinterpret_cast<ArtMethod*>(&methods_[(kMaxEntries + i) * kMethodStride]);
+  }
+
+  // Add the entries one at a time, the way conflict tables grow at runtime.
+  ImtConflictTable* BuildTable(size_t num_entries) {
+    ImtConflictTable* table = Allocate(ImtConflictTable::ComputeSize(0u, kRuntimePointerSize));
+    new (table) ImtConflictTable(/*num_entries=*/0u, kRuntimePointerSize);
+    for (size_t i = 0; i != num_entries; ++i) {
+      size_t size = ImtConflictTable::ComputeSizeWithOneMoreEntry(table, kRuntimePointerSize);
+      ImtConflictTable* new_table = Allocate(size);
+      new (new_table) ImtConflictTable(
+          table, GetInterfaceMethod(i), GetImplementationMethod(i), kRuntimePointerSize);
+      EXPECT_EQ(size, new_table->ComputeSize(kRuntimePointerSize));
+      table = new_table;
+    }
+    return table;
+  }
+
+  // Create the table with its final size and fill it, the way the class linker does.
+  ImtConflictTable* CreateTable(size_t num_entries) {
+    size_t size = ImtConflictTable::ComputeSizeForNewTable(num_entries, kRuntimePointerSize);
+    ImtConflictTable* table = Allocate(size);
+    new (table) ImtConflictTable(num_entries, kRuntimePointerSize, /*allow_hashed_layout=*/ true);
+    for (size_t i = 0; i != num_entries; ++i) {
+      table->AddEntry(GetInterfaceMethod(i), GetImplementationMethod(i), kRuntimePointerSize);
+    }
+    EXPECT_EQ(size, table->ComputeSize(kRuntimePointerSize));
+    return table;
+  }
+
+ private:
+  ImtConflictTable* Allocate(size_t size) {
+    storage_.push_back(std::make_unique<uint64_t[]>(RoundUp(size, sizeof(uint64_t)) / 8u));
+    return reinterpret_cast<ImtConflictTable*>(storage_.back().get());
+  }
+
+  uint64_t methods_[2u * kMaxEntries * kMethodStride] = {};
+  std::vector<std::unique_ptr<uint64_t[]>> storage_;
+};
+
+TEST_F(ImtConflictTableTest, Lookup) {
+  for (size_t num_entries : {0u, 1u, 15u, 16u, 17u, 33u, 40u}) {
+    ImtConflictTable* table = BuildTable(num_entries);
+    EXPECT_EQ(num_entries, table->NumEntries(kRuntimePointerSize));
+    for (size_t i = 0; i != kMaxEntries; ++i) {
+      ArtMethod* expected = (i < num_entries) ? GetImplementationMethod(i) : nullptr;
+      EXPECT_EQ(expected, table->Lookup(GetInterfaceMethod(i), kRuntimePointerSize))
+          << num_entries << " " << i;
+    }
+    EXPECT_TRUE(table->Equals(BuildTable(num_entries), kRuntimePointerSize));
+
+    size_t num_visited = 0u;
+    table->Visit([&](const std::pair<ArtMethod*, ArtMethod*>& methods) {
+      EXPECT_EQ(methods.second, table->Lookup(methods.first, kRuntimePointerSize));
+      ++num_visited;
+      return methods;
+    }, kRuntimePointerSize);
+    EXPECT_EQ(num_entries, num_visited);
+  }
+}
+
+TEST_F(ImtConflictTableTest, CreateAndFill) {
+  for (size_t num_entries : {0u, 1u, 15u, 16u, 17u, 33u, 40u}) {
+    ImtConflictTable* table = CreateTable(num_entries);
+    EXPECT_EQ(num_entries, table->NumEntries(kRuntimePointerSize));
+    for (size_t i = 0; i != kMaxEntries; ++i) {
+      ArtMethod* expected = (i < num_entries) ? GetImplementationMethod(i) : nullptr;
+      EXPECT_EQ(expected, table->Lookup(GetInterfaceMethod(i), kRuntimePointerSize))
+          << num_entries << " " << i;
+    }
+    // Large tables get the same layout as tables grown one entry at a time.
+    EXPECT_EQ(BuildTable(num_entries)->ComputeSize(kRuntimePointerSize),
+              table->ComputeSize(kRuntimePointerSize));
+  }
+}
+
+}  // namespace art
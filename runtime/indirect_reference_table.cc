@@ -79,15 +79,20 @@ static inline MemMap NewIRTMap(size_t table_bytes, std::string* error_msg) {
   return result;
 }
 
-IndirectReferenceTable::IndirectReferenceTable(IndirectRefKind kind)
+IndirectReferenceTable::IndirectReferenceTable(IndirectRefKind kind,
+                                               uint32_t shard,
+                                               size_t shard_bits)
     : table_mem_map_(),
       table_(nullptr),
       kind_(kind),
+      shard_(shard),
+      shard_bits_(shard_bits),
       top_index_(0u),
       max_entries_(0u),
       current_num_holes_(0) {
   CHECK_NE(kind, kJniTransition);
   CHECK_NE(kind, kLocal);
+  CHECK_LT(shard, 1u << shard_bits);
 }
 
 bool IndirectReferenceTable::Initialize(size_t max_count, std::string* error_msg) {
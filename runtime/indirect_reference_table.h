@@ -149,7 +149,12 @@ static_assert(IsPowerOfTwo(sizeof(IrtEntry)), "Unexpected sizeof(IrtEntry)");
 class IndirectReferenceTable {
  public:
   // Constructs an uninitialized indirect reference table. Use `Initialize()` to initialize it.
-  explicit IndirectReferenceTable(IndirectRefKind kind);
+  //
+  // A table can be one of `1 << shard_bits` shards of a larger table. The `shard` is then
+  // encoded in the low bits of the index of its references, see `GetShard()`.
+  explicit IndirectReferenceTable(IndirectRefKind kind,
+                                  uint32_t shard = 0u,
+                                  size_t shard_bits = 0u);
 
   // Initialize the indirect reference table.
   //
@@ -228,6 +233,12 @@ class IndirectReferenceTable {
     return mask;
   }
 
+  // Returns the shard of the table that `iref` belongs to, for tables split in
+  // `1 << shard_bits` shards.
+  ALWAYS_INLINE static uint32_t GetShard(IndirectRef iref, size_t shard_bits) {
+    return DecodeIndex(reinterpret_cast<uintptr_t>(iref)) & ((1u << shard_bits) - 1u);
+  }
+
   static bool IsGlobalOrWeakGlobalReference(IndirectRef iref) {
     return (reinterpret_cast<uintptr_t>(iref) & GetGlobalOrWeakGlobalMask()) != 0u;
   }
@@ -287,14 +298,17 @@ class IndirectReferenceTable {
 
   constexpr uintptr_t EncodeIndirectRef(uint32_t table_index, uint32_t serial) const {
     DCHECK_LT(table_index, max_entries_);
-    return EncodeIndex(table_index) | EncodeSerial(serial) | EncodeIndirectRefKind(kind_);
+    return EncodeIndex((table_index << shard_bits_) | shard_) |
+           EncodeSerial(serial) |
+           EncodeIndirectRefKind(kind_);
   }
 
   static void ConstexprChecks();
 
   // Extract the table index from an indirect reference.
-  ALWAYS_INLINE static uint32_t ExtractIndex(IndirectRef iref) {
-    return DecodeIndex(reinterpret_cast<uintptr_t>(iref));
+  ALWAYS_INLINE uint32_t ExtractIndex(IndirectRef iref) const {
+    DCHECK_EQ(GetShard(iref, shard_bits_), shard_);
+    return DecodeIndex(reinterpret_cast<uintptr_t>(iref)) >> shard_bits_;
   }
 
   IndirectRef ToIndirectRef(uint32_t table_index) const {
@@ -317,6 +331,10 @@ class IndirectReferenceTable {
   // Bit mask, ORed into all irefs.
   const IndirectRefKind kind_;
 
+  // Shard of a larger table encoded in the low `shard_bits_` bits of the index of all irefs.
+  const uint32_t shard_;
+  const size_t shard_bits_;
+
   // The "top of stack" index where new references are added.
   size_t top_index_;
 
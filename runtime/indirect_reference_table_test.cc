@@ -265,4 +265,40 @@ TEST_F(IndirectReferenceTableTest, BasicTest) {
   CheckDump(&irt, 0, 0);
 }
 
+TEST_F(IndirectReferenceTableTest, Shards) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 20;
+  static const size_t kShardBits = 2;
+  IndirectReferenceTable irt1(kGlobal, /*shard=*/ 1u, kShardBits);
+  IndirectReferenceTable irt3(kGlobal, /*shard=*/ 3u, kShardBits);
+  std::string error_msg;
+  ASSERT_TRUE(irt1.Initialize(kTableMax, &error_msg)) << error_msg;
+  ASSERT_TRUE(irt3.Initialize(kTableMax, &error_msg)) << error_msg;
+
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> c =
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+
+  // References of both shards at the same index differ by their shard.
+  IndirectRef iref1 = irt1.Add(obj0.Get(), &error_msg);
+  IndirectRef iref3 = irt3.Add(obj0.Get(), &error_msg);
+  ASSERT_TRUE(iref1 != nullptr);
+  ASSERT_TRUE(iref3 != nullptr);
+  EXPECT_NE(iref1, iref3);
+  EXPECT_EQ(kGlobal, IndirectReferenceTable::GetIndirectRefKind(iref1));
+  EXPECT_EQ(1u, IndirectReferenceTable::GetShard(iref1, kShardBits));
+  EXPECT_EQ(3u, IndirectReferenceTable::GetShard(iref3, kShardBits));
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt1.Get(iref1));
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt3.Get(iref3));
+  EXPECT_TRUE(irt1.IsValidReference(iref1, &error_msg)) << error_msg;
+
+  EXPECT_TRUE(irt1.Remove(iref1));
+  EXPECT_TRUE(irt3.Remove(iref3));
+  EXPECT_EQ(0u, irt1.Capacity());
+  EXPECT_EQ(0u, irt3.Capacity());
+}
+
 }  // namespace art
@@ -42,6 +42,7 @@
 #include "jit/jit_code_cache.h"
 #include "jvalue-inl.h"
 #include "jvalue.h"
+#include "linear_alloc.h"
 #include "mirror/class-inl.h"
 #include "mirror/dex_cache.h"
 #include "mirror/object-inl.h"
@@ -121,6 +122,8 @@ Instrumentation::Instrumentation()
       have_watched_frame_pop_listeners_(false),
       have_branch_listeners_(false),
       have_exception_handled_listeners_(false),
+      entry_exit_hooks_lock_("entry / exit hooks for methods lock", kGenericBottomLock),
+      has_methods_with_entry_exit_hooks_(false),
       quick_alloc_entry_points_instrumentation_counter_(0),
       alloc_entrypoints_instrumented_(false) {}
 
@@ -362,7 +365,10 @@ void Instrumentation::InitializeMethodsCode(ArtMethod* method, const void* aot_c
   }
 
   // Use instrumentation entrypoints if instrumentation is installed.
-  if (UNLIKELY(EntryExitStubsInstalled() || IsForcedInterpretOnly() || IsDeoptimized(method))) {
+  if (UNLIKELY(EntryExitStubsInstalled() ||
+               IsForcedInterpretOnly() ||
+               IsDeoptimized(method) ||
+               HasEntryExitHooksForMethod(method))) {
     UpdateEntryPoints(
         method, method->IsNative() ? GetQuickGenericJniStub() : GetQuickToInterpreterBridge());
     return;
@@ -429,7 +435,7 @@ void Instrumentation::InstallStubsForMethod(ArtMethod* method) {
     return;
   }
 
-  if (EntryExitStubsInstalled()) {
+  if (EntryExitStubsInstalled() || HasEntryExitHooksForMethod(method)) {
     // Install interpreter bridge / GenericJni stub if the existing code doesn't support
     // entry / exit hooks.
     if (!CodeSupportsEntryExitHooks(method->GetEntryPointFromQuickCompiledCode(), method)) {
@@ -1181,6 +1187,11 @@ void Instrumentation::UpdateMethodsCodeImpl(ArtMethod* method, const void* new_c
   if (!EntryExitStubsInstalled()) {
     // Fast path: no instrumentation.
     DCHECK(!IsDeoptimized(method));
+    if (UNLIKELY(HasEntryExitHooksForMethod(method)) &&
+        !CodeSupportsEntryExitHooks(new_code, method)) {
+      // Keep the code with entry / exit hooks selected for this method.
+      return;
+    }
     UpdateEntryPoints(method, new_code);
     return;
   }
@@ -1215,7 +1226,8 @@ void Instrumentation::UpdateNativeMethodsCodeToJitCode(ArtMethod* method, const
   // We don't do any read barrier on `method`'s declaring class in this code, as the JIT might
   // enter here on a soon-to-be deleted ArtMethod. Updating the entrypoint is OK though, as
   // the ArtMethod is still in memory.
-  if (EntryExitStubsInstalled() && !CodeSupportsEntryExitHooks(new_code, method)) {
+  if ((EntryExitStubsInstalled() || HasEntryExitHooksForMethod(method)) &&
+      !CodeSupportsEntryExitHooks(new_code, method)) {
     // If the new code doesn't support entry exit hooks but we need them don't update with the new
     // code.
     return;
@@ -1251,6 +1263,79 @@ bool Instrumentation::RemoveDeoptimizedMethod(ArtMethod* method) {
   return true;
 }
 
+void Instrumentation::EnableEntryExitHooksForMethod(ArtMethod* method) {
+  CHECK(!method->IsProxyMethod());
+  CHECK(!method->IsObsolete());
+  CHECK(!method->IsIntrinsic());
+  CHECK(method->IsInvokable());
+
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  {
+    MutexLock mu(self, entry_exit_hooks_lock_);
+    bool inserted = methods_with_entry_exit_hooks_.insert(method).second;
+    CHECK(inserted) << "Method " << ArtMethod::PrettyMethod(method)
+        << " already has entry / exit hooks";
+    has_methods_with_entry_exit_hooks_.store(true, std::memory_order_relaxed);
+  }
+  // Only this method needs to change its code, there is no need to instrument thread stacks.
+  if (!CodeSupportsEntryExitHooks(method->GetEntryPointFromQuickCompiledCode(), method)) {
+    UpdateEntryPoints(
+        method, method->IsNative() ? GetQuickGenericJniStub() : GetQuickToInterpreterBridge());
+  }
+  // Callers that inlined the method would not call the hooks. The JIT does not inline the
+  // selected methods, so this only needs to be done once.
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr) {
+    jit->GetCodeCache()->InvalidateCompiledCodeThatInlined(method);
+  }
+}
+
+void Instrumentation::DisableEntryExitHooksForMethod(ArtMethod* method) {
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  {
+    MutexLock mu(self, entry_exit_hooks_lock_);
+    bool found_and_erased = methods_with_entry_exit_hooks_.erase(method) != 0u;
+    CHECK(found_and_erased) << "Method " << ArtMethod::PrettyMethod(method)
+        << " does not have entry / exit hooks";
+    has_methods_with_entry_exit_hooks_.store(
+        !methods_with_entry_exit_hooks_.empty(), std::memory_order_relaxed);
+  }
+
+  // Keep the current code if it is still needed for other reasons.
+  if (EntryExitStubsInstalled() || InterpretOnly(method) || method->IsObsolete()) {
+    return;
+  }
+  if (method->StillNeedsClinitCheck()) {
+    UpdateEntryPoints(method, GetQuickResolutionStub());
+  } else {
+    UpdateEntryPoints(method, GetOptimizedCodeFor(method));
+  }
+}
+
+bool Instrumentation::HasEntryExitHooksForMethodSlow(ArtMethod* method) const {
+  MutexLock mu(Thread::Current(), entry_exit_hooks_lock_);
+  return methods_with_entry_exit_hooks_.find(method) != methods_with_entry_exit_hooks_.end();
+}
+
+void Instrumentation::RemoveEntryExitHooksForMethodsIn(const LinearAlloc& allocator) {
+  if (!has_methods_with_entry_exit_hooks_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  MutexLock mu(Thread::Current(), entry_exit_hooks_lock_);
+  for (auto it = methods_with_entry_exit_hooks_.begin();
+       it != methods_with_entry_exit_hooks_.end(); ) {
+    if (allocator.ContainsUnsafe(*it)) {
+      it = methods_with_entry_exit_hooks_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  has_methods_with_entry_exit_hooks_.store(
+      !methods_with_entry_exit_hooks_.empty(), std::memory_order_relaxed);
+}
+
 void Instrumentation::Deoptimize(ArtMethod* method) {
   CHECK(!method->IsNative());
   CHECK(!method->IsProxyMethod());
@@ -1433,7 +1518,8 @@ const void* Instrumentation::GetMaybeInstrumentedCodeForInvoke(ArtMethod* method
   // This is called by resolution trampolines and that should never be getting proxy methods.
   DCHECK(!method->IsProxyMethod()) << method->PrettyMethod();
   const void* code = GetCodeForInvoke(method);
-  if (EntryExitStubsInstalled() && !CodeSupportsEntryExitHooks(code, method)) {
+  if ((EntryExitStubsInstalled() || HasEntryExitHooksForMethod(method)) &&
+      !CodeSupportsEntryExitHooks(code, method)) {
     return method->IsNative() ? GetQuickGenericJniStub() : GetQuickToInterpreterBridge();
   }
   return code;
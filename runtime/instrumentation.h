@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <list>
 #include <memory>
@@ -30,6 +31,7 @@
 #include "base/enums.h"
 #include "base/locks.h"
 #include "base/macros.h"
+#include "base/mutex.h"
 #include "base/safe_map.h"
 #include "gc_root.h"
 #include "jvalue.h"
@@ -44,6 +46,7 @@ class Throwable;
 class ArtField;
 class ArtMethod;
 template <typename T> class Handle;
+class LinearAlloc;
 template <typename T> class MutableHandle;
 struct NthCallerVisitor;
 union JValue;
@@ -291,6 +294,34 @@ class Instrumentation {
   // Indicates whether the method has been deoptimized so it is executed with the interpreter.
   EXPORT bool IsDeoptimized(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Run `method` with code that calls the method entry / exit hooks, without changing the
+  // instrumentation level. Other methods keep their optimized code, so listeners are only
+  // guaranteed to see entry / exit events of the selected methods. This is much cheaper than
+  // `EnableEntryExitHooks()` for observing a few methods.
+  //
+  // The JIT compiles `method` with the hooks and no longer inlines it. JIT code that already
+  // inlined `method` is invalidated, so the caller must suspend the JIT (see `ScopedJitSuspend`)
+  // to make sure no such code is committed afterwards. AOT code that inlined `method` is not
+  // updated, and frames of `method` that are already on the stack do not report their exit.
+  // Intrinsics cannot be selected.
+  EXPORT void EnableEntryExitHooksForMethod(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_, !entry_exit_hooks_lock_);
+
+  // Undo the effect of `EnableEntryExitHooksForMethod()`.
+  EXPORT void DisableEntryExitHooksForMethod(ArtMethod* method)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_, !entry_exit_hooks_lock_);
+
+  // Indicates whether `method` was selected with `EnableEntryExitHooksForMethod()`.
+  bool HasEntryExitHooksForMethod(ArtMethod* method) const
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!entry_exit_hooks_lock_) {
+    return UNLIKELY(has_methods_with_entry_exit_hooks_.load(std::memory_order_relaxed)) &&
+           HasEntryExitHooksForMethodSlow(method);
+  }
+
+  // Forget the selected methods allocated in `allocator`, which is about to be freed.
+  void RemoveEntryExitHooksForMethodsIn(const LinearAlloc& allocator)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!entry_exit_hooks_lock_);
+
   // Indicates if any method needs to be deoptimized. This is used to avoid walking the stack to
   // determine if a deoptimization is required.
   bool IsDeoptimizedMethodsEmpty() const REQUIRES_SHARED(Locks::mutator_lock_);
@@ -663,6 +694,8 @@ class Instrumentation {
   bool AddDeoptimizedMethod(ArtMethod* method) REQUIRES(Locks::mutator_lock_);
   bool IsDeoptimizedMethod(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
   bool RemoveDeoptimizedMethod(ArtMethod* method) REQUIRES(Locks::mutator_lock_);
+  bool HasEntryExitHooksForMethodSlow(ArtMethod* method) const
+      REQUIRES(!entry_exit_hooks_lock_);
   void UpdateMethodsCodeImpl(ArtMethod* method, const void* new_code)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -763,6 +796,13 @@ class Instrumentation {
   // only.
   std::unordered_set<ArtMethod*> deoptimized_methods_ GUARDED_BY(Locks::mutator_lock_);
 
+  // The methods selected to run with entry / exit hooks regardless of the instrumentation level.
+  // Methods are only added and removed with the mutator lock held exclusively, but the set is
+  // also swept when class loaders are unloaded concurrently with other mutators.
+  mutable Mutex entry_exit_hooks_lock_;
+  std::unordered_set<ArtMethod*> methods_with_entry_exit_hooks_ GUARDED_BY(entry_exit_hooks_lock_);
+  std::atomic<bool> has_methods_with_entry_exit_hooks_;
+
   // Current interpreter handler table. This is updated each time the thread state flags are
   // modified.
 
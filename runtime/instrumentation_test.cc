@@ -640,6 +640,42 @@ TEST_F(InstrumentationTest, DeoptimizeDirectMethod) {
   EXPECT_FALSE(instr->IsDeoptimized(method_to_deoptimize));
 }
 
+TEST_F(InstrumentationTest, EntryExitHooksForMethod) {
+  ScopedObjectAccess soa(Thread::Current());
+  jobject class_loader = LoadDex("Instrumentation");
+  Runtime* const runtime = Runtime::Current();
+  instrumentation::Instrumentation* instr = runtime->GetInstrumentation();
+  ClassLinker* class_linker = runtime->GetClassLinker();
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> loader(hs.NewHandle(soa.Decode<mirror::ClassLoader>(class_loader)));
+  ObjPtr<mirror::Class> klass = class_linker->FindClass(soa.Self(), "LInstrumentation;", loader);
+  ASSERT_TRUE(klass != nullptr);
+  ArtMethod* method = klass->FindClassMethod("instanceMethod", "()V", kRuntimePointerSize);
+  ASSERT_TRUE(method != nullptr);
+  EXPECT_FALSE(instr->HasEntryExitHooksForMethod(method));
+
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+    ScopedSuspendAll ssa("Entry / exit hooks for a method");
+    instr->EnableEntryExitHooksForMethod(method);
+  }
+  EXPECT_TRUE(instr->HasEntryExitHooksForMethod(method));
+  // The method runs with the interpreter but the instrumentation level does not change.
+  EXPECT_TRUE(
+      class_linker->IsQuickToInterpreterBridge(method->GetEntryPointFromQuickCompiledCode()));
+  EXPECT_FALSE(instr->IsDeoptimized(method));
+  EXPECT_FALSE(instr->AreAllMethodsDeoptimized());
+  EXPECT_EQ(Instrumentation::InstrumentationLevel::kInstrumentNothing,
+            GetCurrentInstrumentationLevel());
+
+  {
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+    ScopedSuspendAll ssa("Entry / exit hooks for a method");
+    instr->DisableEntryExitHooksForMethod(method);
+  }
+  EXPECT_FALSE(instr->HasEntryExitHooksForMethod(method));
+}
+
 TEST_F(InstrumentationTest, FullDeoptimization) {
   ScopedObjectAccess soa(Thread::Current());
   Runtime* const runtime = Runtime::Current();
@@ -114,6 +114,7 @@ inline size_t InternTable::AddTableFromMemory(const uint8_t* ptr,
     visitor(set);
     if (!set.empty()) {
       strong_interns_.AddInternStrings(std::move(set), is_boot_image);
+      strong_interns_.PublishFrozenTables();
     }
   }
   return read_count;
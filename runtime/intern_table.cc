@@ -114,16 +114,29 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::St
   DCHECK(s != nullptr);
   // `String::GetHashCode()` ensures that the stored hash is calculated.
   uint32_t hash = static_cast<uint32_t>(s->GetHashCode());
+  size_t num_searched_frozen_tables;
+  ObjPtr<mirror::String> result =
+      strong_interns_.FindFrozen(s, hash, &num_searched_frozen_tables);
+  if (result != nullptr) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(s, hash);
+  return strong_interns_.Find(s, hash, num_searched_frozen_tables);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
                                                  uint32_t utf16_length,
                                                  const char* utf8_data) {
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
+  Utf8String string(utf16_length, utf8_data);
+  size_t num_searched_frozen_tables;
+  ObjPtr<mirror::String> result =
+      strong_interns_.FindFrozen(string, hash, &num_searched_frozen_tables);
+  if (result != nullptr) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+  return strong_interns_.Find(string, hash, num_searched_frozen_tables);
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
@@ -144,6 +157,7 @@ void InternTable::AddNewTable() {
   MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
   weak_interns_.AddNewTable();
   strong_interns_.AddNewTable();
+  strong_interns_.PublishFrozenTables();
 }
 
 ObjPtr<mirror::String> InternTable::InsertStrong(ObjPtr<mirror::String> s, uint32_t hash) {
@@ -206,6 +220,13 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   DCHECK_EQ(hash, static_cast<uint32_t>(s->GetStoredHashCode()));
   DCHECK_IMPLIES(hash == 0u, s->ComputeHashCode() == 0);
   Thread* const self = Thread::Current();
+  if (num_searched_strong_frozen_tables == 0u) {
+    ObjPtr<mirror::String> strong =
+        strong_interns_.FindFrozen(s, hash, &num_searched_strong_frozen_tables);
+    if (strong != nullptr) {
+      return strong;
+    }
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking) {
     Locks::mutator_lock_->AssertSharedHeld(self);
@@ -253,14 +274,21 @@ ObjPtr<mirror::String> InternTable::InternStrong(uint32_t utf16_length, const ch
   DCHECK(utf8_data != nullptr);
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
   Thread* self = Thread::Current();
-  ObjPtr<mirror::String> s;
+  Utf8String string(utf16_length, utf8_data);
   size_t num_searched_strong_frozen_tables;
+  // Try to avoid allocation and the lock. Most strings resolved by dex caches are
+  // already interned in the boot image or app image tables, which are frozen.
+  ObjPtr<mirror::String> s =
+      strong_interns_.FindFrozen(string, hash, &num_searched_strong_frozen_tables);
+  if (s != nullptr) {
+    return s;
+  }
   {
-    // Try to avoid allocation. If we need to allocate, release the mutex before the allocation.
+    // If we need to allocate, release the mutex before the allocation.
     MutexLock mu(self, *Locks::intern_table_lock_);
+    s = strong_interns_.Find(string, hash, num_searched_strong_frozen_tables);
     DCHECK(!strong_interns_.tables_.empty());
     num_searched_strong_frozen_tables = strong_interns_.tables_.size() - 1u;
-    s = strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
   }
   if (s != nullptr) {
     return s;
@@ -320,7 +348,8 @@ void InternTable::SweepInternTableWeaks(IsMarkedVisitor* visitor) {
 
 void InternTable::Table::Remove(ObjPtr<mirror::String> s, uint32_t hash) {
   // Note: We can remove weak interns even from frozen tables when promoting to strong interns.
-  // We can remove strong interns only for a transaction rollback.
+  // We can remove strong interns only for a transaction rollback, which does not span the
+  // creation of a new table, so frozen strong tables seen by `FindFrozen()` stay unmodified.
   for (InternalTable& table : tables_) {
     auto it = table.set_.FindWithHash(GcRoot<mirror::String>(s), hash);
     if (it != table.set_.end()) {
@@ -352,11 +381,15 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
 }
 
 FLATTEN
-ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string, uint32_t hash) {
+ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string,
+                                                uint32_t hash,
+                                                size_t num_searched_frozen_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
+  DCHECK_LT(num_searched_frozen_tables, tables_.size());
+  auto mid = tables_.begin() + num_searched_frozen_tables;
   // Search from the last table, assuming that apps shall search for their own
   // strings more often than for boot image strings.
-  for (InternalTable& table : ReverseRange(tables_)) {
+  for (InternalTable& table : ReverseRange(MakeIterationRange(mid, tables_.end()))) {
     auto it = table.set_.FindWithHash(string, hash);
     if (it != table.set_.end()) {
       return it->Read();
@@ -365,6 +398,47 @@ ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string, uint32
   return nullptr;
 }
 
+template <typename Key>
+ObjPtr<mirror::String> InternTable::Table::FindFrozenImpl(
+    const Key& key, uint32_t hash, /*out*/ size_t* num_searched_frozen_tables) const {
+  const std::vector<UnorderedSet>* frozen_sets = frozen_sets_.load(std::memory_order_acquire);
+  if (frozen_sets == nullptr) {
+    *num_searched_frozen_tables = 0u;
+    return nullptr;
+  }
+  for (const UnorderedSet& set : ReverseRange(*frozen_sets)) {
+    auto it = set.FindWithHash(key, hash);
+    if (it != set.end()) {
+      return it->Read();
+    }
+  }
+  *num_searched_frozen_tables = frozen_sets->size();
+  return nullptr;
+}
+
+FLATTEN
+ObjPtr<mirror::String> InternTable::Table::FindFrozen(
+    ObjPtr<mirror::String> s, uint32_t hash, /*out*/ size_t* num_searched_frozen_tables) const {
+  return FindFrozenImpl(GcRoot<mirror::String>(s), hash, num_searched_frozen_tables);
+}
+
+FLATTEN
+ObjPtr<mirror::String> InternTable::Table::FindFrozen(
+    const Utf8String& string, uint32_t hash, /*out*/ size_t* num_searched_frozen_tables) const {
+  return FindFrozenImpl(string, hash, num_searched_frozen_tables);
+}
+
+void InternTable::Table::PublishFrozenTables() {
+  DCHECK(!tables_.empty());
+  auto frozen_sets = std::make_unique<std::vector<UnorderedSet>>();
+  frozen_sets->reserve(tables_.size() - 1u);
+  for (size_t i = 0; i != tables_.size() - 1u; ++i) {
+    frozen_sets->push_back(tables_[i].set_.View());
+  }
+  frozen_sets_.store(frozen_sets.get(), std::memory_order_release);
+  frozen_sets_storage_.push_back(std::move(frozen_sets));
+}
+
 void InternTable::Table::AddNewTable() {
   // Propagate the min/max load factor from the old active set.
   DCHECK(!tables_.empty());
@@ -436,7 +510,7 @@ void InternTable::ChangeWeakRootStateLocked(gc::WeakRootState new_state) {
   }
 }
 
-InternTable::Table::Table() {
+InternTable::Table::Table() : frozen_sets_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   InternalTable initial_table;
   initial_table.set_.SetLoadFactor(runtime->GetHashTableMinLoadFactor(),
@@ -17,6 +17,10 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "base/dchecked_vector.h"
 #include "base/gc_visited_arena_pool.h"
 #include "base/hash_set.h"
@@ -241,8 +245,24 @@ class InternTable {
                                 uint32_t hash,
                                 size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    ObjPtr<mirror::String> Find(const Utf8String& string, uint32_t hash)
+    ObjPtr<mirror::String> Find(const Utf8String& string,
+                                uint32_t hash,
+                                size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+    // Search the frozen tables published by `PublishFrozenTables()` without holding the
+    // lock. On return, `num_searched_frozen_tables` holds the number of searched tables,
+    // which are the first ones in `tables_`.
+    ObjPtr<mirror::String> FindFrozen(ObjPtr<mirror::String> s,
+                                      uint32_t hash,
+                                      /*out*/ size_t* num_searched_frozen_tables) const
+        REQUIRES_SHARED(Locks::mutator_lock_);
+    ObjPtr<mirror::String> FindFrozen(const Utf8String& string,
+                                      uint32_t hash,
+                                      /*out*/ size_t* num_searched_frozen_tables) const
+        REQUIRES_SHARED(Locks::mutator_lock_);
+    // Publish views of all the tables but the last one for `FindFrozen()`. Only valid
+    // for the strong interns, whose frozen tables are not modified.
+    void PublishFrozenTables() REQUIRES(Locks::intern_table_lock_);
     void Insert(ObjPtr<mirror::String> s, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     void Remove(ObjPtr<mirror::String> s, uint32_t hash)
@@ -263,6 +283,12 @@ class InternTable {
         REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
    private:
+    template <typename Key>
+    ObjPtr<mirror::String> FindFrozenImpl(const Key& key,
+                                          uint32_t hash,
+                                          /*out*/ size_t* num_searched_frozen_tables) const
+        REQUIRES_SHARED(Locks::mutator_lock_);
+
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
 
@@ -274,6 +300,13 @@ class InternTable {
     // modifying the zygote intern table. The back of table is modified when strings are interned.
     dchecked_vector<InternalTable> tables_;
 
+    // Views of the frozen tables searched by `FindFrozen()`. Frozen tables keep their
+    // position in `tables_` and their storage, so replaced views only need to stay alive
+    // for concurrent readers; this happens only when a table is added.
+    std::atomic<const std::vector<UnorderedSet>*> frozen_sets_;
+    std::vector<std::unique_ptr<const std::vector<UnorderedSet>>> frozen_sets_storage_
+        GUARDED_BY(Locks::intern_table_lock_);
+
     friend class InternTable;
     friend class linker::ImageWriter;
     ART_FRIEND_TEST(InternTableTest, CrossHash);
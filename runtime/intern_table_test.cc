@@ -263,4 +263,25 @@ TEST_F(InternTableTest, InternStrongFrozenWeak) {
   ASSERT_TRUE(strong_foo == foo.Get());
 }
 
+TEST_F(InternTableTest, LookupStrongFrozen) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable intern_table;
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::String> foo(hs.NewHandle(intern_table.InternStrong(3, "foo")));
+  ASSERT_TRUE(foo != nullptr);
+
+  intern_table.AddNewTable();
+
+  // "foo" is now found in the frozen table, "bar" in the active one.
+  Handle<mirror::String> bar(hs.NewHandle(intern_table.InternStrong(3, "bar")));
+  ASSERT_TRUE(bar != nullptr);
+  EXPECT_OBJ_PTR_EQ(foo.Get(), intern_table.InternStrong(3, "foo"));
+  EXPECT_OBJ_PTR_EQ(foo.Get(), intern_table.LookupStrong(soa.Self(), 3, "foo"));
+  EXPECT_OBJ_PTR_EQ(foo.Get(), intern_table.LookupStrong(soa.Self(), foo.Get()));
+  EXPECT_OBJ_PTR_EQ(bar.Get(), intern_table.InternStrong(3, "bar"));
+  EXPECT_OBJ_PTR_EQ(bar.Get(), intern_table.LookupStrong(soa.Self(), 3, "bar"));
+  EXPECT_TRUE(intern_table.LookupStrong(soa.Self(), 3, "baz") == nullptr);
+  EXPECT_EQ(2u, intern_table.StrongSize());
+}
+
 }  // namespace art
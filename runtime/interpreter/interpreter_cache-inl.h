@@ -19,17 +19,29 @@
 
 #include "interpreter_cache.h"
 
+#include <utility>
+
 #include "thread.h"
 
 namespace art HIDDEN {
 
 inline bool InterpreterCache::Get(Thread* self, const void* key, /* out */ size_t* value) {
   DCHECK(self->GetInterpreterCache() == this) << "Must be called from owning thread";
-  Entry& entry = data_[IndexOf(key)];
+  size_t index = IndexOf(key);
+  Entry& entry = data_[index];
   if (LIKELY(entry.first == key)) {
     *value = entry.second;
     return true;
   }
+  Entry& victim = victims_[VictimIndexOf(index)];
+  if (victim.first == key) {
+    // Move the entry back to the way probed by nterp.
+    ++victim_hits_;
+    std::swap(entry, victim);
+    *value = entry.second;
+    return true;
+  }
+  ++misses_;
   return false;
 }
 
@@ -37,7 +49,12 @@ inline void InterpreterCache::Set(Thread* self, const void* key, size_t value) {
   DCHECK(self->GetInterpreterCache() == this) << "Must be called from owning thread";
   // Simple store works here as the cache is always read/written by the owning
   // thread only (or in a stop-the-world pause).
-  data_[IndexOf(key)] = Entry{key, value};
+  size_t index = IndexOf(key);
+  Entry& entry = data_[index];
+  if (entry.first != nullptr && entry.first != key) {
+    victims_[VictimIndexOf(index)] = entry;
+  }
+  entry = Entry{key, value};
 }
 
 }  // namespace art
@@ -15,20 +15,43 @@
  */
 
 #include "interpreter_cache.h"
+
 #include "thread-inl.h"
 
 namespace art HIDDEN {
 
 void InterpreterCache::Clear(Thread* owning_thread) {
+  static_assert(OFFSETOF_MEMBER(InterpreterCache, victims_) == kVictimsOffset);
   DCHECK(owning_thread->GetInterpreterCache() == this);
   DCHECK(owning_thread == Thread::Current() || owning_thread->IsSuspended());
   // Avoid using std::fill (or its variant) as there could be a concurrent sweep
   // happening by the GC thread and these functions may clear partially.
-  for (Entry& entry : data_) {
-    std::atomic<const void*>* atomic_key_addr =
-        reinterpret_cast<std::atomic<const void*>*>(&entry.first);
-    atomic_key_addr->store(nullptr, std::memory_order_relaxed);
-  }
+  auto clear_way = [](auto& way) {
+    for (Entry& entry : way) {
+      std::atomic<const void*>* atomic_key_addr =
+          reinterpret_cast<std::atomic<const void*>*>(&entry.first);
+      atomic_key_addr->store(nullptr, std::memory_order_relaxed);
+    }
+  };
+  clear_way(data_);
+  clear_way(victims_);
+}
+
+void InterpreterCache::ClearRange(Thread* owning_thread, const void* begin, const void* end) {
+  DCHECK(owning_thread->GetInterpreterCache() == this);
+  DCHECK(owning_thread == Thread::Current() || owning_thread->IsSuspended());
+  auto clear_way_range = [begin, end](auto& way) {
+    for (Entry& entry : way) {
+      std::atomic<const void*>* atomic_key_addr =
+          reinterpret_cast<std::atomic<const void*>*>(&entry.first);
+      uintptr_t key = reinterpret_cast<uintptr_t>(atomic_key_addr->load(std::memory_order_relaxed));
+      if (key >= reinterpret_cast<uintptr_t>(begin) && key < reinterpret_cast<uintptr_t>(end)) {
+        atomic_key_addr->store(nullptr, std::memory_order_relaxed);
+      }
+    }
+  };
+  clear_way_range(data_);
+  clear_way_range(victims_);
 }
 
 }  // namespace art
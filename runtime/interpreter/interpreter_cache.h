@@ -39,8 +39,19 @@ class Thread;
 //   sget/sput: The ArtField* pointer. The field must be non-volitile.
 //   invoke: The ArtMethod* pointer (before vtable indirection, etc).
 //
-// We ensure consistency of the cache by clearing it
-// whenever any dex file is unloaded.
+// We ensure consistency of the cache by clearing the entries
+// of the instructions of any dex file that is unloaded.
+//
+// The cache has a second way that holds entries evicted from the first one.
+// The assembly fast paths of nterp only probe the first way, which is the array
+// at the start of the cache. An entry evicted from it moves to the second way,
+// which is probed by nterp's resolution slow paths and by the switch interpreter,
+// and a hit there moves the entry back to the first way. The second way only
+// needs to catch conflicts, so it is a quarter of the size of the first one and
+// its sets are shared by several sets of the first way. This keeps its cost at
+// 1 KiB per thread. The slow paths of field accesses in the arm64
+// nterp probe the second way in assembly before calling into the runtime; such
+// hits are neither counted nor moved.
 //
 // Aligned to 16-bytes to make it easier to get the address of the cache
 // from assembly (it ensures that the offset is valid immediate value).
@@ -53,23 +64,49 @@ class ALIGNED(16) InterpreterCache {
   // Value of 256 has around 75% cache hit rate.
   static constexpr size_t kSize = 256;
 
+  // Size of the second way.
+  static constexpr size_t kVictimsSize = kSize / 4;
+
+  // Offset of the second way from the start of the cache.
+  static constexpr size_t kVictimsOffset = kSize * sizeof(Entry);
+
   InterpreterCache() {
     // We can not use the Clear() method since the constructor will not
     // be called from the owning thread.
     data_.fill(Entry{});
+    victims_.fill(Entry{});
   }
 
   // Clear the whole cache. It requires the owning thread for DCHECKs.
   EXPORT void Clear(Thread* owning_thread);
 
+  // Clear the entries with keys in [begin, end). It requires the owning thread for DCHECKs.
+  EXPORT void ClearRange(Thread* owning_thread, const void* begin, const void* end);
+
   ALWAYS_INLINE bool Get(Thread* self, const void* key, /* out */ size_t* value);
 
   ALWAYS_INLINE void Set(Thread* self, const void* key, size_t value);
 
+  // The first way, probed by the nterp fast paths.
   std::array<Entry, kSize>& GetArray() {
     return data_;
   }
 
+  std::array<Entry, kVictimsSize>& GetVictimArray() {
+    return victims_;
+  }
+
+  // Number of lookups that missed the first way and hit the second way.
+  size_t GetVictimHits() const {
+    return victim_hits_;
+  }
+
+  // Number of lookups that missed both ways. Lookups done by the nterp fast paths
+  // are not counted.
+  size_t GetMisses() const {
+    return misses_;
+  }
+
  private:
   static ALWAYS_INLINE size_t IndexOf(const void* key) {
     static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
@@ -78,7 +115,15 @@ class ALIGNED(16) InterpreterCache {
     return index;
   }
 
+  static ALWAYS_INLINE size_t VictimIndexOf(size_t index) {
+    static_assert(IsPowerOfTwo(kVictimsSize), "Size must be power of two");
+    return index & (kVictimsSize - 1);
+  }
+
   std::array<Entry, kSize> data_;
+  std::array<Entry, kVictimsSize> victims_;
+  size_t victim_hits_ = 0u;
+  size_t misses_ = 0u;
 };
 
 }  // namespace art
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter_cache-inl.h"
+
+#include "common_runtime_test.h"
+#include "thread-current-inl.h"
+
+namespace art HIDDEN {
+
+class InterpreterCacheTest : public CommonRuntimeTest {};
+
+TEST_F(InterpreterCacheTest, SetAssociative) {
+  Thread* self = Thread::Current();
+  InterpreterCache* cache = self->GetInterpreterCache();
+  cache->Clear(self);
+  // Keys that are `kSize` entries apart map to the same set. Align the keys to the first set.
+  constexpr size_t kWayStride = 2u * InterpreterCache::kSize;
+  alignas(4u * InterpreterCache::kSize) static uint16_t code_units[3u * kWayStride];
+  const void* key0 = &code_units[0];
+  const void* key1 = &code_units[kWayStride];
+  const void* key2 = &code_units[2u * kWayStride];
+
+  cache->Set(self, key0, 10u);
+  cache->Set(self, key1, 11u);
+  EXPECT_EQ(key1, cache->GetArray()[0].first);
+
+  // The evicted entry is still found, and moves back to the first way.
+  size_t hits = cache->GetVictimHits();
+  size_t value = 0u;
+  EXPECT_TRUE(cache->Get(self, key0, &value));
+  EXPECT_EQ(10u, value);
+  EXPECT_EQ(hits + 1u, cache->GetVictimHits());
+  EXPECT_EQ(key0, cache->GetArray()[0].first);
+  EXPECT_TRUE(cache->Get(self, key1, &value));
+  EXPECT_EQ(11u, value);
+
+  // A third key evicts the least recently used one.
+  cache->Set(self, key2, 12u);
+  size_t misses = cache->GetMisses();
+  EXPECT_FALSE(cache->Get(self, key0, &value));
+  EXPECT_EQ(misses + 1u, cache->GetMisses());
+  EXPECT_TRUE(cache->Get(self, key1, &value));
+  EXPECT_EQ(11u, value);
+  EXPECT_TRUE(cache->Get(self, key2, &value));
+  EXPECT_EQ(12u, value);
+
+  cache->Clear(self);
+}
+
+TEST_F(InterpreterCacheTest, SharedVictimSets) {
+  Thread* self = Thread::Current();
+  InterpreterCache* cache = self->GetInterpreterCache();
+  cache->Clear(self);
+  // Sets of the first way that are `kVictimsSize` sets apart share a set of the second way.
+  constexpr size_t kSetStride = 2u * InterpreterCache::kVictimsSize;
+  constexpr size_t kWayStride = 2u * InterpreterCache::kSize;
+  alignas(4u * InterpreterCache::kSize) static uint16_t code_units[2u * kWayStride];
+  const void* key0 = &code_units[0];
+  const void* key1 = &code_units[kWayStride];
+  const void* other_key0 = &code_units[kSetStride];
+  const void* other_key1 = &code_units[kWayStride + kSetStride];
+
+  // Evict `key0` and then `other_key0` to the same set of the second way.
+  cache->Set(self, key0, 10u);
+  cache->Set(self, key1, 11u);
+  cache->Set(self, other_key0, 20u);
+  cache->Set(self, other_key1, 21u);
+  EXPECT_EQ(other_key0, cache->GetVictimArray()[0].first);
+
+  size_t value = 0u;
+  EXPECT_FALSE(cache->Get(self, key0, &value));
+  EXPECT_TRUE(cache->Get(self, other_key0, &value));
+  EXPECT_EQ(20u, value);
+  EXPECT_TRUE(cache->Get(self, key1, &value));
+  EXPECT_EQ(11u, value);
+
+  cache->Clear(self);
+}
+
+TEST_F(InterpreterCacheTest, ClearRange) {
+  Thread* self = Thread::Current();
+  InterpreterCache* cache = self->GetInterpreterCache();
+  cache->Clear(self);
+  static uint16_t code_units[2u * InterpreterCache::kSize];
+  const void* inside = &code_units[0];
+  const void* outside = &code_units[1];
+  cache->Set(self, inside, 1u);
+  cache->Set(self, outside, 2u);
+
+  cache->ClearRange(self, &code_units[0], &code_units[1]);
+  size_t value = 0u;
+  EXPECT_FALSE(cache->Get(self, inside, &value));
+  EXPECT_TRUE(cache->Get(self, outside, &value));
+  EXPECT_EQ(2u, value);
+
+  cache->Clear(self);
+}
+
+}  // namespace art
@@ -910,6 +910,12 @@ void UnstartedRuntime::UnstartedSystemArraycopy(Thread* self,
     PrimitiveArrayCopy<uint16_t>(self, src_array, src_pos, dst_array, dst_pos, length);
   } else if (src_type->IsPrimitiveInt()) {
     PrimitiveArrayCopy<int32_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveShort()) {
+    PrimitiveArrayCopy<int16_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveLong()) {
+    PrimitiveArrayCopy<int64_t>(self, src_array, src_pos, dst_array, dst_pos, length);
+  } else if (src_type->IsPrimitiveBoolean()) {
+    PrimitiveArrayCopy<uint8_t>(self, src_array, src_pos, dst_array, dst_pos, length);
   } else {
     AbortTransactionOrFail(self, "Unimplemented System.arraycopy for type '%s'",
                            src_type->PrettyDescriptor().c_str());
@@ -934,6 +940,24 @@ void UnstartedRuntime::UnstartedSystemArraycopyInt(
   UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
 }
 
+void UnstartedRuntime::UnstartedSystemArraycopyShort(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyLong(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
+void UnstartedRuntime::UnstartedSystemArraycopyBoolean(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  // Just forward.
+  UnstartedRuntime::UnstartedSystemArraycopy(self, shadow_frame, result, arg_offset);
+}
+
 void UnstartedRuntime::UnstartedSystemGetSecurityManager([[maybe_unused]] Thread* self,
                                                          [[maybe_unused]] ShadowFrame* shadow_frame,
                                                          JValue* result,
@@ -1930,6 +1954,16 @@ void UnstartedRuntime::UnstartedJNIMathExp([[maybe_unused]] Thread* self,
   result->SetD(exp(value.GetD()));
 }
 
+void UnstartedRuntime::UnstartedJNIMathSqrt([[maybe_unused]] Thread* self,
+                                            [[maybe_unused]] ArtMethod* method,
+                                            [[maybe_unused]] mirror::Object* receiver,
+                                            uint32_t* args,
+                                            JValue* result) {
+  JValue value;
+  value.SetJ((static_cast<uint64_t>(args[1]) << 32) | args[0]);
+  result->SetD(sqrt(value.GetD()));
+}
+
 void UnstartedRuntime::UnstartedJNIAtomicLongVMSupportsCS8(
     [[maybe_unused]] Thread* self,
     [[maybe_unused]] ArtMethod* method,
@@ -2006,6 +2040,28 @@ void UnstartedRuntime::UnstartedJNIStringCompareTo(Thread* self,
   result->SetI(receiver->AsString()->CompareTo(rhs->AsString()));
 }
 
+void UnstartedRuntime::UnstartedJNIStringConcat(Thread* self,
+                                                [[maybe_unused]] ArtMethod* method,
+                                                mirror::Object* receiver,
+                                                uint32_t* args,
+                                                JValue* result) {
+  StackHandleScope<2> hs(self);
+  Handle<mirror::String> h_this(hs.NewHandle(receiver->AsString()));
+  Handle<mirror::String> h_arg(
+      hs.NewHandle(reinterpret_cast32<mirror::String*>(args[0])));
+  if (h_arg == nullptr) {
+    AbortTransactionOrFail(self, "String.concat with null object.");
+    return;
+  }
+  if (h_this->GetLength() == 0) {
+    result->SetL(h_arg.Get());
+  } else if (h_arg->GetLength() == 0) {
+    result->SetL(h_this.Get());
+  } else {
+    result->SetL(mirror::String::DoConcat(self, h_this, h_arg));
+  }
+}
+
 void UnstartedRuntime::UnstartedJNIStringFillBytesLatin1(Thread* self,
                                                          [[maybe_unused]] ArtMethod* method,
                                                          mirror::Object* receiver,
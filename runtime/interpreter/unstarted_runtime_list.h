@@ -43,6 +43,9 @@
   V(SystemArraycopyByte, "Ljava/lang/System;", "arraycopy", "([BI[BII)V") \
   V(SystemArraycopyChar, "Ljava/lang/System;", "arraycopy", "([CI[CII)V") \
   V(SystemArraycopyInt, "Ljava/lang/System;", "arraycopy", "([II[III)V") \
+  V(SystemArraycopyShort, "Ljava/lang/System;", "arraycopy", "([SI[SII)V") \
+  V(SystemArraycopyLong, "Ljava/lang/System;", "arraycopy", "([JI[JII)V") \
+  V(SystemArraycopyBoolean, "Ljava/lang/System;", "arraycopy", "([ZI[ZII)V") \
   V(SystemGetSecurityManager, "Ljava/lang/System;", "getSecurityManager", "()Ljava/lang/SecurityManager;") \
   V(SystemGetProperty, "Ljava/lang/System;", "getProperty", "(Ljava/lang/String;)Ljava/lang/String;") \
   V(SystemGetPropertyWithDefault, "Ljava/lang/System;", "getProperty", "(Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;") \
@@ -98,6 +101,7 @@
   V(VMStackGetStackClass2, "Ldalvik/system/VMStack;", "getStackClass2", "()Ljava/lang/Class;") \
   V(MathLog, "Ljava/lang/Math;", "log", "(D)D") \
   V(MathExp, "Ljava/lang/Math;", "exp", "(D)D") \
+  V(MathSqrt, "Ljava/lang/Math;", "sqrt", "(D)D") \
   V(AtomicLongVMSupportsCS8, "Ljava/util/concurrent/atomic/AtomicLong;", "VMSupportsCS8", "()Z") \
   V(ClassGetNameNative, "Ljava/lang/Class;", "getNameNative", "()Ljava/lang/String;") \
   V(DoubleLongBitsToDouble, "Ljava/lang/Double;", "longBitsToDouble", "(J)D") \
@@ -106,6 +110,7 @@
   V(ObjectInternalClone, "Ljava/lang/Object;", "internalClone", "()Ljava/lang/Object;") \
   V(ObjectNotifyAll, "Ljava/lang/Object;", "notifyAll", "()V") \
   V(StringCompareTo, "Ljava/lang/String;", "compareTo", "(Ljava/lang/String;)I") \
+  V(StringConcat, "Ljava/lang/String;", "concat", "(Ljava/lang/String;)Ljava/lang/String;") \
   V(StringFillBytesLatin1, "Ljava/lang/String;", "fillBytesLatin1", "([BI)V") \
   V(StringFillBytesUTF16, "Ljava/lang/String;", "fillBytesUTF16", "([BI)V") \
   V(StringIntern, "Ljava/lang/String;", "intern", "()Ljava/lang/String;") \
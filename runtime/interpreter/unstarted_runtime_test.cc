@@ -391,6 +391,28 @@ TEST_F(UnstartedRuntimeTest, StringCharAt) {
   }
 }
 
+TEST_F(UnstartedRuntimeTest, StringConcat) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  StackHandleScope<3> hs(self);
+  Handle<mirror::String> lhs = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "abc"));
+  Handle<mirror::String> rhs = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "def"));
+  Handle<mirror::String> empty = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, ""));
+
+  JValue result;
+  uint32_t args[] = { reinterpret_cast32<uint32_t>(rhs.Get()) };
+  UnstartedJNIStringConcat(self, nullptr, lhs.Get(), args, &result);
+  ASSERT_FALSE(self->IsExceptionPending());
+  ASSERT_TRUE(result.GetL() != nullptr);
+  EXPECT_EQ("abcdef", result.GetL()->AsString()->ToModifiedUtf8());
+
+  // Concatenating with an empty string returns the other string.
+  args[0] = reinterpret_cast32<uint32_t>(empty.Get());
+  UnstartedJNIStringConcat(self, nullptr, lhs.Get(), args, &result);
+  EXPECT_EQ(lhs.Get(), result.GetL());
+}
+
 TEST_F(UnstartedRuntimeTest, StringInit) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
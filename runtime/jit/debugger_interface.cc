@@ -35,6 +35,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <map>
 
 //
 // Debug interface for native tools (gdb, lldb, libunwind, simpleperf).
@@ -217,6 +218,10 @@ static std::vector<const void*> g_removed_jit_functions GUARDED_BY(g_jit_debug_l
 // Number of small (single symbol) ELF files. Used to trigger repacking.
 static uint32_t g_jit_num_unpacked_entries = 0;
 
+// Methods whose ELF file has not been generated yet, sorted by code address.
+static std::map<const void*, JitDebugInfoGenerator> g_lazy_jit_functions
+    GUARDED_BY(g_jit_debug_lock);
+
 struct DexNativeInfo {
   static constexpr bool kCopySymfileData = false;  // Just reference DEX files.
   static JITDescriptor& Descriptor() { return __dex_debug_descriptor; }
@@ -616,9 +621,59 @@ void AddNativeDebugInfoForJit(const void* code_ptr,
   }
 }
 
+void AddLazyNativeDebugInfoForJit(const void* code_ptr, JitDebugInfoGenerator&& generator) {
+  MutexLock mu(Thread::Current(), g_jit_debug_lock);
+  DCHECK(code_ptr != nullptr);
+  if (kIsDebugBuild) {
+    DCHECK(g_dcheck_all_jit_functions.insert(code_ptr).second) << code_ptr << " already added";
+  }
+  g_lazy_jit_functions.emplace(code_ptr, std::move(generator));
+}
+
+static void MaterializeNativeDebugInfoForJitLocked()
+    REQUIRES(g_jit_debug_lock) REQUIRES_SHARED(Locks::jit_lock_) {
+  if (g_lazy_jit_functions.empty() || Runtime::Current()->GetJit() == nullptr) {
+    return;
+  }
+  uint64_t start_time = MicroTime();
+  size_t num_functions = g_lazy_jit_functions.size();
+  // As in `AddNativeDebugInfoForJit()`, the removed entries must go before anything is added.
+  if (!g_removed_jit_functions.empty()) {
+    RepackNativeDebugInfoForJitLocked();
+  }
+  for (auto& [code_ptr, generator] : g_lazy_jit_functions) {
+    std::vector<uint8_t> symfile = generator();
+    CreateJITCodeEntryInternal<JitNativeInfo>(ArrayRef<const uint8_t>(symfile),
+                                              /*addr=*/ code_ptr,
+                                              /*allow_packing=*/ true,
+                                              /*is_compressed=*/ false);
+    if (++g_jit_num_unpacked_entries >= kJitRepackFrequency) {
+      RepackEntries(/*compress_entries=*/ false, /*removed=*/ ArrayRef<const void*>());
+    }
+  }
+  g_lazy_jit_functions.clear();
+  // The materialized entries are not expected to change soon, so compress them right away.
+  RepackEntries(/*compress_entries=*/ true, /*removed=*/ ArrayRef<const void*>());
+  VLOG(jit) << "JIT mini-debug-info materialized for " << num_functions << " methods in "
+            << MicroTime() - start_time << "us";
+}
+
+void MaterializeNativeDebugInfoForJit() {
+  Thread* self = Thread::Current();
+  if (Runtime::Current()->GetJitCodeCache() == nullptr) {
+    return;
+  }
+  MutexLock mu(self, *Locks::jit_lock_);
+  MutexLock mu2(self, g_jit_debug_lock);
+  MaterializeNativeDebugInfoForJitLocked();
+}
+
 void RemoveNativeDebugInfoForJit(const void* code_ptr) {
   MutexLock mu(Thread::Current(), g_jit_debug_lock);
   g_dcheck_all_jit_functions.erase(code_ptr);
+  if (g_lazy_jit_functions.erase(code_ptr) != 0u) {
+    return;  // The ELF file was never generated, so there is nothing else to remove.
+  }
 
   // Method removal is very expensive since we need to decompress and read ELF files.
   // Collet methods to be removed and do the removal in bulk later.
@@ -666,6 +721,7 @@ Mutex* GetNativeDebugInfoLock() {
 
 void ForEachNativeDebugSymbol(std::function<void(const void*, size_t, const char*)> cb) {
   MutexLock mu(Thread::Current(), g_jit_debug_lock);
+  MaterializeNativeDebugInfoForJitLocked();
   using ElfRuntimeTypes = std::conditional<sizeof(void*) == 4, ElfTypes32, ElfTypes64>::type;
   const JITCodeEntry* end = __jit_debug_descriptor.zygote_head_entry_;
   for (const JITCodeEntry* it = __jit_debug_descriptor.head_; it != end; it = it->next_) {
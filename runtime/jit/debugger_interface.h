@@ -56,6 +56,18 @@ void AddNativeDebugInfoForJit(const void* code_ptr,
                               bool allow_packing)
     REQUIRES_SHARED(Locks::jit_lock_);  // Might need JIT code cache to allocate memory.
 
+// Generates the ELF file with the debug info of a single JIT compiled method.
+using JitDebugInfoGenerator = std::function<std::vector<uint8_t>()>;
+
+// Like `AddNativeDebugInfoForJit()`, but the ELF file will only be generated, and native tools
+// notified, when `MaterializeNativeDebugInfoForJit()` is called. The ELF file must allow packing.
+void AddLazyNativeDebugInfoForJit(const void* code_ptr, JitDebugInfoGenerator&& generator)
+    REQUIRES_SHARED(Locks::jit_lock_);
+
+// Generate the ELF files of all the methods added with `AddLazyNativeDebugInfoForJit()`,
+// so that native tools about to unwind or symbolize JIT code can find them.
+void MaterializeNativeDebugInfoForJit() REQUIRES(!Locks::jit_lock_);
+
 // Notify native tools (e.g. libunwind) that JIT code has been garbage collected.
 // The actual removal might be lazy. Removal of address that was not added is no-op.
 void RemoveNativeDebugInfoForJit(const void* code_ptr);
@@ -74,7 +86,9 @@ EXPORT Mutex* GetNativeDebugInfoLock();
 
 // Call given callback for every non-zygote symbol.
 // The callback parameters are (address, size, name).
-void ForEachNativeDebugSymbol(std::function<void(const void*, size_t, const char*)> cb);
+// Materializes lazy debug info first.
+void ForEachNativeDebugSymbol(std::function<void(const void*, size_t, const char*)> cb)
+    REQUIRES_SHARED(Locks::jit_lock_);  // Might need JIT code cache to allocate memory.
 
 }  // namespace art
 
@@ -19,18 +19,26 @@
 #include <dlfcn.h>
 #include <sys/resource.h>
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/memfd.h"
 #include "base/memory_tool.h"
+#include "base/os.h"
 #include "base/runtime_debug.h"
 #include "base/scoped_flock.h"
+#include "base/stl_util.h"
+#include "base/time_utils.h"
 #include "base/utils.h"
+#include "class_loader_utils.h"
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
+#include "debugger_interface.h"
+#include "dex/dex_file_loader.h"
 #include "dex/type_lookup_table.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
@@ -76,6 +84,10 @@ void Jit::DumpInfo(std::ostream& os) {
 
 void Jit::DumpForSigQuit(std::ostream& os) {
   DumpInfo(os);
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    code_cache_->DumpMethodCompilationStats(os);
+  }
   ProfileSaver::DumpInstanceInfo(os);
 }
 
@@ -92,7 +104,8 @@ Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
       lock_("JIT memory use lock"),
       zygote_mapping_methods_(),
       fd_methods_(-1),
-      fd_methods_size_(0) {}
+      fd_methods_size_(0),
+      last_hotness_decay_ns_(NanoTime()) {}
 
 std::unique_ptr<Jit> Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
   jit_compiler_ = jit_create();
@@ -225,7 +238,11 @@ bool Jit::CompileMethodInternal(ArtMethod* method,
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
             << " kind=" << compilation_kind;
+  uint64_t start_ns = NanoTime();
+  uint64_t start_cpu_ns = ThreadCpuNanoTime();
   bool success = jit_compiler_->CompileMethod(self, region, method_to_compile, compilation_kind);
+  code_cache_->AddCompilationTime(
+      method_to_compile, NanoTime() - start_ns, ThreadCpuNanoTime() - start_cpu_ns);
   code_cache_->DoneCompiling(method_to_compile, self);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
@@ -273,6 +290,88 @@ void Jit::DeleteThreadPool() {
   }
 }
 
+// Prefer the reference profile, which dexopt has already merged and checked
+// against the current dex files.
+static const std::string& SelectAppProfile(const std::string& profile_filename,
+                                           const std::string& ref_profile_filename) {
+  return (!ref_profile_filename.empty() && OS::FileExists(ref_profile_filename.c_str()))
+      ? ref_profile_filename
+      : profile_filename;
+}
+
+// Task run when the profile saver of an app starts, to act on the app profile
+// recorded by the previous runs of the app before the app gets there: compile
+// its methods, load its startup classes, or verify the classes of the app.
+class JitAppProfileTask final : public SelfDeletingTask {
+ public:
+  using Action = uint32_t (Jit::*)(Thread* self,
+                                   const std::vector<std::string>& code_paths,
+                                   const std::string& profile_file);
+
+  JitAppProfileTask(Action action,
+                    const std::vector<std::string>& code_paths,
+                    const std::string& profile_filename,
+                    const std::string& ref_profile_filename)
+      : action_(action),
+        code_paths_(code_paths),
+        profile_filename_(profile_filename),
+        ref_profile_filename_(ref_profile_filename) {}
+
+  void Run(Thread* self) override {
+    if (!self->CanLoadClasses()) {
+      return;
+    }
+    const std::string& profile_file = SelectAppProfile(profile_filename_, ref_profile_filename_);
+    (Runtime::Current()->GetJit()->*action_)(self, code_paths_, profile_file);
+  }
+
+ private:
+  const Action action_;
+  const std::vector<std::string> code_paths_;
+  const std::string profile_filename_;
+  const std::string ref_profile_filename_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitAppProfileTask);
+};
+
+// Task run periodically when hotness decay is enabled, to halve the distance
+// every method made towards the JIT thresholds. Methods that are only warm for
+// a short burst then drift back instead of eventually being compiled.
+class JitHotnessDecayTask final : public SelfDeletingTask {
+ public:
+  JitHotnessDecayTask() {}
+
+  void Run(Thread* self) override {
+    Runtime* runtime = Runtime::Current();
+    Jit* jit = runtime->GetJit();
+    uint16_t warmup_threshold = jit->WarmMethodThreshold();
+    {
+      ScopedObjectAccess soa(self);
+      auto visitor = [warmup_threshold](ObjPtr<mirror::Class> klass)
+          REQUIRES_SHARED(Locks::mutator_lock_) {
+        for (ArtMethod& method : klass->GetMethods(kRuntimePointerSize)) {
+          method.DecayCounter(warmup_threshold);
+        }
+        return true;
+      };
+      runtime->GetClassLinker()->VisitClasses(visitor);
+    }
+    jit->GetCodeCache()->DecayBaselineHotnessCounts(self);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(JitHotnessDecayTask);
+};
+
+// Returns whether JVMTI agents are or can be attached. Resolving classes on the
+// JIT threads reports ClassLoad and ClassPrepare events to them, for classes
+// that the app may never use.
+static bool MayHaveAgents(Runtime* runtime) {
+  return runtime->IsJavaDebuggable() ||
+         runtime->HasLoadedPlugins() ||
+         !runtime->GetAgents().empty();
+}
+
 void Jit::StartProfileSaver(const std::string& profile_filename,
                             const std::vector<std::string>& code_paths,
                             const std::string& ref_profile_filename) {
@@ -283,6 +382,44 @@ void Jit::StartProfileSaver(const std::string& profile_filename,
                         code_paths,
                         ref_profile_filename);
   }
+  Runtime* runtime = Runtime::Current();
+  if (options_->PrecompileAppProfile() &&
+      UseJitCompilation() &&
+      thread_pool_ != nullptr &&
+      !runtime->IsZygote() &&
+      !runtime->IsSystemServer() &&
+      !runtime->IsJavaDebuggable()) {
+    thread_pool_->AddTask(
+        Thread::Current(),
+        new JitAppProfileTask(&Jit::CompileMethodsFromAppProfile,
+                              code_paths,
+                              profile_filename,
+                              ref_profile_filename));
+  }
+  if (options_->PreloadStartupClasses() &&
+      thread_pool_ != nullptr &&
+      !runtime->IsZygote() &&
+      !runtime->IsSystemServer() &&
+      !MayHaveAgents(runtime)) {
+    thread_pool_->AddTask(
+        Thread::Current(),
+        new JitAppProfileTask(&Jit::PreloadStartupClassesFromAppProfile,
+                              code_paths,
+                              profile_filename,
+                              ref_profile_filename));
+  }
+  if (options_->VerifyClassesInBackground() &&
+      thread_pool_ != nullptr &&
+      !runtime->IsZygote() &&
+      !runtime->IsSystemServer() &&
+      !MayHaveAgents(runtime)) {
+    thread_pool_->AddTask(
+        Thread::Current(),
+        new JitAppProfileTask(&Jit::VerifyClassesInBackground,
+                              code_paths,
+                              profile_filename,
+                              ref_profile_filename));
+  }
 }
 
 void Jit::StopProfileSaver() {
@@ -651,6 +788,7 @@ class JitCompileTask final : public Task {
   enum class TaskKind {
     kCompile,
     kPreCompile,
+    kWarmup,
   };
 
   JitCompileTask(ArtMethod* method,
@@ -666,7 +804,8 @@ class JitCompileTask final : public Task {
       ScopedObjectAccess soa(self);
       switch (kind_) {
         case TaskKind::kCompile:
-        case TaskKind::kPreCompile: {
+        case TaskKind::kPreCompile:
+        case TaskKind::kWarmup: {
           Runtime::Current()->GetJit()->CompileMethodInternal(
               method_,
               self,
@@ -676,6 +815,15 @@ class JitCompileTask final : public Task {
         }
       }
     }
+    Jit* jit = Runtime::Current()->GetJit();
+    JitThreadPool* thread_pool = jit->GetThreadPool();
+    if (jit->LazyMiniDebugInfo() &&
+        thread_pool != nullptr &&
+        thread_pool->GetTaskCount(self) == 0) {
+      // Generate the pending debug info whenever the JIT becomes idle, so that native tools
+      // reading this process on their own, like profilers and debuggerd, see the new code.
+      MaterializeNativeDebugInfoForJit();
+    }
     ProfileSaver::NotifyJitActivity();
   }
 
@@ -695,6 +843,10 @@ class JitCompileTask final : public Task {
     return compilation_kind_;
   }
 
+  bool IsWarmup() const {
+    return kind_ == TaskKind::kWarmup;
+  }
+
  private:
   ArtMethod* const method_;
   const TaskKind kind_;
@@ -890,6 +1042,22 @@ class JitProfileTask final : public Task {
 
     Jit* jit = Runtime::Current()->GetJit();
 
+    if (Runtime::Current()->IsZygote()) {
+      // A shared library preloaded by the zygote. Compile its profile into the
+      // shared region, like the boot classpath, so that children don't need to
+      // JIT its methods again. Methods are added to the queue so that we can
+      // fork processes in-between compilations.
+      if (OS::FileExists(profile.c_str())) {
+        jit->CompileMethodsFromProfile(
+            self,
+            dex_files_,
+            profile,
+            loader,
+            /* add_to_queue= */ true);
+      }
+      return;
+    }
+
     jit->CompileMethodsFromBootProfile(
         self,
         dex_files_,
@@ -1056,11 +1224,15 @@ bool Jit::InZygoteUsingJit() {
   return runtime->IsZygote() && runtime->HasImageWithProfile() && runtime->UseJitCompilation();
 }
 
+size_t Jit::GetThreadPoolThreadCount() const {
+  return Runtime::Current()->IsZygote() ? 1u : options_->GetThreadPoolThreadCount();
+}
+
 void Jit::CreateThreadPool() {
   // There is a DCHECK in the 'AddSamples' method to ensure the tread pool
   // is not null when we instrument.
 
-  thread_pool_.reset(JitThreadPool::Create("Jit thread pool", 1));
+  thread_pool_.reset(JitThreadPool::Create("Jit thread pool", GetThreadPoolThreadCount()));
 
   Runtime* runtime = Runtime::Current();
   thread_pool_->SetPthreadPriority(
@@ -1168,6 +1340,12 @@ void Jit::RegisterDexFiles(const std::vector<std::unique_ptr<const DexFile>>& de
     return;
   }
   Runtime* runtime = Runtime::Current();
+  if (InZygoteUsingJit() && class_loader != nullptr && UseJitCompilation()) {
+    // Shared libraries loaded by the zygote are used by many of its children:
+    // compile them in the shared region as well.
+    thread_pool_->AddTask(Thread::Current(), new JitProfileTask(dex_files, class_loader));
+    return;
+  }
   // If the runtime is debuggable, don't bother precompiling methods.
   // If system server is being profiled, don't precompile as we are going to use
   // the JIT to count hotness. Note that --count-hotness-in-compiled-code is
@@ -1193,6 +1371,20 @@ void Jit::AddCompileTask(Thread* self,
   thread_pool_->AddTask(self, method, compilation_kind);
 }
 
+// Return whether `method` runs without compiled code, that is through the
+// interpreter or a generic stub.
+static bool HasNoCompiledCode(ClassLinker* class_linker, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  return class_linker->IsQuickToInterpreterBridge(entry_point) ||
+      class_linker->IsQuickGenericJniStub(entry_point) ||
+      class_linker->IsNterpEntryPoint(entry_point) ||
+      // We explicitly check for the resolution stub, and not the resolution trampoline.
+      // The trampoline is for methods backed by a .oat file that has a compiled version of
+      // the method.
+      (entry_point == GetQuickResolutionStub());
+}
+
 bool Jit::CompileMethodFromProfile(Thread* self,
                                    ClassLinker* class_linker,
                                    uint32_t method_idx,
@@ -1214,14 +1406,7 @@ bool Jit::CompileMethodFromProfile(Thread* self,
     return false;
   }
   CompilationKind compilation_kind = CompilationKind::kOptimized;
-  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
-  if (class_linker->IsQuickToInterpreterBridge(entry_point) ||
-      class_linker->IsQuickGenericJniStub(entry_point) ||
-      class_linker->IsNterpEntryPoint(entry_point) ||
-      // We explicitly check for the resolution stub, and not the resolution trampoline.
-      // The trampoline is for methods backed by a .oat file that has a compiled version of
-      // the method.
-      (entry_point == GetQuickResolutionStub())) {
+  if (HasNoCompiledCode(class_linker, method)) {
     VLOG(jit) << "JIT Zygote processing method " << ArtMethod::PrettyMethod(method)
               << " from profile";
     method->SetPreCompiled();
@@ -1241,6 +1426,29 @@ bool Jit::CompileMethodFromProfile(Thread* self,
   return false;
 }
 
+bool Jit::AddWarmupCompilation(Thread* self,
+                               ClassLinker* class_linker,
+                               uint32_t method_idx,
+                               Handle<mirror::DexCache> dex_cache,
+                               Handle<mirror::ClassLoader> class_loader,
+                               CompilationKind compilation_kind) {
+  ArtMethod* method = class_linker->ResolveMethodWithoutInvokeType(
+      method_idx, dex_cache, class_loader);
+  if (method == nullptr) {
+    self->ClearException();
+    return false;
+  }
+  if (!method->IsCompilable() || !method->IsInvokable() || method->IsPreCompiled()) {
+    return false;
+  }
+  // Methods which dex2oat already compiled don't need warming up.
+  if (!HasNoCompiledCode(class_linker, method)) {
+    return false;
+  }
+  thread_pool_->AddWarmupTask(self, method, compilation_kind);
+  return true;
+}
+
 uint32_t Jit::CompileMethodsFromBootProfile(
     Thread* self,
     const std::vector<const DexFile*>& dex_files,
@@ -1347,6 +1555,327 @@ uint32_t Jit::CompileMethodsFromProfile(
   return added_to_queue;
 }
 
+class ClassLoaderCollector : public ClassLoaderVisitor {
+ public:
+  explicit ClassLoaderCollector(VariableSizedHandleScope* handles) : handles_(handles) {}
+
+  void Visit(ObjPtr<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::classlinker_classes_lock_, Locks::mutator_lock_) override {
+    class_loaders.push_back(handles_->NewHandle(class_loader));
+  }
+
+  std::vector<Handle<mirror::ClassLoader>> class_loaders;
+
+ private:
+  VariableSizedHandleScope* const handles_;
+};
+
+// Load the app profile `profile_file`. Return false if there is none.
+static bool LoadAppProfile(const std::string& profile_file,
+                           /*out*/ ProfileCompilationInfo* profile_info) {
+  if (profile_file.empty()) {
+    return false;
+  }
+  unix_file::FdFile profile(profile_file, O_RDONLY, /* check_usage= */ false);
+  if (profile.Fd() == -1) {
+    PLOG(WARNING) << "No app profile: " << profile_file;
+    return false;
+  }
+  if (!profile_info->Load(profile.Fd())) {
+    LOG(WARNING) << "Could not load app profile: " << profile_file;
+    return false;
+  }
+  return true;
+}
+
+// A dex file of the app, with what the app profile records for it.
+struct AppDexFile {
+  Handle<mirror::ClassLoader> class_loader;
+  const DexFile* dex_file = nullptr;
+  // Whether the profile knows the dex file. This is false if the profile has
+  // recorded a different checksum for it.
+  bool in_profile = false;
+  // The classes of the profile, and the declaring classes of its startup methods.
+  std::set<dex::TypeIndex> class_types;
+  // The class definitions of `class_types`, in class definition order. The dex
+  // format puts the definition of a superclass or interface before the classes
+  // that extend it, so this order finds the supertypes of a class ready.
+  std::vector<uint16_t> class_def_indexes;
+  std::set<uint16_t> hot_methods;
+  std::set<uint16_t> startup_methods;
+  std::set<uint16_t> post_startup_methods;
+};
+
+// Collect the dex files of `code_paths` registered by the class loaders of the
+// app, with what `profile_info` records for them, if it is not null.
+static std::vector<AppDexFile> CollectAppDexFiles(Thread* self,
+                                                  VariableSizedHandleScope* handles,
+                                                  const std::vector<std::string>& code_paths,
+                                                  const ProfileCompilationInfo* profile_info)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  ClassLoaderCollector collector(handles);
+  {
+    ReaderMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    class_linker->VisitClassLoaders(&collector);
+  }
+
+  std::vector<AppDexFile> app_dex_files;
+  for (Handle<mirror::ClassLoader> class_loader : collector.class_loaders) {
+    if (!IsInstanceOfBaseDexClassLoader(class_loader)) {
+      continue;
+    }
+    VisitClassLoaderDexFiles(
+        self,
+        class_loader,
+        [&](const DexFile* dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
+          std::string base_location = DexFileLoader::GetBaseLocation(dex_file->GetLocation());
+          if (!ContainsElement(code_paths, base_location) ||
+              !class_linker->IsDexFileRegistered(self, *dex_file)) {
+            return true;  // Continue with the next dex file.
+          }
+          AppDexFile& app_dex_file = app_dex_files.emplace_back();
+          app_dex_file.class_loader = class_loader;
+          app_dex_file.dex_file = dex_file;
+          app_dex_file.in_profile =
+              profile_info != nullptr &&
+              profile_info->GetClassesAndMethods(*dex_file,
+                                                 &app_dex_file.class_types,
+                                                 &app_dex_file.hot_methods,
+                                                 &app_dex_file.startup_methods,
+                                                 &app_dex_file.post_startup_methods);
+          if (!app_dex_file.in_profile) {
+            return true;
+          }
+          for (uint16_t method_idx : app_dex_file.startup_methods) {
+            app_dex_file.class_types.insert(dex_file->GetMethodId(method_idx).class_idx_);
+          }
+          std::vector<uint16_t>& class_def_indexes = app_dex_file.class_def_indexes;
+          for (dex::TypeIndex type_index : app_dex_file.class_types) {
+            const dex::ClassDef* class_def = dex_file->FindClassDef(type_index);
+            if (class_def != nullptr) {
+              class_def_indexes.push_back(dex_file->GetIndexForClassDef(*class_def));
+            }
+          }
+          std::sort(class_def_indexes.begin(), class_def_indexes.end());
+          return true;
+        });
+  }
+  return app_dex_files;
+}
+
+uint32_t Jit::CompileMethodsFromAppProfile(Thread* self,
+                                           const std::vector<std::string>& code_paths,
+                                           const std::string& profile_file) {
+  ProfileCompilationInfo profile_info;
+  if (!LoadAppProfile(profile_file, &profile_info)) {
+    return 0u;
+  }
+
+  ScopedObjectAccess soa(self);
+  VariableSizedHandleScope handles(self);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  std::vector<AppDexFile> app_dex_files =
+      CollectAppDexFiles(self, &handles, code_paths, &profile_info);
+
+  StackHandleScope<1> hs(self);
+  MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+  uint32_t added_to_queue = 0u;
+  for (AppDexFile& app_dex_file : app_dex_files) {
+    if (!app_dex_file.in_profile) {
+      continue;
+    }
+    // Hot methods get optimized code right away. Methods which are only
+    // known to run during or after startup get baseline code, and will be
+    // optimized if they get hot.
+    dex_cache.Assign(class_linker->FindDexCache(self, *app_dex_file.dex_file));
+    for (uint16_t method_idx : app_dex_file.hot_methods) {
+      if (AddWarmupCompilation(self,
+                               class_linker,
+                               method_idx,
+                               dex_cache,
+                               app_dex_file.class_loader,
+                               CompilationKind::kOptimized)) {
+        ++added_to_queue;
+      }
+    }
+    std::set<uint16_t>& startup_methods = app_dex_file.startup_methods;
+    startup_methods.merge(app_dex_file.post_startup_methods);
+    for (uint16_t method_idx : startup_methods) {
+      if (app_dex_file.hot_methods.find(method_idx) == app_dex_file.hot_methods.end() &&
+          AddWarmupCompilation(self,
+                               class_linker,
+                               method_idx,
+                               dex_cache,
+                               app_dex_file.class_loader,
+                               CompilationKind::kBaseline)) {
+        ++added_to_queue;
+      }
+    }
+  }
+  VLOG(jit) << "Added " << added_to_queue << " methods from app profile " << profile_file;
+  return added_to_queue;
+}
+
+// Returns whether initializing `klass` runs no Java code, in which case doing
+// it ahead of the app is not observable.
+static bool CanPreInitialize(ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (!klass->IsVerified() || klass->FindClassInitializer(kRuntimePointerSize) != nullptr) {
+    return false;
+  }
+  ObjPtr<mirror::Class> super_class = klass->GetSuperClass();
+  if (super_class != nullptr && !super_class->IsInitialized()) {
+    return false;
+  }
+  // Initializing a class also initializes its interfaces with default methods.
+  if (!klass->IsInterface()) {
+    ObjPtr<mirror::IfTable> iftable = klass->GetIfTable();
+    for (size_t i = 0, count = klass->GetIfTableCount(); i != count; ++i) {
+      ObjPtr<mirror::Class> iface = iftable->GetInterface(i);
+      if (iface->HasDefaultMethods() && !iface->IsInitialized()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+uint32_t Jit::PreloadStartupClassesFromAppProfile(Thread* self,
+                                                  const std::vector<std::string>& code_paths,
+                                                  const std::string& profile_file) {
+  ProfileCompilationInfo profile_info;
+  if (!LoadAppProfile(profile_file, &profile_info)) {
+    return 0u;
+  }
+
+  ScopedObjectAccess soa(self);
+  VariableSizedHandleScope handles(self);
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  std::vector<AppDexFile> app_dex_files =
+      CollectAppDexFiles(self, &handles, code_paths, &profile_info);
+
+  StackHandleScope<2> hs(self);
+  MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+  MutableHandle<mirror::Class> klass = hs.NewHandle<mirror::Class>(nullptr);
+  uint32_t loaded = 0u;
+  uint32_t initialized = 0u;
+  for (const AppDexFile& app_dex_file : app_dex_files) {
+    if (!app_dex_file.in_profile) {
+      continue;
+    }
+    const DexFile* dex_file = app_dex_file.dex_file;
+    dex_cache.Assign(class_linker->FindDexCache(self, *dex_file));
+    for (uint16_t class_def_index : app_dex_file.class_def_indexes) {
+      dex::TypeIndex type_index = dex_file->GetClassDef(class_def_index).class_idx_;
+      klass.Assign(class_linker->ResolveType(type_index, dex_cache, app_dex_file.class_loader));
+      if (klass == nullptr) {
+        // Let the app see the failure when it loads the class itself.
+        self->ClearException();
+        continue;
+      }
+      ++loaded;
+      if (!klass->IsVerified() &&
+          class_linker->VerifyClass(self, /* verifier_deps= */ nullptr, klass) ==
+              verifier::FailureKind::kHardFailure) {
+        self->ClearException();
+        continue;
+      }
+      if (!klass->IsInitialized() && CanPreInitialize(klass.Get())) {
+        if (class_linker->EnsureInitialized(self,
+                                            klass,
+                                            /* can_init_fields= */ true,
+                                            /* can_init_parents= */ true)) {
+          ++initialized;
+        } else {
+          self->ClearException();
+        }
+      }
+    }
+  }
+  VLOG(jit) << "Preloaded " << loaded << " classes, " << initialized << " initialized, from "
+            << "app profile " << profile_file;
+  return loaded;
+}
+
+// Returns whether the classes of `dex_file` were already verified ahead of time.
+static bool HasVerifiedOatFile(const DexFile* dex_file) {
+  const OatDexFile* oat_dex_file = dex_file->GetOatDexFile();
+  return oat_dex_file != nullptr &&
+         oat_dex_file->GetOatFile() != nullptr &&
+         CompilerFilter::IsVerificationEnabled(oat_dex_file->GetOatFile()->GetCompilerFilter());
+}
+
+uint32_t Jit::VerifyClassesInBackground(Thread* self,
+                                        const std::vector<std::string>& code_paths,
+                                        const std::string& profile_file) {
+  Runtime* runtime = Runtime::Current();
+  if (MayHaveAgents(runtime)) {
+    VLOG(jit) << "Not verifying classes in the background with JVMTI agents allowed";
+    return 0u;
+  }
+
+  // The profile is optional, it only makes the classes the app needs first get verified first.
+  ProfileCompilationInfo profile_info;
+  bool has_profile = LoadAppProfile(profile_file, &profile_info);
+
+  ScopedObjectAccess soa(self);
+  VariableSizedHandleScope handles(self);
+  ClassLinker* class_linker = runtime->GetClassLinker();
+  std::vector<AppDexFile> app_dex_files =
+      CollectAppDexFiles(self, &handles, code_paths, has_profile ? &profile_info : nullptr);
+
+  StackHandleScope<2> hs(self);
+  MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+  MutableHandle<mirror::Class> klass = hs.NewHandle<mirror::Class>(nullptr);
+  uint32_t verified = 0u;
+  for (const AppDexFile& app_dex_file : app_dex_files) {
+    const DexFile* dex_file = app_dex_file.dex_file;
+    if (HasVerifiedOatFile(dex_file)) {
+      continue;
+    }
+    // Classes of the profile come first, then all other classes. Both
+    // groups are in class definition order, so supertypes come first.
+    std::vector<bool> in_profile(dex_file->NumClassDefs(), false);
+    std::vector<uint16_t> class_def_indexes = app_dex_file.class_def_indexes;
+    class_def_indexes.reserve(dex_file->NumClassDefs());
+    for (uint16_t class_def_index : app_dex_file.class_def_indexes) {
+      in_profile[class_def_index] = true;
+    }
+    for (uint32_t i = 0; i != dex_file->NumClassDefs(); ++i) {
+      if (!in_profile[i]) {
+        class_def_indexes.push_back(i);
+      }
+    }
+    dex_cache.Assign(class_linker->FindDexCache(self, *dex_file));
+    for (uint16_t class_def_index : class_def_indexes) {
+      // Let the GC and the main thread in between classes.
+      self->AllowThreadSuspension();
+      if (runtime->IsShuttingDownUnsafe() || MayHaveAgents(runtime)) {
+        return verified;
+      }
+      dex::TypeIndex type_index = dex_file->GetClassDef(class_def_index).class_idx_;
+      klass.Assign(class_linker->ResolveType(type_index, dex_cache, app_dex_file.class_loader));
+      if (klass == nullptr) {
+        // Let the app see the failure when it loads the class itself.
+        self->ClearException();
+        continue;
+      }
+      if (&klass->GetDexFile() != dex_file || klass->IsVerified()) {
+        // Either the class is shadowed by a class of the same name in a
+        // parent class loader, or the app got to it first.
+        continue;
+      }
+      class_linker->VerifyClass(self, /* verifier_deps= */ nullptr, klass);
+      if (self->IsExceptionPending()) {
+        self->ClearException();
+      }
+      ++verified;
+    }
+  }
+  VLOG(jit) << "Verified " << verified << " classes in the background";
+  return verified;
+}
+
 bool Jit::IgnoreSamplesForMethod(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
   if (method->IsClassInitializer() || !method->IsCompilable()) {
     // We do not want to compile such methods.
@@ -1381,6 +1910,7 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   if (GetCodeCache()->ContainsPc(entry_point) &&
       !CodeInfo::IsBaseline(
           OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr())) {
+    MaybeRequestOsrFromBaseline(self, method);
     return;
   }
 
@@ -1392,6 +1922,64 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   }
 }
 
+// Checkpoint a thread requests on itself, only to take the slow path of its
+// next suspend check.
+class OsrFromBaselineCheckpoint final : public Closure {
+ public:
+  void Run([[maybe_unused]] Thread* self) override {
+    delete this;
+  }
+};
+
+void Jit::MaybeRequestOsrFromBaseline(Thread* self, ArtMethod* method) {
+  if (!kEnableOnStackReplacement || method->IsNative()) {
+    return;
+  }
+  if (!code_cache_->IsOsrCompiled(method)) {
+    AddCompileTask(self, method, CompilationKind::kOsr);
+    return;
+  }
+  // Get the slow path of the next suspend check to deoptimize the baseline
+  // frame, see `ShouldDeoptimizeBaselineFrameForOsr`.
+  self->SetOsrFromBaselineRequested(true);
+  MutexLock mu(self, *Locks::thread_suspend_count_lock_);
+  Closure* checkpoint = new OsrFromBaselineCheckpoint();
+  if (!self->RequestCheckpoint(checkpoint)) {
+    delete checkpoint;
+  }
+}
+
+bool Jit::ShouldDeoptimizeBaselineFrameForOsr(Thread* self, ArtMethod* method, uintptr_t pc) {
+  if (!kEnableOnStackReplacement || !UseJitCompilation()) {
+    return false;
+  }
+  if (!GetCodeCache()->PrivateRegionContainsPc(reinterpret_cast<const void*>(pc))) {
+    return false;
+  }
+  const OatQuickMethodHeader* header = method->GetOatQuickMethodHeader(pc);
+  if (header == nullptr ||
+      !header->IsOptimized() ||
+      !CodeInfo::IsBaseline(header->GetOptimizedCodeInfoPtr())) {
+    return false;
+  }
+  // Baseline code is not debuggable, but keeps the environment of suspend checks live,
+  // see `SsaLivenessAnalysis::ShouldBeLiveForEnvironment`. So the interpreter frame can be
+  // rebuilt from the stack map of the suspend check.
+  CodeInfo code_info(header);
+  StackMap stack_map = code_info.GetStackMapForNativePcOffset(header->NativeQuickPcOffset(pc));
+  if (!stack_map.IsValid() || !stack_map.HasDexRegisterMap()) {
+    return false;
+  }
+  // Don't deoptimize if the interpreter would not do OSR, see
+  // `MaybeDoOnStackReplacement`.
+  Runtime* runtime = Runtime::Current();
+  if (runtime->GetInstrumentation()->NeedsSlowInterpreterForMethod(self, method) ||
+      runtime->GetRuntimeCallbacks()->HaveLocalsChanged()) {
+    return false;
+  }
+  return GetCodeCache()->IsOsrCompiled(method);
+}
+
 class ScopedSetRuntimeThread {
  public:
   explicit ScopedSetRuntimeThread(Thread* self)
@@ -1574,6 +2162,8 @@ void Jit::PostZygoteFork() {
     NotifyZygoteCompilationDone();
     CHECK(code_cache_->GetZygoteMap()->IsCompilationNotified());
   }
+  // A child forked from the zygote can use more compiler threads than the zygote.
+  thread_pool_->SetThreadCount(GetThreadPoolThreadCount());
   thread_pool_->CreateThreads();
   thread_pool_->SetPthreadPriority(
       runtime->IsZygote()
@@ -1632,6 +2222,22 @@ bool Jit::CanAssumeInitialized(ObjPtr<mirror::Class> cls, bool is_for_shared_reg
   }
 }
 
+void Jit::MaybeDecayHotness(Thread* self) {
+  uint32_t period_ms = options_->GetHotnessDecayPeriodMs();
+  if (period_ms == 0u) {
+    return;
+  }
+  uint64_t now_ns = NanoTime();
+  uint64_t last_ns = last_hotness_decay_ns_.load(std::memory_order_relaxed);
+  if (now_ns - last_ns < MsToNs(period_ms)) {
+    return;
+  }
+  // Only the thread that wins the exchange schedules the decay.
+  if (last_hotness_decay_ns_.compare_exchange_strong(last_ns, now_ns, std::memory_order_relaxed)) {
+    thread_pool_->AddTask(self, new JitHotnessDecayTask());
+  }
+}
+
 void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
   if (thread_pool_ == nullptr) {
     return;
@@ -1646,6 +2252,8 @@ void Jit::MaybeEnqueueCompilation(ArtMethod* method, Thread* self) {
     return;
   }
 
+  MaybeDecayHotness(self);
+
   if (IgnoreSamplesForMethod(method)) {
     return;
   }
@@ -1701,7 +2309,12 @@ bool Jit::CompileMethod(ArtMethod* method,
   ScopedSetRuntimeThread ssrt(self);
   // TODO(ngeoffray): For JIT at first use, use kPreCompile. Currently we don't due to
   // conflicts with jitzygote optimizations.
-  return CompileMethodInternal(method, self, compilation_kind, prejit);
+  bool success = CompileMethodInternal(method, self, compilation_kind, prejit);
+  if (LazyMiniDebugInfo()) {
+    // The caller is about to run the code, so make it visible to native tools right away.
+    MaterializeNativeDebugInfoForJit();
+  }
+  return success;
 }
 
 size_t JitThreadPool::GetTaskCount(Thread* self) {
@@ -1709,7 +2322,8 @@ size_t JitThreadPool::GetTaskCount(Thread* self) {
   return generic_queue_.size() +
       baseline_queue_.size() +
       optimized_queue_.size() +
-      osr_queue_.size();
+      osr_queue_.size() +
+      warmup_queue_.size();
 }
 
 void JitThreadPool::RemoveAllTasks(Thread* self) {
@@ -1732,6 +2346,7 @@ void JitThreadPool::RemoveAllTasks(Thread* self) {
   baseline_queue_.clear();
   optimized_queue_.clear();
   osr_queue_.clear();
+  warmup_queue_.clear();
 }
 
 JitThreadPool::~JitThreadPool() {
@@ -1761,29 +2376,33 @@ void JitThreadPool::AddTask(Thread* self, ArtMethod* method, CompilationKind kin
   if (!started_) {
     return;
   }
+  bool enqueued = false;
   switch (kind) {
     case CompilationKind::kOsr:
-      if (ContainsElement(osr_enqueued_methods_, method)) {
-        return;
-      }
-      osr_enqueued_methods_.insert(method);
-      osr_queue_.push_back(method);
+      enqueued = Enqueue(osr_queue_, osr_enqueued_methods_, method);
       break;
     case CompilationKind::kBaseline:
-      if (ContainsElement(baseline_enqueued_methods_, method)) {
-        return;
-      }
-      baseline_enqueued_methods_.insert(method);
-      baseline_queue_.push_back(method);
+      enqueued = Enqueue(baseline_queue_, baseline_enqueued_methods_, method);
       break;
     case CompilationKind::kOptimized:
-      if (ContainsElement(optimized_enqueued_methods_, method)) {
-        return;
-      }
-      optimized_enqueued_methods_.insert(method);
-      optimized_queue_.push_back(method);
+      enqueued = Enqueue(optimized_queue_, optimized_enqueued_methods_, method);
       break;
   }
+  if (!enqueued) {
+    return;
+  }
+  // If we have any waiters, signal one.
+  if (waiting_count_ != 0) {
+    task_queue_condition_.Signal(self);
+  }
+}
+
+void JitThreadPool::AddWarmupTask(Thread* self, ArtMethod* method, CompilationKind kind) {
+  MutexLock mu(self, task_queue_lock_);
+  if (!started_) {
+    return;
+  }
+  warmup_queue_.emplace_back(method, kind);
   // If we have any waiters, signal one.
   if (waiting_count_ != 0) {
     task_queue_condition_.Signal(self);
@@ -1802,21 +2421,57 @@ Task* JitThreadPool::TryGetTaskLocked() {
     return task;
   }
 
-  // OSR requests second, then baseline and finally optimized.
+  // OSR requests second, then optimized and finally baseline. Optimized
+  // requests come from methods that already got hot in baseline code, so
+  // they should not wait behind a burst of baseline requests for lukewarm
+  // methods.
   Task* task = FetchFrom(osr_queue_, CompilationKind::kOsr);
   if (task == nullptr) {
-    task = FetchFrom(baseline_queue_, CompilationKind::kBaseline);
+    task = FetchFrom(optimized_queue_, CompilationKind::kOptimized);
     if (task == nullptr) {
-      task = FetchFrom(optimized_queue_, CompilationKind::kOptimized);
+      task = FetchFrom(baseline_queue_, CompilationKind::kBaseline);
+      if (task == nullptr) {
+        // Warmup requests last, so that they don't delay methods that are hot now.
+        task = FetchWarmupTask();
+      }
     }
   }
   return task;
 }
 
-Task* JitThreadPool::FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) {
-  if (!methods.empty()) {
-    ArtMethod* method = methods.front();
-    methods.pop_front();
+bool JitThreadPool::Enqueue(std::set<MethodRequest>& methods,
+                            std::map<ArtMethod*, MethodRequest>& enqueued_methods,
+                            ArtMethod* method) {
+  auto [it, inserted] = enqueued_methods.try_emplace(
+      method, MethodRequest{1u, next_request_sequence_, method});
+  if (!inserted) {
+    // The method got hot again while waiting (or being compiled). Bump its
+    // priority, saturating rather than wrapping around.
+    MethodRequest& request = it->second;
+    if (request.requests != std::numeric_limits<uint32_t>::max()) {
+      // Move the method up in the queue if it is still waiting.
+      auto node = methods.extract(request);
+      ++request.requests;
+      if (!node.empty()) {
+        node.value() = request;
+        methods.insert(std::move(node));
+      }
+    }
+    return false;
+  }
+  ++next_request_sequence_;
+  methods.insert(it->second);
+  return true;
+}
+
+Task* JitThreadPool::FetchFrom(std::set<MethodRequest>& methods, CompilationKind kind) {
+  for (auto it = methods.begin(); it != methods.end(); ++it) {
+    if (IsBeingCompiledLocked(it->method)) {
+      // The worker finishing that compilation will pick up the request once it is done.
+      continue;
+    }
+    ArtMethod* method = it->method;
+    methods.erase(it);
     JitCompileTask* task = new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, kind);
     current_compilations_.insert(task);
     return task;
@@ -1824,9 +2479,49 @@ Task* JitThreadPool::FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind
   return nullptr;
 }
 
+Task* JitThreadPool::FetchWarmupTask() {
+  while (!warmup_queue_.empty()) {
+    auto [method, kind] = warmup_queue_.front();
+    warmup_queue_.pop_front();
+    if (IsBeingCompiledLocked(method) ||
+        baseline_enqueued_methods_.find(method) != baseline_enqueued_methods_.end() ||
+        optimized_enqueued_methods_.find(method) != optimized_enqueued_methods_.end()) {
+      // The method got hot on its own, the hotness requests take care of it.
+      continue;
+    }
+    JitCompileTask* task = new JitCompileTask(method, JitCompileTask::TaskKind::kWarmup, kind);
+    current_compilations_.insert(task);
+    return task;
+  }
+  return nullptr;
+}
+
+bool JitThreadPool::IsBeingCompiledLocked(ArtMethod* method) const {
+  // With multiple workers, a method could otherwise be compiled for two
+  // compilation kinds at the same time, and the baseline code could end up
+  // replacing the optimized code when committed last.
+  for (JitCompileTask* task : current_compilations_) {
+    if (task->GetArtMethod() == method) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void JitThreadPool::SetThreadCount(size_t num_threads) {
+  CHECK(threads_.empty());
+  CHECK_GT(num_threads, 0u);
+  MutexLock mu(Thread::Current(), task_queue_lock_);
+  max_active_workers_ = num_threads;
+}
+
 void JitThreadPool::Remove(JitCompileTask* task) {
   MutexLock mu(Thread::Current(), task_queue_lock_);
   current_compilations_.erase(task);
+  if (task->IsWarmup()) {
+    // Warmup requests are not tracked in the enqueued methods maps.
+    return;
+  }
   switch (task->GetCompilationKind()) {
     case CompilationKind::kOsr: {
       osr_enqueued_methods_.erase(task->GetArtMethod());
@@ -1864,9 +2559,15 @@ void JitThreadPool::VisitRoots(RootVisitor* visitor) {
     // - Generic tasks like `ZygoteVerificationTask` which don't hold any root.
     // - `JitCompileTask` for precompiled methods, which we know are live, being
     //   part of the boot classpath or system server classpath.
-    methods.insert(methods.end(), osr_queue_.begin(), osr_queue_.end());
-    methods.insert(methods.end(), baseline_queue_.begin(), baseline_queue_.end());
-    methods.insert(methods.end(), optimized_queue_.begin(), optimized_queue_.end());
+    for (const std::set<MethodRequest>* queue :
+             {&osr_queue_, &baseline_queue_, &optimized_queue_}) {
+      for (const MethodRequest& request : *queue) {
+        methods.push_back(request.method);
+      }
+    }
+    for (const std::pair<ArtMethod*, CompilationKind>& request : warmup_queue_) {
+      methods.push_back(request.first);
+    }
     for (JitCompileTask* task : current_compilations_) {
       methods.push_back(task->GetArtMethod());
     }
@@ -17,6 +17,9 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include <atomic>
+#include <map>
+#include <set>
 #include <unordered_set>
 
 #include <android-base/unique_fd.h>
@@ -134,9 +137,18 @@ class JitThreadPool : public AbstractThreadPool {
   // Add a custom compilation task in the right queue.
   void AddTask(Thread* self, ArtMethod* method, CompilationKind kind) REQUIRES(!task_queue_lock_);
 
+  // Add a compilation of `method` requested from a persisted profile rather
+  // than from hotness. These are only served once the other queues are empty.
+  void AddWarmupTask(Thread* self, ArtMethod* method, CompilationKind kind)
+      REQUIRES(!task_queue_lock_);
+
   // Visit the ArtMethods stored in the various queues.
   void VisitRoots(RootVisitor* visitor);
 
+  // Set the number of workers created by the next CreateThreads(). Must be
+  // called while the pool has no threads, e.g. between the zygote fork hooks.
+  void SetThreadCount(size_t num_threads) REQUIRES(!task_queue_lock_);
+
  protected:
   Task* TryGetTaskLocked() REQUIRES(task_queue_lock_) override;
 
@@ -145,7 +157,8 @@ class JitThreadPool : public AbstractThreadPool {
         (!generic_queue_.empty() ||
          !baseline_queue_.empty() ||
          !optimized_queue_.empty() ||
-         !osr_queue_.empty());
+         !osr_queue_.empty() ||
+         !warmup_queue_.empty());
   }
 
  private:
@@ -153,23 +166,62 @@ class JitThreadPool : public AbstractThreadPool {
                 size_t num_threads,
                 size_t worker_stack_size)
       // We need peers as we may report the JIT thread, e.g., in the debugger.
-      : AbstractThreadPool(name, num_threads, /* create_peers= */ true, worker_stack_size) {}
-
-  // Try to fetch an entry from `methods`. Return null if `methods` is empty.
-  Task* FetchFrom(std::deque<ArtMethod*>& methods, CompilationKind kind) REQUIRES(task_queue_lock_);
+      : AbstractThreadPool(name, num_threads, /* create_peers= */ true, worker_stack_size),
+        next_request_sequence_(0u) {}
+
+  // A compilation request for `method`. `requests` is the number of times the method was
+  // requested since it got enqueued, i.e. how often it got hot again while waiting, and
+  // `sequence` orders the requests by the time they got enqueued.
+  struct MethodRequest {
+    uint32_t requests;
+    uint64_t sequence;
+    ArtMethod* method;
+
+    // The method requested most often comes first, the oldest one among equally hot methods.
+    bool operator<(const MethodRequest& other) const {
+      return (requests != other.requests) ? (requests > other.requests)
+                                          : (sequence < other.sequence);
+    }
+  };
+
+  // Enqueue `method` in `methods` unless it is already enqueued or being compiled, in which
+  // case only its request count is bumped. Return whether `method` was newly enqueued.
+  bool Enqueue(std::set<MethodRequest>& methods,
+               std::map<ArtMethod*, MethodRequest>& enqueued_methods,
+               ArtMethod* method) REQUIRES(task_queue_lock_);
+
+  // Try to fetch the hottest entry from `methods`, that is the one with the most compilation
+  // requests, oldest first. Methods being compiled by another worker with a different
+  // compilation kind are skipped. Return null if there is no such entry.
+  Task* FetchFrom(std::set<MethodRequest>& methods, CompilationKind kind)
+      REQUIRES(task_queue_lock_);
+
+  // Fetch the next warmup request whose method did not get hot on its own in
+  // the meantime. Return null if there is no such request.
+  Task* FetchWarmupTask() REQUIRES(task_queue_lock_);
+
+  // Return whether a worker is currently compiling `method`.
+  bool IsBeingCompiledLocked(ArtMethod* method) const REQUIRES(task_queue_lock_);
 
   std::deque<Task*> generic_queue_ GUARDED_BY(task_queue_lock_);
 
-  std::deque<ArtMethod*> osr_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> baseline_queue_ GUARDED_BY(task_queue_lock_);
-  std::deque<ArtMethod*> optimized_queue_ GUARDED_BY(task_queue_lock_);
+  // The per-kind queues, ordered by priority so that fetching the hottest method does not
+  // need to scan them.
+  std::set<MethodRequest> osr_queue_ GUARDED_BY(task_queue_lock_);
+  std::set<MethodRequest> baseline_queue_ GUARDED_BY(task_queue_lock_);
+  std::set<MethodRequest> optimized_queue_ GUARDED_BY(task_queue_lock_);
+  std::deque<std::pair<ArtMethod*, CompilationKind>> warmup_queue_ GUARDED_BY(task_queue_lock_);
 
-  // We track the methods that are currently enqueued to avoid
-  // adding them to the queue multiple times, which could bloat the
-  // queues.
-  std::set<ArtMethod*> osr_enqueued_methods_ GUARDED_BY(task_queue_lock_);
-  std::set<ArtMethod*> baseline_enqueued_methods_ GUARDED_BY(task_queue_lock_);
-  std::set<ArtMethod*> optimized_enqueued_methods_ GUARDED_BY(task_queue_lock_);
+  // We track the methods that are currently enqueued or being compiled to
+  // avoid adding them to the queues multiple times, which could bloat the
+  // queues. The value is the method's current request, which is also the
+  // key of its entry in the queue while it waits.
+  std::map<ArtMethod*, MethodRequest> osr_enqueued_methods_ GUARDED_BY(task_queue_lock_);
+  std::map<ArtMethod*, MethodRequest> baseline_enqueued_methods_ GUARDED_BY(task_queue_lock_);
+  std::map<ArtMethod*, MethodRequest> optimized_enqueued_methods_ GUARDED_BY(task_queue_lock_);
+
+  // The sequence number of the next enqueued method.
+  uint64_t next_request_sequence_ GUARDED_BY(task_queue_lock_);
 
   // A set to keep track of methods that are currently being compiled. Entries
   // will be removed when JitCompileTask->Finalize is called.
@@ -211,6 +263,10 @@ class Jit {
   void DeleteThreadPool();
   void WaitForWorkersToBeCreated();
 
+  // Number of compiler threads for the thread pool. The zygote uses a single
+  // thread, as its boot image compilation relies on being the only jit thread.
+  size_t GetThreadPoolThreadCount() const;
+
   // Dump interesting info: #methods compiled, code vs data size, compile / verify cumulative
   // loggers.
   void DumpInfo(std::ostream& os) REQUIRES(!lock_);
@@ -251,6 +307,10 @@ class Jit {
     return options_->GetSaveProfilingInfo();
   }
 
+  bool LazyMiniDebugInfo() const {
+    return options_->LazyMiniDebugInfo();
+  }
+
   // Wait until there is no more pending compilation tasks.
   EXPORT void WaitForCompilationToFinish(Thread* self);
 
@@ -314,6 +374,14 @@ class Jit {
                                         JValue* result)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return whether the frame of `method` at `pc`, stopped at a suspend check, is
+  // running baseline code that should be left for the OSR code of `method`. The
+  // frame is then deoptimized, and the interpreter enters the OSR code at the
+  // next branch. Unlike `Runtime::IsAsyncDeoptimizeable()`, this does not need
+  // debuggable code, as baseline code keeps the environment of suspend checks.
+  bool ShouldDeoptimizeBaselineFrameForOsr(Thread* self, ArtMethod* method, uintptr_t pc)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   JitThreadPool* GetThreadPool() const {
     return thread_pool_.get();
   }
@@ -352,6 +420,34 @@ class Jit {
                                      Handle<mirror::ClassLoader> class_loader,
                                      bool add_to_queue);
 
+  // Compile the methods of the app profile `profile_file` found in the dex
+  // files of `code_paths` which don't have AOT code: hot methods are compiled
+  // optimized, others baseline. Methods are added to a low-priority JIT queue
+  // served after the hotness requests.
+  // Return the number of methods added to the queue.
+  uint32_t CompileMethodsFromAppProfile(Thread* self,
+                                        const std::vector<std::string>& code_paths,
+                                        const std::string& profile_file);
+
+  // Load the startup classes of the app profile `profile_file` found in the dex
+  // files of `code_paths`, in class definition order so that superclasses come
+  // first. Classes are verified, and initialized when that runs no code. Not
+  // started by the profile saver if JVMTI agents can be attached, as loading the
+  // classes would report class load events for them on the calling thread.
+  // Return the number of classes loaded.
+  EXPORT uint32_t PreloadStartupClassesFromAppProfile(Thread* self,
+                                                      const std::vector<std::string>& code_paths,
+                                                      const std::string& profile_file);
+
+  // Verify the classes of the dex files of `code_paths` which were not verified
+  // ahead of time, the classes of the app profile `profile_file` first. Does
+  // nothing if JVMTI agents can be attached, as loading the classes would report
+  // class load events for them on the calling thread.
+  // Return the number of classes verified.
+  EXPORT uint32_t VerifyClassesInBackground(Thread* self,
+                                     const std::vector<std::string>& code_paths,
+                                     const std::string& profile_file);
+
   // Compile methods from the given boot profile (.bprof extension). If `add_to_queue`
   // is true, methods in the profile are added to the JIT queue. Otherwise they are compiled
   // directly.
@@ -385,7 +481,8 @@ class Jit {
   // class path methods.
   void NotifyZygoteCompilationDone();
 
-  EXPORT void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self);
+  EXPORT void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   EXPORT void MaybeEnqueueCompilation(ArtMethod* method, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -400,6 +497,25 @@ class Jit {
   bool IgnoreSamplesForMethod(ArtMethod* method)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Schedule a decay of the hotness counters if the decay period has elapsed
+  // since the last one.
+  void MaybeDecayHotness(Thread* self);
+
+  // Called when baseline code of `method` is still running although its
+  // optimized code is installed, which happens when the frame is stuck in a loop.
+  void MaybeRequestOsrFromBaseline(Thread* self, ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Add a low-priority compilation of a method listed in an app profile,
+  // unless it already has compiled code. Return whether the request was added.
+  bool AddWarmupCompilation(Thread* self,
+                            ClassLinker* linker,
+                            uint32_t method_idx,
+                            Handle<mirror::DexCache> dex_cache,
+                            Handle<mirror::ClassLoader> class_loader,
+                            CompilationKind compilation_kind)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Compile an individual method listed in a profile. If `add_to_queue` is
   // true and the method was resolved, return true. Otherwise return false.
   bool CompileMethodFromProfile(Thread* self,
@@ -466,6 +582,9 @@ class Jit {
   // between the zygote and apps.
   std::map<ArtMethod*, uint16_t> shared_method_counters_;
 
+  // Time of the last hotness decay, see `JitOptions::GetHotnessDecayPeriodMs()`.
+  std::atomic<uint64_t> last_hotness_decay_ns_;
+
   friend class art::jit::JitCompileTask;
 
   DISALLOW_COPY_AND_ASSIGN(Jit);
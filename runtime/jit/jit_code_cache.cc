@@ -16,6 +16,7 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -68,52 +69,15 @@ namespace jit {
 static constexpr size_t kCodeSizeLogThreshold = 50 * KB;
 static constexpr size_t kStackMapSizeLogThreshold = 50 * KB;
 
-class JitCodeCache::JniStubKey {
- public:
-  explicit JniStubKey(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_)
-      : shorty_(method->GetShorty()),
-        is_static_(method->IsStatic()),
-        is_fast_native_(method->IsFastNative()),
-        is_critical_native_(method->IsCriticalNative()),
-        is_synchronized_(method->IsSynchronized()) {
-    DCHECK(!(is_fast_native_ && is_critical_native_));
-  }
-
-  bool operator<(const JniStubKey& rhs) const {
-    if (is_static_ != rhs.is_static_) {
-      return rhs.is_static_;
-    }
-    if (is_synchronized_ != rhs.is_synchronized_) {
-      return rhs.is_synchronized_;
-    }
-    if (is_fast_native_ != rhs.is_fast_native_) {
-      return rhs.is_fast_native_;
-    }
-    if (is_critical_native_ != rhs.is_critical_native_) {
-      return rhs.is_critical_native_;
-    }
-    return strcmp(shorty_, rhs.shorty_) < 0;
-  }
-
-  // Update the shorty to point to another method's shorty. Call this function when removing
-  // the method that references the old shorty from JniCodeData and not removing the entire
-  // JniCodeData; the old shorty may become a dangling pointer when that method is unloaded.
-  void UpdateShorty(ArtMethod* method) const REQUIRES_SHARED(Locks::mutator_lock_) {
-    const char* shorty = method->GetShorty();
-    DCHECK_STREQ(shorty_, shorty);
-    shorty_ = shorty;
-  }
-
- private:
-  // The shorty points to a DexFile data and may need to change
-  // to point to the same shorty in a different DexFile.
-  mutable const char* shorty_;
-
-  const bool is_static_;
-  const bool is_fast_native_;
-  const bool is_critical_native_;
-  const bool is_synchronized_;
-};
+// Update the key to point to another method's shorty. Call this function when removing
+// the method that references the old shorty from JniStubData and not removing the entire
+// JniStubData; the old shorty may become a dangling pointer when that method is unloaded.
+static void UpdateJniStubKey(JniStubKey* key, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  JniStubKey new_key(method);
+  DCHECK_EQ(key->Flags(), new_key.Flags());
+  *key = new_key;
+}
 
 class JitCodeCache::JniStubData {
  public:
@@ -261,6 +225,7 @@ JitCodeCache::JitCodeCache()
     : is_weak_access_enabled_(true),
       inline_cache_cond_("Jit inline cache condition variable", *Locks::jit_lock_),
       reserved_capacity_(GetInitialCapacity() * kReservedCapacityMultiplier),
+      jni_stubs_map_(JniStubKeyHash(kRuntimeISA), JniStubKeyEquals(kRuntimeISA)),
       zygote_map_(&shared_region_),
       lock_cond_("Jit code cache condition variable", *Locks::jit_lock_),
       collection_in_progress_(false),
@@ -336,10 +301,11 @@ const void* JitCodeCache::GetSavedEntryPointOfPreCompiledMethod(ArtMethod* metho
   Thread* self = Thread::Current();
   ScopedDebugDisallowReadBarriers sddrb(self);
   if (method->IsPreCompiled()) {
-    const void* code_ptr = nullptr;
-    if (method->GetDeclaringClass<kWithoutReadBarrier>()->IsBootStrapClassLoaded()) {
-      code_ptr = zygote_map_.GetCodeFor(method);
-    } else {
+    // Boot classpath methods, and methods of the shared libraries preloaded by
+    // the zygote, may have been compiled in the zygote.
+    const void* code_ptr = zygote_map_.GetCodeFor(method);
+    if (code_ptr == nullptr &&
+        !method->GetDeclaringClass<kWithoutReadBarrier>()->IsBootStrapClassLoaded()) {
       WriterMutexLock mu(self, *Locks::jit_mutator_lock_);
       auto it = saved_compiled_methods_map_.find(method);
       if (it != saved_compiled_methods_map_.end()) {
@@ -564,7 +530,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
         method_headers.insert(OatQuickMethodHeader::FromCodePointer(it->second.GetCode()));
         it = jni_stubs_map_.erase(it);
       } else {
-        it->first.UpdateShorty(it->second.GetMethods().front());
+        UpdateJniStubKey(&it->first, it->second.GetMethods().front());
         ++it;
       }
     }
@@ -587,6 +553,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
         ++it;
       }
     }
+    code_index_.Rebuild(method_code_map_);
     for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
       DCHECK(!ContainsElement(zombie_code_, it->second));
       if (alloc.ContainsUnsafe(it->first)) {
@@ -607,6 +574,14 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
     }
   }
 
+  for (auto it = method_compilation_stats_.begin(); it != method_compilation_stats_.end();) {
+    if (alloc.ContainsUnsafe(it->first)) {
+      it = method_compilation_stats_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
   for (auto it = profiling_infos_.begin(); it != profiling_infos_.end();) {
     ProfilingInfo* info = it->second;
     if (alloc.ContainsUnsafe(info->GetMethod())) {
@@ -695,6 +670,7 @@ bool JitCodeCache::Commit(Thread* self,
                           const std::vector<Handle<mirror::Object>>& roots,
                           ArrayRef<const uint8_t> stack_map,
                           const std::vector<uint8_t>& debug_info,
+                          JitDebugInfoGenerator&& lazy_debug_info,
                           bool is_full_debug_info,
                           CompilationKind compilation_kind,
                           const ArenaSet<ArtMethod*>& cha_single_implementation_list) {
@@ -710,20 +686,28 @@ bool JitCodeCache::Commit(Thread* self,
   size_t root_table_size = ComputeRootTableSize(roots.size());
   const uint8_t* stack_map_data = roots_data + root_table_size;
 
-  OatQuickMethodHeader* method_header = nullptr;
+  const uint8_t* code_ptr = nullptr;
+  uint64_t commit_number = 0u;
   {
     MutexLock mu(self, *Locks::jit_lock_);
-    const uint8_t* code_ptr = region->CommitCode(reserved_code, code, stack_map_data);
+    code_ptr = region->CommitCode(reserved_code, code, stack_map_data, &commit_number);
     if (code_ptr == nullptr) {
       return false;
     }
-    method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
 
     // Commit roots and stack maps before updating the entry point.
     if (!region->CommitData(reserved_data, roots, stack_map)) {
       return false;
     }
+  }
+
+  // Make the code visible to all cores before updating the entry point. This is done outside the
+  // JIT lock so that the compiler threads committing at the same time share a single membarrier.
+  region->SyncCores(commit_number);
 
+  OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
     switch (compilation_kind) {
       case CompilationKind::kOsr:
         number_of_osr_compilations_++;
@@ -741,6 +725,20 @@ bool JitCodeCache::Commit(Thread* self,
     if (!debug_info.empty()) {
       // NB: Don't allow packing of full info since it would remove non-backtrace data.
       AddNativeDebugInfoForJit(code_ptr, debug_info, /*allow_packing=*/ !is_full_debug_info);
+    } else if (lazy_debug_info != nullptr) {
+      AddLazyNativeDebugInfoForJit(code_ptr, std::move(lazy_debug_info));
+    }
+
+    if (!method->IsNative() &&
+        method->IsPreCompiled() &&
+        IsSharedRegion(*region) &&
+        zygote_map_.IsFull()) {
+      // Nothing would record this code. Discard it, and let the method be JIT
+      // compiled again.
+      VLOG(jit) << "JIT discarded zygote code of " << method->PrettyMethod()
+                << " as the zygote map is full.";
+      method->ClearPreCompiled();
+      return false;
     }
 
     // The following needs to be guarded by cha_lock_ also. Otherwise it's possible that the
@@ -794,6 +792,7 @@ bool JitCodeCache::Commit(Thread* self,
         ScopedDebugDisallowReadBarriers sddrb(self);
         WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
         method_code_map_.Put(code_ptr, method);
+        code_index_.Insert(code_ptr, method);
 
         // Searching for MethodType-s in roots. They need to be treated as strongly reachable while
         // the corresponding ArtMethod is not removed.
@@ -898,7 +897,7 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
         jni_stubs_map_.erase(it);
         zombie_jni_code_.erase(method);
       } else {
-        it->first.UpdateShorty(it->second.GetMethods().front());
+        UpdateJniStubKey(&it->first, it->second.GetMethods().front());
       }
     }
   } else {
@@ -909,6 +908,7 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
           FreeCodeAndData(it->first);
         }
         VLOG(jit) << "JIT removed " << it->second->PrettyMethod() << ": " << it->first;
+        code_index_.Remove(it->first);
         it = method_code_map_.erase(it);
       } else {
         ++it;
@@ -960,6 +960,7 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
       it.second = new_method;
     }
   }
+  code_index_.Rebuild(method_code_map_);
   // Update osr_code_map_ to point to the new method.
   auto code_map = osr_code_map_.find(old_method);
   if (code_map != osr_code_map_.end()) {
@@ -1024,6 +1025,7 @@ bool JitCodeCache::Reserve(Thread* self,
                            size_t stack_map_size,
                            size_t number_of_roots,
                            ArtMethod* method,
+                           CompilationKind compilation_kind,
                            /*out*/ArrayRef<const uint8_t>* reserved_code,
                            /*out*/ArrayRef<const uint8_t>* reserved_data) {
   code_size = OatQuickMethodHeader::InstructionAlignedSize() + code_size;
@@ -1037,7 +1039,8 @@ bool JitCodeCache::Reserve(Thread* self,
       ScopedThreadSuspension sts(self, ThreadState::kSuspended);
       MutexLock mu(self, *Locks::jit_lock_);
       ScopedCodeCacheWrite ccw(*region);
-      code = region->AllocateCode(code_size);
+      code = region->AllocateCode(code_size,
+                                  /*is_cold=*/ compilation_kind == CompilationKind::kBaseline);
       data = region->AllocateData(data_size);
       at_max_capacity = IsAtMaxCapacity();
     }
@@ -1060,6 +1063,14 @@ bool JitCodeCache::Reserve(Thread* self,
   *reserved_data = ArrayRef<const uint8_t>(data, data_size);
 
   MutexLock mu(self, *Locks::jit_lock_);
+  MethodCompilationStats& stats = method_compilation_stats_.GetOrCreate(
+      method, []() { return MethodCompilationStats(); });
+  stats.code_size = dchecked_integral_cast<uint32_t>(code_size);
+  stats.stack_map_size = dchecked_integral_cast<uint32_t>(data_size);
+  ++stats.compilations;
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  metrics->JitCodeBytesAllocated()->Add(code_size);
+  metrics->JitStackMapBytesAllocated()->Add(data_size);
   histogram_code_memory_use_.AddValue(code_size);
   if (code_size > kCodeSizeLogThreshold) {
     LOG(INFO) << "JIT allocated "
@@ -1162,6 +1173,7 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
   std::unordered_set<OatQuickMethodHeader*> method_headers;
   ScopedDebugDisallowReadBarriers sddrb(self);
   MutexLock mu(self, *Locks::jit_lock_);
+  bool removed_code = false;
   // Iterate over all zombie code and remove entries that are not marked.
   for (auto it = processed_zombie_code_.begin(); it != processed_zombie_code_.end();) {
     const void* code_ptr = *it;
@@ -1192,10 +1204,17 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
 
         method_code_map_.erase(header->GetCode());
       }
+      removed_code = true;
       VLOG(jit) << "JIT removed " << *it;
       it = processed_zombie_code_.erase(it);
     }
   }
+  if (removed_code) {
+    // Update the index in one go before the code gets freed below. Until then,
+    // stale entries are harmless: no frame executes the removed code.
+    WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
+    code_index_.Rebuild(method_code_map_);
+  }
   for (auto it = processed_zombie_jni_code_.begin(); it != processed_zombie_jni_code_.end();) {
     WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
     ArtMethod* method = *it;
@@ -1221,7 +1240,7 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         VLOG(jit) << "JIT removed native code of" << method->PrettyMethod();
         jni_stubs_map_.erase(stub);
       } else {
-        stub->first.UpdateShorty(stub->second.GetMethods().front());
+        UpdateJniStubKey(&stub->first, stub->second.GetMethods().front());
       }
       it = processed_zombie_jni_code_.erase(it);
     } else {
@@ -1244,6 +1263,26 @@ class JitGcTask final : public Task {
   }
 };
 
+class JitTrimTask final : public Task {
+ public:
+  JitTrimTask() {}
+
+  void Run(Thread* self) override {
+    Runtime::Current()->GetJit()->GetCodeCache()->TrimMemory(self);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+};
+
+void JitCodeCache::RequestTrim(Thread* self) {
+  JitThreadPool* pool = Runtime::Current()->GetJit()->GetThreadPool();
+  if (pool != nullptr) {
+    pool->AddTask(self, new JitTrimTask());
+  }
+}
+
 void JitCodeCache::AddZombieCode(ArtMethod* method, const void* entry_point) {
   CHECK(ContainsPc(entry_point));
   CHECK(method->IsNative() || (method->GetEntryPointFromQuickCompiledCode() != entry_point));
@@ -1319,6 +1358,31 @@ void JitCodeCache::MaybeUpdateInlineCache(ArtMethod* method,
   info->AddInvokeInfo(dex_pc, cls.Ptr());
 }
 
+void JitCodeCache::DecayBaselineHotnessCounts(Thread* self) {
+  uint16_t optimize_threshold = ProfilingInfo::GetOptimizeThreshold();
+  MutexLock mu(self, *Locks::jit_lock_);
+  for (const auto& [method, info] : profiling_infos_) {
+    info->DecayBaselineHotnessCount(optimize_threshold);
+  }
+}
+
+void JitCodeCache::RecordDeoptimization(ArtMethod* method,
+                                        DeoptimizationKind kind,
+                                        Thread* self) {
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  if (it == profiling_infos_.end()) {
+    return;
+  }
+  ProfilingInfo* info = it->second;
+  info->RecordDeoptimization(kind);
+  if (!info->CanSpeculate(kind)) {
+    VLOG(jit) << "Not speculating on " << GetDeoptimizationKindName(kind) << " anymore for "
+              << method->PrettyMethod();
+  }
+}
+
 void JitCodeCache::DoCollection(Thread* self) {
   ScopedTrace trace(__FUNCTION__);
 
@@ -1332,11 +1396,12 @@ void JitCodeCache::DoCollection(Thread* self) {
     }
     collection_in_progress_ = true;
     number_of_collections_++;
+    // Cover the whole code mapping: the cold code space is placed at its end,
+    // beyond the current capacity.
     live_bitmap_.reset(CodeCacheBitmap::Create(
           "code-cache-bitmap",
           reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->Begin()),
-          reinterpret_cast<uintptr_t>(
-              private_region_.GetExecPages()->Begin() + private_region_.GetCurrentCapacity() / 2)));
+          reinterpret_cast<uintptr_t>(private_region_.GetExecPages()->End())));
     {
       WriterMutexLock mu2(self, *Locks::jit_mutator_lock_);
       processed_zombie_code_.insert(zombie_code_.begin(), zombie_code_.end());
@@ -1374,6 +1439,67 @@ void JitCodeCache::DoCollection(Thread* self) {
   Runtime::Current()->GetJit()->AddTimingLogger(logger);
 }
 
+void JitCodeCache::TrimMemory(Thread* self) {
+  ScopedTrace trace(__FUNCTION__);
+  size_t discarded = 0u;
+  {
+    ScopedObjectAccess soa(self);
+    ScopedDebugDisallowReadBarriers sddrb(self);
+    std::vector<ArtMethod*> cold_methods;
+    {
+      MutexLock mu(self, *Locks::jit_lock_);
+      if (!garbage_collect_code_) {
+        return;
+      }
+      for (const auto& [method, info] : profiling_infos_) {
+        // Always update the snapshot, so that the next trim only looks at the
+        // samples taken after this one. A zero count means an optimized
+        // compilation was requested for the method.
+        if (info->BaselineCodeRanSinceLastCheck() ||
+            info->GetBaselineHotnessCount() == 0u ||
+            info->IsInUseByCompiler() ||
+            method->IsObsolete()) {
+          continue;
+        }
+        const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+        if (ContainsPc(entry_point) &&
+            !IsInZygoteExecSpace(entry_point) &&
+            CodeInfo::IsBaseline(
+                OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr())) {
+          cold_methods.push_back(method);
+        }
+      }
+    }
+    instrumentation::Instrumentation* instr = Runtime::Current()->GetInstrumentation();
+    uint16_t warmup_threshold = Runtime::Current()->GetJit()->WarmMethodThreshold();
+    for (ArtMethod* method : cold_methods) {
+      const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+      // Optimized code may have replaced the baseline code in the meantime.
+      if (!ContainsPc(entry_point) ||
+          !CodeInfo::IsBaseline(
+              OatQuickMethodHeader::FromEntryPoint(entry_point)->GetOptimizedCodeInfoPtr())) {
+        continue;
+      }
+      // Switching the entry point makes the baseline code a zombie, which the
+      // collection below frees unless it is still on a thread stack. The method
+      // warms up again from the interpreter if it gets used later.
+      instr->InitializeMethodsCode(method, /*aot_code=*/ nullptr);
+      method->ResetCounter(warmup_threshold);
+      ++discarded;
+    }
+  }
+
+  DoCollection(self);
+
+  MutexLock mu(self, *Locks::jit_lock_);
+  // Let a collection started by another thread free its code first.
+  WaitForPotentialCollectionToComplete(self);
+  private_region_.ShrinkCodeCacheCapacity();
+  size_t released = private_region_.ReleaseUnusedMemory();
+  VLOG(jit) << "JIT trim discarded " << discarded << " baseline methods and released "
+            << PrettySize(released);
+}
+
 OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod* method) {
   static_assert(kRuntimeISA != InstructionSet::kThumb2, "kThumb2 cannot be a runtime ISA");
   const void* pc_ptr = reinterpret_cast<const void*>(pc);
@@ -1415,7 +1541,10 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
         return OatQuickMethodHeader::FromCodePointer(code_ptr);
       }
     }
-    {
+    const void* code_ptr = nullptr;
+    ArtMethod* code_method = nullptr;
+    if (!code_index_.Lookup(pc, &code_ptr, &code_method)) {
+      // The index is being updated, search the map instead.
       ReaderMutexLock mu(self, *Locks::jit_mutator_lock_);
       auto it = method_code_map_.lower_bound(pc_ptr);
       if ((it == method_code_map_.end() || it->first != pc_ptr) &&
@@ -1423,13 +1552,16 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
         --it;
       }
       if (it != method_code_map_.end()) {
-        const void* code_ptr = it->first;
-        if (OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
-          method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
-          found_method = it->second;
-        }
+        code_ptr = it->first;
+        code_method = it->second;
       }
     }
+    // A pc being looked up is executing, so its code cannot be freed under us
+    // once the index returned it.
+    if (code_ptr != nullptr && OatQuickMethodHeader::FromCodePointer(code_ptr)->Contains(pc)) {
+      method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+      found_method = code_method;
+    }
     if (method_header == nullptr && method == nullptr) {
       ReaderMutexLock mu(self, *Locks::jit_mutator_lock_);
       // Scan all compiled JNI stubs as well. This slow search is used only
@@ -1693,7 +1825,7 @@ bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
     bool new_compilation = false;
     if (it == jni_stubs_map_.end()) {
       // Create a new entry to mark the stub as being compiled.
-      it = jni_stubs_map_.Put(key, JniStubData{});
+      it = jni_stubs_map_.insert(std::make_pair(key, JniStubData{})).first;
       new_compilation = true;
     }
     JniStubData* data = &it->second;
@@ -1829,6 +1961,94 @@ void JitCodeCache::InvalidateCompiledCodeFor(ArtMethod* method,
   if (method->IsPreCompiled()) {
     method->ClearPreCompiled();
   }
+
+  Runtime::Current()->GetMetrics()->JitCodeInvalidationCount()->AddOne();
+  Thread* self = Thread::Current();
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = method_compilation_stats_.find(method);
+  if (it != method_compilation_stats_.end()) {
+    ++it->second.deoptimizations;
+  }
+}
+
+void JitCodeCache::InvalidateCompiledCodeThatInlined(ArtMethod* inlined) {
+  Thread* self = Thread::Current();
+  ScopedDebugDisallowReadBarriers sddrb(self);
+  auto inlines = [inlined](const void* code_ptr) {
+    const OatQuickMethodHeader* header = OatQuickMethodHeader::FromCodePointer(code_ptr);
+    if (!header->IsOptimized()) {
+      return false;
+    }
+    CodeInfo code_info = CodeInfo::DecodeInlineInfoOnly(header);
+    for (InlineInfo inline_info : code_info.GetInlineInfos()) {
+      // JIT code always encodes the inlined ArtMethod.
+      if (inline_info.EncodesArtMethod() && inline_info.GetArtMethod() == inlined) {
+        return true;
+      }
+    }
+    return false;
+  };
+  // `InvalidateCompiledCodeFor()` takes the `jit_mutator_lock_`, so collect the code first.
+  std::vector<std::pair<ArtMethod*, const void*>> to_invalidate;
+  {
+    ReaderMutexLock mu(self, *Locks::jit_mutator_lock_);
+    for (const auto& [code_ptr, method] : method_code_map_) {
+      if (inlines(code_ptr)) {
+        to_invalidate.emplace_back(method, code_ptr);
+      }
+    }
+  }
+  for (const auto& entry : zygote_map_) {
+    if (entry.method != nullptr && inlines(entry.code_ptr)) {
+      to_invalidate.emplace_back(entry.method, entry.code_ptr);
+    }
+  }
+  for (const auto& [method, code_ptr] : to_invalidate) {
+    VLOG(jit) << "Invalidating " << method->PrettyMethod() << " which inlined "
+              << inlined->PrettyMethod();
+    InvalidateCompiledCodeFor(method, OatQuickMethodHeader::FromCodePointer(code_ptr));
+  }
+}
+
+void JitCodeCache::AddCompilationTime(ArtMethod* method,
+                                      uint64_t wall_time_ns,
+                                      uint64_t cpu_time_ns) {
+  MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+  MethodCompilationStats& stats = method_compilation_stats_.GetOrCreate(
+      method, []() { return MethodCompilationStats(); });
+  stats.wall_time_ns += wall_time_ns;
+  stats.cpu_time_ns += cpu_time_ns;
+}
+
+void JitCodeCache::DumpMethodCompilationStats(std::ostream& os) {
+  static constexpr size_t kNumberOfMethodsToDump = 10u;
+  std::vector<std::pair<ArtMethod*, MethodCompilationStats>> all_stats;
+  {
+    MutexLock mu(Thread::Current(), *Locks::jit_lock_);
+    all_stats.assign(method_compilation_stats_.begin(), method_compilation_stats_.end());
+  }
+  auto dump_top = [&](const char* title, auto greater) REQUIRES_SHARED(Locks::mutator_lock_) {
+    size_t count = std::min(kNumberOfMethodsToDump, all_stats.size());
+    std::partial_sort(all_stats.begin(), all_stats.begin() + count, all_stats.end(), greater);
+    os << "Top JIT methods by " << title << ":\n";
+    for (size_t i = 0; i != count; ++i) {
+      const MethodCompilationStats& stats = all_stats[i].second;
+      os << "  " << ArtMethod::PrettyMethod(all_stats[i].first)
+         << ": code=" << PrettySize(stats.code_size)
+         << " stack_maps=" << PrettySize(stats.stack_map_size)
+         << " compile_time=" << PrettyDuration(stats.wall_time_ns)
+         << " compile_cpu_time=" << PrettyDuration(stats.cpu_time_ns)
+         << " compilations=" << stats.compilations
+         << " deoptimizations=" << stats.deoptimizations << "\n";
+    }
+  };
+  dump_top("code size", [](const auto& lhs, const auto& rhs) {
+    return lhs.second.code_size + lhs.second.stack_map_size >
+           rhs.second.code_size + rhs.second.stack_map_size;
+  });
+  dump_top("compile time", [](const auto& lhs, const auto& rhs) {
+    return lhs.second.wall_time_ns > rhs.second.wall_time_ns;
+  });
 }
 
 void JitCodeCache::Dump(std::ostream& os) {
@@ -1918,6 +2138,7 @@ void JitCodeCache::PostForkChildAction(bool is_system_server, bool is_zygote) {
   histogram_stack_map_memory_use_.Reset();
   histogram_code_memory_use_.Reset();
   histogram_profiling_info_memory_use_.Reset();
+  method_compilation_stats_.clear();
 
   size_t initial_capacity = runtime->GetJITOptions()->GetCodeCacheInitialCapacity();
   size_t max_capacity = runtime->GetJITOptions()->GetCodeCacheMaxCapacity();
@@ -2029,11 +2250,14 @@ const void* ZygoteMap::GetCodeFor(ArtMethod* method, uintptr_t pc) const {
   }
 }
 
+bool ZygoteMap::IsFull() const {
+  // Stay under 90% load, so that lookups remain short and terminate.
+  return (size_ + 1u) * 10u > map_.size() * 9u;
+}
+
 void ZygoteMap::Put(const void* code, ArtMethod* method) {
-  if (map_.empty()) {
-    return;
-  }
   CHECK(Runtime::Current()->IsZygote());
+  CHECK(!IsFull());
   std::hash<ArtMethod*> hf;
   size_t index = hf(method) & (map_.size() - 1);
   size_t original_index = index;
@@ -2051,6 +2275,7 @@ void ZygoteMap::Put(const void* code, ArtMethod* method) {
     index = (index + 1) & (map_.size() - 1);
     DCHECK_NE(original_index, index);
   }
+  ++size_;
   DCHECK_EQ(GetCodeFor(method), code);
 }
 
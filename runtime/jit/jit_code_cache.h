@@ -35,7 +35,10 @@
 #include "base/mutex.h"
 #include "base/safe_map.h"
 #include "compilation_kind.h"
+#include "debugger_interface.h"
+#include "jit_code_index.h"
 #include "jit_memory_region.h"
+#include "oat/jni_stub_hash_map.h"
 #include "profiling_info.h"
 
 namespace art HIDDEN {
@@ -117,13 +120,18 @@ class ZygoteMap {
   };
 
   explicit ZygoteMap(JitMemoryRegion* region)
-      : map_(), region_(region), compilation_state_(nullptr) {}
+      : map_(), size_(0u), region_(region), compilation_state_(nullptr) {}
 
   // Initialize the data structure so it can hold `number_of_methods` mappings.
   // Note that the map is fixed size and never grows.
   void Initialize(uint32_t number_of_methods) REQUIRES(!Locks::jit_lock_);
 
-  // Add the mapping method -> code.
+  // Return whether the map cannot take another mapping. The map is sized for the
+  // methods of the boot classpath profiles, but shared libraries preloaded by the
+  // zygote add to it afterwards.
+  bool IsFull() const REQUIRES(Locks::jit_lock_);
+
+  // Add the mapping method -> code. The map must not be full.
   void Put(const void* code, ArtMethod* method) REQUIRES(Locks::jit_lock_);
 
   // Return the code pointer for the given method. If pc is not zero, check that
@@ -170,6 +178,9 @@ class ZygoteMap {
   // The map allocated with `region_`.
   ArrayRef<const Entry> map_;
 
+  // The number of entries added to `map_`. Only used by the zygote.
+  size_t size_;
+
   // The region in which the map is allocated.
   JitMemoryRegion* const region_;
 
@@ -247,13 +258,15 @@ class JitCodeCache {
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::jit_lock_);
 
   // Allocate a region for both code and data in the JIT code cache.
-  // The reserved memory is left completely uninitialized.
+  // The reserved memory is left completely uninitialized. Baseline code is
+  // allocated in the cold code space of the region, if any.
   bool Reserve(Thread* self,
                JitMemoryRegion* region,
                size_t code_size,
                size_t stack_map_size,
                size_t number_of_roots,
                ArtMethod* method,
+               CompilationKind compilation_kind,
                /*out*/ArrayRef<const uint8_t>* reserved_code,
                /*out*/ArrayRef<const uint8_t>* reserved_data)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -275,6 +288,7 @@ class JitCodeCache {
               const std::vector<Handle<mirror::Object>>& roots,
               ArrayRef<const uint8_t> stack_map,  // Compiler output (source).
               const std::vector<uint8_t>& debug_info,
+              JitDebugInfoGenerator&& lazy_debug_info,  // Used if `debug_info` is empty.
               bool is_full_debug_info,
               CompilationKind compilation_kind,
               const ArenaSet<ArtMethod*>& cha_single_implementation_list)
@@ -350,7 +364,22 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Invalidate the compiled code of all methods that inlined `inlined`.
+  void InvalidateCompiledCodeThatInlined(ArtMethod* inlined)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void Dump(std::ostream& os) REQUIRES(!Locks::jit_lock_);
+
+  // Dump the methods that take the most code cache space and compile time.
+  void DumpMethodCompilationStats(std::ostream& os)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Record that compiling `method` took `wall_time_ns`, `cpu_time_ns` of which
+  // on the CPU.
+  void AddCompilationTime(ArtMethod* method, uint64_t wall_time_ns, uint64_t cpu_time_ns)
+      REQUIRES(!Locks::jit_lock_);
   void DumpAllCompiledMethods(std::ostream& os)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -426,6 +455,14 @@ class JitCodeCache {
                               Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Halve the hotness accumulated by baseline compiled code in all profiling infos.
+  void DecayBaselineHotnessCounts(Thread* self) REQUIRES(!Locks::jit_lock_);
+
+  // Record in the profiling info of `method` that its compiled code deoptimized
+  // because of `kind`, so the next compilation avoids that speculation.
+  void RecordDeoptimization(ArtMethod* method, DeoptimizationKind kind, Thread* self)
+      REQUIRES(!Locks::jit_lock_);
+
   // NO_THREAD_SAFETY_ANALYSIS because we may be called with the JIT lock held
   // or not. The implementation of this method handles the two cases.
   void AddZombieCode(ArtMethod* method, const void* code_ptr) NO_THREAD_SAFETY_ANALYSIS;
@@ -433,6 +470,16 @@ class JitCodeCache {
   EXPORT void DoCollection(Thread* self)
       REQUIRES(!Locks::jit_lock_);
 
+  // Called under memory pressure. Discard the baseline code of methods that did
+  // not run it since the previous trim, collect the code cache, and give the
+  // memory it no longer uses back to the system.
+  EXPORT void TrimMemory(Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES(!Locks::mutator_lock_);
+
+  // Run `TrimMemory()` on the JIT thread pool.
+  EXPORT void RequestTrim(Thread* self);
+
  private:
   JitCodeCache();
 
@@ -513,7 +560,6 @@ class JitCodeCache {
 
   EXPORT const uint8_t* GetRootTable(const void* code_ptr, uint32_t* number_of_roots = nullptr);
 
-  class JniStubKey;
   class JniStubData;
 
   // Whether the GC allows accessing weaks in inline caches. Note that this
@@ -548,8 +594,9 @@ class JitCodeCache {
   // The GC must ensure that methods in these maps are cleaned up with `RemoveMethodsIn()`
   // before the declaring class memory is freed.
 
-  // Holds compiled code associated with the shorty for a JNI stub.
-  SafeMap<JniStubKey, JniStubData> jni_stubs_map_ GUARDED_BY(Locks::jit_mutator_lock_);
+  // Holds compiled code associated with the shorty and flags for a JNI stub. Methods with
+  // different shorties share a stub if the stub would be the same for the runtime ISA.
+  JniStubHashMap<JniStubData> jni_stubs_map_ GUARDED_BY(Locks::jit_mutator_lock_);
 
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_mutator_lock_);
@@ -557,6 +604,9 @@ class JitCodeCache {
   // objects (like `MethodType`-s) as strongly reachable from the corresponding ArtMethod.
   SafeMap<ArtMethod*, std::vector<const void*>> method_code_map_reversed_
       GUARDED_BY(Locks::jit_mutator_lock_);
+  // Copy of `method_code_map_` that `LookupMethodHeader()` can search without
+  // locking. Updated with `Locks::jit_mutator_lock_` held exclusively.
+  JitCodeIndex code_index_;
 
   // Holds compiled code associated to the ArtMethod. Used when pre-jitting
   // methods whose entrypoints have the resolution stub.
@@ -621,6 +671,21 @@ class JitCodeCache {
   // Histograms for keeping track of profiling info statistics.
   Histogram<uint64_t> histogram_profiling_info_memory_use_ GUARDED_BY(Locks::jit_lock_);
 
+  // Compilation statistics of a method.
+  struct MethodCompilationStats {
+    uint64_t wall_time_ns = 0u;     // Of all compilations.
+    uint64_t cpu_time_ns = 0u;      // Of all compilations.
+    uint32_t code_size = 0u;        // Of the last compilation.
+    uint32_t stack_map_size = 0u;   // Of the last compilation, including the roots.
+    uint32_t compilations = 0u;
+    uint32_t deoptimizations = 0u;  // Invalidations of the compiled code.
+  };
+
+  // Per-method compilation statistics, to find the methods that dominate the
+  // code cache size or the JIT compile time.
+  SafeMap<ArtMethod*, MethodCompilationStats> method_compilation_stats_
+      GUARDED_BY(Locks::jit_lock_);
+
   friend class ScopedCodeCacheWrite;
   friend class MarkCodeClosure;
 
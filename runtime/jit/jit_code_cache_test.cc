@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit/jit_code_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "art_method-inl.h"
+#include "class_linker.h"
+#include "common_runtime_test.h"
+#include "handle_scope-inl.h"
+#include "jit/jit.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "oat/oat_quick_method_header.h"
+#include "profile/profile_compilation_info.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+class ZygoteJitCodeCacheTest : public CommonRuntimeTest {
+ public:
+  ZygoteJitCodeCacheTest() {
+    use_boot_image_ = true;  // Shared code can only refer to boot image classes.
+  }
+
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    // Reset the callbacks so that the runtime doesn't think it's for AOT.
+    callbacks_ = nullptr;
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-Xzygote", nullptr));
+    options->push_back(std::make_pair("-Xusejit:true", nullptr));
+  }
+
+  // Return whether the zygote JIT is available, and leaves the zygote map to the test.
+  static bool HasZygoteJit() {
+    Jit* jit = Runtime::Current()->GetJit();
+    return jit != nullptr && jit->UseJitCompilation() && !Jit::InZygoteUsingJit();
+  }
+
+  // Compile the methods of a shared library from its profile into the shared region,
+  // as the zygote does for the dex files of a non-boot class loader, see
+  // `JitProfileTask`. The zygote map is sized for `number_of_methods`.
+  // Return the methods of the profile.
+  std::vector<ArtMethod*> CompileSharedLibraryProfile(uint32_t number_of_methods)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    Thread* self = Thread::Current();
+    Jit* jit = Runtime::Current()->GetJit();
+    jit->GetCodeCache()->GetZygoteMap()->Initialize(number_of_methods);
+
+    jobject jclass_loader = LoadDex("StaticLeafMethods");
+    StackHandleScope<2> hs(self);
+    Handle<mirror::ClassLoader> class_loader(hs.NewHandle(
+        ScopedObjectAccessUnchecked(self).Decode<mirror::ClassLoader>(jclass_loader)));
+    Handle<mirror::Class> klass(
+        hs.NewHandle(class_linker_->FindClass(self, "LStaticLeafMethods;", class_loader)));
+    CHECK(klass != nullptr);
+    const DexFile& dex_file = klass->GetDexFile();
+
+    std::vector<ArtMethod*> methods;
+    std::vector<uint16_t> method_indexes;
+    for (ArtMethod& method : klass->GetDeclaredMethods(kRuntimePointerSize)) {
+      methods.push_back(&method);
+      method_indexes.push_back(method.GetDexMethodIndex());
+    }
+    ProfileCompilationInfo profile_info;
+    CHECK(profile_info.AddMethodsForDex(ProfileCompilationInfo::MethodHotness::kFlagHot,
+                                        &dex_file,
+                                        method_indexes.begin(),
+                                        method_indexes.end()));
+    ScratchFile profile;
+    CHECK(profile_info.Save(profile.GetFd()));
+
+    jit->CompileMethodsFromProfile(self,
+                                   {&dex_file},
+                                   profile.GetFilename(),
+                                   class_loader,
+                                   /* add_to_queue= */ false);
+    return methods;
+  }
+};
+
+// Test that the zygote compiles the profile of a shared library into the shared region,
+// where its children find the code through the zygote map.
+TEST_F(ZygoteJitCodeCacheTest, CompileSharedLibraryProfile) {
+  if (!HasZygoteJit()) {
+    GTEST_SKIP() << "Needs the zygote JIT";
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  std::vector<ArtMethod*> methods = CompileSharedLibraryProfile(/* number_of_methods= */ 64u);
+  JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
+  ASSERT_FALSE(methods.empty());
+  for (ArtMethod* method : methods) {
+    EXPECT_TRUE(method->IsPreCompiled()) << method->PrettyMethod();
+    const void* code = code_cache->GetZygoteMap()->GetCodeFor(method);
+    ASSERT_NE(code, nullptr) << method->PrettyMethod();
+    EXPECT_TRUE(code_cache->IsInZygoteExecSpace(code));
+    EXPECT_EQ(OatQuickMethodHeader::FromCodePointer(code)->GetEntryPoint(),
+              code_cache->GetSavedEntryPointOfPreCompiledMethod(method));
+  }
+}
+
+// Test that the code of methods which do not fit in the zygote map is discarded, and
+// that the methods can be JIT compiled again.
+TEST_F(ZygoteJitCodeCacheTest, ZygoteMapFull) {
+  if (!HasZygoteJit()) {
+    GTEST_SKIP() << "Needs the zygote JIT";
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  // A map sized for two methods stays under its load limit with a single one.
+  std::vector<ArtMethod*> methods = CompileSharedLibraryProfile(/* number_of_methods= */ 2u);
+  JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
+  ASSERT_GT(methods.size(), 1u);
+  size_t num_in_zygote_map = 0u;
+  for (ArtMethod* method : methods) {
+    if (code_cache->GetZygoteMap()->ContainsMethod(method)) {
+      EXPECT_TRUE(method->IsPreCompiled()) << method->PrettyMethod();
+      ++num_in_zygote_map;
+    } else {
+      EXPECT_FALSE(method->IsPreCompiled()) << method->PrettyMethod();
+      EXPECT_EQ(nullptr, code_cache->GetSavedEntryPointOfPreCompiledMethod(method));
+      EXPECT_FALSE(
+          code_cache->IsInZygoteExecSpace(method->GetEntryPointFromQuickCompiledCode()));
+    }
+  }
+  EXPECT_EQ(1u, num_in_zygote_map);
+}
+
+}  // namespace jit
+}  // namespace art
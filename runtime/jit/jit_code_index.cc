@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_index.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace art HIDDEN {
+namespace jit {
+
+JitCodeIndex::JitCodeIndex() : sequence_(0u), array_(nullptr), size_(0u), current_(nullptr) {}
+
+JitCodeIndex::~JitCodeIndex() {}
+
+void JitCodeIndex::BeginWrite() {
+  uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  DCHECK_EQ(sequence & 1u, 0u);
+  sequence_.store(sequence + 1u, std::memory_order_relaxed);
+  // Order the odd sequence before the updates of the entries.
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void JitCodeIndex::EndWrite() {
+  uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  DCHECK_EQ(sequence & 1u, 1u);
+  sequence_.store(sequence + 1u, std::memory_order_release);
+}
+
+void JitCodeIndex::EnsureCapacity(size_t capacity) {
+  if (current_ != nullptr && current_->capacity >= capacity) {
+    return;
+  }
+  size_t new_capacity = std::max(kInitialCapacity, capacity);
+  if (current_ != nullptr) {
+    new_capacity = std::max(new_capacity, 2u * current_->capacity);
+  }
+  std::unique_ptr<Array> array = std::make_unique<Array>(new_capacity);
+  size_t size = size_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i != size; ++i) {
+    array->entries[i].code_ptr.store(
+        current_->entries[i].code_ptr.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    array->entries[i].method.store(
+        current_->entries[i].method.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  current_ = array.get();
+  // Publish the array with its capacity to readers.
+  array_.store(current_, std::memory_order_release);
+  // Readers which loaded the previous array may still search it.
+  arrays_.push_back(std::move(array));
+}
+
+size_t JitCodeIndex::UpperBound(const Entry* entries, size_t size, uintptr_t pc) {
+  size_t low = 0u;
+  size_t high = size;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2u;
+    uintptr_t code = reinterpret_cast<uintptr_t>(
+        entries[mid].code_ptr.load(std::memory_order_relaxed));
+    if (code <= pc) {
+      low = mid + 1u;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+void JitCodeIndex::Insert(const void* code_ptr, ArtMethod* method) {
+  BeginWrite();
+  size_t size = size_.load(std::memory_order_relaxed);
+  EnsureCapacity(size + 1u);
+  Entry* entries = current_->entries.get();
+  size_t pos = UpperBound(entries, size, reinterpret_cast<uintptr_t>(code_ptr));
+  DCHECK(pos == 0u || entries[pos - 1u].code_ptr.load(std::memory_order_relaxed) != code_ptr);
+  for (size_t i = size; i != pos; --i) {
+    entries[i].code_ptr.store(
+        entries[i - 1u].code_ptr.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    entries[i].method.store(
+        entries[i - 1u].method.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  entries[pos].code_ptr.store(code_ptr, std::memory_order_relaxed);
+  entries[pos].method.store(method, std::memory_order_relaxed);
+  size_.store(size + 1u, std::memory_order_relaxed);
+  EndWrite();
+}
+
+void JitCodeIndex::Remove(const void* code_ptr) {
+  size_t size = size_.load(std::memory_order_relaxed);
+  if (size == 0u) {
+    return;
+  }
+  Entry* entries = current_->entries.get();
+  size_t pos = UpperBound(entries, size, reinterpret_cast<uintptr_t>(code_ptr));
+  if (pos == 0u || entries[pos - 1u].code_ptr.load(std::memory_order_relaxed) != code_ptr) {
+    return;
+  }
+  BeginWrite();
+  for (size_t i = pos; i != size; ++i) {
+    entries[i - 1u].code_ptr.store(
+        entries[i].code_ptr.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    entries[i - 1u].method.store(
+        entries[i].method.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  size_.store(size - 1u, std::memory_order_relaxed);
+  EndWrite();
+}
+
+bool JitCodeIndex::Lookup(uintptr_t pc,
+                          /*out*/ const void** code_ptr,
+                          /*out*/ ArtMethod** method) const {
+  for (size_t attempt = 0; attempt != kMaxReadAttempts; ++attempt) {
+    uint32_t sequence = sequence_.load(std::memory_order_acquire);
+    if ((sequence & 1u) != 0u) {
+      continue;
+    }
+    const void* found_code = nullptr;
+    ArtMethod* found_method = nullptr;
+    const Array* array = array_.load(std::memory_order_acquire);
+    if (array != nullptr) {
+      // The size may belong to a newer array if we race with a writer, in which
+      // case the sequence check below will fail.
+      size_t size = std::min(size_.load(std::memory_order_relaxed), array->capacity);
+      const Entry* entries = array->entries.get();
+      size_t pos = UpperBound(entries, size, pc);
+      if (pos != 0u) {
+        found_code = entries[pos - 1u].code_ptr.load(std::memory_order_relaxed);
+        found_method = entries[pos - 1u].method.load(std::memory_order_relaxed);
+      }
+    }
+    // Order the reads of the entries before re-reading the sequence.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == sequence) {
+      *code_ptr = found_code;
+      *method = found_method;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
+#define ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+
+namespace jit {
+
+// A sorted array of JIT code pointers and their methods that stack walkers can
+// search without taking `Locks::jit_mutator_lock_`.
+//
+// Writers must be serialized by the caller. They bump a sequence counter around
+// each update; readers retry, and eventually give up, when they observe an odd
+// counter or a counter that changed during their search. Arrays replaced when
+// growing are kept until the index is destroyed, so a reader racing with a
+// writer only ever reads stale, never freed, memory. Since the array grows
+// geometrically, this keeps at most as many entries alive as the largest array.
+class JitCodeIndex {
+ public:
+  JitCodeIndex();
+  ~JitCodeIndex();
+
+  // Add `code_ptr`, which must not be in the index yet.
+  void Insert(const void* code_ptr, ArtMethod* method);
+
+  // Remove `code_ptr` if it is in the index.
+  void Remove(const void* code_ptr);
+
+  // Replace the contents of the index with the (code pointer, method) pairs of
+  // `map`, which must be sorted by code pointer. Used after bulk updates.
+  template <typename Map>
+  void Rebuild(const Map& map) {
+    BeginWrite();
+    EnsureCapacity(map.size());
+    Entry* entries = current_->entries.get();
+    size_t i = 0;
+    for (const auto& [code_ptr, method] : map) {
+      entries[i].code_ptr.store(code_ptr, std::memory_order_relaxed);
+      entries[i].method.store(method, std::memory_order_relaxed);
+      ++i;
+    }
+    size_.store(i, std::memory_order_relaxed);
+    EndWrite();
+  }
+
+  // Find the entry with the greatest code pointer that is not above `pc`, and
+  // store it in `code_ptr` and `method` (null if there is none). Return false if
+  // no consistent view of the index could be read because of concurrent updates.
+  bool Lookup(uintptr_t pc, /*out*/ const void** code_ptr, /*out*/ ArtMethod** method) const;
+
+  size_t Size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Entry {
+    std::atomic<const void*> code_ptr;
+    std::atomic<ArtMethod*> method;
+  };
+
+  struct Array {
+    explicit Array(size_t cap) : capacity(cap), entries(new Entry[cap]()) {}
+
+    const size_t capacity;
+    const std::unique_ptr<Entry[]> entries;
+  };
+
+  // Number of times a reader retries before giving up.
+  static constexpr size_t kMaxReadAttempts = 4;
+
+  static constexpr size_t kInitialCapacity = 64;
+
+  void BeginWrite();
+  void EndWrite();
+
+  // Make sure the current array can hold `capacity` entries. Must be called
+  // between BeginWrite() and EndWrite().
+  void EnsureCapacity(size_t capacity);
+
+  // Return the index of the first entry whose code pointer is above `pc`.
+  static size_t UpperBound(const Entry* entries, size_t size, uintptr_t pc);
+
+  std::atomic<uint32_t> sequence_;
+  std::atomic<Array*> array_;
+  std::atomic<size_t> size_;
+
+  // The array writers update. Also in `arrays_`.
+  Array* current_;
+
+  // All the arrays allocated, including the retired ones.
+  std::vector<std::unique_ptr<Array>> arrays_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitCodeIndex);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_CODE_INDEX_H_
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit/jit_code_index.h"
+
+#include <map>
+
+#include <gtest/gtest.h>
+
+namespace art HIDDEN {
+namespace jit {
+
+// Mocks some code pointers and methods.
+static const void* Code(uintptr_t address) {
+  return reinterpret_cast<const void*>(address);
+}
+
+static ArtMethod* Method(uintptr_t address) {
+  return reinterpret_cast<ArtMethod*>(address);
+}
+
+static void ExpectLookup(const JitCodeIndex& index,
+                         uintptr_t pc,
+                         const void* expected_code,
+                         ArtMethod* expected_method) {
+  const void* code_ptr = Code(1u);
+  ArtMethod* method = Method(1u);
+  ASSERT_TRUE(index.Lookup(pc, &code_ptr, &method));
+  EXPECT_EQ(code_ptr, expected_code) << pc;
+  EXPECT_EQ(method, expected_method) << pc;
+}
+
+TEST(JitCodeIndexTest, Empty) {
+  JitCodeIndex index;
+  EXPECT_EQ(index.Size(), 0u);
+  ExpectLookup(index, 0x1000u, nullptr, nullptr);
+  index.Remove(Code(0x1000u));
+  EXPECT_EQ(index.Size(), 0u);
+}
+
+TEST(JitCodeIndexTest, InsertAndRemove) {
+  JitCodeIndex index;
+  index.Insert(Code(0x2000u), Method(0x20u));
+  index.Insert(Code(0x1000u), Method(0x10u));
+  index.Insert(Code(0x3000u), Method(0x30u));
+  EXPECT_EQ(index.Size(), 3u);
+
+  ExpectLookup(index, 0x0fffu, nullptr, nullptr);
+  ExpectLookup(index, 0x1000u, Code(0x1000u), Method(0x10u));
+  ExpectLookup(index, 0x1fffu, Code(0x1000u), Method(0x10u));
+  ExpectLookup(index, 0x2000u, Code(0x2000u), Method(0x20u));
+  ExpectLookup(index, 0x5000u, Code(0x3000u), Method(0x30u));
+
+  index.Remove(Code(0x2000u));
+  EXPECT_EQ(index.Size(), 2u);
+  ExpectLookup(index, 0x2800u, Code(0x1000u), Method(0x10u));
+
+  // Removing code that is not in the index does nothing.
+  index.Remove(Code(0x2800u));
+  EXPECT_EQ(index.Size(), 2u);
+
+  index.Remove(Code(0x1000u));
+  ExpectLookup(index, 0x1800u, nullptr, nullptr);
+  ExpectLookup(index, 0x3800u, Code(0x3000u), Method(0x30u));
+}
+
+TEST(JitCodeIndexTest, Grow) {
+  JitCodeIndex index;
+  static constexpr size_t kNumberOfEntries = 1000u;
+  for (size_t i = 0; i != kNumberOfEntries; ++i) {
+    // Insert in a scrambled order.
+    uintptr_t address = 0x1000u + ((i * 7u) % kNumberOfEntries) * 0x100u;
+    index.Insert(Code(address), Method(address / 0x10u));
+  }
+  EXPECT_EQ(index.Size(), kNumberOfEntries);
+  for (size_t i = 0; i != kNumberOfEntries; ++i) {
+    uintptr_t address = 0x1000u + i * 0x100u;
+    ExpectLookup(index, address + 0x80u, Code(address), Method(address / 0x10u));
+  }
+}
+
+TEST(JitCodeIndexTest, Rebuild) {
+  JitCodeIndex index;
+  index.Insert(Code(0x1000u), Method(0x10u));
+  std::map<const void*, ArtMethod*> map = {
+      {Code(0x2000u), Method(0x20u)},
+      {Code(0x4000u), Method(0x40u)},
+  };
+  index.Rebuild(map);
+  EXPECT_EQ(index.Size(), 2u);
+  ExpectLookup(index, 0x1800u, nullptr, nullptr);
+  ExpectLookup(index, 0x3000u, Code(0x2000u), Method(0x20u));
+  ExpectLookup(index, 0x4000u, Code(0x4000u), Method(0x40u));
+}
+
+}  // namespace jit
+}  // namespace art
@@ -31,6 +31,7 @@
 #include "jit/jit_scoped_code_cache_write.h"
 #include "oat/oat_quick_method_header.h"
 #include "palette/palette.h"
+#include "thread-current-inl.h"
 
 using android::base::unique_fd;
 
@@ -42,6 +43,10 @@ namespace jit {
 // TODO: Make this adjustable. Currently must be 2. JitCodeCache relies on that.
 static constexpr size_t kCodeAndDataCapacityDivider = 2;
 
+// Part of the code capacity reserved for cold code (baseline code), which is
+// kept apart so that freeing it doesn't leave holes between hot methods.
+static constexpr size_t kColdCodeCapacityDivider = 4;
+
 bool JitMemoryRegion::Initialize(size_t initial_capacity,
                                  size_t max_capacity,
                                  bool rwx_memory_allowed,
@@ -292,6 +297,17 @@ bool JitMemoryRegion::Initialize(size_t initial_capacity,
     {
       ScopedCodeCacheWrite scc(*this);
       exec_mspace_ = create_mspace_with_base(code_heap->Begin(), exec_end_, false /*locked*/);
+      // The zygote doesn't collect code, so there is no point in segregating
+      // cold code there.
+      size_t cold_capacity = RoundDown(code_heap->Size() / kColdCodeCapacityDivider, gPageSize);
+      if (!is_zygote && cold_capacity >= gPageSize &&
+          exec_end_ <= code_heap->Size() - cold_capacity) {
+        cold_exec_begin_ = code_heap->Size() - cold_capacity;
+        cold_exec_end_ = gPageSize;
+        cold_exec_mspace_ = create_mspace_with_base(
+            code_heap->Begin() + cold_exec_begin_, cold_exec_end_, false /*locked*/);
+        CHECK(cold_exec_mspace_ != nullptr) << "create_mspace_with_base (cold exec) failed";
+      }
     }
     CHECK(exec_mspace_ != nullptr) << "create_mspace_with_base (exec) failed";
     SetFootprintLimit(current_capacity_);
@@ -308,7 +324,16 @@ void JitMemoryRegion::SetFootprintLimit(size_t new_footprint) {
   DCHECK_EQ(data_space_footprint * kCodeAndDataCapacityDivider, new_footprint);
   if (HasCodeMapping()) {
     ScopedCodeCacheWrite scc(*this);
-    mspace_set_footprint_limit(exec_mspace_, new_footprint - data_space_footprint);
+    size_t code_space_footprint = new_footprint - data_space_footprint;
+    if (cold_exec_mspace_ != nullptr) {
+      size_t cold_space_footprint =
+          std::max(RoundDown(code_space_footprint / kColdCodeCapacityDivider, gPageSize),
+                   gPageSize);
+      DCHECK_LE(cold_space_footprint, code_space_footprint);
+      mspace_set_footprint_limit(cold_exec_mspace_, cold_space_footprint);
+      code_space_footprint -= cold_space_footprint;
+    }
+    mspace_set_footprint_limit(exec_mspace_, code_space_footprint);
   }
 }
 
@@ -335,6 +360,75 @@ bool JitMemoryRegion::IncreaseCodeCacheCapacity() {
   return true;
 }
 
+bool JitMemoryRegion::FitsInCapacity(size_t capacity) const {
+  size_t data_space_footprint = capacity / kCodeAndDataCapacityDivider;
+  if (data_end_ > data_space_footprint) {
+    return false;
+  }
+  size_t code_space_footprint = capacity - data_space_footprint;
+  if (cold_exec_mspace_ != nullptr) {
+    // Must match the split done in `SetFootprintLimit()`.
+    size_t cold_space_footprint =
+        std::max(RoundDown(code_space_footprint / kColdCodeCapacityDivider, gPageSize), gPageSize);
+    if (cold_exec_end_ > cold_space_footprint) {
+      return false;
+    }
+    code_space_footprint -= cold_space_footprint;
+  }
+  return exec_mspace_ == nullptr || exec_end_ <= code_space_footprint;
+}
+
+bool JitMemoryRegion::ShrinkCodeCacheCapacity() {
+  size_t capacity = initial_capacity_;
+  while (capacity < current_capacity_ && !FitsInCapacity(capacity)) {
+    // Follow the steps of `IncreaseCodeCacheCapacity()`.
+    capacity = (capacity < 1 * MB) ? capacity * 2 : capacity + 1 * MB;
+  }
+  if (capacity >= current_capacity_) {
+    return false;
+  }
+  VLOG(jit) << "Decreasing code cache capacity to " << PrettySize(capacity);
+  current_capacity_ = capacity;
+  SetFootprintLimit(current_capacity_);
+  return true;
+}
+
+// Callback for mspace_inspect_all that gives the whole pages of free chunks
+// back to the kernel.
+static void ReleaseFreePagesCallback(void* start, void* end, size_t used_bytes, void* arg) {
+  if (used_bytes != 0) {
+    return;
+  }
+  uint8_t* begin = AlignUp(reinterpret_cast<uint8_t*>(start), gPageSize);
+  uint8_t* limit = AlignDown(reinterpret_cast<uint8_t*>(end), gPageSize);
+  if (limit <= begin) {
+    return;
+  }
+  size_t length = limit - begin;
+  // The region is usually backed by a memfd, whose pages MADV_DONTNEED would
+  // only unmap. Fall back to it for anonymous memory.
+  if (madvise(begin, length, MADV_REMOVE) != 0) {
+    CheckedCall(madvise, "release JIT pages", begin, length, MADV_DONTNEED);
+  }
+  *reinterpret_cast<size_t*>(arg) += length;
+}
+
+size_t JitMemoryRegion::ReleaseUnusedMemory() {
+  size_t released = 0u;
+  if (data_mspace_ != nullptr) {
+    mspace_inspect_all(data_mspace_, ReleaseFreePagesCallback, &released);
+  }
+  if (HasCodeMapping()) {
+    // The spaces are accessed through the writable view of the code.
+    ScopedCodeCacheWrite scc(*this);
+    mspace_inspect_all(exec_mspace_, ReleaseFreePagesCallback, &released);
+    if (cold_exec_mspace_ != nullptr) {
+      mspace_inspect_all(cold_exec_mspace_, ReleaseFreePagesCallback, &released);
+    }
+  }
+  return released;
+}
+
 // NO_THREAD_SAFETY_ANALYSIS as this is called from mspace code, at which point the lock
 // is already held.
 void* JitMemoryRegion::MoreCore(const void* mspace, intptr_t increment) NO_THREAD_SAFETY_ANALYSIS {
@@ -343,6 +437,13 @@ void* JitMemoryRegion::MoreCore(const void* mspace, intptr_t increment) NO_THREA
     const MemMap* const code_pages = GetUpdatableCodeMapping();
     void* result = code_pages->Begin() + exec_end_;
     exec_end_ += increment;
+    DCHECK(cold_exec_mspace_ == nullptr || exec_end_ <= cold_exec_begin_);
+    return result;
+  } else if (mspace == cold_exec_mspace_) {
+    const MemMap* const code_pages = GetUpdatableCodeMapping();
+    void* result = code_pages->Begin() + cold_exec_begin_ + cold_exec_end_;
+    cold_exec_end_ += increment;
+    DCHECK_LE(cold_exec_begin_ + cold_exec_end_, code_pages->Size());
     return result;
   } else {
     CHECK_EQ(data_mspace_, mspace);
@@ -355,7 +456,8 @@ void* JitMemoryRegion::MoreCore(const void* mspace, intptr_t increment) NO_THREA
 
 const uint8_t* JitMemoryRegion::CommitCode(ArrayRef<const uint8_t> reserved_code,
                                            ArrayRef<const uint8_t> code,
-                                           const uint8_t* stack_map) {
+                                           const uint8_t* stack_map,
+                                           /*out*/ uint64_t* commit_number) {
   DCHECK(IsInExecSpace(reserved_code.data()));
   ScopedCodeCacheWrite scc(*this);
 
@@ -415,6 +517,21 @@ const uint8_t* JitMemoryRegion::CommitCode(ArrayRef<const uint8_t> reserved_code
     return nullptr;
   }
 
+  // The release order publishes the code to the `SyncCores()` call that reads the new count.
+  *commit_number = num_code_commits_.fetch_add(1u, std::memory_order_release) + 1u;
+  return result;
+}
+
+void JitMemoryRegion::SyncCores(uint64_t commit_number) {
+  Thread* self = Thread::Current();
+  MutexLock mu(self, sync_cores_lock_);
+  if (num_synced_code_commits_ >= commit_number) {
+    // The membarrier of another thread, which we waited for, already covered our code.
+    return;
+  }
+  uint64_t num_commits = num_code_commits_.load(std::memory_order_acquire);
+  DCHECK_GE(num_commits, commit_number);
+
   // Ensure CPU instruction pipelines are flushed for all cores. This is necessary for
   // correctness as code may still be in instruction pipelines despite the i-cache flush. It is
   // not safe to assume that changing permissions with mprotect (RX->RWX->RX) will cause a TLB
@@ -425,8 +542,7 @@ const uint8_t* JitMemoryRegion::CommitCode(ArrayRef<const uint8_t> reserved_code
   // address this (see mbarrier(2)). The membarrier here will fail on prior kernels and on
   // platforms lacking the appropriate support.
   art::membarrier(art::MembarrierCommand::kPrivateExpeditedSyncCore);
-
-  return result;
+  num_synced_code_commits_ = num_commits;
 }
 
 static void FillRootTable(uint8_t* roots_data, const std::vector<Handle<mirror::Object>>& roots)
@@ -463,11 +579,24 @@ bool JitMemoryRegion::CommitData(ArrayRef<const uint8_t> reserved_data,
   return true;
 }
 
-const uint8_t* JitMemoryRegion::AllocateCode(size_t size) {
+const uint8_t* JitMemoryRegion::AllocateCode(size_t size, bool is_cold) {
   size_t alignment = GetInstructionSetCodeAlignment(kRuntimeISA);
-  void* result = mspace_memalign(exec_mspace_, alignment, size);
+  void* preferred_mspace = exec_mspace_;
+  void* fallback_mspace = cold_exec_mspace_;
+  if (is_cold && cold_exec_mspace_ != nullptr) {
+    std::swap(preferred_mspace, fallback_mspace);
+  }
+  void* result = mspace_memalign(preferred_mspace, alignment, size);
   if (UNLIKELY(result == nullptr)) {
-    return nullptr;
+    // Use the other space before asking for more capacity, so that
+    // segregating cold code doesn't reduce the usable capacity.
+    if (fallback_mspace == nullptr) {
+      return nullptr;
+    }
+    result = mspace_memalign(fallback_mspace, alignment, size);
+    if (result == nullptr) {
+      return nullptr;
+    }
   }
   used_memory_for_code_ += mspace_usable_size(result);
   return reinterpret_cast<uint8_t*>(GetExecutableAddress(result));
@@ -476,7 +605,8 @@ const uint8_t* JitMemoryRegion::AllocateCode(size_t size) {
 void JitMemoryRegion::FreeCode(const uint8_t* code) {
   code = GetNonExecutableAddress(code);
   used_memory_for_code_ -= mspace_usable_size(code);
-  mspace_free(exec_mspace_, const_cast<uint8_t*>(code));
+  mspace_free(IsInColdCodeSpace(code) ? cold_exec_mspace_ : exec_mspace_,
+              const_cast<uint8_t*>(code));
 }
 
 const uint8_t* JitMemoryRegion::AllocateData(size_t data_size) {
@@ -17,12 +17,14 @@
 #ifndef ART_RUNTIME_JIT_JIT_MEMORY_REGION_H_
 #define ART_RUNTIME_JIT_JIT_MEMORY_REGION_H_
 
+#include <atomic>
 #include <string>
 
 #include "arch/instruction_set.h"
 #include "base/globals.h"
 #include "base/locks.h"
 #include "base/mem_map.h"
+#include "base/mutex.h"
 #include "gc_root-inl.h"
 #include "handle.h"
 
@@ -56,6 +58,8 @@ class JitMemoryRegion {
         current_capacity_(0),
         data_end_(0),
         exec_end_(0),
+        cold_exec_begin_(0),
+        cold_exec_end_(0),
         used_memory_for_code_(0),
         used_memory_for_data_(0),
         data_pages_(),
@@ -63,7 +67,11 @@ class JitMemoryRegion {
         exec_pages_(),
         non_exec_pages_(),
         data_mspace_(nullptr),
-        exec_mspace_(nullptr) {}
+        exec_mspace_(nullptr),
+        cold_exec_mspace_(nullptr),
+        num_code_commits_(0u),
+        sync_cores_lock_("JIT sync cores lock", kGenericBottomLock),
+        num_synced_code_commits_(0u) {}
 
   bool Initialize(size_t initial_capacity,
                   size_t max_capacity,
@@ -79,7 +87,19 @@ class JitMemoryRegion {
   // Set the footprint limit of the code cache.
   void SetFootprintLimit(size_t new_footprint) REQUIRES(Locks::jit_lock_);
 
-  const uint8_t* AllocateCode(size_t code_size) REQUIRES(Locks::jit_lock_);
+  // Lower the current capacity to the smallest capacity, on the growth path of
+  // `IncreaseCodeCacheCapacity()`, that still holds the memory used by the spaces.
+  // Return whether the capacity changed.
+  bool ShrinkCodeCacheCapacity() REQUIRES(Locks::jit_lock_);
+
+  // Give back to the kernel the whole pages of free memory in the spaces.
+  // Return the number of bytes released.
+  size_t ReleaseUnusedMemory() REQUIRES(Locks::jit_lock_);
+
+  // Allocate code. Code expected to be short-lived or rarely executed, like
+  // baseline code, should pass `is_cold` so that it gets allocated away from
+  // the long-lived hot code, keeping the latter packed.
+  const uint8_t* AllocateCode(size_t code_size, bool is_cold) REQUIRES(Locks::jit_lock_);
   void FreeCode(const uint8_t* code) REQUIRES(Locks::jit_lock_);
   const uint8_t* AllocateData(size_t data_size) REQUIRES(Locks::jit_lock_);
   void FreeData(const uint8_t* data) REQUIRES(Locks::jit_lock_);
@@ -88,11 +108,20 @@ class JitMemoryRegion {
 
   // Emit header and code into the memory pointed by `reserved_code` (despite it being const).
   // Returns pointer to copied code (within reserved_code region; after OatQuickMethodHeader).
+  // The code must not be made executable before `SyncCores()` has been called with the
+  // `commit_number` passed back.
   const uint8_t* CommitCode(ArrayRef<const uint8_t> reserved_code,
                             ArrayRef<const uint8_t> code,
-                            const uint8_t* stack_map)
+                            const uint8_t* stack_map,
+                            /*out*/ uint64_t* commit_number)
       REQUIRES(Locks::jit_lock_);
 
+  // Ensure the instruction pipelines of all cores see the code of `CommitCode()` call number
+  // `commit_number`. Concurrent callers are batched, so that a single membarrier covers all the
+  // code committed before it starts. Should be called without holding the JIT lock, so that
+  // other threads can commit while a membarrier is in progress.
+  void SyncCores(uint64_t commit_number) REQUIRES(!Locks::jit_lock_, !sync_cores_lock_);
+
   // Emit roots and stack map into the memory pointed by `roots_data` (despite it being const).
   bool CommitData(ArrayRef<const uint8_t> reserved_data,
                   const std::vector<Handle<mirror::Object>>& roots,
@@ -106,6 +135,7 @@ class JitMemoryRegion {
     // Also clear the mspaces, which, in their implementation,
     // point to the discarded mappings.
     exec_mspace_ = nullptr;
+    cold_exec_mspace_ = nullptr;
     data_mspace_ = nullptr;
   }
 
@@ -152,7 +182,7 @@ class JitMemoryRegion {
   void* MoreCore(const void* mspace, intptr_t increment);
 
   bool OwnsSpace(const void* mspace) const NO_THREAD_SAFETY_ANALYSIS {
-    return mspace == data_mspace_ || mspace == exec_mspace_;
+    return mspace == data_mspace_ || mspace == exec_mspace_ || mspace == cold_exec_mspace_;
   }
 
   size_t GetCurrentCapacity() const REQUIRES(Locks::jit_lock_) {
@@ -168,7 +198,7 @@ class JitMemoryRegion {
   }
 
   size_t GetResidentMemoryForCode() const REQUIRES(Locks::jit_lock_) {
-    return exec_end_;
+    return exec_end_ + cold_exec_end_;
   }
 
   size_t GetUsedMemoryForData() const REQUIRES(Locks::jit_lock_) {
@@ -187,6 +217,13 @@ class JitMemoryRegion {
   }
 
  private:
+  // Returns whether the non-executable address `ptr` was allocated in the cold code space.
+  bool IsInColdCodeSpace(const void* ptr) const REQUIRES(Locks::jit_lock_) {
+    return cold_exec_mspace_ != nullptr &&
+        reinterpret_cast<const uint8_t*>(ptr) >=
+            GetUpdatableCodeMapping()->Begin() + cold_exec_begin_;
+  }
+
   template <typename T>
   T* TranslateAddress(T* src_ptr, const MemMap& src, const MemMap& dst) {
     CHECK(src.HasAddress(src_ptr)) << reinterpret_cast<const void*>(src_ptr);
@@ -233,6 +270,9 @@ class JitMemoryRegion {
     return TranslateAddress(src_ptr, exec_pages_, non_exec_pages_);
   }
 
+  // Return whether the spaces' footprints fit in `capacity`.
+  bool FitsInCapacity(size_t capacity) const REQUIRES(Locks::jit_lock_);
+
   static int CreateZygoteMemory(size_t capacity, std::string* error_msg);
   static bool ProtectZygoteMemory(int fd, std::string* error_msg);
 
@@ -251,6 +291,12 @@ class JitMemoryRegion {
   // The current footprint in bytes of the code portion of the region.
   size_t exec_end_ GUARDED_BY(Locks::jit_lock_);
 
+  // The offset in bytes of the cold code space within the code portion of the region.
+  size_t cold_exec_begin_ GUARDED_BY(Locks::jit_lock_);
+
+  // The current footprint in bytes of the cold code space.
+  size_t cold_exec_end_ GUARDED_BY(Locks::jit_lock_);
+
   // The size in bytes of used memory for the code portion of the region.
   size_t used_memory_for_code_ GUARDED_BY(Locks::jit_lock_);
 
@@ -277,6 +323,19 @@ class JitMemoryRegion {
   // The opaque mspace for allocating code.
   void* exec_mspace_ GUARDED_BY(Locks::jit_lock_);
 
+  // The opaque mspace for allocating cold code, placed at the end of the code
+  // portion. Null if the region doesn't segregate cold code.
+  void* cold_exec_mspace_ GUARDED_BY(Locks::jit_lock_);
+
+  // The number of `CommitCode()` calls.
+  std::atomic<uint64_t> num_code_commits_;
+
+  // Serializes the membarriers of `SyncCores()`.
+  Mutex sync_cores_lock_;
+
+  // The number of `CommitCode()` calls whose code all cores are known to see.
+  uint64_t num_synced_code_commits_ GUARDED_BY(sync_cores_lock_);
+
   friend class ScopedCodeCacheWrite;  // For GetUpdatableCodeMapping
   friend class TestZygoteMemory;
 };
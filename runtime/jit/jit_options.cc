@@ -48,6 +48,14 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   jit_options->use_jit_compilation_ = options.GetOrDefault(RuntimeArgumentMap::UseJitCompilation);
   jit_options->use_profiled_jit_compilation_ =
       options.GetOrDefault(RuntimeArgumentMap::UseProfiledJitCompilation);
+  jit_options->precompile_app_profile_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPrecompileAppProfile);
+  jit_options->preload_startup_classes_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPreloadStartupClasses);
+  jit_options->verify_classes_in_background_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITVerifyClassesInBackground);
+  jit_options->lazy_mini_debug_info_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITLazyMiniDebugInfo);
 
   jit_options->code_cache_initial_capacity_ =
       options.GetOrDefault(RuntimeArgumentMap::JITCodeCacheInitialCapacity);
@@ -61,6 +69,17 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->thread_pool_thread_count_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadCount);
+  jit_options->hotness_decay_period_ms_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITHotnessDecayPeriodMs);
+  if (jit_options->thread_pool_thread_count_ == 0) {
+    LOG(FATAL) << "Jit thread count cannot be 0.";
+  } else if (jit_options->thread_pool_thread_count_ > kJitPoolThreadMaxCount) {
+    LOG(WARNING) << "Jit thread count " << jit_options->thread_pool_thread_count_
+                 << " is above the maximum; using " << kJitPoolThreadMaxCount;
+    jit_options->thread_pool_thread_count_ = kJitPoolThreadMaxCount;
+  }
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ = kIsDebugBuild
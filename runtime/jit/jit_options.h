@@ -34,6 +34,10 @@ static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
 // 19 is the lowest background priority on device.
 // See android/os/Process.java.
 static constexpr int kJitZygotePoolThreadPthreadDefaultPriority = 19;
+// How many compiler threads the jit thread pool uses by default.
+static constexpr unsigned int kJitPoolThreadDefaultCount = 1;
+// Maximum permitted number of jit compiler threads.
+static constexpr unsigned int kJitPoolThreadMaxCount = 8;
 
 class JitOptions {
  public:
@@ -85,6 +89,17 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  size_t GetThreadPoolThreadCount() const {
+    return thread_pool_thread_count_;
+  }
+
+  // Period at which the samples accumulated in hotness counters are halved, so
+  // that only methods which stay hot reach the compilation thresholds. Zero
+  // disables the decay.
+  uint32_t GetHotnessDecayPeriodMs() const {
+    return hotness_decay_period_ms_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -93,6 +108,36 @@ class JitOptions {
     return use_profiled_jit_compilation_;
   }
 
+  // Whether apps should compile the methods of their saved profile which have
+  // no AOT code when the profile saver starts, instead of waiting for them to
+  // warm up again.
+  bool PrecompileAppProfile() const {
+    return precompile_app_profile_;
+  }
+
+  // Whether apps should load, and where it has no side effects initialize, the
+  // startup classes of their saved profile on the JIT threads when the profile
+  // saver starts, so that the main thread finds them ready.
+  bool PreloadStartupClasses() const {
+    return preload_startup_classes_;
+  }
+
+  // Whether apps should verify the classes of their dex files without a usable
+  // oat file on the JIT threads when the profile saver starts, so that the main
+  // thread finds them verified. Not done in runtimes that allow JVMTI agents.
+  bool VerifyClassesInBackground() const {
+    return verify_classes_in_background_;
+  }
+
+  // Whether the mini-debug-info of JIT compiled methods should be generated in
+  // batches, when the JIT becomes idle or before the runtime unwinds its own
+  // stack, instead of for every compiled method. Native tools attaching on their
+  // own, like profilers or debuggerd for a crash, do not see the methods compiled
+  // since the JIT was last idle.
+  bool LazyMiniDebugInfo() const {
+    return lazy_mini_debug_info_;
+  }
+
   void SetUseJitCompilation(bool b) {
     use_jit_compilation_ = b;
   }
@@ -125,6 +170,10 @@ class JitOptions {
 
   bool use_jit_compilation_;
   bool use_profiled_jit_compilation_;
+  bool precompile_app_profile_;
+  bool preload_startup_classes_;
+  bool verify_classes_in_background_;
+  bool lazy_mini_debug_info_;
   bool use_baseline_compiler_;
   size_t code_cache_initial_capacity_;
   size_t code_cache_max_capacity_;
@@ -135,11 +184,17 @@ class JitOptions {
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  size_t thread_pool_thread_count_;
+  uint32_t hotness_decay_period_ms_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
       : use_jit_compilation_(false),
         use_profiled_jit_compilation_(false),
+        precompile_app_profile_(false),
+        preload_startup_classes_(false),
+        verify_classes_in_background_(false),
+        lazy_mini_debug_info_(false),
         use_baseline_compiler_(false),
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
@@ -149,7 +204,9 @@ class JitOptions {
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        thread_pool_thread_count_(kJitPoolThreadDefaultCount),
+        hotness_decay_period_ms_(0) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -331,10 +331,12 @@ class ProfileSaver::GetClassesAndMethodsHelper {
  public:
   GetClassesAndMethodsHelper(bool startup,
                              const ProfileSaverOptions& options,
-                             const ProfileCompilationInfo::ProfileSampleAnnotation& annotation)
+                             const ProfileCompilationInfo::ProfileSampleAnnotation& annotation,
+                             std::set<std::string>&& tracked_locations)
       REQUIRES_SHARED(Locks::mutator_lock_)
       : startup_(startup),
         profile_boot_class_path_(options.GetProfileBootClassPath()),
+        tracked_locations_(std::move(tracked_locations)),
         extra_flags_(GetExtraMethodHotnessFlags(options)),
         annotation_(annotation),
         arena_stack_(Runtime::Current()->GetArenaPool()),
@@ -390,14 +392,20 @@ class ProfileSaver::GetClassesAndMethodsHelper {
   };
 
   struct DexFileRecords : public DeletableArenaObject<kArenaAllocProfile> {
-    explicit DexFileRecords(ScopedArenaAllocator* allocator)
-        : class_records(allocator->Adapter(kArenaAllocProfile)),
+    DexFileRecords(ScopedArenaAllocator* allocator, bool is_tracked)
+        : tracked(is_tracked),
+          class_records(allocator->Adapter(kArenaAllocProfile)),
           copied_methods(allocator->Adapter(kArenaAllocProfile)) {
-      class_records.reserve(kInitialClassRecordsReservation);
+      if (tracked) {
+        class_records.reserve(kInitialClassRecordsReservation);
+      }
     }
 
     static constexpr size_t kInitialClassRecordsReservation = 512;
 
+    // Whether the dex file belongs to any tracked profile. For other dex files, we only
+    // record the classes with copied methods, which may be defined in tracked dex files.
+    const bool tracked;
     ScopedArenaVector<ClassRecord> class_records;
     ScopedArenaVector<ArtMethod*> copied_methods;
   };
@@ -416,6 +424,7 @@ class ProfileSaver::GetClassesAndMethodsHelper {
 
   const bool startup_;
   const bool profile_boot_class_path_;
+  const std::set<std::string> tracked_locations_;
   const uint32_t extra_flags_;
   const ProfileCompilationInfo::ProfileSampleAnnotation annotation_;
   ArenaStack arena_stack_;
@@ -516,9 +525,15 @@ void ProfileSaver::GetClassesAndMethodsHelper::CollectInternal(
     if (it != dex_file_records_map_.end()) {
       dex_file_records = it->second;
     } else {
-      dex_file_records = new (&allocator_) DexFileRecords(&allocator_);
+      bool tracked = tracked_locations_.find(DexFileLoader::GetBaseLocation(
+                         dex_file.GetLocation())) != tracked_locations_.end();
+      dex_file_records = new (&allocator_) DexFileRecords(&allocator_, tracked);
       dex_file_records_map_.insert(std::make_pair(&dex_file, dex_file_records));
     }
+    if (!dex_file_records->tracked &&
+        (methods == nullptr || copied_methods_start == methods->size())) {
+      return true;
+    }
     dex_file_records->class_records.push_back(
         ClassRecord{type_index, dim, copied_methods_start, methods});
     return true;
@@ -579,7 +594,9 @@ void ProfileSaver::GetClassesAndMethodsHelper::CollectClasses(Thread* self) {
             }
             method_dex_file_records = it->second;
           }
-          method_dex_file_records->copied_methods.push_back(&method);
+          if (method_dex_file_records->tracked) {
+            method_dex_file_records->copied_methods.push_back(&method);
+          }
         }
       }
     }
@@ -619,6 +636,9 @@ void ProfileSaver::GetClassesAndMethodsHelper::UpdateProfile(const std::set<std:
   for (const auto& entry : dex_file_records_map_) {
     const DexFile* dex_file = entry.first;
     const DexFileRecords* dex_file_records = entry.second;
+    if (!dex_file_records->tracked) {
+      continue;
+    }
 
     // Check if this is a profiled dex file.
     const std::string base_location = DexFileLoader::GetBaseLocation(dex_file->GetLocation());
@@ -724,9 +744,14 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
 
   Thread* const self = Thread::Current();
   pthread_t profiler_pthread;
+  // The code paths of all tracked profiles, to skip dex files that no profile needs.
+  std::set<std::string> tracked_locations;
   {
     MutexLock mu(self, *Locks::profiler_lock_);
     profiler_pthread = profiler_pthread_;
+    for (const auto& it : tracked_dex_base_locations_) {
+      tracked_locations.insert(it.second.begin(), it.second.end());
+    }
   }
 
   size_t number_of_hot_methods = 0u;
@@ -742,7 +767,8 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
     }
 
     ScopedObjectAccess soa(self);
-    GetClassesAndMethodsHelper helper(startup, options_, GetProfileSampleAnnotation());
+    GetClassesAndMethodsHelper helper(
+        startup, options_, GetProfileSampleAnnotation(), std::move(tracked_locations));
     helper.CollectClasses(self);
 
     // Release the mutator lock. We shall need to re-acquire the lock for a moment to
@@ -780,6 +806,31 @@ void ProfileSaver::FetchAndCacheResolvedClassesAndMethods(bool startup) {
                  << " sampled methods in " << PrettyDuration(NanoTime() - start_time);
 }
 
+ProfileSaver::ProfileInputs ProfileSaver::GetProfileInputs(
+    const std::string& filename, const std::vector<ProfileMethodInfo>& profile_methods) {
+  ProfileInputs inputs = {};
+  struct stat stat_buffer;
+  if (stat(filename.c_str(), &stat_buffer) == 0) {
+    inputs.file_size = stat_buffer.st_size;
+    inputs.file_mtime_ns =
+        static_cast<int64_t>(stat_buffer.st_mtim.tv_sec) * 1000000000 + stat_buffer.st_mtim.tv_nsec;
+  } else {
+    inputs.file_size = -1;
+  }
+  // The sum of the mixed method references, which does not depend on their order.
+  for (const ProfileMethodInfo& method : profile_methods) {
+    uint64_t key = reinterpret_cast<uintptr_t>(method.ref.dex_file) ^ method.ref.index;
+    inputs.jit_methods_fingerprint += key * UINT64_C(0x9e3779b97f4a7c15);
+  }
+  // The cached profile only grows until it is saved, so its counts identify its contents.
+  auto profile_cache_it = profile_cache_.find(filename);
+  if (profile_cache_it != profile_cache_.end()) {
+    inputs.number_of_cached_methods = profile_cache_it->second->GetNumberOfMethods();
+    inputs.number_of_cached_classes = profile_cache_it->second->GetNumberOfResolvedClasses();
+  }
+  return inputs;
+}
+
 bool ProfileSaver::ProcessProfilingInfo(
         bool force_save,
         bool skip_class_and_method_fetching,
@@ -827,6 +878,20 @@ bool ProfileSaver::ProcessProfilingInfo(
           locations, profile_methods, options_.GetInlineCacheThreshold());
       total_number_of_code_cache_queries_++;
     }
+    ProfileInputs inputs;
+    {
+      MutexLock mu(Thread::Current(), *Locks::profiler_lock_);
+      inputs = GetProfileInputs(filename, profile_methods);
+      auto unsaved_it = unsaved_profile_inputs_.find(filename);
+      if (unsaved_it != unsaved_profile_inputs_.end()) {
+        if (!force_save && unsaved_it->second == inputs) {
+          VLOG(profiler) << "No new information to save to: " << filename;
+          total_number_of_skipped_writes_++;
+          continue;
+        }
+        unsaved_profile_inputs_.erase(unsaved_it);
+      }
+    }
     {
       ProfileCompilationInfo info(Runtime::Current()->GetArenaPool(),
                                   /*for_boot_image=*/options_.GetProfileBootClassPath());
@@ -887,6 +952,7 @@ bool ProfileSaver::ProcessProfilingInfo(
                         << " Number of methods: " << delta_number_of_methods
                         << " Number of classes: " << delta_number_of_classes;
           total_number_of_skipped_writes_++;
+          unsaved_profile_inputs_.Put(filename, inputs);
           continue;
         }
 
@@ -98,6 +98,27 @@ class ProfileSaver {
                            const std::string& ref_profile_filename)
       REQUIRES(Locks::profiler_lock_);
 
+  // What a save attempt for a profile file depends on, apart from the file contents.
+  struct ProfileInputs {
+    int64_t file_size;
+    int64_t file_mtime_ns;
+    uint64_t jit_methods_fingerprint;
+    uint32_t number_of_cached_methods;
+    uint32_t number_of_cached_classes;
+
+    bool operator==(const ProfileInputs& other) const {
+      return file_size == other.file_size &&
+             file_mtime_ns == other.file_mtime_ns &&
+             jit_methods_fingerprint == other.jit_methods_fingerprint &&
+             number_of_cached_methods == other.number_of_cached_methods &&
+             number_of_cached_classes == other.number_of_cached_classes;
+    }
+  };
+
+  ProfileInputs GetProfileInputs(const std::string& filename,
+                                 const std::vector<ProfileMethodInfo>& profile_methods)
+      REQUIRES(Locks::profiler_lock_);
+
   // Fetches the current resolved classes and methods from the ClassLinker and stores them in the
   // profile_cache_ for later save.
   void FetchAndCacheResolvedClassesAndMethods(bool startup) REQUIRES(!Locks::profiler_lock_);
@@ -154,6 +175,11 @@ class ProfileSaver {
   // to just a few hundreds entries in the ProfileCompilationInfo objects.
   SafeMap<std::string, ProfileCompilationInfo*> profile_cache_ GUARDED_BY(Locks::profiler_lock_);
 
+  // The inputs of the last save attempt of each tracked file that did not find enough new
+  // information to save. If the inputs did not change since, the next attempt would not find
+  // any either, so it can skip loading the profile.
+  SafeMap<std::string, ProfileInputs> unsaved_profile_inputs_ GUARDED_BY(Locks::profiler_lock_);
+
   // Whether or not this is the first ever profile save.
   // Note this is an approximation and is not 100% precise. It relies on checking
   // whether or not the profiles are empty which is not a precise indication
@@ -21,6 +21,7 @@
 
 #include "base/macros.h"
 #include "base/value_object.h"
+#include "deoptimization_kind.h"
 #include "gc_root.h"
 #include "interpreter/mterp/nterp.h"
 #include "offsets.h"
@@ -175,18 +176,64 @@ class ProfilingInfo {
     return baseline_hotness_count_;
   }
 
+  // Halve the samples baseline code accumulated towards `optimize_threshold`.
+  void DecayBaselineHotnessCount(uint16_t optimize_threshold) {
+    baseline_hotness_count_ = Decay(baseline_hotness_count_, optimize_threshold);
+    // Keep the snapshot comparable with the decayed count.
+    baseline_hotness_snapshot_ = Decay(baseline_hotness_snapshot_, optimize_threshold);
+  }
+
+  // Return whether baseline code sampled the method since the previous call,
+  // or since the ProfilingInfo was created.
+  bool BaselineCodeRanSinceLastCheck() {
+    uint16_t count = baseline_hotness_count_;
+    bool ran = (count != baseline_hotness_snapshot_);
+    baseline_hotness_snapshot_ = count;
+    return ran;
+  }
+
   static uint16_t GetOptimizeThreshold();
 
+  // Number of deoptimizations of a given kind after which the compiler stops
+  // emitting the speculation responsible for it when recompiling the method.
+  static constexpr uint8_t kMaxDeoptimizationsPerKind = 2;
+
+  // Record that optimized code for the method deoptimized because of `kind`.
+  void RecordDeoptimization(DeoptimizationKind kind) {
+    uint8_t& count = deoptimization_counts_[static_cast<size_t>(kind)];
+    if (count != std::numeric_limits<uint8_t>::max()) {
+      ++count;
+    }
+  }
+
+  uint8_t GetDeoptimizationCount(DeoptimizationKind kind) const {
+    return deoptimization_counts_[static_cast<size_t>(kind)];
+  }
+
+  // Return whether the compiler may still emit speculative code guarded by a
+  // deoptimization of the given `kind`.
+  bool CanSpeculate(DeoptimizationKind kind) const {
+    return GetDeoptimizationCount(kind) < kMaxDeoptimizationsPerKind;
+  }
+
  private:
   ProfilingInfo(ArtMethod* method,
                 const std::vector<uint32_t>& inline_cache_entries,
                 const std::vector<uint32_t>& branch_cache_entries);
 
+  static uint16_t Decay(uint16_t count, uint16_t threshold) {
+    return (count != 0u && count < threshold) ? threshold - (threshold - count) / 2u : count;
+  }
+
   // Hotness count for methods compiled with the JIT baseline compiler. Once
   // a threshold is hit (currentily the maximum value of uint16_t), we will
   // JIT compile optimized the method.
   uint16_t baseline_hotness_count_;
 
+  // Value of `baseline_hotness_count_` seen by the last call to
+  // `BaselineCodeRanSinceLastCheck()`.
+  uint16_t baseline_hotness_snapshot_;
+
   // Method this profiling info is for.
   // Not 'const' as JVMTI introduces obsolete methods that we implement by creating new ArtMethods.
   // See JitCodeCache::MoveObsoleteMethod.
@@ -202,6 +249,10 @@ class ProfilingInfo {
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
+  // Number of times optimized code for the method deoptimized, per kind. Updated
+  // without synchronization other than the JIT lock, which is fine for a heuristic.
+  uint8_t deoptimization_counts_[static_cast<size_t>(DeoptimizationKind::kLast) + 1];
+
   // Memory following the object:
   // - Dynamically allocated array of `InlineCache` of size `number_of_inline_caches_`.
   // - Dynamically allocated array of `BranchCache of size `number_of_branch_caches_`.
@@ -18,6 +18,7 @@
 
 #include "art_method-inl.h"
 #include "dex/dex_instruction-inl.h"
+#include "dex/dex_instruction_utils.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 
 namespace art HIDDEN {
@@ -46,6 +47,26 @@ static mirror::Object* ReturnFieldObjectAt([[maybe_unused]] ArtMethod* method, m
   return obj->GetFieldObject<mirror::Object>(MemberOffset(offset + sizeof(mirror::Object)));
 }
 
+template <int offset, typename T>
+static std::conditional_t<(sizeof(T) < sizeof(int32_t)), int32_t, T> ReturnFieldOrZeroAt(
+    [[maybe_unused]] ArtMethod* method, mirror::Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (obj == nullptr) {
+    return 0;
+  }
+  return obj->GetFieldPrimitive<T, /* kIsVolatile= */ false>(
+      MemberOffset(offset + sizeof(mirror::Object)));
+}
+
+template <int offset, typename unused>
+static mirror::Object* ReturnFieldObjectOrNullAt([[maybe_unused]] ArtMethod* method,
+                                                 mirror::Object* obj)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (obj == nullptr) {
+    return nullptr;
+  }
+  return obj->GetFieldObject<mirror::Object>(MemberOffset(offset + sizeof(mirror::Object)));
+}
+
 template <int offset, typename T>
 static std::conditional_t<(sizeof(T) < sizeof(int32_t)), int32_t, T> ReturnStaticFieldAt(
     ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -129,6 +150,12 @@ static void ConstructorSetFieldObjectAt([[maybe_unused]] ArtMethod* method,
   switch (K) {                                      \
     case Primitive::kPrimBoolean:                   \
       DO_SWITCH_OFFSET(offset, P, uint8_t);         \
+    case Primitive::kPrimByte:                      \
+      DO_SWITCH_OFFSET(offset, P, int8_t);          \
+    case Primitive::kPrimChar:                      \
+      DO_SWITCH_OFFSET(offset, P, uint16_t);        \
+    case Primitive::kPrimShort:                     \
+      DO_SWITCH_OFFSET(offset, P, int16_t);         \
     case Primitive::kPrimInt:                       \
       DO_SWITCH_OFFSET(offset, P, int32_t);         \
     case Primitive::kPrimLong:                      \
@@ -151,6 +178,78 @@ static void ConstructorSetFieldObjectAt([[maybe_unused]] ArtMethod* method,
       return nullptr;                               \
   }
 
+// Recognize a static accessor returning a field of its first argument, or
+// zero/null if that argument is null:
+//   if-eqz v0, :null
+//   iget-{object,wide,boolean,...} vX, v0, field
+//   return-{object} vX
+// :null
+//   const/4 vY, 0
+//   return-{object} vY
+static const void* TryMatchNullCheckedGetter(ArtMethod* method,
+                                             const CodeItemDataAccessor& accessor,
+                                             ClassLinker* class_linker)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  DCHECK(method->IsStatic());
+  DCHECK_EQ(accessor.InsnsSizeInCodeUnits(), 7u);
+  if (method->GetReturnTypePrimitive() == Primitive::kPrimLong ||
+      method->GetReturnTypePrimitive() == Primitive::kPrimDouble) {
+    // The null branch would need a `const-wide`.
+    return nullptr;
+  }
+  uint16_t number_of_vregs = accessor.RegistersSize();
+  uint16_t number_of_parameters = accessor.InsSize();
+  uint16_t obj_reg = number_of_vregs - number_of_parameters;
+  const Instruction* if_eqz = &accessor.begin().Inst();
+  if (if_eqz->Opcode() != Instruction::IF_EQZ ||
+      if_eqz->VRegA_21t() != obj_reg ||
+      if_eqz->VRegB_21t() != 5) {
+    return nullptr;
+  }
+  const Instruction* get = if_eqz->Next();
+  if (!IsInstructionIGet(get->Opcode()) || get->VRegB_22c() != obj_reg) {
+    return nullptr;
+  }
+  const Instruction* ret = get->Next();
+  if (!IsInstructionReturn(ret->Opcode()) ||
+      ret->Opcode() == Instruction::RETURN_VOID ||
+      ret->VRegA_11x() != get->VRegA_22c()) {
+    return nullptr;
+  }
+  const Instruction* zero = ret->Next();
+  if (zero->Opcode() != Instruction::CONST_4 || zero->VRegB_11n() != 0) {
+    return nullptr;
+  }
+  const Instruction* ret_zero = zero->Next();
+  if (ret_zero->Opcode() != ret->Opcode() ||
+      ret_zero->VRegA_11x() != zero->VRegA_11n()) {
+    return nullptr;
+  }
+
+  Thread* self = Thread::Current();
+  ArtField* field = ResolveFieldWithAccessChecks(self,
+                                                 class_linker,
+                                                 get->VRegC_22c(),
+                                                 method,
+                                                 /* is_static= */ false,
+                                                 /* is_put= */ false,
+                                                 /* resolve_field_type= */ false);
+  if (field == nullptr) {
+    self->ClearException();
+    return nullptr;
+  }
+  if (field->IsVolatile()) {
+    return nullptr;
+  }
+  uint32_t offset = field->GetOffset().Int32Value() - sizeof(mirror::Object);
+  if (offset > 64) {
+    return nullptr;
+  }
+  Primitive::Type field_type = field->GetTypeAsPrimitiveType();
+  bool is_object = (get->Opcode() == Instruction::IGET_OBJECT);
+  DO_SWITCH(offset, ReturnFieldObjectOrNullAt, ReturnFieldOrZeroAt, field_type);
+}
+
 const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
   CodeItemDataAccessor accessor(*method->GetDexFile(), method->GetCodeItem());
 
@@ -163,6 +262,9 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
       method->GetDeclaringClass()->GetSuperClass()->IsObjectClass();
 
   size_t insns_size = accessor.InsnsSizeInCodeUnits();
+  if (insns_size == 7u && method->IsStatic()) {
+    return TryMatchNullCheckedGetter(method, accessor, class_linker);
+  }
   if (insns_size >= 4u) {
     if (!is_recognizable_constructor) {
       return nullptr;
@@ -213,6 +315,8 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
   //   return-void
   // Or:
   //   return-object v0
+  // Or, for a static method whose first parameter is an int-like value:
+  //   return v0
   if (insns_size == 1u) {
     const Instruction& instruction = accessor.begin().Inst();
     if (instruction.Opcode() == Instruction::RETURN_VOID) {
@@ -227,6 +331,19 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
         return reinterpret_cast<void*>(&ReturnFirstArgMethod);
       }
     }
+
+    if (instruction.Opcode() == Instruction::RETURN && method->IsStatic()) {
+      // Float arguments and return values are not passed in core registers.
+      const char* shorty = method->GetShorty();
+      if (shorty[0] != 'F' && shorty[1] != '\0' && strchr("IZBCS", shorty[1]) != nullptr) {
+        uint16_t number_of_vregs = accessor.RegistersSize();
+        uint16_t number_of_parameters = accessor.InsSize();
+        uint16_t first_param_reg = number_of_vregs - number_of_parameters;
+        if (first_param_reg == instruction.VRegA_11x()) {
+          return reinterpret_cast<void*>(&ReturnFirstArgMethod);
+        }
+      }
+    }
     return nullptr;
   }
 
@@ -284,8 +401,8 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
   //   iput-{object,wide,boolean} v1, v0, field
   //   return-void
   // Or:
-  //   sget-object vX, field
-  //   return-object vX
+  //   sget-{object,wide,boolean,...} vX, field
+  //   return-{object} vX
   // Or:
   //   iput-{object,wide,boolean} v1, v0, field
   //   invoke-direct v0, j.l.Object.<init>
@@ -315,23 +432,32 @@ const void* SmallPatternMatcher::TryMatch(ArtMethod* method) REQUIRES_SHARED(Loc
             return nullptr;
           }
           break;
+        case Instruction::SGET:
+        case Instruction::SGET_WIDE:
         case Instruction::SGET_OBJECT:
-          is_static = true;
-          FALLTHROUGH_INTENDED;
-        case Instruction::IPUT_OBJECT:
-        case Instruction::IGET_OBJECT:
-          is_object = true;
-          FALLTHROUGH_INTENDED;
-        case Instruction::IPUT:
+        case Instruction::SGET_BOOLEAN:
+        case Instruction::SGET_BYTE:
+        case Instruction::SGET_CHAR:
+        case Instruction::SGET_SHORT:
         case Instruction::IGET:
+        case Instruction::IGET_WIDE:
+        case Instruction::IGET_OBJECT:
         case Instruction::IGET_BOOLEAN:
+        case Instruction::IGET_BYTE:
+        case Instruction::IGET_CHAR:
+        case Instruction::IGET_SHORT:
+        case Instruction::IPUT:
+        case Instruction::IPUT_WIDE:
+        case Instruction::IPUT_OBJECT:
         case Instruction::IPUT_BOOLEAN:
-        case Instruction::IGET_WIDE:
-        case Instruction::IPUT_WIDE: {
-          is_put = (pair->Opcode() == Instruction::IPUT ||
-                    pair->Opcode() == Instruction::IPUT_OBJECT ||
-                    pair->Opcode() == Instruction::IPUT_BOOLEAN ||
-                    pair->Opcode() == Instruction::IPUT_WIDE);
+        case Instruction::IPUT_BYTE:
+        case Instruction::IPUT_CHAR:
+        case Instruction::IPUT_SHORT: {
+          is_static = IsInstructionSGet(pair->Opcode());
+          is_object = (pair->Opcode() == Instruction::SGET_OBJECT ||
+                       pair->Opcode() == Instruction::IGET_OBJECT ||
+                       pair->Opcode() == Instruction::IPUT_OBJECT);
+          is_put = IsInstructionIPut(pair->Opcode());
           if (!is_static && obj_reg != instruction.VRegB_22c()) {
             // The field access is not on the first parameter.
             return nullptr;
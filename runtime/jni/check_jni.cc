@@ -56,11 +56,13 @@ namespace art HIDDEN {
 // This helper cannot be in the anonymous namespace because it needs to be
 // declared as a friend by JniVmExt and JniEnvExt.
 inline IndirectReferenceTable* GetIndirectReferenceTable(ScopedObjectAccess& soa,
-                                                         IndirectRefKind kind) {
+                                                         IndirectRef ref) {
+  IndirectRefKind kind = IndirectReferenceTable::GetIndirectRefKind(ref);
   DCHECK_NE(kind, kJniTransition);
   DCHECK_NE(kind, kLocal);
   JavaVMExt* vm = soa.Env()->GetVm();
-  IndirectReferenceTable* irt = (kind == kGlobal) ? &vm->globals_ : &vm->weak_globals_;
+  IndirectReferenceTable* irt =
+      (kind == kGlobal) ? &vm->GetGlobalsShard(ref) : &vm->weak_globals_;
   DCHECK_EQ(irt->GetKind(), kind);
   return irt;
 }
@@ -884,7 +886,7 @@ class ScopedCheck {
         obj = lrt->Get(ref);
       }
     } else {
-      IndirectReferenceTable* irt = GetIndirectReferenceTable(soa, ref_kind);
+      IndirectReferenceTable* irt = GetIndirectReferenceTable(soa, ref);
       okay = irt->IsValidReference(java_object, &error_msg);
       DCHECK_EQ(okay, error_msg.empty());
       if (okay) {
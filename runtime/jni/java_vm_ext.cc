@@ -22,6 +22,7 @@
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
+#include "base/casts.h"
 #include "base/dumpable.h"
 #include "base/mutex-inl.h"
 #include "base/sdk_version.h"
@@ -512,7 +513,6 @@ JavaVMExt::JavaVMExt(Runtime* runtime, const RuntimeArgumentMap& runtime_options
       tracing_enabled_(runtime_options.Exists(RuntimeArgumentMap::JniTrace)
                        || VLOG_IS_ON(third_party_jni)),
       trace_(runtime_options.GetOrDefault(RuntimeArgumentMap::JniTrace)),
-      globals_(kGlobal),
       libraries_(new Libraries),
       unchecked_functions_(&gJniInvokeInterface),
       weak_globals_(kWeakGlobal),
@@ -528,11 +528,20 @@ JavaVMExt::JavaVMExt(Runtime* runtime, const RuntimeArgumentMap& runtime_options
       old_allocation_tracking_state_(false) {
   functions = unchecked_functions_;
   SetCheckJniEnabled(runtime_options.Exists(RuntimeArgumentMap::CheckJni) || kIsDebugBuild);
+  for (size_t i = 0; i != kNumGlobalsShards; ++i) {
+    globals_[i].reset(new GlobalsShard(i));
+  }
 }
 
 bool JavaVMExt::Initialize(std::string* error_msg) {
-  return globals_.Initialize(kGlobalsMax, error_msg) &&
-         weak_globals_.Initialize(kWeakGlobalsMax, error_msg);
+  // With a full shard we fall back to the other shards, so they share the total capacity.
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    if (!shard->table.Initialize(RoundUp(kGlobalsMax, kNumGlobalsShards) / kNumGlobalsShards,
+                                 error_msg)) {
+      return false;
+    }
+  }
+  return weak_globals_.Initialize(kWeakGlobalsMax, error_msg);
 }
 
 JavaVMExt::~JavaVMExt() {
@@ -651,7 +660,10 @@ void JavaVMExt::CheckGlobalRefAllocationTracking() {
   if (LIKELY(enable_allocation_tracking_delta_ == 0)) {
     return;
   }
-  size_t simple_free_capacity = globals_.FreeCapacity();
+  size_t simple_free_capacity = 0u;
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    simple_free_capacity += shard->table.FreeCapacity();
+  }
   if (UNLIKELY(simple_free_capacity <= enable_allocation_tracking_delta_)) {
     if (!allocation_tracking_enabled_) {
       LOG(WARNING) << "Global reference storage appears close to exhaustion, program termination "
@@ -680,10 +692,20 @@ void JavaVMExt::CheckGlobalRefAllocationTracking() {
   }
 }
 
+size_t JavaVMExt::NumGlobals() const {
+  // Without the shard locks, this is only a snapshot for tracing and dumping.
+  size_t num_globals = 0u;
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    num_globals += shard->table.NEntriesForGlobal();
+  }
+  return num_globals;
+}
+
 void JavaVMExt::MaybeTraceGlobals() {
-  if (global_ref_report_counter_++ == kGlobalRefReportInterval) {
-    global_ref_report_counter_ = 1;
-    ATraceIntegerValue("JNI Global Refs", globals_.NEntriesForGlobal());
+  if (global_ref_report_counter_.fetch_add(1u, std::memory_order_relaxed) ==
+      kGlobalRefReportInterval) {
+    global_ref_report_counter_.store(1u, std::memory_order_relaxed);
+    ATraceIntegerValue("JNI Global Refs", dchecked_integral_cast<int32_t>(NumGlobals()));
   }
 }
 
@@ -699,11 +721,18 @@ jobject JavaVMExt::AddGlobalRef(Thread* self, ObjPtr<mirror::Object> obj) {
   if (obj == nullptr) {
     return nullptr;
   }
-  IndirectRef ref;
+  IndirectRef ref = nullptr;
   std::string error_msg;
   {
-    WriterMutexLock mu(self, *Locks::jni_globals_lock_);
-    ref = globals_.Add(obj, &error_msg);
+    ReaderMutexLock mu(self, *Locks::jni_globals_lock_);
+    // Start with the shard of this thread, and try the others if it is full.
+    size_t first_shard = (self != nullptr) ? self->GetThreadId() : 0u;
+    for (size_t i = 0; i != kNumGlobalsShards && ref == nullptr; ++i) {
+      GlobalsShard* shard = globals_[(first_shard + i) % kNumGlobalsShards].get();
+      MutexLock mu2(self, shard->lock);
+      error_msg.clear();
+      ref = shard->table.Add(obj, &error_msg);
+    }
     MaybeTraceGlobals();
   }
   if (UNLIKELY(ref == nullptr)) {
@@ -753,8 +782,14 @@ void JavaVMExt::DeleteGlobalRef(Thread* self, jobject obj) {
     return;
   }
   {
-    WriterMutexLock mu(self, *Locks::jni_globals_lock_);
-    if (!globals_.Remove(obj)) {
+    ReaderMutexLock mu(self, *Locks::jni_globals_lock_);
+    GlobalsShard* shard = globals_[IndirectReferenceTable::GetShard(obj, kGlobalsShardBits)].get();
+    bool removed;
+    {
+      MutexLock mu2(self, shard->lock);
+      removed = shard->table.Remove(obj);
+    }
+    if (!removed) {
       LOG(WARNING) << "JNI WARNING: DeleteGlobalRef(" << obj << ") "
                    << "failed to find entry";
     }
@@ -796,8 +831,12 @@ void JavaVMExt::DumpForSigQuit(std::ostream& os) {
   }
   Thread* self = Thread::Current();
   {
-    ReaderMutexLock mu(self, *Locks::jni_globals_lock_);
-    os << "; globals=" << globals_.Capacity();
+    WriterMutexLock mu(self, *Locks::jni_globals_lock_);
+    size_t capacity = 0u;
+    for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+      capacity += shard->table.Capacity();
+    }
+    os << "; globals=" << capacity;
   }
   {
     MutexLock mu(self, *Locks::jni_weak_globals_lock_);
@@ -839,12 +878,12 @@ void JavaVMExt::BroadcastForNewWeakGlobals() {
 }
 
 ObjPtr<mirror::Object> JavaVMExt::DecodeGlobal(IndirectRef ref) {
-  return globals_.Get(ref);
+  return GetGlobalsShard(ref).Get(ref);
 }
 
 void JavaVMExt::UpdateGlobal(Thread* self, IndirectRef ref, ObjPtr<mirror::Object> result) {
   WriterMutexLock mu(self, *Locks::jni_globals_lock_);
-  globals_.Update(ref, result);
+  GetGlobalsShard(ref).Update(ref, result);
 }
 
 ObjPtr<mirror::Object> JavaVMExt::DecodeWeakGlobal(Thread* self, IndirectRef ref) {
@@ -911,8 +950,10 @@ void JavaVMExt::UpdateWeakGlobal(Thread* self, IndirectRef ref, ObjPtr<mirror::O
 void JavaVMExt::DumpReferenceTables(std::ostream& os) {
   Thread* self = Thread::Current();
   {
-    ReaderMutexLock mu(self, *Locks::jni_globals_lock_);
-    globals_.Dump(os);
+    WriterMutexLock mu(self, *Locks::jni_globals_lock_);
+    for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+      shard->table.Dump(os);
+    }
   }
   {
     MutexLock mu(self, *Locks::jni_weak_globals_lock_);
@@ -1184,13 +1225,18 @@ void* JavaVMExt::FindCodeForNativeMethod(ArtMethod* m, std::string* error_msg, b
 
 void JavaVMExt::TrimGlobals() {
   WriterMutexLock mu(Thread::Current(), *Locks::jni_globals_lock_);
-  globals_.Trim();
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    shard->table.Trim();
+  }
 }
 
 void JavaVMExt::VisitRoots(RootVisitor* visitor) {
   Thread* self = Thread::Current();
-  ReaderMutexLock mu(self, *Locks::jni_globals_lock_);
-  globals_.VisitRoots(visitor, RootInfo(kRootJNIGlobal));
+  // Exclusive, since adding and deleting global references only takes the lock shared.
+  WriterMutexLock mu(self, *Locks::jni_globals_lock_);
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    shard->table.VisitRoots(visitor, RootInfo(kRootJNIGlobal));
+  }
   // The weak_globals table is visited by the GC itself (because it mutates the table).
 }
 
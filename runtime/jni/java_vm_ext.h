@@ -238,7 +238,29 @@ class JavaVMExt : public JavaVM {
 
   void CheckGlobalRefAllocationTracking();
 
-  inline void MaybeTraceGlobals() REQUIRES(Locks::jni_globals_lock_);
+  // The global reference table is split in shards, each with its own lock, so that threads
+  // adding and deleting global references mostly do not contend. Adding or deleting takes
+  // `jni_globals_lock_` shared and the lock of the shard. Operations on the whole table take
+  // `jni_globals_lock_` exclusively.
+  static constexpr size_t kGlobalsShardBits = 2u;
+  static constexpr size_t kNumGlobalsShards = 1u << kGlobalsShardBits;
+
+  struct GlobalsShard {
+    explicit GlobalsShard(uint32_t shard)
+        : lock("JNI global reference table shard lock", kJniGlobalsShardLock),
+          table(kGlobal, shard, kGlobalsShardBits) {}
+
+    Mutex lock ACQUIRED_AFTER(Locks::jni_globals_lock_);
+    IndirectReferenceTable table;
+  };
+
+  IndirectReferenceTable& GetGlobalsShard(IndirectRef ref) {
+    return globals_[IndirectReferenceTable::GetShard(ref, kGlobalsShardBits)]->table;
+  }
+
+  size_t NumGlobals() const;
+
+  inline void MaybeTraceGlobals();
   inline void MaybeTraceWeakGlobals() REQUIRES(Locks::jni_weak_globals_lock_);
 
   Runtime* const runtime_;
@@ -255,7 +277,7 @@ class JavaVMExt : public JavaVM {
   // Extra diagnostics.
   const std::string trace_;
 
-  IndirectReferenceTable globals_;
+  std::unique_ptr<GlobalsShard> globals_[kNumGlobalsShards];
 
   // No lock annotation since UnloadNativeLibraries is called on libraries_ but locks the
   // jni_libraries_lock_ internally.
@@ -283,12 +305,11 @@ class JavaVMExt : public JavaVM {
   static constexpr uint32_t kGlobalRefReportInterval = 17;
   uint32_t weak_global_ref_report_counter_ GUARDED_BY(Locks::jni_weak_globals_lock_)
       = kGlobalRefReportInterval;
-  uint32_t global_ref_report_counter_ GUARDED_BY(Locks::jni_globals_lock_)
-      = kGlobalRefReportInterval;
+  std::atomic<uint32_t> global_ref_report_counter_ = kGlobalRefReportInterval;
 
   friend class linker::ImageWriter;  // Uses `globals_` and `weak_globals_` without read barrier.
   friend IndirectReferenceTable* GetIndirectReferenceTable(ScopedObjectAccess& soa,
-                                                           IndirectRefKind kind);
+                                                           IndirectRef ref);
 
   DISALLOW_COPY_AND_ASSIGN(JavaVMExt);
 };
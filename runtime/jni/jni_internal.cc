@@ -242,6 +242,12 @@ char* GetUncompressedStringUTFChars(const uint16_t* chars, size_t length, char*
 // things not rendering correctly. E.g. b/16858794
 static constexpr bool kWarnJniAbort = false;
 
+// With the CC and CMC collectors, critical access to a movable array blocks the next thread flip,
+// and thus the GC, until the array is released. Small arrays are copied instead: the copy is
+// cheaper than entering and leaving the flip-disabled section, and it never holds up the GC.
+// Primitive arrays of at least the large object threshold are already allocated non-moving.
+static constexpr size_t kMaxCopiedCriticalArraySize = 256;
+
 static hiddenapi::AccessContext GetJniAccessContext(Thread* self)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   // Construct AccessContext from the first calling class on stack.
@@ -2366,9 +2372,19 @@ class JNI {
       return nullptr;
     }
     gc::Heap* heap = Runtime::Current()->GetHeap();
+    const size_t component_size = array->GetClass()->GetComponentSize();
     if (heap->IsMovableObject(array)) {
       if (!gUseReadBarrier && !gUseUserfaultfd) {
         heap->IncrementDisableMovingGC(soa.Self());
+      } else if (size_t size = array->GetLength() * component_size;
+                 size <= kMaxCopiedCriticalArraySize) {
+        // Freed by ReleasePrimitiveArray() like the copies of Get<Type>ArrayElements().
+        if (is_copy != nullptr) {
+          *is_copy = JNI_TRUE;
+        }
+        void* data = new uint64_t[RoundUp(size, 8) / 8];
+        memcpy(data, array->GetRawData(component_size, 0), size);
+        return data;
       } else {
         // For the CC and CMC collector, we only need to wait for the thread flip rather
         // than the whole GC to occur thanks to the to-space invariant.
@@ -2382,7 +2398,7 @@ class JNI {
     if (is_copy != nullptr) {
       *is_copy = JNI_FALSE;
     }
-    return array->GetRawData(array->GetClass()->GetComponentSize(), 0);
+    return array->GetRawData(component_size, 0);
   }
 
   static void ReleasePrimitiveArrayCritical(JNIEnv* env, jarray java_array, void* elements,
@@ -1270,6 +1270,29 @@ TEST_F(JniInternalTest, GetReleasePrimitiveArrayCriticalOfWrongType) {
   GetReleasePrimitiveArrayCriticalOfWrongType(true);
 }
 
+TEST_F(JniInternalTest, PrimitiveArrayCriticalWriteBack) {
+  // Small arrays may be copied, large ones are not; writes must be visible after release.
+  for (jsize length : {4, 64 * 1024}) {
+    jintArray array = env_->NewIntArray(length);
+    ASSERT_NE(array, nullptr);
+    jboolean is_copy;
+    jint* elements = reinterpret_cast<jint*>(env_->GetPrimitiveArrayCritical(array, &is_copy));
+    ASSERT_NE(elements, nullptr);
+    if (length > 4) {
+      EXPECT_EQ(is_copy, JNI_FALSE);
+    }
+    elements[0] = 42;
+    elements[length - 1] = 43;
+    env_->ReleasePrimitiveArrayCritical(array, elements, 0);
+    jint first;
+    jint last;
+    env_->GetIntArrayRegion(array, 0, 1, &first);
+    env_->GetIntArrayRegion(array, length - 1, 1, &last);
+    EXPECT_EQ(first, 42);
+    EXPECT_EQ(last, 43);
+  }
+}
+
 TEST_F(JniInternalTest, GetPrimitiveArrayRegionElementsOfWrongType) {
   GetPrimitiveArrayRegionElementsOfWrongType(false);
   GetPrimitiveArrayRegionElementsOfWrongType(true);
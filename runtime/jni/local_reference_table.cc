@@ -458,6 +458,28 @@ bool LocalReferenceTable::Remove(IndirectRef iref) {
   DCHECK(max_entries_ == kSmallLrtEntries ? small_table_ != nullptr : !tables_.empty());
   DCheckValidReference(iref);
 
+  constexpr uint32_t kDeadLocalValue = 0xdead10c0;
+
+  // Fast-path for removing the top entry of the current segment of a small table without holes
+  // and with CheckJNI disabled, such as a `DeleteLocalRef()` right after creating a reference.
+  // Without holes there are no free entries below the top to consume.
+  if (LIKELY(small_table_ != nullptr) &&
+      LIKELY(free_entries_list_ == kEmptyFreeListAndCheckJniDisabled)) {
+    uint32_t top_index = segment_state_.top_index;
+    LrtEntry* entry = ToLrtEntry(iref);
+    if (top_index > previous_state_.top_index &&
+        entry == &small_table_[top_index - 1u] &&
+        !GetCheckJniSerialNumberEntry(entry)->IsSerialNumber()) {
+      DCHECK(!entry->IsFree());
+      entry->SetReference(reinterpret_cast32<mirror::Object*>(kDeadLocalValue));
+      segment_state_.top_index = top_index - 1u;
+      if (kDebugLRT) {
+        LOG(INFO) << "+++ removed last entry without holes, new top= " << top_index - 1u;
+      }
+      return true;
+    }
+  }
+
   LrtEntry* entry = ToLrtEntry(iref);
   uint32_t entry_index = GetReferenceEntryIndex(iref);
   uint32_t top_index = segment_state_.top_index;
@@ -508,7 +530,6 @@ bool LocalReferenceTable::Remove(IndirectRef iref) {
   }
   if (is_top_entry) {
     // Top-most entry. Scan up and consume holes created with the current CheckJNI setting.
-    constexpr uint32_t kDeadLocalValue = 0xdead10c0;
     entry->SetReference(reinterpret_cast32<mirror::Object*>(kDeadLocalValue));
 
     // TODO: Maybe we should not prune free entries from the top of the segment
@@ -129,6 +129,37 @@ inline void* LinearAlloc::AllocAlign16(Thread* self, size_t size, LinearAllocKin
   }
 }
 
+inline void LinearAlloc::Free(Thread* self, void* ptr, size_t size) {
+  DCHECK(ptr != nullptr);
+  ArenaPool* pool;
+  {
+    MutexLock mu(self, lock_);
+    DCHECK(allocator_.Contains(ptr));
+    freed_bytes_ += size;
+    if (!track_allocations_) {
+      return;
+    }
+    // As in Realloc(), the header is immediately prior to `ptr`.
+    TrackingHeader* header = static_cast<TrackingHeader*>(ptr) - 1;
+    DCHECK_EQ(header->GetSize(), size + sizeof(TrackingHeader));
+    DCHECK(!header->Is16Aligned());
+    header->SetKind(LinearAllocKind::kNoGCRoots);
+    pool = allocator_.GetArenaPool();
+  }
+  // Keep the page holding the header, which the GC reads to skip the allocation.
+  uint8_t* release_begin = AlignUp(static_cast<uint8_t*>(ptr), gPageSize);
+  uint8_t* release_end = AlignDown(static_cast<uint8_t*>(ptr) + size, gPageSize);
+  if (release_begin < release_end) {
+    down_cast<GcVisitedArenaPool*>(pool)->ReleaseFreedPages(release_begin,
+                                                            release_end - release_begin);
+  }
+}
+
+inline size_t LinearAlloc::GetFreedMemory() const {
+  MutexLock mu(Thread::Current(), lock_);
+  return freed_bytes_;
+}
+
 inline size_t LinearAlloc::GetUsedMemory() const {
   MutexLock mu(Thread::Current(), lock_);
   return allocator_.BytesUsed();
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_LINEAR_ALLOC_H_
 #define ART_RUNTIME_LINEAR_ALLOC_H_
 
+#include <atomic>
+
 #include "base/arena_allocator.h"
 #include "base/casts.h"
 #include "base/macros.h"
@@ -49,7 +51,9 @@ class TrackingHeader final {
     }
   }
 
-  LinearAllocKind GetKind() const { return kind_; }
+  // The GC reads the kind concurrently with ConvertToNoGcRoots() and Free(). Either kind is
+  // fine to visit, so relaxed ordering is enough.
+  LinearAllocKind GetKind() const { return kind_.load(std::memory_order_relaxed); }
   // Since we are linearly allocating and hop from one object to the next during
   // visits, reading 'size_ == 0' indicates that there are no more objects to
   // visit in the given page. But ASAN detects it as use-after-poison access.
@@ -57,9 +61,10 @@ class TrackingHeader final {
   bool Is16Aligned() const { return size_ & kIs16Aligned; }
 
  private:
-  void SetKind(LinearAllocKind kind) { kind_ = kind; }
+  void SetKind(LinearAllocKind kind) { kind_.store(kind, std::memory_order_relaxed); }
 
-  LinearAllocKind kind_;
+  std::atomic<LinearAllocKind> kind_;
+  static_assert(std::atomic<LinearAllocKind>::is_always_lock_free);
   uint32_t size_;
 
   friend class LinearAlloc;  // For SetKind()
@@ -76,7 +81,10 @@ class LinearAlloc {
   static_assert(sizeof(TrackingHeader) == ArenaAllocator::kAlignment);
 
   explicit LinearAlloc(ArenaPool* pool, bool track_allocs)
-      : lock_("linear alloc"), allocator_(pool), track_allocations_(track_allocs) {}
+      : lock_("linear alloc"),
+        allocator_(pool),
+        freed_bytes_(0u),
+        track_allocations_(track_allocs) {}
 
   void* Alloc(Thread* self, size_t size, LinearAllocKind kind) REQUIRES(!lock_);
   void* AllocAlign16(Thread* self, size_t size, LinearAllocKind kind) REQUIRES(!lock_);
@@ -91,9 +99,17 @@ class LinearAlloc {
     return reinterpret_cast<T*>(Alloc(self, elements * sizeof(T), kind));
   }
 
+  // Free an allocation of `size` bytes which is no longer referenced. The memory is not
+  // reused, but the GC stops visiting it and pages which only hold the freed allocation are
+  // released to the kernel. 16-byte aligned allocations are not supported.
+  void Free(Thread* self, void* ptr, size_t size) REQUIRES(!lock_);
+
   // Return the number of bytes used in the allocator.
   size_t GetUsedMemory() const REQUIRES(!lock_);
 
+  // Return the number of bytes freed with Free() so far.
+  size_t GetFreedMemory() const REQUIRES(!lock_);
+
   ArenaPool* GetArenaPool() REQUIRES(!lock_);
   // Force arena allocator to ask for a new arena on next allocation. This
   // is to preserve private/shared clean pages across zygote fork.
@@ -118,6 +134,7 @@ class LinearAlloc {
  private:
   mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ArenaAllocator allocator_ GUARDED_BY(lock_);
+  size_t freed_bytes_ GUARDED_BY(lock_);
   const bool track_allocations_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(LinearAlloc);
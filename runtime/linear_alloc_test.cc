@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "linear_alloc-inl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common_runtime_test.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+
+namespace art HIDDEN {
+
+class LinearAllocTest : public CommonRuntimeTest {
+ protected:
+  LinearAllocTest() {
+    use_boot_image_ = true;  // Make the Runtime creation cheaper.
+  }
+
+  static const TrackingHeader* GetHeader(const void* ptr) {
+    return static_cast<const TrackingHeader*>(ptr) - 1;
+  }
+};
+
+TEST_F(LinearAllocTest, Free) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<LinearAlloc> linear_alloc(Runtime::Current()->CreateLinearAlloc());
+  const size_t size = 3 * gPageSize;
+  uint8_t* ptr = reinterpret_cast<uint8_t*>(
+      linear_alloc->Alloc(self, size, LinearAllocKind::kArtMethodArray));
+  ASSERT_TRUE(ptr != nullptr);
+  std::fill_n(ptr, size, 0xffu);
+
+  linear_alloc->Free(self, ptr, size);
+  EXPECT_EQ(size, linear_alloc->GetFreedMemory());
+  if (!gUseUserfaultfd) {
+    // Without tracked allocations, Free() only counts the freed bytes.
+    return;
+  }
+  EXPECT_EQ(LinearAllocKind::kNoGCRoots, GetHeader(ptr)->GetKind());
+  EXPECT_EQ(size + sizeof(TrackingHeader), GetHeader(ptr)->GetSize());
+  // The pages which only hold the freed allocation read as zeros.
+  uint8_t* release_begin = AlignUp(ptr, gPageSize);
+  uint8_t* release_end = AlignDown(ptr + size, gPageSize);
+  ASSERT_LT(release_begin, release_end);
+  EXPECT_TRUE(std::all_of(release_begin, release_end, [](uint8_t b) { return b == 0u; }));
+  // The partial pages at both ends of the allocation are kept.
+  if (release_begin != ptr) {
+    EXPECT_EQ(0xffu, ptr[0]);
+  }
+  if (release_end != ptr + size) {
+    EXPECT_EQ(0xffu, ptr[size - 1]);
+  }
+}
+
+// The GC reads the kinds of the allocations while other threads free them.
+TEST_F(LinearAllocTest, FreeWhileReadingKinds) {
+  if (!gUseUserfaultfd) {
+    GTEST_SKIP() << "Allocations are only tracked with the userfaultfd GC";
+  }
+  Thread* self = Thread::Current();
+  std::unique_ptr<LinearAlloc> linear_alloc(Runtime::Current()->CreateLinearAlloc());
+  constexpr size_t kNumAllocations = 1000u;
+  constexpr size_t kSize = 64u;
+  std::vector<void*> allocations;
+  for (size_t i = 0; i != kNumAllocations; ++i) {
+    allocations.push_back(linear_alloc->Alloc(self, kSize, LinearAllocKind::kArtMethodArray));
+  }
+
+  std::atomic<bool> done(false);
+  std::thread reader([&]() {
+    while (!done.load(std::memory_order_relaxed)) {
+      for (void* ptr : allocations) {
+        LinearAllocKind kind = GetHeader(ptr)->GetKind();
+        EXPECT_TRUE(kind == LinearAllocKind::kArtMethodArray ||
+                    kind == LinearAllocKind::kNoGCRoots);
+      }
+    }
+  });
+  for (void* ptr : allocations) {
+    linear_alloc->Free(self, ptr, kSize);
+  }
+  done.store(true, std::memory_order_relaxed);
+  reader.join();
+
+  for (void* ptr : allocations) {
+    EXPECT_EQ(LinearAllocKind::kNoGCRoots, GetHeader(ptr)->GetKind());
+  }
+  EXPECT_EQ(kNumAllocations * kSize, linear_alloc->GetFreedMemory());
+}
+
+}  // namespace art
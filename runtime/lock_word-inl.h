@@ -25,7 +25,13 @@ namespace art HIDDEN {
 inline uint32_t LockWord::ThinLockOwner() const {
   DCHECK_EQ(GetState(), kThinLocked);
   CheckReadBarrierState();
-  return (value_ >> kThinLockOwnerShift) & kThinLockOwnerMask;
+  return (value_ >> kThinLockOwnerShift) & kThinLockMaxOwner;
+}
+
+inline bool LockWord::ThinLockHasHashCode() const {
+  DCHECK_EQ(GetState(), kThinLocked);
+  CheckReadBarrierState();
+  return (value_ & kThinLockHashCodeFlag) != 0u;
 }
 
 inline uint32_t LockWord::ThinLockCount() const {
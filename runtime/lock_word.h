@@ -39,11 +39,13 @@ class Monitor;
  *
  * When the lock word is in the "thin" state and its bits are formatted as follows:
  *
- *  |33|2|2|222222221111|1111110000000000|
- *  |10|9|8|765432109876|5432109876543210|
- *  |00|m|r| lock count |thread id owner |
+ *  |33|2|2|222222221111|1|111110000000000|
+ *  |10|9|8|765432109876|5|432109876543210|
+ *  |00|m|r| lock count |h|thread id owner|
  *
  * The lock count is zero, but the owner is nonzero for a simply held lock.
+ * The `h` bit is set when the owner has given the object an identity hash code, which the owner
+ * thread keeps on the side until the lock is released, see `ThinLockHasHashCode()`.
  * When the lock word is in the "fat" state and its bits are formatted as follows:
  *
  *  |33|2|2|2222222211111111110000000000|
@@ -72,7 +74,7 @@ class LockWord {
     kStateSize = 2,
     kReadBarrierStateSize = 1,
     kMarkBitStateSize = 1,
-    // Number of bits to encode the thin lock owner.
+    // Number of bits to encode the thin lock owner, including the hash code flag.
     kThinLockOwnerSize = 16,
     // Remaining bits are the recursive lock count. Zero means it is locked exactly once
     // and not recursively.
@@ -83,7 +85,12 @@ class LockWord {
     kThinLockOwnerShift = 0,
     kThinLockOwnerMask = (1 << kThinLockOwnerSize) - 1,
     kThinLockOwnerMaskShifted = kThinLockOwnerMask << kThinLockOwnerShift,
-    kThinLockMaxOwner = kThinLockOwnerMask,
+    // The top bit of the owner field flags a thin lock with a hash code. Keeping it in the owner
+    // field makes the lock and unlock fast paths, which compare the owner with the thread id,
+    // take the slow path for such lock words.
+    kThinLockHashCodeFlagShift = kThinLockOwnerShift + kThinLockOwnerSize - 1,
+    kThinLockHashCodeFlag = 1 << kThinLockHashCodeFlagShift,
+    kThinLockMaxOwner = kThinLockOwnerMask >> 1,
     // Count in higher bits.
     kThinLockCountShift = kThinLockOwnerSize + kThinLockOwnerShift,
     kThinLockCountMask = (1 << kThinLockCountSize) - 1,
@@ -139,11 +146,15 @@ class LockWord {
     kMaxMonitorId = kMaxHash
   };
 
-  static LockWord FromThinLockId(uint32_t thread_id, uint32_t count, uint32_t gc_state) {
+  static LockWord FromThinLockId(uint32_t thread_id,
+                                 uint32_t count,
+                                 uint32_t gc_state,
+                                 bool has_hash_code = false) {
     CHECK_LE(thread_id, static_cast<uint32_t>(kThinLockMaxOwner));
     CHECK_LE(count, static_cast<uint32_t>(kThinLockMaxCount));
     // DCHECK_EQ(gc_bits & kGCStateMaskToggled, 0U);
     return LockWord((thread_id << kThinLockOwnerShift) |
+                    (has_hash_code ? kThinLockHashCodeFlag : 0u) |
                     (count << kThinLockCountShift) |
                     (gc_state << kGCStateShift) |
                     (kStateThinOrUnlocked << kStateShift));
@@ -239,6 +250,11 @@ class LockWord {
   // Return the owner thin lock thread id.
   uint32_t ThinLockOwner() const;
 
+  // Return whether the owner of a thin lock has given the object an identity hash code. The hash
+  // code is kept by the owner thread, see `Thread::GetThinLockHashCode()`, and moves to the lock
+  // word, or to the monitor, when the lock is released, or inflated.
+  bool ThinLockHasHashCode() const;
+
   // Return the number of times a lock value has been re-locked. Only valid in thin-locked state.
   // If the lock is held only once the return value is zero.
   uint32_t ThinLockCount() const;
@@ -800,6 +800,92 @@ static bool DoMethodHandleInvokeMethod(Thread* self,
   return true;
 }
 
+class ThrowWrongMethodTypeFunctionImpl final : public ThrowWrongMethodTypeFunction {
+ public:
+  ThrowWrongMethodTypeFunctionImpl(Handle<mirror::MethodType> callsite_type,
+                                   Handle<mirror::MethodType> callee_type)
+      : callsite_type_(callsite_type),
+        callee_type_(callee_type) {}
+
+  void operator()() const override REQUIRES_SHARED(Locks::mutator_lock_) {
+    ThrowWrongMethodTypeException(callee_type_.Get(), callsite_type_.Get());
+  }
+
+ private:
+  Handle<mirror::MethodType> callsite_type_;
+  Handle<mirror::MethodType> callee_type_;
+};
+
+// Invokes the target method of a method handle from a call site whose type differs from the
+// handle type only by widening conversions, see `MethodType::IsWideningConvertible()`. The
+// arguments are converted straight into the callee frame, which avoids creating an asType()
+// transformer and the `EmulatedStackFrame`s it needs for every invocation.
+static bool DoMethodHandleInvokeMethodWithConversions(Thread* self,
+                                                      ShadowFrame& shadow_frame,
+                                                      Handle<mirror::MethodHandle> method_handle,
+                                                      Handle<mirror::MethodType> callsite_type,
+                                                      Handle<mirror::MethodType> method_handle_type,
+                                                      const InstructionOperands* const operands,
+                                                      JValue* result)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ArtMethod* target_method = method_handle->GetTargetMethod();
+  uint32_t receiver_reg = (operands->GetNumberOfOperands() > 0) ? operands->GetOperand(0) : 0u;
+  ArtMethod* called_method = RefineTargetMethod(self,
+                                                shadow_frame,
+                                                method_handle->GetHandleKind(),
+                                                method_handle_type.Get(),
+                                                receiver_reg,
+                                                target_method);
+  if (called_method == nullptr) {
+    DCHECK(self->IsExceptionPending());
+    return false;
+  }
+  // Compute method information.
+  CodeItemDataAccessor accessor(called_method->DexInstructionData());
+  uint16_t num_regs;
+  size_t first_dest_reg;
+  if (LIKELY(accessor.HasCodeItem())) {
+    num_regs = accessor.RegistersSize();
+    first_dest_reg = num_regs - accessor.InsSize();
+    // Parameter registers go at the end of the shadow frame.
+    DCHECK_NE(first_dest_reg, (size_t)-1);
+  } else {
+    // No local regs for proxy and native methods.
+    DCHECK(called_method->IsNative() || called_method->IsProxyMethod());
+    num_regs = GetInsForProxyOrNativeMethod(called_method);
+    first_dest_reg = 0;
+  }
+
+  StackHandleScope<2> hs(self);
+  ThrowWrongMethodTypeFunctionImpl throw_wmt(callsite_type, method_handle_type);
+  auto from_types = mirror::MethodType::NewHandlePTypes(callsite_type, &hs);
+  auto to_types = mirror::MethodType::NewHandlePTypes(method_handle_type, &hs);
+  ShadowFrameAllocaUniquePtr shadow_frame_unique_ptr =
+      CREATE_SHADOW_FRAME(num_regs, called_method, /* dex pc */ 0);
+  ShadowFrame* new_shadow_frame = shadow_frame_unique_ptr.get();
+  ShadowFrameGetter getter(shadow_frame, operands);
+  ShadowFrameSetter setter(new_shadow_frame, first_dest_reg);
+  if (!PerformConversions(throw_wmt, from_types, to_types, &getter, &setter)) {
+    DCHECK(self->IsExceptionPending());
+    return false;
+  }
+
+  PerformCall(self,
+              accessor,
+              shadow_frame.GetMethod(),
+              first_dest_reg,
+              new_shadow_frame,
+              result,
+              interpreter::ShouldStayInSwitchInterpreter(called_method));
+  if (self->IsExceptionPending()) {
+    return false;
+  }
+  return ConvertReturnValue(throw_wmt,
+                            method_handle_type->GetRType(),
+                            callsite_type->GetRType(),
+                            result);
+}
+
 static bool MethodHandleInvokeExactInternal(Thread* self,
                                             ShadowFrame& shadow_frame,
                                             Handle<mirror::MethodHandle> method_handle,
@@ -864,6 +950,30 @@ static bool MethodHandleInvokeInternal(Thread* self,
         self, shadow_frame, method_handle, method_handle_type, operands, result);
   }
 
+  // Widening primitive conversions, e.g. for an `int` argument of a `long` parameter, are
+  // common with hot lambdas and method references. For handles that directly invoke a method,
+  // perform them without an asType() adapter. Other handle kinds, in particular transformers,
+  // still go through asType().
+  switch (method_handle->GetHandleKind()) {
+    case mirror::MethodHandle::Kind::kInvokeDirect:
+    case mirror::MethodHandle::Kind::kInvokeInterface:
+    case mirror::MethodHandle::Kind::kInvokeStatic:
+    case mirror::MethodHandle::Kind::kInvokeSuper:
+    case mirror::MethodHandle::Kind::kInvokeVirtual:
+      if (callsite_type->IsWideningConvertible(method_handle_type.Get())) {
+        return DoMethodHandleInvokeMethodWithConversions(self,
+                                                         shadow_frame,
+                                                         method_handle,
+                                                         callsite_type,
+                                                         method_handle_type,
+                                                         operands,
+                                                         result);
+      }
+      break;
+    default:
+      break;
+  }
+
   // Use asType() variant of this MethodHandle to adapt callsite to the target.
   MutableHandle<mirror::MethodHandle> atc(hs.NewHandle(method_handle->GetAsTypeCache()));
   if (atc == nullptr || !callsite_type->IsExactMatch(atc->GetMethodType())) {
@@ -145,6 +145,9 @@ void MetricsReporter::BackgroundThreadRun() {
       backends_.emplace_back(std::move(backend));
     }
   }
+  if (config_.dump_to_trace) {
+    backends_.emplace_back(new TraceBackend());
+  }
 
   MaybeResetTimeout();
 
@@ -294,6 +297,7 @@ ReportingConfig ReportingConfig::FromFlags(bool is_system_server) {
   return {
       .dump_to_logcat = gFlags.MetricsWriteToLogcat(),
       .dump_to_statsd = gFlags.MetricsWriteToStatsd(),
+      .dump_to_trace = gFlags.MetricsWriteToTrace(),
       .dump_to_file = gFlags.MetricsWriteToFile.GetValueOptional(),
       .metrics_format = gFlags.MetricsFormat(),
       .period_spec = period_spec,
@@ -76,6 +76,9 @@ struct ReportingConfig {
   // Causes metrics to be written to statsd.
   bool dump_to_statsd{false};
 
+  // Causes metrics to be written as trace counters, at the reporting period.
+  bool dump_to_trace{false};
+
   // If set, provides a file name to enable metrics logging to a file.
   std::optional<std::string> dump_to_file;
 
@@ -195,6 +195,25 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kTimeElapsedDelta:
       return std::make_optional(
           statsd::ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_TIME_ELAPSED_MS);
+    // Not reported to statsd as atoms.proto has no matching kind.
+    case DatumId::kTlabRefillCount:
+    case DatumId::kTlabGrowCount:
+    case DatumId::kTlabShrinkCount:
+    case DatumId::kTlabRefillCountDelta:
+    case DatumId::kFinalizerEnqueueCount:
+    case DatumId::kFinalizerEnqueueCountDelta:
+    case DatumId::kRosAllocIdleRunRevokeBytes:
+    case DatumId::kRosAllocIdleRunRevokeBytesDelta:
+    case DatumId::kJitCodeBytesAllocated:
+    case DatumId::kJitStackMapBytesAllocated:
+    case DatumId::kJitCodeInvalidationCount:
+    case DatumId::kThreadTimeToSuspend:
+    case DatumId::kStartupHeapCreationTime:
+    case DatumId::kStartupClassLinkerInitTime:
+    case DatumId::kStartupIntrinsicsInitTime:
+    case DatumId::kStartupJitCreationTime:
+    case DatumId::kStartupPluginAndAgentLoadingTime:
+      return std::nullopt;
   }
 }
 
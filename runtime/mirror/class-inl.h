@@ -388,6 +388,9 @@ inline bool Class::Implements(ObjPtr<Class> klass) {
   // recursively all super-interfaces of those interfaces, are listed
   // in iftable_, so we can just do a linear scan through that.
   int32_t iftable_count = GetIfTableCount();
+  if (UNLIKELY(iftable_count > kMaxIfTableCountWithoutTypeCheckCache)) {
+    return ImplementsWithTypeCheckCache(klass);
+  }
   ObjPtr<IfTable> iftable = GetIfTable();
   for (int32_t i = 0; i < iftable_count; i++) {
     if (iftable->GetInterface(i) == klass) {
@@ -510,6 +510,28 @@ bool Class::IsThrowableClass() {
   return GetClassRoot<mirror::Throwable>()->IsAssignableFrom(this);
 }
 
+bool Class::ImplementsWithTypeCheckCache(ObjPtr<Class> klass) {
+  Thread* self = Thread::Current();
+  TypeCheckCache* cache = nullptr;
+  if (LIKELY(self != nullptr)) {
+    cache = self->GetTypeCheckCache();
+    if (cache->Contains(this, klass.Ptr())) {
+      return true;
+    }
+  }
+  int32_t iftable_count = GetIfTableCount();
+  ObjPtr<IfTable> iftable = GetIfTable();
+  for (int32_t i = 0; i < iftable_count; i++) {
+    if (iftable->GetInterface(i) == klass) {
+      if (cache != nullptr) {
+        cache->Add(this, klass.Ptr());
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
 template <typename SignatureType>
 static inline ArtMethod* FindInterfaceMethodWithSignature(ObjPtr<Class> klass,
                                                           std::string_view name,
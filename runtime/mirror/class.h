@@ -662,6 +662,9 @@ class EXPORT MANAGED Class final : public Object {
   // Check if this class implements a given interface.
   bool Implements(ObjPtr<Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Classes with more interfaces use the thread's `TypeCheckCache` in `Implements()`.
+  static constexpr int32_t kMaxIfTableCountWithoutTypeCheckCache = 8;
+
   // Checks if 'klass' is a redefined version of this.
   bool IsObsoleteVersionOf(ObjPtr<Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -1378,6 +1381,8 @@ class EXPORT MANAGED Class final : public Object {
   bool CheckIsVisibleWithTargetSdk(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
+  bool ImplementsWithTypeCheckCache(ObjPtr<Class> klass) REQUIRES_SHARED(Locks::mutator_lock_);
+
   template <typename T, VerifyObjectFlags kVerifyFlags, typename Visitor>
   void FixupNativePointer(
       Class* dest, PointerSize pointer_size, const Visitor& visitor, MemberOffset member_offset)
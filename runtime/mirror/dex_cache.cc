@@ -18,6 +18,7 @@
 
 #include "art_method-inl.h"
 #include "class_linker.h"
+#include "class_loader.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/heap.h"
 #include "jit/profile_saver.h"
@@ -202,6 +203,23 @@ bool DexCache::ShouldAllocateFullArrayAtStartup() {
   return true;
 }
 
+bool DexCache::ShouldGrowToFullArray() {
+  Runtime* runtime = Runtime::Current();
+  // Like for startup arrays, save memory in dex2oat and the zygote.
+  return !runtime->IsAotCompiler() && !runtime->IsZygote();
+}
+
+bool DexCache::IsAllocatedForClassLoader(void* array) {
+  if (array == nullptr) {
+    return false;
+  }
+  ObjPtr<ClassLoader> class_loader = GetClassLoader();
+  LinearAlloc* alloc = (class_loader == nullptr)
+      ? Runtime::Current()->GetLinearAlloc()
+      : class_loader->GetAllocator();
+  return alloc != nullptr && alloc->Contains(array);
+}
+
 void DexCache::UnlinkStartupCaches() {
   if (GetDexFile() == nullptr) {
     // Unused dex cache.
@@ -119,6 +119,20 @@ template <typename T> struct alignas(2 * __SIZEOF_POINTER__) NativeDexCachePair
   }
 };
 
+// Average number of conflicts per slot of a hash-based dex cache array after which the runtime
+// switches to a full array indexed by dex file index. See `DexCache::ShouldGrowToFullArray()`.
+// The full array costs a pointer per id, up to 512KiB for 64Ki ids with 64-bit pointers, so only
+// pay for it once every slot has on average been evicted several times. A dex file whose working
+// set fits the hash array only conflicts on a few slots and takes long to reach the limit, while
+// a larger working set conflicts on most slots and reaches it quickly. With 1024 slots, the limit
+// is 4096 conflicts.
+static constexpr uint32_t kDexCacheConflictsPerSlotForFullArray = 4u;
+
+inline uint32_t CountConflict(std::atomic<uint32_t>* counter, bool conflict) {
+  return conflict ? counter->fetch_add(1u, std::memory_order_relaxed) + 1u
+                  : counter->load(std::memory_order_relaxed);
+}
+
 template <typename T, size_t size> class NativeDexCachePairArray {
  public:
   NativeDexCachePairArray() {}
@@ -141,7 +155,22 @@ template <typename T, size_t size> class NativeDexCachePairArray {
     SetNativePair(entries_, SlotIndex(index), value);
   }
 
+  // Set the entry and return the number of entries evicted for another index so far.
+  uint32_t SetAndCountConflicts(uint32_t index, T* value) REQUIRES_SHARED(Locks::mutator_lock_) {
+    NativeDexCachePair<T> old_pair = GetNativePair(index);
+    Set(index, value);
+    bool conflict = old_pair.object != nullptr && old_pair.index != index;
+    return CountConflict(GetConflictCounter(), conflict);
+  }
+
  private:
+  // The conflict counter is kept in the index of an extra entry past the end of the array.
+  std::atomic<uint32_t>* GetConflictCounter() {
+    return reinterpret_cast<std::atomic<uint32_t>*>(
+        reinterpret_cast<uint8_t*>(&entries_[size]) +
+        OFFSETOF_MEMBER(NativeDexCachePair<T>, index));
+  }
+
   NativeDexCachePair<T> GetNativePair(std::atomic<NativeDexCachePair<T>>* pair_array, size_t idx) {
     auto* array = reinterpret_cast<AtomicPair<uintptr_t>*>(pair_array);
     AtomicPair<uintptr_t> value = AtomicPairLoadAcquire(&array[idx]);
@@ -186,6 +215,14 @@ template <typename T, size_t size> class DexCachePairArray {
     entries_[SlotIndex(index)].store(value, std::memory_order_release);
   }
 
+  // Set the entry and return the number of entries evicted for another index so far.
+  uint32_t SetAndCountConflicts(uint32_t index, T* value) REQUIRES_SHARED(Locks::mutator_lock_) {
+    DexCachePair<T> old_pair = GetPair(index);
+    Set(index, value);
+    bool conflict = !old_pair.object.IsNull() && old_pair.index != index;
+    return CountConflict(GetConflictCounter(), conflict);
+  }
+
   void Clear(uint32_t index) {
     uint32_t slot = SlotIndex(index);
     // This is racy but should only be called from the transactional interpreter.
@@ -200,6 +237,13 @@ template <typename T, size_t size> class DexCachePairArray {
     return index % size;
   }
 
+  // The conflict counter is kept in the index of an extra entry past the end of the array.
+  // The object of that entry stays null, so GC root visitors skip it.
+  std::atomic<uint32_t>* GetConflictCounter() {
+    return reinterpret_cast<std::atomic<uint32_t>*>(
+        reinterpret_cast<uint8_t*>(&entries_[size]) + OFFSETOF_MEMBER(DexCachePair<T>, index));
+  }
+
   std::atomic<DexCachePair<T>> entries_[0];
 
   DexCachePairArray(const DexCachePairArray<T, size>&) = delete;
@@ -434,9 +478,10 @@ class MANAGED DexCache final : public Object {
   } \
   pair_kind ##Array<type, size>* Allocate ##getter_setter() \
       REQUIRES_SHARED(Locks::mutator_lock_) { \
+    /* Allocate an extra entry for the conflict counter. */ \
     return reinterpret_cast<pair_kind ##Array<type, size>*>( \
         AllocArray<std::atomic<pair_kind<type>>>( \
-            getter_setter ##Offset(), size, alloc_kind)); \
+            getter_setter ##Offset(), size + 1u, alloc_kind)); \
   } \
   template<VerifyObjectFlags kVerifyFlags = kDefaultVerifyFlags> \
   size_t Num ##getter_setter() REQUIRES_SHARED(Locks::mutator_lock_) { \
@@ -479,14 +524,18 @@ class MANAGED DexCache final : public Object {
           pairs = Allocate ##getter_setter(); \
           pairs->Set(index, resolved); \
         } \
-      } else { \
-        pairs->Set(index, resolved); \
+      } else if (pairs->SetAndCountConflicts(index, resolved) >= \
+                     kDexCacheConflictsPerSlotForFullArray * pair_size && \
+                 ShouldGrowToFullArray()) { \
+        array = Allocate ##getter_setter ##Array(); \
+        array->Set(index, resolved); \
       } \
     } \
   } \
   void Unlink ##getter_setter ##ArrayIfStartup() \
       REQUIRES_SHARED(Locks::mutator_lock_) { \
-    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size)) { \
+    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size) && \
+        !IsAllocatedForClassLoader(Get ##getter_setter ##Array())) { \
       Set ##getter_setter ##Array(nullptr) ; \
     } \
   }
@@ -573,6 +622,14 @@ class MANAGED DexCache final : public Object {
   // the runtime and oat files.
   bool ShouldAllocateFullArrayAtStartup() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns whether a hash-based array with too many conflicts should be replaced by a
+  // full array. Entries are then resolved again once into the full array.
+  bool ShouldGrowToFullArray() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns whether `array` lives in the LinearAlloc of the class loader, as opposed to
+  // the startup LinearAlloc or the runtime app image.
+  bool IsAllocatedForClassLoader(void* array) REQUIRES_SHARED(Locks::mutator_lock_);
+
   HeapReference<ClassLoader> class_loader_;
   HeapReference<String> location_;
 
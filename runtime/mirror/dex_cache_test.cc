@@ -25,6 +25,7 @@
 #include "linear_alloc.h"
 #include "mirror/class_loader-inl.h"
 #include "mirror/dex_cache-inl.h"
+#include "mirror/string.h"
 #include "scoped_thread_state_change-inl.h"
 
 namespace art HIDDEN {
@@ -72,6 +73,46 @@ TEST_F(DexCacheMethodHandlesTest, Open) {
   EXPECT_EQ(0u, dex_cache->NumResolvedMethodTypes());
 }
 
+TEST_F(DexCacheTest, GrowToFullArray) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  ASSERT_TRUE(java_lang_dex_file_ != nullptr);
+  constexpr size_t kSlots = DexCache::kDexCacheStringCacheSize;
+  ASSERT_GT(java_lang_dex_file_->NumStringIds(), kSlots);
+  // The boot class path does not get full arrays at startup, so the strings start out in the
+  // hash-based array.
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocAndInitializeDexCache(
+          soa.Self(), *java_lang_dex_file_, /*class_loader=*/nullptr)));
+  ASSERT_TRUE(dex_cache != nullptr);
+  Handle<String> string(hs.NewHandle(String::AllocFromModifiedUtf8(soa.Self(), "string")));
+  ASSERT_TRUE(string != nullptr);
+
+  // Alternate between two indexes which share slot 0, so that every store but the first one
+  // evicts the other index.
+  const dex::StringIndex first(0u);
+  const dex::StringIndex second(kSlots);
+  const uint32_t limit = kDexCacheConflictsPerSlotForFullArray * kSlots;
+  dex_cache->SetResolvedString(first, string.Get());
+  for (uint32_t i = 1u; i != limit; ++i) {
+    dex_cache->SetResolvedString((i % 2u == 0u) ? first : second, string.Get());
+    ASSERT_TRUE(dex_cache->GetStringsArray() == nullptr) << i;
+  }
+  EXPECT_EQ(kSlots, dex_cache->NumStrings());
+  EXPECT_TRUE(dex_cache->GetResolvedString(first) == nullptr);
+  EXPECT_OBJ_PTR_EQ(string.Get(), dex_cache->GetResolvedString(second));
+
+  // The next conflict switches to the full array, where both indexes are kept.
+  dex_cache->SetResolvedString(first, string.Get());
+  ASSERT_TRUE(dex_cache->GetStringsArray() != nullptr);
+  EXPECT_EQ(java_lang_dex_file_->NumStringIds(), dex_cache->NumStringsArray());
+  EXPECT_OBJ_PTR_EQ(string.Get(), dex_cache->GetResolvedString(first));
+  EXPECT_TRUE(dex_cache->GetResolvedString(second) == nullptr);
+  dex_cache->SetResolvedString(second, string.Get());
+  EXPECT_OBJ_PTR_EQ(string.Get(), dex_cache->GetResolvedString(first));
+  EXPECT_OBJ_PTR_EQ(string.Get(), dex_cache->GetResolvedString(second));
+}
+
 TEST_F(DexCacheTest, TestResolvedFieldAccess) {
   ScopedObjectAccess soa(Thread::Current());
   jobject jclass_loader(LoadDex("Packages"));
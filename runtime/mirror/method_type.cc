@@ -224,8 +224,29 @@ static bool IsParameterInPlaceConvertible(ObjPtr<Class> from, ObjPtr<Class> to)
   return to->IsAssignableFrom(from);
 }
 
-bool MethodType::IsInPlaceConvertible(ObjPtr<MethodType> target) {
-  const ObjPtr<ObjectArray<Class>> ptypes = GetPTypes();
+static bool IsParameterWideningConvertible(ObjPtr<Class> from, ObjPtr<Class> to)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (from == to) {
+    return true;
+  }
+
+  if (from->IsPrimitive() != to->IsPrimitive()) {
+    return false;  // Boxing and unboxing can fail or allocate.
+  }
+
+  if (from->IsPrimitive()) {
+    // Conversions are documented in JLS 11 S5.1.2 "Widening Primitive Conversion".
+    return Primitive::IsWidenable(from->GetPrimitiveType(), to->GetPrimitiveType());
+  }
+
+  // `from` and `to` are both references, apply an assignability check.
+  return to->IsAssignableFrom(from);
+}
+
+template <bool (*kIsParameterConvertible)(ObjPtr<Class>, ObjPtr<Class>)>
+static bool IsConvertibleImpl(ObjPtr<MethodType> method_type, ObjPtr<MethodType> target)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  const ObjPtr<ObjectArray<Class>> ptypes = method_type->GetPTypes();
   const ObjPtr<ObjectArray<Class>> target_ptypes = target->GetPTypes();
   const int32_t ptypes_length = ptypes->GetLength();
   if (ptypes_length != target_ptypes->GetLength()) {
@@ -233,14 +254,22 @@ bool MethodType::IsInPlaceConvertible(ObjPtr<MethodType> target) {
   }
 
   for (int32_t i = 0; i < ptypes_length; ++i) {
-    if (!IsParameterInPlaceConvertible(ptypes->GetWithoutChecks(i),
-                                       target_ptypes->GetWithoutChecks(i))) {
+    if (!kIsParameterConvertible(ptypes->GetWithoutChecks(i),
+                                 target_ptypes->GetWithoutChecks(i))) {
       return false;
     }
   }
 
-  return GetRType()->IsPrimitiveVoid() ||
-         IsParameterInPlaceConvertible(target->GetRType(), GetRType());
+  return method_type->GetRType()->IsPrimitiveVoid() ||
+         kIsParameterConvertible(target->GetRType(), method_type->GetRType());
+}
+
+bool MethodType::IsInPlaceConvertible(ObjPtr<MethodType> target) {
+  return IsConvertibleImpl<IsParameterInPlaceConvertible>(this, target);
+}
+
+bool MethodType::IsWideningConvertible(ObjPtr<MethodType> target) {
+  return IsConvertibleImpl<IsParameterWideningConvertible>(this, target);
 }
 
 template <typename MethodTypeType>
@@ -99,6 +99,11 @@ class MANAGED MethodType : public Object {
   // for references and between scalar 32-bit types.
   bool IsInPlaceConvertible(ObjPtr<MethodType> target) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns true iff. |this| can be converted to match |target| method type with conversions
+  // that cannot fail, namely assignability for references and widening primitive conversions.
+  // Such call sites do not need an asType() adapter.
+  bool IsWideningConvertible(ObjPtr<MethodType> target) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Returns the pretty descriptor for this method type, suitable for display in
   // exception messages and the like.
   std::string PrettyDescriptor() REQUIRES_SHARED(Locks::mutator_lock_);
@@ -207,5 +207,52 @@ TEST_F(MethodTypeTest, IsInPlaceConvertible) {
   }
 }
 
+TEST_F(MethodTypeTest, IsWideningConvertible) {
+  ScopedObjectAccess soa(Thread::Current());
+
+  // Widening primitive conversions that need a different representation.
+  {
+    StackHandleScope<2> hs(soa.Self());
+    Handle<mirror::MethodType> cs = hs.NewHandle(CreateMethodType("D", { "I", "F", "C" }));
+    Handle<mirror::MethodType> mh = hs.NewHandle(CreateMethodType("J", { "J", "D", "I" }));
+    ASSERT_TRUE(cs->IsWideningConvertible(mh.Get()));
+    ASSERT_FALSE(cs->IsInPlaceConvertible(mh.Get()));
+    ASSERT_FALSE(mh->IsWideningConvertible(cs.Get()));
+  }
+
+  // Assignable Reference Types
+  {
+    StackHandleScope<2> hs(soa.Self());
+    Handle<mirror::MethodType> cs = hs.NewHandle(CreateMethodType("Object", { "Integer" }));
+    Handle<mirror::MethodType> mh = hs.NewHandle(CreateMethodType("String", { "Object" }));
+    ASSERT_TRUE(cs->IsWideningConvertible(mh.Get()));
+  }
+
+  // No boxing or unboxing.
+  {
+    StackHandleScope<2> hs(soa.Self());
+    Handle<mirror::MethodType> cs = hs.NewHandle(CreateMethodType("V", { "I" }));
+    Handle<mirror::MethodType> mh = hs.NewHandle(CreateMethodType("V", { "Integer" }));
+    ASSERT_FALSE(cs->IsWideningConvertible(mh.Get()));
+    ASSERT_FALSE(mh->IsWideningConvertible(cs.Get()));
+  }
+
+  // No conversions from or to boolean.
+  {
+    StackHandleScope<2> hs(soa.Self());
+    Handle<mirror::MethodType> cs = hs.NewHandle(CreateMethodType("V", { "Z" }));
+    Handle<mirror::MethodType> mh = hs.NewHandle(CreateMethodType("V", { "J" }));
+    ASSERT_FALSE(cs->IsWideningConvertible(mh.Get()));
+  }
+
+  // Signed types do not widen to char.
+  {
+    StackHandleScope<2> hs(soa.Self());
+    Handle<mirror::MethodType> cs = hs.NewHandle(CreateMethodType("V", { "B" }));
+    Handle<mirror::MethodType> mh = hs.NewHandle(CreateMethodType("V", { "C" }));
+    ASSERT_FALSE(cs->IsWideningConvertible(mh.Get()));
+  }
+}
+
 }  // namespace mirror
 }  // namespace art
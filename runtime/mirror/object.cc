@@ -204,12 +204,35 @@ int32_t Object::IdentityHashCodeHelper() {
         break;
       }
       case LockWord::kThinLocked: {
+        Thread* self = Thread::Current();
+        if (lw.ThinLockOwner() == self->GetThreadId()) {
+          // We hold the lock, so only we can change its owner and count. Keep the hash code with
+          // this thread until the lock is released instead of inflating the lock, which is common
+          // for objects that are both synchronized on and used as hash map keys.
+          if (lw.ThinLockHasHashCode()) {
+            return self->GetThinLockHashCode(self, current_this);
+          }
+          int32_t hash_code = GenerateIdentityHashCode();
+          if (self->AddThinLockHashCode(current_this, hash_code)) {
+            LockWord hash_lw = LockWord::FromThinLockId(lw.ThinLockOwner(),
+                                                        lw.ThinLockCount(),
+                                                        lw.GCState(),
+                                                        /* has_hash_code= */ true);
+            // Use a strong CAS, as above. It can only fail if the GC state changed.
+            if (current_this->CasLockWord(
+                    lw, hash_lw, CASMode::kStrong, std::memory_order_relaxed)) {
+              return hash_code;
+            }
+            self->RemoveThinLockHashCode(current_this);
+            break;
+          }
+          // Too many thin locks with hash codes held by this thread, inflate.
+        }
         if (!kAllowInflation) {
           return 0;
         }
         // Inflate the thin lock to a monitor and stick the hash code inside of the monitor. May
         // fail spuriously.
-        Thread* self = Thread::Current();
         StackHandleScope<1> hs(self);
         Handle<mirror::Object> h_this(hs.NewHandle(current_this));
         Monitor::InflateThinLocked(self, h_this, lw, GenerateIdentityHashCode());
@@ -16,10 +16,12 @@
 
 #include <android-base/properties.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "android-base/stringprintf.h"
 #include "art_method-inl.h"
+#include "base/lock_contention_profiler.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex.h"
 #include "base/quasi_atomic.h"
@@ -97,6 +99,8 @@ void Monitor::Init(uint32_t lock_profiling_threshold,
 Monitor::Monitor(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_t hash_code)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      spin_score_(0),
+      used_since_sweep_(true),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -131,6 +135,8 @@ Monitor::Monitor(Thread* self,
                  MonitorId id)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      spin_score_(0),
+      used_since_sweep_(true),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -238,6 +244,11 @@ bool Monitor::Install(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
       CHECK_EQ(owner->GetThreadId(), lw.ThinLockOwner());
       DCHECK_EQ(monitor_lock_.GetExclusiveOwnerTid(), 0) << " my tid = " << SafeGetTid(self);
       lock_count_ = lw.ThinLockCount();
+      if (lw.ThinLockHasHashCode()) {
+        // Take over the hash code kept by the owner. Any hash code we were inflated with was
+        // generated by another thread that found the lock word in this state, and is unused.
+        hash_code_.store(owner->GetThinLockHashCode(self, GetObject()), std::memory_order_relaxed);
+      }
       monitor_lock_.ExclusiveLockUncontendedFor(owner);
       DCHECK_EQ(monitor_lock_.GetExclusiveOwnerTid(), owner->GetTid())
           << " my tid = " << SafeGetTid(self);
@@ -245,6 +256,9 @@ bool Monitor::Install(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
       // Publish the updated lock word, which may race with other threads.
       bool success = GetObject()->CasLockWord(lw, fat, CASMode::kWeak, std::memory_order_release);
       if (success) {
+        if (lw.ThinLockHasHashCode()) {
+          owner->RemoveThinLockHashCode(GetObject());
+        }
         if (ATraceEnabled()) {
           SetLockingMethod(owner);
         }
@@ -439,14 +453,51 @@ bool Monitor::TryLock(Thread* self, bool spin) {
     }
   }
   DCHECK(monitor_lock_.IsExclusiveHeld(self));
+  used_since_sweep_.store(true, std::memory_order_relaxed);
   AtraceMonitorLock(self, GetObject(), /* is_wait= */ false);
   return true;
 }
 
+bool Monitor::TryLockWithAdaptiveSpinning(Thread* self) {
+  // Only contended acquisitions affect the spinning policy.
+  if (TryLock(self)) {
+    return true;
+  }
+  int8_t score = spin_score_.load(std::memory_order_relaxed);
+  if (score < 0) {
+    // Spinning did not pay off recently, block without spinning.
+    spin_score_.store(score + 1, std::memory_order_relaxed);
+    return false;
+  }
+  bool success = TryLock(self, /*spin=*/ true);
+  int8_t new_score = success
+      ? std::min<int8_t>(score + 1, kMaxSpinScore)
+      : std::max<int8_t>(score - kSpinFailurePenalty, kMinSpinScore);
+  spin_score_.store(new_score, std::memory_order_relaxed);
+  return success;
+}
+
+void Monitor::RecordContentionSample(Thread* self, ArtMethod* owners_method, uint64_t wait_ns) {
+  uint32_t pc;
+  ArtMethod* m = self->GetCurrentMethod(&pc);
+  // The lock site is the pair of the contending method and the owner's method.
+  uintptr_t site = reinterpret_cast<uintptr_t>(m) ^
+      (reinterpret_cast<uintptr_t>(owners_method) * static_cast<uintptr_t>(0x9e3779b97f4a7c15));
+  site = (site != 0u) ? site : 1u;
+  // Only pretty-print the methods for the first sample of a site.
+  std::string name;
+  if (!LockContentionProfiler::HasSite(site)) {
+    name = ArtMethod::PrettyMethod(m);
+    name += " blocked by ";
+    name += (owners_method != nullptr) ? ArtMethod::PrettyMethod(owners_method) : "unknown method";
+  }
+  LockContentionProfiler::RecordWait(site, name, wait_ns);
+}
+
 template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   bool called_monitors_callback = false;
-  if (TryLock(self, /*spin=*/ true)) {
+  if (TryLockWithAdaptiveSpinning(self)) {
     // TODO: This preserves original behavior. Correct?
     if (called_monitors_callback) {
       CHECK(reason == LockReason::kForLock);
@@ -457,6 +508,10 @@ void Monitor::Lock(Thread* self) {
   // Contended; not reentrant. We hold no locks, so tread carefully.
   const bool log_contention = (lock_profiling_threshold_ != 0);
   uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
+  const bool sample_contention = LockContentionProfiler::ShouldSample();
+  uint64_t sample_start_ns = sample_contention ? NanoTime() : 0u;
+  uint64_t sample_wait_ns = 0u;
+  ArtMethod* sampled_owners_method = nullptr;
 
   Thread *orig_owner = nullptr;
   ArtMethod* owners_method;
@@ -498,7 +553,7 @@ void Monitor::Lock(Thread* self) {
       Locks::thread_list_lock_->ExclusiveUnlock(self);
     }
   }
-  if (log_contention) {
+  if (log_contention || sample_contention) {
     // Request the current holder to set lock_owner_info.
     // Do this even if tracing is enabled, so we semi-consistently get the information
     // corresponding to MonitorExit.
@@ -521,8 +576,29 @@ void Monitor::Lock(Thread* self) {
     // Acquire monitor_lock_ without mutator_lock_, expecting to block this time.
     // We already tried spinning above. The shutdown procedure currently assumes we stop
     // touching monitors shortly after we suspend, so don't spin again here.
+    if (sample_contention && orig_owner != nullptr) {
+      // Use what is already known about the owner, e.g. from tracing, in case the owner
+      // releases the monitor without seeing the request.
+      uint32_t sampled_owners_dex_pc;
+      GetLockOwnerInfo(&sampled_owners_method, &sampled_owners_dex_pc, orig_owner);
+    }
     monitor_lock_.ExclusiveLock(self);
 
+    if (sample_contention) {
+      sample_wait_ns = NanoTime() - sample_start_ns;
+      if (orig_owner != nullptr) {
+        // The owner answered the request when it released the monitor. Read the answer before
+        // anything overwrites it: our own locking method once we are the owner, or the request
+        // of a later contender once we release the monitor.
+        ArtMethod* owners_method = nullptr;
+        uint32_t sampled_owners_dex_pc;
+        GetLockOwnerInfo(&owners_method, &sampled_owners_dex_pc, orig_owner);
+        if (owners_method != nullptr) {
+          sampled_owners_method = owners_method;
+        }
+      }
+    }
+
     if (log_contention && orig_owner != nullptr) {
       // Woken from contention.
       uint64_t wait_ms = MilliTime() - wait_start_ms;
@@ -637,6 +713,9 @@ void Monitor::Lock(Thread* self) {
   self->SetMonitorEnterObject(nullptr);
   num_waiters_.fetch_sub(1, std::memory_order_relaxed);
   DCHECK(monitor_lock_.IsExclusiveHeld(self));
+  if (sample_contention) {
+    RecordContentionSample(self, sampled_owners_method, sample_wait_ns);
+  }
   // We need to pair this with a single contended locking call. NB we match the RI behavior and call
   // this even if MonitorEnter failed.
   if (called_monitors_callback) {
@@ -1138,7 +1217,8 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
           if (LIKELY(new_count <= LockWord::kThinLockMaxCount)) {
             LockWord thin_locked(LockWord::FromThinLockId(thread_id,
                                                           new_count,
-                                                          lock_word.GCState()));
+                                                          lock_word.GCState(),
+                                                          lock_word.ThinLockHasHashCode()));
             // Only this thread pays attention to the count. Thus there is no need for stronger
             // than relaxed memory ordering.
             if (!gUseReadBarrier) {
@@ -1235,9 +1315,16 @@ bool Monitor::MonitorExit(Thread* self, ObjPtr<mirror::Object> obj) {
         } else {
           // We own the lock, decrease the recursion count.
           LockWord new_lw = LockWord::Default();
+          // Whether we release a lock with a hash code, which then moves to the lock word.
+          bool release_hash_code = false;
           if (lock_word.ThinLockCount() != 0) {
             uint32_t new_count = lock_word.ThinLockCount() - 1;
-            new_lw = LockWord::FromThinLockId(thread_id, new_count, lock_word.GCState());
+            new_lw = LockWord::FromThinLockId(
+                thread_id, new_count, lock_word.GCState(), lock_word.ThinLockHasHashCode());
+          } else if (lock_word.ThinLockHasHashCode()) {
+            release_hash_code = true;
+            new_lw = LockWord::FromHashCode(self->GetThinLockHashCode(self, h_obj.Get()),
+                                            lock_word.GCState());
           } else {
             new_lw = LockWord::FromDefault(lock_word.GCState());
           }
@@ -1247,12 +1334,18 @@ bool Monitor::MonitorExit(Thread* self, ObjPtr<mirror::Object> obj) {
             // no way to specify that. In fact there seem to be no legitimate uses of SetLockWord
             // with a final argument of true. This slows down x86 and ARMv7, but probably not v8.
             h_obj->SetLockWord(new_lw, true);
+            if (release_hash_code) {
+              self->RemoveThinLockHashCode(h_obj.Get());
+            }
             AtraceMonitorUnlock();
             // Success!
             return true;
           } else {
             // Use CAS to preserve the read barrier state.
             if (h_obj->CasLockWord(lock_word, new_lw, CASMode::kWeak, std::memory_order_release)) {
+              if (release_hash_code) {
+                self->RemoveThinLockHashCode(h_obj.Get());
+              }
               AtraceMonitorUnlock();
               // Success!
               return true;
@@ -1660,8 +1753,18 @@ void MonitorList::Add(Monitor* m) {
   list_.push_front(m);
 }
 
-void MonitorList::SweepMonitorList(IsMarkedVisitor* visitor) {
+// Returns whether the lock word of `obj` is inflated to the monitor `m`.
+static bool IsFatLockedBy(ObjPtr<mirror::Object> obj, Monitor* m)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  LockWord lock_word = obj->GetLockWord(false);
+  return lock_word.GetState() == LockWord::kFatLocked && lock_word.FatLockMonitor() == m;
+}
+
+void MonitorList::SweepMonitorList(IsMarkedVisitor* visitor, bool deflate_idle_monitors) {
   Thread* self = Thread::Current();
+  // Deflation rewrites the lock word, which is only safe with mutators suspended.
+  deflate_idle_monitors = deflate_idle_monitors && Locks::mutator_lock_->IsExclusiveHeld(self);
+  size_t deflated = 0u;
   MutexLock mu(self, monitor_list_lock_);
   for (auto it = list_.begin(); it != list_.end(); ) {
     Monitor* m = *it;
@@ -1676,9 +1779,23 @@ void MonitorList::SweepMonitorList(IsMarkedVisitor* visitor) {
       it = list_.erase(it);
     } else {
       m->SetObject(new_obj);
-      ++it;
+      // Only release the monitor if the object's lock word referred to it and no longer does.
+      if (deflate_idle_monitors &&
+          IsFatLockedBy(new_obj, m) &&
+          !m->used_since_sweep_.exchange(false, std::memory_order_relaxed) &&
+          Monitor::Deflate(self, new_obj) &&
+          !IsFatLockedBy(new_obj, m)) {
+        MonitorPool::ReleaseMonitor(self, m);
+        it = list_.erase(it);
+        ++deflated;
+      } else {
+        ++it;
+      }
     }
   }
+  if (deflated != 0u) {
+    VLOG(monitor) << "deflated " << deflated << " idle monitors";
+  }
 }
 
 size_t MonitorList::Size() {
@@ -238,6 +238,17 @@ class Monitor {
       TRY_ACQUIRE(true, monitor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Record a sampled contended acquisition that waited `wait_ns` for an owner that held the
+  // monitor in `owners_method`, if known.
+  void RecordContentionSample(Thread* self, ArtMethod* owners_method, uint64_t wait_ns)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Try to lock without blocking. If the monitor is contended, spin for a short period
+  // unless spinning failed to get this monitor recently.
+  bool TryLockWithAdaptiveSpinning(Thread* self)
+      TRY_ACQUIRE(true, monitor_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   template<LockReason reason = LockReason::kForLock>
   void Lock(Thread* self)
       ACQUIRE(monitor_lock_)
@@ -331,6 +342,21 @@ class Monitor {
   // monitor acquisition. Prevents deflation.
   std::atomic<size_t> num_waiters_;
 
+  // Outcome of the recent contended acquisitions of this monitor, between kMinSpinScore
+  // and kMaxSpinScore. Contended acquisitions spin only while the score is not negative.
+  // A spin that gets the lock raises it, a spin that fails lowers it by more so that
+  // monitors held for long quickly stop spinning, and each acquisition that skips the
+  // spin raises it again so that shorter hold times are noticed. Updates may race and
+  // lose increments, which only makes the heuristic less precise.
+  std::atomic<int8_t> spin_score_;
+  static constexpr int8_t kMinSpinScore = -16;
+  static constexpr int8_t kMaxSpinScore = 8;
+  static constexpr int8_t kSpinFailurePenalty = 4;
+
+  // Whether the monitor was acquired since the last sweep of the monitor list that
+  // could deflate it. Monitors that stay unused for a whole GC cycle get deflated.
+  std::atomic<bool> used_since_sweep_;
+
   // Which thread currently owns the lock? monitor_lock_ only keeps the tid.
   // Only set while holding monitor_lock_. Non-locking readers only use it to
   // compare to self or for debugging.
@@ -439,6 +465,7 @@ class Monitor {
   friend class MonitorInfo;
   friend class MonitorList;
   friend class MonitorPool;
+  friend class MonitorTest;  // For the adaptive spinning state.
   friend class mirror::Object;
   DISALLOW_COPY_AND_ASSIGN(Monitor);
 };
@@ -450,7 +477,11 @@ class MonitorList {
 
   void Add(Monitor* m) REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!monitor_list_lock_);
 
-  void SweepMonitorList(IsMarkedVisitor* visitor)
+  // Free the monitors of dead objects. With `deflate_idle_monitors`, also deflate the
+  // monitors that were not acquired since the previous such sweep. That rewrites the lock
+  // word of the objects, so the caller must have suspended the mutators and the visitor must
+  // return the address the object is at, not the one it will be moved to later.
+  void SweepMonitorList(IsMarkedVisitor* visitor, bool deflate_idle_monitors = false)
       REQUIRES(!monitor_list_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
   void DisallowNewMonitors() REQUIRES(!monitor_list_lock_);
   void AllowNewMonitors() REQUIRES(!monitor_list_lock_);
@@ -18,18 +18,22 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/atomic.h"
 #include "barrier.h"
 #include "base/time_utils.h"
 #include "class_linker-inl.h"
 #include "common_runtime_test.h"
+#include "gc/heap.h"
 #include "handle_scope-inl.h"
 #include "jni/java_vm_ext.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
+#include "object_callbacks.h"
 #include "object_lock.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_list.h"
 #include "thread_pool.h"
 
 namespace art HIDDEN {
@@ -48,6 +52,26 @@ class MonitorTest : public CommonRuntimeTest {
   }
 
  public:
+  static bool TryLockWithAdaptiveSpinning(Monitor* monitor, Thread* self)
+      NO_THREAD_SAFETY_ANALYSIS {
+    bool success = monitor->TryLockWithAdaptiveSpinning(self);
+    if (success) {
+      monitor->Unlock(self);
+    }
+    return success;
+  }
+
+  static int8_t GetSpinScore(Monitor* monitor) {
+    return monitor->spin_score_.load(std::memory_order_relaxed);
+  }
+
+  static void SetSpinScore(Monitor* monitor, int8_t score) {
+    monitor->spin_score_.store(score, std::memory_order_relaxed);
+  }
+
+  static constexpr int8_t kMaxSpinScore = Monitor::kMaxSpinScore;
+  static constexpr int8_t kSpinFailurePenalty = Monitor::kSpinFailurePenalty;
+
   std::unique_ptr<Monitor> monitor_;
   jobject object_;
   jobject watchdog_object_;
@@ -85,15 +109,29 @@ class CreateTask : public Task {
       return;
     }
 
-    // Force a fat lock by running identity hashcode to fill up lock word.
-    obj->IdentityHashCode();
+    // Running identity hashcode keeps the lock thin, as we own it.
+    int32_t hash_code = obj->IdentityHashCode();
     LockWord lock_after2 = obj->GetLockWord(false);
     LockWord::LockState new_state2 = lock_after2.GetState();
 
     // Cannot use ASSERT only, as analysis thinks we'll keep holding the mutex.
-    if (LockWord::LockState::kFatLocked != new_state2) {
+    if (LockWord::LockState::kThinLocked != new_state2 || !lock_after2.ThinLockHasHashCode()) {
+      obj->MonitorExit(self);         // To appease analysis.
+      ASSERT_EQ(LockWord::LockState::kThinLocked, new_state2);  // To fail the test.
+      ASSERT_TRUE(lock_after2.ThinLockHasHashCode());
+      return;
+    }
+
+    // Force a fat lock, which takes over the hash code.
+    Monitor::InflateThinLocked(self, obj, lock_after2, 0u);
+    LockWord lock_after3 = obj->GetLockWord(false);
+    LockWord::LockState new_state3 = lock_after3.GetState();
+
+    // Cannot use ASSERT only, as analysis thinks we'll keep holding the mutex.
+    if (LockWord::LockState::kFatLocked != new_state3 || obj->IdentityHashCode() != hash_code) {
       obj->MonitorExit(self);         // To appease analysis.
-      ASSERT_EQ(LockWord::LockState::kFatLocked, new_state2);  // To fail the test.
+      ASSERT_EQ(LockWord::LockState::kFatLocked, new_state3);  // To fail the test.
+      ASSERT_EQ(hash_code, obj->IdentityHashCode());
       return;
     }
 
@@ -391,5 +429,300 @@ TEST_F(MonitorTest, TestTryLock) {
   thread_pool->StopWorkers(self);
 }
 
+class AdaptiveSpinTask : public Task {
+ public:
+  AdaptiveSpinTask(jobject obj, size_t num_attempts, std::vector<int8_t>* scores)
+      : obj_(obj), num_attempts_(num_attempts), scores_(scores) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    Monitor* monitor = soa.Decode<mirror::Object>(obj_)->GetLockWord(false).FatLockMonitor();
+    for (size_t i = 0; i != num_attempts_; ++i) {
+      // The lock is held by the other thread for the whole test, every attempt fails.
+      EXPECT_FALSE(MonitorTest::TryLockWithAdaptiveSpinning(monitor, self));
+      scores_->push_back(MonitorTest::GetSpinScore(monitor));
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  jobject obj_;
+  size_t num_attempts_;
+  std::vector<int8_t>* scores_;
+};
+
+// Test that contenders stop spinning on a monitor held for long, and try again later.
+TEST_F(MonitorTest, AdaptiveSpinning) {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(ThreadPool::Create("the pool", 1));
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  jobject g_obj = soa.Vm()->AddGlobalRef(self, obj.Get());
+  ASSERT_TRUE(g_obj != nullptr);
+  Monitor* monitor;
+  std::vector<int8_t> scores;
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    Monitor::InflateThinLocked(self, obj, obj->GetLockWord(false), /*hash_code=*/ 0);
+    LockWord lock_word = obj->GetLockWord(false);
+    ASSERT_EQ(LockWord::LockState::kFatLocked, lock_word.GetState());
+    monitor = lock_word.FatLockMonitor();
+    EXPECT_EQ(0, MonitorTest::GetSpinScore(monitor));
+
+    // A failed spin makes the next contenders block right away, each of them moving the
+    // score back up until spinning is tried again.
+    thread_pool->AddTask(self, new AdaptiveSpinTask(g_obj, kSpinFailurePenalty + 2u, &scores));
+    thread_pool->StartWorkers(self);
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+      thread_pool->Wait(Thread::Current(), /*do_work=*/false, /*may_hold_locks=*/false);
+    }
+    std::vector<int8_t> expected_scores;
+    for (int score = -kSpinFailurePenalty; score <= 0; ++score) {
+      expected_scores.push_back(static_cast<int8_t>(score));
+    }
+    expected_scores.push_back(static_cast<int8_t>(-kSpinFailurePenalty));
+    EXPECT_EQ(expected_scores, scores);
+
+    // A failed spin from the maximum score keeps spinning for the next contender.
+    MonitorTest::SetSpinScore(monitor, kMaxSpinScore);
+    scores.clear();
+    thread_pool->AddTask(self, new AdaptiveSpinTask(g_obj, 1u, &scores));
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+      thread_pool->Wait(Thread::Current(), /*do_work=*/false, /*may_hold_locks=*/false);
+    }
+    ASSERT_EQ(1u, scores.size());
+    EXPECT_EQ(kMaxSpinScore - kSpinFailurePenalty, scores[0]);
+  }
+
+  // Uncontended acquisitions leave the score alone.
+  int8_t score = MonitorTest::GetSpinScore(monitor);
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    ASSERT_EQ(monitor, obj->GetLockWord(false).FatLockMonitor());
+  }
+  EXPECT_EQ(score, MonitorTest::GetSpinScore(monitor));
+  thread_pool->StopWorkers(self);
+  soa.Vm()->DeleteGlobalRef(self, g_obj);
+}
+
+TEST_F(MonitorTest, ThinLockHashCode) {
+  Thread* const self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  int32_t hash_code;
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    // The identity hash code of an object we hold a thin lock on does not inflate the lock.
+    hash_code = obj->IdentityHashCode();
+    LockWord lock_word = obj->GetLockWord(false);
+    ASSERT_EQ(LockWord::LockState::kThinLocked, lock_word.GetState());
+    EXPECT_TRUE(lock_word.ThinLockHasHashCode());
+    EXPECT_EQ(hash_code, obj->IdentityHashCode());
+    {
+      // Recursive locking keeps the hash code.
+      ObjectLock<mirror::Object> recursive_lock(self, obj);
+      lock_word = obj->GetLockWord(false);
+      ASSERT_EQ(LockWord::LockState::kThinLocked, lock_word.GetState());
+      EXPECT_EQ(1u, lock_word.ThinLockCount());
+      EXPECT_TRUE(lock_word.ThinLockHasHashCode());
+      EXPECT_EQ(hash_code, obj->IdentityHashCode());
+    }
+    lock_word = obj->GetLockWord(false);
+    ASSERT_EQ(LockWord::LockState::kThinLocked, lock_word.GetState());
+    EXPECT_EQ(0u, lock_word.ThinLockCount());
+    EXPECT_TRUE(lock_word.ThinLockHasHashCode());
+  }
+  // Releasing the lock moves the hash code to the lock word.
+  LockWord lock_word = obj->GetLockWord(false);
+  ASSERT_EQ(LockWord::LockState::kHashCode, lock_word.GetState());
+  EXPECT_EQ(hash_code, lock_word.GetHashCode());
+  EXPECT_EQ(hash_code, obj->IdentityHashCode());
+}
+
+class IdentityHashCodeTask : public Task {
+ public:
+  IdentityHashCodeTask(jobject obj, int32_t* hash_code) : obj_(obj), hash_code_(hash_code) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    *hash_code_ = soa.Decode<mirror::Object>(obj_)->IdentityHashCode();
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  jobject obj_;
+  int32_t* hash_code_;
+};
+
+// Test that other threads get the hash code that the owner of a thin lock keeps on the side.
+TEST_F(MonitorTest, ThinLockHashCodeFromOtherThread) {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(ThreadPool::Create("the pool", 1));
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  jobject g_obj = soa.Vm()->AddGlobalRef(self, obj.Get());
+  ASSERT_TRUE(g_obj != nullptr);
+  int32_t hash_code;
+  int32_t other_hash_code = 0;
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    hash_code = obj->IdentityHashCode();
+    ASSERT_TRUE(obj->GetLockWord(false).ThinLockHasHashCode());
+
+    // The other thread inflates the lock, which takes the hash code over from this thread.
+    thread_pool->AddTask(self, new IdentityHashCodeTask(g_obj, &other_hash_code));
+    thread_pool->StartWorkers(self);
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+      thread_pool->Wait(Thread::Current(), /*do_work=*/false, /*may_hold_locks=*/false);
+    }
+    EXPECT_EQ(hash_code, other_hash_code);
+    LockWord lock_word = obj->GetLockWord(false);
+    ASSERT_EQ(LockWord::LockState::kFatLocked, lock_word.GetState());
+    EXPECT_EQ(self, lock_word.FatLockMonitor()->GetOwner());
+    EXPECT_EQ(hash_code, obj->IdentityHashCode());
+  }
+  EXPECT_EQ(hash_code, obj->IdentityHashCode());
+
+  // Locking an object that already has a hash code inflates the lock, so that other threads
+  // read the hash code from the monitor without suspending the owner.
+  Handle<mirror::Object> hashed(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hashed")));
+  jobject g_hashed = soa.Vm()->AddGlobalRef(self, hashed.Get());
+  ASSERT_TRUE(g_hashed != nullptr);
+  hash_code = hashed->IdentityHashCode();
+  {
+    ObjectLock<mirror::Object> lock(self, hashed);
+    LockWord lock_word = hashed->GetLockWord(false);
+    ASSERT_EQ(LockWord::LockState::kFatLocked, lock_word.GetState());
+    EXPECT_EQ(hash_code, lock_word.FatLockMonitor()->GetHashCode());
+    thread_pool->AddTask(self, new IdentityHashCodeTask(g_hashed, &other_hash_code));
+    {
+      ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+      thread_pool->Wait(Thread::Current(), /*do_work=*/false, /*may_hold_locks=*/false);
+    }
+    EXPECT_EQ(hash_code, other_hash_code);
+  }
+  thread_pool->StopWorkers(self);
+  soa.Vm()->DeleteGlobalRef(self, g_obj);
+  soa.Vm()->DeleteGlobalRef(self, g_hashed);
+}
+
+class KeepAllMonitorsVisitor : public IsMarkedVisitor {
+ public:
+  mirror::Object* IsMarked(mirror::Object* obj) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    return obj;
+  }
+};
+
+static void InflateUnlocked(Thread* self, Handle<mirror::Object> obj)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjectLock<mirror::Object> lock(self, obj);
+  Monitor::InflateThinLocked(self, obj, obj->GetLockWord(false), /*hash_code=*/ 0);
+  ASSERT_EQ(LockWord::LockState::kFatLocked, obj->GetLockWord(false).GetState());
+}
+
+static void SweepMonitorListInPause(Thread* self, bool deflate_idle_monitors = true)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+  ScopedSuspendAll ssa(__FUNCTION__);
+  KeepAllMonitorsVisitor visitor;
+  Runtime::Current()->GetMonitorList()->SweepMonitorList(&visitor, deflate_idle_monitors);
+}
+
+// Test that sweeping the monitor list in a pause deflates the monitors that stayed unused
+// since the previous such sweep.
+TEST_F(MonitorTest, SweepDeflatesIdleMonitors) {
+  Thread* const self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<3> hs(self);
+  Handle<mirror::Object> idle(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "idle")));
+  Handle<mirror::Object> used(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "used")));
+  Handle<mirror::Object> held(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "held")));
+  InflateUnlocked(self, idle);
+  InflateUnlocked(self, used);
+  InflateUnlocked(self, held);
+  ObjectLock<mirror::Object> held_lock(self, held);
+
+  // Concurrent sweeps do not deflate.
+  KeepAllMonitorsVisitor visitor;
+  Runtime::Current()->GetMonitorList()->SweepMonitorList(&visitor, /*deflate_idle_monitors=*/ true);
+  Runtime::Current()->GetMonitorList()->SweepMonitorList(&visitor, /*deflate_idle_monitors=*/ true);
+  EXPECT_EQ(LockWord::LockState::kFatLocked, idle->GetLockWord(false).GetState());
+
+  // Neither do sweeps in a pause for collectors that did not ask for it.
+  SweepMonitorListInPause(self, /*deflate_idle_monitors=*/ false);
+  SweepMonitorListInPause(self, /*deflate_idle_monitors=*/ false);
+  EXPECT_EQ(LockWord::LockState::kFatLocked, idle->GetLockWord(false).GetState());
+
+  // Monitors acquired since they were inflated survive the first sweep in a pause.
+  SweepMonitorListInPause(self);
+  EXPECT_EQ(LockWord::LockState::kFatLocked, idle->GetLockWord(false).GetState());
+  EXPECT_EQ(LockWord::LockState::kFatLocked, used->GetLockWord(false).GetState());
+  EXPECT_EQ(LockWord::LockState::kFatLocked, held->GetLockWord(false).GetState());
+
+  { ObjectLock<mirror::Object> lock(self, used); }
+  SweepMonitorListInPause(self);
+  EXPECT_EQ(LockWord::LockState::kUnlocked, idle->GetLockWord(false).GetState());
+  EXPECT_EQ(LockWord::LockState::kFatLocked, used->GetLockWord(false).GetState());
+  // Held monitors are never deflated.
+  EXPECT_EQ(LockWord::LockState::kFatLocked, held->GetLockWord(false).GetState());
+
+  SweepMonitorListInPause(self);
+  EXPECT_EQ(LockWord::LockState::kUnlocked, used->GetLockWord(false).GetState());
+  EXPECT_EQ(LockWord::LockState::kFatLocked, held->GetLockWord(false).GetState());
+
+  // The objects can be locked again, starting with a thin lock.
+  ObjectLock<mirror::Object> idle_lock(self, idle);
+  EXPECT_EQ(LockWord::LockState::kThinLocked, idle->GetLockWord(false).GetState());
+}
+
+// Test that the monitor of an idle object stays attached to the object when the GC moves it.
+// Compacting collectors such as CMC sweep system weaks before moving the objects, so they must
+// not deflate monitors then.
+TEST_F(MonitorTest, IdleMonitorSurvivesMovingGc) {
+  Thread* const self = Thread::Current();
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (!heap->IsMovingGc()) {
+    GTEST_SKIP() << "The collector does not move objects";
+  }
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "idle")));
+  InflateUnlocked(self, obj);
+  int32_t hash_code = obj->IdentityHashCode();
+  ASSERT_EQ(LockWord::LockState::kFatLocked, obj->GetLockWord(false).GetState());
+  for (size_t i = 0; i != 4u; ++i) {
+    heap->CollectGarbage(/*clear_soft_references=*/ false);
+    // The monitor, if the object still has one, belongs to the object at its new address.
+    LockWord lock_word = obj->GetLockWord(false);
+    if (lock_word.GetState() == LockWord::LockState::kFatLocked) {
+      EXPECT_EQ(obj.Get(), lock_word.FatLockMonitor()->GetObject());
+    } else {
+      EXPECT_EQ(LockWord::LockState::kHashCode, lock_word.GetState());
+    }
+    EXPECT_EQ(hash_code, obj->IdentityHashCode());
+  }
+  ObjectLock<mirror::Object> lock(self, obj);
+  EXPECT_EQ(hash_code, obj->IdentityHashCode());
+}
 
 }  // namespace art
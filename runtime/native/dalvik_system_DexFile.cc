@@ -432,7 +432,7 @@ static jboolean DexFile_closeDexFile(JNIEnv* env, jclass, jobject cookie) {
   bool all_deleted = true;
   // We need to clear the caches since they may contain pointers to the dex instructions.
   // Different dex file can be loaded at the same memory location later by chance.
-  Thread::ClearAllInterpreterCaches();
+  Thread::ClearInterpreterCaches(dex_files);
   {
     ScopedObjectAccess soa(env);
     ObjPtr<mirror::Object> dex_files_object = soa.Decode<mirror::Object>(cookie);
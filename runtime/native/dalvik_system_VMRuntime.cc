@@ -40,6 +40,7 @@ extern "C" void android_set_application_target_sdk_version(uint32_t version);
 #include "debugger.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/dex_file-inl.h"
+#include "dex/dex_file_loader.h"
 #include "dex/dex_file_types.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/allocator/art-dlmalloc.h"
@@ -49,6 +50,7 @@ extern "C" void android_set_application_target_sdk_version(uint32_t version);
 #include "gc/task_processor.h"
 #include "intern_table.h"
 #include "jit/jit.h"
+#include "jit/jit_code_cache.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
 #include "mirror/array-alloc-inl.h"
@@ -331,7 +333,14 @@ static void VMRuntime_notifyStartupCompleted(JNIEnv*, jobject) {
 }
 
 static void VMRuntime_trimHeap(JNIEnv* env, jobject) {
-  Runtime::Current()->GetHeap()->Trim(Thread::ForEnv(env));
+  Thread* self = Thread::ForEnv(env);
+  Runtime* runtime = Runtime::Current();
+  runtime->GetHeap()->Trim(self);
+  jit::Jit* jit = runtime->GetJit();
+  if (jit != nullptr) {
+    // Also give back the memory of JIT code that went cold.
+    jit->GetCodeCache()->RequestTrim(self);
+  }
 }
 
 static void VMRuntime_requestHeapTrim(JNIEnv* env, jobject) {
@@ -347,7 +356,10 @@ static void VMRuntime_requestConcurrentGC(JNIEnv* env, jobject) {
 }
 
 static void VMRuntime_startHeapTaskProcessor(JNIEnv* env, jobject) {
-  Runtime::Current()->GetHeap()->GetTaskProcessor()->Start(Thread::ForEnv(env));
+  Thread* self = Thread::ForEnv(env);
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  heap->GetTaskProcessor()->Start(self);
+  heap->ApplyGcCpuAffinity(self);
 }
 
 static void VMRuntime_stopHeapTaskProcessor(JNIEnv* env, jobject) {
@@ -453,6 +465,8 @@ static void VMRuntime_setProcessPackageName(JNIEnv* env,
 static void VMRuntime_setProcessDataDirectory(JNIEnv* env, jclass, jstring java_data_dir) {
   ScopedUtfChars data_dir(env, java_data_dir);
   Runtime::Current()->SetProcessDataDirectory(data_dir.c_str());
+  // Share dex files extracted from compressed APK entries between the processes of the app.
+  DexFileLoader::SetExtractedDexCacheDirectory(std::string(data_dir.c_str()) + "/code_cache");
 }
 
 static void VMRuntime_bootCompleted([[maybe_unused]] JNIEnv* env, [[maybe_unused]] jclass klass) {
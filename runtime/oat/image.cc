@@ -21,6 +21,7 @@
 #include <sstream>
 #include <sys/stat.h>
 #include <zlib.h>
+#include <zstd.h>
 
 #include "android-base/stringprintf.h"
 
@@ -34,8 +35,8 @@
 namespace art HIDDEN {
 
 const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-// Last change: Add JniStubMethodsSection.
-const uint8_t ImageHeader::kImageVersion[] = { '1', '1', '0', '\0' };
+// Last change: Add zstd storage mode.
+const uint8_t ImageHeader::kImageVersion[] = { '1', '1', '1', '\0' };
 
 ImageHeader::ImageHeader(uint32_t image_reservation_size,
                          uint32_t component_count,
@@ -217,6 +218,52 @@ bool LZ4_decompress_safe_checked(const char* source,
   }
 }
 
+static bool ZSTD_decompress_checked(const void* source,
+                                    void* dest,
+                                    size_t compressed_size,
+                                    size_t max_decompressed_size,
+                                    /*out*/ size_t* decompressed_size_checked,
+                                    /*out*/ std::string* error_msg) {
+  size_t decompressed_size = ZSTD_decompress(dest, max_decompressed_size, source, compressed_size);
+  if (UNLIKELY(ZSTD_isError(decompressed_size))) {
+    if (error_msg != nullptr) {
+      *error_msg = android::base::StringPrintf("ZSTD_decompress() failed: %s",
+                                               ZSTD_getErrorName(decompressed_size));
+    }
+    return false;
+  } else {
+    *decompressed_size_checked = decompressed_size;
+    return true;
+  }
+}
+
+// Decompress `compressed_size` bytes of `source`, stored with `storage_mode`, into `dest`.
+static bool DecompressData(ImageHeader::StorageMode storage_mode,
+                           const uint8_t* source,
+                           uint8_t* dest,
+                           size_t compressed_size,
+                           size_t max_decompressed_size,
+                           /*out*/ size_t* decompressed_size,
+                           /*out*/ std::string* error_msg) {
+  if (storage_mode == ImageHeader::kStorageModeZstd) {
+    return ZSTD_decompress_checked(source,
+                                   dest,
+                                   compressed_size,
+                                   max_decompressed_size,
+                                   decompressed_size,
+                                   error_msg);
+  }
+  // LZ4HC and LZ4 have same internal format, both use LZ4_decompress.
+  DCHECK(storage_mode == ImageHeader::kStorageModeLZ4 ||
+         storage_mode == ImageHeader::kStorageModeLZ4HC) << storage_mode;
+  return LZ4_decompress_safe_checked(reinterpret_cast<const char*>(source),
+                                     reinterpret_cast<char*>(dest),
+                                     compressed_size,
+                                     max_decompressed_size,
+                                     decompressed_size,
+                                     error_msg);
+}
+
 bool ImageHeader::Block::Decompress(uint8_t* out_ptr,
                                     const uint8_t* in_ptr,
                                     std::string* error_msg) const {
@@ -227,16 +274,16 @@ bool ImageHeader::Block::Decompress(uint8_t* out_ptr,
       break;
     }
     case kStorageModeLZ4:
-    case kStorageModeLZ4HC: {
-      // LZ4HC and LZ4 have same internal format, both use LZ4_decompress.
+    case kStorageModeLZ4HC:
+    case kStorageModeZstd: {
       size_t decompressed_size;
-      bool ok = LZ4_decompress_safe_checked(
-          reinterpret_cast<const char*>(in_ptr) + data_offset_,
-          reinterpret_cast<char*>(out_ptr) + image_offset_,
-          data_size_,
-          image_size_,
-          &decompressed_size,
-          error_msg);
+      bool ok = DecompressData(storage_mode_,
+                               in_ptr + data_offset_,
+                               out_ptr + image_offset_,
+                               data_size_,
+                               image_size_,
+                               &decompressed_size,
+                               error_msg);
       if (!ok) {
         return false;
       }
@@ -279,29 +326,45 @@ const char* ImageHeader::GetImageSectionName(ImageSections index) {
   }
 }
 
+// Compression level for zstd. Images are written once and loaded on every start, so
+// favor the compression ratio over the compression time.
+static constexpr int kZstdCompressionLevel = 19;
+
 // Compress data from `source` into `storage`.
 static bool CompressData(ArrayRef<const uint8_t> source,
                          ImageHeader::StorageMode image_storage_mode,
                          /*out*/ dchecked_vector<uint8_t>* storage) {
   const uint64_t compress_start_time = NanoTime();
 
-  // Bound is same for both LZ4 and LZ4HC.
-  storage->resize(LZ4_compressBound(source.size()));
   size_t data_size = 0;
-  if (image_storage_mode == ImageHeader::kStorageModeLZ4) {
-    data_size = LZ4_compress_default(
-        reinterpret_cast<char*>(const_cast<uint8_t*>(source.data())),
-        reinterpret_cast<char*>(storage->data()),
-        source.size(),
-        storage->size());
+  if (image_storage_mode == ImageHeader::kStorageModeZstd) {
+    storage->resize(ZSTD_compressBound(source.size()));
+    data_size = ZSTD_compress(storage->data(),
+                              storage->size(),
+                              source.data(),
+                              source.size(),
+                              kZstdCompressionLevel);
+    if (ZSTD_isError(data_size)) {
+      return false;
+    }
   } else {
-    DCHECK_EQ(image_storage_mode, ImageHeader::kStorageModeLZ4HC);
-    data_size = LZ4_compress_HC(
-        reinterpret_cast<const char*>(const_cast<uint8_t*>(source.data())),
-        reinterpret_cast<char*>(storage->data()),
-        source.size(),
-        storage->size(),
-        LZ4HC_CLEVEL_MAX);
+    // Bound is same for both LZ4 and LZ4HC.
+    storage->resize(LZ4_compressBound(source.size()));
+    if (image_storage_mode == ImageHeader::kStorageModeLZ4) {
+      data_size = LZ4_compress_default(
+          reinterpret_cast<char*>(const_cast<uint8_t*>(source.data())),
+          reinterpret_cast<char*>(storage->data()),
+          source.size(),
+          storage->size());
+    } else {
+      DCHECK_EQ(image_storage_mode, ImageHeader::kStorageModeLZ4HC);
+      data_size = LZ4_compress_HC(
+          reinterpret_cast<const char*>(const_cast<uint8_t*>(source.data())),
+          reinterpret_cast<char*>(storage->data()),
+          source.size(),
+          storage->size(),
+          LZ4HC_CLEVEL_MAX);
+    }
   }
 
   if (data_size == 0) {
@@ -315,13 +378,13 @@ static bool CompressData(ArrayRef<const uint8_t> source,
     dchecked_vector<uint8_t> decompressed(source.size());
     size_t decompressed_size;
     std::string error_msg;
-    bool ok = LZ4_decompress_safe_checked(
-        reinterpret_cast<char*>(storage->data()),
-        reinterpret_cast<char*>(decompressed.data()),
-        storage->size(),
-        decompressed.size(),
-        &decompressed_size,
-        &error_msg);
+    bool ok = DecompressData(image_storage_mode,
+                             storage->data(),
+                             decompressed.data(),
+                             storage->size(),
+                             decompressed.size(),
+                             &decompressed_size,
+                             &error_msg);
     if (!ok) {
       LOG(FATAL) << error_msg;
       UNREACHABLE();
@@ -18,9 +18,12 @@
 
 #include <sys/stat.h>
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
+#include <tuple>
 #include <vector>
 
 #include "android-base/file.h"
@@ -65,6 +68,56 @@ static constexpr const char* kAnonymousDexPrefix = "Anonymous-DexFile@";
 static constexpr const char* kVdexExtension = ".vdex";
 static constexpr const char* kDmExtension = ".dm";
 
+// Process-wide cache of the multidex checksums of zip files, so that loading the same APK
+// again, or `artd` answering repeated queries about it, does not read the zip central
+// directory every time. Entries are keyed on the file identity and last modification and
+// status change, so a replaced or rewritten APK misses the cache.
+class DexChecksumCache {
+ public:
+  struct Entry {
+    std::optional<uint32_t> checksum;
+    bool only_contains_uncompressed_dex;
+  };
+
+  static std::optional<Entry> Lookup(const struct stat& st) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(KeyOf(st));
+    return (it != entries_.end()) ? std::make_optional(it->second) : std::nullopt;
+  }
+
+  static void Insert(const struct stat& st, const Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= kMaxEntries) {
+      entries_.clear();
+    }
+    entries_.insert_or_assign(KeyOf(st), entry);
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 64u;
+
+  // The change time is part of the key since the modification time can be set by the writer,
+  // e.g. when a file is extracted from an archive with its original timestamps.
+  using Key =
+      std::tuple<dev_t, ino_t, off_t, time_t, long, time_t, long>;  // NOLINT(runtime/int)
+
+  static Key KeyOf(const struct stat& st) {
+    return Key(st.st_dev,
+               st.st_ino,
+               st.st_size,
+               st.st_mtim.tv_sec,
+               st.st_mtim.tv_nsec,
+               st.st_ctim.tv_sec,
+               st.st_ctim.tv_nsec);
+  }
+
+  static std::mutex mutex_;
+  static std::map<Key, Entry> entries_;
+};
+
+std::mutex DexChecksumCache::mutex_;
+std::map<DexChecksumCache::Key, DexChecksumCache::Entry> DexChecksumCache::entries_;
+
 std::ostream& operator<<(std::ostream& stream, const OatFileAssistant::OatStatus status) {
   switch (status) {
     case OatFileAssistant::kOatCannotOpen:
@@ -705,17 +758,54 @@ bool OatFileAssistant::DexLocationToOatFilename(const std::string& location,
   return GetDalvikCacheFilename(location.c_str(), dalvik_cache.c_str(), oat_filename, error_msg);
 }
 
+bool OatFileAssistant::GetMultiDexChecksum(File* file,
+                                           const std::string& location,
+                                           /*out*/ std::optional<uint32_t>* checksum,
+                                           /*out*/ std::string* error_msg,
+                                           /*out*/ bool* only_contains_uncompressed_dex) {
+  struct stat st;
+  bool has_stat = file->IsValid() ? fstat(file->Fd(), &st) == 0
+                                  : stat(location.c_str(), &st) == 0;
+  std::optional<DexChecksumCache::Entry> cached =
+      has_stat ? DexChecksumCache::Lookup(st) : std::nullopt;
+  if (cached.has_value()) {
+    *checksum = cached->checksum;
+    if (only_contains_uncompressed_dex != nullptr) {
+      *only_contains_uncompressed_dex = cached->only_contains_uncompressed_dex;
+    }
+    return true;
+  }
+
+  bool uncompressed_dex = false;
+  ArtDexFileLoader dex_loader(file, location);
+  if (!dex_loader.GetMultiDexChecksum(checksum, error_msg, &uncompressed_dex)) {
+    return false;
+  }
+  // Only cache successful reads of regular files, errors may be transient.
+  if (has_stat && S_ISREG(st.st_mode)) {
+    DexChecksumCache::Insert(st, {*checksum, uncompressed_dex});
+  }
+  if (only_contains_uncompressed_dex != nullptr) {
+    *only_contains_uncompressed_dex = uncompressed_dex;
+  }
+  return true;
+}
+
+bool OatFileAssistant::IsMultiDexChecksumCachedForTesting(const std::string& location) {
+  struct stat st;
+  return stat(location.c_str(), &st) == 0 && DexChecksumCache::Lookup(st).has_value();
+}
+
 bool OatFileAssistant::GetRequiredDexChecksum(std::optional<uint32_t>* checksum,
                                               std::string* error) {
   if (!required_dex_checksums_attempted_) {
     required_dex_checksums_attempted_ = true;
 
     File file(zip_fd_, /*check_usage=*/false);
-    ArtDexFileLoader dex_loader(&file, dex_location_);
     std::optional<uint32_t> checksum2;
     std::string error2;
-    if (dex_loader.GetMultiDexChecksum(
-            &checksum2, &error2, &zip_file_only_contains_uncompressed_dex_)) {
+    if (GetMultiDexChecksum(
+            &file, dex_location_, &checksum2, &error2, &zip_file_only_contains_uncompressed_dex_)) {
       cached_required_dex_checksums_ = checksum2;
       cached_required_dex_checksums_error_ = std::nullopt;
     } else {
@@ -360,6 +360,19 @@ class OatFileAssistant {
   // anonymous dex file(s) created by AnonymousDexVdexLocation.
   EXPORT static bool IsAnonymousVdexBasename(const std::string& basename);
 
+  // Reads the multidex checksum of the dex or zip file at `location`, or of `file` if it is
+  // valid, like `ArtDexFileLoader::GetMultiDexChecksum`. Successful reads are cached for the
+  // process, keyed on the file identity and last modification and status change.
+  EXPORT static bool GetMultiDexChecksum(
+      File* file,
+      const std::string& location,
+      /*out*/ std::optional<uint32_t>* checksum,
+      /*out*/ std::string* error_msg,
+      /*out*/ bool* only_contains_uncompressed_dex = nullptr);
+
+  // Returns whether the multidex checksum of the file at `location` is cached.
+  EXPORT static bool IsMultiDexChecksumCachedForTesting(const std::string& location);
+
   bool ClassLoaderContextIsOkay(const OatFile& oat_file) const;
 
   // Validates the boot class path checksum of an OatFile.
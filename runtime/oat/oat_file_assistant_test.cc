@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <gtest/gtest.h>
 #include <sys/param.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <functional>
 #include <iterator>
@@ -37,6 +39,7 @@
 #include "class_linker.h"
 #include "class_loader_context.h"
 #include "common_runtime_test.h"
+#include "dex/art_dex_file_loader.h"
 #include "dexopt_test.h"
 #include "oat.h"
 #include "oat_file.h"
@@ -2674,6 +2677,60 @@ TEST_P(OatFileAssistantTest, ValidateBootClassPathChecksums) {
   }
 }
 
+TEST_F(OatFileAssistantBaseTest, MultiDexChecksumCache) {
+  std::string dex_location = GetScratchDir() + "/MultiDexChecksumCache.jar";
+  auto get_checksum = [&]() {
+    File file(-1, /*check_usage=*/false);
+    std::optional<uint32_t> checksum;
+    std::string error_msg;
+    EXPECT_TRUE(OatFileAssistant::GetMultiDexChecksum(&file, dex_location, &checksum, &error_msg))
+        << error_msg;
+    return checksum;
+  };
+  auto read_checksum = [&]() {
+    ArtDexFileLoader dex_loader(dex_location);
+    std::optional<uint32_t> checksum;
+    std::string error_msg;
+    EXPECT_TRUE(dex_loader.GetMultiDexChecksum(&checksum, &error_msg)) << error_msg;
+    return checksum;
+  };
+
+  // The first read is cached and reused.
+  Copy(GetMultiDexSrc1(), dex_location);
+  std::optional<uint32_t> checksum1 = read_checksum();
+  ASSERT_TRUE(checksum1.has_value());
+  EXPECT_FALSE(OatFileAssistant::IsMultiDexChecksumCachedForTesting(dex_location));
+  EXPECT_EQ(checksum1, get_checksum());
+  EXPECT_TRUE(OatFileAssistant::IsMultiDexChecksumCachedForTesting(dex_location));
+  EXPECT_EQ(checksum1, get_checksum());
+
+  // Rewriting the file invalidates the entry.
+  Copy(GetMultiDexSrc2(), dex_location);
+  std::optional<uint32_t> checksum2 = read_checksum();
+  ASSERT_NE(checksum1, checksum2);
+  EXPECT_FALSE(OatFileAssistant::IsMultiDexChecksumCachedForTesting(dex_location));
+  EXPECT_EQ(checksum2, get_checksum());
+  EXPECT_TRUE(OatFileAssistant::IsMultiDexChecksumCachedForTesting(dex_location));
+
+  // A status change invalidates the entry, even if the size and modification time are the same.
+  struct stat old_st;
+  ASSERT_EQ(0, stat(dex_location.c_str(), &old_st));
+  struct stat new_st = old_st;
+  // File timestamps have a coarse granularity, so retry until the change time moves.
+  for (int i = 0; i != 1000 && new_st.st_ctim.tv_sec == old_st.st_ctim.tv_sec &&
+                  new_st.st_ctim.tv_nsec == old_st.st_ctim.tv_nsec;
+       ++i) {
+    usleep(1000);
+    ASSERT_EQ(0, chmod(dex_location.c_str(), old_st.st_mode & ~S_IFMT));
+    ASSERT_EQ(0, stat(dex_location.c_str(), &new_st));
+  }
+  ASSERT_EQ(old_st.st_size, new_st.st_size);
+  ASSERT_EQ(old_st.st_mtim.tv_sec, new_st.st_mtim.tv_sec);
+  ASSERT_EQ(old_st.st_mtim.tv_nsec, new_st.st_mtim.tv_nsec);
+  EXPECT_FALSE(OatFileAssistant::IsMultiDexChecksumCachedForTesting(dex_location));
+  EXPECT_EQ(checksum2, get_checksum());
+}
+
 // TODO: More Tests:
 //  * Test class linker falls back to unquickened dex for DexNoOat
 //  * Test class linker falls back to unquickened dex for MultiDexNoOat
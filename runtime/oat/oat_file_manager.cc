@@ -17,8 +17,11 @@
 #include "oat_file_manager.h"
 
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <queue>
 #include <vector>
@@ -74,6 +77,55 @@ static const bool kEnableRuntimeAppImage = true;
 static const char* kDisableAppImageKeyword = "_disable_art_image_";
 #endif
 
+// Prefetch the code that dex2oat compiled for the startup methods of the profile, and turn off
+// readahead for the rest of the compiled code, which is paged in one method at a time and
+// would otherwise evict useful pages from the page cache. `prefetched_size` is the size of
+// the prefix of the oat file that was already prefetched.
+static void MadviseStartupCode(const OatFile& oat_file, size_t prefetched_size) {
+#ifdef ART_TARGET_ANDROID
+  const OatHeader& oat_header = oat_file.GetOatHeader();
+  if (oat_header.GetStartupCodeSize() == 0u) {
+    return;
+  }
+  // Clamp the ranges to the oat file. The readahead is only turned off for whole pages of code.
+  const size_t size = oat_file.Size();
+  const size_t startup_offset = std::min<size_t>(oat_header.GetStartupCodeOffset(), size);
+  const size_t startup_size =
+      std::min<size_t>(oat_header.GetStartupCodeSize(), size - startup_offset);
+  const uint8_t* code_begin =
+      AlignUp(oat_file.Begin() + oat_header.GetExecutableOffset(), gPageSize);
+  const uint8_t* code_end = AlignDown(oat_file.End(), gPageSize);
+  const uint8_t* startup_begin = AlignDown(oat_file.Begin() + startup_offset, gPageSize);
+  const uint8_t* startup_end = AlignUp(oat_file.Begin() + startup_offset + startup_size, gPageSize);
+  if (startup_begin == startup_end) {
+    return;
+  }
+
+  auto madvise_range = [&](const uint8_t* begin, const uint8_t* end, int advice) {
+    if (begin < end &&
+        madvise(const_cast<uint8_t*>(begin), static_cast<size_t>(end - begin), advice) != 0) {
+      PLOG(WARNING) << "Failed to madvise " << oat_file.GetLocation() << " with " << advice;
+    }
+  };
+  madvise_range(code_begin, startup_begin, MADV_RANDOM);
+  madvise_range(startup_end, code_end, MADV_RANDOM);
+  // Only prefetch the startup code past the prefix that was already prefetched. Note that
+  // `prefetched_size` can be `std::numeric_limits<size_t>::max()` for no limit.
+  const uint8_t* prefetched_end =
+      AlignUp(oat_file.Begin() + std::min(prefetched_size, size), gPageSize);
+  const uint8_t* prefetch_begin = std::max(startup_begin, prefetched_end);
+  if (prefetch_begin < startup_end) {
+    Runtime::MadviseFileForRange(std::numeric_limits<size_t>::max(),
+                                 static_cast<size_t>(startup_end - prefetch_begin),
+                                 prefetch_begin,
+                                 startup_end,
+                                 oat_file.GetLocation() + " startup code");
+  }
+#else
+  UNUSED(oat_file, prefetched_size);
+#endif
+}
+
 const OatFile* OatFileManager::RegisterOatFile(std::unique_ptr<const OatFile> oat_file,
                                                bool in_memory) {
   // Use class_linker vlog to match the log for dex file registration.
@@ -277,6 +329,9 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
                                      oat_file->Begin(),
                                      oat_file->End(),
                                      oat_file->GetLocation());
+        if (oat_file->IsExecutable()) {
+          MadviseStartupCode(*oat_file, madvise_size_limit);
+        }
       }
 
       ScopedTrace app_image_timing("AppImage:Loading");
@@ -400,6 +400,11 @@ class CodeInfo {
     return DexRegisterMap(0, DexRegisterLocation::None());
   }
 
+  // Returns the inline infos of all stack maps.
+  BitTableRange<InlineInfo> GetInlineInfos() const {
+    return BitTableRange<InlineInfo>(inline_infos_.begin(), inline_infos_.end());
+  }
+
   BitTableRange<InlineInfo> GetInlineInfosOf(StackMap stack_map) const {
     uint32_t index = stack_map.GetInlineInfoIndex();
     if (index != StackMap::kNoValue) {
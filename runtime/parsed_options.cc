@@ -167,6 +167,13 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:ForegroundHeapGrowthMultiplier=_")
           .WithType<double>().WithRange(0.1, 5.0)
           .IntoKey(M::ForegroundHeapGrowthMultiplier)
+      .Define("-XX:GcCpuBudget=_")
+          .WithMetavar("FRACTION")
+          .WithHelp("Size the heap so that concurrent GCs take up about this fraction of the time"
+                    " instead of growing it for -XX:HeapTargetUtilization. 0 (the default)"
+                    " disables this.")
+          .WithType<double>().WithRange(0.0, 0.5)
+          .IntoKey(M::GcCpuBudget)
       .Define("-XX:LowMemoryMode")
           .IntoKey(M::LowMemoryMode)
       .Define("-Xprofile:_")
@@ -212,9 +219,25 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:ConcGCThreads=_")
           .WithType<unsigned int>()
           .IntoKey(M::ConcGCThreads)
+      .Define("-XX:ForegroundGcCpuAffinity=_")
+          .WithMetavar("CPU[,CPU...]")
+          .WithHelp("CPUs the GC threads run on while the process is jank perceptible.")
+          .WithType<ParseIntList<','>>()
+          .IntoKey(M::ForegroundGcCpuAffinity)
+      .Define("-XX:BackgroundGcCpuAffinity=_")
+          .WithMetavar("CPU[,CPU...]")
+          .WithHelp("CPUs the GC threads run on while the process is in the background.")
+          .WithType<ParseIntList<','>>()
+          .IntoKey(M::BackgroundGcCpuAffinity)
       .Define("-XX:FinalizerTimeoutMs=_")
           .WithType<unsigned int>()
           .IntoKey(M::FinalizerTimeoutMs)
+      .Define("-XX:AllocTrackerSampleInterval=_")
+          .WithMetavar("BYTES")
+          .WithHelp("Mean number of bytes a thread allocates between two allocations recorded by"
+                    " the allocation tracker. 0 (the default) records every allocation.")
+          .WithType<unsigned int>()
+          .IntoKey(M::AllocTrackerSampleInterval)
       .Define("-XX:MaxSpinsBeforeThinLockInflation=_")
           .WithType<unsigned int>()
           .IntoKey(M::MaxSpinsBeforeThinLockInflation)
@@ -230,6 +253,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .IntoKey(M::DumpRegionInfoBeforeGC)
       .Define("-XX:DumpRegionInfoAfterGC")
           .IntoKey(M::DumpRegionInfoAfterGC)
+      .Define("-XX:UseTransparentHugePages")
+          .WithHelp("Back the moving space and the card table with transparent huge pages.")
+          .IntoKey(M::UseTransparentHugePages)
       .Define("-XX:DumpJITInfoOnShutdown")
           .IntoKey(M::DumpJITInfoOnShutdown)
       .Define("-XX:IgnoreMaxFootprint")
@@ -271,6 +297,22 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::UseProfiledJitCompilation)
+      .Define("-Xjitprecompileappprofile:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITPrecompileAppProfile)
+      .Define("-Xjitpreloadstartupclasses:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITPreloadStartupClasses)
+      .Define("-Xjitverifyclassesinbackground:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITVerifyClassesInBackground)
+      .Define("-Xjitlazyminidebuginfo:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::JITLazyMiniDebugInfo)
       .Define("-Xjitinitialsize:_")
           .WithType<MemoryKiB>()
           .IntoKey(M::JITCodeCacheInitialCapacity)
@@ -292,6 +334,12 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitthreads:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITPoolThreadCount)
+      .Define("-Xjithotnessdecayperiod:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITHotnessDecayPeriodMs)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -350,6 +398,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xstackdumplockprofthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::StackDumpLockProfThreshold)
+      .Define("-Xlockcontentionsamplinginterval:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::LockContentionSamplingInterval)
       .Define("-Xmethod-trace")
           .IntoKey(M::MethodTrace)
       .Define("-Xmethod-trace-file:_")
@@ -121,12 +121,18 @@ class CatchBlockStackVisitor final : public StackVisitor {
   }
 
  private:
+  // Only methods with try items can catch the exception. This is checked before getting the
+  // dex pc, which decodes the stack maps of compiled frames.
+  static bool HasTryItems(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+    return method->GetCodeItem() != nullptr && method->DexInstructionData().TriesSize() != 0u;
+  }
+
   bool HandleTryItems(ArtMethod* method)
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    uint32_t dex_pc = dex::kDexNoIndex;
-    if (!method->IsNative()) {
-      dex_pc = GetDexPc();
+    if (method->IsNative()) {
+      return true;  // Continue stack walk.
     }
+    uint32_t dex_pc = HasTryItems(method) ? GetDexPc() : dex::kDexNoIndex;
     if (dex_pc != dex::kDexNoIndex) {
       bool clear_exception = false;
       StackHandleScope<1> hs(GetThread());
@@ -143,15 +149,16 @@ class CatchBlockStackVisitor final : public StackVisitor {
         exception_handler_->SetHandlerQuickFrame(GetCurrentQuickFrame());
         exception_handler_->SetHandlerMethodHeader(GetCurrentOatQuickMethodHeader());
         return false;  // End stack walk.
-      } else if (UNLIKELY(GetThread()->HasDebuggerShadowFrames())) {
-        // We are going to unwind this frame. Did we prepare a shadow frame for debugging?
-        size_t frame_id = GetFrameId();
-        ShadowFrame* frame = GetThread()->FindDebuggerShadowFrame(frame_id);
-        if (frame != nullptr) {
-          // We will not execute this shadow frame so we can safely deallocate it.
-          GetThread()->RemoveDebuggerShadowFrameMapping(frame_id);
-          ShadowFrame::DeleteDeoptimizedFrame(frame);
-        }
+      }
+    }
+    if (UNLIKELY(GetThread()->HasDebuggerShadowFrames())) {
+      // We are going to unwind this frame. Did we prepare a shadow frame for debugging?
+      size_t frame_id = GetFrameId();
+      ShadowFrame* frame = GetThread()->FindDebuggerShadowFrame(frame_id);
+      if (frame != nullptr) {
+        // We will not execute this shadow frame so we can safely deallocate it.
+        GetThread()->RemoveDebuggerShadowFrameMapping(frame_id);
+        ShadowFrame::DeleteDeoptimizedFrame(frame);
       }
     }
     return true;  // Continue stack walk.
@@ -724,7 +731,13 @@ void QuickExceptionHandler::DeoptimizeSingleFrame(DeoptimizationKind kind) {
   // can be reused when debugging support (like breakpoints) are no longer
   // needed fot this method.
   Runtime* runtime = Runtime::Current();
-  if (runtime->UseJitCompilation() && (kind != DeoptimizationKind::kDebugging)) {
+  if (kind == DeoptimizationKind::kJitOsr) {
+    // The baseline code is still valid, the frame only leaves it to enter the OSR code.
+  } else if (runtime->UseJitCompilation() && (kind != DeoptimizationKind::kDebugging)) {
+    // Remember which speculation failed, so that recompiling the method does not
+    // emit it again and we don't keep oscillating between compiled and
+    // interpreted code.
+    runtime->GetJit()->GetCodeCache()->RecordDeoptimization(deopt_method, kind, self_);
     runtime->GetJit()->GetCodeCache()->InvalidateCompiledCodeFor(
         deopt_method, visitor.GetSingleFrameDeoptQuickMethodHeader());
   } else {
@@ -238,8 +238,16 @@ class ArgArray {
         hs.NewHandle<mirror::ObjectArray<mirror::Object>>(raw_args));
     for (size_t i = 1, args_offset = 0; i < shorty_len_; ++i, ++args_offset) {
       arg.Assign(args->Get(args_offset));
-      if (((shorty_[i] == 'L') && (arg != nullptr)) ||
-          ((arg == nullptr && shorty_[i] != 'L'))) {
+      if (UNLIKELY(arg == nullptr && shorty_[i] != 'L')) {
+        // No need to resolve the parameter type to report a null primitive argument.
+        ThrowIllegalArgumentException(
+            StringPrintf("method %s argument %zd has type %s, got null",
+                m->PrettyMethod(false).c_str(),
+                args_offset + 1,  // Humans don't count from 0.
+                Primitive::PrettyDescriptor(Primitive::GetType(shorty_[i]))).c_str());
+        return false;
+      }
+      if (shorty_[i] == 'L' && arg != nullptr) {
         // TODO: The method's parameter's type must have been previously resolved, yet
         // we've seen cases where it's not b/34440020.
         ObjPtr<mirror::Class> dst_class(
@@ -248,7 +256,7 @@ class ArgArray {
           CHECK(self->IsExceptionPending());
           return false;
         }
-        if (UNLIKELY(arg == nullptr || !arg->InstanceOf(dst_class))) {
+        if (UNLIKELY(!arg->InstanceOf(dst_class))) {
           ThrowIllegalArgumentException(
               StringPrintf("method %s argument %zd has type %s, got %s",
                   m->PrettyMethod(false).c_str(),
@@ -260,23 +268,20 @@ class ArgArray {
       }
 
 #define DO_FIRST_ARG(boxed, get_fn, append) { \
-          if (LIKELY(arg != nullptr && \
-                     arg->GetClass() == WellKnownClasses::java_lang_##boxed)) { \
-            ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
+          if (LIKELY(arg_class == WellKnownClasses::java_lang_##boxed)) { \
+            ArtField* primitive_field = arg_class->GetInstanceField(0); \
             append(primitive_field-> get_fn(arg.Get()));
 
 #define DO_ARG(boxed, get_fn, append) \
-          } else if (LIKELY(arg != nullptr && \
-                            arg->GetClass() == WellKnownClasses::java_lang_##boxed)) { \
-            ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
+          } else if (LIKELY(arg_class == WellKnownClasses::java_lang_##boxed)) { \
+            ArtField* primitive_field = arg_class->GetInstanceField(0); \
             append(primitive_field-> get_fn(arg.Get()));
 
 #define DO_FAIL(expected) \
           } else { \
-            if (arg->GetClass<>()->IsPrimitive()) { \
+            if (arg_class->IsPrimitive()) { \
               std::string temp; \
-              ThrowIllegalPrimitiveArgumentException(expected, \
-                                                     arg->GetClass<>()->GetDescriptor(&temp)); \
+              ThrowIllegalPrimitiveArgumentException(expected, arg_class->GetDescriptor(&temp)); \
             } else { \
               ThrowIllegalArgumentException(\
                   StringPrintf("method %s argument %zd has type %s, got %s", \
@@ -288,6 +293,8 @@ class ArgArray {
             return false; \
           } }
 
+      // Read the class of a boxed argument once rather than in every conversion check.
+      ObjPtr<mirror::Class> arg_class = (shorty_[i] != 'L') ? arg->GetClass() : nullptr;
       switch (shorty_[i]) {
         case 'L':
           Append(arg.Get());
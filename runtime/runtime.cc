@@ -32,8 +32,10 @@
 #include <crt_externs.h>  // for _NSGetEnviron
 #endif
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <initializer_list>
 #include <limits>
 #include <string.h>
 #include <thread>
@@ -58,6 +60,7 @@
 #include "base/enums.h"
 #include "base/file_utils.h"
 #include "base/flags.h"
+#include "base/lock_contention_profiler.h"
 #include "base/malloc_arena_pool.h"
 #include "base/mem_map_arena_pool.h"
 #include "base/memory_tool.h"
@@ -67,6 +70,7 @@
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
+#include "base/timing_logger.h"
 #include "base/unix_file/fd_file.h"
 #include "base/utils.h"
 #include "class_linker-inl.h"
@@ -242,6 +246,15 @@ void CheckConstants() {
   CHECK_EQ(mirror::Array::kFirstElementOffset, mirror::Array::FirstElementOffset());
 }
 
+// Labels of the startup phases that are reported as metrics.
+constexpr const char* kStartupHeapCreation = "CreateHeap";
+constexpr const char* kStartupInitFromBootImage = "InitFromBootImage";
+constexpr const char* kStartupInitWithoutImage = "InitWithoutImage";
+constexpr const char* kStartupInitializeIntrinsics = "InitializeIntrinsics";
+constexpr const char* kStartupCreateJit = "CreateJit";
+constexpr const char* kStartupLoadPlugins = "LoadPlugins";
+constexpr const char* kStartupLoadAgents = "LoadAgents";
+
 }  // namespace
 
 Runtime::Runtime()
@@ -311,6 +324,7 @@ Runtime::Runtime()
       madvise_willneed_art_filesize_(0),
       safe_mode_(false),
       hidden_api_policy_(hiddenapi::EnforcementPolicy::kDisabled),
+      hidden_api_generation_(0u),
       core_platform_api_policy_(hiddenapi::EnforcementPolicy::kDisabled),
       test_api_policy_(hiddenapi::EnforcementPolicy::kDisabled),
       dedupe_hidden_api_warnings_(true),
@@ -878,13 +892,13 @@ void Runtime::CallExitHook(jint status) {
   }
 }
 
-void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor) {
+void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor, bool deflate_idle_monitors) {
   // Userfaultfd compaction updates weak intern-table page-by-page via
   // LinearAlloc.
   if (!GetHeap()->IsPerformingUffdCompaction()) {
     GetInternTable()->SweepInternTableWeaks(visitor);
   }
-  GetMonitorList()->SweepMonitorList(visitor);
+  GetMonitorList()->SweepMonitorList(visitor, deflate_idle_monitors);
   GetJavaVM()->SweepJniWeakGlobals(visitor);
   GetHeap()->SweepAllocationRecords(visitor);
   // Sweep JIT tables only if the GC is moving as in other cases the entries are
@@ -1051,15 +1065,21 @@ bool Runtime::Start() {
   // Before running any clinit, set up the native methods provided by the runtime itself.
   RegisterRuntimeNativeMethods(self->GetJniEnv());
 
-  class_linker_->RunEarlyRootClinits(self);
-  InitializeIntrinsics();
+  {
+    TimingLogger::ScopedTiming timing("RunEarlyRootClinits", startup_timings_.get());
+    class_linker_->RunEarlyRootClinits(self);
+  }
+  {
+    TimingLogger::ScopedTiming timing(kStartupInitializeIntrinsics, startup_timings_.get());
+    InitializeIntrinsics();
+  }
 
   self->TransitionFromRunnableToSuspended(ThreadState::kNative);
 
   // InitNativeMethods needs to be after started_ so that the classes
   // it touches will have methods linked to the oat file if necessary.
   {
-    ScopedTrace trace2("InitNativeMethods");
+    TimingLogger::ScopedTiming timing("InitNativeMethods", startup_timings_.get());
     InitNativeMethods();
   }
 
@@ -1080,7 +1100,10 @@ bool Runtime::Start() {
   // recoding profiles. Maybe we should consider changing the name to be more clear it's
   // not only about compiling. b/28295073.
   if (jit_options_->UseJitCompilation() || jit_options_->GetSaveProfilingInfo()) {
-    CreateJit();
+    {
+      TimingLogger::ScopedTiming timing(kStartupCreateJit, startup_timings_.get());
+      CreateJit();
+    }
 #ifdef ADDRESS_SANITIZER
     // (b/238730394): In older implementations of sanitizer + glibc there is a race between
     // pthread_create and dlopen that could cause a deadlock. pthread_create interceptor in ASAN
@@ -1106,7 +1129,10 @@ bool Runtime::Start() {
     callbacks_->NextRuntimePhase(RuntimePhaseCallback::RuntimePhase::kStart);
   }
 
-  system_class_loader_ = CreateSystemClassLoader(this);
+  {
+    TimingLogger::ScopedTiming timing("CreateSystemClassLoader", startup_timings_.get());
+    system_class_loader_ = CreateSystemClassLoader(this);
+  }
 
   if (!is_zygote_) {
     if (is_native_bridge_loaded_) {
@@ -1133,6 +1159,8 @@ bool Runtime::Start() {
     self->GetJniEnv()->AssertLocalsEmpty();
   }
 
+  ReportStartupMetrics();
+
   VLOG(startup) << "Runtime::Start exiting";
   finished_starting_ = true;
 
@@ -1517,6 +1545,9 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   ScopedTrace trace(__FUNCTION__);
   CHECK_EQ(static_cast<size_t>(sysconf(_SC_PAGE_SIZE)), gPageSize);
 
+  startup_timings_ = std::make_unique<TimingLogger>(
+      "Runtime startup", /*precise=*/ true, /*verbose=*/ false);
+
   // Reload all the flags value (from system properties and device configs).
   ReloadAllFlags(__FUNCTION__);
 
@@ -1574,6 +1605,8 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   Thread::SetSensitiveThreadHook(runtime_options.GetOrDefault(Opt::HookIsSensitiveThread));
   Monitor::Init(runtime_options.GetOrDefault(Opt::LockProfThreshold),
                 runtime_options.GetOrDefault(Opt::StackDumpLockProfThreshold));
+  LockContentionProfiler::SetSamplingInterval(
+      runtime_options.GetOrDefault(Opt::LockContentionSamplingInterval));
 
   image_locations_ = runtime_options.ReleaseOrDefault(Opt::Image);
 
@@ -1738,49 +1771,59 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                         (gUseUserfaultfd ? BackgroundGcOption(gc::kCollectorTypeCMCBackground) :
                                            runtime_options.GetOrDefault(Opt::BackgroundGc));
 
-  heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
-                       runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
-                       runtime_options.GetOrDefault(Opt::HeapMinFree),
-                       runtime_options.GetOrDefault(Opt::HeapMaxFree),
-                       runtime_options.GetOrDefault(Opt::HeapTargetUtilization),
-                       foreground_heap_growth_multiplier,
-                       runtime_options.GetOrDefault(Opt::StopForNativeAllocs),
-                       runtime_options.GetOrDefault(Opt::MemoryMaximumSize),
-                       runtime_options.GetOrDefault(Opt::NonMovingSpaceCapacity),
-                       GetBootClassPath(),
-                       GetBootClassPathLocations(),
-                       GetBootClassPathFiles(),
-                       GetBootClassPathImageFiles(),
-                       GetBootClassPathVdexFiles(),
-                       GetBootClassPathOatFiles(),
-                       image_locations_,
-                       instruction_set_,
-                       // Override the collector type to CC if the read barrier config.
-                       gUseReadBarrier ? gc::kCollectorTypeCC : xgc_option.collector_type_,
-                       background_gc,
-                       runtime_options.GetOrDefault(Opt::LargeObjectSpace),
-                       runtime_options.GetOrDefault(Opt::LargeObjectThreshold),
-                       runtime_options.GetOrDefault(Opt::ParallelGCThreads),
-                       runtime_options.GetOrDefault(Opt::ConcGCThreads),
-                       runtime_options.Exists(Opt::LowMemoryMode),
-                       runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
-                       runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
-                       runtime_options.Exists(Opt::IgnoreMaxFootprint),
-                       runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
-                       runtime_options.GetOrDefault(Opt::UseTLAB),
-                       xgc_option.verify_pre_gc_heap_,
-                       xgc_option.verify_pre_sweeping_heap_,
-                       xgc_option.verify_post_gc_heap_,
-                       xgc_option.verify_pre_gc_rosalloc_,
-                       xgc_option.verify_pre_sweeping_rosalloc_,
-                       xgc_option.verify_post_gc_rosalloc_,
-                       xgc_option.gcstress_,
-                       xgc_option.measure_,
-                       runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
-                       use_generational_cc,
-                       runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
-                       runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
-                       runtime_options.Exists(Opt::DumpRegionInfoAfterGC));
+  {
+    TimingLogger::ScopedTiming timing(kStartupHeapCreation, startup_timings_.get());
+    heap_ = new gc::Heap(runtime_options.GetOrDefault(Opt::MemoryInitialSize),
+                         runtime_options.GetOrDefault(Opt::HeapGrowthLimit),
+                         runtime_options.GetOrDefault(Opt::HeapMinFree),
+                         runtime_options.GetOrDefault(Opt::HeapMaxFree),
+                         runtime_options.GetOrDefault(Opt::HeapTargetUtilization),
+                         foreground_heap_growth_multiplier,
+                         runtime_options.GetOrDefault(Opt::StopForNativeAllocs),
+                         runtime_options.GetOrDefault(Opt::MemoryMaximumSize),
+                         runtime_options.GetOrDefault(Opt::NonMovingSpaceCapacity),
+                         GetBootClassPath(),
+                         GetBootClassPathLocations(),
+                         GetBootClassPathFiles(),
+                         GetBootClassPathImageFiles(),
+                         GetBootClassPathVdexFiles(),
+                         GetBootClassPathOatFiles(),
+                         image_locations_,
+                         instruction_set_,
+                         // Override the collector type to CC if the read barrier config.
+                         gUseReadBarrier ? gc::kCollectorTypeCC : xgc_option.collector_type_,
+                         background_gc,
+                         runtime_options.GetOrDefault(Opt::LargeObjectSpace),
+                         runtime_options.GetOrDefault(Opt::LargeObjectThreshold),
+                         runtime_options.GetOrDefault(Opt::ParallelGCThreads),
+                         runtime_options.GetOrDefault(Opt::ConcGCThreads),
+                         runtime_options.Exists(Opt::LowMemoryMode),
+                         runtime_options.GetOrDefault(Opt::LongPauseLogThreshold),
+                         runtime_options.GetOrDefault(Opt::LongGCLogThreshold),
+                         runtime_options.Exists(Opt::IgnoreMaxFootprint),
+                         runtime_options.GetOrDefault(Opt::AlwaysLogExplicitGcs),
+                         runtime_options.GetOrDefault(Opt::UseTLAB),
+                         xgc_option.verify_pre_gc_heap_,
+                         xgc_option.verify_pre_sweeping_heap_,
+                         xgc_option.verify_post_gc_heap_,
+                         xgc_option.verify_pre_gc_rosalloc_,
+                         xgc_option.verify_pre_sweeping_rosalloc_,
+                         xgc_option.verify_post_gc_rosalloc_,
+                         xgc_option.incremental_verify_heap_,
+                         xgc_option.gcstress_,
+                         xgc_option.measure_,
+                         runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
+                         use_generational_cc,
+                         runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs),
+                         runtime_options.Exists(Opt::DumpRegionInfoBeforeGC),
+                         runtime_options.Exists(Opt::DumpRegionInfoAfterGC),
+                         runtime_options.Exists(Opt::UseTransparentHugePages));
+  }
+  heap_->SetGcCpuAffinity(runtime_options.ReleaseOrDefault(Opt::ForegroundGcCpuAffinity),
+                          runtime_options.ReleaseOrDefault(Opt::BackgroundGcCpuAffinity));
+  heap_->SetGcCpuBudget(runtime_options.GetOrDefault(Opt::GcCpuBudget));
+  heap_->SetAllocTrackerSampleInterval(
+      runtime_options.GetOrDefault(Opt::AllocTrackerSampleInterval));
 
   dump_gc_performance_on_shutdown_ = runtime_options.Exists(Opt::DumpGCPerformanceOnShutdown);
 
@@ -1946,7 +1989,11 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
         runtime_options.GetOrDefault(Opt::FastClassNotFoundException));
   }
   if (GetHeap()->HasBootImageSpace()) {
-    bool result = class_linker_->InitFromBootImage(&error_msg);
+    bool result;
+    {
+      TimingLogger::ScopedTiming timing(kStartupInitFromBootImage, startup_timings_.get());
+      result = class_linker_->InitFromBootImage(&error_msg);
+    }
     if (!result) {
       LOG(ERROR) << "Could not initialize from image: " << error_msg;
       return false;
@@ -1957,7 +2004,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
       }
     }
     {
-      ScopedTrace trace2("AddImageStringsToTable");
+      TimingLogger::ScopedTiming timing("AddImageStringsToTable", startup_timings_.get());
       for (gc::space::ImageSpace* image_space : heap_->GetBootImageSpaces()) {
         GetInternTable()->AddImageStringsToTable(image_space, VoidFunctor());
       }
@@ -2001,7 +2048,12 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        ArrayRef<File>(GetBootClassPathFiles()),
                        &boot_class_path);
     }
-    if (!class_linker_->InitWithoutImage(std::move(boot_class_path), &error_msg)) {
+    bool result;
+    {
+      TimingLogger::ScopedTiming timing(kStartupInitWithoutImage, startup_timings_.get());
+      result = class_linker_->InitWithoutImage(std::move(boot_class_path), &error_msg);
+    }
+    if (!result) {
       LOG(ERROR) << "Could not initialize without image: " << error_msg;
       return false;
     }
@@ -2106,6 +2158,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   {
     // The init method of plugins expect the state of the thread to be non runnable.
     ScopedThreadSuspension sts(self, ThreadState::kNative);
+    TimingLogger::ScopedTiming timing(kStartupLoadPlugins, startup_timings_.get());
     for (auto& plugin : plugins_) {
       std::string err;
       if (!plugin.Load(&err)) {
@@ -2148,32 +2201,35 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   // Startup agents
   // TODO Maybe we should start a new thread to run these on. Investigate RI behavior more.
-  for (auto& agent_spec : agent_specs_) {
-    // TODO Check err
-    int res = 0;
-    std::string err = "";
-    ti::LoadError error;
-    std::unique_ptr<ti::Agent> agent = agent_spec.Load(&res, &error, &err);
-
-    if (agent != nullptr) {
-      agents_.push_back(std::move(agent));
-      continue;
-    }
+  {
+    TimingLogger::ScopedTiming timing(kStartupLoadAgents, startup_timings_.get());
+    for (auto& agent_spec : agent_specs_) {
+      // TODO Check err
+      int res = 0;
+      std::string err = "";
+      ti::LoadError error;
+      std::unique_ptr<ti::Agent> agent = agent_spec.Load(&res, &error, &err);
+
+      if (agent != nullptr) {
+        agents_.push_back(std::move(agent));
+        continue;
+      }
 
-    switch (error) {
-      case ti::LoadError::kInitializationError:
-        LOG(FATAL) << "Unable to initialize agent!";
-        UNREACHABLE();
+      switch (error) {
+        case ti::LoadError::kInitializationError:
+          LOG(FATAL) << "Unable to initialize agent!";
+          UNREACHABLE();
 
-      case ti::LoadError::kLoadingError:
-        LOG(ERROR) << "Unable to load an agent: " << err;
-        continue;
+        case ti::LoadError::kLoadingError:
+          LOG(ERROR) << "Unable to load an agent: " << err;
+          continue;
 
-      case ti::LoadError::kNoError:
-        break;
+        case ti::LoadError::kNoError:
+          break;
+      }
+      LOG(FATAL) << "Unreachable";
+      UNREACHABLE();
     }
-    LOG(FATAL) << "Unreachable";
-    UNREACHABLE();
   }
   {
     ScopedObjectAccess soa(self);
@@ -2198,6 +2254,33 @@ void Runtime::InitMetrics() {
   metrics_reporter_ = metrics::MetricsReporter::Create(metrics_config, this);
 }
 
+void Runtime::ReportStartupMetrics() {
+  DCHECK(startup_timings_ != nullptr);
+  TimingLogger::TimingData timing_data = startup_timings_->CalculateTimingData();
+  const std::vector<TimingLogger::Timing>& timings = startup_timings_->GetTimings();
+  // Returns the total time in microseconds of all phases with one of the `labels`.
+  auto phase_time_us = [&](std::initializer_list<const char*> labels) {
+    uint64_t total_ns = 0u;
+    for (size_t i = 0; i != timings.size(); ++i) {
+      if (timings[i].IsStartTiming() &&
+          std::find(labels.begin(), labels.end(), timings[i].GetName()) != labels.end()) {
+        total_ns += timing_data.GetTotalTime(i);
+      }
+    }
+    return total_ns / 1000u;
+  };
+  metrics::ArtMetrics* metrics = GetMetrics();
+  metrics->StartupHeapCreationTime()->Add(phase_time_us({kStartupHeapCreation}));
+  metrics->StartupClassLinkerInitTime()->Add(
+      phase_time_us({kStartupInitFromBootImage, kStartupInitWithoutImage}));
+  metrics->StartupIntrinsicsInitTime()->Add(phase_time_us({kStartupInitializeIntrinsics}));
+  metrics->StartupJitCreationTime()->Add(phase_time_us({kStartupCreateJit}));
+  metrics->StartupPluginAndAgentLoadingTime()->Add(
+      phase_time_us({kStartupLoadPlugins, kStartupLoadAgents}));
+  VLOG(startup) << Dumpable<TimingLogger>(*startup_timings_);
+  startup_timings_.reset();
+}
+
 void Runtime::RequestMetricsReport(bool synchronous) {
   if (metrics_reporter_) {
     metrics_reporter_->RequestMetricsReport(synchronous);
@@ -2454,6 +2537,7 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   os << "\n";
 
   BaseMutex::DumpAll(os);
+  LockContentionProfiler::Dump(os);
 
   // Inform anyone else who is interested in SigQuit.
   {
@@ -20,6 +20,7 @@
 #include <jni.h>
 #include <stdio.h>
 
+#include <atomic>
 #include <forward_list>
 #include <iosfwd>
 #include <memory>
@@ -118,6 +119,7 @@ class StackOverflowHandler;
 class SuspensionHandler;
 class ThreadList;
 class ThreadPool;
+class TimingLogger;
 class Trace;
 struct TraceConfig;
 class Transaction;
@@ -486,8 +488,11 @@ class Runtime {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Sweep system weaks, the system weak is deleted if the visitor return null. Otherwise, the
-  // system weak is updated to be the visitor's returned value.
-  EXPORT void SweepSystemWeaks(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+  // system weak is updated to be the visitor's returned value. Collectors that sweep in a pause
+  // with objects at their final address can pass `deflate_idle_monitors` to also deflate the
+  // monitors that stayed unused, see `MonitorList::SweepMonitorList()`.
+  EXPORT void SweepSystemWeaks(IsMarkedVisitor* visitor, bool deflate_idle_monitors = false)
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Walk all reflective objects and visit their targets as well as any method/fields held by the
   // runtime threads that are marked as being reflective.
@@ -711,12 +716,20 @@ class Runtime {
 
   void SetHiddenApiEnforcementPolicy(hiddenapi::EnforcementPolicy policy) {
     hidden_api_policy_ = policy;
+    InvalidateHiddenApiDecisions();
   }
 
   hiddenapi::EnforcementPolicy GetHiddenApiEnforcementPolicy() const {
     return hidden_api_policy_;
   }
 
+  // Returns a value that changes whenever a setting that access checks of application code
+  // to hidden API depend on changes, so that cached decisions can be invalidated.
+  uint32_t GetHiddenApiGeneration() const {
+    return hidden_api_generation_.load(std::memory_order_acquire) +
+           compat_framework_.GetGeneration();
+  }
+
   void SetCorePlatformApiEnforcementPolicy(hiddenapi::EnforcementPolicy policy) {
     core_platform_api_policy_ = policy;
   }
@@ -727,6 +740,7 @@ class Runtime {
 
   void SetTestApiEnforcementPolicy(hiddenapi::EnforcementPolicy policy) {
     test_api_policy_ = policy;
+    InvalidateHiddenApiDecisions();
   }
 
   hiddenapi::EnforcementPolicy GetTestApiEnforcementPolicy() const {
@@ -735,6 +749,7 @@ class Runtime {
 
   void SetHiddenApiExemptions(const std::vector<std::string>& exemptions) {
     hidden_api_exemptions_ = exemptions;
+    InvalidateHiddenApiDecisions();
   }
 
   const std::vector<std::string>& GetHiddenApiExemptions() {
@@ -791,6 +806,7 @@ class Runtime {
 
   void SetTargetSdkVersion(uint32_t version) {
     target_sdk_version_ = version;
+    InvalidateHiddenApiDecisions();
   }
 
   uint32_t GetTargetSdkVersion() const {
@@ -1201,6 +1217,8 @@ class Runtime {
   void InitNativeMethods() REQUIRES(!Locks::mutator_lock_);
   void RegisterRuntimeNativeMethods(JNIEnv* env);
   void InitMetrics();
+  // Add the durations of the startup phases to the metrics and release the timings.
+  void ReportStartupMetrics();
 
   void StartDaemonThreads() REQUIRES_SHARED(Locks::mutator_lock_);
   void StartSignalCatcher();
@@ -1500,6 +1518,13 @@ class Runtime {
   // Whether access checks on hidden API should be performed.
   hiddenapi::EnforcementPolicy hidden_api_policy_;
 
+  void InvalidateHiddenApiDecisions() {
+    hidden_api_generation_.fetch_add(1u, std::memory_order_release);
+  }
+
+  // Incremented by the setters of the hidden API settings, see `GetHiddenApiGeneration()`.
+  std::atomic<uint32_t> hidden_api_generation_;
+
   // Whether access checks on core platform API should be performed.
   hiddenapi::EnforcementPolicy core_platform_api_policy_;
 
@@ -1595,6 +1620,9 @@ class Runtime {
   metrics::ArtMetrics metrics_;
   std::unique_ptr<metrics::MetricsReporter> metrics_reporter_;
 
+  // Timeline of the phases of `Init()` and `Start()`. Released once reported.
+  std::unique_ptr<TimingLogger> startup_timings_;
+
   // Apex versions of boot classpath jars concatenated in a string. The format
   // is of the type:
   // '/apex1_version/apex2_version//'
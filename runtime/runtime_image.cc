@@ -20,6 +20,7 @@
 #include <unistd.h>
 
 #include "android-base/file.h"
+#include "android-base/scopeguard.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 #include "arch/instruction_set.h"
@@ -50,6 +51,7 @@
 #include "oat/oat.h"
 #include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread.h"
 #include "vdex_file.h"
 
 namespace art HIDDEN {
@@ -1886,6 +1888,16 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
 
   ScopedTrace write_image_trace("Writing runtime image to disk");
 
+  // Nothing waits for the image, so compress and write it at the lowest priority to keep it
+  // from competing with the app, which is usually still busy right after startup. Generating
+  // the image above holds the mutator lock and the dex lock, so it keeps the normal priority
+  // to avoid a priority inversion with the threads waiting for these locks.
+  Thread* self = Thread::Current();
+  const int old_priority = self->GetNativePriority();
+  self->SetNativePriority(kMinThreadPriority);
+  auto restore_priority =
+      android::base::make_scope_guard([&]() { self->SetNativePriority(old_priority); });
+
   const std::string path = GetRuntimeImagePath(image->GetDexLocation());
   if (!EnsureDirectoryExists(android::base::Dirname(path), error_msg)) {
     return false;
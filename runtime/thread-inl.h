@@ -251,7 +251,9 @@ inline void Thread::TransitionToSuspendedAndRunCheckpoints(ThreadState new_state
     StateAndFlags new_state_and_flags = old_state_and_flags.WithState(new_state);
 
     // CAS the value, ensuring that prior memory operations are visible to any thread
-    // that observes that we are suspended.
+    // that observes that we are suspended. Note that this cannot be a plain store, even with
+    // a `membarrier()` on the requesting side: other threads set request flags in the same
+    // word concurrently, and a plain store of `new_state_and_flags` could drop such a request.
     bool done =
         tls32_.state_and_flags.CompareAndSetWeakRelease(old_state_and_flags.GetValue(),
                                                         new_state_and_flags.GetValue());
@@ -1511,6 +1511,8 @@ bool Thread::PassActiveSuspendBarriers() {
       // We have at most one active active_suspendall_barrier. See thread.h comment.
       pass_barriers.push_back(tlsPtr_.active_suspendall_barrier);
       tlsPtr_.active_suspendall_barrier = nullptr;
+      // Published to the suspending thread by the release decrement of the barrier below.
+      suspend_all_barrier_pass_time_ns_.store(NanoTime(), std::memory_order_relaxed);
     }
     for (WrappedSuspend1Barrier* w = tlsPtr_.active_suspend1_barriers; w != nullptr; w = w->next_) {
       CHECK_EQ(w->magic_, WrappedSuspend1Barrier::kMagic)
@@ -2907,16 +2909,14 @@ void Thread::SetClassLoaderOverride(jobject class_loader_override) {
 
 using ArtMethodDexPcPair = std::pair<ArtMethod*, uint32_t>;
 
-// Counts the stack trace depth and also fetches the first max_saved_frames frames.
+// Counts the stack trace depth and also fetches the frames if `saved_frames` is not null.
 class FetchStackTraceVisitor : public StackVisitor {
  public:
   explicit FetchStackTraceVisitor(Thread* thread,
-                                  ArtMethodDexPcPair* saved_frames = nullptr,
-                                  size_t max_saved_frames = 0)
+                                  std::vector<ArtMethodDexPcPair>* saved_frames = nullptr)
       REQUIRES_SHARED(Locks::mutator_lock_)
       : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
-        saved_frames_(saved_frames),
-        max_saved_frames_(max_saved_frames) {}
+        saved_frames_(saved_frames) {}
 
   bool VisitFrame() override REQUIRES_SHARED(Locks::mutator_lock_) {
     // We want to skip frames up to and including the exception's constructor.
@@ -2929,14 +2929,11 @@ class FetchStackTraceVisitor : public StackVisitor {
     }
     if (!skipping_) {
       if (!m->IsRuntimeMethod()) {  // Ignore runtime frames (in particular callee save).
-        if (depth_ < max_saved_frames_) {
-          saved_frames_[depth_].first = m;
-          saved_frames_[depth_].second = m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc();
+        if (saved_frames_ != nullptr) {
+          saved_frames_->emplace_back(m, m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc());
         }
         ++depth_;
       }
-    } else {
-      ++skip_depth_;
     }
     return true;
   }
@@ -2945,26 +2942,19 @@ class FetchStackTraceVisitor : public StackVisitor {
     return depth_;
   }
 
-  uint32_t GetSkipDepth() const {
-    return skip_depth_;
-  }
-
  private:
   uint32_t depth_ = 0;
-  uint32_t skip_depth_ = 0;
   bool skipping_ = true;
-  ArtMethodDexPcPair* saved_frames_;
-  const size_t max_saved_frames_;
+  std::vector<ArtMethodDexPcPair>* const saved_frames_;
 
   DISALLOW_COPY_AND_ASSIGN(FetchStackTraceVisitor);
 };
 
-class BuildInternalStackTraceVisitor : public StackVisitor {
+// Builds the internal stack trace from the frames collected by the `FetchStackTraceVisitor`.
+class BuildInternalStackTraceVisitor {
  public:
-  BuildInternalStackTraceVisitor(Thread* self, Thread* thread, uint32_t skip_depth)
-      : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
-        self_(self),
-        skip_depth_(skip_depth),
+  explicit BuildInternalStackTraceVisitor(Thread* self)
+      : self_(self),
         pointer_size_(Runtime::Current()->GetClassLinker()->GetImagePointerSize()) {}
 
   bool Init(uint32_t depth) REQUIRES_SHARED(Locks::mutator_lock_) ACQUIRE(Roles::uninterruptible_) {
@@ -3001,26 +2991,10 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
     return true;
   }
 
-  virtual ~BuildInternalStackTraceVisitor() RELEASE(Roles::uninterruptible_) {
+  ~BuildInternalStackTraceVisitor() RELEASE(Roles::uninterruptible_) {
     self_->EndAssertNoThreadSuspension(nullptr);
   }
 
-  bool VisitFrame() override REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (trace_ == nullptr) {
-      return true;  // We're probably trying to fillInStackTrace for an OutOfMemoryError.
-    }
-    if (skip_depth_ > 0) {
-      skip_depth_--;
-      return true;
-    }
-    ArtMethod* m = GetMethod();
-    if (m->IsRuntimeMethod()) {
-      return true;  // Ignore runtime frames (in particular callee save).
-    }
-    AddFrame(m, m->IsProxyMethod() ? dex::kDexNoIndex : GetDexPc());
-    return true;
-  }
-
   void AddFrame(ArtMethod* method, uint32_t dex_pc) REQUIRES_SHARED(Locks::mutator_lock_) {
     ObjPtr<mirror::PointerArray> methods_and_pcs = GetTraceMethodsAndPCs();
     methods_and_pcs->SetElementPtrSize</*kTransactionActive=*/ false, /*kCheckTransaction=*/ false>(
@@ -3054,8 +3028,6 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
 
  private:
   Thread* const self_;
-  // How many more frames to skip.
-  uint32_t skip_depth_;
   // Current position down stack trace.
   uint32_t count_ = 0;
   // An object array where the first element is a pointer array that contains the `ArtMethod`
@@ -3074,30 +3046,25 @@ class BuildInternalStackTraceVisitor : public StackVisitor {
 };
 
 jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa) const {
-  // Compute depth of stack, save frames if possible to avoid needing to recompute many.
-  constexpr size_t kMaxSavedFrames = 256;
-  std::unique_ptr<ArtMethodDexPcPair[]> saved_frames(new ArtMethodDexPcPair[kMaxSavedFrames]);
-  FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this),
-                                       &saved_frames[0],
-                                       kMaxSavedFrames);
+  // Compute depth of stack and save all frames, so that the stack is walked only once. Walking
+  // the stack, and in particular decoding the dex pcs of compiled frames, is the dominant cost
+  // of constructing a `Throwable`. The dex pcs cannot be decoded lazily later since the frames
+  // and possibly their JIT code are gone by the time the stack trace is requested.
+  constexpr size_t kInitialSavedFrames = 256;
+  std::vector<ArtMethodDexPcPair> saved_frames;
+  saved_frames.reserve(kInitialSavedFrames);
+  FetchStackTraceVisitor count_visitor(const_cast<Thread*>(this), &saved_frames);
   count_visitor.WalkStack();
   const uint32_t depth = count_visitor.GetDepth();
-  const uint32_t skip_depth = count_visitor.GetSkipDepth();
+  DCHECK_EQ(depth, saved_frames.size());
 
   // Build internal stack trace.
-  BuildInternalStackTraceVisitor build_trace_visitor(
-      soa.Self(), const_cast<Thread*>(this), skip_depth);
+  BuildInternalStackTraceVisitor build_trace_visitor(soa.Self());
   if (!build_trace_visitor.Init(depth)) {
     return nullptr;  // Allocation failed.
   }
-  // If we saved all of the frames we don't even need to do the actual stack walk. This is faster
-  // than doing the stack walk twice.
-  if (depth < kMaxSavedFrames) {
-    for (size_t i = 0; i < depth; ++i) {
-      build_trace_visitor.AddFrame(saved_frames[i].first, saved_frames[i].second);
-    }
-  } else {
-    build_trace_visitor.WalkStack();
+  for (const ArtMethodDexPcPair& frame : saved_frames) {
+    build_trace_visitor.AddFrame(frame.first, frame.second);
   }
 
   mirror::ObjectArray<mirror::Object>* trace = build_trace_visitor.GetInternalStackTrace();
@@ -4244,9 +4211,13 @@ class ReferenceMapVisitor : public StackVisitor {
       StackReference<mirror::Object>* vreg_base =
           reinterpret_cast<StackReference<mirror::Object>*>(cur_quick_frame);
       uintptr_t native_pc_offset = method_header->NativeQuickPcOffset(GetCurrentQuickFramePc());
-      CodeInfo code_info = kPrecise
-          ? CodeInfo(method_header)  // We will need dex register maps.
-          : CodeInfo::DecodeGcMasksOnly(method_header);
+      if (method_header != code_info_header_) {
+        code_info_ = kPrecise
+            ? CodeInfo(method_header)  // We will need dex register maps.
+            : CodeInfo::DecodeGcMasksOnly(method_header);
+        code_info_header_ = method_header;
+      }
+      const CodeInfo& code_info = code_info_;
       StackMap map = code_info.GetStackMapForNativePcOffset(native_pc_offset);
       DCHECK(map.IsValid());
 
@@ -4404,6 +4375,11 @@ class ReferenceMapVisitor : public StackVisitor {
   // Visitor for when we visit a root.
   RootVisitor& visitor_;
   bool visit_declaring_class_;
+
+  // The CodeInfo decoded for the last compiled frame. Recursion often puts consecutive
+  // frames of the same compiled code on the stack, so we avoid decoding it again.
+  const OatQuickMethodHeader* code_info_header_ = nullptr;
+  CodeInfo code_info_;
 };
 
 class RootCallbackVisitor {
@@ -4445,6 +4421,9 @@ void Thread::VisitRoots(RootVisitor* visitor) {
                        RootInfo(kRootNativeStack, thread_id));
   }
   visitor->VisitRootIfNonNull(&tlsPtr_.monitor_enter_object, RootInfo(kRootNativeStack, thread_id));
+  for (ThinLockHashCode& entry : thin_lock_hash_codes_) {
+    visitor->VisitRootIfNonNull(&entry.obj, RootInfo(kRootNativeStack, thread_id));
+  }
   tlsPtr_.jni_env->VisitJniLocalRoots(visitor, RootInfo(kRootJNILocal, thread_id));
   tlsPtr_.jni_env->VisitMonitorRoots(visitor, RootInfo(kRootJNIMonitor, thread_id));
   HandleScopeVisitRoots(visitor, thread_id);
@@ -4561,6 +4540,11 @@ void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
   for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetArray()) {
     SweepCacheEntry(visitor, reinterpret_cast<const Instruction*>(entry.first), &entry.second);
   }
+  for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetVictimArray()) {
+    SweepCacheEntry(visitor, reinterpret_cast<const Instruction*>(entry.first), &entry.second);
+  }
+  // The moving collectors call this before they move or free classes.
+  GetTypeCheckCache()->Clear();
 }
 
 // FIXME: clang-r433403 reports the below function exceeds frame size limit.
@@ -4760,6 +4744,51 @@ bool Thread::IsAotCompiler() {
   return Runtime::Current()->IsAotCompiler();
 }
 
+bool Thread::AddThinLockHashCode(ObjPtr<mirror::Object> obj, int32_t hash_code) {
+  DCHECK_EQ(Thread::Current(), this);
+  DCHECK_NE(hash_code, 0);
+  for (ThinLockHashCode& entry : thin_lock_hash_codes_) {
+    if (entry.obj == nullptr) {
+      entry.obj = obj.Ptr();
+      entry.hash_code = hash_code;
+      return true;
+    }
+  }
+  return false;
+}
+
+int32_t Thread::GetThinLockHashCode(Thread* self, ObjPtr<mirror::Object> obj) {
+  if (self != this) {
+    // As in `GetPeerFromOtherThread()`, make sure that our roots are not from-space references.
+    DCHECK(IsSuspended()) << *this;
+    EnsureFlipFunctionStarted(self, this);
+    if (ReadFlag(ThreadFlag::kRunningFlipFunction)) {
+      WaitForFlipFunction(self);
+    }
+  }
+  for (const ThinLockHashCode& entry : thin_lock_hash_codes_) {
+    if (entry.obj == obj.Ptr()) {
+      return entry.hash_code;
+    }
+  }
+  LOG(FATAL) << "No hash code recorded for thin-locked object " << obj
+             << " by thread " << GetThreadId();
+  UNREACHABLE();
+}
+
+void Thread::RemoveThinLockHashCode(ObjPtr<mirror::Object> obj) {
+  for (ThinLockHashCode& entry : thin_lock_hash_codes_) {
+    if (entry.obj == obj.Ptr()) {
+      entry.obj = nullptr;
+      entry.hash_code = 0;
+      return;
+    }
+  }
+  LOG(FATAL) << "No hash code recorded for thin-locked object " << obj
+             << " by thread " << GetThreadId();
+  UNREACHABLE();
+}
+
 mirror::Object* Thread::GetPeerFromOtherThread() {
   Thread* self = Thread::Current();
   if (this == self) {
@@ -4820,6 +4849,32 @@ void Thread::ClearAllInterpreterCaches() {
   Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
 }
 
+void Thread::ClearInterpreterCaches(const std::vector<const DexFile*>& dex_files) {
+  class ClearInterpreterCacheRangesClosure : public Closure {
+   public:
+    explicit ClearInterpreterCacheRangesClosure(const std::vector<const DexFile*>& dex_files)
+        : dex_files_(dex_files) {}
+
+    void Run(Thread* thread) override {
+      InterpreterCache* cache = thread->GetInterpreterCache();
+      for (const DexFile* dex_file : dex_files_) {
+        if (dex_file == nullptr) {
+          continue;
+        }
+        // Code items are in the data section, which may not be part of [Begin(), Size()).
+        cache->ClearRange(thread, dex_file->Begin(), dex_file->Begin() + dex_file->Size());
+        cache->ClearRange(
+            thread, dex_file->DataBegin(), dex_file->DataBegin() + dex_file->DataSize());
+      }
+    }
+
+   private:
+    const std::vector<const DexFile*>& dex_files_;
+  };
+  ClearInterpreterCacheRangesClosure closure(dex_files);
+  Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+}
+
 
 void Thread::ReleaseLongJumpContextInternal() {
   // Each QuickExceptionHandler gets a long jump context and uses
@@ -24,6 +24,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/atomic.h"
 #include "base/bit_field.h"
@@ -49,6 +50,7 @@
 #include "runtime_stats.h"
 #include "suspend_reason.h"
 #include "thread_state.h"
+#include "type_check_cache.h"
 
 namespace unwindstack {
 class AndroidLocalUnwinder;
@@ -786,6 +788,23 @@ class EXPORT Thread {
     tlsPtr_.monitor_enter_object = obj;
   }
 
+  // Identity hash codes of objects thin-locked by this thread, for the lock words with the hash
+  // code flag, see `LockWord::ThinLockHasHashCode()`. This lets a thin lock and an identity hash
+  // code coexist until the lock is released, instead of inflating the lock. Other threads that
+  // need the hash code inflate the lock, which suspends the owner as for any other thin lock, so
+  // objects that already have a hash code are still inflated when locked.
+  //
+  // Record the hash code of `obj`. Returns false if there is no free entry. Must be called by
+  // this thread.
+  bool AddThinLockHashCode(ObjPtr<mirror::Object> obj, int32_t hash_code)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Return the hash code of `obj`, which must have been recorded. Must be called by this thread,
+  // or by `self` with this thread suspended.
+  int32_t GetThinLockHashCode(Thread* self, ObjPtr<mirror::Object> obj)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  // Forget the hash code of `obj`, once it has moved to the lock word or to a monitor.
+  void RemoveThinLockHashCode(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Implements java.lang.Thread.interrupted.
   bool Interrupted();
   // Implements java.lang.Thread.isInterrupted.
@@ -1560,6 +1579,35 @@ class EXPORT Thread {
     return &interpreter_cache_;
   }
 
+  ALWAYS_INLINE TypeCheckCache* GetTypeCheckCache() {
+    return &type_check_cache_;
+  }
+
+  // Whether the JIT asked this thread to leave baseline code for OSR code at its next suspend
+  // check, see `Jit::MaybeRequestOsrFromBaseline()`. Only accessed by the thread itself.
+  bool IsOsrFromBaselineRequested() const {
+    return osr_from_baseline_requested_;
+  }
+
+  void SetOsrFromBaselineRequested(bool requested) {
+    osr_from_baseline_requested_ = requested;
+  }
+
+  // Per-thread state used by the heap to size new TLABs (see Heap::AdaptiveTlabSize()).
+  // Only accessed by the thread itself.
+  struct TlabSizing {
+    // Number of TLAB refills since the last adjustment of `size_shift`.
+    uint32_t refill_count = 0;
+    // GC number (see Heap::GetCurrentGcNum()) at the time of the last refill.
+    uint32_t gc_num = 0;
+    // Log2 of the factor by which the default TLAB size is scaled.
+    uint8_t size_shift = 0;
+  };
+
+  TlabSizing* GetTlabSizing() {
+    return &tlab_sizing_;
+  }
+
   // Clear all thread-local interpreter caches.
   //
   // Since the caches are keyed by memory pointer to dex instructions, this must be
@@ -1570,6 +1618,10 @@ class EXPORT Thread {
   // called if the pre-conditions might no longer hold true.
   static void ClearAllInterpreterCaches();
 
+  // Clear only the interpreter cache entries of instructions in `dex_files`, which may
+  // contain null entries. This must be called when these dex files are unloaded.
+  static void ClearInterpreterCaches(const std::vector<const DexFile*>& dex_files);
+
   template<PointerSize pointer_size>
   static constexpr ThreadOffset<pointer_size> InterpreterCacheOffset() {
     return ThreadOffset<pointer_size>(OFFSETOF_MEMBER(Thread, interpreter_cache_));
@@ -2337,6 +2389,22 @@ class EXPORT Thread {
   // Debug disable read barrier count, only is checked for debug builds and only in the runtime.
   uint8_t debug_disallow_read_barrier_ = 0;
 
+  TlabSizing tlab_sizing_;
+
+  // Cache of successful interface checks for classes with many interfaces.
+  TypeCheckCache type_check_cache_;
+
+  bool osr_from_baseline_requested_ = false;
+
+  // Hash codes of objects thin-locked by this thread, see `AddThinLockHashCode()`. Entries with
+  // a null `obj` are free. The objects are roots of this thread.
+  struct ThinLockHashCode {
+    mirror::Object* obj = nullptr;
+    int32_t hash_code = 0;
+  };
+  static constexpr size_t kMaxThinLockHashCodes = 4u;
+  ThinLockHashCode thin_lock_hash_codes_[kMaxThinLockHashCodes];
+
   // Counters used only for debugging and error reporting.  Likely to wrap.  Small to avoid
   // increasing Thread size.
   // We currently maintain these unconditionally, since it doesn't cost much, and we seem to have
@@ -2352,6 +2420,10 @@ class EXPORT Thread {
   // Pending extra checkpoints if checkpoint_function_ is already used.
   std::list<Closure*> checkpoint_overflow_ GUARDED_BY(Locks::thread_suspend_count_lock_);
 
+  // Time at which we last passed a suspend-all barrier ourselves. Used by the thread list to
+  // measure the time each thread took to suspend.
+  std::atomic<uint64_t> suspend_all_barrier_pass_time_ns_ = 0;
+
   // Custom TLS field that can be used by plugins or the runtime. Should not be accessed directly by
   // compiled code or entrypoints.
   SafeMap<std::string, std::unique_ptr<TLSData>, std::less<>> custom_tls_
@@ -20,6 +20,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <tuple>
@@ -31,6 +32,7 @@
 #include "unwindstack/AndroidUnwinder.h"
 
 #include "art_field-inl.h"
+#include "art_method-inl.h"
 #include "base/aborting.h"
 #include "base/histogram-inl.h"
 #include "base/mutex-inl.h"
@@ -76,6 +78,7 @@ ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
     : suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_histogram_("suspend all histogram", 16, 64),
+      time_to_suspend_histogram_("thread time to suspend histogram", 16, 64),
       long_suspend_(false),
       shut_down_(false),
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
@@ -141,6 +144,12 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_histogram_.CreateHistogram(&data);
       suspend_all_histogram_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
+    if (time_to_suspend_histogram_.SampleSize() > 0) {
+      Histogram<uint64_t>::CumulativeData data;
+      time_to_suspend_histogram_.CreateHistogram(&data);
+      time_to_suspend_histogram_.PrintConfidenceIntervals(os, 0.99, data);
+      DumpSlowestSuspensions(os);
+    }
   }
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   Dump(os, dump_native_stack);
@@ -368,6 +377,14 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
   size_t nthreads = remaining_threads.size();
   size_t starting_thread = 0;
   size_t next_starting_thread;  // First possible remaining non-null entry in remaining_threads.
+  // If the caller holds the mutator lock, we suspend all the remaining suspended threads at once
+  // and run their checkpoints in a batch. This avoids releasing and reacquiring the thread list
+  // and suspend count locks, and broadcasting on resume_cond_, once per suspended thread, as
+  // there may be hundreds of them. Holding several threads suspended at once is safe then: the
+  // checkpoint cannot need a lock that a suspended thread would only release after becoming
+  // runnable, since such a lock would have to be acquired before the mutator lock.
+  std::vector<size_t> batch;  // Indexes into remaining_threads.
+  std::vector<bool> batch_done;
   // Run the checkpoint for the suspended threads.
   do {
     // We hold mutator_lock_ (if desired), thread_list_lock_, and suspend_count_lock_
@@ -394,11 +411,16 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
       // We need to run the checkpoint ourselves. Suspend thread so it stays suspended.
       thread->IncrementSuspendCount(self);
       if (LIKELY(thread->IsSuspended())) {
+        if (mutator_lock_held) {
+          // Run the checkpoint function ourselves, with the rest of the batch below.
+          batch.push_back(i);
+          continue;
+        }
         // Run the checkpoint function ourselves.
         // We need to run the checkpoint function without the thread_list and suspend_count locks.
         Locks::thread_suspend_count_lock_->Unlock(self);
         Locks::thread_list_lock_->Unlock(self);
-        if (mutator_lock_held || acquire_mutator_lock) {
+        if (acquire_mutator_lock) {
           // Make sure there is no pending flip function before running Java-heap-accessing
           // checkpoint on behalf of thread.
           Thread::EnsureFlipFunctionStarted(self, thread);
@@ -446,6 +468,41 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function,
         next_starting_thread = std::min(next_starting_thread, i);
       }
     }
+    if (!batch.empty()) {
+      // We need to run the checkpoint functions without the thread_list and suspend_count locks.
+      // The threads of the batch stay suspended until we decrement their suspend counts.
+      Locks::thread_suspend_count_lock_->Unlock(self);
+      Locks::thread_list_lock_->Unlock(self);
+      batch_done.assign(batch.size(), false);
+      for (size_t j = 0; j != batch.size(); ++j) {
+        Thread* thread = remaining_threads[batch[j]];
+        // Make sure there is no pending flip function before running Java-heap-accessing
+        // checkpoint on behalf of thread.
+        Thread::EnsureFlipFunctionStarted(self, thread);
+        if (thread->GetStateAndFlags(std::memory_order_acquire)
+                .IsAnyOfFlagsSet(Thread::FlipFunctionFlags())) {
+          // There is another thread running the flip function for 'thread'.
+          // Retry this one later from scratch.
+          next_starting_thread = std::min(next_starting_thread, batch[j]);
+          continue;
+        }
+        checkpoint_function->Run(thread);
+        batch_done[j] = true;
+      }
+      Locks::thread_list_lock_->Lock(self);
+      Locks::thread_suspend_count_lock_->Lock(self);
+      for (size_t j = 0; j != batch.size(); ++j) {
+        Thread* thread = remaining_threads[batch[j]];
+        thread->DecrementSuspendCount(self);
+        if (batch_done[j]) {
+          thread->UnregisterThreadExitFlag(&tefs[batch[j]]);
+          remaining_threads[batch[j]] = nullptr;
+        }
+      }
+      // One broadcast resumes the whole batch.
+      Thread::resume_cond_->Broadcast(self);
+      batch.clear();
+    }
     starting_thread = next_starting_thread;
   } while (starting_thread != nthreads);
 
@@ -613,6 +670,7 @@ void ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   // Run the flip callback for the collector.
   Locks::mutator_lock_->ExclusiveLock(self);
   suspend_all_histogram_.AdjustAndAddValue(NanoTime() - suspend_start_time);
+  RecordTimeToSuspend(self, suspend_start_time);
   flip_callback->Run(self);
 
   std::vector<Thread*> flipping_threads;  // All suspended threads. Includes us.
@@ -862,6 +920,7 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     const uint64_t end_time = NanoTime();
     const uint64_t suspend_time = end_time - start_time;
     suspend_all_histogram_.AdjustAndAddValue(suspend_time);
+    RecordTimeToSuspend(self, start_time);
     if (suspend_time > kLongThreadSuspendThreshold) {
       LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
     }
@@ -885,6 +944,50 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
   }
 }
 
+void ThreadList::RecordTimeToSuspend(Thread* self, uint64_t start_time) {
+  metrics::ArtMetrics* metrics = Runtime::Current()->GetMetrics();
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  for (Thread* thread : list_) {
+    uint64_t pass_time = thread->suspend_all_barrier_pass_time_ns_.load(std::memory_order_relaxed);
+    if (thread == self || pass_time < start_time) {
+      continue;  // The thread did not have to pass the barrier itself.
+    }
+    uint64_t time_to_suspend = pass_time - start_time;
+    time_to_suspend_histogram_.AdjustAndAddValue(time_to_suspend);
+    metrics->ThreadTimeToSuspend()->Add(static_cast<int64_t>(NsToUs(time_to_suspend)));
+    if (slowest_suspensions_.size() == kMaxSlowSuspensions &&
+        time_to_suspend <= slowest_suspensions_.back().time_to_suspend_ns) {
+      continue;
+    }
+    // The thread is suspended, so its top frame is where it noticed the suspend request.
+    ArtMethod* method =
+        thread->GetCurrentMethod(nullptr, /*check_suspended=*/ false, /*abort_on_error=*/ false);
+    SlowSuspension slow_suspension = {
+        time_to_suspend,
+        thread->GetTid(),
+        /*thread_name=*/ "",
+        method != nullptr ? method->PrettyMethod() : "<no managed frame>"};
+    thread->GetThreadName(slow_suspension.thread_name);
+    auto it = std::find_if(slowest_suspensions_.begin(),
+                           slowest_suspensions_.end(),
+                           [=](const SlowSuspension& s) {
+                             return s.time_to_suspend_ns < time_to_suspend;
+                           });
+    slowest_suspensions_.insert(it, std::move(slow_suspension));
+    if (slowest_suspensions_.size() > kMaxSlowSuspensions) {
+      slowest_suspensions_.pop_back();
+    }
+  }
+}
+
+void ThreadList::DumpSlowestSuspensions(std::ostream& os) {
+  os << "Slowest threads to suspend:\n";
+  for (const SlowSuspension& s : slowest_suspensions_) {
+    os << "  " << PrettyDuration(s.time_to_suspend_ns) << " \"" << s.thread_name
+       << "\" tid=" << s.tid << " in " << s.method << "\n";
+  }
+}
+
 // Ensures all threads running Java suspend and that those not running Java don't start.
 void ThreadList::SuspendAllInternal(Thread* self, SuspendReason reason) {
   // self can be nullptr if this is an unregistered thread.
@@ -1641,6 +1744,13 @@ void ThreadList::SweepInterpreterCaches(IsMarkedVisitor* visitor) const {
   }
 }
 
+void ThreadList::ClearTypeCheckCaches() const {
+  MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
+  for (const auto& thread : list_) {
+    thread->GetTypeCheckCache()->Clear();
+  }
+}
+
 uint32_t ThreadList::AllocThreadId(Thread* self) {
   MutexLock mu(self, *Locks::allocated_thread_ids_lock_);
   for (size_t i = 0; i < allocated_ids_.size(); ++i) {
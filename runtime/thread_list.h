@@ -19,6 +19,7 @@
 
 #include <bitset>
 #include <list>
+#include <string>
 #include <vector>
 
 #include "barrier.h"
@@ -47,7 +48,9 @@ enum VisitRootFlags : uint8_t;
 
 class ThreadList {
  public:
-  static constexpr uint32_t kMaxThreadId = 0xFFFF;
+  // Thread ids must fit in the owner of a thin lock word, which reserves its top bit for the
+  // hash code flag, see `LockWord::ThinLockHasHashCode()`.
+  static constexpr uint32_t kMaxThreadId = 0x7FFF;
   static constexpr uint32_t kInvalidThreadId = 0;
   static constexpr uint32_t kMainThreadId = 1;
   static constexpr uint64_t kDefaultThreadSuspendTimeout =
@@ -213,6 +216,10 @@ class ThreadList {
   EXPORT void SweepInterpreterCaches(IsMarkedVisitor* visitor) const
       REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
 
+  // Empty the `TypeCheckCache` of every thread, for collectors that free classes without
+  // sweeping the interpreter caches.
+  void ClearTypeCheckCaches() const REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+
   // Return a copy of the thread list.
   std::list<Thread*> GetList() REQUIRES(Locks::thread_list_lock_) {
     return list_;
@@ -276,6 +283,14 @@ class ThreadList {
   void AssertOtherThreadsAreSuspended(Thread* self)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Record how long each thread took to pass the barrier of the suspend-all that started at
+  // `start_time`, and remember the slowest ones. Threads that were already suspended when the
+  // suspend-all started are not counted.
+  void RecordTimeToSuspend(Thread* self, uint64_t start_time)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_);
+
+  void DumpSlowestSuspensions(std::ostream& os) REQUIRES_SHARED(Locks::mutator_lock_);
+
   std::bitset<kMaxThreadId> allocated_ids_ GUARDED_BY(Locks::allocated_thread_ids_lock_);
 
   // The actual list of all threads.
@@ -294,6 +309,21 @@ class ThreadList {
   // by mutator lock ensures no thread can read when another thread is modifying it.
   Histogram<uint64_t> suspend_all_histogram_ GUARDED_BY(Locks::mutator_lock_);
 
+  // Histogram of the time individual threads took to respond to suspend-all requests, guarded
+  // like `suspend_all_histogram_`.
+  Histogram<uint64_t> time_to_suspend_histogram_ GUARDED_BY(Locks::mutator_lock_);
+
+  // A thread that was slow to respond to a suspend-all request, and the method it was running.
+  struct SlowSuspension {
+    uint64_t time_to_suspend_ns;
+    pid_t tid;
+    std::string thread_name;
+    std::string method;
+  };
+  static constexpr size_t kMaxSlowSuspensions = 8;
+  // The slowest responses seen so far, slowest first.
+  std::vector<SlowSuspension> slowest_suspensions_ GUARDED_BY(Locks::mutator_lock_);
+
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_list.h"
+
+#include <sched.h>
+
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "common_runtime_test.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+#include "thread_pool.h"
+
+namespace art HIDDEN {
+
+class ThreadListTest : public CommonRuntimeTest {};
+
+// Stays runnable, checking for suspension requests, until told to stop.
+class RunnableLoopTask : public Task {
+ public:
+  RunnableLoopTask(std::atomic<bool>* running, std::atomic<bool>* stop)
+      : running_(running), stop_(stop) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    running_->store(true);
+    while (!stop_->load()) {
+      self->AllowThreadSuspension();
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  std::atomic<bool>* running_;
+  std::atomic<bool>* stop_;
+};
+
+// Test that threads passing the barrier of a suspend-all show up in SIGQUIT dumps.
+TEST_F(ThreadListTest, TimeToSuspendIsDumped) {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(ThreadPool::Create("Suspend test pool", 1));
+  std::atomic<bool> running = false;
+  std::atomic<bool> stop = false;
+  thread_pool->AddTask(self, new RunnableLoopTask(&running, &stop));
+  thread_pool->StartWorkers(self);
+  while (!running.load()) {
+    sched_yield();
+  }
+  {
+    ScopedSuspendAll ssa(__FUNCTION__);
+  }
+  stop.store(true);
+  thread_pool->Wait(self, /*do_work=*/false, /*may_hold_locks=*/false);
+  thread_pool->StopWorkers(self);
+
+  std::ostringstream oss;
+  Runtime::Current()->GetThreadList()->DumpForSigQuit(oss);
+  std::string dump = oss.str();
+  EXPECT_NE(std::string::npos, dump.find("thread time to suspend histogram")) << dump;
+  size_t slowest = dump.find("Slowest threads to suspend:");
+  ASSERT_NE(std::string::npos, slowest) << dump;
+  // The worker runs no managed code.
+  EXPECT_NE(std::string::npos,
+            dump.find("\"Suspend test pool worker thread 0\" tid=", slowest)) << dump;
+  EXPECT_NE(std::string::npos, dump.find("in <no managed frame>", slowest)) << dump;
+}
+
+}  // namespace art
@@ -115,6 +115,16 @@ int ThreadPoolWorker::GetPthreadPriority() {
 #endif
 }
 
+void ThreadPoolWorker::SetPthreadAffinity(const cpu_set_t& cpu_set) {
+#if defined(ART_TARGET_ANDROID)
+  if (sched_setaffinity(pthread_gettid_np(pthread_), sizeof(cpu_set), &cpu_set) != 0) {
+    PLOG(WARNING) << "Failed to set CPU affinity of thread pool worker " << name_;
+  }
+#else
+  UNUSED(cpu_set);
+#endif
+}
+
 void ThreadPoolWorker::Run() {
   Thread* self = Thread::Current();
   Task* task = nullptr;
@@ -346,12 +356,267 @@ size_t ThreadPool::GetTaskCount(Thread* self) {
   return tasks_.size();
 }
 
+// The work-stealing pool whose deque at `current_deque_index` is owned by the current thread.
+static thread_local const WorkStealingThreadPool* current_work_stealing_pool = nullptr;
+static thread_local size_t current_deque_index = 0u;
+
+bool WorkStealingDeque::Push(Task* task) {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  int64_t top = top_.load(std::memory_order_acquire);
+  if (bottom - top >= static_cast<int64_t>(kCapacity)) {
+    return false;
+  }
+  buffer_[bottom & (kCapacity - 1u)].store(task, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+  return true;
+}
+
+Task* WorkStealingDeque::Pop() {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = top_.load(std::memory_order_relaxed);
+  if (top > bottom) {
+    // Empty.
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  Task* task = buffer_[bottom & (kCapacity - 1u)].load(std::memory_order_relaxed);
+  if (top == bottom) {
+    // This is the last task, thieves may be trying to take it too.
+    if (!top_.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      task = nullptr;
+    }
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return task;
+}
+
+Task* WorkStealingDeque::Steal() {
+  int64_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+    return nullptr;
+  }
+  Task* task = buffer_[top & (kCapacity - 1u)].load(std::memory_order_relaxed);
+  if (!top_.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  return task;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(const char* name,
+                                               size_t num_threads,
+                                               bool create_peers,
+                                               size_t worker_stack_size)
+    : AbstractThreadPool(name, num_threads, create_peers, worker_stack_size),
+      num_deques_(num_threads),
+      deques_(new WorkStealingDeque[num_threads]),
+      deque_owners_(new std::atomic<Thread*>[num_threads]),
+      num_parked_(0u),
+      active_workers_limit_(num_threads) {
+  for (size_t i = 0; i != num_deques_; ++i) {
+    deque_owners_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  DeleteThreads();
+  RemoveAllTasks(Thread::Current());
+}
+
+size_t WorkStealingThreadPool::FindDeque(Thread* self) const {
+  if (current_work_stealing_pool == this) {
+    DCHECK_EQ(deque_owners_[current_deque_index].load(std::memory_order_relaxed), self);
+    return current_deque_index;
+  }
+  return num_deques_;
+}
+
+size_t WorkStealingThreadPool::ClaimDeque(Thread* self) {
+  for (size_t i = 0; i != num_deques_; ++i) {
+    Thread* owner = nullptr;
+    if (deque_owners_[i].compare_exchange_strong(owner, self, std::memory_order_relaxed)) {
+      current_work_stealing_pool = this;
+      current_deque_index = i;
+      return i;
+    }
+  }
+  LOG(FATAL) << "More workers than deques in " << name_;
+  UNREACHABLE();
+}
+
+void WorkStealingThreadPool::ReleaseDeque(size_t index) {
+  DCHECK_EQ(current_work_stealing_pool, this);
+  current_work_stealing_pool = nullptr;
+  deque_owners_[index].store(nullptr, std::memory_order_relaxed);
+}
+
+Task* WorkStealingThreadPool::StealTask(size_t first_victim) {
+  for (size_t i = 0; i != num_deques_; ++i) {
+    Task* task = deques_[(first_victim + i) % num_deques_].Steal();
+    if (task != nullptr) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+void WorkStealingThreadPool::AddTask(Thread* self, Task* task) {
+  size_t index = FindDeque(self);
+  if (index != num_deques_ && deques_[index].Push(task)) {
+    // Pairs with the fence in GetTask: either we see the parking worker, or it sees our task.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_parked_.load(std::memory_order_relaxed) != 0u) {
+      MutexLock mu(self, task_queue_lock_);
+      task_queue_condition_.Signal(self);
+    }
+    return;
+  }
+  MutexLock mu(self, task_queue_lock_);
+  shared_tasks_.push_back(task);
+  // If we have any waiters, signal one.
+  if (started_ && waiting_count_ != 0) {
+    task_queue_condition_.Signal(self);
+  }
+}
+
+Task* WorkStealingThreadPool::GetTask(Thread* self) {
+  size_t index = FindDeque(self);
+  if (index == num_deques_) {
+    index = ClaimDeque(self);
+  }
+  while (true) {
+    // A worker always runs the tasks it added itself, it is already one of the active workers.
+    Task* task = deques_[index].Pop();
+    if (task != nullptr) {
+      return task;
+    }
+    // Like `AbstractThreadPool::GetTask()`, do not take other tasks if we would exceed the
+    // maximum active workers. This is only a hint, it is checked again with the lock held.
+    // We cannot read the thread count without the lock, but it is at most `num_deques_`.
+    const size_t parked = num_parked_.load(std::memory_order_relaxed);
+    if (num_deques_ - parked <= active_workers_limit_.load(std::memory_order_relaxed)) {
+      task = StealTask(index + 1u);
+      if (task != nullptr) {
+        return task;
+      }
+    }
+    MutexLock mu(self, task_queue_lock_);
+    if (IsShuttingDown()) {
+      break;
+    }
+    // <= since self is considered an active worker.
+    const bool may_run = GetThreadCount() - waiting_count_ <= max_active_workers_;
+    if (may_run) {
+      task = TryGetTaskLocked();
+      if (task != nullptr) {
+        return task;
+      }
+    }
+    ++waiting_count_;
+    num_parked_.fetch_add(1u, std::memory_order_relaxed);
+    // Pairs with the fence in AddTask.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool has_outstanding_tasks = HasOutstandingTasks();
+    if (!may_run || !has_outstanding_tasks) {
+      if (waiting_count_ == GetThreadCount() && !has_outstanding_tasks) {
+        // We may be done, lets broadcast to the completion condition.
+        completion_condition_.Broadcast(self);
+      }
+      const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
+      task_queue_condition_.Wait(self);
+      if (kMeasureWaitTime) {
+        const uint64_t wait_end = NanoTime();
+        total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+      }
+    }
+    num_parked_.fetch_sub(1u, std::memory_order_relaxed);
+    --waiting_count_;
+  }
+  // We are shutting down. Release the deque for the workers of a later CreateThreads.
+  ReleaseDeque(index);
+  return nullptr;
+}
+
+void WorkStealingThreadPool::SetMaxActiveWorkers(size_t max_workers) {
+  AbstractThreadPool::SetMaxActiveWorkers(max_workers);
+  active_workers_limit_.store(max_workers, std::memory_order_relaxed);
+}
+
+Task* WorkStealingThreadPool::TryGetTaskLocked() {
+  if (!started_) {
+    return nullptr;
+  }
+  if (!shared_tasks_.empty()) {
+    Task* task = shared_tasks_.front();
+    shared_tasks_.pop_front();
+    return task;
+  }
+  return StealTask(0u);
+}
+
+bool WorkStealingThreadPool::HasOutstandingTasks() const {
+  if (!started_) {
+    return false;
+  }
+  if (!shared_tasks_.empty()) {
+    return true;
+  }
+  for (size_t i = 0; i != num_deques_; ++i) {
+    if (deques_[i].Size() != 0u) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t WorkStealingThreadPool::GetTaskCount(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  size_t count = shared_tasks_.size();
+  for (size_t i = 0; i != num_deques_; ++i) {
+    count += deques_[i].Size();
+  }
+  return count;
+}
+
+void WorkStealingThreadPool::RemoveAllTasks(Thread* self) {
+  // Like ThreadPool, we are responsible for calling Finalize on all the tasks.
+  while (true) {
+    Task* task = nullptr;
+    {
+      MutexLock mu(self, task_queue_lock_);
+      if (!shared_tasks_.empty()) {
+        task = shared_tasks_.front();
+        shared_tasks_.pop_front();
+      }
+    }
+    if (task == nullptr) {
+      task = StealTask(0u);
+    }
+    if (task == nullptr) {
+      return;
+    }
+    task->Finalize();
+  }
+}
+
 void AbstractThreadPool::SetPthreadPriority(int priority) {
   for (ThreadPoolWorker* worker : threads_) {
     worker->SetPthreadPriority(priority);
   }
 }
 
+void AbstractThreadPool::SetPthreadAffinity(const cpu_set_t& cpu_set) {
+  for (ThreadPoolWorker* worker : threads_) {
+    worker->SetPthreadAffinity(cpu_set);
+  }
+}
+
 void AbstractThreadPool::CheckPthreadPriority(int priority) {
 #if defined(ART_TARGET_ANDROID)
   for (ThreadPoolWorker* worker : threads_) {
@@ -17,8 +17,12 @@
 #ifndef ART_RUNTIME_THREAD_POOL_H_
 #define ART_RUNTIME_THREAD_POOL_H_
 
+#include <sched.h>
+
+#include <atomic>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include "barrier.h"
@@ -90,6 +94,9 @@ class ThreadPoolWorker {
   // Get the "nice" priority for this worker.
   int GetPthreadPriority();
 
+  // Restrict this worker to the CPUs in `cpu_set`.
+  void SetPthreadAffinity(const cpu_set_t& cpu_set);
+
   Thread* GetThread() const { return thread_; }
 
  protected:
@@ -154,11 +161,14 @@ class AbstractThreadPool {
 
   // Provides a way to bound the maximum number of worker threads, threads must be less the the
   // thread count of the thread pool.
-  void SetMaxActiveWorkers(size_t threads) REQUIRES(!task_queue_lock_);
+  virtual void SetMaxActiveWorkers(size_t threads) REQUIRES(!task_queue_lock_);
 
   // Set the "nice" priority for threads in the pool.
   void SetPthreadPriority(int priority);
 
+  // Restrict the threads in the pool to the CPUs in `cpu_set`.
+  void SetPthreadAffinity(const cpu_set_t& cpu_set);
+
   // CHECK that the "nice" priority of threads in the pool is the given
   // `priority`.
   void CheckPthreadPriority(int priority);
@@ -170,7 +180,7 @@ class AbstractThreadPool {
 
  protected:
   // get a task to run, blocks if there are no tasks left
-  Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Try to get a task, returning null if there is none available.
   Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
@@ -251,6 +261,108 @@ class EXPORT ThreadPool : public AbstractThreadPool {
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
+// A fixed-capacity work-stealing deque, after Chase and Lev, "Dynamic circular work-stealing
+// deque", with the memory orderings of Le et al., "Correct and efficient work-stealing for weak
+// memory models". Only the owner pushes and pops at the bottom, any thread may steal from the top.
+class WorkStealingDeque {
+ public:
+  static constexpr size_t kCapacity = 1024;
+
+  WorkStealingDeque() : top_(0), bottom_(0), buffer_() {}
+
+  // Owner only. Returns false if the deque is full.
+  bool Push(Task* task);
+
+  // Owner only. Returns null if the deque is empty.
+  Task* Pop();
+
+  // Returns null if the deque is empty or if we lost a race with another thief or the owner.
+  Task* Steal();
+
+  // Returns the number of tasks in the deque. Only exact when there are no concurrent updates.
+  size_t Size() const {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_t>(bottom - top) : 0u;
+  }
+
+ private:
+  std::atomic<int64_t> top_;
+  std::atomic<int64_t> bottom_;
+  std::atomic<Task*> buffer_[kCapacity];
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+// A thread pool where each worker keeps the tasks it adds in its own deque and idle workers
+// steal from the deques of the others, so that recursively spawned tasks do not contend on the
+// task queue lock. Tasks added by other threads, or that do not fit in a full deque, go to a
+// shared queue. Workers that find no task park on the task queue condition like ThreadPool
+// workers, and are only woken by workers adding tasks when some of them are parked.
+//
+// StopWorkers only applies to the shared queue and SetMaxActiveWorkers only applies to the shared
+// queue and to stealing: a worker still runs the tasks it added itself.
+class EXPORT WorkStealingThreadPool : public AbstractThreadPool {
+ public:
+  static WorkStealingThreadPool* Create(
+      const char* name,
+      size_t num_threads,
+      bool create_peers = false,
+      size_t worker_stack_size = ThreadPoolWorker::kDefaultStackSize) {
+    WorkStealingThreadPool* pool =
+        new WorkStealingThreadPool(name, num_threads, create_peers, worker_stack_size);
+    pool->CreateThreads();
+    return pool;
+  }
+
+  void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_) override;
+  size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_) override;
+  void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_) override;
+  void SetMaxActiveWorkers(size_t threads) REQUIRES(!task_queue_lock_) override;
+  ~WorkStealingThreadPool() override;
+
+ protected:
+  Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_) override;
+  Task* TryGetTaskLocked() REQUIRES(task_queue_lock_) override;
+
+  bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) override;
+
+  WorkStealingThreadPool(const char* name,
+                         size_t num_threads,
+                         bool create_peers,
+                         size_t worker_stack_size);
+
+ private:
+  // Returns the index of the deque owned by `self`, or `num_deques_` if `self` is not one of
+  // our workers. The index is kept in a thread local variable, `self` must be the current thread.
+  size_t FindDeque(Thread* self) const;
+
+  // Called by a worker to take ownership of a free deque. Returns its index.
+  size_t ClaimDeque(Thread* self);
+
+  // Called by a worker that shuts down to give up ownership of its deque.
+  void ReleaseDeque(size_t index);
+
+  // Try to steal a task from the deques, starting with the one at `first_victim`.
+  Task* StealTask(size_t first_victim);
+
+  // One deque per worker, claimed by workers when they first look for a task.
+  const size_t num_deques_;
+  std::unique_ptr<WorkStealingDeque[]> deques_;
+  std::unique_ptr<std::atomic<Thread*>[]> deque_owners_;
+
+  // Tasks added by threads that are not workers, or that did not fit in a deque.
+  std::deque<Task*> shared_tasks_ GUARDED_BY(task_queue_lock_);
+
+  // Number of workers waiting on `task_queue_condition_`, readable without the lock.
+  std::atomic<size_t> num_parked_;
+
+  // Copy of `max_active_workers_`, readable without the lock.
+  std::atomic<size_t> active_workers_limit_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_THREAD_POOL_H_
@@ -16,6 +16,7 @@
 
 #include "thread_pool.h"
 
+#include <atomic>
 #include <string>
 
 #include "base/atomic.h"
@@ -127,7 +128,7 @@ TEST_F(ThreadPoolTest, StopWait) {
 
 class TreeTask : public Task {
  public:
-  TreeTask(ThreadPool* const thread_pool, AtomicInteger* count, int depth)
+  TreeTask(AbstractThreadPool* const thread_pool, AtomicInteger* count, int depth)
       : thread_pool_(thread_pool),
         count_(count),
         depth_(depth) {}
@@ -146,7 +147,7 @@ class TreeTask : public Task {
   }
 
  private:
-  ThreadPool* const thread_pool_;
+  AbstractThreadPool* const thread_pool_;
   AtomicInteger* const count_;
   const int depth_;
 };
@@ -164,6 +165,195 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
 }
 
+TEST_F(ThreadPoolTest, WorkStealingCheckRun) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<WorkStealingThreadPool> thread_pool(
+      WorkStealingThreadPool::Create("Work stealing test thread pool", num_threads));
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool->AddTask(self, new CountTask(&count));
+  }
+  usleep(200);
+  // Check that no threads started prematurely.
+  EXPECT_EQ(0, count.load(std::memory_order_seq_cst));
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, false);
+  EXPECT_EQ(num_tasks, count.load(std::memory_order_seq_cst));
+  EXPECT_EQ(0u, thread_pool->GetTaskCount(self));
+}
+
+// Test that tasks added from within a task end up in the worker deques and get stolen.
+TEST_F(ThreadPoolTest, WorkStealingRecursiveTest) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<WorkStealingThreadPool> thread_pool(
+      WorkStealingThreadPool::Create("Work stealing test thread pool", num_threads));
+  AtomicInteger count(0);
+  // Deep enough for all the workers to steal subtrees.
+  static const int depth = 12;
+  thread_pool->AddTask(self, new TreeTask(thread_pool.get(), &count, depth));
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, false);
+  EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
+}
+
+// A task that records the thread that ran it.
+class RecordThreadTask : public Task {
+ public:
+  RecordThreadTask(std::atomic<Thread*>* thread, AtomicInteger* count)
+      : thread_(thread), count_(count) {}
+
+  void Run(Thread* self) override {
+    thread_->store(self, std::memory_order_relaxed);
+    ++*count_;
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  std::atomic<Thread*>* const thread_;
+  AtomicInteger* const count_;
+};
+
+// A task that adds tasks to its worker's deque and does not return before they have all run,
+// so that only other workers can run them.
+class StolenTasksParentTask : public Task {
+ public:
+  StolenTasksParentTask(WorkStealingThreadPool* thread_pool,
+                        std::atomic<Thread*>* parent_thread,
+                        std::atomic<bool>* may_add_tasks,
+                        std::atomic<Thread*>* child_threads,
+                        int32_t num_children,
+                        AtomicInteger* count)
+      : thread_pool_(thread_pool),
+        parent_thread_(parent_thread),
+        may_add_tasks_(may_add_tasks),
+        child_threads_(child_threads),
+        num_children_(num_children),
+        count_(count) {}
+
+  void Run(Thread* self) override {
+    parent_thread_->store(self, std::memory_order_release);
+    while (!may_add_tasks_->load(std::memory_order_acquire)) {
+      usleep(100);
+    }
+    for (int32_t i = 0; i < num_children_; ++i) {
+      thread_pool_->AddTask(self, new RecordThreadTask(&child_threads_[i], count_));
+    }
+    // Do not wait forever if the tasks are not stolen, the test checks the count.
+    for (size_t i = 0; i != 10000u && count_->load(std::memory_order_seq_cst) != num_children_;
+         ++i) {
+      usleep(1000);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  WorkStealingThreadPool* const thread_pool_;
+  std::atomic<Thread*>* const parent_thread_;
+  std::atomic<bool>* const may_add_tasks_;
+  std::atomic<Thread*>* const child_threads_;
+  const int32_t num_children_;
+  AtomicInteger* const count_;
+};
+
+// Test that tasks added by a worker go to its own deque and that other workers steal them.
+TEST_F(ThreadPoolTest, WorkStealingStealTest) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<WorkStealingThreadPool> thread_pool(
+      WorkStealingThreadPool::Create("Work stealing test thread pool", num_threads));
+  static const int32_t num_children = num_threads * 4;
+  std::atomic<Thread*> parent_thread(nullptr);
+  std::atomic<bool> may_add_tasks(false);
+  std::unique_ptr<std::atomic<Thread*>[]> child_threads(new std::atomic<Thread*>[num_children]);
+  for (int32_t i = 0; i < num_children; ++i) {
+    child_threads[i].store(nullptr, std::memory_order_relaxed);
+  }
+  AtomicInteger count(0);
+  thread_pool->AddTask(self,
+                       new StolenTasksParentTask(thread_pool.get(),
+                                                 &parent_thread,
+                                                 &may_add_tasks,
+                                                 child_threads.get(),
+                                                 num_children,
+                                                 &count));
+  thread_pool->StartWorkers(self);
+  while (parent_thread.load(std::memory_order_acquire) == nullptr) {
+    usleep(100);
+  }
+  // Stopped workers do not take tasks from the shared queue, so the children can only run if
+  // they are in the parent's deque and get stolen.
+  thread_pool->StopWorkers(self);
+  may_add_tasks.store(true, std::memory_order_release);
+  thread_pool->Wait(self, false, false);
+  ASSERT_EQ(num_children, count.load(std::memory_order_seq_cst));
+  for (int32_t i = 0; i < num_children; ++i) {
+    Thread* child_thread = child_threads[i].load(std::memory_order_relaxed);
+    EXPECT_NE(nullptr, child_thread);
+    EXPECT_NE(parent_thread.load(std::memory_order_relaxed), child_thread);
+  }
+  EXPECT_EQ(0u, thread_pool->GetTaskCount(self));
+}
+
+// A task that records the maximum number of such tasks running at the same time.
+class ConcurrencyTask : public Task {
+ public:
+  ConcurrencyTask(AbstractThreadPool* thread_pool,
+                  AtomicInteger* running,
+                  AtomicInteger* max_running,
+                  int32_t num_children)
+      : thread_pool_(thread_pool),
+        running_(running),
+        max_running_(max_running),
+        num_children_(num_children) {}
+
+  void Run(Thread* self) override {
+    int32_t running = running_->fetch_add(1, std::memory_order_seq_cst) + 1;
+    int32_t max_running = max_running_->load(std::memory_order_seq_cst);
+    while (running > max_running &&
+           !max_running_->compare_exchange_weak(max_running, running, std::memory_order_seq_cst)) {
+    }
+    for (int32_t i = 0; i < num_children_; ++i) {
+      thread_pool_->AddTask(self, new ConcurrencyTask(thread_pool_, running_, max_running_, 0));
+    }
+    // Simulate doing some work.
+    usleep(100);
+    running_->fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  AbstractThreadPool* const thread_pool_;
+  AtomicInteger* const running_;
+  AtomicInteger* const max_running_;
+  const int32_t num_children_;
+};
+
+// Test that workers neither steal nor take shared tasks beyond the maximum active workers.
+TEST_F(ThreadPoolTest, WorkStealingMaxActiveWorkers) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<WorkStealingThreadPool> thread_pool(
+      WorkStealingThreadPool::Create("Work stealing test thread pool", num_threads));
+  thread_pool->SetMaxActiveWorkers(1);
+  AtomicInteger running(0);
+  AtomicInteger max_running(0);
+  for (int32_t i = 0; i < num_threads; ++i) {
+    thread_pool->AddTask(self, new ConcurrencyTask(thread_pool.get(), &running, &max_running, 8));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, false, false);
+  EXPECT_EQ(1, max_running.load(std::memory_order_seq_cst));
+  EXPECT_EQ(0u, thread_pool->GetTaskCount(self));
+}
+
 class PeerTask : public Task {
  public:
   PeerTask() {}
@@ -22,6 +22,7 @@
 #include "android-base/macros.h"
 #include "android-base/stringprintf.h"
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/leb128.h"
@@ -97,7 +98,7 @@ TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
-std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
+std::atomic<std::vector<ArtMethod*>*> Trace::temp_stack_trace_(nullptr);
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
@@ -238,6 +239,23 @@ bool TraceWriter::HasMethodEncoding(ArtMethod* method) {
   return art_method_id_map_.find(method) != art_method_id_map_.end();
 }
 
+uint32_t TraceWriter::GetMethodIdForRecord(
+    ArtMethod* method,
+    const std::unordered_map<ArtMethod*, std::string>& method_infos,
+    /*inout*/ ArtMethod** last_method,
+    /*inout*/ uint32_t* last_method_id) {
+  if (method == *last_method) {
+    return *last_method_id;
+  }
+  auto [method_id, is_new_method] = GetMethodEncoding(method);
+  if (is_new_method && trace_output_mode_ == TraceOutputMode::kStreaming) {
+    RecordMethodInfo(method_infos.find(method)->second, method_id);
+  }
+  *last_method = method;
+  *last_method_id = method_id;
+  return method_id;
+}
+
 std::pair<uint32_t, bool> TraceWriter::GetMethodEncoding(ArtMethod* method) {
   auto it = art_method_id_map_.find(method);
   if (it != art_method_id_map_.end()) {
@@ -314,13 +332,13 @@ class TraceWriterTask final : public SelfDeletingTask {
 };
 
 std::vector<ArtMethod*>* Trace::AllocStackTrace() {
-  return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
-      new std::vector<ArtMethod*>();
+  std::vector<ArtMethod*>* stack_trace = temp_stack_trace_.exchange(nullptr);
+  return (stack_trace != nullptr) ? stack_trace : new std::vector<ArtMethod*>();
 }
 
 void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
   stack_trace->clear();
-  temp_stack_trace_.reset(stack_trace);
+  delete temp_stack_trace_.exchange(stack_trace);
 }
 
 void Trace::SetDefaultClockSource(TraceClockSource clock_source) {
@@ -440,6 +458,33 @@ static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_
   the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
 }
 
+// Checkpoint taking a sample of the stack of each thread. Runnable threads take their own
+// sample at their next suspend point, so that sampling does not stop all threads at once.
+class SampleCheckpoint final : public Closure {
+ public:
+  explicit SampleCheckpoint(Trace* trace) : barrier_(0), trace_(trace) {}
+
+  void Run(Thread* thread) override REQUIRES_SHARED(Locks::mutator_lock_) {
+    // Note thread and self may not be equal if thread was already suspended at
+    // the point of the request.
+    GetSample(thread, trace_);
+    barrier_.Pass(Thread::Current());
+  }
+
+  void WaitForThreadsToRunThroughCheckpoint(size_t threads_running_checkpoint) {
+    Thread* self = Thread::Current();
+    ScopedThreadStateChange tsc(self, ThreadState::kWaitingForCheckPointsToRun);
+    barrier_.Increment(self, threads_running_checkpoint);
+  }
+
+ private:
+  // The barrier to be passed through and for the requestor to wait upon.
+  Barrier barrier_;
+  Trace* const trace_;
+
+  DISALLOW_COPY_AND_ASSIGN(SampleCheckpoint);
+};
+
 static void ClearThreadStackTraceAndClockBase(Thread* thread, [[maybe_unused]] void* arg) {
   thread->SetTraceClockBase(0);
   std::vector<ArtMethod*>* stack_trace = thread->GetStackTraceSample();
@@ -449,7 +494,8 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, [[maybe_unused]] v
 
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  // The sample is taken by the thread itself or, if it is suspended, by the sampling thread.
+  DCHECK(thread == Thread::Current() || thread->IsSuspended());
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -511,9 +557,15 @@ void* Trace::RunSamplingThread(void* arg) {
       gc::ScopedGCCriticalSection gcs(self,
                                       art::gc::kGcCauseInstrumentation,
                                       art::gc::kCollectorTypeInstrumentation);
-      ScopedSuspendAll ssa(__FUNCTION__);
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(GetSample, the_trace);
+      SampleCheckpoint checkpoint(the_trace);
+      size_t threads_running_checkpoint;
+      {
+        ScopedObjectAccess soa(self);
+        threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+      }
+      if (threads_running_checkpoint != 0) {
+        checkpoint.WaitForThreadsToRunThroughCheckpoint(threads_running_checkpoint);
+      }
     }
   }
 
@@ -1240,10 +1292,16 @@ void TraceWriter::PreProcessTraceForMethodInfos(
   MutexLock mu(Thread::Current(), tracing_lock_);
   size_t num_entries = GetNumEntries(clock_source_);
   DCHECK_EQ((kPerThreadBufSize - current_offset) % num_entries, 0u);
+  ArtMethod* last_method = nullptr;
   for (size_t entry_index = kPerThreadBufSize; entry_index != current_offset;) {
     entry_index -= num_entries;
     uintptr_t method_and_action = method_trace_entries[entry_index];
     ArtMethod* method = reinterpret_cast<ArtMethod*>(method_and_action & kMaskTraceAction);
+    // Consecutive records are often the entry and exit events of the same method.
+    if (method == last_method) {
+      continue;
+    }
+    last_method = method;
     if (!HasMethodEncoding(method) && method_infos.find(method) == method_infos.end()) {
       method_infos.emplace(method, GetMethodInfoLine(method));
     }
@@ -1439,6 +1497,8 @@ void TraceWriter::FlushEntriesFormatV1(
   size_t buffer_index = *current_index;
   size_t num_entries = GetNumEntries(clock_source_);
   const size_t record_size = GetRecordSize(clock_source_, trace_format_version_);
+  ArtMethod* last_method = nullptr;
+  uint32_t last_method_id = 0u;
 
   for (size_t entry_index = kPerThreadBufSize; entry_index != end_offset;) {
     entry_index -= num_entries;
@@ -1447,10 +1507,8 @@ void TraceWriter::FlushEntriesFormatV1(
     ReadValuesFromRecord(
         method_trace_entries, entry_index, record, has_thread_cpu_clock, has_wall_clock);
 
-    auto [method_id, is_new_method] = GetMethodEncoding(record.method);
-    if (is_new_method && trace_output_mode_ == TraceOutputMode::kStreaming) {
-      RecordMethodInfo(method_infos.find(record.method)->second, method_id);
-    }
+    uint32_t method_id =
+        GetMethodIdForRecord(record.method, method_infos, &last_method, &last_method_id);
 
     DCHECK_LT(buffer_index + record_size, buffer_size_);
     EncodeEventEntry(buffer_ptr + buffer_index,
@@ -1481,6 +1539,8 @@ void TraceWriter::FlushEntriesFormatV2(
   uint8_t* current_buffer_ptr = init_buffer_ptr;
   uint32_t header_size = (clock_source_ == TraceClockSource::kDual) ? kEntryHeaderSizeDualClockV2 :
                                                                       kEntryHeaderSizeSingleClockV2;
+  ArtMethod* last_method = nullptr;
+  uint32_t last_method_id = 0u;
 
   size_t entry_index = kPerThreadBufSize;
   for (size_t i = 0; i < num_records; i++) {
@@ -1494,10 +1554,8 @@ void TraceWriter::FlushEntriesFormatV2(
     // On 64-bit this means method ids would use 8 bytes but that is okay since we only encode the
     // full method id in the header and then encode the diff against the method id in the header.
     // The diff is usually expected to be small.
-    auto [method_id, is_new_method] = GetMethodEncoding(record.method);
-    if (is_new_method && trace_output_mode_ == TraceOutputMode::kStreaming) {
-      RecordMethodInfo(method_infos.find(record.method)->second, method_id);
-    }
+    uint32_t method_id =
+        GetMethodIdForRecord(record.method, method_infos, &last_method, &last_method_id);
     DCHECK(method_id < (1 << (31 - TraceActionBits)));
     uint32_t method_action_encoding = (method_id << TraceActionBits) | record.action;
 
@@ -1597,8 +1655,8 @@ void Trace::LogMethodTraceEvent(Thread* thread,
                                 uint32_t thread_clock_diff,
                                 uint64_t timestamp_counter) {
   // This method is called in both tracing modes (method and sampling). In sampling mode, this
-  // method is only called by the sampling thread. In method tracing mode, it can be called
-  // concurrently.
+  // method is called for each thread by the thread itself, or by the sampling thread while the
+  // thread is suspended. In both modes, it can be called concurrently for different threads.
 
   // In non-streaming modes, we stop recoding events once the buffer is full.
   if (trace_writer_->HasOverflow()) {
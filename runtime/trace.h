@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_TRACE_H_
 #define ART_RUNTIME_TRACE_H_
 
+#include <atomic>
 #include <bitset>
 #include <map>
 #include <memory>
@@ -238,6 +239,15 @@ class TraceWriter {
   std::pair<uint32_t, bool> GetMethodEncoding(ArtMethod* method) REQUIRES(tracing_lock_);
   bool HasMethodEncoding(ArtMethod* method) REQUIRES(tracing_lock_);
 
+  // Get the id of the method of a record being flushed, recording the method information of new
+  // methods in streaming mode. The `last_method` and `last_method_id` remember the previous
+  // record of the buffer, which is often for the same method as entry and exit events come in
+  // pairs, so that most records do not need a lookup in `art_method_id_map_`.
+  uint32_t GetMethodIdForRecord(ArtMethod* method,
+                                const std::unordered_map<ArtMethod*, std::string>& method_infos,
+                                /*inout*/ ArtMethod** last_method,
+                                /*inout*/ uint32_t* last_method_id) REQUIRES(tracing_lock_);
+
   // Get a 16-bit id for the thread. We don't want to use thread ids directly since they can be
   // more than 16-bit.
   uint16_t GetThreadEncoding(pid_t thread_id) REQUIRES(tracing_lock_);
@@ -507,8 +517,9 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
+  // Used to remember an unused stack trace to avoid re-allocation during sampling. Samples are
+  // taken concurrently by the threads running the sampling checkpoint.
+  static std::atomic<std::vector<ArtMethod*>*> temp_stack_trace_;
 
   // Flags enabling extra tracing of things such as alloc counts.
   const int flags_;
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_TYPE_CHECK_CACHE_H_
+#define ART_RUNTIME_TYPE_CHECK_CACHE_H_
+
+#include <array>
+
+#include "base/bit_utils.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+// Small thread-local cache of successful interface checks, that is pairs of a class and
+// an interface that it implements. It is used by `mirror::Class::Implements()` for classes
+// with many interfaces, where the linear scan of the `IfTable` is slow. Compiled code scans
+// the `IfTable` inline and uses the cache through the runtime calls of its slow paths.
+//
+// The cache holds raw class pointers, which may be stale after a garbage collection moved
+// or unloaded the classes. Therefore the collectors empty the cache in a pause, before they
+// move or free any class, see `Thread::SweepInterpreterCache()` and
+// `ThreadList::ClearTypeCheckCaches()`. Other operations must be done from the owning thread.
+class TypeCheckCache {
+ public:
+  static constexpr size_t kSize = 32;
+
+  TypeCheckCache() {
+    entries_.fill(Entry{});
+  }
+
+  // Returns whether the cache holds the pair of `klass` and `interface`.
+  ALWAYS_INLINE bool Contains(mirror::Class* klass, mirror::Class* interface) const {
+    const Entry& entry = entries_[IndexOf(klass, interface)];
+    return entry.klass == klass && entry.interface == interface;
+  }
+
+  // Record that `klass` implements `interface`.
+  ALWAYS_INLINE void Add(mirror::Class* klass, mirror::Class* interface) {
+    entries_[IndexOf(klass, interface)] = Entry{klass, interface};
+  }
+
+  // Empty the cache. Called by the GC, with the owning thread suspended or running a
+  // checkpoint. Since the entries are indexed by address, moved classes cannot be updated.
+  void Clear() {
+    entries_.fill(Entry{});
+  }
+
+ private:
+  struct Entry {
+    mirror::Class* klass = nullptr;
+    mirror::Class* interface = nullptr;
+  };
+
+  static ALWAYS_INLINE size_t IndexOf(mirror::Class* klass, mirror::Class* interface) {
+    static_assert(IsPowerOfTwo(kSize));
+    // Classes are at least 8-byte aligned, ignore the low bits.
+    uintptr_t key = (reinterpret_cast<uintptr_t>(klass) ^
+                     (reinterpret_cast<uintptr_t>(interface) >> WhichPowerOf2(kSize))) >> 3;
+    return key & (kSize - 1u);
+  }
+
+  std::array<Entry, kSize> entries_;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_TYPE_CHECK_CACHE_H_
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "type_check_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace art HIDDEN {
+
+class TypeCheckCacheTest : public testing::Test {};
+
+TEST_F(TypeCheckCacheTest, AddAndClear) {
+  // The cache only compares the pointers, so these do not need to be real classes.
+  alignas(8) static uint8_t storage[4u * 8u];
+  mirror::Class* klass1 = reinterpret_cast<mirror::Class*>(&storage[0]);
+  mirror::Class* klass2 = reinterpret_cast<mirror::Class*>(&storage[8]);
+  mirror::Class* interface1 = reinterpret_cast<mirror::Class*>(&storage[16]);
+  mirror::Class* interface2 = reinterpret_cast<mirror::Class*>(&storage[24]);
+
+  TypeCheckCache cache;
+  EXPECT_FALSE(cache.Contains(klass1, interface1));
+  cache.Add(klass1, interface1);
+  EXPECT_TRUE(cache.Contains(klass1, interface1));
+  EXPECT_FALSE(cache.Contains(klass1, interface2));
+  EXPECT_FALSE(cache.Contains(klass2, interface1));
+  cache.Add(klass2, interface2);
+  EXPECT_TRUE(cache.Contains(klass2, interface2));
+
+  // The GC empties the cache.
+  cache.Clear();
+  EXPECT_FALSE(cache.Contains(klass1, interface1));
+  EXPECT_FALSE(cache.Contains(klass2, interface2));
+}
+
+}  // namespace art
@@ -19,10 +19,14 @@
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 
+#include <optional>
+
 #include "art_method-inl.h"
+#include "base/arena_allocator.h"
 #include "base/enums.h"
 #include "base/locks.h"
 #include "base/logging.h"
+#include "base/scoped_arena_allocator.h"
 #include "base/systrace.h"
 #include "base/utils.h"
 #include "class_linker.h"
@@ -51,6 +55,49 @@ using android::base::StringPrintf;
 // sure we only print this once.
 static bool gPrintedDxMonitorText = false;
 
+// A `RegTypeCache` shared by the methods of a class, so that the primitive and constant types,
+// and the types most methods of a class refer to like the class itself, are only created once.
+// Lookups in the cache are linear, so it is started anew when it grows too large.
+class ClassRegTypeCache {
+ public:
+  ClassRegTypeCache(Thread* self, ClassLinker* class_linker, ArenaPool* arena_pool)
+      : self_(self), class_linker_(class_linker), arena_stack_(arena_pool) {}
+
+  RegTypeCache* Get() REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (storage_.has_value() && storage_->reg_types.GetCacheSize() > kMaxSharedEntries) {
+      storage_.reset();
+    }
+    if (!storage_.has_value()) {
+      storage_.emplace(self_, class_linker_, &arena_stack_);
+    }
+    return &storage_->reg_types;
+  }
+
+ private:
+  static constexpr size_t kMaxSharedEntries = 1024u;
+
+  struct Storage {
+    Storage(Thread* self, ClassLinker* class_linker, ArenaStack* arena_stack)
+        REQUIRES_SHARED(Locks::mutator_lock_)
+        : handles(self),
+          allocator(arena_stack),
+          reg_types(class_linker,
+                    /* can_load_classes= */ true,
+                    allocator,
+                    handles,
+                    /* can_suspend= */ true) {}
+
+    VariableSizedHandleScope handles;
+    ScopedArenaAllocator allocator;
+    RegTypeCache reg_types;
+  };
+
+  Thread* const self_;
+  ClassLinker* const class_linker_;
+  ArenaStack arena_stack_;
+  std::optional<Storage> storage_;
+};
+
 static void UpdateMethodFlags(uint32_t method_index,
                               Handle<mirror::Class> klass,
                               Handle<mirror::DexCache> dex_cache,
@@ -110,6 +157,7 @@ FailureKind ClassVerifier::VerifyClass(Thread* self,
   int64_t previous_method_idx[2] = { -1, -1 };
   MethodVerifier::FailureData failure_data;
   ClassLinker* const linker = Runtime::Current()->GetClassLinker();
+  ClassRegTypeCache class_reg_types(self, linker, Runtime::Current()->GetArenaPool());
 
   for (const ClassAccessor::Method& method : accessor.GetMethods()) {
     int64_t* previous_idx = &previous_method_idx[method.IsStaticOrDirect() ? 0u : 1u];
@@ -137,6 +185,7 @@ FailureKind ClassVerifier::VerifyClass(Thread* self,
                                      log_level,
                                      api_level,
                                      Runtime::Current()->IsAotCompiler(),
+                                     class_reg_types.Get(),
                                      &hard_failure_msg);
     if (result.kind == FailureKind::kHardFailure) {
       if (failure_data.kind == FailureKind::kHardFailure) {
@@ -151,7 +151,8 @@ class MethodVerifier final : public ::art::verifier::MethodVerifier {
                  const dex::ClassDef& class_def,
                  uint32_t access_flags,
                  bool verify_to_dump,
-                 uint32_t api_level) REQUIRES_SHARED(Locks::mutator_lock_)
+                 uint32_t api_level,
+                 RegTypeCache* shared_reg_types = nullptr) REQUIRES_SHARED(Locks::mutator_lock_)
      : art::verifier::MethodVerifier(self,
                                      class_linker,
                                      arena_pool,
@@ -162,7 +163,8 @@ class MethodVerifier final : public ::art::verifier::MethodVerifier {
                                      method_idx,
                                      can_load_classes,
                                      allow_thread_suspension,
-                                     aot_mode),
+                                     aot_mode,
+                                     shared_reg_types),
        method_access_flags_(access_flags),
        return_type_(nullptr),
        dex_cache_(dex_cache),
@@ -4953,12 +4955,19 @@ MethodVerifier::MethodVerifier(Thread* self,
                                uint32_t dex_method_idx,
                                bool can_load_classes,
                                bool allow_thread_suspension,
-                               bool aot_mode)
+                               bool aot_mode,
+                               RegTypeCache* shared_reg_types)
     : self_(self),
       handles_(self),
       arena_stack_(arena_pool),
       allocator_(&arena_stack_),
-      reg_types_(class_linker, can_load_classes, allocator_, handles_, allow_thread_suspension),
+      reg_types_(shared_reg_types != nullptr
+                     ? *shared_reg_types
+                     : owned_reg_types_.emplace(class_linker,
+                                                can_load_classes,
+                                                allocator_,
+                                                handles_,
+                                                allow_thread_suspension)),
       reg_table_(allocator_),
       work_insn_idx_(dex::kDexNoIndex),
       dex_method_idx_(dex_method_idx),
@@ -4992,6 +5001,7 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethod(Thread* self,
                                                          HardFailLogMode log_level,
                                                          uint32_t api_level,
                                                          bool aot_mode,
+                                                         RegTypeCache* shared_reg_types,
                                                          std::string* hard_failure_msg) {
   if (VLOG_IS_ON(verifier_debug)) {
     return VerifyMethod<true>(self,
@@ -5008,6 +5018,7 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethod(Thread* self,
                               log_level,
                               api_level,
                               aot_mode,
+                              shared_reg_types,
                               hard_failure_msg);
   } else {
     return VerifyMethod<false>(self,
@@ -5024,6 +5035,7 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethod(Thread* self,
                                log_level,
                                api_level,
                                aot_mode,
+                               shared_reg_types,
                                hard_failure_msg);
   }
 }
@@ -5060,6 +5072,7 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethod(Thread* self,
                                                          HardFailLogMode log_level,
                                                          uint32_t api_level,
                                                          bool aot_mode,
+                                                         RegTypeCache* shared_reg_types,
                                                          std::string* hard_failure_msg) {
   MethodVerifier::FailureData result;
   uint64_t start_ns = kTimeVerifyMethod ? NanoTime() : 0;
@@ -5079,7 +5092,8 @@ MethodVerifier::FailureData MethodVerifier::VerifyMethod(Thread* self,
                                                 class_def,
                                                 method_access_flags,
                                                 /* verify to dump */ false,
-                                                api_level);
+                                                api_level,
+                                                shared_reg_types);
   if (verifier.Verify()) {
     // Verification completed, however failures may be pending that didn't cause the verification
     // to hard fail.
@@ -18,6 +18,7 @@
 #define ART_RUNTIME_VERIFIER_METHOD_VERIFIER_H_
 
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <vector>
 
@@ -201,7 +202,8 @@ class MethodVerifier {
                  uint32_t dex_method_idx,
                  bool can_load_classes,
                  bool allow_thread_suspension,
-                 bool aot_mode)
+                 bool aot_mode,
+                 RegTypeCache* shared_reg_types = nullptr)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Verification result for method(s). Includes a (maximum) failure kind, and (the union of)
@@ -239,6 +241,7 @@ class MethodVerifier {
                                   HardFailLogMode log_level,
                                   uint32_t api_level,
                                   bool aot_mode,
+                                  RegTypeCache* shared_reg_types,
                                   std::string* hard_failure_msg)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -257,6 +260,7 @@ class MethodVerifier {
                                   HardFailLogMode log_level,
                                   uint32_t api_level,
                                   bool aot_mode,
+                                  RegTypeCache* shared_reg_types,
                                   std::string* hard_failure_msg)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -292,7 +296,10 @@ class MethodVerifier {
   ArenaStack arena_stack_;
   ScopedArenaAllocator allocator_;
 
-  RegTypeCache reg_types_;
+  // The cache of this verifier, unless `reg_types_` is shared with the other methods of the
+  // class.
+  std::optional<RegTypeCache> owned_reg_types_;
+  RegTypeCache& reg_types_;
 
   PcToRegisterLineTable reg_table_;
 
@@ -145,8 +145,13 @@ class RegisterLine {
   void CopyFromLine(const RegisterLine* src) {
     DCHECK_EQ(num_regs_, src->num_regs_);
     memcpy(&line_, &src->line_, num_regs_ * sizeof(uint16_t));
-    monitors_ = src->monitors_;
-    reg_to_lock_depths_ = src->reg_to_lock_depths_;
+    // Most methods hold no monitors; skip the container copies for them.
+    if (!monitors_.empty() || !src->monitors_.empty()) {
+      monitors_ = src->monitors_;
+    }
+    if (!reg_to_lock_depths_.empty() || !src->reg_to_lock_depths_.empty()) {
+      reg_to_lock_depths_ = src->reg_to_lock_depths_;
+    }
     this_initialized_ = src->this_initialized_;
   }
 
@@ -18,6 +18,7 @@
 
 #include <cstring>
 #include <sstream>
+#include <unordered_map>
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
@@ -27,6 +28,7 @@
 #include "compiler_callbacks.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/dex_file-inl.h"
+#include "handle_scope-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "oat/oat_file.h"
@@ -706,18 +708,30 @@ bool VerifierDeps::VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
                                        const std::vector<std::set<TypeAssignability>>& assignables,
                                        Thread* self,
                                        /* out */ std::string* error_msg) const {
-  StackHandleScope<2> hs(self);
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  MutableHandle<mirror::Class> source(hs.NewHandle<mirror::Class>(nullptr));
-  MutableHandle<mirror::Class> destination(hs.NewHandle<mirror::Class>(nullptr));
+  // Many classes of a dex file record the same tests, so look up each descriptor and
+  // check each pair of descriptors only once.
+  VariableSizedHandleScope hs(self);
+  std::unordered_map<uint32_t, Handle<mirror::Class>> classes;
+  auto find_class = [&](dex::StringIndex string_index) REQUIRES_SHARED(Locks::mutator_lock_) {
+    auto it = classes.find(string_index.index_);
+    if (it == classes.end()) {
+      const std::string& descriptor = GetStringFromId(dex_file, string_index);
+      Handle<mirror::Class> klass =
+          hs.NewHandle(FindClassAndClearException(class_linker, self, descriptor, class_loader));
+      it = classes.emplace(string_index.index_, klass).first;
+    }
+    return it->second;
+  };
+  std::set<TypeAssignability> checked;
 
   for (const auto& vec : assignables) {
     for (const auto& entry : vec) {
-      const std::string& destination_desc = GetStringFromId(dex_file, entry.GetDestination());
-      destination.Assign(
-          FindClassAndClearException(class_linker, self, destination_desc, class_loader));
-      const std::string& source_desc = GetStringFromId(dex_file, entry.GetSource());
-      source.Assign(FindClassAndClearException(class_linker, self, source_desc, class_loader));
+      if (!checked.insert(entry).second) {
+        continue;
+      }
+      Handle<mirror::Class> destination = find_class(entry.GetDestination());
+      Handle<mirror::Class> source = find_class(entry.GetSource());
 
       if (destination == nullptr || source == nullptr) {
         // We currently don't use assignability information for unresolved
@@ -728,7 +742,9 @@ bool VerifierDeps::VerifyAssignability(Handle<mirror::ClassLoader> class_loader,
 
       DCHECK(destination->IsResolved() && source->IsResolved());
       if (!destination->IsAssignableFrom(source.Get())) {
-        *error_msg = ART_FORMAT("Class {} not assignable from {}", destination_desc, source_desc);
+        *error_msg = ART_FORMAT("Class {} not assignable from {}",
+                                GetStringFromId(dex_file, entry.GetDestination()),
+                                GetStringFromId(dex_file, entry.GetSource()));
         return false;
       }
     }
@@ -164,6 +164,7 @@ ArtField* WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_data;
 ArtField* WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_length;
 ArtField* WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_offset;
 ArtField* WellKnownClasses::org_apache_harmony_dalvik_ddmc_Chunk_type;
+std::atomic<bool> WellKnownClasses::lazy_members_initialized_(false);
 
 ArtField* WellKnownClasses::java_lang_Byte_ByteCache_cache;
 ArtField* WellKnownClasses::java_lang_Character_CharacterCache_cache;
@@ -417,7 +418,7 @@ void WellKnownClasses::InitFieldsAndMethodsOnly(JNIEnv* env) {
   java_lang_Long_value = CacheValueInBoxField(
       class_linker, self, "Ljava/lang/Long;", "J");
 
-  StackHandleScope<44u> hs(self);
+  StackHandleScope<43u> hs(self);
   Handle<mirror::Class> d_s_bdcl =
       hs.NewHandle(FindSystemClass(class_linker, self, "Ldalvik/system/BaseDexClassLoader;"));
   Handle<mirror::Class> d_s_dlcl =
@@ -502,8 +503,6 @@ void WellKnownClasses::InitFieldsAndMethodsOnly(JNIEnv* env) {
       hs.NewHandle(FindSystemClass(class_linker, self, "Llibcore/reflect/AnnotationMember;"));
   Handle<mirror::Class> l_u_ea =
       hs.NewHandle(FindSystemClass(class_linker, self, "Llibcore/util/EmptyArray;"));
-  Handle<mirror::Class> o_a_h_d_c =
-      hs.NewHandle(FindSystemClass(class_linker, self, "Lorg/apache/harmony/dalvik/ddmc/Chunk;"));
   Handle<mirror::Class> o_a_h_d_d_ds =
       hs.NewHandle(FindSystemClass(class_linker, self, "Lorg/apache/harmony/dalvik/ddmc/DdmServer;"));
 
@@ -826,15 +825,23 @@ void WellKnownClasses::InitFieldsAndMethodsOnly(JNIEnv* env) {
 
   libcore_util_EmptyArray_STACK_TRACE_ELEMENT = CacheField(
       l_u_ea.Get(), /*is_static=*/ true, "STACK_TRACE_ELEMENT", "[Ljava/lang/StackTraceElement;");
+}
 
+void WellKnownClasses::InitLazyMembers() {
+  // Only the DDM support uses these, so there is no need to look them up at startup.
+  // Racing threads store the same values before publishing them.
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  ObjPtr<mirror::Class> o_a_h_d_c =
+      FindSystemClass(class_linker, Thread::Current(), "Lorg/apache/harmony/dalvik/ddmc/Chunk;");
   org_apache_harmony_dalvik_ddmc_Chunk_data =
-      CacheField(o_a_h_d_c.Get(), /*is_static=*/ false, "data", "[B");
+      CacheField(o_a_h_d_c, /*is_static=*/ false, "data", "[B");
   org_apache_harmony_dalvik_ddmc_Chunk_length =
-      CacheField(o_a_h_d_c.Get(), /*is_static=*/ false, "length", "I");
+      CacheField(o_a_h_d_c, /*is_static=*/ false, "length", "I");
   org_apache_harmony_dalvik_ddmc_Chunk_offset =
-      CacheField(o_a_h_d_c.Get(), /*is_static=*/ false, "offset", "I");
+      CacheField(o_a_h_d_c, /*is_static=*/ false, "offset", "I");
   org_apache_harmony_dalvik_ddmc_Chunk_type =
-      CacheField(o_a_h_d_c.Get(), /*is_static=*/ false, "type", "I");
+      CacheField(o_a_h_d_c, /*is_static=*/ false, "type", "I");
+  lazy_members_initialized_.store(true, std::memory_order_release);
 }
 
 void WellKnownClasses::LateInit(JNIEnv* env) {
@@ -985,6 +992,7 @@ void WellKnownClasses::Clear() {
   org_apache_harmony_dalvik_ddmc_Chunk_length = nullptr;
   org_apache_harmony_dalvik_ddmc_Chunk_offset = nullptr;
   org_apache_harmony_dalvik_ddmc_Chunk_type = nullptr;
+  lazy_members_initialized_.store(false, std::memory_order_relaxed);
 
   java_lang_Byte_ByteCache_cache = nullptr;
   java_lang_Character_CharacterCache_cache = nullptr;
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_WELL_KNOWN_CLASSES_H_
 #define ART_RUNTIME_WELL_KNOWN_CLASSES_H_
 
+#include <atomic>
+
 #include "base/locks.h"
 #include "base/macros.h"
 #include "jni.h"
@@ -81,8 +83,19 @@ struct EXPORT WellKnownClasses {
 
   static ObjPtr<mirror::Class> ToClass(jclass global_jclass) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Resolve the members that are not needed for startup. Must be called before using
+  // any member marked as lazily initialized below.
+  ALWAYS_INLINE static void EnsureLazyMembersInitialized() REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (UNLIKELY(!lazy_members_initialized_.load(std::memory_order_acquire))) {
+      InitLazyMembers();
+    }
+  }
+
  private:
   static void InitFieldsAndMethodsOnly(JNIEnv* env);
+  static void InitLazyMembers() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static std::atomic<bool> lazy_members_initialized_;
 
   template <ArtMethod** kMethod>
   using ClassFromMethod = detail::ClassFromMember<ArtMethod, kMethod>;
@@ -206,6 +219,7 @@ struct EXPORT WellKnownClasses {
   static ArtField* jdk_internal_math_FloatingDecimal_BinaryToASCIIBuffer_buffer;
   static ArtField* jdk_internal_math_FloatingDecimal_ExceptionalBinaryToASCIIBuffer_image;
   static ArtField* libcore_util_EmptyArray_STACK_TRACE_ELEMENT;
+  // Lazily initialized, see `EnsureLazyMembersInitialized()`.
   static ArtField* org_apache_harmony_dalvik_ddmc_Chunk_data;
   static ArtField* org_apache_harmony_dalvik_ddmc_Chunk_length;
   static ArtField* org_apache_harmony_dalvik_ddmc_Chunk_offset;
@@ -41,3 +41,11 @@ def run(ctx, args):
       Xcompiler_option=["--generate-mini-debug-info"],
       runtime_option=["-Xjitthreshold:0"],
       test_args=["--test-remote"])
+
+  # Test with minimal debugging information generated in batches. Methods compiled at first
+  # use get their debug info before they run.
+  ctx.default_run(
+      args,
+      Xcompiler_option=["--generate-mini-debug-info"],
+      runtime_option=["-Xjitthreshold:0", "-Xjitlazyminidebuginfo:true"],
+      test_args=["--test-remote"])
@@ -46,6 +46,11 @@ public class Main {
         $noinline$testStaticFieldSetsMultipleReceivers(new Object(), new Object(), new Object());
         $noinline$testArraySetsMultipleReceiversSameRTI();
 
+        // Several sets in different blocks, same receiver. The first write barrier dominates the
+        // other sets and there is no GC point in between.
+        $noinline$testInstanceFieldSetsAcrossBlocks(new Main(), new Object(), new Object(), true);
+        $noinline$testInstanceFieldSetsAcrossBlocks(new Main(), new Object(), new Object(), false);
+
         // The write barrier elimination optimization is blocked by invokes, suspend checks, and
         // instructions that can throw.
         $noinline$testInstanceFieldSetsBlocked(
@@ -209,6 +214,22 @@ public class Main {
         return array_of_arrays;
     }
 
+    /// CHECK-START: Main Main.$noinline$testInstanceFieldSetsAcrossBlocks(Main, java.lang.Object, java.lang.Object, boolean) disassembly (after)
+    /// CHECK: InstanceFieldSet field_name:Main.inner field_type:Reference write_barrier_kind:EmitBeingReliedOn
+    /// CHECK: ; card_table
+    /// CHECK-DAG: InstanceFieldSet field_name:Main.inner2 field_type:Reference write_barrier_kind:DontEmit
+    /// CHECK-DAG: InstanceFieldSet field_name:Main.inner3 field_type:Reference write_barrier_kind:DontEmit
+    private static Main $noinline$testInstanceFieldSetsAcrossBlocks(
+            Main m, Object o, Object o2, boolean cond) {
+        m.inner = o;
+        if (cond) {
+            m.inner2 = o2;
+        } else {
+            m.inner3 = o2;
+        }
+        return m;
+    }
+
     private static void $noinline$emptyMethod() {}
 
     /// CHECK-START: Main Main.$noinline$testInstanceFieldSetsBlocked(Main, java.lang.Object, java.lang.Object, java.lang.Object) disassembly (after)
@@ -0,0 +1,23 @@
+#
+# Copyright 2024 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+def run(ctx, args):
+  # Use --compiler-filter=verify so that the loop first runs in baseline JIT code, and
+  # -Xjitinitialsize:32M so that the test is not subject to code collection.
+  ctx.default_run(
+      args,
+      Xcompiler_option=["--compiler-filter=verify"],
+      runtime_option=["-Xjitinitialsize:32M"])
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+    public static void main(String[] args) {
+        System.loadLibrary(args[0]);
+        if (!hasJit()) {
+            System.out.println("passed");
+            return;
+        }
+        ensureJitBaselineCompiled(Main.class, "$noinline$loop");
+        // Run the baseline code, which installs the optimized code while the loop runs.
+        $noinline$loop(/* installOptimizedCode= */ true);
+        System.out.println("passed");
+    }
+
+    public static void $noinline$loop(boolean installOptimizedCode) {
+        if (installOptimizedCode) {
+            ensureJitCompiled(Main.class, "$noinline$loop");
+        }
+        // The baseline frame keeps running out of hotness in this loop. The JIT then compiles
+        // OSR code, and the next suspend check deoptimizes the frame so that the interpreter
+        // enters the OSR code with the values of the baseline frame.
+        long sum = 0;
+        Object marker = new Object();
+        Object local = marker;
+        int i = 0;
+        do {
+            sum += i;
+            ++i;
+        } while ((i & 0xffff) != 0 || !isInOsrCode("$noinline$loop"));
+        long expected = (long) i * (i - 1) / 2;
+        if (sum != expected) {
+            throw new Error("Expected " + expected + ", got " + sum + " after " + i);
+        }
+        if (local != marker) {
+            throw new Error("Lost a reference local");
+        }
+    }
+
+    private static native boolean hasJit();
+    private static native boolean isInOsrCode(String methodName);
+    private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+    private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
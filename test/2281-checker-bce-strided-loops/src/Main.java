@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START: int Main.$noinline$stridedSum(int[]) BCE (before)
+  /// CHECK-DAG: BoundsCheck
+  //
+  /// CHECK-START: int Main.$noinline$stridedSum(int[]) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  //
+  /// CHECK-START: int Main.$noinline$stridedSum(int[]) BCE (after)
+  /// CHECK-DAG: Deoptimize
+  private static int $noinline$stridedSum(int[] a) {
+    int result = 0;
+    // The loop control could step over a.length and wrap around if the array were close
+    // to Integer.MAX_VALUE in length, so this needs a finite-test deoptimization.
+    for (int i = 0; i < a.length; i += 2) {
+      result += a[i];
+    }
+    return result;
+  }
+
+  /// CHECK-START: void Main.$noinline$stridedMultiArray(int[], int[], int[]) BCE (before)
+  /// CHECK-DAG: BoundsCheck
+  /// CHECK-DAG: BoundsCheck
+  /// CHECK-DAG: BoundsCheck
+  //
+  /// CHECK-START: void Main.$noinline$stridedMultiArray(int[], int[], int[]) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  //
+  /// CHECK-START: void Main.$noinline$stridedMultiArray(int[], int[], int[]) BCE (after)
+  /// CHECK-DAG: Deoptimize
+  private static void $noinline$stridedMultiArray(int[] a, int[] b, int[] c) {
+    for (int i = 0; i < a.length; i += 3) {
+      a[i] = b[i] + c[i + 1];
+    }
+  }
+
+  // Only unit stride loops are vectorized, so this loop is checked for that separately.
+  //
+  /// CHECK-START: void Main.$noinline$add(int[], int[], int[]) BCE (before)
+  /// CHECK-DAG: BoundsCheck
+  /// CHECK-DAG: BoundsCheck
+  /// CHECK-DAG: BoundsCheck
+  //
+  /// CHECK-START: void Main.$noinline$add(int[], int[], int[]) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  //
+  /// CHECK-START: void Main.$noinline$add(int[], int[], int[]) BCE (after)
+  /// CHECK-DAG: Deoptimize
+  //
+  /// CHECK-START-ARM64: void Main.$noinline$add(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-DAG: VecLoad  loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: VecLoad  loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: VecAdd   loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: VecStore loop:<<Loop>>      outer_loop:none
+  private static void $noinline$add(int[] a, int[] b, int[] c) {
+    for (int i = 0; i < a.length; i++) {
+      a[i] = b[i] + c[i + 1];
+    }
+  }
+
+  private static int[] makeArray(int length) {
+    int[] array = new int[length];
+    for (int i = 0; i < length; i++) {
+      array[i] = i;
+    }
+    return array;
+  }
+
+  public static void main(String[] args) {
+    for (int length = 0; length < 100; length++) {
+      int expected = 0;
+      for (int i = 0; i < length; i += 2) {
+        expected += i;
+      }
+      expectEquals(expected, $noinline$stridedSum(makeArray(length)));
+
+      int[] a = new int[length];
+      $noinline$stridedMultiArray(a, makeArray(length), makeArray(length + 1));
+      for (int i = 0; i < length; i++) {
+        expectEquals(i % 3 == 0 ? 2 * i + 1 : 0, a[i]);
+      }
+
+      a = new int[length];
+      $noinline$add(a, makeArray(length), makeArray(length + 1));
+      for (int i = 0; i < length; i++) {
+        expectEquals(2 * i + 1, a[i]);
+      }
+    }
+
+    // Arrays that are too short deoptimize and still throw.
+    try {
+      $noinline$stridedMultiArray(new int[10], makeArray(10), makeArray(10));
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    try {
+      $noinline$add(new int[10], makeArray(9), makeArray(11));
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.VarHandle;
+import java.nio.ByteOrder;
+
+// Get-and-update operations used as expression statements have a call site returning void.
+// The arm64 compiler intrinsifies them without materializing the old value; other code
+// generators use the runtime call. Either way the update itself must be performed.
+public class Main {
+  private int intField;
+  private long longField;
+  private Object objectField;
+  private static int staticIntField;
+
+  private static final VarHandle INT_FIELD;
+  private static final VarHandle LONG_FIELD;
+  private static final VarHandle OBJECT_FIELD;
+  private static final VarHandle STATIC_INT_FIELD;
+  private static final VarHandle INT_ARRAY =
+      MethodHandles.arrayElementVarHandle(int[].class);
+  private static final VarHandle OBJECT_ARRAY =
+      MethodHandles.arrayElementVarHandle(Object[].class);
+  private static final VarHandle INT_VIEW =
+      MethodHandles.byteArrayViewVarHandle(int[].class, ByteOrder.nativeOrder());
+
+  static {
+    try {
+      MethodHandles.Lookup lookup = MethodHandles.lookup();
+      INT_FIELD = lookup.findVarHandle(Main.class, "intField", int.class);
+      LONG_FIELD = lookup.findVarHandle(Main.class, "longField", long.class);
+      OBJECT_FIELD = lookup.findVarHandle(Main.class, "objectField", Object.class);
+      STATIC_INT_FIELD = lookup.findStaticVarHandle(Main.class, "staticIntField", int.class);
+    } catch (ReflectiveOperationException e) {
+      throw new Error(e);
+    }
+  }
+
+  private static void $noinline$intFieldUpdates(Main m) {
+    INT_FIELD.getAndAdd(m, 3);
+    INT_FIELD.getAndAddAcquire(m, 4);
+    INT_FIELD.getAndAddRelease(m, 5);
+    INT_FIELD.getAndBitwiseOr(m, 0x100);
+    INT_FIELD.getAndBitwiseAnd(m, 0x10f);
+    INT_FIELD.getAndBitwiseXor(m, 0x3);
+  }
+
+  private static void $noinline$longFieldUpdates(Main m) {
+    LONG_FIELD.getAndAdd(m, 1L << 40);
+    LONG_FIELD.getAndBitwiseXor(m, 0xffL);
+    LONG_FIELD.getAndSetAcquire(m, (long) LONG_FIELD.getVolatile(m) + 1L);
+  }
+
+  private static void $noinline$objectFieldUpdate(Main m, Object value) {
+    OBJECT_FIELD.getAndSet(m, value);
+  }
+
+  private static void $noinline$staticIntFieldUpdate() {
+    STATIC_INT_FIELD.getAndAdd(1);
+  }
+
+  private static void $noinline$arrayUpdates(int[] ints, Object[] objects, Object value) {
+    INT_ARRAY.getAndAdd(ints, 1, 7);
+    INT_ARRAY.getAndSetRelease(ints, 2, 8);
+    OBJECT_ARRAY.getAndSet(objects, 0, value);
+  }
+
+  private static void $noinline$viewUpdate(byte[] bytes) {
+    INT_VIEW.getAndAdd(bytes, 4, 0x01020304);
+  }
+
+  public static void main(String[] args) {
+    Main m = new Main();
+    $noinline$intFieldUpdates(m);
+    assertEquals((((3 + 4 + 5) | 0x100) & 0x10f) ^ 0x3, m.intField);
+
+    $noinline$longFieldUpdates(m);
+    assertEquals(((1L << 40) ^ 0xffL) + 1L, m.longField);
+
+    for (int i = 0; i < 10000; ++i) {
+      $noinline$staticIntFieldUpdate();
+    }
+    assertEquals(10000, staticIntField);
+
+    // Make sure the GC sees references stored without reading back the old value.
+    $noinline$objectFieldUpdate(m, new String("field"));
+    int[] ints = new int[3];
+    Object[] objects = new Object[1];
+    $noinline$arrayUpdates(ints, objects, new String("element"));
+    Runtime.getRuntime().gc();
+    assertEquals("field", m.objectField);
+    assertEquals("element", objects[0]);
+    assertEquals(7, ints[1]);
+    assertEquals(8, ints[2]);
+
+    byte[] bytes = new byte[8];
+    $noinline$viewUpdate(bytes);
+    $noinline$viewUpdate(bytes);
+    assertEquals(2 * 0x01020304, (int) INT_VIEW.get(bytes, 4));
+    assertEquals(0, (int) INT_VIEW.get(bytes, 0));
+
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(long expected, long actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static void assertEquals(Object expected, Object actual) {
+    if (!expected.equals(actual)) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+
+#include "art_method-inl.h"
+#include "instrumentation.h"
+#include "jit/jit.h"
+#include "jni.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+#include "thread_list.h"
+
+namespace art {
+namespace EntryExitHooksForMethod {
+
+// Counts the entry / exit events of a single method.
+class CountingListener final : public instrumentation::InstrumentationListener {
+ public:
+  explicit CountingListener(ArtMethod* method) : method_(method) {}
+
+  using InstrumentationListener::FieldWritten;
+  using InstrumentationListener::MethodExited;
+
+  void MethodEntered([[maybe_unused]] Thread* thread, ArtMethod* method) override
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (method == method_) {
+      entries_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void MethodExited([[maybe_unused]] Thread* thread,
+                    ArtMethod* method,
+                    [[maybe_unused]] instrumentation::OptionalFrame frame,
+                    [[maybe_unused]] JValue& return_value) override
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (method == method_) {
+      exits_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void MethodUnwind([[maybe_unused]] Thread* thread,
+                    [[maybe_unused]] ArtMethod* method,
+                    [[maybe_unused]] uint32_t dex_pc) override {}
+
+  void DexPcMoved([[maybe_unused]] Thread* thread,
+                  [[maybe_unused]] Handle<mirror::Object> this_object,
+                  [[maybe_unused]] ArtMethod* method,
+                  [[maybe_unused]] uint32_t new_dex_pc) override {}
+
+  void FieldRead([[maybe_unused]] Thread* thread,
+                 [[maybe_unused]] Handle<mirror::Object> this_object,
+                 [[maybe_unused]] ArtMethod* method,
+                 [[maybe_unused]] uint32_t dex_pc,
+                 [[maybe_unused]] ArtField* field) override {}
+
+  void FieldWritten([[maybe_unused]] Thread* thread,
+                    [[maybe_unused]] Handle<mirror::Object> this_object,
+                    [[maybe_unused]] ArtMethod* method,
+                    [[maybe_unused]] uint32_t dex_pc,
+                    [[maybe_unused]] ArtField* field,
+                    [[maybe_unused]] const JValue& field_value) override {}
+
+  void ExceptionThrown([[maybe_unused]] Thread* thread,
+                       [[maybe_unused]] Handle<mirror::Throwable> exception_object) override {}
+
+  void ExceptionHandled([[maybe_unused]] Thread* thread,
+                        [[maybe_unused]] Handle<mirror::Throwable> exception_object) override {}
+
+  void Branch([[maybe_unused]] Thread* thread,
+              [[maybe_unused]] ArtMethod* method,
+              [[maybe_unused]] uint32_t dex_pc,
+              [[maybe_unused]] int32_t dex_pc_offset) override {}
+
+  void WatchedFramePop([[maybe_unused]] Thread* thread,
+                       [[maybe_unused]] const ShadowFrame& frame) override {}
+
+  ArtMethod* GetMethod() const { return method_; }
+  jint GetEntries() const { return entries_.load(std::memory_order_relaxed); }
+  jint GetExits() const { return exits_.load(std::memory_order_relaxed); }
+
+ private:
+  ArtMethod* const method_;
+  std::atomic<jint> entries_ = 0;
+  std::atomic<jint> exits_ = 0;
+};
+
+static CountingListener* gListener = nullptr;
+
+static constexpr uint32_t kEvents =
+    instrumentation::Instrumentation::kMethodEntered |
+    instrumentation::Instrumentation::kMethodExited;
+
+extern "C" JNIEXPORT void JNICALL Java_Main_startCounting(JNIEnv* env, jclass, jobject method) {
+  CHECK(gListener == nullptr);
+  ArtMethod* art_method;
+  {
+    ScopedObjectAccess soa(env);
+    art_method = ArtMethod::FromReflectedMethod(soa, method);
+  }
+  gListener = new CountingListener(art_method);
+  // Make sure that no JIT code that inlined the method is committed after invalidation.
+  jit::ScopedJitSuspend suspend_jit;
+  ScopedSuspendAll ssa(__FUNCTION__);
+  instrumentation::Instrumentation* instr = Runtime::Current()->GetInstrumentation();
+  instr->AddListener(gListener, kEvents);
+  instr->EnableEntryExitHooksForMethod(art_method);
+}
+
+extern "C" JNIEXPORT void JNICALL Java_Main_stopCounting(JNIEnv*, jclass) {
+  CHECK(gListener != nullptr);
+  ScopedSuspendAll ssa(__FUNCTION__);
+  instrumentation::Instrumentation* instr = Runtime::Current()->GetInstrumentation();
+  instr->DisableEntryExitHooksForMethod(gListener->GetMethod());
+  instr->RemoveListener(gListener, kEvents);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_getEntryCount(JNIEnv*, jclass) {
+  return gListener->GetEntries();
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_getExitCount(JNIEnv*, jclass) {
+  return gListener->GetExits();
+}
+
+}  // namespace EntryExitHooksForMethod
+}  // namespace art
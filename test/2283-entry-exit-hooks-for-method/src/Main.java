@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class Main {
+  static int value;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    Method selected = Main.class.getDeclaredMethod("$inline$selected", int.class);
+
+    // Compile a caller that inlines the method before its hooks are enabled. Enabling the
+    // hooks must invalidate that code.
+    ensureJitCompiled(Main.class, "callSelected");
+    startCounting(selected);
+    callSelected(10);
+    assertEquals(10, getEntryCount());
+    assertEquals(10, getExitCount());
+
+    // The JIT must neither inline the method nor compile it without the hooks.
+    ensureJitCompiled(Main.class, "callSelected");
+    ensureJitCompiled(Main.class, "$inline$selected");
+    callSelected(10);
+    assertEquals(20, getEntryCount());
+    assertEquals(20, getExitCount());
+
+    stopCounting();
+    callSelected(10);
+    assertEquals(20, getEntryCount());
+    assertEquals(20, getExitCount());
+    assertEquals(30 * 3, value);
+
+    System.out.println("passed");
+  }
+
+  public static void callSelected(int count) {
+    for (int i = 0; i < count; ++i) {
+      $inline$selected(3);
+    }
+  }
+
+  public static void $inline$selected(int increment) {
+    value += increment;
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native void startCounting(Method method);
+  private static native void stopCounting();
+  private static native int getEntryCount();
+  private static native int getExitCount();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.File;
+import java.io.FileDescriptor;
+import java.io.FileInputStream;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.lang.reflect.Method;
+import java.nio.charset.StandardCharsets;
+import java.util.zip.GZIPInputStream;
+
+public class Main {
+  private static final String HPROF_HEADER = "JAVA PROFILE 1.0.3";
+
+  public static void main(String[] args) throws Exception {
+    Class<?> vmDebug = Class.forName("dalvik.system.VMDebug");
+    Method dumpToFile = vmDebug.getMethod("dumpHprofData", String.class);
+    Method dumpToFd = vmDebug.getMethod("dumpHprofData", String.class, FileDescriptor.class);
+
+    // A dump named like a gzip file is compressed, whether the runtime opens the file...
+    File file = createTempFile(".hprof.gz");
+    try {
+      dumpToFile.invoke(null, file.getPath());
+      checkGzipDump(file);
+    } finally {
+      file.delete();
+    }
+
+    // ... or the caller passes a file descriptor.
+    file = createTempFile(".hprof.gz");
+    try {
+      try (FileOutputStream out = new FileOutputStream(file)) {
+        dumpToFd.invoke(null, file.getPath(), out.getFD());
+      }
+      checkGzipDump(file);
+    } finally {
+      file.delete();
+    }
+
+    // Other dumps are not compressed.
+    file = createTempFile(".hprof");
+    try {
+      dumpToFile.invoke(null, file.getPath());
+      try (InputStream in = new FileInputStream(file)) {
+        checkHeader(in);
+      }
+    } finally {
+      file.delete();
+    }
+
+    System.out.println("passed");
+  }
+
+  private static void checkGzipDump(File file) throws IOException {
+    long uncompressedLength = HPROF_HEADER.length() + 1;
+    try (InputStream in = new GZIPInputStream(new FileInputStream(file))) {
+      checkHeader(in);
+      // Read to the end so that the stream trailer and its CRC are checked too.
+      byte[] buffer = new byte[64 * 1024];
+      for (int count; (count = in.read(buffer)) != -1; ) {
+        uncompressedLength += count;
+      }
+    }
+    if (uncompressedLength <= file.length()) {
+      throw new Error("Dump of " + uncompressedLength + " bytes was not compressed: " +
+          file.length() + " bytes");
+    }
+  }
+
+  private static void checkHeader(InputStream in) throws IOException {
+    byte[] header = new byte[HPROF_HEADER.length() + 1];
+    for (int offset = 0; offset != header.length; ) {
+      int count = in.read(header, offset, header.length - offset);
+      if (count == -1) {
+        throw new Error("Truncated dump");
+      }
+      offset += count;
+    }
+    String actual = new String(header, 0, HPROF_HEADER.length(), StandardCharsets.US_ASCII);
+    if (!HPROF_HEADER.equals(actual) || header[HPROF_HEADER.length()] != 0) {
+      throw new Error("Unexpected dump header: " + actual);
+    }
+  }
+
+  private static File createTempFile(String suffix) throws IOException {
+    try {
+      return File.createTempFile("test-2284-hprof", suffix);
+    } catch (IOException e) {
+      System.setProperty("java.io.tmpdir", "/data/local/tmp");
+      try {
+        return File.createTempFile("test-2284-hprof", suffix);
+      } catch (IOException e2) {
+        System.setProperty("java.io.tmpdir", "/sdcard");
+        return File.createTempFile("test-2284-hprof", suffix);
+      }
+    }
+  }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (!hasJit()) {
+      // The background verification runs on the JIT thread pool.
+      System.out.println("passed");
+      return;
+    }
+
+    int verified = verifyClassesInBackground(Main.class);
+    // Loading `NotUsedYet` does not verify it, so it must have been verified above. Runtimes
+    // that allow JVMTI agents skip the verification, so that agents do not see class load
+    // events for classes that the app does not use.
+    Class<?> notUsedYet = Class.forName("NotUsedYet", false, Main.class.getClassLoader());
+    if (isDebuggable()) {
+      assertEquals(0, verified);
+      assertEquals(false, isVerified(notUsedYet));
+    } else {
+      if (verified == 0) {
+        throw new Error("Expected classes to be verified");
+      }
+      assertEquals(true, isVerified(notUsedYet));
+    }
+    // The app can use the class as usual.
+    assertEquals(42, NotUsedYet.value());
+
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(Object expected, Object actual) {
+    if (!expected.equals(actual)) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native boolean isDebuggable();
+  private static native int verifyClassesInBackground(Class<?> cls);
+  private static native boolean isVerified(Class<?> cls);
+}
+
+class NotUsedYet {
+  static int value() {
+    return 42;
+  }
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "dex/dex_file.h"
+#include "dex/dex_file_loader.h"
+#include "jit/jit.h"
+#include "jni.h"
+#include "mirror/class-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace VerifyClassesInBackground {
+
+// Verifies the classes of the dex file of `klass` the way the background task does, and
+// returns the number of classes verified.
+extern "C" JNIEXPORT jint JNICALL Java_Main_verifyClassesInBackground(JNIEnv* env,
+                                                                      jclass,
+                                                                      jclass klass) {
+  std::string code_path;
+  {
+    ScopedObjectAccess soa(env);
+    code_path = DexFileLoader::GetBaseLocation(
+        soa.Decode<mirror::Class>(klass)->GetDexFile().GetLocation());
+  }
+  std::vector<std::string> code_paths = { code_path };
+  return Runtime::Current()->GetJit()->VerifyClassesInBackground(
+      Thread::Current(), code_paths, /*profile_file=*/ "");
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isVerified(JNIEnv* env, jclass, jclass klass) {
+  ScopedObjectAccess soa(env);
+  return soa.Decode<mirror::Class>(klass)->IsVerified();
+}
+
+}  // namespace VerifyClassesInBackground
+}  // namespace art
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static int $inline$shiftAdd(int x, int y) {
+    return x + (y << 2);
+  }
+
+  /// CHECK-START: int Main.$noinline$loop(int, int) inliner (after)
+  /// CHECK-NOT: InvokeStaticOrDirect method_name:Main.$inline$shiftAdd
+
+  /// CHECK-START-ARM64: int Main.$noinline$loop(int, int) instruction_simplifier_arm64 (after)
+  /// CHECK:     DataProcWithShifterOp kind:Xor+LSR shift:3
+  static int $noinline$loop(int x, int a) {
+    for (int i = 0; i < 50; ++i) {
+      x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    }
+    return x;
+  }
+
+  // The reduced pipeline keeps the calls and skips the ARM64 passes, which include the
+  // shifter operand merging, GVN and instruction scheduling.
+
+  /// CHECK-START: int Main.$noinline$large(int, int) dead_code_elimination$before_codegen (after)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.$inline$shiftAdd
+
+  /// CHECK-START-ARM64: int Main.$noinline$large(int, int) disassembly (after)
+  /// CHECK-NOT: DataProcWithShifterOp
+  static int $noinline$large(int x, int a) {
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    x = $inline$shiftAdd(x, a) ^ (x >>> 3);
+    return x;
+  }
+
+  public static void main(String[] args) {
+    for (int x = -3; x <= 3; ++x) {
+      assertEquals($noinline$loop(x, 0x12345), $noinline$large(x, 0x12345));
+    }
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.nio.ByteBuffer;
+import java.util.Random;
+import java.util.zip.CRC32C;
+
+/**
+ * The ART compiler can use intrinsics for the java.util.zip.CRC32C methods:
+ *   private static int updateBytes(int crc, byte[] b, int off, int end)
+ *   private static int updateDirectByteBuffer(int crc, long address, int off, int end)
+ *
+ * As the methods are private it is not possible to check the use of intrinsics
+ * for them directly.
+ * The tests compare the checksums with a bitwise reference implementation, using
+ * offsets and lengths that exercise all the alignment cases of the byte loop.
+ */
+public class Main {
+  // The reflected Castagnoli polynomial.
+  private static final int POLY = 0x82F63B78;
+
+  private static long referenceCRC32C(byte[] bytes, int off, int len) {
+    int crc = ~0;
+    for (int i = off; i < off + len; ++i) {
+      crc ^= bytes[i] & 0xff;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc >>> 1) ^ (POLY & -(crc & 1));
+      }
+    }
+    return ~crc & 0xffffffffL;
+  }
+
+  private static long CRC32CBytes(byte[] bytes, int off, int len) {
+    CRC32C crc32c = new CRC32C();
+    crc32c.update(bytes, off, len);
+    return crc32c.getValue();
+  }
+
+  private static long CRC32CDirectByteBuffer(byte[] bytes, int off, int len) {
+    ByteBuffer buf = ByteBuffer.allocateDirect(bytes.length).put(bytes);
+    buf.position(off);
+    buf.limit(off + len);
+    CRC32C crc32c = new CRC32C();
+    crc32c.update(buf);
+    return crc32c.getValue();
+  }
+
+  // Checksums of a buffer split into two updates must match the checksum of the whole
+  // buffer, which checks that the intermediate CRC is kept in the right form.
+  private static long CRC32CSplit(byte[] bytes, int off, int len, int split) {
+    CRC32C crc32c = new CRC32C();
+    crc32c.update(bytes, off, split);
+    ByteBuffer buf = ByteBuffer.allocateDirect(len - split).put(bytes, off + split, len - split);
+    buf.rewind();
+    crc32c.update(buf);
+    return crc32c.getValue();
+  }
+
+  private static void TestKnownValues() {
+    byte[] digits = "123456789".getBytes();
+    assertEqual(0xE3069283L, referenceCRC32C(digits, 0, digits.length));
+    assertEqual(0xE3069283L, CRC32CBytes(digits, 0, digits.length));
+    assertEqual(0xE3069283L, CRC32CDirectByteBuffer(digits, 0, digits.length));
+    assertEqual(0L, CRC32CBytes(digits, 0, 0));
+    assertEqual(0L, CRC32CDirectByteBuffer(digits, 3, 0));
+    assertEqual(0x8A9136AAL, CRC32CBytes(new byte[32], 0, 32));
+  }
+
+  private static void TestRandomData() {
+    Random rnd = new Random(0);
+    byte[] bytes = new byte[1024 + 16];
+    rnd.nextBytes(bytes);
+    for (int off = 0; off < 16; ++off) {
+      for (int len = 0; len <= 64; ++len) {
+        long expected = referenceCRC32C(bytes, off, len);
+        assertEqual(expected, CRC32CBytes(bytes, off, len));
+        assertEqual(expected, CRC32CDirectByteBuffer(bytes, off, len));
+      }
+      long expected = referenceCRC32C(bytes, off, 1024);
+      assertEqual(expected, CRC32CBytes(bytes, off, 1024));
+      assertEqual(expected, CRC32CDirectByteBuffer(bytes, off, 1024));
+      for (int split = 0; split <= 1024; split += 97) {
+        assertEqual(expected, CRC32CSplit(bytes, off, 1024, split));
+      }
+    }
+  }
+
+  private static void TestInvalidArguments() {
+    CRC32C crc32c = new CRC32C();
+    try {
+      crc32c.update(new byte[4], 2, 3);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    assertEqual(0L, crc32c.getValue());
+  }
+
+  public static void main(String[] args) {
+    TestKnownValues();
+    TestRandomData();
+    TestInvalidArguments();
+    System.out.println("passed");
+  }
+
+  private static void assertEqual(long expected, long actual) {
+    if (expected != actual) {
+      throw new Error("Expected: " + Long.toHexString(expected) + ", found: "
+          + Long.toHexString(actual));
+    }
+  }
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.invoke.MethodHandle;
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.MethodType;
+import java.lang.invoke.WrongMethodTypeException;
+
+// The runtime converts the arguments of these call sites straight into the callee frame
+// instead of creating an asType() adapter. The results must not depend on which path is used.
+public class Main {
+  interface Shape {
+    double scale(long factor, double extra);
+  }
+
+  static class Square implements Shape {
+    final int side;
+
+    Square(int side) {
+      this.side = side;
+    }
+
+    public double scale(long factor, double extra) {
+      return side * factor + extra;
+    }
+
+    long area(long factor) {
+      return (long) side * side * factor;
+    }
+
+    private int $noinline$privateSide(long offset) {
+      return (int) (side + offset);
+    }
+
+    static MethodHandle findPrivateSide() throws Throwable {
+      return MethodHandles.lookup().findVirtual(
+          Square.class, "$noinline$privateSide", MethodType.methodType(int.class, long.class));
+    }
+  }
+
+  static class Base {
+    String name(Object suffix) {
+      return "Base" + suffix;
+    }
+  }
+
+  static class Derived extends Base {
+    String name(Object suffix) {
+      return "Derived" + suffix;
+    }
+
+    static MethodHandle findSuperName() throws Throwable {
+      return MethodHandles.lookup().findSpecial(
+          Base.class, "name", MethodType.methodType(String.class, Object.class), Derived.class);
+    }
+  }
+
+  static long mix(long a, int b, double c, long d, float e) {
+    return a * 1000000L + b * 10000L + (long) (c * 100.0) + d * 10L + (long) e;
+  }
+
+  static int length(CharSequence s) {
+    return s.length();
+  }
+
+  static int count;
+
+  static void increment(long by) {
+    count += by;
+  }
+
+  static int fail(long value) {
+    throw new IllegalStateException("value " + value);
+  }
+
+  private static void testStatic() throws Throwable {
+    MethodHandles.Lookup lookup = MethodHandles.lookup();
+    MethodHandle mix = lookup.findStatic(Main.class, "mix",
+        MethodType.methodType(long.class, long.class, int.class, double.class, long.class,
+                              float.class));
+    // byte -> long, char -> int, float -> double, int -> long, short -> float.
+    long result = (long) mix.invoke((byte) 1, 'a', 0.5f, 7, (short) 3);
+    assertEquals(1L * 1000000L + 'a' * 10000L + 50L + 70L + 3L, result);
+    // Same call site with the exact types for comparison.
+    assertEquals(result, (long) mix.invokeExact(1L, (int) 'a', 0.5, 7L, 3.0f));
+    // An int call site for the long parameters, with a wider return type.
+    for (int i = 0; i < 1000; ++i) {
+      double d = (double) mix.invoke(i, i, i, i, i);
+      assertEquals((long) i * 1000000L + i * 10000L + i * 100L + i * 10L + i, (long) d);
+    }
+
+    MethodHandle length = lookup.findStatic(Main.class, "length",
+        MethodType.methodType(int.class, CharSequence.class));
+    assertEquals(5L, (long) length.invoke("hello"));
+    assertEquals(3L, (int) length.invoke(new StringBuilder("abc")));
+    // Object is not assignable to CharSequence, so asType() casts and fails.
+    try {
+      int unused = (int) length.invoke(new Object());
+      throw new Error("Expected ClassCastException");
+    } catch (ClassCastException expected) {
+    }
+
+    MethodHandle increment = lookup.findStatic(Main.class, "increment",
+        MethodType.methodType(void.class, long.class));
+    count = 0;
+    for (int i = 0; i < 100; ++i) {
+      increment.invoke(i);
+    }
+    assertEquals(4950L, count);
+
+    MethodHandle fail = lookup.findStatic(Main.class, "fail",
+        MethodType.methodType(int.class, long.class));
+    try {
+      long unused = (long) fail.invoke(42);
+      throw new Error("Expected IllegalStateException");
+    } catch (IllegalStateException expected) {
+      assertEquals("value 42", expected.getMessage());
+    }
+    // Narrowing is not a widening conversion and must still be rejected.
+    try {
+      short unused = (short) fail.invoke(42);
+      throw new Error("Expected WrongMethodTypeException");
+    } catch (WrongMethodTypeException expected) {
+    }
+  }
+
+  private static void testInstance() throws Throwable {
+    MethodHandles.Lookup lookup = MethodHandles.lookup();
+    Square square = new Square(3);
+
+    MethodHandle scale = lookup.findVirtual(Shape.class, "scale",
+        MethodType.methodType(double.class, long.class, double.class));
+    assertEquals(3L * 4L + 1L, (long) (double) scale.invoke(square, 4, 1));
+    // A Square receiver for a Shape parameter and a float extra.
+    assertEquals(13.5, (double) scale.invoke(square, 4, 1.5f));
+
+    MethodHandle area = lookup.findVirtual(Square.class, "area",
+        MethodType.methodType(long.class, long.class));
+    assertEquals(18L, (long) area.invoke(square, 2));
+    assertEquals(18.0f, (float) area.invoke(square, (short) 2));
+    try {
+      long unused = (long) area.invoke((Square) null, 2);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+
+    MethodHandle privateSide = Square.findPrivateSide();
+    assertEquals(10L, (long) privateSide.invoke(square, 7));
+
+    MethodHandle superName = Derived.findSuperName();
+    assertEquals("Base!", (String) superName.invoke(new Derived(), "!"));
+    assertEquals("Base1", (Object) superName.invoke(new Derived(), (Integer) 1));
+
+    MethodHandle constructor = lookup.findConstructor(Square.class,
+        MethodType.methodType(void.class, int.class));
+    Shape shape = (Shape) constructor.invoke((byte) 5);
+    assertEquals(5.0, shape.scale(1, 0.0));
+  }
+
+  // Handles that are not direct method invocations keep using asType().
+  private static void testTransformers() throws Throwable {
+    MethodHandles.Lookup lookup = MethodHandles.lookup();
+    MethodHandle area = lookup.findVirtual(Square.class, "area",
+        MethodType.methodType(long.class, long.class));
+    MethodHandle bound = area.bindTo(new Square(2));
+    assertEquals(12L, (long) bound.invoke(3));
+    MethodHandle dropped = MethodHandles.dropArguments(bound, 0, float.class);
+    assertEquals(4.0, (double) dropped.invoke(1.0f, (byte) 1));
+  }
+
+  public static void main(String[] args) throws Throwable {
+    testStatic();
+    testInstance();
+    testTransformers();
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(long expected, long actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static void assertEquals(double expected, double actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static void assertEquals(Object expected, Object actual) {
+    if (!expected.equals(actual)) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Profiled to take two iterations on every call: peel them and keep the loop for longer
+  // executions.
+
+  /// CHECK-START-ARM64: int Main.$noinline$shortLoop(int, int) loop_optimization (before)
+  /// CHECK:     Mul loop:B{{\d+}}
+  /// CHECK-NOT: Mul
+
+  /// CHECK-START-ARM64: int Main.$noinline$shortLoop(int, int) loop_optimization (after)
+  /// CHECK-DAG: Mul loop:none
+  /// CHECK-DAG: Mul loop:none
+  /// CHECK-DAG: Mul loop:B{{\d+}}
+  static int $noinline$shortLoop(int n, int x) {
+    for (int i = 0; i < n; ++i) {
+      x = x * x + i;
+    }
+    return x;
+  }
+
+  // Profiled to take many iterations: unroll by two, keeping the loop check of the copy.
+
+  /// CHECK-START-ARM64: int Main.$noinline$longLoop(int, int) loop_optimization (before)
+  /// CHECK:     Mul loop:B{{\d+}}
+  /// CHECK-NOT: Mul
+
+  /// CHECK-START-ARM64: int Main.$noinline$longLoop(int, int) loop_optimization (after)
+  /// CHECK-DAG: Mul loop:<<Loop:B\d+>>
+  /// CHECK-DAG: Mul loop:<<Loop>>
+  /// CHECK-DAG: If  loop:<<Loop>>
+  /// CHECK-DAG: If  loop:<<Loop>>
+  /// CHECK-NOT: Mul loop:none
+  static int $noinline$longLoop(int n, int x) {
+    for (int i = 0; i < n; ++i) {
+      x = x * x + i;
+    }
+    return x;
+  }
+
+  private static int reference(int n, int x) {
+    for (int i = 0; i < n; ++i) {
+      x = x * x + i;
+    }
+    return x;
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+
+    ensureJitBaselineCompiled(Main.class, "$noinline$shortLoop");
+    for (int i = 0; i < 20; ++i) {
+      assertEquals(reference(2, i), $noinline$shortLoop(2, i));
+    }
+    ensureJitCompiled(Main.class, "$noinline$shortLoop");
+    for (int n = 0; n < 5; ++n) {
+      assertEquals(reference(n, 3), $noinline$shortLoop(n, 3));
+    }
+
+    ensureJitBaselineCompiled(Main.class, "$noinline$longLoop");
+    for (int i = 0; i < 20; ++i) {
+      assertEquals(reference(100, i), $noinline$longLoop(100, i));
+    }
+    ensureJitCompiled(Main.class, "$noinline$longLoop");
+    // Odd trip counts leave the loop from the check of the unrolled copy.
+    for (int n = 0; n < 5; ++n) {
+      assertEquals(reference(n, 3), $noinline$longLoop(n, 3));
+    }
+    assertEquals(reference(101, 3), $noinline$longLoop(101, 3));
+
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  public static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
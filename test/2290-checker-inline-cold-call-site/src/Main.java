@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Too big to be inlined at a cold call site, small enough to be inlined elsewhere.
+  static int mix(int x) {
+    x = x * 3 + 1;
+    x ^= x >>> 5;
+    x = x * 7 - 2;
+    x ^= x << 3;
+    return x + 11;
+  }
+
+  // The branch of `rare` is never taken while the baseline code collects the profile, so
+  // only the call site that always runs is inlined.
+
+  /// CHECK-START: int Main.$noinline$test(boolean, int) inliner (before)
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.mix
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.mix
+
+  /// CHECK-START: int Main.$noinline$test(boolean, int) inliner (after)
+  /// CHECK:     If
+  /// CHECK:     InvokeStaticOrDirect method_name:Main.mix
+  /// CHECK-NOT: InvokeStaticOrDirect
+  static int $noinline$test(boolean rare, int x) {
+    if (rare) {
+      x = mix(x);
+    }
+    return mix(x);
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+
+    ensureJitBaselineCompiled(Main.class, "$noinline$test");
+    for (int i = 0; i < 20; ++i) {
+      assertEquals(mix(i), $noinline$test(false, i));
+    }
+    ensureJitCompiled(Main.class, "$noinline$test");
+    assertEquals(mix(42), $noinline$test(false, 42));
+    assertEquals(mix(mix(42)), $noinline$test(true, 42));
+
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  public static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Hot methods keep the loop optimizations.
+
+  /// CHECK-START-ARM64: int Main.$noinline$hotSum(int[]) loop_optimization (after)
+  /// CHECK: VecLoad loop:B{{\d+}}
+  static int $noinline$hotSum(int[] array) {
+    int sum = 0;
+    for (int i = 0; i < array.length; ++i) {
+      sum += array[i];
+    }
+    return sum;
+  }
+
+  // Other methods are compiled for size and keep their scalar loop.
+
+  /// CHECK-START: int Main.$noinline$startupSum(int[]) dead_code_elimination$before_codegen (after)
+  /// CHECK:     ArrayGet loop:B{{\d+}}
+  /// CHECK-NOT: VecLoad
+  static int $noinline$startupSum(int[] array) {
+    int sum = 0;
+    for (int i = 0; i < array.length; ++i) {
+      sum += array[i];
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    int[] array = new int[100];
+    for (int i = 0; i < array.length; ++i) {
+      array[i] = i;
+    }
+    assertEquals(4950, $noinline$hotSum(array));
+    assertEquals(4950, $noinline$startupSum(array));
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
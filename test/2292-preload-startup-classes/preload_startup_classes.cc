@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "base/casts.h"
+#include "class_linker.h"
+#include "dex/dex_file.h"
+#include "dex/dex_file_loader.h"
+#include "jit/jit.h"
+#include "jni.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "nativehelper/ScopedUtfChars.h"
+#include "profile/profile_compilation_info.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace PreloadStartupClasses {
+
+// Writes an app profile to `profile_path` with the classes `class_descriptors` and the methods
+// of `startup_method_class` as startup methods, all from the dex file of `klass`. Preloads the
+// startup classes of that profile and returns the number of classes loaded.
+extern "C" JNIEXPORT jint JNICALL Java_Main_preloadStartupClasses(JNIEnv* env,
+                                                                  jclass,
+                                                                  jclass klass,
+                                                                  jobjectArray class_descriptors,
+                                                                  jstring startup_method_class,
+                                                                  jstring profile_path) {
+  ScopedUtfChars profile_chars(env, profile_path);
+  ScopedUtfChars method_class_chars(env, startup_method_class);
+  std::vector<std::string> descriptors;
+  for (jsize i = 0, size = env->GetArrayLength(class_descriptors); i != size; ++i) {
+    jobject descriptor = env->GetObjectArrayElement(class_descriptors, i);
+    descriptors.push_back(ScopedUtfChars(env, reinterpret_cast<jstring>(descriptor)).c_str());
+  }
+  std::string code_path;
+  {
+    ScopedObjectAccess soa(env);
+    const DexFile& dex_file = soa.Decode<mirror::Class>(klass)->GetDexFile();
+    code_path = DexFileLoader::GetBaseLocation(dex_file.GetLocation());
+    ProfileCompilationInfo info;
+    for (const std::string& descriptor : descriptors) {
+      CHECK(info.AddClass(dex_file, descriptor));
+    }
+    const dex::TypeId* type_id = dex_file.FindTypeId(method_class_chars.c_str());
+    CHECK(type_id != nullptr);
+    dex::TypeIndex type_index = dex_file.GetIndexForTypeId(*type_id);
+    std::vector<uint16_t> startup_methods;
+    for (uint32_t method_idx = 0; method_idx != dex_file.NumMethodIds(); ++method_idx) {
+      if (dex_file.GetMethodId(method_idx).class_idx_ == type_index) {
+        startup_methods.push_back(dchecked_integral_cast<uint16_t>(method_idx));
+      }
+    }
+    CHECK(!startup_methods.empty());
+    CHECK(info.AddMethodsForDex(ProfileCompilationInfo::MethodHotness::kFlagStartup,
+                                &dex_file,
+                                startup_methods.begin(),
+                                startup_methods.end()));
+    uint64_t bytes_written;
+    CHECK(info.Save(profile_chars.c_str(), &bytes_written));
+  }
+  std::vector<std::string> code_paths = { code_path };
+  return Runtime::Current()->GetJit()->PreloadStartupClassesFromAppProfile(
+      Thread::Current(), code_paths, profile_chars.c_str());
+}
+
+// Returns whether the class `descriptor` was loaded by the class loader of `klass`, without
+// loading it.
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isLoaded(JNIEnv* env,
+                                                         jclass,
+                                                         jclass klass,
+                                                         jstring descriptor) {
+  ScopedUtfChars descriptor_chars(env, descriptor);
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::ClassLoader> class_loader = soa.Decode<mirror::Class>(klass)->GetClassLoader();
+  return Runtime::Current()->GetClassLinker()->LookupClass(
+      soa.Self(), descriptor_chars.c_str(), class_loader) != nullptr;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isVerified(JNIEnv* env, jclass, jclass klass) {
+  ScopedObjectAccess soa(env);
+  return soa.Decode<mirror::Class>(klass)->IsVerified();
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isInitialized(JNIEnv* env, jclass, jclass klass) {
+  ScopedObjectAccess soa(env);
+  return soa.Decode<mirror::Class>(klass)->IsInitialized();
+}
+
+}  // namespace PreloadStartupClasses
+}  // namespace art
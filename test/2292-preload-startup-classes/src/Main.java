@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static boolean clinitRan = false;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (!hasJit()) {
+      // The startup classes are preloaded for the JIT.
+      System.out.println("passed");
+      return;
+    }
+
+    // The test classes are only used through reflection, so that verifying `Main` does not
+    // load them.
+    String[] descriptors = {
+        "LNoClinit;", "LNoClinitSub;", "LWithClinit;", "LWithClinitSub;" };
+    for (String descriptor : descriptors) {
+      assertEquals(false, isLoaded(Main.class, descriptor));
+    }
+    assertEquals(false, isLoaded(Main.class, "LStartupMethods;"));
+
+    String profile = System.getenv("DEX_LOCATION") + "/2292-preload-startup-classes.prof";
+    int loaded = preloadStartupClasses(Main.class, descriptors, "LStartupMethods;", profile);
+    // The declaring class of the startup methods is loaded with the classes of the profile.
+    assertEquals(descriptors.length + 1, loaded);
+    assertEquals(true, isLoaded(Main.class, "LStartupMethods;"));
+    assertEquals(false, isLoaded(Main.class, "LNotInProfile;"));
+
+    // Classes without a static initializer get initialized, after their superclass.
+    ClassLoader loader = Main.class.getClassLoader();
+    Class<?> noClinit = Class.forName("NoClinit", false, loader);
+    Class<?> noClinitSub = Class.forName("NoClinitSub", false, loader);
+    Class<?> startupMethods = Class.forName("StartupMethods", false, loader);
+    for (Class<?> cls : new Class<?>[] { noClinit, noClinitSub, startupMethods }) {
+      assertEquals(true, isVerified(cls));
+      assertEquals(true, isInitialized(cls));
+    }
+
+    // Running a static initializer early could change the behavior of the app, so classes
+    // that have one, or extend one that has one, are only verified.
+    Class<?> withClinit = Class.forName("WithClinit", false, loader);
+    Class<?> withClinitSub = Class.forName("WithClinitSub", false, loader);
+    for (Class<?> cls : new Class<?>[] { withClinit, withClinitSub }) {
+      assertEquals(true, isVerified(cls));
+      assertEquals(false, isInitialized(cls));
+    }
+    assertEquals(false, clinitRan);
+
+    // The app initializes them as usual when it first uses them.
+    Class.forName("WithClinitSub", true, loader);
+    assertEquals(true, isInitialized(withClinit));
+    assertEquals(true, clinitRan);
+
+    System.out.println("passed");
+  }
+
+  private static void assertEquals(Object expected, Object actual) {
+    if (!expected.equals(actual)) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native int preloadStartupClasses(
+      Class<?> cls, String[] classDescriptors, String startupMethodClass, String profile);
+  private static native boolean isLoaded(Class<?> cls, String descriptor);
+  private static native boolean isVerified(Class<?> cls);
+  private static native boolean isInitialized(Class<?> cls);
+}
+
+class NoClinit {
+  static int value() {
+    return 1;
+  }
+}
+
+class NoClinitSub extends NoClinit {
+  static int otherValue() {
+    return 2;
+  }
+}
+
+class WithClinit {
+  static {
+    Main.clinitRan = true;
+  }
+}
+
+class WithClinitSub extends WithClinit {
+}
+
+class StartupMethods {
+  static int run() {
+    return 3;
+  }
+}
+
+class NotInProfile {
+}
@@ -609,11 +609,14 @@ public class Main {
   /// CHECK: ArraySet
   /// CHECK: BoundsCheck
   /// CHECK: ArraySet
-  /// CHECK: BoundsCheck
+  /// CHECK-NOT: BoundsCheck
   /// CHECK: ArraySet
   /// CHECK-NOT: BoundsCheck
   /// CHECK: ArraySet
 
+  /// CHECK-START: void Main.loopPattern1(int[]) BCE (after)
+  /// CHECK: Deoptimize
+
   static void loopPattern1(int[] array) {
     for (int i = 0; i < array.length; i++) {
       array[i] = 1;  // Bounds check can be eliminated.
@@ -637,7 +640,8 @@ public class Main {
 
     for (int i = 0; i < array.length; i += 2) {
       // We don't have any assumption on max array length yet.
-      // Bounds check can't be eliminated due to overflow concern.
+      // Bounds check can only be eliminated dynamically, with a deoptimization
+      // on the array length being close enough to Integer.MAX_VALUE to overflow.
       array[i] = 1;
     }
 
@@ -258,13 +258,13 @@ public class Main {
   /// CHECK-DAG: BoundsCheck
   //
   /// CHECK-START: int Main.linearByTwoSkip2(int[]) BCE (after)
-  /// CHECK-DAG: BoundsCheck
+  /// CHECK-NOT: BoundsCheck
   //
   /// CHECK-START: int Main.linearByTwoSkip2(int[]) BCE (after)
-  /// CHECK-NOT: Deoptimize
+  /// CHECK-DAG: Deoptimize
   private static int linearByTwoSkip2(int x[]) {
     int result = 0;
-    // This case is not optimized.
+    // The bounds check is eliminated dynamically, with a finite-test deoptimization.
     for (int i = 0; i < x.length; i+=2) {
       result += x[i];
     }
@@ -4073,9 +4073,6 @@ public class Main {
 
   /// CHECK-START: int Main.$noinline$testPartialEscape1(TestClass, boolean) load_store_elimination (after)
   /// CHECK:         InstanceFieldSet
-  //
-  // TODO: We should be able to remove this setter by realizing `i` only escapes in a branch.
-  /// CHECK:         InstanceFieldSet
   /// CHECK-NOT:     InstanceFieldSet
   //
   /// CHECK-START: int Main.$noinline$testPartialEscape1(TestClass, boolean) load_store_elimination (after)
@@ -4098,6 +4095,36 @@ public class Main {
     return res;
   }
 
+  /// CHECK-START: int Main.$noinline$testPartialEscape2(TestClass, int) load_store_elimination (before)
+  /// CHECK:         NewInstance
+  /// CHECK-NOT:     NewInstance
+
+  /// CHECK-START: int Main.$noinline$testPartialEscape2(TestClass, int) load_store_elimination (after)
+  /// CHECK-DAG:     <<Obj:l\d+>>    ParameterValue
+  /// CHECK-DAG:     <<Value:i\d+>>  ParameterValue
+  /// CHECK-DAG:     <<Const1:i\d+>> IntConstant 1
+  /// CHECK-DAG:     <<New:l\d+>>    NewInstance
+  /// CHECK-DAG:                    InstanceFieldSet [<<New>>,<<Obj>>] field_name:TestClass.next
+  /// CHECK-DAG:                    InstanceFieldSet [<<New>>,<<Value>>] field_name:TestClass.j
+  /// CHECK-DAG:                    InvokeStaticOrDirect [<<New>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$Escape
+  /// CHECK-DAG:                    Add [<<Value>>,<<Const1>>]
+
+  /// CHECK-START: int Main.$noinline$testPartialEscape2(TestClass, int) load_store_elimination (after)
+  /// CHECK:         NewInstance
+  /// CHECK-NOT:     NewInstance
+  private static int $noinline$testPartialEscape2(TestClass obj, int value) {
+    // The allocation only escapes on the slow path, where it is created with the
+    // values stored so far. The fast path does not allocate.
+    TestClass i = new TestClass();
+    i.next = obj;
+    i.j = value;
+    if (value < 0) {
+      $noinline$Escape(i);
+      return i.j;
+    }
+    return i.j + 1;
+  }
+
   private static void $noinline$clobberObservables() {}
 
   static void assertLongEquals(long result, long expected) {
@@ -4507,5 +4534,10 @@ public class Main {
     assertLongEquals(testOverlapLoop(50), 7778742049l);
     assertIntEquals($noinline$testPartialEscape1(new TestClass(), true), 1);
     assertIntEquals($noinline$testPartialEscape1(new TestClass(), false), 0);
+    TestClass escapeTarget = new TestClass();
+    assertIntEquals($noinline$testPartialEscape2(escapeTarget, 5), 6);
+    assertIntEquals(escapeTarget.i, 0);
+    assertIntEquals($noinline$testPartialEscape2(escapeTarget, -5), -5);
+    assertIntEquals(escapeTarget.i, 1);
   }
 }
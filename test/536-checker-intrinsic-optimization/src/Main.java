@@ -124,6 +124,8 @@ public class Main {
       assertStringContains("Main.$opt$noinline$stringCharAt", sioob.getStackTrace()[1].toString());
     }
 
+    assertCharEquals('b', $opt$noinline$constStringCharAt());
+
     assertCharEquals('7', $opt$noinline$stringCharAtCatch("0123456789", 7));
     assertCharEquals('\0', $opt$noinline$stringCharAtCatch("0123456789", 10));
 
@@ -195,6 +197,23 @@ public class Main {
     return s.charAt(pos);
   }
 
+  /// CHECK-START: char Main.$opt$noinline$constStringCharAt() constant_folding (before)
+  /// CHECK-DAG:                    ArrayGet is_string_char_at:true
+
+  /// CHECK-START: char Main.$opt$noinline$constStringCharAt() constant_folding (after)
+  /// CHECK-DAG:  <<Char:i\d+>>     IntConstant 98
+  /// CHECK-DAG:                    Return [<<Char>>]
+
+  /// CHECK-START: char Main.$opt$noinline$constStringCharAt() constant_folding (after)
+  /// CHECK-NOT:                    ArrayGet
+
+  /// CHECK-START: char Main.$opt$noinline$constStringCharAt() BCE (after)
+  /// CHECK-NOT:                    BoundsCheck
+
+  static public char $opt$noinline$constStringCharAt() {
+    return "abc".charAt(1);
+  }
+
   /// CHECK-START: char Main.$opt$noinline$stringCharAtCatch(java.lang.String, int) builder (after)
   /// CHECK-DAG:  <<String:l\d+>>   ParameterValue
   /// CHECK-DAG:  <<Pos:i\d+>>      ParameterValue
@@ -216,6 +216,28 @@ public class Main {
     return merged.byteValue() & 0xff;
   }
 
+  /// CHECK-START: int Main.$noinline$boxedLoopSum(int) instruction_simplifier$after_inlining (before)
+  /// CHECK-DAG:                  InvokeStaticOrDirect method_name:java.lang.Integer.valueOf loop:<<Loop:B\d+>>
+  /// CHECK-DAG:                  InstanceFieldGet field_name:java.lang.Integer.value loop:<<Loop>>
+
+  /// CHECK-START: int Main.$noinline$boxedLoopSum(int) dead_code_elimination$after_inlining (after)
+  /// CHECK-DAG: <<Const0:i\d+>>   IntConstant 0
+  /// CHECK-DAG: <<Sum:i\d+>>      Phi [<<Const0>>,{{i\d+}}] loop:<<Loop:B\d+>>
+  /// CHECK-DAG: <<Add:i\d+>>      Add [<<Sum>>,{{i\d+}}] loop:<<Loop>>
+  /// CHECK-DAG:                  Phi [<<Const0>>,<<Add>>] loop:<<Loop>>
+
+  /// CHECK-START: int Main.$noinline$boxedLoopSum(int) dead_code_elimination$after_inlining (after)
+  /// CHECK-NOT:                  InvokeStaticOrDirect method_name:java.lang.Integer.valueOf
+  /// CHECK-NOT:                  InstanceFieldGet
+
+  public static int $noinline$boxedLoopSum(int n) {
+    Integer sum = 0;
+    for (int i = 0; i < n; ++i) {
+      sum += i;
+    }
+    return sum;
+  }
+
   public static boolean $inline$returnTrue() {
     return true;
   }
@@ -249,6 +271,9 @@ public class Main {
 
     assertEqual(42, $noinline$boxUnboxByteAsUint8((byte) 42));
     assertEqual(-42 & 0xff, $noinline$boxUnboxByteAsUint8((byte) -42));
+
+    assertEqual(0, $noinline$boxedLoopSum(0));
+    assertEqual(4950, $noinline$boxedLoopSum(100));
   }
 
   static void assertEqual(String a, Integer b) {
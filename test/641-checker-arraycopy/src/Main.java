@@ -47,12 +47,26 @@ public class Main {
     untypedCopy(o, array);
   }
 
+  /// CHECK-START-X86_64: void Main.longCopy(long[], long[]) disassembly (after)
+  /// CHECK: InvokeStaticOrDirect method_name:java.lang.System.arraycopy intrinsic:SystemArrayCopyLong
+  /// CHECK-NOT:    call
+  /// CHECK: ReturnVoid
+  public static void longCopy(long[] src, long[] dst) {
+    System.arraycopy((Object)src, 1, (Object)dst, 0, 2);
+  }
+
   public static void assertEquals(Object one, Object two) {
     if (one != two) {
       throw new Error("Expected " + one + ", got " + two);
     }
   }
 
+  public static void assertEquals(long expected, long actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
   public static void main(String[] args) {
     // Simple checks.
     byte[] a = new byte[2];
@@ -79,5 +93,11 @@ public class Main {
     assertEquals(o[1], o);
     assertEquals(a[0], (byte)2);
     assertEquals(a[1], (byte)2);
+
+    long[] src = { 1L, 2L, 0x123456789L };
+    long[] dst = new long[2];
+    longCopy(src, dst);
+    assertEquals(2L, dst[0]);
+    assertEquals(0x123456789L, dst[1]);
   }
 }
@@ -156,6 +156,19 @@ public class Main {
     }
   }
 
+  /// CHECK-START-{X86_64,ARM64}: void Main.$noinline$stencilTwoSourcesConstSize(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-DAG:                NotEqual                             loop:none
+  /// CHECK-DAG:                NotEqual                             loop:none
+  /// CHECK-DAG:                VecStore                             loop:{{B\d+}}    outer_loop:none
+  //
+  // Checks that several disambiguation runtime tests can guard the vector loop.
+  //
+  private static void $noinline$stencilTwoSourcesConstSize(int[] a, int[] b, int[] c) {
+    for (int i = 1; i < STENCIL_ARRAY_SIZE - 1; i++) {
+      a[i] = b[i - 1] + c[i + 1];
+    }
+  }
+
   /// CHECK-START: void Main.stencilAddInt(int[], int[], int) loop_optimization (before)
   /// CHECK-DAG: <<CP1:i\d+>>   IntConstant 1                        loop:none
   /// CHECK-DAG: <<CM1:i\d+>>   IntConstant -1                       loop:none
@@ -444,6 +457,29 @@ public class Main {
     }
   }
 
+  // Checks several disambiguation runtime tests for array references.
+  static void testStencilTwoSourcesConstSize() {
+    int[] a = new int[STENCIL_ARRAY_SIZE];
+    int[] b = new int[STENCIL_ARRAY_SIZE];
+    int[] c = new int[STENCIL_ARRAY_SIZE];
+    initArrayStencil(b);
+    initArrayStencil(c);
+
+    $noinline$stencilTwoSourcesConstSize(a, b, c);
+    for (int i = 1; i < STENCIL_ARRAY_SIZE - 1; i++) {
+      // (i - 1) + (i + 1) = 2 * i.
+      expectEquals(i + i, a[i]);
+    }
+
+    initArrayStencil(b);
+    $noinline$stencilTwoSourcesConstSize(b, b, c);
+    for (int i = 1; i < STENCIL_ARRAY_SIZE - 1; i++) {
+      // The formula of the ith member of recurrent def: b[i] = b[i-1] + (i + 1).
+      int e = i * (i + 3) / 2;
+      expectEquals(e, b[i]);
+    }
+  }
+
   static void testStencil2() {
     int[] a = new int[100];
     int[] b = new int[100];
@@ -489,6 +525,7 @@ public class Main {
     testUnroll();
     testStencil1();
     testStencilConstSize();
+    testStencilTwoSourcesConstSize();
     testStencil2();
     testStencil3();
     testTypes();
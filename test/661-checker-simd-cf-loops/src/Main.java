@@ -450,6 +450,81 @@ public class Main {
     }
   }
 
+  //
+  // Early exit loops.
+  //
+
+  /// CHECK-START-ARM64: int Main.$compile$noinline$SearchInt(int[], int, int) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("sve")
+  //
+  ///     CHECK-DAG: <<C0:i\d+>>      IntConstant 0                                         loop:none
+  ///     CHECK-DAG: <<Vec:d\d+>>     VecReplicateScalar [<<Val:i\d+>>,{{j\d+}}]           loop:none
+  //
+  ///     CHECK-DAG: <<Phi:i\d+>>     Phi [<<C0>>,{{i\d+}}]                                 loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Hi:i\d+>>      Phi [{{i\d+}},<<Sel:i\d+>>]                          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<LoopP:j\d+>>   VecPredWhile [<<Phi>>,<<Hi>>]                         loop:<<Loop>>      outer_loop:none
+  //
+  ///     CHECK-DAG: <<Load:d\d+>>    VecLoad [{{l\d+}},{{i\d+}},<<LoopP>>]                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Cond:j\d+>>    VecCondition [<<Load>>,<<Vec>>,<<LoopP>>]             loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Any:z\d+>>     VecPredToBoolean [<<Cond>>]                           loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Sel>>          Select [<<Hi>>,<<Phi>>,<<Any>>]                       loop:<<Loop>>      outer_loop:none
+  //
+  ///     CHECK-DAG:                  Min [<<Phi>>,<<Hi>>]                                  loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-NOT:                      VecLoad
+  //
+  /// CHECK-FI:
+  public static int $compile$noinline$SearchInt(int[] x, int from, int val) {
+    for (int i = from; i < x.length; i++) {
+      if (x[i] == val) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /// CHECK-START-ARM64: int Main.$compile$noinline$SearchByte(byte[], byte) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("sve")
+  //
+  ///     CHECK-DAG: <<LoopP:j\d+>>   VecPredWhile                                          loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>    VecLoad [{{l\d+}},{{i\d+}},<<LoopP>>]                 loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Cond:j\d+>>    VecCondition [<<Load>>,{{d\d+}},<<LoopP>>]            loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                  VecPredToBoolean [<<Cond>>]                           loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-NOT:                      VecLoad
+  //
+  /// CHECK-FI:
+  public static int $compile$noinline$SearchByte(byte[] x, byte val) {
+    for (int i = 0; i < x.length; i++) {
+      if (x[i] == val) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  /// CHECK-START-ARM64: int Main.$compile$noinline$SearchWithStore(int[], int) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("sve")
+  //
+  ///     CHECK-NOT: VecLoad
+  //
+  /// CHECK-FI:
+  //
+  // The body of an early exit loop must not have side effects.
+  public static int $compile$noinline$SearchWithStore(int[] x, int val) {
+    for (int i = 0; i < x.length; i++) {
+      if (x[i] == val) {
+        return i;
+      }
+      x[i] = 0;
+    }
+    return -1;
+  }
+
   //
   // Main driver.
   //
@@ -552,6 +627,28 @@ public class Main {
     $compile$noinline$BrokenInduction(intArray);
     expectIntEquals(18963, IntArraySum(intArray));
 
+    // Early exit loops.
+    initIntArray(intArray);
+    expectIntEquals(0, $compile$noinline$SearchInt(intArray, 0, MAGIC_VALUE_A));
+    expectIntEquals(2, $compile$noinline$SearchInt(intArray, 0, MAGIC_VALUE_C));
+    expectIntEquals(3, $compile$noinline$SearchInt(intArray, 1, MAGIC_VALUE_A));
+    expectIntEquals(USED_ARRAY_LENGTH, $compile$noinline$SearchInt(intArray, 0, 10000));
+    expectIntEquals(-1, $compile$noinline$SearchInt(intArray, 0, 5));
+    intArray[77] = 5;
+    expectIntEquals(77, $compile$noinline$SearchInt(intArray, 0, 5));
+    expectIntEquals(77, $compile$noinline$SearchInt(intArray, 77, 5));
+    expectIntEquals(-1, $compile$noinline$SearchInt(intArray, 78, 5));
+    expectIntEquals(-1, $compile$noinline$SearchInt(intArray, ARRAY_LENGTH + 1, MAGIC_VALUE_A));
+
+    initByteArray(byteArray);
+    expectIntEquals(1, $compile$noinline$SearchByte(byteArray, (byte) MAGIC_VALUE_B));
+    expectIntEquals(USED_ARRAY_LENGTH, $compile$noinline$SearchByte(byteArray, (byte) 127));
+    expectIntEquals(-1, $compile$noinline$SearchByte(byteArray, (byte) -1));
+
+    initIntArray(intArray);
+    expectIntEquals(1, $compile$noinline$SearchWithStore(intArray, MAGIC_VALUE_B));
+    expectIntEquals(23119, IntArraySum(intArray));
+
     System.out.println("passed");
   }
 
@@ -16,6 +16,7 @@
 
 #include <jni.h>
 
+#include "art_method.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "mirror/class.h"
@@ -35,6 +36,32 @@ void Java_Main_callThrough(JNIEnv* env, jclass, jclass klass, jstring methodName
   env->CallStaticVoidMethod(klass, method);
 }
 
+extern "C" JNIEXPORT
+void Java_Main_takeInt(JNIEnv*, jclass, jint) {}
+
+extern "C" JNIEXPORT
+void Java_Main_takeBoolean(JNIEnv*, jclass, jboolean) {}
+
+// Checks that two static methods of `klass` use the same JIT-compiled entrypoint.
+extern "C" JNIEXPORT
+jboolean Java_Main_haveSameEntrypoint(JNIEnv*,
+                                      jclass,
+                                      jclass klass,
+                                      jstring name1,
+                                      jstring name2) {
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> cls = soa.Decode<mirror::Class>(klass);
+  ArtMethod* method1 = cls->FindDeclaredDirectMethodByName(
+      soa.Decode<mirror::String>(name1)->ToModifiedUtf8(), kRuntimePointerSize);
+  ArtMethod* method2 = cls->FindDeclaredDirectMethodByName(
+      soa.Decode<mirror::String>(name2)->ToModifiedUtf8(), kRuntimePointerSize);
+  CHECK(method1 != nullptr);
+  CHECK(method2 != nullptr);
+  const void* entrypoint = method1->GetEntryPointFromQuickCompiledCode();
+  return Runtime::Current()->GetJit()->GetCodeCache()->ContainsPc(entrypoint) &&
+      entrypoint == method2->GetEntryPointFromQuickCompiledCode();
+}
+
 extern "C" JNIEXPORT
 void Java_Main_jitGc(JNIEnv*, jclass) {
   CHECK(Runtime::Current()->GetJit() != nullptr);
@@ -28,6 +28,7 @@ public class Main {
     deoptimizeNativeMethod(Main.class, "callThrough");
     testCompilationUseAndCollection();
     testMixedFramesOnStack();
+    testEquivalentShortiesShareStub();
   }
 
   public static void testCompilationUseAndCollection() {
@@ -90,6 +91,48 @@ public class Main {
     jitGc();
   }
 
+  public static void testEquivalentShortiesShareStub() {
+    // Shorties "VI" and "VZ" differ but need the same JNI stub on all ISAs, so the stub compiled
+    // for takeInt() is also used for takeBoolean().
+    assertFalse(hasJitCompiledCode(Main.class, "takeInt"));
+    assertFalse(hasJitCompiledCode(Main.class, "takeBoolean"));
+    ensureCompiledEntrypoint("takeInt");
+    ensureCompiledEntrypoint("takeBoolean");
+    assertTrue(haveSameEntrypoint(Main.class, "takeInt", "takeBoolean"));
+    takeInt(42);
+    takeBoolean(true);
+
+    // The shared stub is collected once neither method uses it.
+    jitGc();
+    assertFalse(hasJitCompiledCode(Main.class, "takeInt"));
+    assertFalse(hasJitCompiledCode(Main.class, "takeBoolean"));
+  }
+
+  public static void ensureCompiledEntrypoint(String methodName) {
+    int count = 0;
+    while (!hasJitCompiledEntrypoint(Main.class, methodName)) {
+      // Ramp-up the number of calls we do up to 1 << 12.
+      final int rampUpCutOff = 12;
+      int limit = 1 << Math.min(count, rampUpCutOff);
+      for (int i = 0; i < limit; ++i) {
+        if (methodName.equals("takeInt")) {
+          takeInt(i);
+        } else {
+          takeBoolean((i & 1) != 0);
+        }
+      }
+      try {
+        // Sleep to give a chance for the JIT to compile the stub.
+        Thread.sleep(count >= rampUpCutOff ? 200 : 100);
+      } catch (Exception e) {
+        // Ignore
+      }
+      if (++count == 50) {
+        throw new Error("TIMEOUT");
+      }
+    }
+  }
+
   public static void testStubCanBeCollected() {
     jitGc();  // JIT GC without callThrough() on the stack should collect the callThrough() stub.
     assertFalse(hasJitCompiledEntrypoint(Main.class, "callThrough"));
@@ -154,6 +197,10 @@ public class Main {
   public native static void callThrough(Class<?> cls, String methodName);
   public native static void deoptimizeNativeMethod(Class<?> cls, String methodName);
 
+  public native static void takeInt(int value);
+  public native static void takeBoolean(boolean value);
+  public native static boolean haveSameEntrypoint(Class<?> cls, String name1, String name2);
+
   public native static void jitGc();
   public native static boolean isNextJitGcFull();
 
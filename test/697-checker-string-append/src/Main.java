@@ -25,6 +25,7 @@ public class Main {
         testMiscelaneous();
         testNoArgs();
         testInline();
+        testConstructorArgs();
         testEquals();
         System.out.println("passed");
     }
@@ -409,6 +410,43 @@ public class Main {
         assertEquals("x42", $noinline$testInlineOuter("x", 42));
     }
 
+    /// CHECK-START: java.lang.String Main.$noinline$constructorString(int) instruction_simplifier (before)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$constructorString(int) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$constructorString(int i) {
+        return new StringBuilder("x").append(i).toString();
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$constructorNullableString(java.lang.String, int) instruction_simplifier (after)
+    /// CHECK-NOT:              StringBuilderAppend
+    public static String $noinline$constructorNullableString(String s, int i) {
+        // The constructor throws NullPointerException for null, unlike append().
+        return new StringBuilder(s).append(i).toString();
+    }
+
+    /// CHECK-START: java.lang.String Main.$noinline$constructorCapacity(java.lang.String, int) instruction_simplifier (before)
+    /// CHECK-NOT:              StringBuilderAppend
+
+    /// CHECK-START: java.lang.String Main.$noinline$constructorCapacity(java.lang.String, int) instruction_simplifier (after)
+    /// CHECK:                  StringBuilderAppend
+    public static String $noinline$constructorCapacity(String s, int i) {
+        return new StringBuilder(32).append(s).append(i).toString();
+    }
+
+    public static void testConstructorArgs() {
+        assertEquals("x42", $noinline$constructorString(42));
+        assertEquals("y42", $noinline$constructorNullableString("y", 42));
+        assertEquals("z42", $noinline$constructorCapacity("z", 42));
+        assertEquals("null42", $noinline$constructorCapacity(null, 42));
+        try {
+            $noinline$constructorNullableString(null, 42);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException expected) {
+        }
+    }
+
     /// CHECK-START: java.lang.String Main.$noinline$appendNothing() instruction_simplifier (before)
     /// CHECK-NOT:              StringBuilderAppend
 
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Methods are ordered by name in the dex file: `a()` and `c()` call methods that come after
+// them, with the unrelated `b()` in between.
+class CallGraph {
+  static int a(int x) {
+    return c(x) + 1;
+  }
+
+  static int b(int x) {
+    return x * 3;
+  }
+
+  static int c(int x) {
+    return d(x) * 5;
+  }
+
+  static int d(int x) {
+    return x - 7;
+  }
+}
@@ -50,6 +50,7 @@ import java.util.Map;
 import java.util.Set;
 import java.util.regex.Matcher;
 import java.util.regex.Pattern;
+import java.util.stream.Collectors;
 import java.util.stream.Stream;
 
 import javax.xml.parsers.DocumentBuilder;
@@ -197,17 +198,24 @@ public class OdsignTestUtils {
         return getExpectedBootImage("boot-" + getFirstMainlineFrameworkLibraryName());
     }
 
-    public Set<String> getSystemServerExpectedArtifacts() throws Exception {
+    /** Returns all system server jars, in the order in which odrefresh compiles them. */
+    public List<String> getSystemServerJars() throws Exception {
         String[] classpathElements = getListFromEnvironmentVariable("SYSTEMSERVERCLASSPATH");
         assertTrue("SYSTEMSERVERCLASSPATH is empty", classpathElements.length > 0);
         String[] standaloneJars = getListFromEnvironmentVariable("STANDALONE_SYSTEMSERVER_JARS");
-        String[] allSystemServerJars =
-                Stream.concat(Arrays.stream(classpathElements), Arrays.stream(standaloneJars))
-                        .toArray(String[] ::new);
+        return Stream.concat(Arrays.stream(classpathElements), Arrays.stream(standaloneJars))
+                .collect(Collectors.toList());
+    }
+
+    public Set<String> getSystemServerExpectedArtifacts() throws Exception {
+        return getSystemServerExpectedArtifacts(getSystemServerJars());
+    }
+
+    public Set<String> getSystemServerExpectedArtifacts(List<String> jars) throws Exception {
         String isa = getSystemServerIsa();
 
         Set<String> artifacts = new HashSet<>();
-        for (String jar : allSystemServerJars) {
+        for (String jar : jars) {
             artifacts.addAll(getApexDataDalvikCacheFilenames(jar, isa));
         }
 